@@ -63,6 +63,9 @@ void World::run()
     // Set window size to be fixed
     sad::Renderer::ref()->makeFixedSize();
 
+    // Most of bodies are small and far from each other, so broad phase filters most of pairs
+    m_world->setBroadPhase(new sad::p2d::SweepAndPruneBroadPhase());
+
     m_steptask = new sad::p2d::WorldStepTask(m_world);
     sad::Renderer::ref()->pipeline()->append(m_steptask);
 
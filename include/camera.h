@@ -5,6 +5,8 @@
  */
 #pragma once
 #include "sadpoint.h"
+#include "sadrect.h"
+#include "matrix4x4.h"
 #include "object.h"
 
 namespace sad
@@ -41,10 +43,61 @@ public:
     /*! Restores a camera transformation
      */
     virtual void restore();
+    /*! Computes a part of scene, visible through camera, used to cull nodes outside of view.
+        Default camera doesn't know used projection, so no part could be computed
+        \param[out] r a bounding box of visible part of scene, computed by sad::boundingBox
+        \return whether part could be computed
+     */
+    virtual bool viewRect(sad::Rect2D & r) const;
+    /*! Returns a transformation of camera, including global translation offset of renderer,
+        computed on CPU. Matrix is cached and recomputed only if fields of camera or
+        global translation offset are changed
+        \return matrix of transformation
+     */
+    const sad::Matrix4x4<double>& matrix() const;
+    /*! Returns an inverse of transformation of camera, which maps points of viewport to
+        points of scene. Cached like matrix()
+        \return inverse matrix of transformation
+     */
+    const sad::Matrix4x4<double>& inverseMatrix() const;
     /*! You can define your camera, which can be used if you want to bound rotation,
         move around point and other stuff
      */
     virtual ~Camera();
+protected:
+    /*! Computes a part of scene, which is visible in viewport with specified size after transformations
+        of camera, by transforming corners of viewport back to coordinates of scene
+        \param[in] width a width of viewport
+        \param[in] height a height of viewport
+        \param[out] r a bounding box of visible part of scene
+        \return false, if camera is rotated not in plane of screen
+     */
+    bool viewRectForViewport(double width, double height, sad::Rect2D & r) const;
+    /*! Recomputes cached matrices, if fields of camera are changed since last computation
+     */
+    void updateMatrices() const;
+
+    /*! A cached transformation of camera
+     */
+    mutable sad::Matrix4x4<double> m_matrix;
+    /*! A cached inverse transformation of camera
+     */
+    mutable sad::Matrix4x4<double> m_inverse_matrix;
+    /*! Whether cached matrices were computed
+     */
+    mutable bool m_matrices_computed;
+    /*! A translation, used to compute cached matrices
+     */
+    mutable sad::Vector3D m_cached_translation;
+    /*! A temporary rotation offset, used to compute cached matrices
+     */
+    mutable sad::Vector3D m_cached_rotation_offset;
+    /*! An angle, used to compute cached matrices
+     */
+    mutable double m_cached_angle;
+    /*! A rotation axis, used to compute cached matrices
+     */
+    mutable sad::Vector3D m_cached_rotation_direction;
 public:
     /*! An offset, that is substituted to glTranslatef
      */
@@ -168,11 +168,14 @@ public:
         \return sprite options
      */
     const sad::String& options() const;
-    /*! Loads object from picojson object
-        \param[in] v a picojson object
+    /*! Toggles loading mode of inner sprite on, before properties are loaded
+     */
+    virtual void beginLoading();
+    /*! Toggles loading mode of inner sprite off, when properties are loaded
+        \param[in] loaded whether properties were loaded successfully
         \return  whether it as successfull
      */
-    virtual bool load(const picojson::value& v);
+    virtual bool finishLoading(bool loaded);
     /*! Sets a texture coordinates for sprites
         \param[in] texturecoordinates a texture coordinates for a sprite in notation, defined in 
                                       constructor
@@ -61,6 +61,10 @@ public:
         \return true. This resource supports loading from archives.
      */
     virtual bool supportsLoadingFromTar7z() const;
+    /*! Returns whether file could be loaded in parallel with other files of tree
+        \return false. Schemas reference resources, loaded by previous files
+     */
+    virtual bool supportsParallelLoading() const;
 protected:
     /*! Parses file with schemas
         \param[out] result a parsed data
@@ -0,0 +1,102 @@
+/*! \file db/dbbinaryformat.h
+
+
+    Contains definitions for binary format of database, which could be used instead of JSON.
+
+    Binary database consists of header, string table and body. All numbers are little-endian.
+    Header is magic signature "SADB" and 32-bit format version.
+    String table is 32-bit count of strings, followed by strings as 32-bit length and bytes.
+    Every string (names of properties, tables, types and string values) is stored
+    in body as 32-bit index in string table.
+    Body consists of database properties (32-bit count, then name, type and value for each one) and
+    tables (32-bit count, then name, 32-bit count of objects and objects for each table).
+    Every object is written as type, 32-bit count of fields and pairs of field name and value.
+    Every value starts from one byte tag, describing it's type (see sad::db::BinaryValueType).
+    Since version 2 points, rectangles, sizes and colors are stored as packed arrays of numbers
+    and vectors of them as arrays of such values, so they are loaded without building JSON.
+ */
+#pragma once
+
+namespace sad
+{
+
+namespace db
+{
+class Variant;
+
+/*! A signature, which every binary database starts with
+ */
+#define SAD_DB_BINARY_MAGIC "SADB"
+/*! A current version of binary format of database
+ */
+#define SAD_DB_BINARY_VERSION  (2)
+/*! A maximal depth of nested arrays and objects, which could be read from binary database
+ */
+#define SAD_DB_BINARY_MAX_DEPTH  (64)
+/*! An extension of file, which selects binary format, when saving and loading database from files
+ */
+#define SAD_DB_BINARY_EXTENSION "sdb"
+
+/*! A tag of value, stored in binary database
+ */
+enum BinaryValueType
+{
+    BVT_NULL = 0,         //!< Empty value
+    BVT_BOOL = 1,         //!< Boolean value, stored as one byte
+    BVT_INT = 2,          //!< Signed integral value, stored as 64-bit number
+    BVT_UINT = 3,         //!< Unsigned integral value, stored as 64-bit number
+    BVT_DOUBLE = 4,       //!< Floating-point value, stored as 64-bit IEEE 754 number
+    BVT_STRING = 5,       //!< String, stored as index in string table
+    BVT_ARRAY = 6,        //!< Array, stored as 32-bit count and values
+    BVT_OBJECT = 7,       //!< Object, stored as 32-bit count and pairs of keys and values
+    BVT_DOUBLES = 8,      //!< Packed numbers, stored as 32-bit count and 64-bit IEEE 754 numbers without tags
+    BVT_BYTES = 9         //!< Packed bytes, stored as 32-bit count and bytes without tags
+};
+
+/*! A type of value in variant, which could be written to binary database directly,
+    without converting it to JSON
+ */
+enum BinaryPrimitive
+{
+    BP_NONE = 0,                //!< Not a primitive, value should be converted to JSON
+    BP_BOOL = 1,                //!< bool
+    BP_CHAR = 2,                //!< char
+    BP_SIGNED_CHAR = 3,         //!< signed char
+    BP_UNSIGNED_CHAR = 4,       //!< unsigned char
+    BP_SHORT = 5,               //!< short
+    BP_UNSIGNED_SHORT = 6,      //!< unsigned short
+    BP_INT = 7,                 //!< int
+    BP_UNSIGNED_INT = 8,        //!< unsigned int
+    BP_LONG = 9,                //!< long
+    BP_UNSIGNED_LONG = 10,      //!< unsigned long
+    BP_LONG_LONG = 11,          //!< long long
+    BP_UNSIGNED_LONG_LONG = 12, //!< unsigned long long
+    BP_FLOAT = 13,              //!< float
+    BP_DOUBLE = 14,             //!< double
+    BP_LONG_DOUBLE = 15,        //!< long double
+    BP_SAD_STRING = 16,         //!< sad::String
+    BP_STD_STRING = 17,         //!< std::string
+    BP_POINT2D = 18,            //!< sad::Point2D
+    BP_POINT2I = 19,            //!< sad::Point2I
+    BP_POINT3D = 20,            //!< sad::Point3D
+    BP_POINT3I = 21,            //!< sad::Point3I
+    BP_RECT2D = 22,             //!< sad::Rect2D
+    BP_SIZE2D = 23,             //!< sad::Size2D
+    BP_SIZE2I = 24,             //!< sad::Size2I
+    BP_COLOR = 25,              //!< sad::Color
+    BP_ACOLOR = 26,             //!< sad::AColor
+    BP_VECTOR_POINT2D = 27,     //!< sad::Vector<sad::Point2D>
+    BP_VECTOR_VECTOR_ACOLOR = 28, //!< sad::Vector<sad::Vector<sad::AColor> >
+    BP_VECTOR_STRING = 29,      //!< sad::Vector<sad::String>
+    BP_VECTOR_UNSIGNED_LONG_LONG = 30 //!< sad::Vector<unsigned long long>
+};
+
+/*! Returns type of value in variant, if it could be written to binary database directly
+    \param[in] v variant
+    \return type of value (BP_NONE if value should be converted to JSON)
+ */
+sad::db::BinaryPrimitive binaryPrimitiveOf(const sad::db::Variant& v);
+
+}
+
+}
@@ -0,0 +1,219 @@
+/*! \file db/dbbinaryreader.h
+
+
+    Contains definition of class BinaryReader, which reads database in binary format.
+ */
+#pragma once
+#include "../sadstring.h"
+#include "../sadhash.h"
+#include "../sadvector.h"
+#include "../sadpoint.h"
+#include "../sadrect.h"
+#include "../sadsize.h"
+#include "../sadcolor.h"
+#include "../3rdparty/picojson/picojson.h"
+#include "dbbinaryformat.h"
+
+namespace sad
+{
+
+namespace db
+{
+
+class Variant;
+
+/*! \class BinaryReader
+
+    Reads data of database in binary format, described in db/dbbinaryformat.h.
+    All reading methods check bounds of data and return false, if data is malformed.
+    Nested arrays and objects deeper than SAD_DB_BINARY_MAX_DEPTH are treated as malformed.
+ */
+class BinaryReader
+{
+public:
+    /*! A field of object, found in data
+     */
+    struct Field
+    {
+        unsigned int Name;  //!< An index of name of field in string table
+        size_t Offset;      //!< A position of value of field in data
+    };
+    /*! A list of fields of object
+     */
+    typedef sad::Vector<sad::db::BinaryReader::Field> Fields;
+    /*! Creates new reader for data. Data must be alive, while reader is used.
+        \param[in] data a data
+     */
+    BinaryReader(const sad::String& data);
+    /*! Reads header and string table
+        \return whether it was successfull
+     */
+    bool readHeader();
+    /*! Reads one byte
+        \param[out] v value
+        \return whether it was successfull
+     */
+    bool readByte(unsigned char& v);
+    /*! Reads 32-bit unsigned number
+        \param[out] v value
+        \return whether it was successfull
+     */
+    bool readUInt32(unsigned int& v);
+    /*! Reads 64-bit unsigned number
+        \param[out] v value
+        \return whether it was successfull
+     */
+    bool readUInt64(unsigned long long& v);
+    /*! Reads 64-bit floating-point number
+        \param[out] v value
+        \return whether it was successfull
+     */
+    bool readDouble(double& v);
+    /*! Reads string as index in string table
+        \param[out] s a string from string table
+        \return whether it was successfull
+     */
+    bool readString(const sad::String*& s);
+    /*! Reads tagged value into variant. Variant must contain a value of type, which should be read,
+        usually taken from property via sad::db::Property::get.
+        \param[in, out] v variant
+        \return whether it was successfull
+     */
+    bool readValue(sad::db::Variant& v);
+    /*! Reads tagged value as JSON value
+        \param[out] v value
+        \return whether it was successfull
+     */
+    bool readJSON(picojson::value& v);
+    /*! Skips tagged value
+        \param[in] depth a depth of value in arrays and objects
+        \return whether it was successfull
+     */
+    bool skipValue(unsigned int depth = 0);
+    /*! Reads count and fields of object, skipping their values
+        \param[out] fields fields of object
+        \return whether it was successfull
+     */
+    bool readFields(sad::db::BinaryReader::Fields& fields);
+    /*! Searches field by name
+        \param[in] fields fields of object
+        \param[in] name a name of field
+        \return field or NULL if not found
+     */
+    const sad::db::BinaryReader::Field* findField(
+        const sad::db::BinaryReader::Fields& fields,
+        const sad::String& name
+    ) const;
+    /*! Returns current position in data
+        \return position
+     */
+    size_t position() const;
+    /*! Sets current position in data
+        \param[in] position a position
+     */
+    void setPosition(size_t position);
+    /*! Returns true, if all data is read
+        \return whether all data is read
+     */
+    bool atEnd() const;
+private:
+    /*! Reads value with specified tag as JSON value
+        \param[in] tag a tag
+        \param[out] v value
+        \param[in] depth a depth of value in arrays and objects
+        \return whether it was successfull
+     */
+    bool readJSONWithTag(unsigned char tag, picojson::value& v, unsigned int depth);
+    /*! Reads tagged value of composite type, which is written directly
+        \param[in] primitive a type of value
+        \param[out] data a value
+        \return whether it was successfull
+     */
+    bool readComposite(sad::db::BinaryPrimitive primitive, void* data);
+    /*! Reads tagged packed numbers. Amount of numbers must match exactly
+        \param[out] values numbers
+        \param[in] count amount of numbers
+        \return whether it was successfull
+     */
+    bool readDoubles(double* values, unsigned int count);
+    /*! Reads tagged packed bytes. Amount of bytes must match exactly
+        \param[out] values bytes
+        \param[in] count amount of bytes
+        \return whether it was successfull
+     */
+    bool readBytes(unsigned char* values, unsigned int count);
+    /*! Reads tagged point
+        \param[out] v value
+        \return whether it was successfull
+     */
+    bool readTyped(sad::Point2D& v);
+    /*! Reads tagged color with alpha-channel
+        \param[out] v value
+        \return whether it was successfull
+     */
+    bool readTyped(sad::AColor& v);
+    /*! Reads tagged string
+        \param[out] v value
+        \return whether it was successfull
+     */
+    bool readTyped(sad::String& v);
+    /*! Reads tagged unsigned number
+        \param[out] v value
+        \return whether it was successfull
+     */
+    bool readTyped(unsigned long long& v);
+    /*! Reads vector from tagged array of values
+        \param[out] v value
+        \return whether it was successfull
+     */
+    template<typename T>
+    bool readTyped(sad::Vector<T>& v)
+    {
+        unsigned char tag = 0;
+        unsigned int count = 0;
+        // Every element takes at least one byte
+        if (!readByte(tag) || tag != sad::db::BVT_ARRAY || !readUInt32(count) || !canRead(count))
+        {
+            return false;
+        }
+        sad::Vector<T> result;
+        result.resize(count);
+        for(unsigned int i = 0; i < count; i++)
+        {
+            if (!readTyped(result[i]))
+            {
+                return false;
+            }
+        }
+        v = result;
+        return true;
+    }
+    /*! Tests, whether specified amount of bytes could be read
+        \param[in] size amount of bytes
+        \return whether it could be read
+     */
+    bool canRead(size_t size) const;
+
+    /*! A data
+     */
+    const unsigned char* m_data;
+    /*! A size of data
+     */
+    size_t m_size;
+    /*! A current position in data
+     */
+    size_t m_position;
+    /*! A version of format, read from header
+     */
+    unsigned int m_version;
+    /*! A string table
+     */
+    sad::Vector<sad::String> m_strings;
+    /*! Indexes of strings in string table
+     */
+    sad::Hash<sad::String, unsigned int> m_string_indexes;
+};
+
+}
+
+}
@@ -0,0 +1,138 @@
+/*! \file db/dbbinarywriter.h
+
+
+    Contains definition of class BinaryWriter, which writes database in binary format.
+ */
+#pragma once
+#include "../sadstring.h"
+#include "../sadhash.h"
+#include "../sadvector.h"
+#include "../sadpoint.h"
+#include "../sadrect.h"
+#include "../sadsize.h"
+#include "../sadcolor.h"
+#include "../3rdparty/picojson/picojson.h"
+#include "dbbinaryformat.h"
+
+namespace sad
+{
+
+namespace db
+{
+
+class Variant;
+
+/*! \class BinaryWriter
+
+    Writes data of database in binary format, described in db/dbbinaryformat.h.
+    Strings are collected into string table, which is written before body, when writer is finished.
+ */
+class BinaryWriter
+{
+public:
+    /*! Creates new empty writer
+     */
+    BinaryWriter();
+    /*! Writes one byte
+        \param[in] v value
+     */
+    void writeByte(unsigned char v);
+    /*! Writes 32-bit unsigned number
+        \param[in] v value
+     */
+    void writeUInt32(unsigned int v);
+    /*! Writes 64-bit unsigned number
+        \param[in] v value
+     */
+    void writeUInt64(unsigned long long v);
+    /*! Writes 64-bit floating-point number
+        \param[in] v value
+     */
+    void writeDouble(double v);
+    /*! Writes string as index in string table
+        \param[in] s string
+     */
+    void writeString(const sad::String& s);
+    /*! Writes tagged value of variant. Values of primitive types, strings, points, rectangles,
+        sizes, colors and vectors of them are written directly, other values are written
+        as JSON-like structure, made by sad::db::Variant::save
+        \param[in] v value
+     */
+    void writeValue(const sad::db::Variant& v);
+    /*! Writes tagged JSON value
+        \param[in] v value
+     */
+    void writeJSON(const picojson::value& v);
+    /*! Reserves place for 32-bit number, which will be written later
+        \return position of reserved place
+     */
+    size_t reserveUInt32();
+    /*! Writes 32-bit number to reserved place
+        \param[in] position a position, returned by reserveUInt32
+        \param[in] v value
+     */
+    void writeUInt32At(size_t position, unsigned int v);
+    /*! Makes resulting data, writing header, string table and body
+        \param[out] output output data
+     */
+    void finish(sad::String& output) const;
+private:
+    /*! Appends 32-bit number to buffer
+        \param[out] buffer a buffer
+        \param[in] v value
+     */
+    static void appendUInt32(std::string& buffer, unsigned int v);
+    /*! Writes tagged packed numbers
+        \param[in] values numbers
+        \param[in] count amount of numbers
+     */
+    void writeDoubles(const double* values, unsigned int count);
+    /*! Writes tagged packed bytes
+        \param[in] values bytes
+        \param[in] count amount of bytes
+     */
+    void writeBytes(const unsigned char* values, unsigned int count);
+    /*! Writes tagged point
+        \param[in] v value
+     */
+    void writeTyped(const sad::Point2D& v);
+    /*! Writes tagged color with alpha-channel
+        \param[in] v value
+     */
+    void writeTyped(const sad::AColor& v);
+    /*! Writes tagged string
+        \param[in] v value
+     */
+    void writeTyped(const sad::String& v);
+    /*! Writes tagged unsigned number
+        \param[in] v value
+     */
+    void writeTyped(unsigned long long v);
+    /*! Writes vector as tagged array of values
+        \param[in] v value
+     */
+    template<typename T>
+    void writeTyped(const sad::Vector<T>& v)
+    {
+        writeByte(sad::db::BVT_ARRAY);
+        writeUInt32(static_cast<unsigned int>(v.size()));
+        for(size_t i = 0; i < v.size(); i++)
+        {
+            writeTyped(v[i]);
+        }
+    }
+
+    /*! A body of database
+     */
+    std::string m_body;
+    /*! A string table
+     */
+    sad::Vector<sad::String> m_strings;
+    /*! Indexes of strings in string table
+     */
+    sad::Hash<sad::String, unsigned int> m_string_indexes;
+};
+
+}
+
+}
@@ -14,6 +14,7 @@
 #include "dbstoredproperty.h"
 #include "dbcanbecastedfromto.h"
 #include "dbvariant.h"
+#include "dbjournal.h"
 
 namespace sad
 {
@@ -66,7 +67,12 @@ public:
         \return output string
      */
     sad::String save();
-    /*! Saves database to file
+    /*! Saves database in binary format to string
+        \param[out] output output data
+     */
+    void saveBinary(sad::String & output);
+    /*! Saves database to file. If file has extension, specified by SAD_DB_BINARY_EXTENSION,
+        database is saved in binary format, otherwise in JSON.
         \param[in] filename a name of file
      */
     void saveToFile(const sad::String& filename);
@@ -75,12 +81,19 @@ public:
         \return whether load was successfull
      */
     bool load(const sad::String& input);
+    /*! Loads database from data in binary format. Saves a snapshot if successfull.
+        \param[in] input a data in binary format
+        \return whether load was successfull
+     */
+    bool loadBinary(const sad::String& input);
     /*! Loads database from file, using specifying name. Saves a snapshot if successfull.
         \param[in] name a name for file
         \return whether load was successfull
      */
     bool tryLoadFrom(const sad::String& name);
     /*! Loads database from file, using specifying name. Saves a snapshot if successfull.
+        If file has extension, specified by SAD_DB_BINARY_EXTENSION, it's loaded as binary data,
+        otherwise as JSON.
         \param[in] name a name for file
         \param[in] r renderer, which is used to determine global path's (NULL for global)
         \return whether load was successfull
@@ -146,6 +159,10 @@ public:
             if (canbecasted)
             {
                 sad::db::Variant v(value);
+                if (m_journal)
+                {
+                    m_journal->recordPropertyChange(NULL, name, prop);
+                }
                 result = prop->set(NULL, v);
             }
         }
@@ -350,6 +367,23 @@ public:
         \return default tree name
      */
     const sad::String& defaultTreeName() const;
+    /*! Enables or disables journaled snapshots. In journaled mode database does not copy
+        whole content, when saving snapshot, but records only changes, made since previous snapshot,
+        so saving and restoring snapshots costs proportionally to size of change.
+        Only changes, made through setProperty of objects and database, adding and removing objects
+        and tables are tracked in this mode, see sad::db::Journal for details.
+        Switching mode removes all existing snapshots.
+        \param[in] journaled whether snapshots should be journaled
+     */
+    void setJournaledSnapshots(bool journaled);
+    /*! Returns true, if snapshots are journaled
+        \return whether snapshots are journaled
+     */
+    bool journaledSnapshots() const;
+    /*! Returns journal of changes, if snapshots are journaled
+        \return journal (NULL if snapshots are not journaled)
+     */
+    sad::db::Journal* journal() const;
     /*! Saves snapshot for database
      */
     void saveSnapshot();
@@ -390,6 +424,41 @@ protected:
         const picojson::object & properties, 
         const picojson::object & tables
     );
+    /*! Loads properties from binary data
+        \param[in] r a reader for binary data
+        \param[out] newproperties a new properties for database
+        \return whether it was successfull
+     */
+    bool loadProperties(
+        sad::db::BinaryReader& r,
+        sad::Hash<sad::String, sad::db::Property*>& newproperties
+    );
+    /*! Loads properties and tables from binary data
+        \param[in] r a reader for binary data
+        \return whether it was successfull
+     */
+    bool loadPropertiesAndTables(sad::db::BinaryReader& r);
+    /*! Replaces properties and tables of database with loaded ones, if loading was successfull,
+        otherwise frees them and restores old state of database
+        \param[in] result whether loading was successfull
+        \param[in] oldmajoridtotable a links from major ids to tables before loading
+        \param[in] oldmaxmajorid maximal major id before loading
+        \param[in] newproperties loaded properties
+        \param[in] newtables loaded tables
+        \return result
+     */
+    bool finishLoadingPropertiesAndTables(
+        bool result,
+        const sad::Hash<unsigned long long, sad::db::Table*>& oldmajoridtotable,
+        unsigned long long oldmaxmajorid,
+        sad::Hash<sad::String, sad::db::Property*>& newproperties,
+        sad::Hash<sad::String, sad::db::Table*>& newtables
+    );
+    /*! Tests, whether file should be saved or loaded in binary format, judging by extension
+        \param[in] name a name of file
+        \return whether file is in binary format
+     */
+    static bool isBinaryFileName(const sad::String& name);
     /*! Saves properties into JSON object
         \param[out] o object
      */
@@ -422,6 +491,9 @@ protected:
     /*! A snapshots for database
      */
     sad::Vector<sad::db::Database::Snapshot> m_snapshots;
+    /*! A journal for journaled snapshots (NULL if snapshots are full copies of database)
+     */
+    sad::db::Journal* m_journal;
     /*! Filters objects by specific type
         \param[out] result a resulting vector
         \param[in] o objects
@@ -0,0 +1,183 @@
+/*! \file db/dbjournal.h
+
+
+    Contains definition of class Journal, which keeps journaled snapshots of database as
+    lists of changes between them, instead of full copies of database content.
+ */
+#pragma once
+#include "../sadstring.h"
+#include "../sadvector.h"
+#include "../sadhash.h"
+#include "dbvariant.h"
+
+namespace sad
+{
+
+namespace db
+{
+
+class Database;
+class Table;
+class Object;
+class Property;
+
+/*! \class Journal
+
+    A journal of changes in database, used to implement cheap snapshots. Every snapshot
+    is stored as a segment of changes, made since previous snapshot, so saving and restoring
+    snapshot costs proportionally to size of change, not size of database.
+
+    Journal tracks only changes, which are made through sad::db::Object::setProperty,
+    sad::db::Database::setProperty, sad::db::Database::setDBProperty, adding and removing
+    objects from tables and adding and removing tables from database. Changes, made via
+    direct calls of object setters are not tracked.
+ */
+class Journal
+{
+public:
+    /*! A type of journaled change
+     */
+    enum EntryType
+    {
+        JET_PROPERTY_CHANGED = 0,  //!< A property of object or database is changed
+        JET_OBJECT_ADDED = 1,      //!< An object is added to table
+        JET_OBJECT_REMOVED = 2,    //!< An object is removed from table
+        JET_TABLE_ADDED = 3,       //!< A table is added to database
+        JET_TABLE_REMOVED = 4      //!< A table is removed from database
+    };
+    /*! A journaled change. Entry holds references to object and table, so
+        they are kept alive, while change could be undone or redone.
+     */
+    struct Entry
+    {
+        sad::db::Journal::EntryType Type;  //!< A type of change
+        sad::db::Object* Item;             //!< An object (NULL for database properties and tables)
+        sad::db::Table* Container;         //!< A table (NULL for property changes)
+        sad::String Name;                  //!< A name of property or table
+        sad::db::Variant OldValue;         //!< A value of property before change
+        sad::db::Variant NewValue;         //!< A value of property after change
+    };
+    /*! A list of changes between two snapshots
+     */
+    typedef sad::Vector<sad::db::Journal::Entry> Segment;
+    /*! Creates new empty journal for database
+        \param[in] db a database
+     */
+    Journal(sad::db::Database* db);
+    /*! Releases all references, held by journal
+     */
+    ~Journal();
+    /*! Returns true, if journal records changes now. Journal does not record changes,
+        before first snapshot is saved or while restoring snapshot.
+        \return whether journal records changes
+     */
+    bool isRecording() const;
+    /*! Records, that property of object or database is going to be changed. Only first
+        change of property since last snapshot is recorded.
+        \param[in] o an object (NULL for database property)
+        \param[in] name a name of property
+        \param[in] prop a property
+     */
+    void recordPropertyChange(sad::db::Object* o, const sad::String& name, sad::db::Property* prop);
+    /*! Records, that object is added to table
+        \param[in] t a table
+        \param[in] o an object
+     */
+    void recordObjectAdded(sad::db::Table* t, sad::db::Object* o);
+    /*! Records, that object is going to be removed from table
+        \param[in] t a table
+        \param[in] o an object
+     */
+    void recordObjectRemoved(sad::db::Table* t, sad::db::Object* o);
+    /*! Records, that table is added to database
+        \param[in] name a name of table
+        \param[in] t a table
+     */
+    void recordTableAdded(const sad::String& name, sad::db::Table* t);
+    /*! Records, that table is going to be removed from database
+        \param[in] name a name of table
+        \param[in] t a table
+     */
+    void recordTableRemoved(const sad::String& name, sad::db::Table* t);
+    /*! Saves new snapshot, closing list of pending changes
+        \param[in] maxid maximal major id in database
+     */
+    void saveSnapshot(unsigned long long maxid);
+    /*! Returns count of snapshots
+        \return count of snapshots
+     */
+    unsigned long snapshotsCount() const;
+    /*! Restores snapshot, undoing and redoing changes between current state and snapshot
+        \param[in] index index of snapshot
+        \param[out] maxid maximal major id in database for snapshot
+        \return whether it was successfull (false if index is out of range)
+     */
+    bool restoreSnapshot(unsigned long index, unsigned long long& maxid);
+    /*! Returns amount of changes, stored in journal, including pending changes
+        \return amount of changes
+     */
+    size_t entriesCount() const;
+    /*! Removes all snapshots and pending changes, releasing held references
+     */
+    void clear();
+private:
+    /*! Disabled copying
+        \param[in] o other journal
+     */
+    Journal(const sad::db::Journal& o);
+    /*! Disabled copying
+        \param[in] o other journal
+        \return self-reference
+     */
+    sad::db::Journal& operator=(const sad::db::Journal& o);
+    /*! Adds references for object and table of entry
+        \param[in] e entry
+     */
+    static void retain(const sad::db::Journal::Entry& e);
+    /*! Removes references for object and table of entry
+        \param[in] e entry
+     */
+    static void release(const sad::db::Journal::Entry& e);
+    /*! Releases all entries in segment and clears it
+        \param[in] s segment
+     */
+    static void releaseSegment(sad::db::Journal::Segment& s);
+    /*! Appends entry to pending changes
+        \param[in] e entry
+     */
+    void addPending(const sad::db::Journal::Entry& e);
+    /*! Applies change to a database
+        \param[in] e entry
+        \param[in] forward true to redo change, false to undo it
+     */
+    void apply(const sad::db::Journal::Entry& e, bool forward);
+    /*! Undoes all pending changes and clears them
+     */
+    void undoPending();
+
+    /*! A database, which changes are recorded
+     */
+    sad::db::Database* m_database;
+    /*! Changes between snapshots. Segment with index i leads from snapshot i to snapshot i + 1
+     */
+    sad::Vector<sad::db::Journal::Segment> m_segments;
+    /*! Maximal major ids for every snapshot
+     */
+    sad::Vector<unsigned long long> m_max_ids;
+    /*! Changes, made since current snapshot
+     */
+    sad::db::Journal::Segment m_pending;
+    /*! Indexes of pending property changes by object and property name
+     */
+    sad::Hash<sad::db::Object*, sad::Hash<sad::String, size_t> > m_pending_properties;
+    /*! An index of snapshot, which database state is based on
+     */
+    unsigned long m_position;
+    /*! Whether journal is applying changes now
+     */
+    bool m_replaying;
+};
+
+}
+
+}
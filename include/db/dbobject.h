@@ -9,6 +9,7 @@
 #include "dbproperty.h"
 #include "dbcanbecastedfromto.h"
 #include "dbvariant.h"
+#include "dbbinaryreader.h"
 
 namespace sad
 {
@@ -25,6 +26,7 @@ class Schema;
 
 class Property;
 class Table;
+class BinaryWriter;
 /*! \class Object
     
     Defines a basic serializable object
@@ -47,6 +49,24 @@ public:
         \return  whether it as successfull
      */
     virtual bool load(const picojson::value& v);
+    /*! Saves object in binary format as type and fields, described by schema
+        \param[out] w a writer for binary data
+     */
+    virtual void saveBinary(sad::db::BinaryWriter& w);
+    /*! Loads object from fields in binary data
+        \param[in] r a reader for binary data
+        \param[in] fields fields of object
+        \return whether it was successfull
+     */
+    virtual bool loadBinary(sad::db::BinaryReader& r, const sad::db::BinaryReader::Fields& fields);
+    /*! Called before properties of object are loaded. By default does nothing
+     */
+    virtual void beginLoading();
+    /*! Called after properties of object are loaded. By default returns loading result
+        \param[in] loaded whether properties were loaded successfully
+        \return whether object is loaded successfully
+     */
+    virtual bool finishLoading(bool loaded);
     /*! Returns a table, where object belongs
         \return table
      */
@@ -132,6 +152,7 @@ public:
             if (canbecasted)
             {
                 sad::db::Variant v(o);
+                this->journalPropertyChange(s, prop);
                 result = prop->set(this, v);
             }
         }
@@ -151,6 +172,12 @@ public:
         \return s string
      */
     sad::db::Property* getObjectProperty(const sad::String& s) const;
+    /*! Records in journal of database, that property of object is going to be changed,
+        if object belongs to database with journaled snapshots
+        \param[in] s a name of property
+        \param[in] prop a property
+     */
+    void journalPropertyChange(const sad::String& s, sad::db::Property* prop);
     /*! A basic introspection capability. Checks, whether object has specified type
         \param[in] name name of class
         \return in basic implementation - false
@@ -127,6 +127,13 @@ public:
         \return object or NULL, if can't create object
      */
     virtual sad::db::Object* createFromEntry(const picojson::value & v);
+    /*! Creates new object by type and name of object. A name is used to create custom objects
+        with special handlers.
+        \param[in] type a name of object's class
+        \param[in] name a name of object (could be empty)
+        \return object or NULL, if can't create object
+     */
+    virtual sad::db::Object* createByTypeAndName(const sad::String& type, const sad::Maybe<sad::String>& name);
     /*! This class can be inherited
      */
     virtual ~ObjectFactory();
@@ -80,6 +80,23 @@ public:
         \param[out] v a value for table
      */
     virtual void save(picojson::value & v);
+    /*! Loads table from binary data
+        \param[in] r a reader for binary data
+        \param[in] factory a factory
+        \param[in] renderer a renderer, where should resources, linked to objects be stored
+        \param[in] treename a name for tree, where should resourced, linked to objects be stored
+        \return whether value was successfull
+     */
+    virtual bool loadBinary(
+        sad::db::BinaryReader& r,
+        sad::db::ObjectFactory* factory,
+        sad::Renderer* renderer = NULL,
+        const sad::String& treename = ""
+    );
+    /*! Saves a table to binary data
+        \param[out] w a writer for binary data
+     */
+    virtual void saveBinary(sad::db::BinaryWriter& w);
     /*! Returns database, linked with table
         \return database
      */
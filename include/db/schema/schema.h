@@ -6,6 +6,8 @@
 #pragma once
 #include "../dbproperty.h"
 #include "../dbobject.h"
+#include "../dbbinarywriter.h"
+#include "../dbbinaryreader.h"
 #include "../../sadptrhash.h"
 #include "../../sadvector.h"
 #include "../../sadmutex.h"
@@ -64,6 +66,19 @@ public:
         \param[out] v a value, which will be filled with data from schema
      */
     void save(sad::db::Object * linked, picojson::value & v);
+    /*! Loads an object for schema from fields of object in binary data
+        \param[in] o object, where data is stored
+        \param[in] r a reader for binary data
+        \param[in] fields fields of object
+        \return whether it was successfull
+     */
+    bool load(sad::db::Object * o, sad::db::BinaryReader& r, const sad::db::BinaryReader::Fields& fields);
+    /*! Saves linked object from a schema as fields in binary data
+        \param[in] linked a linked object
+        \param[out] w a writer for binary data
+        \return amount of written fields
+     */
+    unsigned int save(sad::db::Object * linked, sad::db::BinaryWriter& w);
     /*! Return parent schema
         \return parent schema
      */
@@ -128,15 +128,11 @@ protected:
     /*! A color of font
      */
     sad::AColor m_color;
-    /*! A buffer, used by fonts to store current color
-     */
-    int m_current_color_buffer[4]; 
-    /*! Sets current OpenGL state rendering color to an inner color
+    /*! Sets current OpenGL state rendering color to an inner color through state cache
+        of global renderer. Color is not restored after rendering, since every object
+        sets it's own color through the cache before rendering
      */
     void setCurrentColor();
-    /*! Restores OpenGL state rendering color
-     */
-    void restoreColor();
 };
 
 }
@@ -5,6 +5,7 @@
  */
 #pragma once
 #include "timer.h"
+#include "sadvector.h"
 
 namespace sad
 {
@@ -38,6 +39,40 @@ public:
         \return FPS
      */
     virtual double fps();
+    /*! Registers, that frame is finished, storing real time between ends of this and previous
+        frame, including time, spent on waiting for next frame in main loop
+     */
+    void frameFinished();
+    /*! Registers frame with specified time, as if it was measured. Used for registering
+        frames, which were timed elsewhere
+        \param[in] elapsed time of frame in milliseconds
+     */
+    void frameFinished(double elapsed);
+    /*! Resets timer for frame times, so next frame time is measured from now. Used, when
+        main loop waits for events, so waiting won't be counted as frame time
+     */
+    void resetFrameTimer();
+    /*! Returns percentile of frame times among last registered frames, using nearest-rank method
+        \param[in] percentile a percentile (from 0 to 100)
+        \return frame time in milliseconds (0 if no frames are registered)
+     */
+    double frameTimePercentile(double percentile) const;
+    /*! Returns amount of registered frame times
+        \return amount of frame times
+     */
+    size_t frameTimesCount() const;
+    /*! Sets maximal amount of stored frame times. Older times are replaced with newer.
+        Clears stored frame times
+        \param[in] capacity a capacity (at least 1)
+     */
+    void setFrameTimesCapacity(size_t capacity);
+    /*! Returns maximal amount of stored frame times
+        \return capacity
+     */
+    size_t frameTimesCapacity() const;
+    /*! Clears stored frame times
+     */
+    void clearFrameTimes();
 protected:
     /*! A timer, for computng FPS
      */
@@ -57,6 +92,21 @@ protected:
     /*!  Current FPS value
      */
     double               m_fps; 
+    /*! A timer for measuring time between ends of frames
+     */
+    sad::Timer           m_frame_timer;
+    /*! Whether timer for frame times is started
+     */
+    bool                 m_frame_timer_started;
+    /*! Last frame times, used as ring buffer
+     */
+    sad::Vector<double>  m_frame_times;
+    /*! A position in frame times, where next time will be written, if buffer is full
+     */
+    size_t               m_frame_times_position;
+    /*! Maximal amount of stored frame times
+     */
+    size_t               m_frame_times_capacity;
     /*!  A warm-up  time for interpolation (ms)
      */
     static const double WarmupTime;
@@ -0,0 +1,129 @@
+/*! \file framepacer.h
+
+
+    A frame pacer, which limits frame rate of main loop, so it won't burn a full core
+ */
+#pragma once
+#include "timer.h"
+
+namespace sad
+{
+
+/*! Limits frame rate of main loop, waiting between frames. Waiting is hybrid: most of time
+    is slept, and last milliseconds are spinned with timer, since sleep could oversleep.
+    Also defines, whether main loop should block in waiting for system events, when
+    nothing happens in it.
+ */
+class FramePacer
+{
+public:
+    /*! A strategy for pacing frames
+     */
+    enum Strategy
+    {
+        FPS_UNLIMITED = 0,  //!< Frames are not paced, main loop runs as fast, as possible
+        FPS_TIMER = 1,      //!< Frames are paced by timer, with target FPS
+        FPS_VSYNC = 2       //!< Frames are paced by vertical synchronization. If not supported, timer is used
+    };
+    /*! Creates new pacer, which does not limit frame rate
+     */
+    FramePacer();
+    /*! Can be inherited
+     */
+    virtual ~FramePacer();
+    /*! Sets target FPS for timer strategy
+        \param[in] fps target FPS. Zero or negative value disables limiting
+     */
+    void setTargetFPS(double fps);
+    /*! Returns target FPS for timer strategy
+        \return target FPS
+     */
+    double targetFPS() const;
+    /*! Sets strategy for pacing frames. Strategy is applied, when main loop is started
+        \param[in] strategy a strategy
+     */
+    void setStrategy(sad::FramePacer::Strategy strategy);
+    /*! Returns strategy for pacing frames
+        \return strategy
+     */
+    sad::FramePacer::Strategy strategy() const;
+    /*! Sets time before end of frame, which will be spinned instead of sleeping
+        \param[in] ms time in milliseconds
+     */
+    void setSpinTime(double ms);
+    /*! Returns time before end of frame, which will be spinned instead of sleeping
+        \return time in milliseconds
+     */
+    double spinTime() const;
+    /*! Sets, whether main loop should block in waiting for system events,
+        when no events arrived, no user pipeline steps and no animations are running
+        \param[in] enabled whether it's enabled
+     */
+    void setIdleWaiting(bool enabled);
+    /*! Returns, whether main loop should block in waiting for system events, when idle
+        \return whether it's enabled
+     */
+    bool idleWaiting() const;
+    /*! Sets maximal time of blocking in waiting for system events. Main loop
+        wakes up after this time, even if no events arrived, so changes from other threads
+        are handled
+        \param[in] ms time in milliseconds
+     */
+    void setMaxIdleWaitTime(unsigned int ms);
+    /*! Returns maximal time of blocking in waiting for system events
+        \return time in milliseconds
+     */
+    unsigned int maxIdleWaitTime() const;
+    /*! Sets, whether vertical synchronization was successfully enabled. Set by main loop,
+        when applying strategy
+        \param[in] enabled whether it's enabled
+     */
+    void setVSyncEnabled(bool enabled);
+    /*! Returns, whether vertical synchronization is enabled
+        \return whether it's enabled
+     */
+    bool vsyncEnabled() const;
+    /*! Returns true, if pacer should wait between frames with timer
+        \return whether pacer waits between frames
+     */
+    bool waitsWithTimer() const;
+    /*! Returns duration of frame for target FPS
+        \return duration of frame in milliseconds (0 if not limited)
+     */
+    double frameTime() const;
+    /*! Starts timing of new frame, forgetting time of previous frames. Called, when
+        main loop is started or wakes up after waiting for events
+     */
+    virtual void reset();
+    /*! Waits until end of current frame and starts timing of new frame
+     */
+    virtual void waitForNextFrame();
+protected:
+    /*! A timer for measuring time of frame
+     */
+    sad::Timer m_timer;
+    /*! A target FPS
+     */
+    double m_target_fps;
+    /*! A strategy for pacing frames
+     */
+    sad::FramePacer::Strategy m_strategy;
+    /*! A time before end of frame, which is spinned instead of sleeping
+     */
+    double m_spin_time;
+    /*! Whether main loop should block in waiting for events, when idle
+     */
+    bool m_idle_waiting;
+    /*! A maximal time of blocking in waiting for events
+     */
+    unsigned int m_max_idle_wait_time;
+    /*! Whether vertical synchronization is enabled
+     */
+    bool m_vsync_enabled;
+    /*! A time, which previous frame overshot its end, subtracted from next frame
+        to keep average frame rate close to target
+     */
+    double m_lag;
+};
+
+}
@@ -114,6 +114,26 @@ bool isValid(const sad::Rect2D & rect);
  */
 bool isAABB(const sad::Rect2D& rect);
 
+/*! Computes an axis-aligned bounding box for points of rectangle. First point of result
+    contains minimal coordinates, third - maximal
+    \param[in] rect a rectangle
+    \return bounding box
+ */
+sad::Rect2D boundingBox(const sad::Rect2D& rect);
+
+/*! Extends axis-aligned bounding box, so it will contain all points of rectangle
+    \param[in, out] box a bounding box, computed by sad::boundingBox
+    \param[in] rect a rectangle
+ */
+void extendBoundingBox(sad::Rect2D& box, const sad::Rect2D& rect);
+
+/*! Tests, whether two bounding boxes, computed by sad::boundingBox, collide
+    \param[in] a first box
+    \param[in] b second box
+    \return whether they collide
+ */
+bool collidesAABB(const sad::Rect2D& a, const sad::Rect2D& b);
+
 /*! Computes rectangle which is axis-aligned to OXY and rotation angle for it
     \param[in] rect a rectangle element
     \param[out] base an-axis aligned element
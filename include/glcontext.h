@@ -39,6 +39,12 @@ public:
     /*! Swaps buffers. Must be called, after scene is rendered
      */
     virtual void swapBuffers();
+    /*! Sets swap interval, enabling (1) or disabling (0) vertical synchronization.
+        Context must be created and current
+        \param[in] interval amount of vertical retraces between swaps
+        \return whether swap interval is supported and was set
+     */
+    virtual bool setSwapInterval(int interval);
     /*! Maps a point from client coordinates to OpenGL viewport
         \param[in] p point
         \param[in] ztest whether ztesting should be performed
@@ -0,0 +1,74 @@
+/*! \file blockcompression.h
+    
+
+    Defines encoding and decoding of block-compressed pixels in BC1 (DXT1) and BC3 (DXT5) formats,
+    used by compressed textures
+ */
+#pragma once
+#include "../texture.h"
+
+namespace sad
+{
+
+namespace imageformats
+{
+
+/*! Encodes and decodes pixels in BC1 and BC3 formats. Pixels are split into 4x4 blocks,
+    stored row by row. BC1 block takes 8 bytes and supports only 1-bit alpha, BC3 block
+    takes 16 bytes and stores alpha separately from color.
+ */
+class BlockCompression
+{
+public:
+    /*! Returns, whether format is block-compressed
+        \param[in] format a format
+        \return whether format is compressed
+     */
+    static bool isCompressed(sad::Texture::InternalFormat format);
+    /*! Returns size of one 4x4 block in bytes
+        \param[in] format a compressed format
+        \return size of block (0 if format is not compressed)
+     */
+    static size_t blockSize(sad::Texture::InternalFormat format);
+    /*! Returns size of compressed image in bytes
+        \param[in] width a width of image in pixels
+        \param[in] height a height of image in pixels
+        \param[in] format a compressed format
+        \return size of image
+     */
+    static size_t compressedSize(unsigned int width, unsigned int height, sad::Texture::InternalFormat format);
+    /*! Compresses 32-bit RGBA pixels. Blocks on edges of image are padded with edge pixels
+        \param[in] pixels a source pixels
+        \param[in] width a width of image
+        \param[in] height a height of image
+        \param[in] format a compressed format
+        \param[out] blocks a destination, which must hold at least compressedSize bytes
+        \return false if format is not compressed
+     */
+    static bool compress(
+        const sad::uchar* pixels,
+        unsigned int width,
+        unsigned int height,
+        sad::Texture::InternalFormat format,
+        sad::uchar* blocks
+    );
+    /*! Decompresses blocks to 32-bit RGBA pixels
+        \param[in] blocks a source blocks
+        \param[in] width a width of image
+        \param[in] height a height of image
+        \param[in] format a compressed format
+        \param[out] pixels a destination, which must hold width * height * 4 bytes
+        \return false if format is not compressed
+     */
+    static bool decompress(
+        const sad::uchar* blocks,
+        unsigned int width,
+        unsigned int height,
+        sad::Texture::InternalFormat format,
+        sad::uchar* pixels
+    );
+};
+
+}
+
+}
@@ -0,0 +1,95 @@
+/*! \file compressedstorageloader.h
+    
+
+    Defines a loader for block-compressed pixels (BC1, BC3), stored as plain buffer of blocks,
+    preceded by signature, width and height. Unlike pixel storage formats, size of image
+    could be arbitrary.
+ */
+#pragma once
+#include "loader.h"
+
+namespace sad
+{
+
+namespace imageformats
+{
+/*! Defines a loader for block-compressed pixels, stored as plain buffer of blocks.
+    File consists of signature, width and height as 32-bit little-endian numbers
+    and blocks, stored row by row.
+ */
+class CompressedStorageLoader: public sad::imageformats::Loader
+{
+public:
+/*! A settings for a loader, which define, how specific format loaded will work
+ */ 
+struct Settings
+{
+    /*! Must point into buffer, where ethalon signature is defined
+     */
+    const unsigned char* Signature;
+    /*!  Contains a size of signature
+     */
+    size_t SignatureSize;
+    /*! Amount of bits per pixel in loaded texture
+     */
+    size_t Bpp;
+    /*! A format, which texture must have after loading image. Must be a value from sad::Texture::Format 
+     */
+    unsigned int Format;
+    /*! Constructs new settings
+        \param[in] s signature
+        \param[in] ssize signature size
+        \param[in] bpp bits per pixel in loaded texture
+        \param[in] fmt format format of loaded texture
+     */
+    inline Settings(const unsigned char* s, size_t ssize, size_t bpp, unsigned int fmt) : Signature(s), SignatureSize(ssize), Bpp(bpp), Format(fmt)
+    {
+    }
+};
+    /*! Makes new loader with specified settings
+        \param[in] settings a settings
+     */
+    CompressedStorageLoader(const sad::imageformats::CompressedStorageLoader::Settings& settings);
+    /*! Loads a texture from file stream. File must be opened in binary format for reading.
+        \param[in] file
+        \param[in] texture
+        \return true on success
+     */
+    virtual bool load(FILE * file, sad::Texture * texture);
+    /*! Loads texture from archive entry.
+        \param[in] entry a file entry to be loaded
+        \param[in] texture a source texture
+     */
+    virtual bool load(tar7z::Entry* entry, sad::Texture* texture);
+    /*! Saves texture to file stream in format of loader. Texture must be already compressed
+        in format of loader. File must be opened in binary format for writing.
+        \param[in] file a file
+        \param[in] texture a texture
+        \return true on success
+     */
+    bool save(FILE* file, const sad::Texture* texture);
+    /*! Kept for purpose of inheritance
+     */
+    virtual ~CompressedStorageLoader();
+    /*! A settings for SBC1 format
+     */
+    static sad::imageformats::CompressedStorageLoader::Settings SBC1Settings;
+    /*! A settings for SBC3 format
+     */
+    static sad::imageformats::CompressedStorageLoader::Settings SBC3Settings;
+protected:
+    /*! Reads size of image from header, validating it
+        \param[in] header a header, which follows signature
+        \param[out] width a width of image
+        \param[out] height a height of image
+        \return whether size is valid
+     */
+    static bool readSize(const sad::uchar* header, unsigned int& width, unsigned int& height);
+    /*! A settings for loader
+     */
+    sad::imageformats::CompressedStorageLoader::Settings m_settings;
+};
+
+}
+
+}
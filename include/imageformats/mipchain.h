@@ -0,0 +1,118 @@
+/*! \file mipchain.h
+    
+
+    Defines a chain of mip-maps, generated on CPU, which could be stored with image
+    and uploaded with texture, instead of generating mip-maps via OpenGL.
+ */
+#pragma once
+#include "../texture.h"
+#include "../sadvector.h"
+
+namespace sad
+{
+
+namespace imageformats
+{
+
+/*! A chain of mip-maps of texture, excluding base level, which is stored in texture itself.
+    Levels are stored in same format, as texture, so they could be uploaded as is.
+    Chains are built on CPU, so they could be generated on loader threads and independently
+    from driver.
+ */
+class MipChain
+{
+public:
+    /*! A filter, used to generate levels
+     */
+    enum Filter
+    {
+        MCF_BOX,    //!< An average of 2x2 block of pixels. Fastest one
+        MCF_KAISER  //!< A Kaiser-windowed sinc filter. Keeps images sharper
+    };
+    /*! A level of chain
+     */
+    struct Level
+    {
+        unsigned int Width;             //!< A width of level
+        unsigned int Height;            //!< A height of level
+        sad::Vector<sad::uchar> Data;   //!< A pixels of level in format of texture
+    };
+    /*! Creates empty chain
+     */
+    MipChain();
+    /*! Can be inherited
+     */
+    virtual ~MipChain();
+    /*! Builds chain for pixels of base level, down to 1x1 level. Supports 24-bit and 32-bit
+        textures in sad::Texture::SFT_R8_G8_B8_A8 format and all of packed formats
+        \param[in] pixels a pixels of base level
+        \param[in] width a width of base level
+        \param[in] height a height of base level
+        \param[in] bpp bits per pixel
+        \param[in] format a format of pixels
+        \param[in] filter a filter for downsampling
+        \return false if format is not supported
+     */
+    bool build(
+        const sad::uchar* pixels,
+        unsigned int width,
+        unsigned int height,
+        unsigned int bpp,
+        sad::Texture::InternalFormat format,
+        sad::imageformats::MipChain::Filter filter = sad::imageformats::MipChain::MCF_BOX
+    );
+    /*! Builds chain for texture. Texture must have pixels
+        \param[in] texture a texture
+        \param[in] filter a filter for downsampling
+        \return false if format is not supported
+     */
+    bool build(
+        const sad::Texture* texture,
+        sad::imageformats::MipChain::Filter filter = sad::imageformats::MipChain::MCF_BOX
+    );
+    /*! Returns amount of levels, excluding base level
+        \return amount of levels
+     */
+    unsigned int levels() const;
+    /*! Returns level of chain. First level has half size of base level
+        \param[in] i index of level
+        \return level
+     */
+    const sad::imageformats::MipChain::Level& level(unsigned int i) const;
+    /*! Adds new level to chain
+        \param[in] width a width of level
+        \param[in] height a height of level
+        \param[in] data a pixels of level
+     */
+    void addLevel(unsigned int width, unsigned int height, const sad::Vector<sad::uchar>& data);
+    /*! Removes all levels
+     */
+    void clear();
+    /*! Tests, whether chain contains all levels for base level with specified size
+        \param[in] width a width of base level
+        \param[in] height a height of base level
+        \param[in] bpp bits per pixel
+        \return whether chain is complete
+     */
+    bool isCompleteFor(unsigned int width, unsigned int height, unsigned int bpp) const;
+    /*! Returns size of next level for size of current level
+        \param[in] size a size of level
+        \return size of next level
+     */
+    static unsigned int nextLevelSize(unsigned int size);
+    /*! Returns amount of bytes, needed to store all levels of chain for base level
+        \param[in] width a width of base level
+        \param[in] height a height of base level
+        \param[in] bpp bits per pixel
+        \return amount of bytes
+     */
+    static size_t chainSize(unsigned int width, unsigned int height, unsigned int bpp);
+protected:
+    /*! A levels of chain
+     */
+    sad::Vector<sad::imageformats::MipChain::Level> m_levels;
+};
+
+}
+
+}
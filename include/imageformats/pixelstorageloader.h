@@ -2,7 +2,8 @@
     
 
     Defines a loader for primitive pixels, stored as plain buffer, preceded by size byte and signature.
-    A basic example of this format is SRGBA. 
+    A basic example of this format is SRGBA. Pixels could be followed by full chain of mip-maps,
+    which is uploaded instead of generating mip-maps on GPU.
 
     See https://github.com/mamontov-cpp/saddy-graphics-engine-2d/issues/82 , https://github.com/mamontov-cpp/saddy-graphics-engine-2d/issues/94 for details.
 
@@ -63,6 +64,14 @@ struct Settings
         \param[in] texture a source texture
      */
     virtual bool load(tar7z::Entry* entry, sad::Texture* texture);
+    /*! Saves texture to file stream in format of loader. Texture must be square with power of
+        two side and have same format as loader. If texture has complete chain of mip-maps,
+        it's saved after pixels. File must be opened in binary format for writing.
+        \param[in] file a file
+        \param[in] texture a texture
+        \return true on success
+     */
+    bool save(FILE* file, const sad::Texture* texture);
     /*! Kept for purpose of inheritance
      */
     virtual ~PixelStorageLoader();
@@ -5,6 +5,7 @@
  */
 #pragma once
 #include "loader.h"
+#include "../sadmutex.h"
 
 #include <istream>
 
@@ -68,6 +69,10 @@ protected:
         This field is set in sad::imageformats::TGALoader::load.	
      */
     std::istream * m_file;
+    /*! A lock, which serializes loading, since state of loading is stored in loader,
+        while textures could be loaded from several threads
+     */
+    sad::Mutex m_lock;
 };
 
 }
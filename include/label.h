@@ -101,6 +101,12 @@ public:
         \param[out] r a vector of regions
      */
     virtual void regions(sad::Vector<sad::Rect2D> & r);
+    /*! Computes bounding box of cached region of label without allocating regions.
+        Recomputes region, if it's stale
+        \param[out] r a bounding box
+        \return false if region could not be computed (font is not loaded yet), so label must not be culled
+     */
+    virtual bool boundingRect(sad::Rect2D & r);
     /*! A basic schema for object
         \return a schema 
      */
@@ -307,7 +307,13 @@ protected:
         \param[in] p point
      */
     static void normalize(sad::layouts::Cell::NormalizedRectangle& result, const sad::Point2D& p);
-    /*! Tries notify a grid, if update_grid is specified
+    /*! Returns size, which cell takes in grid: a preferred size, where non-automatic
+        width and height are replaced with computed ones
+        \return size of cell in grid
+     */
+    sad::Size2D layoutSize() const;
+    /*! Marks cell as dirty in grid. If update_grid is specified, grid is relayouted, otherwise
+        only cell is updated and grid will take it's changes into account on next relayout
         \param[in] update_grid whether we should notify a grid
      */
     void tryNotify(bool update_grid);
@@ -379,6 +385,12 @@ protected:
     /*! A database, which is cell is linked to 
      */
     sad::db::Database* m_db;
+    /*! Whether cell was changed since last relayout of grid
+     */
+    bool m_dirty;
+    /*! A size of cell in grid, cached on last relayout of grid
+     */
+    sad::Size2D m_layout_size;
 private:
     /*! This object is non-copyable
         \param[in] o object
@@ -71,11 +71,14 @@ public:
         \param[out] r a vector of regions
      */
     virtual void regions(sad::Vector<sad::Rect2D> & r);
-    /*! Loads grid from picojson object
-        \param[in] v a picojson object
-        \return  whether it as successfull
+    /*! Marks grid as loading, so cells are not rebuilt, while properties are set
      */
-    virtual bool load(const picojson::value& v);        
+    virtual void beginLoading();
+    /*! Validates grid and makes views for cells, when properties are loaded
+        \param[in] loaded whether properties were loaded successfully
+        \return whether grid is loaded successfully
+     */
+    virtual bool finishLoading(bool loaded);
     /*! A basic schema for object
         \return a schema 
      */
@@ -235,6 +238,43 @@ public:
     /*! Forces grid to recompute all items for cells
      */ 
     void update();
+    /*! Recomputes only rows and columns, affected by cells, which were changed since last
+        relayout. Only cells, which are changed or which assigned areas are changed, are updated.
+        If structure or area of grid was changed, everything is recomputed
+     */
+    void relayout();
+    /*! Starts a batch of changes. While batch is active, changes of grid and it's cells
+        don't relayout grid, it will be relayouted once, when batch is finished.
+        Batches could be nested
+     */
+    void beginBatch();
+    /*! Finishes a batch of changes. If it's outermost batch and grid was changed, relayouts grid
+     */
+    void endBatch();
+    /*! Returns true, if batch of changes is active
+        \return whether batch is active
+     */
+    bool isBatching() const;
+    /*! Sets, whether relayouting should be deferred to a task in pipeline of renderer,
+        so all changes, done in one frame, cause only one relayout before scenes are rendered.
+        If grid is not attached to renderer, it's relayouted immediately
+        \param[in] deferred whether updates are deferred
+     */
+    void setDeferredUpdates(bool deferred);
+    /*! Returns true, if relayouting is deferred to a task in pipeline of renderer
+        \return whether updates are deferred
+     */
+    bool deferredUpdates() const;
+    /*! Returns true, if grid was changed, but not relayouted yet
+        \return whether grid should be relayouted
+     */
+    bool needsRelayout() const;
+    /*! Marks cell as changed, so it's size, it's rows and columns will be recomputed
+        on next relayout. Called by cells, when they are changed
+        \param[in] cell a changed cell
+        \param[in] relayout whether grid should be relayouted
+     */
+    void markDirty(sad::layouts::Cell* cell, bool relayout);
     /*! Returns a a major ids list for all children of all cells
         \return list of major ids
      */
@@ -281,6 +321,16 @@ private:
         \param[in] newcols a new rows count
      */
     void shrinkColumns(size_t oldcols, size_t newcols);
+    /*! Marks all cells, rows and columns as changed and relayouts grid, if possible
+     */
+    void invalidate();
+    /*! Relayouts grid now, or postpones it, if grid is loading, batch is active
+        or updates are deferred
+     */
+    void requestRelayout();
+    /*! Relayouts grid, if it's still needed. Called from pipeline, when updates are deferred
+     */
+    void performDeferredRelayout();
     /*! Regenerates cell views array, according to current settings
         \param[in] prows a pointer, which should point to current rows count (NULL for current rows)
         \param[in] pcols a pointer, which should point to current columns count (NULL for current columns)
@@ -375,6 +425,30 @@ private:
     /*! Toggles loading mode on grid. If grid is loading, no update should be called
      */
     bool m_loading; 
+    /*! Natural heights of rows, computed from cells on last relayout
+     */
+    sad::Vector<double> m_row_heights;
+    /*! Natural widths of columns, computed from cells on last relayout
+     */
+    sad::Vector<double> m_col_widths;
+    /*! Cells, changed since last relayout
+     */
+    sad::Vector<sad::layouts::Cell*> m_dirty_cells;
+    /*! Whether everything should be recomputed on next relayout
+     */
+    bool m_full_relayout;
+    /*! Whether grid was changed, but not relayouted yet
+     */
+    bool m_relayout_pending;
+    /*! A nesting level of batches of changes
+     */
+    unsigned int m_batch_depth;
+    /*! Whether relayouting is deferred to a pipeline of renderer
+     */
+    bool m_deferred_updates;
+    /*! Whether relayouting task is already added to pipeline
+     */
+    bool m_relayout_scheduled;
 };
 
 }   
@@ -45,6 +45,9 @@ public:
         \param[in] message received message
      */
     virtual void receive(const sad::log::Message & message);
+    /*! Flushes file, if it's opened
+     */
+    virtual void flush();
     /*! Set minimal priority, which can be output
         \param[in] priority level message
      */ 
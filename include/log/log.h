@@ -11,16 +11,22 @@
 #include "filetarget.h"
 #include "consoletarget.h"
 #include "logscope.h"
+#include "overflowpolicy.h"
+#include "messagequeue.h"
 
 #include "../sadvector.h"
 #include "../sadstring.h"
 #include "../sadmutex.h"
+#include "../sadsemaphore.h"
+
+#include <atomic>
 
 
 
 
 namespace sad
 {
+class Thread;
 
 namespace log
 {
@@ -221,9 +227,57 @@ public:
     /*! Creates new empty log
      */
     inline Log() 
+    : m_queue(NULL), 
+    m_worker(NULL), 
+    m_overflow_policy(sad::log::LOP_BLOCK), 
+    m_stopping(false), 
+    m_queued_messages(0), 
+    m_blocked_writers(0), 
+    m_dropped_messages(0), 
+    m_blocked_messages(0)
     {
         m_internal_mode = false;
     }
+    /*! Enables or disables asynchronous mode. In asynchronous mode messages are pushed
+        into bounded queue and a background thread broadcasts them to targets in batches,
+        so logging thread is not blocked by output. When mode is disabled, all queued messages
+        are broadcasted before returning. Must not be called, while other threads are logging.
+        \param[in] async whether log should be asynchronous
+        \param[in] capacity a capacity of queue of messages
+        \param[in] policy a policy, used when queue of messages is full
+     */
+    void setAsynchronous(
+        bool async, 
+        size_t capacity = 4096, 
+        sad::log::OverflowPolicy policy = sad::log::LOP_BLOCK
+    );
+    /*! Returns whether log is asynchronous
+        \return whether log is asynchronous
+     */
+    bool isAsynchronous() const;
+    /*! Sets policy, used when queue of messages is full
+        \param[in] policy a policy
+     */
+    void setOverflowPolicy(sad::log::OverflowPolicy policy);
+    /*! Returns policy, used when queue of messages is full
+        \return policy
+     */
+    sad::log::OverflowPolicy overflowPolicy() const;
+    /*! Returns amount of messages, which were dropped, because queue was full
+        \return amount of dropped messages
+     */
+    size_t droppedMessages() const;
+    /*! Returns amount of messages, for which logging thread was blocked, because queue was full
+        \return amount of blocked messages
+     */
+    size_t blockedMessages() const;
+    /*! Resets counters of dropped and blocked messages
+     */
+    void resetCounters();
+    /*! Broadcasts all queued messages to targets and flushes targets. Called
+        by sad::Renderer::emergencyShutdown, so messages won't be lost
+     */
+    virtual void flush();
     /*! Sets internal mode. If true, on sad::log::Log::pushAction, 
         log will generate internal messages
         \param[in] mode a new internal mode
@@ -247,10 +301,65 @@ protected:
         sad::log::Log::pushSubsystem(), popped with sad::log::Log::popSubsystem()
      */
     sad::Vector<sad::String> m_subsystems;
+    /*! A queue of messages in asynchronous mode (NULL if log is synchronous)
+     */
+    sad::log::MessageQueue* m_queue;
+    /*! A background thread, which broadcasts queued messages
+     */
+    sad::Thread* m_worker;
+    /*! A semaphore, released, when messages are queued into empty queue
+     */
+    sad::Semaphore m_queue_semaphore;
+    /*! A semaphore, released, when queued messages are taken for broadcasting,
+        so threads, blocked on full queue, could try again
+     */
+    sad::Semaphore m_space_semaphore;
+    /*! A lock, which is held, when queued messages are broadcasted, so they are
+        broadcasted in same order, even when flushed from other thread
+     */
+    ::sad::Mutex m_drain_lock;
+    /*! A policy, used when queue of messages is full
+     */
+    sad::log::OverflowPolicy m_overflow_policy;
+    /*! Whether background thread should stop
+     */
+    std::atomic<bool> m_stopping;
+    /*! An amount of queued messages, which are not taken for broadcasting yet.
+        Could be off by a few, while messages are pushed or popped
+     */
+    std::atomic<size_t> m_queued_messages;
+    /*! An amount of threads, which should be woken via m_space_semaphore
+     */
+    std::atomic<size_t> m_blocked_writers;
+    /*! An amount of dropped messages
+     */
+    std::atomic<size_t> m_dropped_messages;
+    /*! An amount of messages, for which logging thread was blocked
+     */
+    std::atomic<size_t> m_blocked_messages;
     /*! Returns a current subsystem
         \return name of current subsystem
      */
     virtual sad::String subsystem();
+    /*! Broadcasts a message to all targets at once
+        \param[in] m message
+     */
+    void broadcastNow(const sad::log::Message & m);
+    /*! Pushes message into queue of messages, applying overflow policy if queue is full.
+        Log takes ownership of message
+        \param[in] m message
+     */
+    void enqueue(sad::log::Message * m);
+    /*! Counts queued message, waking background thread, if queue was empty
+     */
+    void notifyQueued();
+    /*! Pops all queued messages and broadcasts them to targets in batches
+     */
+    void drainQueue();
+    /*! A main loop of background thread
+        \return zero
+     */
+    int processQueue();
     /*! Creates new message and broadcasts them to all contained targets
         \param[in] mesg text message, that is being logged
         \param[in] priority  a priority for message
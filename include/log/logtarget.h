@@ -28,6 +28,9 @@ public:
         \param[in] message taken message
      */
     virtual void receive(const sad::log::Message & message) = 0;
+    /*! Flushes all buffered output. Default implementation does nothing
+     */
+    virtual void flush();
     /*! Kept only for inheritance conformance. Does nothing
      */
     virtual ~Target();
@@ -0,0 +1,89 @@
+/*! \file messagequeue.h
+
+
+    Describes a bounded lock-free queue of messages, used by asynchronous log
+ */
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+namespace sad
+{
+
+namespace log
+{
+class Message;
+
+/*! A bounded lock-free queue of messages, which supports several producers and several consumers.
+    Every cell of queue keeps a sequence number, which tells, whether cell is ready to be
+    written or read, so producers and consumers only compete on positions, not on cells.
+    Queue owns messages, stored in it, deleting them on destruction.
+ */
+class MessageQueue
+{
+public:
+    /*! Makes new queue
+        \param[in] capacity a capacity of queue (rounded up to power of two, at least 2)
+     */
+    MessageQueue(size_t capacity);
+    /*! Frees all messages, which are stored in queue
+     */
+    ~MessageQueue();
+    /*! Returns capacity of queue
+        \return capacity
+     */
+    size_t capacity() const;
+    /*! Tries to push message into queue. If succeeded, queue takes ownership of message.
+        \param[in] m message
+        \return true if message is pushed, false if queue is full
+     */
+    bool tryPush(sad::log::Message* m);
+    /*! Tries to pop message from queue. Caller takes ownership of returned message.
+        \return message or NULL if queue is empty
+     */
+    sad::log::Message* tryPop();
+private:
+    /*! A cell of queue
+     */
+    struct Cell
+    {
+        /*! A sequence number of cell
+         */
+        std::atomic<size_t> Sequence;
+        /*! A stored message
+         */
+        sad::log::Message* Data;
+    };
+    /*! Disabled copying
+        \param[in] o other queue
+     */
+    MessageQueue(const sad::log::MessageQueue& o);
+    /*! Disabled copying
+        \param[in] o other queue
+        \return self-reference
+     */
+    sad::log::MessageQueue& operator=(const sad::log::MessageQueue& o);
+
+    /*! Cells of queue
+     */
+    sad::log::MessageQueue::Cell* m_cells;
+    /*! A mask for getting index of cell by position
+     */
+    size_t m_mask;
+    /*! A padding to keep positions in different cache lines
+     */
+    char m_padding1[64];
+    /*! A position for pushing messages
+     */
+    std::atomic<size_t> m_push_position;
+    /*! A padding to keep positions in different cache lines
+     */
+    char m_padding2[64];
+    /*! A position for popping messages
+     */
+    std::atomic<size_t> m_pop_position;
+};
+
+}
+
+}
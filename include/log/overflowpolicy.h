@@ -0,0 +1,25 @@
+/*! \file overflowpolicy.h
+
+
+    Defines a policy, used by asynchronous log, when queue of messages is full
+ */
+#pragma once
+
+namespace sad
+{
+
+namespace log
+{
+
+/*! Defines, what should asynchronous log do with new message, when queue of messages is full
+ */
+enum OverflowPolicy
+{
+    LOP_BLOCK = 0,       //!< Block producing thread, until there is a place for message
+    LOP_DROP_OLDEST = 1, //!< Drop oldest message in queue, making a place for new message
+    LOP_DROP_NEWEST = 2  //!< Drop new message
+};
+
+}
+
+}
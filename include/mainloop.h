@@ -10,6 +10,7 @@
 namespace sad
 {
 class Renderer;
+class FramePacer;
 
 namespace os
 {
@@ -52,6 +53,24 @@ public:
         \return dispatcher for loop
      */
     virtual sad::os::SystemEventDispatcher *  dispatcher();
+    /*! Returns frame pacer, which limits frame rate of loop and defines, whether
+        loop should wait for system events, when idle
+        \return frame pacer
+     */
+    sad::FramePacer* framePacer() const;
+    /*! Sets maximal amount of frames, after which loop stops. Useful for running
+        headless renderer in benchmarks and tests
+        \param[in] frames amount of frames (0 for unlimited)
+     */
+    void setFrameLimit(unsigned int frames);
+    /*! Returns maximal amount of frames, after which loop stops
+        \return amount of frames (0 for unlimited)
+     */
+    unsigned int frameLimit() const;
+    /*! Returns amount of frames, performed since loop was started
+        \return amount of frames
+     */
+    unsigned int frameCount() const;
     /*! Determines, whether main loop is running
         \return whether main loop is running
      */
@@ -87,6 +106,20 @@ protected:
     /*! Forces built-in OS scheduler switch to other processes
      */
     void forceSchedulerSwitchToOtherProcesses();
+    /*! Applies strategy of frame pacer, setting swap interval of context
+     */
+    virtual void applyFramePacing();
+    /*! Tests, whether loop is idle and could block in waiting for system events:
+        no events arrived on this iteration, no user steps are in pipeline and no animations
+        are running
+        \param[in] hadevents whether some events arrived on this iteration
+        \return whether loop is idle
+     */
+    virtual bool isIdle(bool hadevents) const;
+    /*! Blocks, until system event arrives or time is out
+        \param[in] ms maximal time of waiting in milliseconds
+     */
+    virtual void waitForSystemEvents(unsigned int ms);
     /*! Determines, whether main loop is running
      */
     bool m_running;
@@ -96,6 +129,15 @@ protected:
     /*! A system event disptacher for dispachign all events
      */
     sad::os::SystemEventDispatcher * m_dispatcher;
+    /*! A frame pacer for loop
+     */
+    sad::FramePacer * m_frame_pacer;
+    /*! A maximal amount of frames, after which loop stops
+     */
+    unsigned int m_frame_limit;
+    /*! An amount of frames, performed since loop was started
+     */
+    unsigned int m_frame_count;
 private:
     /*! Disabled to made main loop non-copyable
         \param[in] o other main loop
@@ -0,0 +1,331 @@
+/*! \file matrix4x4.h
+    
+
+    Defines a 4x4 matrix of homogeneous transformations, used to keep projection and camera
+    transformations on CPU side, so they could be inverted without reading them back from OpenGL
+ */
+#pragma once
+#include "sadpoint.h"
+#include "sadpair.h"
+#include <math.h>
+
+#ifndef M_PI
+    #define M_PI (3.14159265358979323846)
+#endif
+
+namespace sad
+{
+/*! A 4x4 matrix of homogeneous transformations. Matrices are built in the same way, as
+    fixed-function pipeline of OpenGL builds them, so they could be loaded via glLoadMatrix
+    and compared with results of OpenGL
+ */
+template<typename T>
+class Matrix4x4
+{
+private:
+    T m_o[4][4]; //!< An array used to store all of data
+public:
+    typedef sad::Pair<unsigned int, unsigned int> index;
+    /*! Constructs identity matrix
+     */
+    Matrix4x4()
+    {
+        for(int i = 0; i < 4; i++)
+        {
+            for(int j = 0; j < 4; j++)
+            {
+                m_o[i][j] = (i == j) ? (T)1 : (T)0;
+            }
+        }
+    }
+    /*! Constructs identity matrix
+        \return matrix
+     */
+    static Matrix4x4 identity()
+    {
+        return Matrix4x4();
+    }
+    /*! Constructs translation matrix, like glTranslate does
+        \param[in] x x offset
+        \param[in] y y offset
+        \param[in] z z offset
+        \return matrix
+     */
+    static Matrix4x4 translation(T x, T y, T z)
+    {
+        Matrix4x4 result;
+        result.m_o[0][3] = x;
+        result.m_o[1][3] = y;
+        result.m_o[2][3] = z;
+        return result;
+    }
+    /*! Constructs counter-clockwise rotation matrix around axis, like glRotate does.
+        Zero axis results in identity matrix
+        \param[in] angle an angle in degrees
+        \param[in] x x component of axis
+        \param[in] y y component of axis
+        \param[in] z z component of axis
+        \return matrix
+     */
+    static Matrix4x4 rotation(T angle, T x, T y, T z)
+    {
+        Matrix4x4 result;
+        T length = sqrt(x * x + y * y + z * z);
+        if (length == (T)0)
+        {
+            return result;
+        }
+        x /= length;
+        y /= length;
+        z /= length;
+        T radians = angle / (T)180 * (T)M_PI;
+        T c = cos(radians);
+        T s = sin(radians);
+        T ic = (T)1 - c;
+        result.m_o[0][0] = x * x * ic + c;
+        result.m_o[0][1] = x * y * ic - z * s;
+        result.m_o[0][2] = x * z * ic + y * s;
+        result.m_o[1][0] = y * x * ic + z * s;
+        result.m_o[1][1] = y * y * ic + c;
+        result.m_o[1][2] = y * z * ic - x * s;
+        result.m_o[2][0] = x * z * ic - y * s;
+        result.m_o[2][1] = y * z * ic + x * s;
+        result.m_o[2][2] = z * z * ic + c;
+        return result;
+    }
+    /*! Constructs orthographic projection matrix, like glOrtho does
+        \param[in] left a left clipping plane
+        \param[in] right a right clipping plane
+        \param[in] bottom a bottom clipping plane
+        \param[in] top a top clipping plane
+        \param[in] znear a near clipping plane
+        \param[in] zfar a far clipping plane
+        \return matrix
+     */
+    static Matrix4x4 ortho(T left, T right, T bottom, T top, T znear, T zfar)
+    {
+        Matrix4x4 result;
+        result.m_o[0][0] = (T)2 / (right - left);
+        result.m_o[1][1] = (T)2 / (top - bottom);
+        result.m_o[2][2] = (T)(-2) / (zfar - znear);
+        result.m_o[0][3] = -(right + left) / (right - left);
+        result.m_o[1][3] = -(top + bottom) / (top - bottom);
+        result.m_o[2][3] = -(zfar + znear) / (zfar - znear);
+        return result;
+    }
+    /*! Constructs orthographic projection matrix for viewport, like gluOrtho2D(0, width, 0, height) does
+        \param[in] width a width of viewport
+        \param[in] height a height of viewport
+        \return matrix
+     */
+    static Matrix4x4 ortho2D(T width, T height)
+    {
+        return sad::Matrix4x4<T>::ortho(0, width, 0, height, -1, 1);
+    }
+    /*! Constructs perspective projection matrix, like gluPerspective does
+        \param[in] fovy a field of view angle in degrees in y direction
+        \param[in] aspect an aspect ratio (width divided by height)
+        \param[in] znear a distance to near clipping plane
+        \param[in] zfar a distance to far clipping plane
+        \return matrix
+     */
+    static Matrix4x4 perspective(T fovy, T aspect, T znear, T zfar)
+    {
+        Matrix4x4 result;
+        T f = (T)1 / tan(fovy / (T)360 * (T)M_PI);
+        result.m_o[0][0] = f / aspect;
+        result.m_o[1][1] = f;
+        result.m_o[2][2] = (zfar + znear) / (znear - zfar);
+        result.m_o[2][3] = (T)2 * zfar * znear / (znear - zfar);
+        result.m_o[3][2] = (T)(-1);
+        result.m_o[3][3] = (T)0;
+        return result;
+    }
+    /*! Returns a value by position
+        \param[in] i index of row in matrix
+        \param[in] j index of column in matrix
+        \return value, stored in matrix (0 if out of range)
+     */
+    T get(unsigned int i , unsigned int j) const
+    {
+        if (i >= 4 || j >= 4) return (T)0;
+        return m_o[i][j];
+    }
+    /*! Sets a value by position. Does nothing, if position is out of range
+        \param[in] i index of row in matrix
+        \param[in] j index of column in matrix
+        \param[in] value a value
+     */
+    void set(unsigned int i, unsigned int j, T value)
+    {
+        if (i >= 4 || j >= 4) return;
+        m_o[i][j] = value;
+    }
+    /*! Returns a value by position
+        \param[in] i index of value in matrix
+        \return value, stored in matrix (0 if out of range)
+     */
+    T operator[](const typename Matrix4x4<T>::index & i) const
+    {
+        return get(i.p1(), i.p2());
+    }
+    /*! Copies matrix into array in column-major order, as expected by glLoadMatrix
+        \param[out] data an array of 16 elements
+     */
+    void toColumnMajor(T* data) const
+    {
+        for(int j = 0; j < 4; j++)
+        {
+            for(int i = 0; i < 4; i++)
+            {
+                data[j * 4 + i] = m_o[i][j];
+            }
+        }
+    }
+    /*! Multiplies matrix by other matrix. Transformation of other matrix is applied first,
+        like in glMultMatrix
+        \param[in] o other matrix
+        \return result
+     */
+    Matrix4x4 operator*(const Matrix4x4& o) const
+    {
+        Matrix4x4 result;
+        for(int i = 0; i < 4; i++)
+        {
+            for(int j = 0; j < 4; j++)
+            {
+                T sum = 0;
+                for(int k = 0; k < 4; k++)
+                {
+                    sum += m_o[i][k] * o.m_o[k][j];
+                }
+                result.m_o[i][j] = sum;
+            }
+        }
+        return result;
+    }
+    /*! Transforms homogeneous vector by matrix
+        \param[in] in a source vector
+        \param[out] out a result vector
+     */
+    void transform(const T* in, T* out) const
+    {
+        for(int i = 0; i < 4; i++)
+        {
+            out[i] = m_o[i][0] * in[0] + m_o[i][1] * in[1] + m_o[i][2] * in[2] + m_o[i][3] * in[3];
+        }
+    }
+    /*! Transforms point by matrix with perspective division
+        \param[in] p point
+        \return transformed point (same point, if it's transformed to infinity)
+     */
+    sad::Point3<T> transform(const sad::Point3<T>& p) const
+    {
+        T in[4] = { p.x(), p.y(), p.z(), (T)1 };
+        T out[4];
+        this->transform(in, out);
+        if (out[3] == (T)0)
+        {
+            return p;
+        }
+        return sad::Point3<T>(out[0] / out[3], out[1] / out[3], out[2] / out[3]);
+    }
+    /*! Computes inverse matrix, using cofactors
+        \param[out] result an inverse matrix
+        \return false, if matrix is singular
+     */
+    bool inverse(Matrix4x4& result) const
+    {
+        T m[16];
+        T inv[16];
+        this->toColumnMajor(m);
+        inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15]
+               + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+        inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15]
+               - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+        inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15]
+               + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+        inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14]
+                - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+        inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15]
+               - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+        inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15]
+               + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+        inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15]
+               - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+        inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14]
+                + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+        inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15]
+               + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+        inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15]
+               - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+        inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15]
+                + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+        inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14]
+                - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+        inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11]
+               - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+        inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11]
+               + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+        inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11]
+                - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+        inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10]
+                + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+        T det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+        if (det == (T)0)
+        {
+            return false;
+        }
+        for(int j = 0; j < 4; j++)
+        {
+            for(int i = 0; i < 4; i++)
+            {
+                result.m_o[i][j] = inv[j * 4 + i] / det;
+            }
+        }
+        return true;
+    }
+};
+
+/*! Maps window coordinates to object coordinates, like gluUnProject does, but without
+    any calls to OpenGL
+    \param[in] window a window coordinates (x and y are in pixels with origin at bottom left corner
+                      of viewport, z is depth in range [0, 1])
+    \param[in] modelview a model-view matrix
+    \param[in] projection a projection matrix
+    \param[in] viewport a viewport as x, y, width and height
+    \param[out] result a result point
+    \return false, if point could not be mapped
+ */
+template<typename T>
+bool unProject(
+    const sad::Point3<T>& window,
+    const sad::Matrix4x4<T>& modelview,
+    const sad::Matrix4x4<T>& projection,
+    const int* viewport,
+    sad::Point3<T>& result
+)
+{
+    sad::Matrix4x4<T> inverse;
+    if ((projection * modelview).inverse(inverse) == false)
+    {
+        return false;
+    }
+    T in[4] = {
+        (window.x() - viewport[0]) / viewport[2] * (T)2 - (T)1,
+        (window.y() - viewport[1]) / viewport[3] * (T)2 - (T)1,
+        window.z() * (T)2 - (T)1,
+        (T)1
+    };
+    T out[4];
+    inverse.transform(in, out);
+    if (out[3] == (T)0)
+    {
+        return false;
+    }
+    result = sad::Point3<T>(out[0] / out[3], out[1] / out[3], out[2] / out[3]);
+    return true;
+}
+
+}
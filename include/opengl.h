@@ -8,6 +8,7 @@
 #pragma
 #include "sadstring.h"
 #include "sadpair.h"
+#include "rendering/glstatecache.h"
 
 namespace sad
 {
@@ -67,6 +68,12 @@ public:
         \return whether OpenGL extension is presented
      */
     bool supportsExtension(const sad::String & extension);
+    /*! Returns a cache of OpenGL state for context of attached renderer.
+        Code, which changes bound texture, color, blending or matrix mode
+        directly, must notify cache or invalidate it
+        \return cache of state
+     */
+    sad::rendering::GLStateCache* stateCache();
 protected:
     /*! Tries to fetch OpenGL strings via glGetString
      */
@@ -103,6 +110,9 @@ protected:
     /*! An extensions string
      */
     sad::String m_extensions;
+    /*! A cache of OpenGL state
+     */
+    sad::rendering::GLStateCache m_state_cache;
 };
 
 }
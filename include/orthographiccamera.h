@@ -33,9 +33,15 @@ public:
      */
     OrthographicCamera(int width, int height);
     /*! Applies an orthographic projection matrices, using gluOrtho2D function, clearing
-        another matrices. After that applies matrix transformation
+        another matrices, and sets projection matrix of renderer. After that applies matrix transformation
      */
     virtual void apply();
+    /*! Computes a part of scene, visible through camera. Size of projection is known only
+        after camera is applied, if it's taken from settings of renderer
+        \param[out] r a bounding box of visible part of scene
+        \return whether part could be computed
+     */
+    virtual bool viewRect(sad::Rect2D & r) const;
     /*! Kept for purpose of inheritance
      */
     virtual ~OrthographicCamera();
@@ -45,6 +51,10 @@ private:
     bool m_fetched;  
     int  m_width;    //!< Width or viewed maximal X coordinate 
     int  m_height;   //!< Height  or viewed maximal Y coordinate 
+    /*! A projection matrix, computed once width and height are known, 
+        so renderer could map cursor without reading it from OpenGL
+     */
+    sad::Matrix4x4<double> m_projection;
 };
 
 }
@@ -0,0 +1,40 @@
+/*! \file compressedteximage2d.h
+    
+
+    Defines crossplatform uploading of compressed 2D textures, as in OpenGL 1.3+
+ */
+#pragma once
+#include "glheaders.h"
+
+namespace sad
+{
+class Renderer;
+
+namespace os
+{
+
+/*! Uploads compressed image of texture, like glCompressedTexImage2D does
+    \param[in] r renderer, which will render texture
+    \param[in] target a target texture type
+    \param[in] level a level of mip-map
+    \param[in] internalformat a compressed format of image
+    \param[in] width a width of image
+    \param[in] height a height of image
+    \param[in] size a size of compressed data in bytes
+    \param[in] data a compressed data
+    \return whether we got some pointer to a function "glCompressedTexImage2D" and called it
+ */
+bool compressedTexImage2D(
+    sad::Renderer * r,
+    GLenum target,
+    GLint level,
+    GLenum internalformat,
+    GLsizei width,
+    GLsizei height,
+    GLsizei size,
+    const GLvoid* data
+);
+
+}
+
+}
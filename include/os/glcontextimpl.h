@@ -48,6 +48,11 @@ public:
     /*! Swaps buffers. Must be called, after scene is rendered
      */
     virtual void swapBuffers();
+    /*! Sets swap interval, enabling (1) or disabling (0) vertical synchronization
+        \param[in] interval amount of vertical retraces between swaps
+        \return whether swap interval is supported and was set
+     */
+    virtual bool setSwapInterval(int interval);
     /*! Makes context current for a window
      */
     virtual void makeCurrent();
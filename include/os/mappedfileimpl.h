@@ -0,0 +1,77 @@
+/*! \file       mappedfileimpl.h
+     
+    Contains crossplatform read-only mapping of file into memory, which uses mmap on 
+    Linux and file mapping objects on Windows. Mapped pages are copy-on-write, so
+    they could be changed without changing file.
+*/
+#pragma once
+#ifdef WIN32
+    #ifndef NOMINMAX
+    #define NOMINMAX 
+    #endif
+    #include  <windows.h>
+#endif
+#include <cstdio>
+#include <cstddef>
+
+namespace sad
+{
+
+namespace os
+{
+
+/*! \class MappedFileImpl
+    
+    A file, mapped into memory. Pages are read from page cache of system on first
+    access, so no buffer is allocated and no data is copied, when file is mapped
+*/
+class MappedFileImpl
+{
+public:
+    /*! Creates new unmapped file
+     */
+    MappedFileImpl();
+    /*! Unmaps file, releasing system resources
+     */
+    ~MappedFileImpl();
+    /*! Maps whole opened file into memory. File could be closed after mapping
+        \param[in] file a file, opened for reading
+        \return whether file was mapped
+     */
+    bool map(FILE* file);
+    /*! Unmaps file
+     */
+    void unmap();
+    /*! Returns mapped contents of file
+        \return contents (NULL if not mapped)
+     */
+    unsigned char* data() const;
+    /*! Returns size of mapped file
+        \return size
+     */
+    size_t size() const;
+protected:
+    /*! A mapped contents of file
+     */
+    unsigned char* m_data;
+    /*! A size of mapped file
+     */
+    size_t m_size;
+#ifdef WIN32
+    HANDLE m_mapping;  //!< A system-dependent handle of mapping
+#endif
+private:
+    /*! Cannot be copied, so this is disabled and not implemented
+        \param[in] o other file
+     */
+    MappedFileImpl(const sad::os::MappedFileImpl & o);
+    /*! Cannot be copied, so this is disabled and not implemented
+        \param[in] o other file
+        \return self-reference
+     */ 
+    sad::os::MappedFileImpl & operator=(const sad::os::MappedFileImpl & o);
+};
+
+}
+
+}
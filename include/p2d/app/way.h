@@ -107,11 +107,11 @@ public:
         \return schema
      */
     virtual sad::db::schema::Schema* schema() const;
-    /*! Loads sprite from picojson object
-        \param[in] v a picojson object
+    /*! Constructs way, when properties are loaded
+        \param[in] loaded whether properties were loaded successfully
         \return  whether it as successfull
      */
-    virtual bool load(const picojson::value& v);
+    virtual bool finishLoading(bool loaded);
 protected:
     bool m_constructed; //!< Whether way is constructed
     bool m_closed;		//!< Whether way is closed
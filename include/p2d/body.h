@@ -9,10 +9,14 @@
 #include "force.h"
 #include "angularforce.h"
 #include "movement.h"
+#include "boundingbox.h"
+#include "convexhull.h"
 
 #include "../object.h"
 #include "../sadstring.h"
 
+#include <atomic>
+
 
 /*! A special point, which can be added to time or other values to make objects
     not collide
@@ -54,6 +58,13 @@ public:
         \return what shape, body had at specified time
      */
     virtual p2d::CollisionShape & at(double time, int index = 0) const;
+    /*! Returns sample of shape with specified index, cached by sad::p2d::Body::at.
+        Samples must be accessed by this method instead of pointer arithmetic on
+        Temporary, since size of shape type is not a size of sad::p2d::CollisionShape
+        \param[in] index index of sample
+        \return sample
+     */
+    p2d::CollisionShape * sample(int index) const;
     /*! Notifies body, that item is rotated
         \param[in] delta difference between angles 
      */
@@ -130,6 +141,16 @@ public:
         \return world
      */
     p2d::World * world();
+    /*! Binds movements of body to slot of packed kinematic state, so position and velocities
+        of body are stored in it. Used by world, when body is added to it
+        \param[in] state a state (NULL to unbind body and store values in body again)
+        \param[in] slot a slot in state
+     */
+    void setKinematicState(p2d::KinematicState* state, size_t slot = 0);
+    /*! Returns a packed kinematic state, where position and velocities are stored
+        \return state (NULL if body stores them by itself)
+     */
+    p2d::KinematicState* kinematicState() const;
     /*! Sets new shape for a body. Shape must have center at (0,0)
         and rotated by zero angle. It will move automatically to current 
         points and rotate by specified angle
@@ -244,6 +265,29 @@ public:
         \return next position
      */
     double nextAngularVelocity() const;
+    /*! Returns position of body, which it had before last step of world
+        \return previous position
+     */
+    const p2d::Vector & previousPosition() const;
+    /*! Returns angle of body, which it had before last step of world
+        \return previous angle
+     */
+    double previousAngle() const;
+    /*! Returns interpolation alpha for body, set by world in fixed step mode. A scene nodes
+        can use it to render body between previous and current step
+        \return interpolation alpha (1 if body is not in world)
+     */
+    double interpolationAlpha() const;
+    /*! Returns position of body, interpolated between previous and current step of world
+        by interpolation alpha
+        \return interpolated position
+     */
+    p2d::Vector interpolatedPosition() const;
+    /*! Returns angle of body, interpolated between previous and current step of world
+        by interpolation alpha
+        \return interpolated angle
+     */
+    double interpolatedAngle() const;
     /*! Moves body by specified vector
         \param[in] v vector
      */
@@ -330,6 +374,19 @@ public:
         \return velocity
      */
     p2d::Vector tangentialVelocityAt(double time);
+    /*! Returns a difference between position of body at specified time of current step and
+        current position. Unlike sampling with sad::p2d::Body::at, does not touch any caches
+        of body, so it could be called from several threads of narrow phase at once
+        \param[in] time a time
+        \return difference between positions
+     */
+    p2d::Vector positionDeltaAt(double time) const;
+    /*! Returns a difference between angle of body at specified time of current step and
+        current angle. Could be called from several threads at once
+        \param[in] time a time
+        \return difference between angles
+     */
+    double angleDeltaAt(double time) const;
     /*! Builds an acceleration cache for any of bodies
      */
     void buildCaches();
@@ -337,6 +394,19 @@ public:
         \return time step
      */
     double timeStep() const;
+    /*! Returns a bounding box, which contains current shape of body and all of samples,
+        cached for current time step. Rebuilt in sad::p2d::Body::buildCaches and used
+        by broad phase to filter pairs before narrow phase
+        \return bounding box of swept shape
+     */
+    const sad::p2d::BoundingBox& sweptBoundingBox() const;
+    /*! Returns a convex hull of swept shape of body, built from current shape and all of samples,
+        cached for current time step. Hull and it's projections on own axis are built once, when
+        requested first time after sad::p2d::Body::buildCaches, and reused for every pair
+        with this body. Can be called from several threads of narrow phase at once
+        \return convex hull of swept shape
+     */
+    const sad::p2d::ConvexHull& sweptHull();
     /*! If next position is scheduled, places object between two positions,
         otherwise schedules new position. Note, that instead a position, a distance
         between current position and new is passed
@@ -360,7 +430,42 @@ public:
     /*! Set amount of sampling, needed to cache positions for collision detection
      */
     void setSamplingCount(int samples);
-    /*! Builds inner bodu caches with time step
+    /*! Returns whether body is sleeping. A sleeping body is not integrated, it's caches are not
+        rebuilt and it's not tested for collisions with other sleeping bodies
+        \return whether body is sleeping
+     */
+    bool isSleeping() const;
+    /*! Puts body to sleep, stopping it. Called by world, when body rests for several steps
+     */
+    void sleep();
+    /*! Wakes up body, if it's sleeping. Called, when body is moved, force is added to it,
+        or it collides with other body. Sleeping bodies, touching woken body, are woken
+        by world before next step
+     */
+    void wakeUp();
+    /*! Wakes up body and, if it's already awake, asks world to wake sleeping bodies, touching it,
+        before next step. Called, when body is moved by user or force is added to it,
+        so bodies, resting on it, don't stay hanging in the air
+     */
+    void disturb();
+    /*! Sets, whether body can fall asleep. If it can't, it's woken up
+        \param[in] can_sleep whether body can fall asleep
+     */
+    void setCanSleep(bool can_sleep);
+    /*! Returns, whether body can fall asleep
+        \return whether body can fall asleep
+     */
+    bool canSleep() const;
+    /*! Counts steps, when body rests, and puts it to sleep, when enough of them passed in a row.
+        Body rests, when it's velocities are below thresholds and nothing is scheduled for it
+        \param[in] linear_threshold a threshold for tangential velocity
+        \param[in] angular_threshold a threshold for angular velocity
+        \param[in] steps amount of steps, body should rest before falling asleep
+        \return whether body fell asleep
+     */
+    bool updateSleepState(double linear_threshold, double angular_threshold, unsigned int steps);
+    /*! Builds inner bodu caches with time step. Also remembers current position and angle
+        as previous, since it's called by world at start of every step
         \param time_step a current time step
      */
     void buildCaches(double time_step);
@@ -382,6 +487,9 @@ private:
     /*! A world simulation
      */
     p2d::World* m_world;
+    /*! A kinematic state, where position and velocities of body are stored
+     */
+    p2d::KinematicState* m_kinematic_state;
     /*! Returns a user object
         \return user object for a body
      */
@@ -407,6 +515,44 @@ private:
     /*! Describes, whether this body should not be changed
      */
     bool m_fixed;
+    /*! A bounding box for swept shape of body in current time step
+     */
+    sad::p2d::BoundingBox m_swept_bounding_box;
+    /*! A position of body before last step of world
+     */
+    p2d::Vector m_previous_position;
+    /*! An angle of body before last step of world
+     */
+    double m_previous_angle;
+    /*! Whether body is sleeping
+     */
+    bool m_is_sleeping;
+    /*! Whether body can fall asleep
+     */
+    bool m_can_sleep;
+    /*! Amount of steps in a row, when body rested
+     */
+    unsigned int m_resting_steps;
+    /*! A states of cached convex hull of swept shape
+     */
+    enum SweptHullState
+    {
+        SHS_INVALID = 0,  //!< Hull should be rebuilt, when requested
+        SHS_BUILDING = 1, //!< Hull is being built by some thread
+        SHS_BUILT = 2     //!< Hull is valid for current time step
+    };
+    /*! A convex hull for swept shape of body in current time step. Memory of it is reused
+        between steps
+     */
+    sad::p2d::ConvexHull m_swept_hull;
+    /*! A state of m_swept_hull, as value of SweptHullState
+     */
+    std::atomic<int> m_swept_hull_state;
+
+    /*! Builds bounding box for swept shape of body from current shape and samples.
+        Also invalidates cached hull of swept shape
+     */
+    void buildSweptBoundingBox();
 };
 
 }
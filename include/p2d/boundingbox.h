@@ -0,0 +1,98 @@
+/*! \file boundingbox.h
+
+
+    Defines an axis-aligned bounding box, used by broad phase to find candidate pairs
+    of bodies
+ */
+#pragma once
+#include "axle.h"
+
+namespace sad
+{
+
+namespace p2d
+{
+
+/*! An axis-aligned bounding box for a body. A box could be unbounded, which
+    means that it intersects with any other box (used for bounds, which are infinite)
+ */
+struct BoundingBox
+{
+    /*! Minimal x coordinate
+     */
+    double MinX;
+    /*! Minimal y coordinate
+     */
+    double MinY;
+    /*! Maximal x coordinate
+     */
+    double MaxX;
+    /*! Maximal y coordinate
+     */
+    double MaxY;
+    /*! Whether box is unbounded
+     */
+    bool Unbounded;
+    /*! Whether box is empty, so no points were added to it
+     */
+    bool Empty;
+
+    /*! Makes new empty box
+     */
+    inline BoundingBox() : MinX(0), MinY(0), MaxX(0), MaxY(0), Unbounded(false), Empty(true)
+    {
+
+    }
+    /*! Extends box to contain specified projections of shape to horizontal and vertical axles
+        \param[in] x projection to horizontal axle
+        \param[in] y projection to vertical axle
+     */
+    inline void add(const sad::p2d::Cutter1D& x, const sad::p2d::Cutter1D& y)
+    {
+        double minx = (x.p1() < x.p2()) ? x.p1() : x.p2();
+        double maxx = (x.p1() < x.p2()) ? x.p2() : x.p1();
+        double miny = (y.p1() < y.p2()) ? y.p1() : y.p2();
+        double maxy = (y.p1() < y.p2()) ? y.p2() : y.p1();
+        if (Empty)
+        {
+            MinX = minx;
+            MaxX = maxx;
+            MinY = miny;
+            MaxY = maxy;
+            Empty = false;
+        }
+        else
+        {
+            MinX = (minx < MinX) ? minx : MinX;
+            MaxX = (maxx > MaxX) ? maxx : MaxX;
+            MinY = (miny < MinY) ? miny : MinY;
+            MaxY = (maxy > MaxY) ? maxy : MaxY;
+        }
+    }
+    /*! Extends box on all sides by specified value
+        \param[in] value a value
+     */
+    inline void inflate(double value)
+    {
+        MinX -= value;
+        MinY -= value;
+        MaxX += value;
+        MaxY += value;
+    }
+    /*! Tests, whether two boxes intersect. Touching boxes are treated as intersecting
+        \param[in] o other box
+        \return whether boxes intersect
+     */
+    inline bool intersects(const sad::p2d::BoundingBox& o) const
+    {
+        if (Unbounded || o.Unbounded)
+        {
+            return true;
+        }
+        return MinX <= o.MaxX && o.MinX <= MaxX && MinY <= o.MaxY && o.MinY <= MaxY;
+    }
+};
+
+}
+
+}
@@ -52,6 +52,10 @@ public:
         \return raw array of bounds
      */
     p2d::CollisionShape * clone(int count) const;
+    /*! Frees bounds, created by clone
+        \param[in] clones raw array of bounds
+     */
+    virtual void freeClones(sad::p2d::CollisionShape * clones) const;
     /*! Returns a center of rectangle
         \return center of rectangle
      */
@@ -37,6 +37,9 @@ public:
       virtual p2d::MaybeTime collides(p2d::Body * b1, 
                                       p2d::Body * b2, 
                                       double limit);
+      /*! Prepares detector for testing bodies from several threads at once
+       */
+      virtual void prepare();
 protected:
      p2d::CollisionTest * m_tester; //!< A collision tester, used to determining a data
      p2d::SimpleCollisionDetector * m_detector; //!< Inner detector for simplified computing of collisions
@@ -0,0 +1,133 @@
+/*! \file broadphase.h
+
+
+    Describes a basic broad phase, used to find candidate pairs of bodies,
+    which can collide, before testing them with collision detector
+ */
+#pragma once
+#include "body.h"
+#include "../sadvector.h"
+#include "../object.h"
+
+
+namespace sad
+{
+
+namespace p2d
+{
+
+/*! A basic broad phase, which filters pairs of bodies from two groups, using
+    swept bounding boxes of bodies (see sad::p2d::Body::sweptBoundingBox), so
+    only pairs, which could collide, are passed to narrow phase
+ */
+class BroadPhase: public sad::Object
+{
+SAD_OBJECT
+public:
+    /*! An entry of broad phase as body with it's position in group
+     */
+    struct Entry
+    {
+        /*! A body
+         */
+        sad::p2d::Body* Body;
+        /*! Position of body in group
+         */
+        size_t Index;
+
+        /*! Makes new entry
+            \param[in] b body
+            \param[in] i index of body in group
+         */
+        inline Entry(sad::p2d::Body* b = NULL, size_t i = 0) : Body(b), Index(i)
+        {
+
+        }
+    };
+    /*! A candidate pair as positions of bodies in first and second group
+     */
+    struct CandidatePair
+    {
+        /*! A position of body in first group
+         */
+        size_t First;
+        /*! A position of body in second group
+         */
+        size_t Second;
+
+        /*! Makes new pair
+            \param[in] first a position of body in first group
+            \param[in] second a position of body in second group
+         */
+        inline CandidatePair(size_t first = 0, size_t second = 0) : First(first), Second(second)
+        {
+
+        }
+        /*! Compares pairs lexicographically
+            \param[in] o other pair
+            \return comparison results
+         */
+        inline bool operator<(const sad::p2d::BroadPhase::CandidatePair& o) const
+        {
+            return (First < o.First) || (First == o.First && Second < o.Second);
+        }
+        /*! Compares pairs for equality
+            \param[in] o other pair
+            \return comparison results
+         */
+        inline bool operator==(const sad::p2d::BroadPhase::CandidatePair& o) const
+        {
+            return First == o.First && Second == o.Second;
+        }
+    };
+    /*! Finds candidate pairs for two groups of bodies. If groups are the same,
+        lists of entries are the same and only pairs with first index less than second
+        must be produced. Pairs could be produced in any order and could contain duplicates,
+        since they are sorted and made unique in sad::p2d::BroadPhase::findSortedPairs.
+        \param[in] first entries of first group
+        \param[in] second entries of second group
+        \param[in] same_group whether groups are the same
+        \param[out] pairs a found candidate pairs
+     */
+    virtual void findPairs(
+        const sad::Vector<sad::p2d::BroadPhase::Entry>& first,
+        const sad::Vector<sad::p2d::BroadPhase::Entry>& second,
+        bool same_group,
+        sad::Vector<sad::p2d::BroadPhase::CandidatePair>& pairs
+    ) = 0;
+    /*! Finds candidate pairs, sorting them in same order, as they would be tested,
+        when no broad phase is used, and removing duplicates
+        \param[in] first entries of first group
+        \param[in] second entries of second group
+        \param[in] same_group whether groups are the same
+        \param[out] pairs a found candidate pairs
+     */
+    void findSortedPairs(
+        const sad::Vector<sad::p2d::BroadPhase::Entry>& first,
+        const sad::Vector<sad::p2d::BroadPhase::Entry>& second,
+        bool same_group,
+        sad::Vector<sad::p2d::BroadPhase::CandidatePair>& pairs
+    );
+    /*! Could be inherited
+     */
+    virtual ~BroadPhase();
+protected:
+    /*! Tests whether two entries could form a candidate pair and adds them to list
+        \param[in] e1 first entry
+        \param[in] e2 second entry
+        \param[in] same_group whether entries are from same group
+        \param[out] pairs a found candidate pairs
+     */
+    static void tryAddPair(
+        const sad::p2d::BroadPhase::Entry& e1,
+        const sad::p2d::BroadPhase::Entry& e2,
+        bool same_group,
+        sad::Vector<sad::p2d::BroadPhase::CandidatePair>& pairs
+    );
+};
+
+}
+
+}
+
+DECLARE_TYPE_AS_SAD_OBJECT_ENUM(sad::p2d::BroadPhase)
@@ -44,6 +44,10 @@ public:
         \return raw array of circles
      */
     p2d::CollisionShape * clone(int count) const;
+    /*! Frees circles, created by clone
+        \param[in] clones raw array of circles
+     */
+    virtual void freeClones(sad::p2d::CollisionShape * clones) const;
     /*! Returns raw reference to center. Works faster than p2d::Circle::center()
         \return reference to center
      */
@@ -38,6 +38,10 @@ public:
       /*! Returns a sample  count, needed to fetch samples for detection
        */
       virtual int sampleCount() const;
+      /*! Prepares detector for testing bodies from several threads at once,
+          initializing all lazily initialized data. Default implementation does nothing
+       */
+      virtual void prepare();
       /*! Could be inherited
        */
       virtual ~CollisionDetector();
@@ -240,18 +240,25 @@ class CollisionMultiMethod
         }
     public:
         CollisionMultiMethod() { m_init = false;}
-        /*! Invokes a multi-method, if possible. Returns default object,
-            if can't handle.
-            \param[in] a first shape
-            \param[in] b second shape
+        /*! Initializes all callbacks, if they are not initialized yet. Must be called
+            before invoking multi-method from several threads at once
          */
-        virtual _ReturnType invoke(CollisionShape * a, CollisionShape * b)
+        void ensureInitialized()
         {
             if (!m_init)
             {
                 m_init = true;
                 init();
             }
+        }
+        /*! Invokes a multi-method, if possible. Returns default object,
+            if can't handle.
+            \param[in] a first shape
+            \param[in] b second shape
+         */
+        virtual _ReturnType invoke(CollisionShape * a, CollisionShape * b)
+        {
+            ensureInitialized();
             instance_t * d = lookup(a,b);
             if (!d) return _ReturnType();
             return d->invoke(a, b);
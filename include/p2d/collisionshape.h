@@ -31,6 +31,11 @@ public:
         \return copy of shape
      */
     virtual p2d::CollisionShape * clone(int count = 1) const = 0;
+    /*! Frees shapes, created by clone. Array must be deleted by pointer to it's real
+        type, so this method must be overridden along with clone
+        \param[in] clones shapes, created by clone
+     */
+    virtual void freeClones(p2d::CollisionShape * clones) const;
     /*! Returns a center of shape
         \return center of shape
      */
@@ -0,0 +1,95 @@
+/*! \file conservativeadvancementcollisiondetector.h
+
+
+    Determines a collision detector, which computes time of impact of two bodies
+    by conservative advancement, so fast bodies can't pass through thin ones
+ */
+#pragma once
+#include "collisiondetector.h"
+
+
+namespace sad
+{
+
+namespace p2d
+{
+/*! A collision detector, which computes time of impact by conservative advancement.
+    On each iteration a lower bound of distance between shapes is computed and time is
+    advanced by time, needed to cover this distance with maximal relative velocity of
+    bodies. Since bodies could not collide until that time, no collision is skipped, and
+    amount of iterations does not depend on velocity of bodies, unlike amount of samples
+    in sad::p2d::MultisamplingCollisionDetector
+ */
+class ConservativeAdvancementCollisionDetector: public p2d::CollisionDetector
+{
+SAD_OBJECT
+public:
+     /*! Creates new detector
+         \param[in] iterations a maximal amount of advancements for one pair of bodies
+         \param[in] tolerance  a distance, when shapes are considered as touching
+         \param[in] t          a shape collision testing callbacks
+      */
+     ConservativeAdvancementCollisionDetector(
+         unsigned int iterations = 32,
+         double tolerance = COLLISION_PRECISION,
+         p2d::CollisionTest * t = new p2d::CollisionTest()
+     );
+     /*! Tests, whether two bodies collide within specified limit
+          testing their movement in interval [0, limit] and returning
+          time if possible
+          \param[in] b1 first body
+          \param[in] b2 second body
+          \param[in] limit a time limit for finding a position of bodies
+          \return time of impact, if collision is detected
+       */
+      virtual p2d::MaybeTime collides(p2d::Body * b1,
+                                      p2d::Body * b2,
+                                      double limit);
+      /*! Prepares detector for testing bodies from several threads at once
+       */
+      virtual void prepare();
+      /*! Sets maximal amount of advancements for one pair of bodies. If it's exceeded,
+          only end of step is tested
+          \param[in] iterations amount of iterations
+       */
+      void setMaxIterations(unsigned int iterations);
+      /*! Returns maximal amount of advancements for one pair of bodies
+          \return amount of iterations
+       */
+      unsigned int maxIterations() const;
+      /*! Sets a distance, when shapes are considered as touching
+          \param[in] tolerance a distance
+       */
+      void setTolerance(double tolerance);
+      /*! Returns a distance, when shapes are considered as touching
+          \return distance
+       */
+      double tolerance() const;
+      /*! Computes a lower bound of distance between two shapes. For circles, rectangles,
+          lines and bounds it's a distance along best separating axis, so it's not positive,
+          when shapes intersect. For other shapes only axis between centers is tested
+          \param[in] s1 first shape
+          \param[in] s2 second shape
+          \return lower bound of distance
+       */
+      static double separation(p2d::CollisionShape * s1, p2d::CollisionShape * s2);
+      /*! Returns maximal distance between center of shape and it's points, which
+          limits speed of points of shape, when it's rotated
+          \param[in] s shape
+          \return radius of rotation
+       */
+      static double rotationRadius(p2d::CollisionShape * s);
+      /*! Frees collision tester
+       */
+     ~ConservativeAdvancementCollisionDetector();
+private:
+     p2d::CollisionTest * m_tester; //!< A tester, which tests shapes for collisions
+     unsigned int m_max_iterations; //!< A maximal amount of advancements for one pair
+     double m_tolerance; //!< A distance, when shapes are considered as touching
+};
+
+}
+
+}
+
+DECLARE_TYPE_AS_SAD_OBJECT_ENUM(sad::p2d::ConservativeAdvancementCollisionDetector)
@@ -32,6 +32,14 @@ public:
      /*! Builds a hull for a hull
       */
      void buildHull();
+     /*! Removes all points from hull and drops cached axis, keeping allocated memory,
+         so same hull could be rebuilt many times without reallocations
+      */
+     void clear();
+     /*! Caches axis for collision of hull and projections of hull on them, so
+         they won't be recomputed, when hull is tested against many other hulls
+      */
+     void buildAxisCache();
      /*! Creates a nex convex hull from specified set of points
          \param[in] set set of points
       */
@@ -69,6 +77,13 @@ public:
          \return  whether they are colliding
       */ 
      bool collides(const ConvexHull & c) const;
+     /*! Whether two convex hulls collide. Same as sad::p2d::ConvexHull::collides, but
+         uses axis and projections, cached by sad::p2d::ConvexHull::buildAxisCache,
+         so only hulls are projected on axis of each other
+         \param[in] c other convex hull, which axis must be cached
+         \return whether they are colliding
+      */
+     bool collidesUsingCachedAxis(const ConvexHull & c) const;
      /*! Projects a convex hull on specified axle
          \param[in] axle axle
          \return cutter
@@ -88,6 +103,12 @@ public:
      inline const sad::Vector<sad::p2d::Point> & set() { return m_set; }
 private: 
      sad::Vector<sad::p2d::Point> m_set;
+     /*! Cached axis for collision of hull
+      */
+     sad::Vector<sad::p2d::Axle> m_axles;
+     /*! Cached projections of hull on axis from m_axles
+      */
+     sad::Vector<sad::p2d::Cutter1D> m_projections;
      /*!  Inserts axle to container if not found in container
           \param[in, out] container container with axis
           \param[in] axle one axle
@@ -285,6 +285,10 @@ public:
         \return whether container has a forces
      */
     bool hasForces() const { return m_forces.size() != 0; }
+    /*! Whether container has forces, scheduled to be added
+        \return whether container has scheduled forces
+     */
+    bool hasScheduledForces() const { return m_queued.size() != 0; }
     /*! Returns list of forces, acting on body
         \return list of forces
      */
@@ -0,0 +1,165 @@
+/*! \file kinematicstate.h
+    
+
+    Describes a packed kinematic state of bodies in world, stored as structure of arrays,
+    so integration of positions and velocities could be performed as one vectorized loop
+ */
+#pragma once
+#include "vector.h"
+
+#include "../sadvector.h"
+
+namespace sad
+{
+
+namespace p2d
+{
+
+class Body;
+
+/*! A flags for slot of kinematic arrays
+ */
+enum KinematicSlotFlags
+{
+    KSF_FREE = 1,        //!< A slot is not bound to any movement
+    KSF_SCHEDULED = 2,   //!< A movement has scheduled position or velocity and must be stepped by itself
+    KSF_INTEGRATED = 4,  //!< A slot was integrated, but listeners of movement are not notified yet
+    KSF_SLEEPING = 8     //!< A body of movement is sleeping and must not be integrated
+};
+
+/*! A packed positions, velocities and accelerations for one kind of movement. Every
+    movement, bound to arrays, reads and writes it's position and velocity by slot index
+ */
+template<
+    typename _Value
+>
+struct KinematicArrays
+{
+    /*! Current positions of movements
+     */
+    sad::Vector<_Value> Positions;
+    /*! Current velocities of movements
+     */
+    sad::Vector<_Value> Velocities;
+    /*! Accelerations, used for integration on current step. Filled, when caches
+        of bodies are built
+     */
+    sad::Vector<_Value> Accelerations;
+    /*! A position differences, computed on last integration
+     */
+    sad::Vector<_Value> Deltas;
+    /*! A flags for slots (see sad::p2d::KinematicSlotFlags)
+     */
+    sad::Vector<unsigned char> Flags;
+
+    /*! Resizes arrays to specified amount of slots, marking new slots as free
+        \param[in] size new amount of slots
+     */
+    void resize(size_t size)
+    {
+        size_t old_size = Flags.size();
+        Positions.resize(size);
+        Velocities.resize(size);
+        Accelerations.resize(size);
+        Deltas.resize(size);
+        Flags.resize(size);
+        for(size_t i = old_size; i < size; i++)
+        {
+            Flags[i] = sad::p2d::KSF_FREE;
+        }
+    }
+    /*! Clears arrays
+     */
+    void clear()
+    {
+        Positions.clear();
+        Velocities.clear();
+        Accelerations.clear();
+        Deltas.clear();
+        Flags.clear();
+    }
+};
+
+/*! A packed kinematic state of bodies, owned by world. Slots of state are the same as offsets of
+    bodies in global body container of world. A body could be bound only to one state, so if body
+    is added to several worlds, only first of them stores it's kinematics, and other ones
+    step it as standalone object.
+ */
+class KinematicState
+{
+public:
+    /*! Creates empty state
+     */
+    KinematicState();
+    /*! Unbinds all bodies from state
+     */
+    ~KinematicState();
+    /*! Binds body to specified slot, copying it's position and velocities to state
+        \param[in] slot a slot
+        \param[in] body a body
+     */
+    void bind(size_t slot, sad::p2d::Body* body);
+    /*! Unbinds body from slot, copying it's position and velocities back to body
+        \param[in] slot a slot
+     */
+    void unbind(size_t slot);
+    /*! Unbinds all bodies from state
+     */
+    void clear();
+    /*! Integrates positions and velocities for all bound movements, which don't have scheduled
+        values. A movements are notified about changes, when they are stepped by bodies.
+        \param[in] time_step a time step
+     */
+    void integrate(double time_step);
+    /*! Returns amount of slots in state
+        \return amount of slots
+     */
+    size_t size() const;
+    /*! Returns a body, bound to slot
+        \param[in] slot a slot
+        \return body (NULL if slot is free)
+     */
+    sad::p2d::Body* body(size_t slot) const;
+    /*! Returns packed state for tangential movements
+        \return arrays
+     */
+    sad::p2d::KinematicArrays<sad::p2d::Vector>& tangential();
+    /*! Returns packed state for angular movements
+        \return arrays
+     */
+    sad::p2d::KinematicArrays<double>& angular();
+    /*! Integrates tangential movements for a time step
+        \param[in] arrays an arrays of movements
+        \param[in] time_step a time step
+     */
+    static void integrate(sad::p2d::KinematicArrays<sad::p2d::Vector>& arrays, double time_step);
+    /*! Integrates angular movements for a time step
+        \param[in] arrays an arrays of movements
+        \param[in] time_step a time step
+     */
+    static void integrate(sad::p2d::KinematicArrays<double>& arrays, double time_step);
+private:
+    /*! Disabled, since bodies are bound to state by address
+        \param[in] o other state
+     */
+    KinematicState(const sad::p2d::KinematicState& o);
+    /*! Disabled, since bodies are bound to state by address
+        \param[in] o other state
+        \return self-reference
+     */
+    sad::p2d::KinematicState& operator=(const sad::p2d::KinematicState& o);
+
+    /*! A packed tangential movements
+     */
+    sad::p2d::KinematicArrays<sad::p2d::Vector> m_tangential;
+    /*! A packed angular movements
+     */
+    sad::p2d::KinematicArrays<double> m_angular;
+    /*! A bodies, bound to slots
+     */
+    sad::Vector<sad::p2d::Body*> m_bodies;
+};
+
+}
+
+}
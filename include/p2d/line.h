@@ -46,6 +46,10 @@ public:
         \return raw array of cutters
      */
     sad::p2d::CollisionShape * clone(int count) const;
+    /*! Frees lines, created by clone
+        \param[in] clones raw array of lines
+     */
+    virtual void freeClones(sad::p2d::CollisionShape * clones) const;
     /*! Returns a center of cutter
         \return center of cutter
      */
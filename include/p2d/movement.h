@@ -7,6 +7,7 @@
 #include "weight.h"
 #include "vector.h"
 #include "force.h"
+#include "kinematicstate.h"
 
 #include "../sadvector.h"
 #include "../geometry2d.h"
@@ -128,7 +129,60 @@ class Movement
      /*! Whether position is cached
       */
      bool   m_position_is_cached;
+     /*! A packed arrays, where position and velocity are stored, when movement is bound
+         to kinematic state of world. NULL if movement stores them by itself
+      */
+     p2d::KinematicArrays<_Value>* m_arrays;
+     /*! A slot of movement in packed arrays
+      */
+     size_t m_slot;
  protected:
+     /*! Returns current position, stored in movement or in packed arrays
+         \return position
+      */
+     inline _Value& currentPosition()
+     {
+         return (m_arrays) ? m_arrays->Positions[m_slot] : m_position;
+     }
+     /*! Returns current position, stored in movement or in packed arrays
+         \return position
+      */
+     inline const _Value& currentPosition() const
+     {
+         return (m_arrays) ? m_arrays->Positions[m_slot] : m_position;
+     }
+     /*! Returns current velocity, stored in movement or in packed arrays
+         \return velocity
+      */
+     inline _Value& currentVelocity()
+     {
+         return (m_arrays) ? m_arrays->Velocities[m_slot] : m_velocity;
+     }
+     /*! Returns current velocity, stored in movement or in packed arrays
+         \return velocity
+      */
+     inline const _Value& currentVelocity() const
+     {
+         return (m_arrays) ? m_arrays->Velocities[m_slot] : m_velocity;
+     }
+     /*! Marks slot in packed arrays as scheduled, if movement has scheduled position or
+         velocity, so it won't be integrated by kinematic state
+      */
+     void updateScheduledFlag()
+     {
+         if (m_arrays)
+         {
+             unsigned char& flags = m_arrays->Flags[m_slot];
+             if (m_next_velocity.exists() || m_next_position.exists())
+             {
+                 flags |= p2d::KSF_SCHEDULED;
+             }
+             else
+             {
+                 flags &= ~p2d::KSF_SCHEDULED;
+             }
+         }
+     }
      /*! Called, when object moved on step, or by setting a current value
          \param[in] delta a difference from new value and current value
       */
@@ -169,22 +223,86 @@ class Movement
          m_position = p2d::TickableDefaultValue<_Value>::zero(); //-V656
          m_acceleration_is_cached = false;
          m_position_is_cached = false;
+         m_arrays = NULL;
+         m_slot = 0;
      }
      /*! Destroys force and listeners
       */
      ~Movement()
      {
+         unbind();
          clearListeners();
      }
      /*! Builds inner cache for accelerations, so, when bodies move, acceleration
-         would be taken from here
+         would be taken from here. Cached position is dropped, since it depends on acceleration
       */
      void cacheAcceleration()
      {
+         m_position_is_cached = false;
          m_acceleration_is_cached = false;
          m_acceleration_cache = p2d::TickableDefaultValue<_Value>::zero();
          this->acceleration(m_acceleration_cache);
          m_acceleration_is_cached = true;
+         if (m_arrays)
+         {
+             _Value p = p2d::TickableDefaultValue<_Value>::zero();
+             if (m_force.hasForces())
+             {
+                 this->acceleration(p);
+             }
+             m_arrays->Accelerations[m_slot] = p;
+         }
+     }
+     /*! Binds movement to slot of packed arrays, copying current position and velocity to it
+         \param[in] arrays an arrays
+         \param[in] slot a slot
+      */
+     void bind(p2d::KinematicArrays<_Value>* arrays, size_t slot)
+     {
+         unbind();
+         arrays->Positions[slot] = m_position;
+         arrays->Velocities[slot] = m_velocity;
+         arrays->Accelerations[slot] = p2d::TickableDefaultValue<_Value>::zero();
+         arrays->Deltas[slot] = p2d::TickableDefaultValue<_Value>::zero();
+         arrays->Flags[slot] = 0;
+         m_arrays = arrays;
+         m_slot = slot;
+         updateScheduledFlag();
+     }
+     /*! Unbinds movement from packed arrays, copying current position and velocity back
+      */
+     void unbind()
+     {
+         if (m_arrays)
+         {
+             m_position = m_arrays->Positions[m_slot];
+             m_velocity = m_arrays->Velocities[m_slot];
+             m_arrays->Flags[m_slot] = p2d::KSF_FREE;
+             m_arrays = NULL;
+             m_slot = 0;
+         }
+     }
+     /*! Returns, whether movement is bound to packed arrays
+         \return whether movement is bound
+      */
+     bool isBound() const { return m_arrays != NULL; }
+     /*! Marks slot in packed arrays as sleeping, so it won't be integrated by kinematic state
+         \param[in] sleeping whether body of movement is sleeping
+      */
+     void setSleeping(bool sleeping)
+     {
+         if (m_arrays)
+         {
+             unsigned char& flags = m_arrays->Flags[m_slot];
+             if (sleeping)
+             {
+                 flags |= p2d::KSF_SLEEPING;
+             }
+             else
+             {
+                 flags &= ~p2d::KSF_SLEEPING;
+             }
+         }
      }
      /*! Clears all of movement listeners
       */
@@ -243,13 +361,13 @@ class Movement
          {
              if (sad::is_fuzzy_equal(time, step_size))
              {
-                 return m_next_velocity.value() - m_velocity;
+                 return m_next_velocity.value() - this->currentVelocity();
              }
              if (m_next_velocity_time.exists())
              {
                  if (sad::is_fuzzy_equal(time, m_next_velocity_time.value()))
                  {
-                      return m_next_velocity.value() - m_velocity;
+                      return m_next_velocity.value() - this->currentVelocity();
                  }
              }
              return p;
@@ -267,7 +385,7 @@ class Movement
       */
      _Value velocityAt(double time, double step_size)
      {
-         return m_velocity + velocityDelta(time, step_size);
+         return this->currentVelocity() + velocityDelta(time, step_size);
      }
      /*! Returns a position  difference at specified time
          \param[in] time specified time
@@ -285,13 +403,13 @@ class Movement
              if (sad::is_fuzzy_equal(time, step_size))
              {
                  m_position_is_cached = true;
-                 m_position_cache =  m_next_position.value() - m_position;
+                 m_position_cache =  m_next_position.value() - this->currentPosition();
              }
              if (m_next_position_time.exists())
              {
                  if (sad::is_fuzzy_equal(time, m_next_position_time.value()))
                  {
-                      return m_next_position.value() - m_position;
+                      return m_next_position.value() - this->currentPosition();
                  }
              }
              return p2d::TickableDefaultValue<_Value>::zero();
@@ -302,20 +420,54 @@ class Movement
             m_position_cache = p2d::TickableDefaultValue<_Value>::zero();
             this->acceleration(m_position_cache);
             m_position_cache *= time / 2;
-            m_position_cache += m_velocity;
+            m_position_cache += this->currentVelocity();
             m_position_cache *= time;
             m_position_is_cached = iswholestep;
             return m_position_cache;
          }
          else
          {
-            m_position_cache = m_velocity;
+            m_position_cache = this->currentVelocity();
             m_position_cache *= time;
             m_position_is_cached = iswholestep;
             return m_position_cache;
          }
          return _Value();
      }
+     /*! Returns a position difference at specified time, same as positionDelta, but
+         without writing into inner position cache, so it could be called for same movement
+         from several threads at once
+         \param[in] time specified time
+         \param[in] step_size a simulation step size
+         \return position difference
+      */
+     _Value positionDeltaWithoutCaching(double time, double step_size) const
+     {
+         if (m_next_position.exists())
+         {
+             if (sad::is_fuzzy_equal(time, step_size))
+             {
+                 return m_next_position.value() - this->currentPosition();
+             }
+             if (m_next_position_time.exists())
+             {
+                 if (sad::is_fuzzy_equal(time, m_next_position_time.value()))
+                 {
+                      return m_next_position.value() - this->currentPosition();
+                 }
+             }
+             return p2d::TickableDefaultValue<_Value>::zero();
+         }
+         _Value result = p2d::TickableDefaultValue<_Value>::zero();
+         if (m_force.hasForces())
+         {
+             this->acceleration(result);
+             result *= time / 2;
+         }
+         result += this->currentVelocity();
+         result *= time;
+         return result;
+     }
 
      /*! Returns a position at specified time. 
          \param[in] time specified time
@@ -323,7 +475,7 @@ class Movement
       */
      _Value positionAt(double time, double step_size)
      {
-         return m_position + positionDelta(time, step_size);
+         return this->currentPosition() + positionDelta(time, step_size);
      }
      /*! Steps a position of body and a velocity
          \param[in] time specified time size
@@ -331,11 +483,24 @@ class Movement
       */
      void step(double time, double step_size)
      {
+         if (m_arrays)
+         {
+             // Position and velocity is already integrated by kinematic state, so only notify listeners
+             unsigned char& flags = m_arrays->Flags[m_slot];
+             if ((flags & p2d::KSF_INTEGRATED) != 0)
+             {
+                 flags &= ~p2d::KSF_INTEGRATED;
+                 m_position_is_cached = false;
+                 _Value integrated_delta = m_arrays->Deltas[m_slot];
+                 fireMovement(integrated_delta);
+                 return;
+             }
+         }
          _Value delta = this->positionDelta(time, step_size);
          _Value newvelocity = velocityAt(time, step_size);
          _Value newposition = positionAt(time, step_size);
-         m_velocity = newvelocity;
-         m_position = newposition;
+         this->currentVelocity() = newvelocity;
+         this->currentPosition() = newposition;
          if (sad::is_fuzzy_equal(time, step_size))
          {
              m_next_velocity.clear();
@@ -360,6 +525,7 @@ class Movement
              }
          }
          m_position_is_cached = false;
+         updateScheduledFlag();
          fireMovement(delta);
      }
      /*! Current weight of moved body
@@ -373,7 +539,7 @@ class Movement
      /*! Return current value for velocity
          \return current value for velocity
       */
-     const _Value & velocity() const { return m_velocity; }
+     const _Value & velocity() const { return this->currentVelocity(); }
      /*! Tests, whether velocity will be changed, due to user call
          \return whether velocity will be changed, due to user call
       */
@@ -392,7 +558,8 @@ class Movement
       */
      void setCurrentVelocity(const _Value & v)
      {
-         m_velocity = v;
+         this->currentVelocity() = v;
+         m_position_is_cached = false;
      }
      /*! Sets next planned velocity for body
          \param[in] v velocity
@@ -400,6 +567,7 @@ class Movement
      void setNextVelocity(const _Value & v)
      {
          m_next_velocity.setValue(v);
+         updateScheduledFlag();
      }
      /*! Sets next valocity at specified time
       */
@@ -407,11 +575,12 @@ class Movement
      {
          m_next_velocity.setValue(v);
          m_next_velocity_time.setValue(time);
+         updateScheduledFlag();
      }
      /*! Return current value for position
          \return current value for position
       */
-     const _Value & position() const { return m_position; }
+     const _Value & position() const { return this->currentPosition(); }
      /*! Tests, whether position will be changed, due to user call
          \return whether position will be changed, due to user call
       */
@@ -430,8 +599,8 @@ class Movement
       */
      void setCurrentPosition(const _Value & v)
      {
-         _Value delta = v - m_position;
-         m_position = v;
+         _Value delta = v - this->currentPosition();
+         this->currentPosition() = v;
          m_position_is_cached =  false;
          fireMovement(delta);
      }
@@ -443,6 +612,7 @@ class Movement
          m_position_is_cached = false;
          m_next_position.setValue(v);
          m_next_position_time.clear();
+         updateScheduledFlag();
      }
      /*! Sets next planned position for body at time
          \param[in] v position
@@ -453,6 +623,7 @@ class Movement
          m_position_is_cached = false;
          m_next_position.setValue(v);
          m_next_position_time.setValue(time);
+         updateScheduledFlag();
      }
      /*! Computes average velocity, based on force
          Note, that this function ignores any of velocity changes, made by calling
@@ -465,7 +636,7 @@ class Movement
          _Value p = p2d::TickableDefaultValue<_Value>::zero(); 
          this->acceleration(p);
          p *= time / 2;
-         p += m_velocity;
+         p += this->currentVelocity();
          return p;
      }
      /*! Set body for forces container. Note, that movement stores data by weak reference, so 
@@ -47,6 +47,9 @@ public:
       /*! Returns a sample  count, needed to fetch samples for detection
        */
       virtual int sampleCount() const;
+      /*! Prepares detector for testing bodies from several threads at once
+       */
+      virtual void prepare();
 
      ~MultisamplingCollisionDetector();
 private:
@@ -35,6 +35,10 @@ public:
         \return rectangle
      */
     p2d::CollisionShape * clone(int count) const;
+    /*! Frees rectangles, created by clone
+        \param[in] clones raw array of rectangles
+     */
+    virtual void freeClones(sad::p2d::CollisionShape * clones) const;
     /*! Returns a center of rectangle
         \return center of rectangle
      */
@@ -43,6 +43,9 @@ public:
       virtual p2d::MaybeTime collides(p2d::Body * b1, 
                                       p2d::Body * b2, 
                                       double limit);
+      /*! Prepares detector for testing bodies from several threads at once
+       */
+      virtual void prepare();
 
      ~SimpleCollisionDetector();
 private:
@@ -0,0 +1,101 @@
+/*! \file sweepandprunebroadphase.h
+
+
+    Describes a broad phase, which sorts bodies by left side of their bounding boxes and
+    sweeps them along horizontal axis, testing only bodies with overlapping projections
+ */
+#pragma once
+#include "broadphase.h"
+
+
+namespace sad
+{
+
+namespace p2d
+{
+
+/*! A broad phase, which sorts bodies by left side of their bounding boxes and
+    sweeps them along horizontal axis, testing only bodies with overlapping projections.
+    Unbounded bodies are tested against all other bodies.
+ */
+class SweepAndPruneBroadPhase: public sad::p2d::BroadPhase
+{
+SAD_OBJECT
+public:
+    /*! Makes new broad phase
+     */
+    SweepAndPruneBroadPhase();
+    /*! Finds candidate pairs for two groups of bodies
+        \param[in] first entries of first group
+        \param[in] second entries of second group
+        \param[in] same_group whether groups are the same
+        \param[out] pairs a found candidate pairs
+     */
+    virtual void findPairs(
+        const sad::Vector<sad::p2d::BroadPhase::Entry>& first,
+        const sad::Vector<sad::p2d::BroadPhase::Entry>& second,
+        bool same_group,
+        sad::Vector<sad::p2d::BroadPhase::CandidatePair>& pairs
+    );
+    /*! Could be inherited
+     */
+    virtual ~SweepAndPruneBroadPhase();
+protected:
+    /*! An endpoint of body projection on horizontal axis
+     */
+    struct Interval
+    {
+        /*! A minimal x coordinate of body
+         */
+        double MinX;
+        /*! A maximal x coordinate of body
+         */
+        double MaxX;
+        /*! Whether body is from second group
+         */
+        bool Second;
+        /*! Position of body in list of entries
+         */
+        size_t Position;
+
+        /*! Makes new interval
+            \param[in] minx a minimal x coordinate
+            \param[in] maxx a maximal x coordinate
+            \param[in] second whether body is from second group
+            \param[in] position a position of body in list of entries
+         */
+        inline Interval(double minx = 0, double maxx = 0, bool second = false, size_t position = 0)
+        : MinX(minx), MaxX(maxx), Second(second), Position(position)
+        {
+
+        }
+        /*! Compares intervals by left side
+            \param[in] o other interval
+            \return comparison result
+         */
+        inline bool operator<(const sad::p2d::SweepAndPruneBroadPhase::Interval& o) const
+        {
+            return MinX < o.MinX;
+        }
+    };
+    /*! Removes intervals, which end before specified coordinate from list
+        \param[in, out] active a list of active intervals
+        \param[in] x a coordinate
+     */
+    static void prune(sad::Vector<sad::p2d::SweepAndPruneBroadPhase::Interval>& active, double x);
+    /*! A sorted intervals, reused between calls
+     */
+    sad::Vector<sad::p2d::SweepAndPruneBroadPhase::Interval> m_intervals;
+    /*! An active intervals for first group
+     */
+    sad::Vector<sad::p2d::SweepAndPruneBroadPhase::Interval> m_active_first;
+    /*! An active intervals for second group
+     */
+    sad::Vector<sad::p2d::SweepAndPruneBroadPhase::Interval> m_active_second;
+};
+
+}
+
+}
+
+DECLARE_TYPE_AS_SAD_OBJECT_ENUM(sad::p2d::SweepAndPruneBroadPhase)
@@ -0,0 +1,129 @@
+/*! \file uniformgridbroadphase.h
+
+
+    Describes a broad phase, which places bodies of second group into cells of uniform
+    grid and tests bodies of first group only against bodies in same cells
+ */
+#pragma once
+#include "broadphase.h"
+
+
+namespace sad
+{
+
+namespace p2d
+{
+
+/*! A broad phase, which places bodies of second group into cells of uniform grid
+    and tests bodies of first group only against bodies, which share cells with them.
+    Bodies, which cover too many cells or unbounded bodies are tested against all other
+    bodies.
+ */
+class UniformGridBroadPhase: public sad::p2d::BroadPhase
+{
+SAD_OBJECT
+public:
+    /*! Makes new broad phase with specified cell size
+        \param[in] cell_size a size of cell of grid
+        \param[in] max_cells_per_body a maximal amount of cells, which body could cover, before
+                   it will be tested against all other bodies
+     */
+    UniformGridBroadPhase(double cell_size = 64.0, size_t max_cells_per_body = 64);
+    /*! Sets size of cell
+        \param[in] cell_size a size of cell (must be positive)
+     */
+    void setCellSize(double cell_size);
+    /*! Returns size of cell
+        \return size of cell
+     */
+    double cellSize() const;
+    /*! Sets maximal amount of cells, which body could cover
+        \param[in] max_cells_per_body a maximal amount of cells
+     */
+    void setMaxCellsPerBody(size_t max_cells_per_body);
+    /*! Returns maximal amount of cells, which body could cover
+        \return maximal amount of cells
+     */
+    size_t maxCellsPerBody() const;
+    /*! Finds candidate pairs for two groups of bodies
+        \param[in] first entries of first group
+        \param[in] second entries of second group
+        \param[in] same_group whether groups are the same
+        \param[out] pairs a found candidate pairs
+     */
+    virtual void findPairs(
+        const sad::Vector<sad::p2d::BroadPhase::Entry>& first,
+        const sad::Vector<sad::p2d::BroadPhase::Entry>& second,
+        bool same_group,
+        sad::Vector<sad::p2d::BroadPhase::CandidatePair>& pairs
+    );
+    /*! Could be inherited
+     */
+    virtual ~UniformGridBroadPhase();
+protected:
+    /*! An entry of body in cell of grid
+     */
+    struct CellEntry
+    {
+        /*! A horizontal index of cell
+         */
+        long long X;
+        /*! A vertical index of cell
+         */
+        long long Y;
+        /*! Position of entry in list of entries of second group
+         */
+        size_t Position;
+
+        /*! Makes new entry
+            \param[in] x a horizontal index of cell
+            \param[in] y a vertical index of cell
+            \param[in] position a position of entry in list
+         */
+        inline CellEntry(long long x = 0, long long y = 0, size_t position = 0) : X(x), Y(y), Position(position)
+        {
+
+        }
+        /*! Compares entries by cell
+            \param[in] o other entry
+            \return comparison result
+         */
+        inline bool operator<(const sad::p2d::UniformGridBroadPhase::CellEntry& o) const
+        {
+            return (X < o.X) || (X == o.X && Y < o.Y);
+        }
+    };
+    /*! Computes range of cells, covered by body
+        \param[in] box a bounding box of body
+        \param[out] minx a minimal horizontal index
+        \param[out] miny a minimal vertical index
+        \param[out] maxx a maximal horizontal index
+        \param[out] maxy a maximal vertical index
+        \return false if body is unbounded or covers too many cells
+     */
+    bool cellRange(
+        const sad::p2d::BoundingBox& box,
+        long long& minx,
+        long long& miny,
+        long long& maxx,
+        long long& maxy
+    ) const;
+    /*! A size of cell
+     */
+    double m_cell_size;
+    /*! A maximal amount of cells, which body could cover
+     */
+    size_t m_max_cells_per_body;
+    /*! A sorted entries of bodies in cells, reused between calls
+     */
+    sad::Vector<sad::p2d::UniformGridBroadPhase::CellEntry> m_cells;
+    /*! A positions of bodies in second group, which should be tested against all bodies
+     */
+    sad::Vector<size_t> m_large;
+};
+
+}
+
+}
+
+DECLARE_TYPE_AS_SAD_OBJECT_ENUM(sad::p2d::UniformGridBroadPhase)
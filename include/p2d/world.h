@@ -10,13 +10,24 @@
 #include "simplecollisiondetector.h"
 #include "broadcollisiondetector.h"
 #include "multisamplingcollisiondetector.h"
+#include "conservativeadvancementcollisiondetector.h"
+#include "broadphase.h"
+#include "uniformgridbroadphase.h"
+#include "sweepandprunebroadphase.h"
+#include "../sadworkerpool.h"
 #include "collisionhandler.h"
+#include "kinematicstate.h"
 
 #include "../sadhash.h"
 #include "../sadvector.h"
 #include "../object.h"
 #include "../sadmutex.h"
 
+/*! A distance, by which areas of woken, moved or removed bodies are extended, when sleeping
+    bodies, touching them, are searched
+ */
+#define SAD_P2D_WAKE_UP_DISTANCE 1.0
+
 namespace sad
 {
 
@@ -81,6 +92,10 @@ public:
             in near O(1)
          */
         sad::Vector<size_t> FreePositions;
+        /*! A packed positions and velocities of bodies. Slots of state are same as positions
+            of bodies in AllBodies
+         */
+        sad::p2d::KinematicState Kinematics;
         /*! Performs action on container
             \param[in] f function
          */
@@ -107,7 +122,8 @@ public:
             \param[in] time_step a time step size
          */
         void stepDiscreteChangingValues(double time_step);
-        /*! Steps a position and velocities
+        /*! Steps a position and velocities. Bodies, which don't have scheduled positions
+            or velocities, are integrated by packed kinematic state at once
             \param[in] time_step a time step size
          */
         void stepPositionsAndVelocities(double time_step);
@@ -141,6 +157,23 @@ public:
             \return a list of bodies
          */
         sad::Vector<sad::p2d::Body*> activeBodies();
+        /*! Counts resting steps for awake bodies, putting them to sleep, if they rest long enough
+            \param[in] linear_threshold a threshold for tangential velocity
+            \param[in] angular_threshold a threshold for angular velocity
+            \param[in] steps amount of steps, body should rest before falling asleep
+         */
+        void updateSleepStates(double linear_threshold, double angular_threshold, unsigned int steps);
+        /*! Wakes up all sleeping bodies in container
+         */
+        void wakeUpAll();
+        /*! Wakes up sleeping bodies in container, which swept bounding boxes intersect with area
+            \param[in] area an area
+         */
+        void wakeUpInArea(const sad::p2d::BoundingBox& area);
+        /*! Returns amount of sleeping bodies in container
+            \return amount of sleeping bodies
+         */
+        size_t sleepingBodyCount();
     };
     /*! A group container for bodies
      */
@@ -487,6 +520,36 @@ public:
     /*! A list pf events with callbacks
      */
     typedef sad::Vector<EventWithCallback> EventsWithCallbacks;
+    /*! A task for finding collision events in parallel, defined as range of rows (or candidate
+        pairs, if broad phase is used) for one pair of groups
+     */
+    struct NarrowPhaseTask
+    {
+        /*! Bodies of first group
+         */
+        sad::Vector<sad::p2d::World::BodyWithActivityFlag>* Bodies1;
+        /*! Bodies of second group
+         */
+        sad::Vector<sad::p2d::World::BodyWithActivityFlag>* Bodies2;
+        /*! Whether groups are the same
+         */
+        bool SameGroup;
+        /*! A callbacks for group pair
+         */
+        sad::Vector<sad::p2d::BasicCollisionHandler*>* Callbacks;
+        /*! A candidate pairs, found by broad phase (NULL if all pairs in rows are tested)
+         */
+        const sad::Vector<sad::p2d::BroadPhase::CandidatePair>* Pairs;
+        /*! A beginning of range of rows or pairs
+         */
+        size_t Begin;
+        /*! An end of range of rows or pairs (not included)
+         */
+        size_t End;
+        /*! Found events
+         */
+        sad::p2d::World::EventsWithCallbacks Events;
+    };
 public:
     /*! Creates world with default transformer
      */
@@ -502,10 +565,90 @@ public:
         \param[in] d detector
      */
     void setDetector(sad::p2d::CollisionDetector * d);
+    /*! Sets new broad phase for a world. A broad phase filters pairs of bodies, using their
+        swept bounding boxes, before passing them to a detector. If NULL is passed, all pairs
+        of bodies are tested by detector.
+        \param[in] p a broad phase (NULL to test all pairs)
+     */
+    void setBroadPhase(sad::p2d::BroadPhase * p);
+    /*! Returns current broad phase for a world
+        \return broad phase (NULL if all pairs are tested)
+     */
+    sad::p2d::BroadPhase * broadPhase() const;
+    /*! Sets amount of threads, used to test pairs of bodies for collisions. If amount is greater
+        than one, pairs are split into tasks, performed by pool of worker threads, and found events are merged
+        in same order, as in single-threaded mode, so callbacks are invoked in same order. A detector
+        must support testing bodies from several threads at once (all detectors from library do).
+        \param[in] threads amount of threads (zero or one disables parallel testing)
+     */
+    void setNarrowPhaseThreadCount(size_t threads);
+    /*! Returns amount of threads, used to test pairs of bodies for collisions
+        \return amount of threads
+     */
+    size_t narrowPhaseThreadCount() const;
     /*! Returns current time step for a world
         \return a time step for a world
      */
     double timeStep() const;
+    /*! Sets interpolation alpha, which defines, how far rendering is between previous and current step
+        of world. Set by sad::p2d::WorldStepTask in fixed step mode and used by bodies to compute
+        interpolated positions and angles
+        \param[in] alpha an alpha in [0, 1]
+     */
+    void setInterpolationAlpha(double alpha);
+    /*! Returns interpolation alpha between previous and current step of world
+        \return interpolation alpha (1 by default, so current state is rendered)
+     */
+    double interpolationAlpha() const;
+    /*! Enables or disables putting bodies to sleep. A body falls asleep, when it's velocities are
+        below thresholds for several steps in a row. Sleeping bodies are not integrated, their caches are
+        not rebuilt and pairs of sleeping bodies are not tested for collisions. A body is woken up, when
+        it's moved by user, force is added to it, it collides with awake body, or a body, it touches,
+        is woken, moved or removed. Disabling
+        sleeping wakes up all bodies. Disabled by default.
+        \param[in] enabled whether sleeping is enabled
+     */
+    void setSleepingEnabled(bool enabled);
+    /*! Returns whether bodies can fall asleep in world
+        \return whether sleeping is enabled
+     */
+    bool isSleepingEnabled() const;
+    /*! Sets thresholds for velocities, below which body is considered resting
+        \param[in] linear a threshold for modulo of tangential velocity
+        \param[in] angular a threshold for modulo of angular velocity
+     */
+    void setSleepThresholds(double linear, double angular);
+    /*! Returns threshold for modulo of tangential velocity, below which body is considered resting
+        \return threshold
+     */
+    double sleepLinearThreshold() const;
+    /*! Returns threshold for modulo of angular velocity, below which body is considered resting
+        \return threshold
+     */
+    double sleepAngularThreshold() const;
+    /*! Sets amount of steps in a row, body should rest before falling asleep
+        \param[in] steps amount of steps
+     */
+    void setStepsBeforeSleep(unsigned int steps);
+    /*! Returns amount of steps in a row, body should rest before falling asleep
+        \return amount of steps
+     */
+    unsigned int stepsBeforeSleep() const;
+    /*! Returns amount of sleeping bodies in world
+        \return amount of sleeping bodies
+     */
+    size_t sleepingBodyCount();
+    /*! Returns amount of awake bodies in world
+        \return amount of awake bodies
+     */
+    size_t awakeBodyCount();
+    /*! Remembers current swept bounding box of body, so sleeping bodies, touching it, are woken
+        before next step. Bodies, woken this way, wake their neighbours too, so a whole stack of
+        bodies, resting on each other, is woken. Called, when body is woken up, moved by user or
+        removed from world. Does nothing, if sleeping is disabled
+        \param[in] b a body
+     */
+    void wakeUpNeighbours(sad::p2d::Body* b);
     /*! Set transformer for a circles
         \param[in] t transformer
      */
@@ -834,12 +977,58 @@ protected:
     /*! Current time step
      */
     double m_time_step;
+    /*! An interpolation alpha between previous and current step
+     */
+    double m_interpolation_alpha;
+    /*! Whether bodies can fall asleep
+     */
+    bool m_sleeping_enabled;
+    /*! A threshold for tangential velocity of resting body
+     */
+    double m_sleep_linear_threshold;
+    /*! A threshold for angular velocity of resting body
+     */
+    double m_sleep_angular_threshold;
+    /*! Amount of steps in a row, body should rest before falling asleep
+     */
+    unsigned int m_steps_before_sleep;
+    /*! Swept bounding boxes of bodies, which were woken, moved or removed since last step.
+        Sleeping bodies, touching them, are woken on next step
+     */
+    sad::Vector<sad::p2d::BoundingBox> m_disturbed_areas;
+    /*! A lock for disturbed areas, since bodies could be changed from handlers
+     */
+    sad::Mutex m_disturbed_areas_lock;
     /*! A common transformer for all shapes
      */
     p2d::CircleToHullTransformer * m_transformer;
     /*! A collision dispatcher for testing an items for collision
      */
     p2d::CollisionDetector * m_detector;
+    /*! A broad phase for filtering pairs of bodies before detecting collisions (NULL if not used)
+     */
+    p2d::BroadPhase * m_broad_phase;
+    /*! A cached entries of first group for broad phase
+     */
+    sad::Vector<sad::p2d::BroadPhase::Entry> m_broad_phase_first;
+    /*! A cached entries of second group for broad phase
+     */
+    sad::Vector<sad::p2d::BroadPhase::Entry> m_broad_phase_second;
+    /*! A cached candidate pairs, found by broad phase
+     */
+    sad::Vector<sad::p2d::BroadPhase::CandidatePair> m_broad_phase_pairs;
+    /*! An amount of threads, used to test pairs of bodies for collisions
+     */
+    size_t m_narrow_phase_thread_count;
+    /*! A pool of worker threads for testing pairs of bodies (NULL if not created)
+     */
+    sad::WorkerPool* m_worker_pool;
+    /*! A cached tasks for finding collision events in parallel
+     */
+    sad::Vector<sad::p2d::World::NarrowPhaseTask> m_narrow_phase_tasks;
+    /*! A cached candidate pairs for each handler list, when events are found in parallel
+     */
+    sad::Vector<sad::Vector<sad::p2d::BroadPhase::CandidatePair> > m_narrow_phase_pairs;
     /*! A global body container for storing body references
      */
     sad::p2d::World::GlobalBodyContainer m_global_body_container;
@@ -960,6 +1149,9 @@ protected:
         \param time_step a time step
      */
     void stepNow(double time_step);
+    /*! Wakes up sleeping bodies, touching disturbed areas, and bodies, touching woken ones
+     */
+    void wakeUpBodiesInDisturbedAreas();
     /*! Find specific collision events and populates reactions
         \param[in] ewc events with callbacks
      */
@@ -969,6 +1161,85 @@ protected:
         \param[in] lst a handler list to be used
      */
     void findEvent(sad::p2d::World::EventsWithCallbacks& ewc, sad::p2d::World::HandlerList& lst);
+    /*! Finds collision events, testing pairs of bodies in parallel, using worker pool
+        \param[in] ewc events with callbacks
+     */
+    void findEventsInParallel(sad::p2d::World::EventsWithCallbacks& ewc);
+    /*! Finds collision events for specified rows (bodies of first group), testing them against
+        all bodies of second group
+        \param[in] ewc events with callbacks
+        \param[in] bodies1 bodies of first group
+        \param[in] bodies2 bodies of second group
+        \param[in] same_group whether groups are the same
+        \param[in] callbacks a callbacks for group pair
+        \param[in] begin a first row
+        \param[in] end a row after last row
+     */
+    void findEventInRows(
+        sad::p2d::World::EventsWithCallbacks& ewc,
+        sad::Vector<sad::p2d::World::BodyWithActivityFlag>& bodies1,
+        sad::Vector<sad::p2d::World::BodyWithActivityFlag>& bodies2,
+        bool same_group,
+        sad::Vector<sad::p2d::BasicCollisionHandler*>* callbacks,
+        size_t begin,
+        size_t end
+    );
+    /*! Finds a specific collision event, using broad phase to filter pairs of bodies
+        \param[in] ewc events with callbacks
+        \param[in] bodies1 bodies of first group
+        \param[in] bodies2 bodies of second group
+        \param[in] same_group whether groups are the same
+        \param[in] callbacks a callbacks for group pair
+     */
+    void findEventWithBroadPhase(
+        sad::p2d::World::EventsWithCallbacks& ewc,
+        sad::Vector<sad::p2d::World::BodyWithActivityFlag>& bodies1,
+        sad::Vector<sad::p2d::World::BodyWithActivityFlag>& bodies2,
+        bool same_group,
+        sad::Vector<sad::p2d::BasicCollisionHandler*>* callbacks
+    );
+    /*! Finds candidate pairs for groups, using broad phase
+        \param[in] bodies1 bodies of first group
+        \param[in] bodies2 bodies of second group
+        \param[in] same_group whether groups are the same
+        \param[out] pairs a found candidate pairs
+     */
+    void findCandidatePairs(
+        sad::Vector<sad::p2d::World::BodyWithActivityFlag>& bodies1,
+        sad::Vector<sad::p2d::World::BodyWithActivityFlag>& bodies2,
+        bool same_group,
+        sad::Vector<sad::p2d::BroadPhase::CandidatePair>& pairs
+    );
+    /*! Finds collision events for specified range of candidate pairs
+        \param[in] ewc events with callbacks
+        \param[in] bodies1 bodies of first group
+        \param[in] bodies2 bodies of second group
+        \param[in] pairs a candidate pairs
+        \param[in] callbacks a callbacks for group pair
+        \param[in] begin a first pair
+        \param[in] end a pair after last pair
+     */
+    void findEventForPairs(
+        sad::p2d::World::EventsWithCallbacks& ewc,
+        sad::Vector<sad::p2d::World::BodyWithActivityFlag>& bodies1,
+        sad::Vector<sad::p2d::World::BodyWithActivityFlag>& bodies2,
+        const sad::Vector<sad::p2d::BroadPhase::CandidatePair>& pairs,
+        sad::Vector<sad::p2d::BasicCollisionHandler*>* callbacks,
+        size_t begin,
+        size_t end
+    );
+    /*! Tests a pair of bodies for collision, adding event if needed
+        \param[in] ewc events with callbacks
+        \param[in] b1 first body
+        \param[in] b2 second body
+        \param[in] callbacks a callbacks for group pair
+     */
+    void findEventForPair(
+        sad::p2d::World::EventsWithCallbacks& ewc,
+        sad::p2d::Body* b1,
+        sad::p2d::Body* b2,
+        sad::Vector<sad::p2d::BasicCollisionHandler*>* callbacks
+    );
 };
 
 }
@@ -7,6 +7,7 @@
 #include "world.h"
 #include "../pipeline/pipelineprocess.h"
 #include "../renderer.h"
+#include "../timer.h"
 
 namespace sad
 {
@@ -14,7 +15,13 @@ namespace sad
 namespace p2d
 {
 
-/*! A world step task can perform world step, basing on rendering intervals
+/*! A world step task can perform world step, basing on rendering intervals.
+
+    By default world is stepped once per frame by time of frame, computed from FPS of renderer.
+    If fixed time step is set, time of frames is accumulated and world is stepped by fixed step
+    as many times, as accumulated time allows it, but no more than maximal amount of substeps.
+    A remaining part of step is exposed as interpolation alpha, which is also set in world, so
+    bodies could be rendered between previous and current states.
  */
 class WorldStepTask: public sad::pipeline::AbstractProcess
 {
@@ -29,6 +36,47 @@ public:
         \param[in] world a world
      */
     void setWorld(sad::p2d::World* world);
+    /*! Sets fixed time step for a world. If step is zero or less, world is stepped once per frame
+        by time of frame, as before
+        \param[in] step a step (in seconds)
+     */
+    void setFixedTimeStep(double step);
+    /*! Returns fixed time step for a world
+        \return fixed time step (zero or less if disabled)
+     */
+    double fixedTimeStep() const;
+    /*! Returns whether world is stepped with fixed time step
+        \return whether fixed step is enabled
+     */
+    bool isFixedTimeStep() const;
+    /*! Sets maximal amount of steps, performed per frame in fixed step mode. If more time is accumulated,
+        it is dropped, so slow frames won't lead to spiral of death
+        \param[in] substeps amount of substeps (zero is treated as one)
+     */
+    void setMaxSubsteps(unsigned int substeps);
+    /*! Returns maximal amount of steps, performed per frame in fixed step mode
+        \return amount of substeps
+     */
+    unsigned int maxSubsteps() const;
+    /*! Returns accumulated time, which was not simulated yet in fixed step mode
+        \return accumulated time (in seconds)
+     */
+    double accumulator() const;
+    /*! Returns interpolation alpha for current frame, as part of fixed step, accumulated, but not simulated
+        yet. Is always 1 if fixed step is disabled
+        \return interpolation alpha in [0, 1)
+     */
+    double interpolationAlpha() const;
+    /*! Drops accumulated time, also resetting time of frame, so next frame will perform a single step
+     */
+    void resetAccumulator();
+    /*! Advances world by time of frame. In fixed step mode, time is accumulated and world is stepped
+        by fixed steps, otherwise world is stepped once by specified time. Can be called manually, to
+        replay recorded times of frames
+        \param[in] frame_time a time of frame (in seconds)
+        \return amount of performed steps
+     */
+    unsigned int advance(double frame_time);
     /*! Decreases reference count for world 
      */
     ~WorldStepTask();
@@ -39,6 +87,24 @@ protected:
     /*! A world, that will be calculated, when task is executed
      */
     sad::p2d::World* m_world;
+    /*! A fixed time step for a world (zero or less if disabled)
+     */
+    double m_fixed_time_step;
+    /*! A maximal amount of steps per frame in fixed step mode
+     */
+    unsigned int m_max_substeps;
+    /*! An accumulated time, which was not simulated yet
+     */
+    double m_accumulator;
+    /*! An interpolation alpha for current frame
+     */
+    double m_interpolation_alpha;
+    /*! A timer for measuring time of frames in fixed step mode
+     */
+    sad::Timer m_frame_timer;
+    /*! Whether timer is started, measuring time of frame
+     */
+    bool m_frame_timer_started;
     /*! Invokes a delegate inside of process
      */ 
     virtual void _process();
@@ -388,6 +388,12 @@ public:
     /*! Runs a pipeline loop
      */
     void run();
+    /*! Returns true, if pipeline contains enabled user steps. Used by main loop to detect, whether
+        something should be done on next frame
+        \param[in] ignored_marks marks of steps, which should not be counted
+        \return whether pipeline contains user steps
+     */
+    bool hasUserSteps(const sad::Vector<sad::String>& ignored_marks = sad::Vector<sad::String>()) const;
     /*! Reimplemented. If user inserts step in runtime into end of scene rendering, we should add
         it immediately, because it won't hurt performance and allows to perform transition at end
         of frame and to not render next frame.
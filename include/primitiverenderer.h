@@ -9,6 +9,7 @@
 
 namespace sad
 {
+class Renderer;
 
 /*! \class PrimitiveRenderer
     
@@ -23,6 +24,14 @@ public:
     /*! You can override primitive render to render own primitives in a way, you like it
      */
     virtual ~PrimitiveRenderer();
+    /*! Sets renderer, whose backend receives draw calls
+        \param[in] renderer a renderer
+     */
+    void setRenderer(sad::Renderer* renderer);
+    /*! Returns renderer, whose backend receives draw calls
+        \return renderer
+     */
+    sad::Renderer* renderer() const;
     /*! Renders a line with specified color
         \param[in] p1 a first point of renderer
         \param[in] p2 a second point of renderer
@@ -41,6 +50,10 @@ public:
         const sad::Rect2D & r,
         const sad::AColor & c
     );
+protected:
+    /*! A renderer, whose backend receives draw calls
+     */
+    sad::Renderer* m_renderer;
 };
 
 }
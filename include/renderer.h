@@ -19,6 +19,8 @@
 #include "settings.h"
 #include "scene.h"
 #include "sadpoint.h"
+#include "sadsize.h"
+#include "matrix4x4.h"
 #include "sadptrhash.h"
 #include "timer.h"
 #include "maybe.h"
@@ -27,6 +29,7 @@
 #include "sadptrhash.h"
 #include "sadmutex.h"
 #include "primitiverenderer.h"
+#include "spritebatch.h"
 #include "texture.h"
 #include "clipboard.h"
 
@@ -51,6 +54,13 @@ namespace pipeline
 {
     class Pipeline;
 }
+namespace rendering
+{
+    class Backend;
+    class CommandBuffer;
+    class Recorder;
+    class TextureResidency;
+}
 namespace input
 {
     class Controls;
@@ -182,6 +192,11 @@ public:
         about current platform spec
      */
     virtual sad::OpenGL* opengl() const;
+    /*! Returns a manager of textures, resident on GPU, which could be used to set
+        a budget of GPU memory for textures and to query statistics of it
+        \return manager of textures
+     */
+    sad::rendering::TextureResidency* textureResidency() const;
     /*! Returns current main loop for renderer
         \return main loop for a renderer
      */
@@ -324,6 +339,11 @@ public:
         \return renderer for primitives
      */
     sad::PrimitiveRenderer * render() const;
+    /*! Returns a batch for sprites, which gathers sprites with same texture, while rendering
+        scene to reduce amount of draw calls
+        \return batch for sprites
+     */
+    sad::SpriteBatch * spriteBatch() const;
     /*! Fetches path to executable without it's name and last delimiter. Returns empty string if fails
         \return executable path
      */
@@ -434,6 +454,61 @@ public:
         \return global translation offset
      */
     const sad::Vector3D& globalTranslationOffset() const;
+    /*! Sets projection matrix, which is currently loaded into OpenGL. Must be called by code,
+        which changes projection, since mapping of cursor does not read matrices from OpenGL
+        \param[in] m matrix
+     */
+    void setProjectionMatrix(const sad::Matrix4x4<double>& m);
+    /*! Returns projection matrix, which is currently loaded into OpenGL
+        \return projection matrix
+     */
+    const sad::Matrix4x4<double>& projectionMatrix() const;
+    /*! Returns size of viewport, set by last reshape
+        \return size of viewport
+     */
+    const sad::Size2I& viewportSize() const;
+    /*! Maps point in coordinates of viewport to coordinates of scenes, using projection matrix on CPU.
+        Since cameras restore model-view matrix after rendering scene, only global translation offset
+        is taken into account
+        \param[in] p point, where x and y are in pixels with origin at bottom left corner of viewport and
+                     z is depth in range [0, 1]
+        \return point in coordinates of scenes (same point, if it could not be mapped)
+     */
+    sad::Point3D unproject(const sad::Point3D& p) const;
+    /*! Sets, whether renderer runs without window and OpenGL context. In headless mode
+        main loop runs pipeline with animations and user steps, but scenes are not drawn:
+        only their visible nodes are counted. Must be set before running renderer.
+        Replaces rendering backend with sad::rendering::NullBackend for headless mode
+        and sad::rendering::GLBackend otherwise.
+        \param[in] headless whether renderer is headless
+     */
+    void setHeadless(bool headless);
+    /*! Returns, whether renderer runs without window and OpenGL context
+        \return whether renderer is headless
+     */
+    bool headless() const;
+    /*! Returns current rendering backend, which receives all drawing commands.
+        If commands are recorded, a recorder is returned
+        \return backend
+     */
+    sad::rendering::Backend* backend() const;
+    /*! Sets rendering backend, stopping recording of commands. Renderer takes ownership over backend
+        \param[in] backend a new backend (must not be NULL)
+     */
+    void setBackend(sad::rendering::Backend* backend);
+    /*! Starts recording all drawing commands into buffer. Commands are still passed
+        to backend. Recording stops, when stopRecording is called. In headless mode scenes
+        are rendered via backend, while recording.
+        \param[in] buffer a buffer, where commands are recorded (not owned by renderer)
+     */
+    void startRecording(sad::rendering::CommandBuffer* buffer);
+    /*! Stops recording drawing commands
+     */
+    void stopRecording();
+    /*! Returns, whether drawing commands are recorded
+        \return whether commands are recorded
+     */
+    bool recording() const;
 protected:
     /*! A global instance for renderer, to make it local creation is
         procedures unnecessary. It's not a singleton, but can
@@ -467,6 +542,9 @@ protected:
     /*! A renderer for the primitives
      */ 
     sad::PrimitiveRenderer *  m_primitiverenderer;
+    /*! A batch for sprites
+     */
+    sad::SpriteBatch *  m_sprite_batch;
     /*! An input controls for user action callbacks
      */
     sad::input::Controls*     m_controls;
@@ -516,6 +594,24 @@ protected:
     /*! A global translation offset, that should be applied to all of scenes cameras
      */
     sad::Vector3D m_global_translation_offset;
+    /*! Whether renderer runs without window and OpenGL context
+     */
+    bool m_headless;
+    /*! A backend, which receives drawing commands
+     */
+    sad::rendering::Backend* m_backend;
+    /*! A recorder for drawing commands, NULL if commands are not recorded
+     */
+    sad::rendering::Recorder* m_recorder;
+    /*! A projection matrix, which is currently loaded into OpenGL
+     */
+    sad::Matrix4x4<double> m_projection_matrix;
+    /*! A size of viewport, set by last reshape
+     */
+    sad::Size2I m_viewport_size;
+    /*! A manager of textures, resident on GPU
+     */
+    sad::rendering::TextureResidency* m_texture_residency;
 
     /*! Copying a renderer, due to held system resources is disabled
     \param[in] o other renderer
@@ -0,0 +1,110 @@
+/*! \file rendering/backend.h
+
+
+    Defines a backend for rendering, which receives all draw commands of sprites, labels,
+    primitives and cameras. Default backend performs OpenGL calls, while other ones could
+    record commands or only count them.
+ */
+#pragma once
+#include "../sadrect.h"
+#include "../sadcolor.h"
+
+#include <functional>
+
+namespace sad
+{
+class Texture;
+class Renderer;
+
+namespace rendering
+{
+
+/*! \class Backend
+
+    A backend for rendering. All colors, passed to backend are colors, as they are passed to
+    OpenGL, so alpha component is opacity.
+ */
+class Backend
+{
+public:
+    /*! Can be inherited
+     */
+    virtual ~Backend();
+    /*! Called, when renderer starts rendering new frame
+     */
+    virtual void startFrame() = 0;
+    /*! Called, when renderer finished rendering frame, before swapping buffers
+     */
+    virtual void finishFrame() = 0;
+    /*! Sets orthographic projection for viewport
+        \param[in] width a width of viewport
+        \param[in] height a height of viewport
+     */
+    virtual void setOrthographicProjection(double width, double height) = 0;
+    /*! Pushes current model-view matrix into stack
+     */
+    virtual void pushMatrix() = 0;
+    /*! Pops current model-view matrix from stack
+     */
+    virtual void popMatrix() = 0;
+    /*! Multiplies current model-view matrix by translation
+        \param[in] x x offset
+        \param[in] y y offset
+        \param[in] z z offset
+     */
+    virtual void translate(double x, double y, double z) = 0;
+    /*! Multiplies current model-view matrix by rotation
+        \param[in] angle an angle in degrees
+        \param[in] x x component of rotation axis
+        \param[in] y y component of rotation axis
+        \param[in] z z component of rotation axis
+     */
+    virtual void rotate(double angle, double x, double y, double z) = 0;
+    /*! Draws a textured quad of sprite
+        \param[in] texture a texture (must not be NULL)
+        \param[in] area a rendered area
+        \param[in] texture_coordinates a normalized texture coordinates for each point of area
+        \param[in] color a color of quad
+     */
+    virtual void drawSprite(
+        sad::Texture* texture,
+        const sad::Rect2D& area,
+        const sad::Rect2D& texture_coordinates,
+        const sad::AColor& color
+    ) = 0;
+    /*! Draws several textured quads with one draw call
+        \param[in] texture a texture (must not be NULL)
+        \param[in] vertexes a coordinates of vertexes (two per vertex, four vertexes per quad)
+        \param[in] texture_coordinates a texture coordinates (two per vertex)
+        \param[in] colors a colors (four bytes per vertex)
+        \param[in] quads amount of quads
+     */
+    virtual void drawQuads(
+        sad::Texture* texture,
+        const float* vertexes,
+        const float* texture_coordinates,
+        const unsigned char* colors,
+        unsigned int quads
+    ) = 0;
+    /*! Draws untextured lines
+        \param[in] points a pairs of points of lines
+        \param[in] count amount of points
+        \param[in] color a color of lines
+     */
+    virtual void drawLines(const sad::Point2D* points, unsigned int count, const sad::AColor& color) = 0;
+    /*! Draws a text. Fonts render themselves, so backend only decides, whether they should be called
+        \param[in] characters amount of rendered characters
+        \param[in] render a function, which renders text via OpenGL
+     */
+    virtual void drawText(unsigned int characters, const std::function<void()>& render) = 0;
+};
+
+/*! Returns backend of renderer, or default OpenGL backend if renderer is NULL
+    \param[in] renderer a renderer
+    \return backend
+ */
+sad::rendering::Backend* backend(sad::Renderer* renderer);
+
+}
+
+}
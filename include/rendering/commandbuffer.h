@@ -0,0 +1,192 @@
+/*! \file rendering/commandbuffer.h
+
+
+    Defines a compact buffer of recorded rendering commands, which could be saved to disk
+    and replayed into any backend
+ */
+#pragma once
+#include "../sadvector.h"
+#include "../sadstring.h"
+#include "../sadrect.h"
+#include "../sadcolor.h"
+
+namespace sad
+{
+
+namespace rendering
+{
+class Backend;
+
+/*! \class CommandBuffer
+
+    A buffer of recorded rendering commands. Every command is stored as byte of type, followed
+    by arguments. Coordinates are stored as floats, colors as four bytes and textures as keys,
+    defined by CT_DefineTexture command before first use. Data is stored in byte order of
+    machine, where commands were recorded.
+ */
+class CommandBuffer
+{
+public:
+    /*! A type of command
+     */
+    enum CommandType
+    {
+        CT_StartFrame = 0,                 //!< Starts frame
+        CT_FinishFrame = 1,                //!< Finishes frame
+        CT_SetOrthographicProjection = 2,  //!< Sets projection (width, height)
+        CT_PushMatrix = 3,                 //!< Pushes model-view matrix
+        CT_PopMatrix = 4,                  //!< Pops model-view matrix
+        CT_Translate = 5,                  //!< Translates model-view matrix (x, y, z)
+        CT_Rotate = 6,                     //!< Rotates model-view matrix (angle, x, y, z)
+        CT_DefineTexture = 7,              //!< Defines a texture (key, width, height)
+        CT_DrawSprite = 8,                 //!< Draws a quad (texture, area, texture coordinates, color)
+        CT_DrawQuads = 9,                  //!< Draws quads (texture, amount, vertexes, texture coordinates, colors)
+        CT_DrawLines = 10,                 //!< Draws lines (amount of points, color, points)
+        CT_DrawText = 11                   //!< Draws text (amount of characters)
+    };
+    /*! Creates empty buffer
+     */
+    CommandBuffer();
+    /*! Can be inherited
+     */
+    virtual ~CommandBuffer();
+    /*! Records starting of frame
+     */
+    void startFrame();
+    /*! Records finishing of frame
+     */
+    void finishFrame();
+    /*! Records setting of orthographic projection
+        \param[in] width a width of viewport
+        \param[in] height a height of viewport
+     */
+    void setOrthographicProjection(double width, double height);
+    /*! Records pushing of model-view matrix
+     */
+    void pushMatrix();
+    /*! Records popping of model-view matrix
+     */
+    void popMatrix();
+    /*! Records translation of model-view matrix
+        \param[in] x x offset
+        \param[in] y y offset
+        \param[in] z z offset
+     */
+    void translate(double x, double y, double z);
+    /*! Records rotation of model-view matrix
+        \param[in] angle an angle in degrees
+        \param[in] x x component of rotation axis
+        \param[in] y y component of rotation axis
+        \param[in] z z component of rotation axis
+     */
+    void rotate(double angle, double x, double y, double z);
+    /*! Records definition of texture
+        \param[in] key a key of texture, used in drawing commands
+        \param[in] width a width of texture
+        \param[in] height a height of texture
+     */
+    void defineTexture(unsigned int key, unsigned int width, unsigned int height);
+    /*! Records drawing a textured quad of sprite
+        \param[in] texture a key of texture
+        \param[in] area a rendered area
+        \param[in] texture_coordinates a normalized texture coordinates for each point of area
+        \param[in] color a color of quad
+     */
+    void drawSprite(
+        unsigned int texture,
+        const sad::Rect2D& area,
+        const sad::Rect2D& texture_coordinates,
+        const sad::AColor& color
+    );
+    /*! Records drawing of several textured quads
+        \param[in] texture a key of texture
+        \param[in] vertexes a coordinates of vertexes (two per vertex, four vertexes per quad)
+        \param[in] texture_coordinates a texture coordinates (two per vertex)
+        \param[in] colors a colors (four bytes per vertex)
+        \param[in] quads amount of quads
+     */
+    void drawQuads(
+        unsigned int texture,
+        const float* vertexes,
+        const float* texture_coordinates,
+        const unsigned char* colors,
+        unsigned int quads
+    );
+    /*! Records drawing of lines
+        \param[in] points a pairs of points of lines
+        \param[in] count amount of points
+        \param[in] color a color of lines
+     */
+    void drawLines(const sad::Point2D* points, unsigned int count, const sad::AColor& color);
+    /*! Records drawing of text
+        \param[in] characters amount of characters
+     */
+    void drawText(unsigned int characters);
+    /*! Returns amount of recorded frames
+        \return amount of frames
+     */
+    unsigned int frameCount() const;
+    /*! Returns amount of recorded commands
+        \return amount of commands
+     */
+    unsigned int commandCount() const;
+    /*! Returns recorded data
+        \return data
+     */
+    const sad::Vector<unsigned char>& data() const;
+    /*! Clears buffer
+     */
+    void clear();
+    /*! Replays all commands into backend. Textures are replaced with empty textures of same size,
+        which are destroyed after replaying
+        \param[in] backend a backend
+        \return false, if data is malformed
+     */
+    bool replay(sad::rendering::Backend* backend) const;
+    /*! Saves buffer to file
+        \param[in] filename a name of file
+        \return whether saving was successfull
+     */
+    bool save(const sad::String& filename) const;
+    /*! Loads buffer from file, replacing contents
+        \param[in] filename a name of file
+        \return whether loading was successfull. If not, buffer is not changed
+     */
+    bool load(const sad::String& filename);
+protected:
+    /*! Writes a type of command
+        \param[in] type a type
+     */
+    void writeCommand(sad::rendering::CommandBuffer::CommandType type);
+    /*! Writes raw bytes
+        \param[in] data a data
+        \param[in] size a size of data
+     */
+    void write(const void* data, size_t size);
+    /*! Writes unsigned integer
+        \param[in] value a value
+     */
+    void writeUInt(unsigned int value);
+    /*! Writes a coordinate as float
+        \param[in] value a value
+     */
+    void writeFloat(double value);
+    /*! Writes a color as four bytes
+        \param[in] color a color
+     */
+    void writeColor(const sad::AColor& color);
+
+    /*! A recorded data
+     */
+    sad::Vector<unsigned char> m_data;
+    /*! Amount of recorded frames
+     */
+    unsigned int m_frames;
+    /*! Amount of recorded commands
+     */
+    unsigned int m_commands;
+};
+
+}
+
+}
@@ -0,0 +1,67 @@
+/*! \file rendering/framestatistics.h
+
+
+    Defines a statistics of rendering commands for a frame
+ */
+#pragma once
+
+namespace sad
+{
+
+namespace rendering
+{
+
+/*! A statistics of rendering commands for a frame
+ */
+struct FrameStatistics
+{
+    /*! Amount of commands, except starting and finishing frame
+     */
+    unsigned int Commands;
+    /*! Amount of draw calls
+     */
+    unsigned int DrawCalls;
+    /*! Amount of drawn textured quads
+     */
+    unsigned int Quads;
+    /*! Amount of drawn lines
+     */
+    unsigned int Lines;
+    /*! Amount of drawn characters of text
+     */
+    unsigned int Characters;
+    /*! Amount of changes of state: texture switches, color changes, projection
+        changes and operations with model-view matrix
+     */
+    unsigned int StateChanges;
+    /*! Amount of switches of bound texture
+     */
+    unsigned int TextureSwitches;
+
+    /*! Creates empty statistics
+     */
+    inline FrameStatistics()
+    : Commands(0), DrawCalls(0), Quads(0), Lines(0), Characters(0), StateChanges(0), TextureSwitches(0)
+    {
+
+    }
+    /*! Adds other statistics to this
+        \param[in] o other statistics
+        \return self-reference
+     */
+    inline sad::rendering::FrameStatistics& operator+=(const sad::rendering::FrameStatistics& o)
+    {
+        Commands += o.Commands;
+        DrawCalls += o.DrawCalls;
+        Quads += o.Quads;
+        Lines += o.Lines;
+        Characters += o.Characters;
+        StateChanges += o.StateChanges;
+        TextureSwitches += o.TextureSwitches;
+        return *this;
+    }
+};
+
+}
+
+}
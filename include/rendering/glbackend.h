@@ -0,0 +1,111 @@
+/*! \file rendering/glbackend.h
+
+
+    Defines a backend for rendering, which performs OpenGL calls
+ */
+#pragma once
+#include "backend.h"
+#include "glstatecache.h"
+
+namespace sad
+{
+
+namespace rendering
+{
+
+/*! \class GLBackend
+
+    A default backend of renderer, which renders everything via OpenGL immediately.
+    State changes are passed through state cache of renderer, so redundant bindings
+    and color changes are skipped and state is never read back from OpenGL
+ */
+class GLBackend: public sad::rendering::Backend
+{
+public:
+    /*! Creates new backend
+        \param[in] renderer a renderer, whose state cache is used (NULL for global renderer)
+     */
+    GLBackend(sad::Renderer* renderer = NULL);
+    /*! Can be inherited
+     */
+    virtual ~GLBackend() override;
+    /*! Returns a state cache of renderer
+        \return state cache
+     */
+    sad::rendering::GLStateCache* stateCache() const;
+    /*! Invalidates state cache, clears buffers and resets model-view matrix
+     */
+    virtual void startFrame() override;
+    /*! Does nothing, since buffers are swapped by renderer
+     */
+    virtual void finishFrame() override;
+    /*! Sets orthographic projection for viewport
+        \param[in] width a width of viewport
+        \param[in] height a height of viewport
+     */
+    virtual void setOrthographicProjection(double width, double height) override;
+    /*! Pushes current model-view matrix into stack
+     */
+    virtual void pushMatrix() override;
+    /*! Pops current model-view matrix from stack
+     */
+    virtual void popMatrix() override;
+    /*! Multiplies current model-view matrix by translation
+        \param[in] x x offset
+        \param[in] y y offset
+        \param[in] z z offset
+     */
+    virtual void translate(double x, double y, double z) override;
+    /*! Multiplies current model-view matrix by rotation
+        \param[in] angle an angle in degrees
+        \param[in] x x component of rotation axis
+        \param[in] y y component of rotation axis
+        \param[in] z z component of rotation axis
+     */
+    virtual void rotate(double angle, double x, double y, double z) override;
+    /*! Draws a textured quad of sprite
+        \param[in] texture a texture (must not be NULL)
+        \param[in] area a rendered area
+        \param[in] texture_coordinates a normalized texture coordinates for each point of area
+        \param[in] color a color of quad
+     */
+    virtual void drawSprite(
+        sad::Texture* texture,
+        const sad::Rect2D& area,
+        const sad::Rect2D& texture_coordinates,
+        const sad::AColor& color
+    ) override;
+    /*! Draws several textured quads with one draw call
+        \param[in] texture a texture (must not be NULL)
+        \param[in] vertexes a coordinates of vertexes (two per vertex, four vertexes per quad)
+        \param[in] texture_coordinates a texture coordinates (two per vertex)
+        \param[in] colors a colors (four bytes per vertex)
+        \param[in] quads amount of quads
+     */
+    virtual void drawQuads(
+        sad::Texture* texture,
+        const float* vertexes,
+        const float* texture_coordinates,
+        const unsigned char* colors,
+        unsigned int quads
+    ) override;
+    /*! Draws untextured lines
+        \param[in] points a pairs of points of lines
+        \param[in] count amount of points
+        \param[in] color a color of lines
+     */
+    virtual void drawLines(const sad::Point2D* points, unsigned int count, const sad::AColor& color) override;
+    /*! Calls rendering function and invalidates state cache, since font changes state directly
+        \param[in] characters amount of rendered characters
+        \param[in] render a function, which renders text via OpenGL
+     */
+    virtual void drawText(unsigned int characters, const std::function<void()>& render) override;
+protected:
+    /*! A renderer, whose state cache is used
+     */
+    sad::Renderer* m_renderer;
+};
+
+}
+
+}
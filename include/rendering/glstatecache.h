@@ -0,0 +1,140 @@
+/*! \file rendering/glstatecache.h
+
+
+    Defines a cache of OpenGL state, which shadows state of context, so only
+    real changes of state are passed to OpenGL
+ */
+#pragma once
+#include "../sadcolor.h"
+#include "../maybe.h"
+
+namespace sad
+{
+
+namespace rendering
+{
+
+/*! \class GLStateCache
+
+    A shadow copy of OpenGL state for one context: bound texture, current color,
+    blending and matrix mode. Every setter passes change to OpenGL only if it differs from
+    known value, so state is never read back from driver. If some code changes state
+    directly via OpenGL, it must call corresponding setter or invalidate() afterwards.
+    Owned by sad::OpenGL.
+ */
+class GLStateCache
+{
+public:
+    /*! Creates new cache with unknown state
+     */
+    GLStateCache();
+    /*! Can be inherited
+     */
+    virtual ~GLStateCache();
+    /*! Binds a 2D texture
+        \param[in] id an id of texture
+     */
+    void bindTexture(unsigned int id);
+    /*! Must be called, when texture is deleted, since OpenGL resets binding
+        of deleted texture
+        \param[in] id an id of deleted texture
+     */
+    void textureDeleted(unsigned int id);
+    /*! Sets current color
+        \param[in] color a color, as passed to OpenGL (alpha is opacity)
+     */
+    void setColor(const sad::AColor& color);
+    /*! Forgets current color. Must be called, when current color becomes undefined,
+        like after drawing with color arrays
+     */
+    void forgetColor();
+    /*! Enables or disables blending
+        \param[in] enabled whether blending is enabled
+     */
+    void setBlendEnabled(bool enabled);
+    /*! Sets blending function
+        \param[in] source a source factor
+        \param[in] destination a destination factor
+     */
+    void setBlendFunction(unsigned int source, unsigned int destination);
+    /*! Enables or disables 2D texturing
+        \param[in] enabled whether texturing is enabled
+     */
+    void setTextureEnabled(bool enabled);
+    /*! Sets current matrix mode
+        \param[in] mode a matrix mode
+     */
+    void setMatrixMode(unsigned int mode);
+    /*! Returns current matrix mode, if it's known
+        \return matrix mode
+     */
+    const sad::Maybe<unsigned int>& matrixMode() const;
+    /*! Forgets all of state, so next changes will be passed to OpenGL.
+        Must be called, when context is changed or state is changed by external code
+     */
+    void invalidate();
+    /*! Returns amount of calls, passed to OpenGL
+        \return amount of calls
+     */
+    unsigned int issuedCalls() const;
+    /*! Returns amount of calls, avoided since they did not change state
+        \return amount of calls
+     */
+    unsigned int avoidedCalls() const;
+    /*! Returns amount of avoided bindings of texture
+        \return amount of calls
+     */
+    unsigned int avoidedTextureBinds() const;
+    /*! Returns amount of avoided changes of color
+        \return amount of calls
+     */
+    unsigned int avoidedColorChanges() const;
+    /*! Resets counters of calls
+     */
+    void resetCounters();
+protected:
+    /*! Enables or disables capability
+        \param[in] state a known state of capability
+        \param[in] capability a capability
+        \param[in] enabled whether it should be enabled
+     */
+    void setCapability(sad::Maybe<bool>& state, unsigned int capability, bool enabled);
+
+    /*! A bound texture
+     */
+    sad::Maybe<unsigned int> m_texture;
+    /*! A current color
+     */
+    sad::Maybe<sad::AColor> m_color;
+    /*! Whether blending is enabled
+     */
+    sad::Maybe<bool> m_blend;
+    /*! A source factor of blending
+     */
+    sad::Maybe<unsigned int> m_blend_source;
+    /*! A destination factor of blending
+     */
+    sad::Maybe<unsigned int> m_blend_destination;
+    /*! Whether 2D texturing is enabled
+     */
+    sad::Maybe<bool> m_texture_2d;
+    /*! A matrix mode
+     */
+    sad::Maybe<unsigned int> m_matrix_mode;
+    /*! Amount of calls, passed to OpenGL
+     */
+    unsigned int m_issued_calls;
+    /*! Amount of avoided calls
+     */
+    unsigned int m_avoided_calls;
+    /*! Amount of avoided bindings of texture
+     */
+    unsigned int m_avoided_texture_binds;
+    /*! Amount of avoided changes of color
+     */
+    unsigned int m_avoided_color_changes;
+};
+
+}
+
+}
@@ -0,0 +1,169 @@
+/*! \file rendering/nullbackend.h
+
+
+    Defines a backend for rendering, which does not render anything, but counts commands
+    of every frame
+ */
+#pragma once
+#include "backend.h"
+#include "framestatistics.h"
+#include "../sadvector.h"
+
+namespace sad
+{
+
+namespace rendering
+{
+
+/*! \class NullBackend
+
+    A backend, which does not render anything, but collects statistics of commands for
+    every frame. Used by headless renderer and for replaying recorded commands
+ */
+class NullBackend: public sad::rendering::Backend
+{
+public:
+    /*! Creates new backend
+     */
+    NullBackend();
+    /*! Can be inherited
+     */
+    virtual ~NullBackend() override;
+    /*! Does nothing, commands are counted for current frame, until it's finished
+     */
+    virtual void startFrame() override;
+    /*! Finishes statistics for current frame
+     */
+    virtual void finishFrame() override;
+    /*! Counts a change of projection
+        \param[in] width a width of viewport
+        \param[in] height a height of viewport
+     */
+    virtual void setOrthographicProjection(double width, double height) override;
+    /*! Counts a matrix operation
+     */
+    virtual void pushMatrix() override;
+    /*! Counts a matrix operation
+     */
+    virtual void popMatrix() override;
+    /*! Counts a matrix operation
+        \param[in] x x offset
+        \param[in] y y offset
+        \param[in] z z offset
+     */
+    virtual void translate(double x, double y, double z) override;
+    /*! Counts a matrix operation
+        \param[in] angle an angle in degrees
+        \param[in] x x component of rotation axis
+        \param[in] y y component of rotation axis
+        \param[in] z z component of rotation axis
+     */
+    virtual void rotate(double angle, double x, double y, double z) override;
+    /*! Counts a draw call for quad
+        \param[in] texture a texture (must not be NULL)
+        \param[in] area a rendered area
+        \param[in] texture_coordinates a normalized texture coordinates for each point of area
+        \param[in] color a color of quad
+     */
+    virtual void drawSprite(
+        sad::Texture* texture,
+        const sad::Rect2D& area,
+        const sad::Rect2D& texture_coordinates,
+        const sad::AColor& color
+    ) override;
+    /*! Counts a draw call for quads
+        \param[in] texture a texture (must not be NULL)
+        \param[in] vertexes a coordinates of vertexes (two per vertex, four vertexes per quad)
+        \param[in] texture_coordinates a texture coordinates (two per vertex)
+        \param[in] colors a colors (four bytes per vertex)
+        \param[in] quads amount of quads
+     */
+    virtual void drawQuads(
+        sad::Texture* texture,
+        const float* vertexes,
+        const float* texture_coordinates,
+        const unsigned char* colors,
+        unsigned int quads
+    ) override;
+    /*! Counts a draw call for lines
+        \param[in] points a pairs of points of lines
+        \param[in] count amount of points
+        \param[in] color a color of lines
+     */
+    virtual void drawLines(const sad::Point2D* points, unsigned int count, const sad::AColor& color) override;
+    /*! Counts a draw call for text. Since font binds own texture, next texture is counted as switch.
+        Text is not rendered.
+        \param[in] characters amount of rendered characters
+        \param[in] render a function, which renders text via OpenGL
+     */
+    virtual void drawText(unsigned int characters, const std::function<void()>& render) override;
+    /*! Sets, whether statistics of every finished frame should be kept. Disabled by default,
+        so long running renderer won't grow memory
+        \param[in] keep whether statistics should be kept
+     */
+    void setKeepsHistory(bool keep);
+    /*! Returns, whether statistics of every finished frame are kept
+        \return whether statistics are kept
+     */
+    bool keepsHistory() const;
+    /*! Returns statistics of all finished frames, if they are kept
+        \return statistics
+     */
+    const sad::Vector<sad::rendering::FrameStatistics>& frames() const;
+    /*! Returns amount of finished frames
+        \return amount of frames
+     */
+    unsigned int frameCount() const;
+    /*! Returns statistics of last finished frame
+        \return statistics
+     */
+    const sad::rendering::FrameStatistics& lastFrame() const;
+    /*! Returns sum of statistics for all frames, including current one
+        \return statistics
+     */
+    sad::rendering::FrameStatistics total() const;
+    /*! Clears statistics and forgets tracked state
+     */
+    void clear();
+protected:
+    /*! Counts binding of texture
+        \param[in] texture a texture
+     */
+    void bindTexture(sad::Texture* texture);
+    /*! Counts setting of current color
+        \param[in] color a color
+     */
+    void setColor(const sad::AColor& color);
+
+    /*! A statistics for current frame
+     */
+    sad::rendering::FrameStatistics m_frame;
+    /*! A statistics for last finished frame
+     */
+    sad::rendering::FrameStatistics m_last_frame;
+    /*! A sum of statistics of finished frames
+     */
+    sad::rendering::FrameStatistics m_total;
+    /*! A statistics for finished frames, if kept
+     */
+    sad::Vector<sad::rendering::FrameStatistics> m_frames;
+    /*! Amount of finished frames
+     */
+    unsigned int m_frame_count;
+    /*! Whether statistics of finished frames are kept
+     */
+    bool m_keeps_history;
+    /*! A last bound texture
+     */
+    sad::Texture* m_texture;
+    /*! A last set color
+     */
+    sad::AColor m_color;
+    /*! Whether color was set
+     */
+    bool m_color_set;
+};
+
+}
+
+}
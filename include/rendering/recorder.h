@@ -0,0 +1,129 @@
+/*! \file rendering/recorder.h
+
+
+    Defines a backend for rendering, which records all commands into command buffer,
+    passing them to other backend
+ */
+#pragma once
+#include "backend.h"
+#include "commandbuffer.h"
+#include "../sadhash.h"
+
+namespace sad
+{
+
+namespace rendering
+{
+
+/*! \class Recorder
+
+    A backend, which records all commands into a command buffer and passes them to
+    target backend, if it's set. Textures are recorded with keys, assigned on first use
+ */
+class Recorder: public sad::rendering::Backend
+{
+public:
+    /*! Creates new recorder. Recorder does not own buffer and target
+        \param[in] buffer a buffer, where commands are recorded
+        \param[in] target a target backend, which receives commands (NULL to only record them)
+     */
+    Recorder(sad::rendering::CommandBuffer* buffer, sad::rendering::Backend* target = NULL);
+    /*! Can be inherited
+     */
+    virtual ~Recorder() override;
+    /*! Returns a buffer, where commands are recorded
+        \return buffer
+     */
+    sad::rendering::CommandBuffer* buffer() const;
+    /*! Returns a backend, which receives commands
+        \return target backend
+     */
+    sad::rendering::Backend* target() const;
+    /*! Records starting of frame
+     */
+    virtual void startFrame() override;
+    /*! Records finishing of frame
+     */
+    virtual void finishFrame() override;
+    /*! Records setting of orthographic projection
+        \param[in] width a width of viewport
+        \param[in] height a height of viewport
+     */
+    virtual void setOrthographicProjection(double width, double height) override;
+    /*! Records pushing of model-view matrix
+     */
+    virtual void pushMatrix() override;
+    /*! Records popping of model-view matrix
+     */
+    virtual void popMatrix() override;
+    /*! Records translation of model-view matrix
+        \param[in] x x offset
+        \param[in] y y offset
+        \param[in] z z offset
+     */
+    virtual void translate(double x, double y, double z) override;
+    /*! Records rotation of model-view matrix
+        \param[in] angle an angle in degrees
+        \param[in] x x component of rotation axis
+        \param[in] y y component of rotation axis
+        \param[in] z z component of rotation axis
+     */
+    virtual void rotate(double angle, double x, double y, double z) override;
+    /*! Records drawing a textured quad of sprite
+        \param[in] texture a texture (must not be NULL)
+        \param[in] area a rendered area
+        \param[in] texture_coordinates a normalized texture coordinates for each point of area
+        \param[in] color a color of quad
+     */
+    virtual void drawSprite(
+        sad::Texture* texture,
+        const sad::Rect2D& area,
+        const sad::Rect2D& texture_coordinates,
+        const sad::AColor& color
+    ) override;
+    /*! Records drawing of several textured quads
+        \param[in] texture a texture (must not be NULL)
+        \param[in] vertexes a coordinates of vertexes (two per vertex, four vertexes per quad)
+        \param[in] texture_coordinates a texture coordinates (two per vertex)
+        \param[in] colors a colors (four bytes per vertex)
+        \param[in] quads amount of quads
+     */
+    virtual void drawQuads(
+        sad::Texture* texture,
+        const float* vertexes,
+        const float* texture_coordinates,
+        const unsigned char* colors,
+        unsigned int quads
+    ) override;
+    /*! Records drawing of lines
+        \param[in] points a pairs of points of lines
+        \param[in] count amount of points
+        \param[in] color a color of lines
+     */
+    virtual void drawLines(const sad::Point2D* points, unsigned int count, const sad::AColor& color) override;
+    /*! Records drawing of text
+        \param[in] characters amount of rendered characters
+        \param[in] render a function, which renders text via OpenGL
+     */
+    virtual void drawText(unsigned int characters, const std::function<void()>& render) override;
+protected:
+    /*! Returns key of texture, recording its definition on first use
+        \param[in] texture a texture
+        \return key
+     */
+    unsigned int textureKey(sad::Texture* texture);
+
+    /*! A buffer, where commands are recorded
+     */
+    sad::rendering::CommandBuffer* m_buffer;
+    /*! A backend, which receives commands
+     */
+    sad::rendering::Backend* m_target;
+    /*! A keys of recorded textures
+     */
+    sad::Hash<sad::Texture*, unsigned int> m_textures;
+};
+
+}
+
+}
@@ -0,0 +1,140 @@
+/*! \file rendering/textureresidency.h
+
+
+    Defines a manager of textures, resident on GPU, which keeps their memory within budget
+ */
+#pragma once
+#include "../sadhash.h"
+#include "../sadmutex.h"
+
+#include <cstddef>
+
+namespace sad
+{
+class Texture;
+
+namespace rendering
+{
+
+/*! \class TextureResidency
+
+    Tracks memory of textures, uploaded to GPU, and frame, when each of them was bound last time.
+    When a budget is set and resident textures exceed it, least recently used textures are unloaded
+    from GPU via sad::Texture::unloadFromGPU. Since texture keeps its pixels, it's uploaded again on
+    next binding. Textures, bound in current frame, are never evicted, so budget could be exceeded,
+    if one frame needs more memory. Owned by sad::Renderer
+ */
+class TextureResidency
+{
+public:
+    /*! Creates new manager without budget
+     */
+    TextureResidency();
+    /*! Can be inherited
+     */
+    virtual ~TextureResidency();
+    /*! Sets a budget of GPU memory for textures. If resident textures exceed it, they are evicted
+        immediately
+        \param[in] bytes a budget in bytes (0 for unlimited)
+     */
+    void setBudget(size_t bytes);
+    /*! Returns a budget of GPU memory for textures
+        \return budget in bytes (0 for unlimited)
+     */
+    size_t budget() const;
+    /*! Starts new frame. Called by renderer before rendering scenes
+     */
+    void startFrame();
+    /*! Returns index of current frame
+        \return index of frame
+     */
+    unsigned int frame() const;
+    /*! Must be called, when texture is uploaded to GPU. Evicts other textures, if budget is exceeded
+        \param[in] texture a texture
+     */
+    void textureUploaded(sad::Texture* texture);
+    /*! Must be called, when texture is bound
+        \param[in] texture a texture
+     */
+    void textureBound(sad::Texture* texture);
+    /*! Must be called, when texture is unloaded from GPU
+        \param[in] texture a texture
+     */
+    void textureUnloaded(sad::Texture* texture);
+    /*! Must be called, when texture is destroyed
+        \param[in] texture a texture
+     */
+    void textureDestroyed(sad::Texture* texture);
+    /*! Tests, whether texture is tracked as resident
+        \param[in] texture a texture
+        \return whether it's resident
+     */
+    bool isResident(sad::Texture* texture) const;
+    /*! Returns a frame, when texture was bound last time
+        \param[in] texture a texture
+        \return frame (0 if texture is not resident)
+     */
+    unsigned int lastBoundFrame(sad::Texture* texture) const;
+    /*! Returns total GPU memory of resident textures
+        \return memory in bytes
+     */
+    size_t residentBytes() const;
+    /*! Returns amount of resident textures
+        \return amount of textures
+     */
+    size_t residentTextures() const;
+    /*! Returns amount of textures, evicted from GPU
+        \return amount of evictions
+     */
+    unsigned int evictions() const;
+    /*! Returns amount of uploads of previously evicted textures
+        \return amount of uploads
+     */
+    unsigned int reuploads() const;
+    /*! Resets amount of evictions and uploads
+     */
+    void resetStatistics();
+protected:
+    /*! A record for resident texture
+     */
+    struct Record
+    {
+        size_t Bytes;             //!< A GPU memory of texture
+        unsigned int LastFrame;   //!< A frame, when texture was bound last time
+    };
+    /*! Evicts least recently used textures, until budget is reached. Mutex must not be locked
+     */
+    void enforceBudget();
+
+    /*! A resident textures
+     */
+    sad::Hash<sad::Texture*, sad::rendering::TextureResidency::Record> m_resident;
+    /*! A textures, which were evicted and not uploaded yet
+     */
+    sad::Hash<sad::Texture*, bool> m_evicted;
+    /*! A budget in bytes
+     */
+    size_t m_budget;
+    /*! A total memory of resident textures
+     */
+    size_t m_resident_bytes;
+    /*! A current frame
+     */
+    unsigned int m_frame;
+    /*! An amount of evictions
+     */
+    unsigned int m_evictions;
+    /*! An amount of uploads of evicted textures
+     */
+    unsigned int m_reuploads;
+    /*! Whether textures are evicted now
+     */
+    bool m_evicting;
+    /*! A lock for tracked textures, since they could be destroyed in other threads
+     */
+    mutable sad::Mutex m_lock;
+};
+
+}
+
+}
@@ -0,0 +1,265 @@
+/*! \file resource/asyncloading.h
+
+
+    Contains definition of class AsyncLoading.
+
+    An asynchronous loading of resources to a tree. Files are decoded on a pool of worker threads,
+    while resources are added to a tree and textures are uploaded to GPU on a thread of renderer's
+    context, via renderer's pipeline.
+ */
+#pragma once
+#include "../refcountable.h"
+#include "../sadvector.h"
+#include "../sadthread.h"
+#include "../sadmutex.h"
+#include "../maybe.h"
+#include "../pipeline/pipelinestep.h"
+#include "../3rdparty/picojson/picojson.h"
+#include "error.h"
+
+#include <atomic>
+
+namespace sad
+{
+class Texture;
+
+namespace resource
+{
+class Tree;
+class Folder;
+class ResourceFile;
+
+/*! \class AsyncLoading
+
+    A progress of asynchronous loading of tree. Created by sad::resource::Tree::loadFromStringAsync
+    and sad::resource::Tree::loadFromFileAsync.
+
+    Like synchronous loading, resources are added to a tree only if all of files are loaded without errors.
+    Note, that tree must not be loaded or destroyed, until loading is committed.
+ */
+class AsyncLoading: public sad::RefCountable
+{
+public:
+    /*! A step of pipeline, which commits loading and uploads textures on a thread of renderer's
+        context. Removed from pipeline, when loading is finished.
+     */
+    class PipelineStep: public sad::pipeline::Step
+    {
+    public:
+        /*! Creates new step for loading, holding a reference to it
+            \param[in] loading a loading
+         */
+        PipelineStep(sad::resource::AsyncLoading* loading);
+        /*! Releases a reference to loading
+         */
+        virtual ~PipelineStep();
+        /*! Whether loading is finished
+            \return whether step should be removed
+         */
+        virtual bool shouldBeDestroyedAfterProcessing();
+    protected:
+        /*! Updates loading
+         */
+        virtual void _process();
+        /*! A loading
+         */
+        sad::resource::AsyncLoading* m_loading;
+        /*! Whether loading is finished
+         */
+        bool m_finished;
+    };
+    /*! Creates new loading for a tree. Call start to run it
+        \param[in] tree a tree, where resources are loaded
+     */
+    AsyncLoading(sad::resource::Tree* tree);
+    /*! Cancels decoding, waits for worker threads and frees all of not committed data
+     */
+    virtual ~AsyncLoading();
+    /*! Parses resource list and starts decoding files on worker threads. If renderer of tree is set,
+        adds a step to it's pipeline, which commits loading, when files are decoded.
+        \param[in] string a resource list
+        \param[in] threads amount of worker threads (0 for amount of hardware threads)
+     */
+    void start(const sad::String& string, size_t threads = 0);
+    /*! Marks loading as failed with error, without decoding anything
+        \param[in] error an error
+     */
+    void fail(sad::resource::Error* error);
+    /*! Returns a tree, where resources are loaded
+        \return tree
+     */
+    sad::resource::Tree* tree() const;
+    /*! Returns amount of files in resource list
+        \return amount of files
+     */
+    size_t total() const;
+    /*! Returns amount of already decoded files
+        \return amount of decoded files
+     */
+    size_t decoded() const;
+    /*! Returns progress of loading from 0 to 1. Decoding of every file and uploading of every
+        texture counts as a unit of work
+        \return progress
+     */
+    double progress() const;
+    /*! Whether all files are decoded
+        \return whether all files are decoded
+     */
+    bool decodingFinished() const;
+    /*! Whether resources are added to tree (or loading failed)
+        \return whether loading is committed
+     */
+    bool committed() const;
+    /*! Whether loading is committed and all textures are uploaded to GPU
+        \return whether loading is finished
+     */
+    bool finished() const;
+    /*! Returns amount of textures, waiting to be uploaded to GPU
+        \return amount of textures
+     */
+    size_t pendingUploads() const;
+    /*! Sets maximal amount of textures, uploaded on a frame
+        \param[in] count amount of textures (0 for unlimited)
+     */
+    void setUploadsPerFrame(size_t count);
+    /*! Returns maximal amount of textures, uploaded on a frame
+        \return amount of textures (0 for unlimited)
+     */
+    size_t uploadsPerFrame() const;
+    /*! Cancels decoding of files, which are not decoded yet. Loading will fail, if not committed
+     */
+    void cancel();
+    /*! Whether loading was cancelled
+        \return whether loading was cancelled
+     */
+    bool cancelled() const;
+    /*! Blocks execution, until all files are decoded, and commits loading on calling thread.
+        Textures are not uploaded and will be uploaded by pipeline step or on first bind.
+        Must be called from thread, that owns tree.
+        \return list of errors
+     */
+    const sad::Vector<sad::resource::Error*>& wait();
+    /*! Returns list of errors. Errors are owned by loading. List is complete, when loading is committed
+        \return list of errors
+     */
+    const sad::Vector<sad::resource::Error*>& errors() const;
+    /*! Commits loading, if all files are decoded, and uploads textures.
+        Must be called on a thread of renderer's context
+        \return whether loading is finished
+     */
+    bool update();
+private:
+    /*! An entry of resource list
+     */
+    struct Entry
+    {
+        /*! A type of file
+         */
+        sad::String Type;
+        /*! A name of file
+         */
+        sad::String FileName;
+        /*! A name of resource
+         */
+        sad::Maybe<sad::String> ResourceName;
+        /*! A description of entry
+         */
+        picojson::value Description;
+        /*! Whether file could be decoded in parallel with other ones
+         */
+        bool Parallel;
+        /*! Whether entry was decoded. Entries are skipped, when loading is cancelled or failed
+         */
+        bool Decoded;
+        /*! A folder, where resources of entry are decoded to
+         */
+        sad::resource::Folder* Folder;
+        /*! A decoded files
+         */
+        sad::Vector<sad::resource::ResourceFile*> Files;
+        /*! An errors of decoding
+         */
+        sad::Vector<sad::resource::Error*> Errors;
+    };
+    /*! Adds a step, which commits loading, to pipeline of tree's renderer
+     */
+    void appendToPipeline();
+    /*! Decodes all files. Run in coordinating thread
+     */
+    void decode();
+    /*! Decodes an entry
+        \param[in] index an index of entry
+     */
+    void decodeEntry(size_t index);
+    /*! Adds resources to tree or frees them, if errors occurred
+     */
+    void commit();
+    /*! Uploads pending textures to GPU
+     */
+    void upload();
+    /*! Disabled, loading is uncopyable
+        \param[in] o other loading
+     */
+    AsyncLoading(const sad::resource::AsyncLoading& o);
+    /*! Disabled, loading is uncopyable
+        \param[in] o other loading
+        \return self-reference
+     */
+    sad::resource::AsyncLoading& operator=(const sad::resource::AsyncLoading& o);
+
+    /*! A tree
+     */
+    sad::resource::Tree* m_tree;
+    /*! A root folder of tree, when loading was started, used to resolve paths
+     */
+    sad::String m_temporary_root;
+    /*! An entries of resource list
+     */
+    sad::Vector<sad::resource::AsyncLoading::Entry*> m_entries;
+    /*! A folder, where decoded resources are merged into
+     */
+    sad::resource::Folder* m_new_root;
+    /*! A decoded files
+     */
+    sad::Vector<sad::resource::ResourceFile*> m_new_files;
+    /*! A list of errors
+     */
+    sad::Vector<sad::resource::Error*> m_errors;
+    /*! A textures, waiting to be uploaded
+     */
+    sad::Vector<sad::Texture*> m_uploads;
+    /*! Amount of uploaded textures
+     */
+    size_t m_uploaded;
+    /*! Maximal amount of textures, uploaded on a frame
+     */
+    size_t m_uploads_per_frame;
+    /*! Amount of worker threads
+     */
+    size_t m_thread_count;
+    /*! A coordinating thread
+     */
+    sad::Thread* m_thread;
+    /*! A lock for committing loading
+     */
+    sad::Mutex m_commit_lock;
+    /*! Amount of decoded files
+     */
+    std::atomic<size_t> m_decoded;
+    /*! Whether all files are decoded
+     */
+    std::atomic<bool> m_decoding_finished;
+    /*! Whether decoding of files should be stopped
+     */
+    std::atomic<bool> m_cancelled;
+    /*! Whether some file is failed to load, so rest of them could be skipped
+     */
+    std::atomic<bool> m_failed;
+    /*! Whether loading is committed
+     */
+    bool m_committed;
+};
+
+}
+
+}
@@ -75,6 +75,35 @@ protected:
     sad::String m_name;
 };
 
+/*! \class LoadingCancelled
+
+    Describes an error, when asynchronous loading of tree was cancelled before all files were loaded
+ */
+class LoadingCancelled: public sad::resource::Error  
+{	
+SAD_OBJECT
+public:
+    /*! Formats error
+        \return error string
+     */
+    inline static sad::String format_error()
+    {
+        return "Loading was cancelled";
+    }
+
+    /*! Constructs a error for cancelled loading
+     */
+    inline LoadingCancelled()
+    : sad::resource::Error(sad::resource::LoadingCancelled::format_error())
+    {
+        
+    }
+
+    /*! This class can be inherited 
+     */
+    virtual ~LoadingCancelled() throw();
+};
+
 /*! \class ResourceLoadError
     A resource loading error
  */
@@ -593,4 +622,5 @@ DECLARE_TYPE_AS_SAD_OBJECT_ENUM(sad::resource::MalformedResourceEntry)
 DECLARE_TYPE_AS_SAD_OBJECT_ENUM(sad::resource::EmptyTextureAtlas)
 DECLARE_TYPE_AS_SAD_OBJECT_ENUM(sad::resource::TreeNotFound)
 DECLARE_TYPE_AS_SAD_OBJECT_ENUM(sad::resource::ResourceCannotBeLoadedFromArchive)
+DECLARE_TYPE_AS_SAD_OBJECT_ENUM(sad::resource::LoadingCancelled)
 
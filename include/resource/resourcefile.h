@@ -154,6 +154,10 @@ public:
         \return false. Until this function is overridden, physical file would not be loaded from archives
      */
     virtual bool supportsLoadingFromTar7z() const;
+    /*! Returns whether file could be loaded on worker thread, in parallel with other files of tree
+        \return true. Override for files, which depend on resources of other files
+     */
+    virtual bool supportsParallelLoading() const;
 protected: 
     /*! Tries to read a file to string
         \param[in] force_reload whether we should force reloading of file
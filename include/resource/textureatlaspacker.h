@@ -0,0 +1,81 @@
+/*! \file resource/textureatlaspacker.h
+
+
+    Contains definition of class TextureAtlasPacker.
+
+    A packer, which places small textures into shared pages of runtime texture atlas,
+    so sprites with different textures could be rendered without switching textures.
+ */
+#pragma once
+#include "../sadvector.h"
+
+namespace sad
+{
+class Texture;
+
+namespace resource
+{
+
+/*! \class TextureAtlasPacker
+
+    Packs textures into pages of texture atlas, using bundled framepacker. Every page is
+    a square power-of-two sad::Texture without mip-maps. Pixels of textures are copied into
+    pages and textures are placed into them via sad::Texture::placeInAtlas, so textures
+    could be still used as before. Texture edges are extruded into padding to prevent bleeding
+    of neighbours, when texture is filtered.
+ */
+class TextureAtlasPacker
+{
+public:
+    /*! Creates new packer
+        \param[in] page_size a maximal size of page in pixels
+        \param[in] padding a padding around every texture in pixels
+     */
+    TextureAtlasPacker(unsigned int page_size = 1024, unsigned int padding = 1);
+    /*! Can be inherited
+     */
+    virtual ~TextureAtlasPacker();
+    /*! Returns maximal size of page
+        \return maximal size of page in pixels
+     */
+    unsigned int pageSize() const;
+    /*! Returns padding around every texture
+        \return padding in pixels
+     */
+    unsigned int padding() const;
+    /*! Returns, whether texture could be placed into atlas. Only textures with eight bits per
+        component, which are not placed already and fit page could be placed
+        \param[in] texture a texture
+        \return whether texture could be packed
+     */
+    bool canBePacked(sad::Texture* texture) const;
+    /*! Packs textures into new pages. Textures, which cannot be packed are left as is.
+        \param[in] textures a list of textures
+        \return created pages, which must be freed by caller after all of textures
+     */
+    sad::Vector<sad::Texture*> pack(const sad::Vector<sad::Texture*>& textures) const;
+protected:
+    /*! Tries to pack group of textures into one page. If they don't fit, group is split in halves
+        \param[in] textures a group of textures
+        \param[out] pages a created pages
+     */
+    void packGroup(const sad::Vector<sad::Texture*>& textures, sad::Vector<sad::Texture*>& pages) const;
+    /*! Copies pixels of texture into page, extruding edges into padding
+        \param[in] texture a texture
+        \param[in] page a page
+        \param[in] x horizontal offset in page
+        \param[in] y vertical offset in page
+     */
+    void copy(sad::Texture* texture, sad::Texture* page, unsigned int x, unsigned int y) const;
+
+    /*! A maximal size of page
+     */
+    unsigned int m_page_size;
+    /*! A padding around every texture
+     */
+    unsigned int m_padding;
+};
+
+}
+
+}
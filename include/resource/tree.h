@@ -10,6 +10,7 @@
 #include "../sadptrvector.h"
 #include "../sadhash.h"
 #include "../refcountable.h"
+#include "../sadmutex.h"
 #include "resource.h"
 #include "resourcefactory.h"
 #include "folder.h"
@@ -27,9 +28,11 @@ class Entry;
 namespace sad
 {
 class Renderer;
+class Texture;
 
 namespace resource
 {
+class AsyncLoading;
 
 /*! \class Tree
 
@@ -70,6 +73,20 @@ public:
         \return maybe error message
      */
     sad::Maybe<sad::String> tryLoadFromFile(const sad::String & string);
+    /*! Starts loading a tree from a string asynchronously. Files are decoded on worker threads,
+        while resources are added to tree and textures are uploaded on renderer's thread
+        via it's pipeline, or when sad::resource::AsyncLoading::wait is called.
+        \param[in] string a resource list
+        \param[in] threads amount of worker threads (0 for amount of hardware threads)
+        \return a loading. Caller should call addRef to keep it and delRef, when it's not needed
+     */
+    sad::resource::AsyncLoading* loadFromStringAsync(const sad::String & string, size_t threads = 0);
+    /*! Starts loading a tree from a file asynchronously. Resource list is read on calling thread.
+        \param[in] string a name of file
+        \param[in] threads amount of worker threads (0 for amount of hardware threads)
+        \return a loading. Caller should call addRef to keep it and delRef, when it's not needed
+     */
+    sad::resource::AsyncLoading* loadFromFileAsync(const sad::String & string, size_t threads = 0);
     /*! Loads new file. If no errors found, all resources will be stored in
         node.
 
@@ -189,7 +206,43 @@ public:
         \return entry if entry exists
      */
     tar7z::Entry* archiveEntry(const sad::String& archive, const sad::String filename, bool loadnew = false);
+    /*! Enables or disables runtime texture atlas. When enabled, textures, which are not larger than
+        threshold, are packed into shared pages of atlas, when they are loaded, so sprites with
+        different small textures could be rendered without switching textures. Textures are packed
+        per loading call, so it's better to load them with one resource list. Disabled by default,
+        since sprites could not repeat packed textures via texture coordinates outside of texture.
+        \param[in] enabled whether atlas is enabled
+     */
+    void setTextureAtlasEnabled(bool enabled);
+    /*! Returns whether runtime texture atlas is enabled
+        \return whether atlas is enabled
+     */
+    bool textureAtlasEnabled() const;
+    /*! Sets maximal width and height of texture, which could be packed into atlas
+        \param[in] threshold a maximal size of side in pixels
+     */
+    void setTextureAtlasThreshold(unsigned int threshold);
+    /*! Returns maximal width and height of texture, which could be packed into atlas
+        \return maximal size of side in pixels
+     */
+    unsigned int textureAtlasThreshold() const;
+    /*! Sets maximal size of page of atlas
+        \param[in] size a size in pixels
+     */
+    void setTextureAtlasPageSize(unsigned int size);
+    /*! Returns maximal size of page of atlas
+        \return size in pixels
+     */
+    unsigned int textureAtlasPageSize() const;
+    /*! Returns pages of runtime texture atlas, owned by tree
+        \return pages
+     */
+    const sad::Vector<sad::Texture*>& textureAtlasPages() const;
 protected:
+    /*! Packs small textures from files into new pages of atlas, if atlas is enabled
+        \param[in] files a loaded files
+     */
+    void packTextures(const sad::Vector<sad::resource::ResourceFile*>& files);
     /*! An archive list
      */
     sad::Vector<tar7z::Archive*> m_archive_list;
@@ -214,7 +267,28 @@ protected:
     /*! Whether we should store links
      */
     bool m_storelinks;
+    /*! A lock for archives, since they could be requested from several loading threads
+     */
+    sad::Mutex m_archives_lock;
+    /*! Whether runtime texture atlas is enabled
+     */
+    bool m_texture_atlas_enabled;
+    /*! A maximal size of side of texture, which could be packed into atlas
+     */
+    unsigned int m_texture_atlas_threshold;
+    /*! A maximal size of page of atlas
+     */
+    unsigned int m_texture_atlas_page_size;
+    /*! A pages of runtime texture atlas
+     */
+    sad::Vector<sad::Texture*> m_texture_atlas_pages;
 private:
+    friend class sad::resource::AsyncLoading;
+    /*! Reads a resource list from file, setting a temporary root
+        \param[in] string a name of file
+        \return contents of file, if it's read
+     */
+    sad::Maybe<sad::String> readFile(const sad::String& string);
     /*! A current root for loading data
      */
     sad::String m_current_root;
@@ -0,0 +1,84 @@
+/*! \file sadworkerpool.h
+
+
+    Describes a simple pool of worker threads, used to perform independent tasks
+    (like narrow phase of collision detection or decoding of resources) in parallel
+ */
+#pragma once
+#include <atomic>
+#include <functional>
+#include "sadthread.h"
+#include "sadsemaphore.h"
+#include "sadvector.h"
+
+
+namespace sad
+{
+
+/*! A pool of worker threads, which performs a set of independent tasks, indexed from zero.
+    Tasks are distributed dynamically: every thread takes next not performed task, until all tasks are done.
+    Calling thread also performs tasks, so pool with thread count N creates only N - 1 threads.
+ */
+class WorkerPool
+{
+public:
+    /*! Makes new pool with specified amount of threads, including calling thread
+        \param[in] threads amount of threads (values less than one are treated as one)
+     */
+    WorkerPool(size_t threads);
+    /*! Stops and frees all threads
+     */
+    ~WorkerPool();
+    /*! Returns amount of threads, including calling thread
+        \return amount of threads
+     */
+    size_t threadCount() const;
+    /*! Performs tasks in parallel, blocking execution until all of them are done.
+        Note, that this function is not reentrant and must be called only from one thread.
+        \param[in] tasks amount of tasks
+        \param[in] f a function, which performs task with specified index
+     */
+    void run(size_t tasks, const std::function<void(size_t)>& f);
+private:
+    /*! Main loop of worker thread
+        \param[in] index index of worker
+        \return zero
+     */
+    int workerLoop(size_t index);
+    /*! Performs tasks, until there are no tasks left
+     */
+    void performTasks();
+    /*! Disabled copying
+        \param[in] o other pool
+     */
+    WorkerPool(const sad::WorkerPool& o);
+    /*! Disabled copying
+        \param[in] o other pool
+        \return self-reference
+     */
+    sad::WorkerPool& operator=(const sad::WorkerPool& o);
+
+    /*! A worker threads
+     */
+    sad::Vector<sad::Thread*> m_threads;
+    /*! A semaphores, which are released, when worker should start performing tasks
+     */
+    sad::Vector<sad::Semaphore*> m_start;
+    /*! A semaphore, which is released by each worker, when it's finished performing tasks
+     */
+    sad::Semaphore m_finished;
+    /*! A currently performed function
+     */
+    const std::function<void(size_t)>* m_function;
+    /*! Amount of tasks
+     */
+    size_t m_tasks;
+    /*! An index of next task, that should be performed
+     */
+    std::atomic<size_t> m_next_task;
+    /*! Whether workers should stop
+     */
+    bool m_stopping;
+};
+
+}
@@ -109,6 +109,34 @@ public:
     {
         return m_active;
     }
+    /*! Enables or disables culling of nodes, which are outside of camera's view. Culling works only
+        for cameras, which could compute their view, like sad::OrthographicCamera, and skips only nodes,
+        that report their bounds via sad::SceneNode::boundingRect. Disabled by default
+        \param[in] enabled whether culling is enabled
+     */
+    void setCullingEnabled(bool enabled);
+    /*! Whether culling of nodes, which are outside of camera's view, is enabled
+        \return whether culling is enabled
+     */
+    bool cullingEnabled() const;
+    /*! Sets margin, by which camera's view is extended, when culling nodes. Could be used for nodes,
+        which render something outside of their bounds
+        \param[in] margin a margin
+     */
+    void setCullingMargin(double margin);
+    /*! Returns margin, by which camera's view is extended, when culling nodes
+        \return margin
+     */
+    double cullingMargin() const;
+    /*! Returns amount of nodes, skipped as outside of view on last rendering of scene
+        \return amount of culled nodes
+     */
+    size_t culledNodeCount() const;
+    /*! Returns amount of nodes, rendered on last rendering of scene. For headless renderer
+        returns amount of visible nodes, which would be rendered
+        \return amount of rendered nodes
+     */
+    size_t renderedNodeCount() const;
     /*! Returns cached scene layer parameter for scene
         \return scene layer
      */
@@ -162,6 +190,21 @@ protected:
     /*! Renderer, which scene belongs to
      */
     sad::Renderer*        m_renderer;       
+    /*! Whether nodes outside of camera's view should be culled
+     */
+    bool m_culling_enabled;
+    /*! A margin, by which camera's view is extended, when culling nodes
+     */
+    double m_culling_margin;
+    /*! Amount of nodes, culled on last rendering
+     */
+    size_t m_culled_node_count;
+    /*! Amount of nodes, rendered on last rendering
+     */
+    size_t m_rendered_node_count;
+    /*! Counts visible nodes instead of rendering them, when renderer is headless
+     */
+    void countNodesWithoutRendering();
     /*! Adds an object to scene
         \param[in] node 
      */
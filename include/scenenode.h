@@ -12,6 +12,7 @@ namespace sad
 {
 class Scene;
 class Renderer;
+class SpriteBatch;
 
 /*! Defines an object, which is basic for any renderable part of scene
  */
@@ -25,11 +26,25 @@ public:
     /*! Implement this to make object render a part of scene
      */
     virtual void render() = 0;
+    /*! Tries to add node to a batch instead of rendering it immediately. If node 
+        could not be batched, it will be rendered, using sad::SceneNode::render.
+        By default, nodes are not batchable.
+        \param[in] batch a batch, where node should be added
+        \return whether node was added to batch
+     */
+    virtual bool batch(sad::SpriteBatch* batch);
     /*! Fills vector of regions with data, that could be used for identifying bounds of item.
         As default, no regions are produced.
         \param[out] r a vector of regions
      */
     virtual void regions(sad::Vector<sad::Rect2D> & r);
+    /*! Computes axis-aligned bounding box of node in coordinates of scene, used by scene
+        to cull nodes outside of camera's view. By default it's computed from regions, so
+        node without regions has no bounds and is never culled.
+        \param[out] r a bounding box, computed by sad::boundingBox
+        \return whether node has bounds
+     */
+    virtual bool boundingRect(sad::Rect2D & r);
     /*! Returns regions for a scene node
         \return region list
      */
@@ -114,6 +114,11 @@ public:
         \param[out] r a vector of regions
      */
     virtual void regions(sad::Vector<sad::Rect2D> & r);
+    /*! Computes bounding box of renderable area of sprite without allocating regions
+        \param[out] r a bounding box
+        \return true
+     */
+    virtual bool boundingRect(sad::Rect2D & r);
     /*! A basic schema for object
         \return a schema 
      */
@@ -125,6 +130,12 @@ public:
     /*! Renders a sprite as a simple quad 
      */
     virtual void render();
+    /*! Adds a sprite to batch, if sprite has texture. Note, that descendants of sprite
+        are not batched, since they could override rendering
+        \param[in] batch a batch, where sprite should be added
+        \return whether sprite was added to batch
+     */
+    virtual bool batch(sad::SpriteBatch* batch);
     /*! Called, when renderer for scene is changed
      */
     virtual void rendererChanged();
@@ -306,11 +317,14 @@ public:
         \param[in] load whether loading mode is enabled
      */
     void toggleLoadingMode(bool load);
-    /*! Loads sprite from picojson object
-        \param[in] v a picojson object
+    /*! Toggles loading mode on, before properties are loaded
+     */
+    virtual void beginLoading();
+    /*! Toggles loading mode off, when properties are loaded
+        \param[in] loaded whether properties were loaded successfully
         \return  whether it as successfull
      */
-    virtual bool load(const picojson::value& v);
+    virtual bool finishLoading(bool loaded);
     /*! Sets a tree name for object with specified renderer
         \param[in] r renderer, which tree should be fetched from
         \param[in] tree_name a name for an item for object
@@ -382,9 +396,6 @@ protected:
     /*! A used color of sprite
      */
     sad::AColor  m_color;
-    /*! A current color buffer, used when getting current color of scene
-     */ 
-    int  m_current_color_buffer[4];
     /*! Determines, whether we should change own size, if options size is changed
      */
     bool m_changesizeifoptionssizechanged;
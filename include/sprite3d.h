@@ -267,9 +267,6 @@ protected:
     /*! A used color of sprite
      */
     sad::AColor  m_color;
-    /*! A current color buffer, used when getting current color of scene
-     */ 
-    int  m_current_color_buffer[4];
 };
 
 }
@@ -0,0 +1,120 @@
+/*! \file spritebatch.h
+
+
+    Defines a batcher for sprites, which gathers textured quads with same texture into
+    one vertex stream and renders them with a single draw call
+ */
+#pragma once
+#include "sadrect.h"
+#include "sadcolor.h"
+#include "sadvector.h"
+
+namespace sad
+{
+class Texture;
+class Renderer;
+
+/*! \class SpriteBatch
+
+    A special part of renderer, which collects quads from sprites, while scene is
+    rendered and flushes all consequent quads with same texture as one draw call.
+    Order of rendering is preserved, because batch is flushed when texture is changed
+    or when non-batchable node should be rendered.
+ */
+class SpriteBatch
+{
+public:
+    /*! Constructs new enabled batch
+     */
+    SpriteBatch();
+    /*! Can be inherited
+     */
+    virtual ~SpriteBatch();
+    /*! Enables or disables batching. If disabled, all sprites are rendered via immediate path
+        \param[in] enabled whether batching is enabled
+     */
+    void setEnabled(bool enabled);
+    /*! Returns whether batching is enabled
+        \return whether batching is enabled
+     */
+    bool enabled() const;
+    /*! Sets renderer, whose backend receives draw calls
+        \param[in] renderer a renderer
+     */
+    void setRenderer(sad::Renderer* renderer);
+    /*! Returns renderer, whose backend receives draw calls
+        \return renderer
+     */
+    sad::Renderer* renderer() const;
+    /*! Adds new quad to batch, flushing a batch if texture differs from current
+        \param[in] tex a texture for quad (must not be NULL)
+        \param[in] area a renderable area of quad
+        \param[in] texture_coordinates a normalized texture coordinates for each point of area
+        \param[in] clr a color of quad
+     */
+    virtual void add(
+        sad::Texture* tex,
+        const sad::Rect2D& area,
+        const sad::Rect2D& texture_coordinates,
+        const sad::AColor& clr
+    );
+    /*! Renders all quads in current run with one draw call and clears a batch
+     */
+    virtual void flush();
+    /*! Starts new frame, storing counters of previous frame and resetting current counters
+     */
+    void startFrame();
+    /*! Returns amount of quads, pending in batch
+        \return amount of quads
+     */
+    unsigned int pendingQuads() const;
+    /*! Returns amount of quads, rendered via batch in current frame
+        \return amount of quads
+     */
+    unsigned int batchedQuads() const;
+    /*! Returns amount of draw calls, issued by batch in current frame
+        \return amount of draw calls
+     */
+    unsigned int drawCalls() const;
+    /*! Returns amount of draw calls, saved by batching in current frame
+        \return amount of saved draw calls
+     */
+    unsigned int savedDrawCalls() const;
+    /*! Returns amount of draw calls, saved by batching in previous frame
+        \return amount of saved draw calls
+     */
+    unsigned int lastFrameSavedDrawCalls() const;
+protected:
+    /*! Clears pending data
+     */
+    void clear();
+    /*! A renderer, whose backend receives draw calls
+     */
+    sad::Renderer* m_renderer;
+    /*! Whether batching is enabled
+     */
+    bool m_enabled;
+    /*! A texture of current run
+     */
+    sad::Texture* m_texture;
+    /*! Vertex coordinates of pending quads as pairs of x and y
+     */
+    sad::Vector<float> m_vertexes;
+    /*! Texture coordinates of pending quads as pairs of u and v
+     */
+    sad::Vector<float> m_texture_coordinates;
+    /*! Colors of pending quads as RGBA bytes for each vertex
+     */
+    sad::Vector<unsigned char> m_colors;
+    /*! Amount of quads, rendered via batch in current frame
+     */
+    unsigned int m_batched_quads;
+    /*! Amount of draw calls, issued by batch in current frame
+     */
+    unsigned int m_draw_calls;
+    /*! Amount of saved draw calls in previous frame
+     */
+    unsigned int m_last_frame_saved_draw_calls;
+};
+
+}
@@ -27,6 +27,16 @@ namespace sad
 {
 class Renderer;
 
+namespace imageformats
+{
+class MipChain;
+}
+
+namespace os
+{
+class MappedFileImpl;
+}
+
 /*! A main texture class, which stores all related data to a texture
     providing simple interface for working with it
  */
@@ -114,6 +124,31 @@ public:
      */
     size_t Offset;
 };
+/*! A buffer, which is pointing to file, mapped into memory, so pixels are read
+    from page cache without copying them. Used only if sad::Texture::MapFile is set,
+    since file stays mapped, while buffer exists
+ */
+class MappedFileBuffer: public Buffer
+{
+public:
+    /*! Constructs new empty buffer
+     */
+    MappedFileBuffer();
+    /*! Returns buffer contents for a texture
+        \return buffer
+     */ 
+    virtual sad::uchar* buffer() const;
+    /*! A destructor for buffer. Unmaps file
+     */ 
+    virtual ~MappedFileBuffer();
+
+    /*! A mapped file, owned by buffer
+     */
+    sad::os::MappedFileImpl* File;
+    /*! Offset of buffer start for texture
+     */
+    size_t Offset;
+};
 
 /*! A buffer which contains default image
  */
@@ -139,10 +174,18 @@ enum InternalFormat
     SFT_R5_G6_B5,    //!< A format, which has 5 bits for red component, 6 bits for green component, 5 bits for blue component
     SFT_R4_G4_B4_A4, //!< A format, which has 4 bits for each component 
     SFT_R3_G3_B2,    //!< A format, which has 3 bits for red component, 3 bits for green component, 2 bits for blue component
+    SFT_BC1,         //!< A block-compressed format (DXT1) with 1-bit alpha, taking 4 bits per pixel
+    SFT_BC3,         //!< A block-compressed format (DXT5) with separately stored alpha, taking 8 bits per pixel
 };
     /*! Whether we should build mip-maps, when uploading texture to GPU
      */
     bool BuildMipMaps;
+    /*! Whether pixel storage loaders should map file into memory instead of reading it.
+        Mapped file is kept for whole lifetime of texture, since texture could be uploaded
+        again after eviction, so file must not be changed while texture is loaded: on Linux
+        truncating it raises SIGBUS, on Windows it's locked. Disabled by default
+     */
+    bool MapFile;
     /*! A buffer, which should contain pixels, which will be uploaded to GPU
      */
     sad::Texture::Buffer* Buffer;   
@@ -239,6 +282,43 @@ enum InternalFormat
     /*! Unloads a texture from videocard memory
      */
     void unload();
+    /*! Returns estimated size of texture in videocard memory, including mip-maps
+        \return size in bytes
+     */
+    size_t gpuMemorySize() const;
+    /*! Sets a chain of mip-maps, which will be uploaded with texture, instead of generating
+        mip-maps on GPU. Chain is used only if it's complete for size of texture.
+        Texture takes ownership of chain
+        \param[in] chain a chain (NULL to remove chain)
+     */
+    void setMipChain(sad::imageformats::MipChain* chain);
+    /*! Returns a chain of mip-maps, which will be uploaded with texture
+        \return chain (NULL if not set)
+     */
+    inline sad::imageformats::MipChain* mipChain() const
+    {
+        return m_mip_chain;
+    }
+    /*! Builds chain of mip-maps for pixels of texture on CPU. Could be called from
+        any thread, since it does not access OpenGL
+        \param[in] kaiser whether Kaiser filter should be used instead of box filter
+        \return whether chain was built
+     */
+    bool buildMipChain(bool kaiser = false);
+    /*! Returns, whether pixels of texture are block-compressed
+        \return whether texture is compressed
+     */
+    bool isCompressed() const;
+    /*! Compresses 32-bit pixels of texture into blocks of specified format
+        \param[in] format a compressed format (sad::Texture::SFT_BC1 or sad::Texture::SFT_BC3)
+        \return whether texture was compressed
+     */
+    bool compress(sad::Texture::InternalFormat format);
+    /*! Decompresses block-compressed pixels of texture into 32-bit pixels. Used, when
+        compressed textures are not supported by driver
+        \return whether texture was decompressed
+     */
+    bool decompress();
     /*! Sets an alpha-channel value for a color
         \param[in] a alpha-channel value
      */
@@ -313,10 +393,50 @@ enum InternalFormat
         two sides, filling added pixels with zero bytes
      */
     void convertToPOTTexture();
+    /*! Places texture into a page of texture atlas. After that texture is uploaded and bound
+        via page and normalized coordinates of texture are remapped into page. Pixels of texture
+        must be already copied into page. Page is not owned by texture.
+        \param[in] page a page of atlas (NULL to remove texture from atlas)
+        \param[in] x horizontal offset of texture in page in pixels
+        \param[in] y vertical offset of texture in page in pixels
+     */
+    void placeInAtlas(sad::Texture* page, unsigned int x, unsigned int y);
+    /*! Returns a page of atlas, where texture is placed
+        \return page (NULL if texture is not placed in atlas)
+     */
+    inline sad::Texture* atlasPage() const
+    {
+        return m_atlas_page;
+    }
+    /*! Returns a texture, which is actually bound, when this texture is bound:
+        a page of atlas if texture is placed in atlas, otherwise texture itself
+        \return texture
+     */
+    inline sad::Texture* boundTexture()
+    {
+        return (m_atlas_page) ? m_atlas_page : this;
+    }
+    /*! Converts point in pixels of texture to a normalized coordinates of bound texture
+        \param[in] p point
+        \return normalized point
+     */
+    sad::Point2D normalizedPoint(const sad::Point2D& p) const;
 protected:
     /*! A renderer, which is held by a texture
      */
     sad::Renderer * m_renderer;
+    /*! A page of atlas, where texture is placed
+     */
+    sad::Texture* m_atlas_page;
+    /*! A horizontal offset of texture in page of atlas
+     */
+    unsigned int m_atlas_x;
+    /*! A vertical offset of texture in page of atlas
+     */
+    unsigned int m_atlas_y;
+    /*! A chain of mip-maps, prebuilt on CPU
+     */
+    sad::imageformats::MipChain* m_mip_chain;
 private:
     /*! Checks for errors in work of OpenGL and converts them into string
         \return string with error description (NULL if there wasn't any error)
@@ -26,6 +26,7 @@
 #include <p2d/bouncesolver.h>
 #include <p2d/simplecollisiondetector.h>
 #include <p2d/multisamplingcollisiondetector.h>
+#include <p2d/conservativeadvancementcollisiondetector.h>
 #include <p2d/broadcollisiondetector.h>
 #include <p2d/collisionevent.h>
 #include <p2d/walls.h>
@@ -599,12 +600,29 @@ static void exposeCollisionDetector(sad::dukpp03::Context* ctx)
 
         ctx->addClassBinding("sad::p2d::MultisamplingCollisionDetector", c);
     }
+    {
+        sad::dukpp03::ClassBinding* c = new sad::dukpp03::ClassBinding();
+        c->addObjectConstructor<sad::p2d::ConservativeAdvancementCollisionDetector>("SadP2DConservativeAdvancementCollisionDetector");
+        c->addObjectConstructor<sad::p2d::ConservativeAdvancementCollisionDetector, unsigned int>("SadP2DConservativeAdvancementCollisionDetector");
+        c->addObjectConstructor<sad::p2d::ConservativeAdvancementCollisionDetector, unsigned int, double>("SadP2DConservativeAdvancementCollisionDetector");
+        c->addMethod("setMaxIterations", sad::dukpp03::bind_method::from(&sad::p2d::ConservativeAdvancementCollisionDetector::setMaxIterations));
+        c->addMethod("maxIterations", sad::dukpp03::bind_method::from(&sad::p2d::ConservativeAdvancementCollisionDetector::maxIterations));
+        c->addMethod("setTolerance", sad::dukpp03::bind_method::from(&sad::p2d::ConservativeAdvancementCollisionDetector::setTolerance));
+        c->addMethod("tolerance", sad::dukpp03::bind_method::from(&sad::p2d::ConservativeAdvancementCollisionDetector::tolerance));
+
+        c->setPrototypeFunction("SadP2DConservativeAdvancementCollisionDetector");
+
+        c->addParentBinding(ctx->getClassBinding("sad::p2d::CollisionDetector"));
+
+        ctx->addClassBinding("sad::p2d::ConservativeAdvancementCollisionDetector", c);
+    }
 
 
     PERFORM_AND_ASSERT(
         "sad.p2d.SimpleCollisionDetector = SadP2DSimpleCollisionDetector;"
         "sad.p2d.BroadCollisionDetector = SadP2DBroadCollisionDetector;"
         "sad.p2d.MultisamplingCollisionDetector = SadP2DMultisamplingCollisionDetector;"
+        "sad.p2d.ConservativeAdvancementCollisionDetector = SadP2DConservativeAdvancementCollisionDetector;"
     );
 }
 
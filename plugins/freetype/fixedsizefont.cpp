@@ -2,6 +2,7 @@
 #include "towidechar.h"
 
 #include <sadmutex.h>
+#include <sadscopedlock.h>
 
 #include <3rdparty/format/format.h>
 
@@ -18,7 +19,7 @@ sad::freetype::FixedSizeFont::FixedSizeFont(
     FT_Face face, 
     unsigned int height
 )
-: m_on_gpu(false)
+: m_library(library), m_face(face), m_last_render_binds(0)
 {
     requestSize(library, face, height);
     m_height = static_cast<float>(height);
@@ -27,32 +28,18 @@ sad::freetype::FixedSizeFont::FixedSizeFont(
     m_builtin_linespacing = ppem * (static_cast<float>(linespacinginpt) / face->units_per_EM);
     m_bearing_y = ppem * (static_cast<float>(face->bbox.yMax) / face->units_per_EM);	
     
-    for(unsigned int i = 0; i < 256; i++)
-    {
-        m_glyphs[i] = new sad::freetype::Glyph(face, static_cast<unsigned char>(i));
-    }
-
     computeKerning(face);
 }
 
 
 sad::freetype::FixedSizeFont::~FixedSizeFont()
 {
-    for(unsigned int i = 0; i < 256; i++)
-    {
-        delete m_glyphs[i];
-    }
+
 }
 
 void sad::freetype::FixedSizeFont::uploadedTextures(sad::Vector<unsigned int> & textures)
 {
-    for(unsigned int i = 0; i < 256; i++)
-    {
-        if (m_glyphs[i]->Texture.IsOnGPU)
-        {
-            textures << m_glyphs[i]->Texture.Id;
-        }
-    }
+    m_atlas.uploadedTextures(textures);
 }
 
 float sad::freetype::FixedSizeFont::ascent() const
@@ -62,14 +49,23 @@ float sad::freetype::FixedSizeFont::ascent() const
 
 void sad::freetype::FixedSizeFont::markTexturesAsUnloaded()
 {
-    for(unsigned int i = 0; i < 256; i++)
-    {
-        m_glyphs[i]->Texture.IsOnGPU = false;
-    }
+    m_atlas.markTexturesAsUnloaded();
+}
+
+const sad::freetype::GlyphAtlas& sad::freetype::FixedSizeFont::atlas() const
+{
+    return m_atlas;
+}
+
+size_t sad::freetype::FixedSizeFont::cachedGlyphCount() const
+{
+    return m_glyphs.size();
+}
+
+unsigned int sad::freetype::FixedSizeFont::lastRenderBinds() const
+{
+    return m_last_render_binds;
 }
-// Why this even exists? It's not like were doing something horrible here
-// Also, we encounter bad Linux behaviour here
-// static sad::Mutex sad_freetype_font_lock;
 
 void sad::freetype::FixedSizeFont::render(
     const sad::String & s, 
@@ -78,23 +74,20 @@ void sad::freetype::FixedSizeFont::render(
     sad::Font::RenderFlags flags
 )
 {
-    // sad_freetype_font_lock.lock();
-
-    if (!m_on_gpu)
-    {
-        for(unsigned int i = 0; i < 256; i++)
-        {
-            m_glyphs[i]->Texture.upload();
-        }
-        m_on_gpu = true;
-    }
+    sad::ScopedLock lock(&m_lock);
 
     sad::String tmp = s;
     tmp.removeAllOccurences("\r");
     sad::StringList list = tmp.split("\n", sad::String::KEEP_EMPTY_PARTS);
 
+    for(size_t i = 0; i < m_quads.size(); i++)
+    {
+        m_quads[i].clear();
+    }
+    m_atlas.beginUse();
+
     bool previous = false;
-    unsigned char prevchar = 0;
+    unsigned int prevchar = 0;
     float xbegin = static_cast<float>(p.x());
     float curx = xbegin;
     float cury = static_cast<float>(p.y() - m_bearing_y);
@@ -105,25 +98,28 @@ void sad::freetype::FixedSizeFont::render(
         topoffset = 0;
     }
     
+    // Collect quads for all glyphs, grouping them by pages of atlas
     for(unsigned int i = 0; i < list.size(); i++)
     {
-        for(unsigned int j = 0; j < list[i].size(); j++)
+        size_t pos = 0;
+        while(pos < list[i].size())
         {
-            unsigned char curchar = list[i][j];
+            unsigned int curchar = sad::freetype::next_code_point(list[i], pos);
             if (previous)
             {
-                curx += m_kerning_table[prevchar][curchar];
+                curx += kerning(prevchar, curchar);
             }
 
-            sad::freetype::Glyph * g = m_glyphs[curchar];
+            sad::freetype::FixedSizeFont::CachedGlyph * g = glyph(curchar);
+            place(g);
             
-            g->render(curx, cury, topoffset);
+            appendQuad(g, curx, cury, topoffset);
             if ((flags & sad::Font::FRF_Bold) != 0)
             {
                 curx += 1.0;
-                g->render(curx, cury, topoffset);
+                appendQuad(g, curx, cury, topoffset);
                 curx += 1.0;
-                g->render(curx, cury, topoffset);
+                appendQuad(g, curx, cury, topoffset);
             }
 
             curx += g->AdvanceX;
@@ -135,7 +131,25 @@ void sad::freetype::FixedSizeFont::render(
         previous = false;
     }
 
-    // sad_freetype_font_lock.unlock();
+    // Render quads with one bind per page
+    m_last_render_binds = 0;
+    for(size_t page = 0; page < m_quads.size(); page++)
+    {
+        const sad::Vector<float>& quads = m_quads[page];
+        if (quads.size() == 0)
+        {
+            continue;
+        }
+        m_atlas.bind(page);
+        ++m_last_render_binds;
+        glBegin(GL_QUADS);
+        for(size_t j = 0; j < quads.size(); j += 4)
+        {
+            glTexCoord2f(quads[j], quads[j + 1]);
+            glVertex2f(quads[j + 2], quads[j + 3]);
+        }
+        glEnd();
+    }
 }
 
 sad::String sad::freetype::FixedSizeFont::dumpGlyphParameters() const
@@ -146,11 +160,23 @@ sad::String sad::freetype::FixedSizeFont::dumpGlyphParameters() const
         << FREETYPE_MINOR
         << FREETYPE_PATCH
     );
+    sad::freetype::FixedSizeFont* me = const_cast<sad::freetype::FixedSizeFont*>(this);
+    sad::ScopedLock lock(&(me->m_lock));
     for(int i = 0; i < 256; i++)
     {
+        const sad::freetype::FixedSizeFont::CachedGlyph* g = me->glyph(sad::freetype::to_wide_char(static_cast<unsigned char>(i)));
         result += sad::String::number(i);
         result += ":";
-        result += m_glyphs[i]->dumpParametes();
+        result += str(fmt::Format(
+            "Width: {0} "
+            "Height: {1} "
+            "Descender: {2} "
+            "BearingY: {3} "
+            "AdvanceX: {4}\n") 
+            << g->Width << g->Height
+            << g->Descender << g->BearingY
+            << g->AdvanceX
+        );
     }
     return result;
 }
@@ -162,13 +188,13 @@ sad::Texture * sad::freetype::FixedSizeFont::renderToTexture(
     unsigned int height
 )
 {
-    requestSize(library, face, height);
-
     sad::String tmp = string;
     tmp.removeAllOccurences("\r");
     tmp.removeAllOccurences("\n");
 
     sad::Size2D size = this->size(string, 1.0, sad::Font::FRF_None);
+    // Size is requested after computing size of string, since it could load glyphs of this font
+    requestSize(library, face, height);
 
     sad::Texture * texture = new sad::Texture();
     texture->width() = static_cast<unsigned int>(ceil(size.Width));
@@ -186,24 +212,33 @@ sad::Texture * sad::freetype::FixedSizeFont::renderToTexture(
         }
     }
 
-    sad::freetype::Glyph ** glyphs = new sad::freetype::Glyph*[tmp.size()];
+    // Decode code points same way, as size and render do, so glyphs match computed size
+    sad::Vector<unsigned int> code_points;
+    size_t pos = 0;
+    while(pos < tmp.size())
+    {
+        code_points << sad::freetype::next_code_point(tmp, pos);
+    }
+
+    sad::freetype::Glyph ** glyphs = new sad::freetype::Glyph*[code_points.size()];
     int y_max = -1; 
-    for(unsigned int i = 0; i < tmp.size(); i++)
+    for(unsigned int i = 0; i < code_points.size(); i++)
     {
-        glyphs[i] = new sad::freetype::Glyph(face, tmp[i]);
+        glyphs[i] = new sad::freetype::Glyph(face, code_points[i]);
         y_max = std::max(y_max, static_cast<int>(glyphs[i]->Height));
     }
     // Place glyphs
     bool previous = false;
-    unsigned char prevchar = 0;
+    unsigned int prevchar = 0;
     unsigned int curx = 0;
     
-    for(unsigned int i = 0; i < tmp.size(); i++)
+    for(unsigned int i = 0; i < code_points.size(); i++)
     {
-        unsigned char curchar = tmp[i];
+        unsigned int curchar = code_points[i];
         if (previous)
         {
-            curx += static_cast<unsigned int>(m_kerning_table[prevchar][curchar]);
+            sad::ScopedLock lock(&m_lock);
+            curx += static_cast<unsigned int>(kerning(prevchar, curchar));
         }
         previous = true;	
 
@@ -237,7 +272,7 @@ sad::Texture * sad::freetype::FixedSizeFont::renderToTexture(
         prevchar = curchar;
     }
 
-    for(unsigned int i = 0; i < tmp.size(); i++)
+    for(unsigned int i = 0; i < code_points.size(); i++)
     {
         delete glyphs[i];
     }
@@ -252,33 +287,38 @@ sad::Size2D sad::freetype::FixedSizeFont::size(
     sad::Font::RenderFlags flags
 )
 {
+    sad::ScopedLock lock(&m_lock);
+
     sad::String tmp = s;
     tmp.removeAllOccurences("\r");
     sad::StringList list = tmp.split("\n", sad::String::KEEP_EMPTY_PARTS);
 
     bool previous = false;
-    unsigned char prevchar = 0;
+    unsigned int prevchar = 0;
     float curx = 0;
     float maxx = 0;
     for(unsigned int i = 0; i < list.size(); i++)
     {
         curx = 0;
-        for(unsigned int j = 0; j < list[i].size(); j++)
+        size_t pos = 0;
+        size_t count = 0;
+        while(pos < list[i].size())
         {
-            unsigned char curchar = list[i][j];
+            unsigned int curchar = sad::freetype::next_code_point(list[i], pos);
             if (previous)
             {
-                curx += m_kerning_table[prevchar][curchar];
+                curx += kerning(prevchar, curchar);
             }
 
-            sad::freetype::Glyph * g = m_glyphs[curchar];
+            sad::freetype::FixedSizeFont::CachedGlyph * g = glyph(curchar);
             curx += g->AdvanceX;
             prevchar = curchar;
             previous = true;
+            ++count;
         }
         if ((flags & sad::Font::FRF_Bold) != 0)
         {
-            curx += list[i].size() * 2; // 2 is bold font size
+            curx += count * 2; // 2 is bold font size
         }
         if ((flags & sad::Font::FRF_Italic) != 0)
         {
@@ -331,12 +371,10 @@ void sad::freetype::FixedSizeFont::computeKerning(FT_Face face)
         FT_Vector kerning;
         for(unsigned int i = 0 ; i < 256; i++)
         {
-            wchar_t c1 = sad::freetype::to_wide_char(static_cast<unsigned int>(i));
-            unsigned int index1 = FT_Get_Char_Index(face, c1);
+            unsigned int index1 = FT_Get_Char_Index(face, i);
             for(unsigned int j = 0; j < 256; j++)
             {
-                wchar_t c2 = sad::freetype::to_wide_char(static_cast<unsigned int>(j));
-                unsigned int index2 = FT_Get_Char_Index(face, c2);
+                unsigned int index2 = FT_Get_Char_Index(face, j);
                 FT_Get_Kerning(face, index1, index2, FT_KERNING_DEFAULT, &kerning);
                 m_kerning_table[i][j] = static_cast<float>(kerning.x >> 6);
             }
@@ -347,3 +385,125 @@ void sad::freetype::FixedSizeFont::computeKerning(FT_Face face)
         std::fill_n(&(m_kerning_table[0][0]), 256 * 256, 0.0f);
     }
 }
+
+sad::freetype::FixedSizeFont::CachedGlyph* sad::freetype::FixedSizeFont::glyph(unsigned int code_point)
+{
+    if (m_glyphs.contains(code_point))
+    {
+        return m_glyphs[code_point];
+    }
+    sad::freetype::FixedSizeFont::CachedGlyph* g = new sad::freetype::FixedSizeFont::CachedGlyph();
+    g->Index = FT_Get_Char_Index(m_face, code_point);
+    g->Width = 0;
+    g->Height = 0;
+    g->BearingY = 0;
+    g->Descender = 0;
+    g->AdvanceX = 0;
+    g->HasBitmap = false;
+    g->Region.Page = static_cast<unsigned int>(-1);
+    g->Region.Generation = 0;
+    FT_BitmapGlyph bitmap_glyph = renderBitmap(g->Index);
+    if (bitmap_glyph)
+    {
+        FT_Bitmap & bitmap = bitmap_glyph->bitmap;
+        g->Width = static_cast<float>(bitmap.width);
+        g->Height = static_cast<float>(bitmap.rows);
+        g->Descender = static_cast<float>(static_cast<long>(bitmap_glyph->top) - static_cast<long>(bitmap.rows));
+        g->BearingY = g->Height + g->Descender;
+        g->AdvanceX = static_cast<float>(m_face->glyph->advance.x >> 6);
+        g->HasBitmap = bitmap.width != 0 && bitmap.rows != 0;
+        if (g->HasBitmap)
+        {
+            m_atlas.add(bitmap, g->Region);
+        }
+        FT_Done_Glyph(reinterpret_cast<FT_Glyph>(bitmap_glyph));
+    }
+    m_glyphs.insert(code_point, g);
+    return g;
+}
+
+void sad::freetype::FixedSizeFont::place(sad::freetype::FixedSizeFont::CachedGlyph* g)
+{
+    if (!g->HasBitmap || m_atlas.use(g->Region))
+    {
+        return;
+    }
+    // Glyph was evicted from atlas, so it's rendered again
+    FT_BitmapGlyph bitmap_glyph = renderBitmap(g->Index);
+    if (bitmap_glyph)
+    {
+        m_atlas.add(bitmap_glyph->bitmap, g->Region);
+        FT_Done_Glyph(reinterpret_cast<FT_Glyph>(bitmap_glyph));
+    }
+    else
+    {
+        g->HasBitmap = false;
+    }
+}
+
+FT_BitmapGlyph sad::freetype::FixedSizeFont::renderBitmap(unsigned int index)
+{
+    // Face is shared between all sizes, so size must be requested again
+    requestSize(m_library, m_face, static_cast<unsigned int>(m_height));
+    if (FT_Load_Glyph(m_face, index, FT_LOAD_DEFAULT))
+    {
+        return NULL;
+    }
+    FT_Glyph glyph = NULL;
+    if (FT_Get_Glyph(m_face->glyph, &glyph))
+    {
+        return NULL;
+    }
+    if (FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, 0, 1))
+    {
+        FT_Done_Glyph(glyph);
+        return NULL;
+    }
+    return reinterpret_cast<FT_BitmapGlyph>(glyph);
+}
+
+float sad::freetype::FixedSizeFont::kerning(unsigned int previous, unsigned int current)
+{
+    if (previous < 256 && current < 256)
+    {
+        return m_kerning_table[previous][current];
+    }
+    if (!FT_HAS_KERNING(m_face))
+    {
+        return 0;
+    }
+    unsigned long long key = (static_cast<unsigned long long>(previous) << 32) | current;
+    if (m_kerning_cache.contains(key))
+    {
+        return m_kerning_cache[key];
+    }
+    requestSize(m_library, m_face, static_cast<unsigned int>(m_height));
+    FT_Vector kerning;
+    FT_Get_Kerning(m_face, FT_Get_Char_Index(m_face, previous), FT_Get_Char_Index(m_face, current), FT_KERNING_DEFAULT, &kerning);
+    float result = static_cast<float>(kerning.x >> 6);
+    m_kerning_cache.insert(key, result);
+    return result;
+}
+
+void sad::freetype::FixedSizeFont::appendQuad(
+    const sad::freetype::FixedSizeFont::CachedGlyph* g,
+    float x,
+    float y,
+    float topoffset
+)
+{
+    if (!g->HasBitmap)
+    {
+        return;
+    }
+    const sad::freetype::GlyphAtlas::Region& r = g->Region;
+    while (m_quads.size() <= r.Page)
+    {
+        m_quads << sad::Vector<float>();
+    }
+    sad::Vector<float>& quads = m_quads[r.Page];
+    quads << r.U0 << r.V0 << x + topoffset << y + g->BearingY;
+    quads << r.U0 << r.V1 << x << y + g->Descender;
+    quads << r.U1 << r.V1 << x + g->Width << y + g->Descender;
+    quads << r.U1 << r.V0 << x + g->Width + topoffset << y + g->BearingY;
+}
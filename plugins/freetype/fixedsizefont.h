@@ -6,11 +6,14 @@
  */
 #pragma once
 #include "glyph.h"
+#include "glyphatlas.h"
 #include <font.h>
 #include <sadstring.h>
 #include <sadsize.h>
 #include <sadpoint.h>
 #include <sadvector.h>
+#include <sadptrhash.h>
+#include <sadmutex.h>
 
 #include <texture.h>
 
@@ -20,9 +23,41 @@ namespace sad
 namespace freetype
 {
 
+/*! A font with fixed size. Glyphs are loaded lazily by code point and packed into shared
+    textures of glyph atlas, so string is rendered with one texture bind per page of atlas
+ */
 class FixedSizeFont
 {
 public:
+    /*! A glyph, cached by font
+     */
+    struct CachedGlyph
+    {
+        /*! A freetype index of glyph
+         */
+        unsigned int Index;
+        /*! Bitmap width
+         */
+        float Width;
+        /*! Bitmap height
+         */
+        float Height;
+        /*! A vertical bearing  as distance from baseline to top point of glyph
+         */
+        float BearingY;
+        /*! A vertical distance from baseline to bottom point of glyph
+         */
+        float Descender;
+        /*! How long should pen move, after glyph was rendered
+         */
+        float AdvanceX;
+        /*! Whether glyph has bitmap, which should be placed in atlas
+         */
+        bool HasBitmap;
+        /*! A region of glyph in atlas
+         */
+        sad::freetype::GlyphAtlas::Region Region;
+    };
     /*! Creates new font height
         \param[in] library a library
         \param[in] face a font face, used for rendering
@@ -80,6 +115,18 @@ public:
     /*! Marks textures as unloaded
      */
     void markTexturesAsUnloaded();
+    /*! Returns atlas of glyphs
+        \return atlas
+     */
+    const sad::freetype::GlyphAtlas& atlas() const;
+    /*! Returns amount of cached glyphs
+        \return amount of glyphs
+     */
+    size_t cachedGlyphCount() const;
+    /*! Returns amount of texture binds, made on last rendering
+        \return amount of binds
+     */
+    unsigned int lastRenderBinds() const;
 protected:
     /*! A builtin  linespacing
      */
@@ -87,19 +134,65 @@ protected:
     /*! A bearing y for rendering all fonts
      */
     float m_bearing_y;
-    /*! Whether font glyph textures is uploaded to GPU
+    /*! A freetype library
      */
-    bool m_on_gpu;
+    FT_Library m_library;
+    /*! A face, which glyphs are loaded from
+     */
+    FT_Face m_face;
     /*! A height for font
      */
     float m_height; 
-    /*! A glyphs table
+    /*! A cached glyphs by code points
+     */
+    sad::PtrHash<unsigned int, sad::freetype::FixedSizeFont::CachedGlyph> m_glyphs;
+    /*! An atlas, where bitmaps of glyphs are stored
      */
-    sad::freetype::Glyph * m_glyphs[256];
-    /*! A table of kerning, where row is previous char 
+    sad::freetype::GlyphAtlas m_atlas;
+    /*! A table of kerning for first 256 code points, where row is previous code point
         and column is current
      */
     float m_kerning_table[256][256];
+    /*! A cached kerning for other code points, where key contains previous code point
+        in high part and current in low part
+     */
+    sad::Hash<unsigned long long, float> m_kerning_cache;
+    /*! A vertices of quads, grouped by pages of atlas. Kept to avoid reallocations
+     */
+    sad::Vector<sad::Vector<float> > m_quads;
+    /*! An amount of texture binds on last rendering
+     */
+    unsigned int m_last_render_binds;
+    /*! A lock for cache of glyphs, since size could be computed outside of rendering thread
+     */
+    sad::Mutex m_lock;
+    /*! Returns cached glyph for code point, loading it if needed
+        \param[in] code_point a code point
+        \return glyph
+     */
+    sad::freetype::FixedSizeFont::CachedGlyph* glyph(unsigned int code_point);
+    /*! Places bitmap of glyph into atlas, if it's not placed or was evicted
+        \param[in] g glyph
+     */
+    void place(sad::freetype::FixedSizeFont::CachedGlyph* g);
+    /*! Renders glyph bitmap with freetype
+        \param[in] index an index of glyph
+        \return glyph, converted to bitmap or NULL on failure. Must be freed with FT_Done_Glyph
+     */
+    FT_BitmapGlyph renderBitmap(unsigned int index);
+    /*! Returns kerning between two code points
+        \param[in] previous previous code point
+        \param[in] current current code point
+        \return kerning
+     */
+    float kerning(unsigned int previous, unsigned int current);
+    /*! Appends quad of glyph to list of quads for it's page
+        \param[in] g glyph
+        \param[in] x X coordinate of baseline position
+        \param[in] y Y coordinate of baseline position
+        \param[in] topoffset a top offset for italic font
+     */
+    void appendQuad(const sad::freetype::FixedSizeFont::CachedGlyph* g, float x, float y, float topoffset);
     /*! Sets bounding box size to specified height
         \param[in] library a library
         \param[in] face a face
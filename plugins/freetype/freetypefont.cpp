@@ -44,7 +44,6 @@ void sad::freetype::Font::render(const sad::String & str,const sad::Point2D & p,
 
     this->setCurrentColor();
     m_dptr->render(str, p, m_linespacing_ratio, flags);
-    this->restoreColor();
 }
 
 
@@ -1,5 +1,4 @@
 #include "glyph.h"
-#include "towidechar.h"
 
 #include "3rdparty/format/format.h"
 
@@ -16,9 +15,9 @@ YMax(0), YMin(0)
 
 }
 
-sad::freetype::Glyph::Glyph(FT_Face face, unsigned char c)
+sad::freetype::Glyph::Glyph(FT_Face face, unsigned int code_point)
 {
-    sad::Maybe<FT_Glyph> result = sad::freetype::Glyph::glyph(face, c, Index);
+    sad::Maybe<FT_Glyph> result = sad::freetype::Glyph::glyph(face, code_point, Index);
     if (result.exists())
     {
         makeGlyph(face, result.value());
@@ -51,10 +50,9 @@ void sad::freetype::Glyph::render(float x, float y, float topoffset)
 }
 
 
-sad::Maybe<FT_Glyph> sad::freetype::Glyph::glyph(FT_Face face, unsigned char c, unsigned int & index)
+sad::Maybe<FT_Glyph> sad::freetype::Glyph::glyph(FT_Face face, unsigned int code_point, unsigned int & index)
 {
-    wchar_t widecharacter = sad::freetype::to_wide_char(c);
-    index = FT_Get_Char_Index( face, widecharacter );
+    index = FT_Get_Char_Index( face, code_point );
     
     sad::Maybe<FT_Glyph> result;
 
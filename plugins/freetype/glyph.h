@@ -64,9 +64,9 @@ public:
 
     /*! Creates a new glyph for specified character, building a texture for it
         \param[in] face a face
-        \param[in] c a character, which is stored in glyph
+        \param[in] code_point a code point of character, which is stored in glyph
      */
-    Glyph(FT_Face face, unsigned char c);
+    Glyph(FT_Face face, unsigned int code_point);
     
     /*! Renders a glyph at specified baseline position. Note, that this
         is BASELINE position. 
@@ -75,13 +75,13 @@ public:
         \param[in] topoffset a top offset for italic font
      */
     void render(float x, float y, float topoffset);
-    /*! Tries to get a glyph for a face and char c
+    /*! Tries to get a glyph for a face and character
         \param[in] face face to be used
-        \param[in] c character
+        \param[in] code_point a code point of character
         \param[out] index index of character in list
         \return glyph value
      */
-    static sad::Maybe<FT_Glyph> glyph(FT_Face face, unsigned char c, unsigned int & index);
+    static sad::Maybe<FT_Glyph> glyph(FT_Face face, unsigned int code_point, unsigned int & index);
     /*! Dumps parameters to string
         \return parameters
      */
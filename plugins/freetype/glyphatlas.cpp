@@ -0,0 +1,294 @@
+#include "glyphatlas.h"
+#include "nextpoweroftwo.h"
+
+#include <algorithm>
+
+/*! A padding between glyphs in page, so linear filtering won't bleed neighbours
+ */
+#define GLYPH_ATLAS_PADDING 1
+
+sad::freetype::GlyphAtlas::GlyphAtlas(unsigned int page_size, unsigned int max_pages)
+: m_page_size(page_size), m_max_pages(std::max(max_pages, 1u)), m_use(0), m_evictions(0)
+{
+
+}
+
+sad::freetype::GlyphAtlas::~GlyphAtlas()
+{
+    for(size_t i = 0; i < m_pages.size(); i++)
+    {
+        delete m_pages[i];
+    }
+}
+
+void sad::freetype::GlyphAtlas::beginUse()
+{
+    ++m_use;
+}
+
+void sad::freetype::GlyphAtlas::add(const FT_Bitmap & bitmap, sad::freetype::GlyphAtlas::Region & region)
+{
+    unsigned int width = static_cast<unsigned int>(bitmap.width) + GLYPH_ATLAS_PADDING;
+    unsigned int height = static_cast<unsigned int>(bitmap.rows) + GLYPH_ATLAS_PADDING;
+    unsigned int x = 0, y = 0;
+    unsigned int page = 0;
+    bool found = false;
+    // Try pages, starting from most recently created, since older ones are usually full
+    for(size_t i = m_pages.size(); i > 0 && !found; i--)
+    {
+        if (reserve(i - 1, width, height, x, y))
+        {
+            page = i - 1;
+            found = true;
+        }
+    }
+    if (!found)
+    {
+        unsigned int pagewidth = std::max(m_page_size, sad::freetype::next_power_of_two(width));
+        unsigned int pageheight = std::max(m_page_size, sad::freetype::next_power_of_two(height));
+        // Look for least recently used page, which is not used now
+        bool canevict = false;
+        if (m_pages.size() >= m_max_pages)
+        {
+            for(size_t i = 0; i < m_pages.size(); i++)
+            {
+                if (m_pages[i]->LastUse != m_use && (!canevict || m_pages[i]->LastUse < m_pages[page]->LastUse))
+                {
+                    page = i;
+                    canevict = true;
+                }
+            }
+        }
+        if (canevict)
+        {
+            evict(page);
+            sad::freetype::GlyphAtlas::Page* p = m_pages[page];
+            if (p->Width < pagewidth || p->Height < pageheight)
+            {
+                // Oversized glyph could not fit into evicted page, so it's reallocated
+                p->Width = std::max(p->Width, pagewidth);
+                p->Height = std::max(p->Height, pageheight);
+                p->Pixels.clear();
+                p->Pixels.resize(2 * p->Width * p->Height, 0);
+                p->DirtyFrom = 0;
+                p->DirtyTo = p->Height;
+                // Old texture is smaller than page, so it's released and page is uploaded again
+                if (p->IsOnGPU)
+                {
+                    m_released_textures << p->Id;
+                    p->IsOnGPU = false;
+                    p->Id = 0;
+                }
+            }
+        }
+        else
+        {
+            // If all pages are used by current string, atlas grows over it's limit
+            page = makePage(pagewidth, pageheight);
+        }
+        reserve(page, width, height, x, y);
+    }
+
+    sad::freetype::GlyphAtlas::Page* p = m_pages[page];
+    const unsigned char* buffer = bitmap.buffer;
+    for(unsigned int row = 0; row < static_cast<unsigned int>(bitmap.rows); row++)
+    {
+        const unsigned char* source = buffer + row * bitmap.pitch;
+        unsigned char* destination = &(p->Pixels[2 * ((y + row) * p->Width + x)]);
+        for(unsigned int col = 0; col < static_cast<unsigned int>(bitmap.width); col++)
+        {
+            destination[2 * col] = source[col];
+            destination[2 * col + 1] = source[col];
+        }
+    }
+    p->DirtyFrom = std::min(p->DirtyFrom, y);
+    p->DirtyTo = std::max(p->DirtyTo, y + height);
+    p->LastUse = m_use;
+
+    region.Page = page;
+    region.Generation = p->Generation;
+    region.U0 = static_cast<float>(x) / p->Width;
+    region.V0 = static_cast<float>(y) / p->Height;
+    region.U1 = static_cast<float>(x + bitmap.width) / p->Width;
+    region.V1 = static_cast<float>(y + bitmap.rows) / p->Height;
+}
+
+bool sad::freetype::GlyphAtlas::use(const sad::freetype::GlyphAtlas::Region & region)
+{
+    if (region.Page >= m_pages.size())
+    {
+        return false;
+    }
+    sad::freetype::GlyphAtlas::Page* p = m_pages[region.Page];
+    if (p->Generation != region.Generation)
+    {
+        return false;
+    }
+    p->LastUse = m_use;
+    return true;
+}
+
+void sad::freetype::GlyphAtlas::bind(unsigned int page)
+{
+    if (m_released_textures.size())
+    {
+        glDeleteTextures(m_released_textures.size(), &(m_released_textures[0]));
+        m_released_textures.clear();
+    }
+    sad::freetype::GlyphAtlas::Page* p = m_pages[page];
+    if (!p->IsOnGPU)
+    {
+        p->IsOnGPU = true;
+        glGenTextures(1, &(p->Id));
+        glBindTexture(GL_TEXTURE_2D, p->Id);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexImage2D(
+            GL_TEXTURE_2D,
+            0,
+            GL_RGBA2,
+            p->Width,
+            p->Height,
+            0,
+            GL_LUMINANCE_ALPHA,
+            GL_UNSIGNED_BYTE,
+            &(p->Pixels[0])
+        );
+        p->DirtyFrom = p->Height;
+        p->DirtyTo = 0;
+        return;
+    }
+    glBindTexture(GL_TEXTURE_2D, p->Id);
+    if (p->DirtyFrom < p->DirtyTo)
+    {
+        // Only changed rows are uploaded
+        unsigned int to = std::min(p->DirtyTo, p->Height);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(
+            GL_TEXTURE_2D,
+            0,
+            0,
+            p->DirtyFrom,
+            p->Width,
+            to - p->DirtyFrom,
+            GL_LUMINANCE_ALPHA,
+            GL_UNSIGNED_BYTE,
+            &(p->Pixels[2 * p->DirtyFrom * p->Width])
+        );
+        p->DirtyFrom = p->Height;
+        p->DirtyTo = 0;
+    }
+}
+
+unsigned int sad::freetype::GlyphAtlas::pageCount() const
+{
+    return m_pages.size();
+}
+
+unsigned int sad::freetype::GlyphAtlas::evictionCount() const
+{
+    return m_evictions;
+}
+
+void sad::freetype::GlyphAtlas::uploadedTextures(sad::Vector<unsigned int> & textures) const
+{
+    for(size_t i = 0; i < m_pages.size(); i++)
+    {
+        if (m_pages[i]->IsOnGPU)
+        {
+            textures << m_pages[i]->Id;
+        }
+    }
+    textures << m_released_textures;
+}
+
+void sad::freetype::GlyphAtlas::markTexturesAsUnloaded()
+{
+    for(size_t i = 0; i < m_pages.size(); i++)
+    {
+        m_pages[i]->IsOnGPU = false;
+    }
+    m_released_textures.clear();
+}
+
+unsigned int sad::freetype::GlyphAtlas::makePage(unsigned int width, unsigned int height)
+{
+    sad::freetype::GlyphAtlas::Page* p = new sad::freetype::GlyphAtlas::Page();
+    p->Width = width;
+    p->Height = height;
+    p->Pixels.resize(2 * width * height, 0);
+    p->NextY = 0;
+    p->Generation = 0;
+    p->LastUse = m_use;
+    p->IsOnGPU = false;
+    p->Id = 0;
+    p->DirtyFrom = 0;
+    p->DirtyTo = height;
+    m_pages << p;
+    return m_pages.size() - 1;
+}
+
+void sad::freetype::GlyphAtlas::evict(unsigned int page)
+{
+    sad::freetype::GlyphAtlas::Page* p = m_pages[page];
+    p->Shelves.clear();
+    p->NextY = 0;
+    ++(p->Generation);
+    std::fill(p->Pixels.begin(), p->Pixels.end(), 0);
+    p->DirtyFrom = 0;
+    p->DirtyTo = p->Height;
+    ++m_evictions;
+}
+
+bool sad::freetype::GlyphAtlas::reserve(
+    unsigned int page,
+    unsigned int width,
+    unsigned int height,
+    unsigned int & x,
+    unsigned int & y
+)
+{
+    sad::freetype::GlyphAtlas::Page* p = m_pages[page];
+    if (width > p->Width)
+    {
+        return false;
+    }
+    // Pick a shelf, which wastes least of height
+    int best = -1;
+    for(size_t i = 0; i < p->Shelves.size(); i++)
+    {
+        const sad::freetype::GlyphAtlas::Shelf& shelf = p->Shelves[i];
+        if (shelf.Height >= height && shelf.X + width <= p->Width)
+        {
+            if (best == -1 || shelf.Height < p->Shelves[best].Height)
+            {
+                best = static_cast<int>(i);
+            }
+        }
+    }
+    // Don't waste a tall shelf on a short glyph, if there is place for a new one
+    if (best != -1 && p->Shelves[best].Height > height * 2 && p->NextY + height <= p->Height)
+    {
+        best = -1;
+    }
+    if (best == -1)
+    {
+        if (p->NextY + height > p->Height)
+        {
+            return false;
+        }
+        sad::freetype::GlyphAtlas::Shelf shelf;
+        shelf.Y = p->NextY;
+        shelf.Height = height;
+        shelf.X = 0;
+        p->Shelves << shelf;
+        p->NextY += height;
+        best = static_cast<int>(p->Shelves.size() - 1);
+    }
+    sad::freetype::GlyphAtlas::Shelf& shelf = p->Shelves[best];
+    x = shelf.X;
+    y = shelf.Y;
+    shelf.X += width;
+    return true;
+}
@@ -0,0 +1,175 @@
+/*! \file glyphatlas.h
+
+
+    Describes an atlas of glyphs, which packs bitmaps of glyphs into few shared textures,
+    so rendering of a string needs only one texture bind per texture
+ */
+#pragma once
+#include "texture.h"
+
+#include <sadvector.h>
+
+namespace sad
+{
+
+namespace freetype
+{
+
+class GlyphAtlas
+{
+public:
+    /*! A region of glyph in atlas
+     */
+    struct Region
+    {
+        /*! An index of page, where glyph is placed
+         */
+        unsigned int Page;
+        /*! A generation of page, when glyph was placed. If page was evicted, generation
+            of page is changed and region becomes invalid
+         */
+        unsigned int Generation;
+        /*! A left texture coordinate
+         */
+        float U0;
+        /*! A top texture coordinate
+         */
+        float V0;
+        /*! A right texture coordinate
+         */
+        float U1;
+        /*! A bottom texture coordinate
+         */
+        float V1;
+    };
+    /*! Creates new empty atlas
+        \param[in] page_size a width and height of pages of atlas
+        \param[in] max_pages a maximal amount of pages. When all of them are full, least recently used
+                   page is evicted
+     */
+    GlyphAtlas(unsigned int page_size = 512, unsigned int max_pages = 4);
+    /*! Frees all pages. Textures must be unloaded from GPU before
+     */
+    ~GlyphAtlas();
+    /*! Starts new usage of atlas, like rendering of string. Pages, used in current usage, are never evicted
+     */
+    void beginUse();
+    /*! Places bitmap into atlas, evicting least recently used page, if atlas is full
+        \param[in] bitmap a bitmap
+        \param[out] region a region of placed bitmap
+     */
+    void add(const FT_Bitmap & bitmap, sad::freetype::GlyphAtlas::Region & region);
+    /*! Tests, whether region is still valid, marking it's page as used in current usage
+        \param[in] region a region
+        \return whether region is valid
+     */
+    bool use(const sad::freetype::GlyphAtlas::Region & region);
+    /*! Uploads pending changes of page to GPU and binds it's texture
+        \param[in] page an index of page
+     */
+    void bind(unsigned int page);
+    /*! Returns amount of pages in atlas
+        \return amount of pages
+     */
+    unsigned int pageCount() const;
+    /*! Returns amount of evictions of pages
+        \return amount of evictions
+     */
+    unsigned int evictionCount() const;
+    /*! Appends textures of pages, uploaded to GPU, and textures of reallocated pages, which are not freed yet
+        \param[out] textures a list of textures
+     */
+    void uploadedTextures(sad::Vector<unsigned int> & textures) const;
+    /*! Marks textures of pages as unloaded, so they will be uploaded again on next binding
+     */
+    void markTexturesAsUnloaded();
+private:
+    /*! A shelf of glyphs in page: a row, where glyphs are placed from left to right
+     */
+    struct Shelf
+    {
+        unsigned int Y;      //!< A top position of shelf
+        unsigned int Height; //!< A height of shelf
+        unsigned int X;      //!< A first free position on shelf
+    };
+    /*! A page of atlas, stored as luminance-alpha pixels
+     */
+    struct Page
+    {
+        /*! A pixels of page, kept to upload it again after unloading
+         */
+        std::vector<unsigned char> Pixels;
+        /*! A width of page
+         */
+        unsigned int Width;
+        /*! A height of page
+         */
+        unsigned int Height;
+        /*! A shelves of page
+         */
+        sad::Vector<sad::freetype::GlyphAtlas::Shelf> Shelves;
+        /*! A top of free space below shelves
+         */
+        unsigned int NextY;
+        /*! A generation of page, changed on eviction
+         */
+        unsigned int Generation;
+        /*! A last usage of page
+         */
+        unsigned int LastUse;
+        /*! Whether page is uploaded to GPU
+         */
+        bool IsOnGPU;
+        /*! An id of texture on GPU
+         */
+        unsigned int Id;
+        /*! A first row, changed since last upload
+         */
+        unsigned int DirtyFrom;
+        /*! A row after last row, changed since last upload
+         */
+        unsigned int DirtyTo;
+    };
+    /*! Creates new page with specified size
+        \param[in] width a width
+        \param[in] height a height
+        \return index of page
+     */
+    unsigned int makePage(unsigned int width, unsigned int height);
+    /*! Clears page, making all regions in it invalid
+        \param[in] page an index of page
+     */
+    void evict(unsigned int page);
+    /*! Tries to reserve space in page
+        \param[in] page an index of page
+        \param[in] width a width of space
+        \param[in] height a height of space
+        \param[out] x a left position of space
+        \param[out] y a top position of space
+        \return whether space is reserved
+     */
+    bool reserve(unsigned int page, unsigned int width, unsigned int height, unsigned int & x, unsigned int & y);
+    /*! A pages of atlas
+     */
+    sad::Vector<sad::freetype::GlyphAtlas::Page*> m_pages;
+    /*! A size of page
+     */
+    unsigned int m_page_size;
+    /*! A maximal amount of pages
+     */
+    unsigned int m_max_pages;
+    /*! A counter of usages
+     */
+    unsigned int m_use;
+    /*! An amount of evictions
+     */
+    unsigned int m_evictions;
+    /*! Textures of pages, which were reallocated with larger size. Glyphs could be added outside
+        of rendering thread, so they are deleted on next binding
+     */
+    sad::Vector<unsigned int> m_released_textures;
+};
+
+}
+
+}
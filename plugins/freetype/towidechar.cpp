@@ -29,3 +29,48 @@ wchar_t sad::freetype::to_wide_char(unsigned char c)
     }
     return result;
 }
+
+unsigned int sad::freetype::next_code_point(const sad::String & s, size_t & pos)
+{
+    unsigned char c = static_cast<unsigned char>(s[pos]);
+    size_t length = 0;
+    unsigned int result = 0;
+    if (c >= 0xC2 && c <= 0xDF)
+    {
+        length = 2;
+        result = c & 0x1F;
+    }
+    if (c >= 0xE0 && c <= 0xEF)
+    {
+        length = 3;
+        result = c & 0x0F;
+    }
+    if (c >= 0xF0 && c <= 0xF4)
+    {
+        length = 4;
+        result = c & 0x07;
+    }
+    if (length != 0 && pos + length <= s.size())
+    {
+        bool valid = true;
+        for(size_t i = 1; i < length && valid; i++)
+        {
+            unsigned char next = static_cast<unsigned char>(s[pos + i]);
+            valid = (next & 0xC0) == 0x80;
+            result = (result << 6) | (next & 0x3F);
+        }
+        // Reject overlong sequences, surrogates and values out of Unicode
+        if (valid && ((length == 3 && result < 0x800) || (result >= 0xD800 && result <= 0xDFFF)
+                      || (length == 4 && (result < 0x10000 || result > 0x10FFFF))))
+        {
+            valid = false;
+        }
+        if (valid)
+        {
+            pos += length;
+            return result;
+        }
+    }
+    ++pos;
+    return static_cast<unsigned int>(sad::freetype::to_wide_char(c));
+}
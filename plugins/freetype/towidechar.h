@@ -5,6 +5,7 @@
     responds to russian letters
  */
 #pragma once
+#include <sadstring.h>
 
 namespace sad
 {
@@ -18,6 +19,14 @@ namespace freetype
     \return wide character
  */
 wchar_t to_wide_char(unsigned char c);
+/*! Decodes next code point from string, advancing position. Valid UTF-8 sequences
+    are decoded as is, other bytes are converted with to_wide_char, so strings
+    in single-byte encodings are still rendered properly
+    \param[in] s string
+    \param[in, out] pos a position in string, which will be moved to next code point
+    \return code point
+ */
+unsigned int next_code_point(const sad::String & s, size_t & pos);
 
 }
 
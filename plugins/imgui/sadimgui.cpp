@@ -14,6 +14,7 @@
 #endif
 
 #include <renderer.h>
+#include <opengl.h>
 #include <log/consoletarget.h>
 #include <window.h>
 #include <os/windowhandles.h>
@@ -280,6 +281,8 @@ void render_draw_lists(ImDrawData* draw_data)
     glPolygonMode(GL_FRONT, last_polygon_mode[0]); glPolygonMode(GL_BACK, last_polygon_mode[1]);
     glViewport(last_viewport[0], last_viewport[1], (GLsizei)last_viewport[2], (GLsizei)last_viewport[3]);
     glScissor(last_scissor_box[0], last_scissor_box[1], (GLsizei)last_scissor_box[2], (GLsizei)last_scissor_box[3]);
+    // Current color is undefined after drawing with color array, so cached state is no longer valid
+    sad::Renderer::ref()->opengl()->stateCache()->invalidate();
 }
 /*! A local storage string for storing callback for objects
  */
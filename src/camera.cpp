@@ -1,6 +1,10 @@
 #include <camera.h>
 #include <scene.h>
 #include <renderer.h>
+#include <geometry2d.h>
+#include <fuzzyequal.h>
+
+#include <rendering/backend.h>
 
 #ifdef WIN32
 // ReSharper disable once CppUnusedIncludeDirective
@@ -14,7 +18,8 @@
 DECLARE_SOBJ(sad::Camera)
 
 sad::Camera::Camera() 
-: TranslationOffset(0,0,0), Angle(0), TemporaryRotationOffset(0, 0, 0), RotationVectorDirection(0, 0, 0), Scene(NULL)
+: m_matrices_computed(false), m_cached_angle(0),
+TranslationOffset(0,0,0), Angle(0), TemporaryRotationOffset(0, 0, 0), RotationVectorDirection(0, 0, 0), Scene(NULL)
 {
 
 }
@@ -23,44 +28,134 @@ void sad::Camera::apply()
 {
     sad::Vector3D vector3 = TranslationOffset;  
     sad::Scene* scene = Scene;
+    sad::Renderer* renderer = NULL;
     if (scene)
     {
-        sad::Renderer* renderer  = Scene->renderer();
+        renderer  = Scene->renderer();
         if (renderer)
         {
             vector3 += renderer->globalTranslationOffset();
         }
     }
-    glPushMatrix();
-    glTranslatef(
-        static_cast<GLfloat>(vector3.x()),
-        static_cast<GLfloat>(vector3.y()),
-        static_cast<GLfloat>(vector3.z())
-    );
-    glTranslatef(
-        static_cast<GLfloat>(TemporaryRotationOffset.x()),
-        static_cast<GLfloat>(TemporaryRotationOffset.y()),
-        static_cast<GLfloat>(TemporaryRotationOffset.z())
+    sad::rendering::Backend* backend = sad::rendering::backend(renderer);
+    backend->pushMatrix();
+    backend->translate(vector3.x(), vector3.y(), vector3.z());
+    backend->translate(
+        TemporaryRotationOffset.x(),
+        TemporaryRotationOffset.y(),
+        TemporaryRotationOffset.z()
     );
-    glRotatef(
-        static_cast<GLfloat>(Angle),
-        static_cast<GLfloat>(RotationVectorDirection.x()),
-        static_cast<GLfloat>(RotationVectorDirection.y()),
-        static_cast<GLfloat>(RotationVectorDirection.z())
+    backend->rotate(
+        Angle,
+        RotationVectorDirection.x(),
+        RotationVectorDirection.y(),
+        RotationVectorDirection.z()
     );
-    glTranslatef(
-        static_cast<GLfloat>(-(TemporaryRotationOffset.x())),
-        static_cast<GLfloat>(-(TemporaryRotationOffset.y())),
-        static_cast<GLfloat>(-(TemporaryRotationOffset.z()))
+    backend->translate(
+        -(TemporaryRotationOffset.x()),
+        -(TemporaryRotationOffset.y()),
+        -(TemporaryRotationOffset.z())
     );
 }
 
 void sad::Camera::restore()
 {
-    glPopMatrix();	
+    sad::Renderer* renderer = (Scene) ? Scene->renderer() : NULL;
+    sad::rendering::backend(renderer)->popMatrix();
+}
+
+bool sad::Camera::viewRect(sad::Rect2D &) const
+{
+    return false;
+}
+
+const sad::Matrix4x4<double>& sad::Camera::matrix() const
+{
+    this->updateMatrices();
+    return m_matrix;
+}
+
+const sad::Matrix4x4<double>& sad::Camera::inverseMatrix() const
+{
+    this->updateMatrices();
+    return m_inverse_matrix;
+}
+
+bool sad::Camera::viewRectForViewport(double width, double height, sad::Rect2D & r) const
+{
+    // Only rotation around axis, orthogonal to screen, keeps view rectangular
+    if (sad::is_fuzzy_zero(Angle) == false)
+    {
+        if (sad::is_fuzzy_zero(RotationVectorDirection.x()) == false
+            || sad::is_fuzzy_zero(RotationVectorDirection.y()) == false
+            || sad::is_fuzzy_zero(RotationVectorDirection.z()))
+        {
+            return false;
+        }
+    }
+    // Corners of viewport are transformed back to scene by inverse transformation of camera
+    const sad::Matrix4x4<double>& inverse = this->inverseMatrix();
+    sad::Point2D corners[4] = {
+        sad::Point2D(0, 0),
+        sad::Point2D(width, 0),
+        sad::Point2D(width, height),
+        sad::Point2D(0, height)
+    };
+    for(int i = 0; i < 4; i++)
+    {
+        corners[i] = inverse.transform(sad::Point3D(corners[i]));
+    }
+    r = sad::boundingBox(sad::Rect2D(corners[0], corners[1], corners[2], corners[3]));
+    return true;
 }
 
 sad::Camera::~Camera()
 {
 
 }
+
+/*! Tests, whether vectors are equal exactly
+    \param[in] a first vector
+    \param[in] b second vector
+    \return whether they are equal
+ */
+static bool equal_camera_vectors(const sad::Vector3D& a, const sad::Vector3D& b)
+{
+    return a.x() == b.x() && a.y() == b.y() && a.z() == b.z();
+}
+
+void sad::Camera::updateMatrices() const
+{
+    sad::Vector3D translation = TranslationOffset;
+    if (Scene)
+    {
+        sad::Renderer* renderer  = Scene->renderer();
+        if (renderer)
+        {
+            translation += renderer->globalTranslationOffset();
+        }
+    }
+    if (m_matrices_computed
+        && equal_camera_vectors(m_cached_translation, translation)
+        && equal_camera_vectors(m_cached_rotation_offset, TemporaryRotationOffset)
+        && m_cached_angle == Angle
+        && equal_camera_vectors(m_cached_rotation_direction, RotationVectorDirection))
+    {
+        return;
+    }
+    m_matrices_computed = true;
+    m_cached_translation = translation;
+    m_cached_rotation_offset = TemporaryRotationOffset;
+    m_cached_angle = Angle;
+    m_cached_rotation_direction = RotationVectorDirection;
+
+    // Same transformations, as applied in apply()
+    const sad::Vector3D& o = TemporaryRotationOffset;
+    const sad::Vector3D& d = RotationVectorDirection;
+    m_matrix = sad::Matrix4x4<double>::translation(translation.x(), translation.y(), translation.z())
+             * sad::Matrix4x4<double>::translation(o.x(), o.y(), o.z())
+             * sad::Matrix4x4<double>::rotation(Angle, d.x(), d.y(), d.z())
+             * sad::Matrix4x4<double>::translation(-(o.x()), -(o.y()), -(o.z()));
+    // Translations and rotations are always invertible
+    m_matrix.inverse(m_inverse_matrix);
+}
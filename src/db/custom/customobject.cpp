@@ -472,12 +472,15 @@ void sad::db::custom::Object::setRenderingStringLimitAsRatioToLength(double limi
     m_label->setRenderingStringLimitAsRatioToLength(limit);
 }
 
-bool sad::db::custom::Object::load(const picojson::value& v)
+void sad::db::custom::Object::beginLoading()
 {
     m_sprite2d->toggleLoadingMode(true);
-    bool result = this->sad::SceneNode::load(v);
+}
+
+bool sad::db::custom::Object::finishLoading(bool loaded)
+{
     m_sprite2d->toggleLoadingMode(false);
-    return result;
+    return loaded;
 }
 
 void sad::db::custom::Object::initDefaultSchema()
@@ -90,6 +90,11 @@ bool sad::db::custom::SchemaFile::supportsLoadingFromTar7z() const
     return true;
 }
 
+bool sad::db::custom::SchemaFile::supportsParallelLoading() const
+{
+    return false;
+}
+
 void sad::db::custom::SchemaFile::tryParsePartial(
         sad::db::custom::SchemaFile::parse_result & result,
         sad::Vector<sad::resource::Error *> & errors,
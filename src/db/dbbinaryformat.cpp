@@ -0,0 +1,56 @@
+#include "db/dbbinaryformat.h"
+#include "db/dbvariant.h"
+#include "sadhash.h"
+
+/*! Makes table of primitive types by their names
+    \return table
+ */
+static sad::Hash<sad::String, sad::db::BinaryPrimitive> makeBinaryPrimitives()
+{
+    sad::Hash<sad::String, sad::db::BinaryPrimitive> result;
+    result.insert("bool", sad::db::BP_BOOL);
+    result.insert("char", sad::db::BP_CHAR);
+    result.insert("signed char", sad::db::BP_SIGNED_CHAR);
+    result.insert("unsigned char", sad::db::BP_UNSIGNED_CHAR);
+    result.insert("short", sad::db::BP_SHORT);
+    result.insert("unsigned short", sad::db::BP_UNSIGNED_SHORT);
+    result.insert("int", sad::db::BP_INT);
+    result.insert("unsigned int", sad::db::BP_UNSIGNED_INT);
+    result.insert("long", sad::db::BP_LONG);
+    result.insert("unsigned long", sad::db::BP_UNSIGNED_LONG);
+    result.insert("long long", sad::db::BP_LONG_LONG);
+    result.insert("unsigned long long", sad::db::BP_UNSIGNED_LONG_LONG);
+    result.insert("float", sad::db::BP_FLOAT);
+    result.insert("double", sad::db::BP_DOUBLE);
+    result.insert("long double", sad::db::BP_LONG_DOUBLE);
+    result.insert("sad::String", sad::db::BP_SAD_STRING);
+    result.insert("std::string", sad::db::BP_STD_STRING);
+    result.insert("sad::Point2D", sad::db::BP_POINT2D);
+    result.insert("sad::Point2I", sad::db::BP_POINT2I);
+    result.insert("sad::Point3D", sad::db::BP_POINT3D);
+    result.insert("sad::Point3I", sad::db::BP_POINT3I);
+    result.insert("sad::Rect2D", sad::db::BP_RECT2D);
+    result.insert("sad::Size2D", sad::db::BP_SIZE2D);
+    result.insert("sad::Size2I", sad::db::BP_SIZE2I);
+    result.insert("sad::Color", sad::db::BP_COLOR);
+    result.insert("sad::AColor", sad::db::BP_ACOLOR);
+    result.insert("sad::Vector<sad::Point2D>", sad::db::BP_VECTOR_POINT2D);
+    result.insert("sad::Vector<sad::Vector<sad::AColor> >", sad::db::BP_VECTOR_VECTOR_ACOLOR);
+    result.insert("sad::Vector<sad::String>", sad::db::BP_VECTOR_STRING);
+    result.insert("sad::Vector<unsigned long long>", sad::db::BP_VECTOR_UNSIGNED_LONG_LONG);
+    return result;
+}
+
+sad::db::BinaryPrimitive sad::db::binaryPrimitiveOf(const sad::db::Variant& v)
+{
+    static const sad::Hash<sad::String, sad::db::BinaryPrimitive> primitives = makeBinaryPrimitives();
+    if (v.pointerStarsCount() != 0 || v.data() == NULL)
+    {
+        return sad::db::BP_NONE;
+    }
+    if (primitives.contains(v.typeName()) == false)
+    {
+        return sad::db::BP_NONE;
+    }
+    return primitives[v.typeName()];
+}
@@ -0,0 +1,642 @@
+#include "db/dbbinaryreader.h"
+#include "db/dbvariant.h"
+
+#include <cstring>
+
+// ===================================  PUBLIC METHODS ===================================
+
+sad::db::BinaryReader::BinaryReader(const sad::String& data)
+: m_data(reinterpret_cast<const unsigned char*>(data.c_str())), m_size(data.size()), m_position(0), m_version(0)
+{
+
+}
+
+bool sad::db::BinaryReader::readHeader()
+{
+    size_t magiclength = strlen(SAD_DB_BINARY_MAGIC);
+    if (!canRead(magiclength) || memcmp(m_data + m_position, SAD_DB_BINARY_MAGIC, magiclength) != 0)
+    {
+        return false;
+    }
+    m_position += magiclength;
+    unsigned int version = 0;
+    // Version 1 differs only in storing composite values as JSON-like structures
+    if (!readUInt32(version) || version < 1 || version > SAD_DB_BINARY_VERSION)
+    {
+        return false;
+    }
+    m_version = version;
+    unsigned int count = 0;
+    if (!readUInt32(count) || !canRead(count * static_cast<size_t>(4)))
+    {
+        return false;
+    }
+    m_strings.clear();
+    m_string_indexes.clear();
+    m_strings.reserve(count);
+    for(unsigned int i = 0; i < count; i++)
+    {
+        unsigned int length = 0;
+        if (!readUInt32(length) || !canRead(length))
+        {
+            return false;
+        }
+        m_strings << sad::String(std::string(reinterpret_cast<const char*>(m_data + m_position), length));
+        m_string_indexes.insert(m_strings[i], i);
+        m_position += length;
+    }
+    return true;
+}
+
+bool sad::db::BinaryReader::readByte(unsigned char& v)
+{
+    if (!canRead(1))
+    {
+        return false;
+    }
+    v = m_data[m_position];
+    ++m_position;
+    return true;
+}
+
+bool sad::db::BinaryReader::readUInt32(unsigned int& v)
+{
+    if (!canRead(4))
+    {
+        return false;
+    }
+    v = 0;
+    for(int i = 0; i < 4; i++)
+    {
+        v |= static_cast<unsigned int>(m_data[m_position + i]) << (8 * i);
+    }
+    m_position += 4;
+    return true;
+}
+
+bool sad::db::BinaryReader::readUInt64(unsigned long long& v)
+{
+    if (!canRead(8))
+    {
+        return false;
+    }
+    v = 0;
+    for(int i = 0; i < 8; i++)
+    {
+        v |= static_cast<unsigned long long>(m_data[m_position + i]) << (8 * i);
+    }
+    m_position += 8;
+    return true;
+}
+
+bool sad::db::BinaryReader::readDouble(double& v)
+{
+    unsigned long long bits = 0;
+    if (!readUInt64(bits))
+    {
+        return false;
+    }
+    memcpy(&v, &bits, sizeof(double));
+    return true;
+}
+
+bool sad::db::BinaryReader::readString(const sad::String*& s)
+{
+    unsigned int index = 0;
+    if (!readUInt32(index) || index >= m_strings.size())
+    {
+        return false;
+    }
+    s = &(m_strings[index]);
+    return true;
+}
+
+bool sad::db::BinaryReader::readValue(sad::db::Variant& v)
+{
+    sad::db::BinaryPrimitive primitive = sad::db::binaryPrimitiveOf(v);
+    if (primitive >= sad::db::BP_POINT2D)
+    {
+        if (m_version >= 2)
+        {
+            return readComposite(primitive, v.data());
+        }
+        primitive = sad::db::BP_NONE;
+    }
+
+    unsigned char tag = 0;
+    if (!readByte(tag))
+    {
+        return false;
+    }
+    if (primitive == sad::db::BP_NONE)
+    {
+        picojson::value json;
+        if (!readJSONWithTag(tag, json, 0))
+        {
+            return false;
+        }
+        return v.load(json);
+    }
+
+    void* data = v.data();
+    if (primitive == sad::db::BP_SAD_STRING || primitive == sad::db::BP_STD_STRING)
+    {
+        const sad::String* s = NULL;
+        if (tag != sad::db::BVT_STRING || !readString(s))
+        {
+            return false;
+        }
+        if (primitive == sad::db::BP_SAD_STRING)
+        {
+            *static_cast<sad::String*>(data) = *s;
+        }
+        else
+        {
+            *static_cast<std::string*>(data) = *s;
+        }
+        return true;
+    }
+
+    // Numeric value could be converted to any other numeric type, like in JSON
+    long long i = 0;
+    unsigned long long u = 0;
+    double d = 0;
+    switch(tag)
+    {
+        case sad::db::BVT_BOOL:
+        {
+            unsigned char b = 0;
+            if (!readByte(b))
+            {
+                return false;
+            }
+            i = (b != 0) ? 1 : 0;
+            u = static_cast<unsigned long long>(i);
+            d = static_cast<double>(i);
+            break;
+        }
+        case sad::db::BVT_INT:
+            if (!readUInt64(u))
+            {
+                return false;
+            }
+            i = static_cast<long long>(u);
+            d = static_cast<double>(i);
+            break;
+        case sad::db::BVT_UINT:
+            if (!readUInt64(u))
+            {
+                return false;
+            }
+            i = static_cast<long long>(u);
+            d = static_cast<double>(u);
+            break;
+        case sad::db::BVT_DOUBLE:
+            if (!readDouble(d))
+            {
+                return false;
+            }
+            i = static_cast<long long>(d);
+            u = (d < 0) ? static_cast<unsigned long long>(i) : static_cast<unsigned long long>(d);
+            break;
+        default:
+            return false;
+    }
+
+    switch(primitive)
+    {
+        case sad::db::BP_BOOL: *static_cast<bool*>(data) = (tag == sad::db::BVT_DOUBLE) ? (d != 0) : (u != 0); break;
+        case sad::db::BP_CHAR: *static_cast<char*>(data) = static_cast<char>(i); break;
+        case sad::db::BP_SIGNED_CHAR: *static_cast<signed char*>(data) = static_cast<signed char>(i); break;
+        case sad::db::BP_UNSIGNED_CHAR: *static_cast<unsigned char*>(data) = static_cast<unsigned char>(u); break;
+        case sad::db::BP_SHORT: *static_cast<short*>(data) = static_cast<short>(i); break;
+        case sad::db::BP_UNSIGNED_SHORT: *static_cast<unsigned short*>(data) = static_cast<unsigned short>(u); break;
+        case sad::db::BP_INT: *static_cast<int*>(data) = static_cast<int>(i); break;
+        case sad::db::BP_UNSIGNED_INT: *static_cast<unsigned int*>(data) = static_cast<unsigned int>(u); break;
+        case sad::db::BP_LONG: *static_cast<long*>(data) = static_cast<long>(i); break;
+        case sad::db::BP_UNSIGNED_LONG: *static_cast<unsigned long*>(data) = static_cast<unsigned long>(u); break;
+        case sad::db::BP_LONG_LONG: *static_cast<long long*>(data) = i; break;
+        case sad::db::BP_UNSIGNED_LONG_LONG: *static_cast<unsigned long long*>(data) = u; break;
+        case sad::db::BP_FLOAT: *static_cast<float*>(data) = static_cast<float>(d); break;
+        case sad::db::BP_DOUBLE: *static_cast<double*>(data) = d; break;
+        case sad::db::BP_LONG_DOUBLE: *static_cast<long double*>(data) = d; break;
+        default: return false;
+    }
+    return true;
+}
+
+bool sad::db::BinaryReader::readJSON(picojson::value& v)
+{
+    unsigned char tag = 0;
+    if (!readByte(tag))
+    {
+        return false;
+    }
+    return readJSONWithTag(tag, v, 0);
+}
+
+bool sad::db::BinaryReader::skipValue(unsigned int depth)
+{
+    unsigned char tag = 0;
+    if (!readByte(tag))
+    {
+        return false;
+    }
+    switch(tag)
+    {
+        case sad::db::BVT_NULL:
+            return true;
+        case sad::db::BVT_BOOL:
+            return readByte(tag);
+        case sad::db::BVT_INT:
+        case sad::db::BVT_UINT:
+        case sad::db::BVT_DOUBLE:
+            if (!canRead(8))
+            {
+                return false;
+            }
+            m_position += 8;
+            return true;
+        case sad::db::BVT_STRING:
+        {
+            const sad::String* s = NULL;
+            return readString(s);
+        }
+        case sad::db::BVT_DOUBLES:
+        case sad::db::BVT_BYTES:
+        {
+            unsigned int count = 0;
+            size_t size = (tag == sad::db::BVT_DOUBLES) ? 8 : 1;
+            if (!readUInt32(count) || !canRead(count * size))
+            {
+                return false;
+            }
+            m_position += count * size;
+            return true;
+        }
+        case sad::db::BVT_ARRAY:
+        case sad::db::BVT_OBJECT:
+        {
+            unsigned int count = 0;
+            if (depth >= SAD_DB_BINARY_MAX_DEPTH || !readUInt32(count))
+            {
+                return false;
+            }
+            bool ok = true;
+            for(unsigned int i = 0; i < count && ok; i++)
+            {
+                if (tag == sad::db::BVT_OBJECT)
+                {
+                    const sad::String* key = NULL;
+                    ok = readString(key);
+                }
+                ok = ok && skipValue(depth + 1);
+            }
+            return ok;
+        }
+    }
+    return false;
+}
+
+bool sad::db::BinaryReader::readFields(sad::db::BinaryReader::Fields& fields)
+{
+    unsigned int count = 0;
+    // Every field takes at least five bytes
+    if (!readUInt32(count) || !canRead(count * static_cast<size_t>(5)))
+    {
+        return false;
+    }
+    fields.clear();
+    fields.reserve(count);
+    for(unsigned int i = 0; i < count; i++)
+    {
+        sad::db::BinaryReader::Field field;
+        if (!readUInt32(field.Name) || field.Name >= m_strings.size())
+        {
+            return false;
+        }
+        field.Offset = m_position;
+        if (!skipValue())
+        {
+            return false;
+        }
+        fields << field;
+    }
+    return true;
+}
+
+const sad::db::BinaryReader::Field* sad::db::BinaryReader::findField(
+    const sad::db::BinaryReader::Fields& fields,
+    const sad::String& name
+) const
+{
+    if (m_string_indexes.contains(name) == false)
+    {
+        return NULL;
+    }
+    unsigned int index = m_string_indexes[name];
+    for(size_t i = 0; i < fields.size(); i++)
+    {
+        if (fields[i].Name == index)
+        {
+            return &(fields[i]);
+        }
+    }
+    return NULL;
+}
+
+size_t sad::db::BinaryReader::position() const
+{
+    return m_position;
+}
+
+void sad::db::BinaryReader::setPosition(size_t position)
+{
+    m_position = position;
+}
+
+bool sad::db::BinaryReader::atEnd() const
+{
+    return m_position == m_size;
+}
+
+// ===================================  PRIVATE METHODS ===================================
+
+bool sad::db::BinaryReader::readJSONWithTag(unsigned char tag, picojson::value& v, unsigned int depth)
+{
+    switch(tag)
+    {
+        case sad::db::BVT_NULL:
+            v = picojson::value();
+            return true;
+        case sad::db::BVT_BOOL:
+        {
+            unsigned char b = 0;
+            if (!readByte(b))
+            {
+                return false;
+            }
+            v = picojson::value(b != 0);
+            return true;
+        }
+        case sad::db::BVT_INT:
+        case sad::db::BVT_UINT:
+        {
+            unsigned long long u = 0;
+            if (!readUInt64(u))
+            {
+                return false;
+            }
+            if (tag == sad::db::BVT_INT)
+            {
+                v = picojson::value(static_cast<double>(static_cast<long long>(u)));
+            }
+            else
+            {
+                v = picojson::value(static_cast<double>(u));
+            }
+            return true;
+        }
+        case sad::db::BVT_DOUBLE:
+        {
+            double d = 0;
+            if (!readDouble(d))
+            {
+                return false;
+            }
+            v = picojson::value(d);
+            return true;
+        }
+        case sad::db::BVT_STRING:
+        {
+            const sad::String* s = NULL;
+            if (!readString(s))
+            {
+                return false;
+            }
+            v = picojson::value(static_cast<const std::string&>(*s));
+            return true;
+        }
+        case sad::db::BVT_ARRAY:
+        {
+            unsigned int count = 0;
+            if (depth >= SAD_DB_BINARY_MAX_DEPTH || !readUInt32(count) || !canRead(count))
+            {
+                return false;
+            }
+            picojson::array a(count);
+            for(unsigned int i = 0; i < count; i++)
+            {
+                unsigned char itemtag = 0;
+                if (!readByte(itemtag) || !readJSONWithTag(itemtag, a[i], depth + 1))
+                {
+                    return false;
+                }
+            }
+            v = picojson::value(a);
+            return true;
+        }
+        case sad::db::BVT_OBJECT:
+        {
+            unsigned int count = 0;
+            if (depth >= SAD_DB_BINARY_MAX_DEPTH || !readUInt32(count) || !canRead(count * static_cast<size_t>(5)))
+            {
+                return false;
+            }
+            picojson::object o;
+            for(unsigned int i = 0; i < count; i++)
+            {
+                const sad::String* key = NULL;
+                picojson::value value;
+                unsigned char itemtag = 0;
+                if (!readString(key) || !readByte(itemtag) || !readJSONWithTag(itemtag, value, depth + 1))
+                {
+                    return false;
+                }
+                o.insert(std::make_pair(static_cast<const std::string&>(*key), value));
+            }
+            v = picojson::value(o);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool sad::db::BinaryReader::readComposite(sad::db::BinaryPrimitive primitive, void* data)
+{
+    switch(primitive)
+    {
+        case sad::db::BP_POINT2D:
+            return readTyped(*static_cast<sad::Point2D*>(data));
+        case sad::db::BP_POINT2I:
+        {
+            double values[2];
+            if (!readDoubles(values, 2))
+            {
+                return false;
+            }
+            *static_cast<sad::Point2I*>(data) = sad::Point2I(static_cast<int>(values[0]), static_cast<int>(values[1]));
+            return true;
+        }
+        case sad::db::BP_POINT3D:
+        {
+            double values[3];
+            if (!readDoubles(values, 3))
+            {
+                return false;
+            }
+            *static_cast<sad::Point3D*>(data) = sad::Point3D(values[0], values[1], values[2]);
+            return true;
+        }
+        case sad::db::BP_POINT3I:
+        {
+            double values[3];
+            if (!readDoubles(values, 3))
+            {
+                return false;
+            }
+            *static_cast<sad::Point3I*>(data) = sad::Point3I(
+                static_cast<int>(values[0]),
+                static_cast<int>(values[1]),
+                static_cast<int>(values[2])
+            );
+            return true;
+        }
+        case sad::db::BP_RECT2D:
+        {
+            double values[8];
+            if (!readDoubles(values, 8))
+            {
+                return false;
+            }
+            sad::Rect2D& r = *static_cast<sad::Rect2D*>(data);
+            for(unsigned int i = 0; i < 4; i++)
+            {
+                r[i] = sad::Point2D(values[i * 2], values[i * 2 + 1]);
+            }
+            return true;
+        }
+        case sad::db::BP_SIZE2D:
+        {
+            double values[2];
+            if (!readDoubles(values, 2))
+            {
+                return false;
+            }
+            *static_cast<sad::Size2D*>(data) = sad::Size2D(values[0], values[1]);
+            return true;
+        }
+        case sad::db::BP_SIZE2I:
+        {
+            double values[2];
+            if (!readDoubles(values, 2))
+            {
+                return false;
+            }
+            *static_cast<sad::Size2I*>(data) = sad::Size2I(
+                static_cast<unsigned int>(values[0]),
+                static_cast<unsigned int>(values[1])
+            );
+            return true;
+        }
+        case sad::db::BP_COLOR:
+        {
+            unsigned char values[3];
+            if (!readBytes(values, 3))
+            {
+                return false;
+            }
+            *static_cast<sad::Color*>(data) = sad::Color(values[0], values[1], values[2]);
+            return true;
+        }
+        case sad::db::BP_ACOLOR:
+            return readTyped(*static_cast<sad::AColor*>(data));
+        case sad::db::BP_VECTOR_POINT2D:
+            return readTyped(*static_cast<sad::Vector<sad::Point2D>*>(data));
+        case sad::db::BP_VECTOR_VECTOR_ACOLOR:
+            return readTyped(*static_cast<sad::Vector<sad::Vector<sad::AColor> >*>(data));
+        case sad::db::BP_VECTOR_STRING:
+            return readTyped(*static_cast<sad::Vector<sad::String>*>(data));
+        case sad::db::BP_VECTOR_UNSIGNED_LONG_LONG:
+            return readTyped(*static_cast<sad::Vector<unsigned long long>*>(data));
+        default:
+            break;
+    }
+    return false;
+}
+
+bool sad::db::BinaryReader::readDoubles(double* values, unsigned int count)
+{
+    unsigned char tag = 0;
+    unsigned int stored = 0;
+    if (!readByte(tag) || tag != sad::db::BVT_DOUBLES || !readUInt32(stored) || stored != count)
+    {
+        return false;
+    }
+    for(unsigned int i = 0; i < count; i++)
+    {
+        if (!readDouble(values[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool sad::db::BinaryReader::readBytes(unsigned char* values, unsigned int count)
+{
+    unsigned char tag = 0;
+    unsigned int stored = 0;
+    if (!readByte(tag) || tag != sad::db::BVT_BYTES || !readUInt32(stored) || stored != count || !canRead(count))
+    {
+        return false;
+    }
+    memcpy(values, m_data + m_position, count);
+    m_position += count;
+    return true;
+}
+
+bool sad::db::BinaryReader::readTyped(sad::Point2D& v)
+{
+    double values[2];
+    if (!readDoubles(values, 2))
+    {
+        return false;
+    }
+    v = sad::Point2D(values[0], values[1]);
+    return true;
+}
+
+bool sad::db::BinaryReader::readTyped(sad::AColor& v)
+{
+    unsigned char values[4];
+    if (!readBytes(values, 4))
+    {
+        return false;
+    }
+    v = sad::AColor(values[0], values[1], values[2], values[3]);
+    return true;
+}
+
+bool sad::db::BinaryReader::readTyped(sad::String& v)
+{
+    unsigned char tag = 0;
+    const sad::String* s = NULL;
+    if (!readByte(tag) || tag != sad::db::BVT_STRING || !readString(s))
+    {
+        return false;
+    }
+    v = *s;
+    return true;
+}
+
+bool sad::db::BinaryReader::readTyped(unsigned long long& v)
+{
+    unsigned char tag = 0;
+    return readByte(tag) && tag == sad::db::BVT_UINT && readUInt64(v);
+}
+
+bool sad::db::BinaryReader::canRead(size_t size) const
+{
+    return m_size - m_position >= size;
+}
@@ -0,0 +1,329 @@
+#include "db/dbbinarywriter.h"
+#include "db/dbvariant.h"
+
+#include <cstring>
+
+// ===================================  PUBLIC METHODS ===================================
+
+sad::db::BinaryWriter::BinaryWriter()
+{
+
+}
+
+void sad::db::BinaryWriter::writeByte(unsigned char v)
+{
+    m_body.push_back(static_cast<char>(v));
+}
+
+void sad::db::BinaryWriter::writeUInt32(unsigned int v)
+{
+    sad::db::BinaryWriter::appendUInt32(m_body, v);
+}
+
+void sad::db::BinaryWriter::writeUInt64(unsigned long long v)
+{
+    for(int i = 0; i < 8; i++)
+    {
+        m_body.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+    }
+}
+
+void sad::db::BinaryWriter::writeDouble(double v)
+{
+    unsigned long long bits = 0;
+    memcpy(&bits, &v, sizeof(double));
+    writeUInt64(bits);
+}
+
+void sad::db::BinaryWriter::writeString(const sad::String& s)
+{
+    sad::Hash<sad::String, unsigned int>::iterator it = m_string_indexes.find(s);
+    if (it != m_string_indexes.end())
+    {
+        writeUInt32(it->second);
+    }
+    else
+    {
+        unsigned int index = static_cast<unsigned int>(m_strings.size());
+        m_strings << s;
+        m_string_indexes.insert(s, index);
+        writeUInt32(index);
+    }
+}
+
+void sad::db::BinaryWriter::writeValue(const sad::db::Variant& v)
+{
+    void* data = v.data();
+    switch(sad::db::binaryPrimitiveOf(v))
+    {
+        case sad::db::BP_BOOL:
+            writeByte(sad::db::BVT_BOOL);
+            writeByte(*static_cast<bool*>(data) ? 1 : 0);
+            break;
+        case sad::db::BP_CHAR:
+            writeByte(sad::db::BVT_INT);
+            writeUInt64(static_cast<unsigned long long>(static_cast<long long>(*static_cast<char*>(data))));
+            break;
+        case sad::db::BP_SIGNED_CHAR:
+            writeByte(sad::db::BVT_INT);
+            writeUInt64(static_cast<unsigned long long>(static_cast<long long>(*static_cast<signed char*>(data))));
+            break;
+        case sad::db::BP_SHORT:
+            writeByte(sad::db::BVT_INT);
+            writeUInt64(static_cast<unsigned long long>(static_cast<long long>(*static_cast<short*>(data))));
+            break;
+        case sad::db::BP_INT:
+            writeByte(sad::db::BVT_INT);
+            writeUInt64(static_cast<unsigned long long>(static_cast<long long>(*static_cast<int*>(data))));
+            break;
+        case sad::db::BP_LONG:
+            writeByte(sad::db::BVT_INT);
+            writeUInt64(static_cast<unsigned long long>(static_cast<long long>(*static_cast<long*>(data))));
+            break;
+        case sad::db::BP_LONG_LONG:
+            writeByte(sad::db::BVT_INT);
+            writeUInt64(static_cast<unsigned long long>(*static_cast<long long*>(data)));
+            break;
+        case sad::db::BP_UNSIGNED_CHAR:
+            writeByte(sad::db::BVT_UINT);
+            writeUInt64(*static_cast<unsigned char*>(data));
+            break;
+        case sad::db::BP_UNSIGNED_SHORT:
+            writeByte(sad::db::BVT_UINT);
+            writeUInt64(*static_cast<unsigned short*>(data));
+            break;
+        case sad::db::BP_UNSIGNED_INT:
+            writeByte(sad::db::BVT_UINT);
+            writeUInt64(*static_cast<unsigned int*>(data));
+            break;
+        case sad::db::BP_UNSIGNED_LONG:
+            writeByte(sad::db::BVT_UINT);
+            writeUInt64(*static_cast<unsigned long*>(data));
+            break;
+        case sad::db::BP_UNSIGNED_LONG_LONG:
+            writeByte(sad::db::BVT_UINT);
+            writeUInt64(*static_cast<unsigned long long*>(data));
+            break;
+        case sad::db::BP_FLOAT:
+            writeByte(sad::db::BVT_DOUBLE);
+            writeDouble(*static_cast<float*>(data));
+            break;
+        case sad::db::BP_DOUBLE:
+            writeByte(sad::db::BVT_DOUBLE);
+            writeDouble(*static_cast<double*>(data));
+            break;
+        case sad::db::BP_LONG_DOUBLE:
+            writeByte(sad::db::BVT_DOUBLE);
+            writeDouble(static_cast<double>(*static_cast<long double*>(data)));
+            break;
+        case sad::db::BP_SAD_STRING:
+            writeByte(sad::db::BVT_STRING);
+            writeString(*static_cast<sad::String*>(data));
+            break;
+        case sad::db::BP_STD_STRING:
+            writeByte(sad::db::BVT_STRING);
+            writeString(*static_cast<std::string*>(data));
+            break;
+        case sad::db::BP_POINT2D:
+            writeTyped(*static_cast<sad::Point2D*>(data));
+            break;
+        case sad::db::BP_POINT2I:
+        {
+            const sad::Point2I& p = *static_cast<sad::Point2I*>(data);
+            double values[2] = { static_cast<double>(p.x()), static_cast<double>(p.y()) };
+            writeDoubles(values, 2);
+            break;
+        }
+        case sad::db::BP_POINT3D:
+        {
+            const sad::Point3D& p = *static_cast<sad::Point3D*>(data);
+            double values[3] = { p.x(), p.y(), p.z() };
+            writeDoubles(values, 3);
+            break;
+        }
+        case sad::db::BP_POINT3I:
+        {
+            const sad::Point3I& p = *static_cast<sad::Point3I*>(data);
+            double values[3] = { static_cast<double>(p.x()), static_cast<double>(p.y()), static_cast<double>(p.z()) };
+            writeDoubles(values, 3);
+            break;
+        }
+        case sad::db::BP_RECT2D:
+        {
+            const sad::Rect2D& r = *static_cast<sad::Rect2D*>(data);
+            double values[8];
+            for(unsigned int i = 0; i < 4; i++)
+            {
+                values[i * 2] = r[i].x();
+                values[i * 2 + 1] = r[i].y();
+            }
+            writeDoubles(values, 8);
+            break;
+        }
+        case sad::db::BP_SIZE2D:
+        {
+            const sad::Size2D& size = *static_cast<sad::Size2D*>(data);
+            double values[2] = { size.Width, size.Height };
+            writeDoubles(values, 2);
+            break;
+        }
+        case sad::db::BP_SIZE2I:
+        {
+            const sad::Size2I& size = *static_cast<sad::Size2I*>(data);
+            double values[2] = { static_cast<double>(size.Width), static_cast<double>(size.Height) };
+            writeDoubles(values, 2);
+            break;
+        }
+        case sad::db::BP_COLOR:
+        {
+            const sad::Color& c = *static_cast<sad::Color*>(data);
+            unsigned char values[3] = { c.r(), c.g(), c.b() };
+            writeBytes(values, 3);
+            break;
+        }
+        case sad::db::BP_ACOLOR:
+            writeTyped(*static_cast<sad::AColor*>(data));
+            break;
+        case sad::db::BP_VECTOR_POINT2D:
+            writeTyped(*static_cast<sad::Vector<sad::Point2D>*>(data));
+            break;
+        case sad::db::BP_VECTOR_VECTOR_ACOLOR:
+            writeTyped(*static_cast<sad::Vector<sad::Vector<sad::AColor> >*>(data));
+            break;
+        case sad::db::BP_VECTOR_STRING:
+            writeTyped(*static_cast<sad::Vector<sad::String>*>(data));
+            break;
+        case sad::db::BP_VECTOR_UNSIGNED_LONG_LONG:
+            writeTyped(*static_cast<sad::Vector<unsigned long long>*>(data));
+            break;
+        default:
+            writeJSON(v.save());
+            break;
+    }
+}
+
+void sad::db::BinaryWriter::writeJSON(const picojson::value& v)
+{
+    if (v.is<bool>())
+    {
+        writeByte(sad::db::BVT_BOOL);
+        writeByte(v.get<bool>() ? 1 : 0);
+        return;
+    }
+    if (v.is<double>())
+    {
+        writeByte(sad::db::BVT_DOUBLE);
+        writeDouble(v.get<double>());
+        return;
+    }
+    if (v.is<std::string>())
+    {
+        writeByte(sad::db::BVT_STRING);
+        writeString(v.get<std::string>());
+        return;
+    }
+    if (v.is<picojson::array>())
+    {
+        const picojson::array& a = v.get<picojson::array>();
+        writeByte(sad::db::BVT_ARRAY);
+        writeUInt32(static_cast<unsigned int>(a.size()));
+        for(size_t i = 0; i < a.size(); i++)
+        {
+            writeJSON(a[i]);
+        }
+        return;
+    }
+    if (v.is<picojson::object>())
+    {
+        const picojson::object& o = v.get<picojson::object>();
+        writeByte(sad::db::BVT_OBJECT);
+        writeUInt32(static_cast<unsigned int>(o.size()));
+        for(picojson::object::const_iterator it = o.begin(); it != o.end(); ++it)
+        {
+            writeString(it->first);
+            writeJSON(it->second);
+        }
+        return;
+    }
+    writeByte(sad::db::BVT_NULL);
+}
+
+size_t sad::db::BinaryWriter::reserveUInt32()
+{
+    size_t result = m_body.size();
+    writeUInt32(0);
+    return result;
+}
+
+void sad::db::BinaryWriter::writeUInt32At(size_t position, unsigned int v)
+{
+    for(int i = 0; i < 4; i++)
+    {
+        m_body[position + i] = static_cast<char>((v >> (8 * i)) & 0xFF);
+    }
+}
+
+void sad::db::BinaryWriter::finish(sad::String& output) const
+{
+    std::string result(SAD_DB_BINARY_MAGIC);
+    sad::db::BinaryWriter::appendUInt32(result, SAD_DB_BINARY_VERSION);
+    sad::db::BinaryWriter::appendUInt32(result, static_cast<unsigned int>(m_strings.size()));
+    for(size_t i = 0; i < m_strings.size(); i++)
+    {
+        sad::db::BinaryWriter::appendUInt32(result, static_cast<unsigned int>(m_strings[i].size()));
+        result.append(m_strings[i]);
+    }
+    result.append(m_body);
+    output = result;
+}
+
+// ===================================  PRIVATE METHODS ===================================
+
+void sad::db::BinaryWriter::appendUInt32(std::string& buffer, unsigned int v)
+{
+    for(int i = 0; i < 4; i++)
+    {
+        buffer.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+    }
+}
+
+void sad::db::BinaryWriter::writeDoubles(const double* values, unsigned int count)
+{
+    writeByte(sad::db::BVT_DOUBLES);
+    writeUInt32(count);
+    for(unsigned int i = 0; i < count; i++)
+    {
+        writeDouble(values[i]);
+    }
+}
+
+void sad::db::BinaryWriter::writeBytes(const unsigned char* values, unsigned int count)
+{
+    writeByte(sad::db::BVT_BYTES);
+    writeUInt32(count);
+    m_body.append(reinterpret_cast<const char*>(values), count);
+}
+
+void sad::db::BinaryWriter::writeTyped(const sad::Point2D& v)
+{
+    double values[2] = { v.x(), v.y() };
+    writeDoubles(values, 2);
+}
+
+void sad::db::BinaryWriter::writeTyped(const sad::AColor& v)
+{
+    unsigned char values[4] = { v.r(), v.g(), v.b(), v.a() };
+    writeBytes(values, 4);
+}
+
+void sad::db::BinaryWriter::writeTyped(const sad::String& v)
+{
+    writeByte(sad::db::BVT_STRING);
+    writeString(v);
+}
+
+void sad::db::BinaryWriter::writeTyped(unsigned long long v)
+{
+    writeByte(sad::db::BVT_UINT);
+    writeUInt64(v);
+}
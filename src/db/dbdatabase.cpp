@@ -1,5 +1,7 @@
 #include "db/dbdatabase.h"
 #include "db/dbtypename.h"
+#include "db/dbbinarywriter.h"
+#include "db/dbbinaryreader.h"
 
 #include "util/fs.h"
 
@@ -9,7 +11,7 @@
 
 // ===================================  PUBLIC METHODS ===================================
 
-sad::db::Database::Database() : m_max_major_id(1), m_renderer(NULL)
+sad::db::Database::Database() : m_max_major_id(1), m_renderer(NULL), m_journal(NULL)
 {
     m_factory = new sad::db::ObjectFactory();
     m_prop_factory = new sad::db::StoredPropertyFactory();
@@ -17,6 +19,7 @@ sad::db::Database::Database() : m_max_major_id(1), m_renderer(NULL)
 
 sad::db::Database::~Database()
 {
+    delete m_journal;
     delete m_factory;
     delete m_prop_factory;
     for(sad::Hash<sad::String, sad::db::Table*>::iterator it = m_names_to_tables.begin();
@@ -65,13 +68,50 @@ sad::String sad::db::Database::save()
     return result;
 }
 
+void sad::db::Database::saveBinary(sad::String & output)
+{
+    sad::db::BinaryWriter w;
+    w.writeUInt32(static_cast<unsigned int>(m_properties.size()));
+    for(sad::PtrHash<sad::String, sad::db::Property>::iterator it = m_properties.begin();
+        it != m_properties.end();
+        ++it
+       )
+    {
+        w.writeString(it.key());
+        w.writeString(it.value()->serializableType());
+        sad::db::Variant tmp;
+        it.value()->get(NULL, tmp);
+        w.writeValue(tmp);
+    }
+
+    w.writeUInt32(static_cast<unsigned int>(m_names_to_tables.size()));
+    for(sad::Hash<sad::String, sad::db::Table*>::iterator it = m_names_to_tables.begin();
+        it!= m_names_to_tables.end();
+        ++it
+       )
+    {
+        w.writeString(it.key());
+        it.value()->saveBinary(w);
+    }
+    w.finish(output);
+}
+
 void sad::db::Database::saveToFile(const sad::String& s)
 {
-    std::ofstream file(s.c_str(), std::ofstream::out);
+    bool binary = sad::db::Database::isBinaryFileName(s);
+    std::ios_base::openmode mode = (binary) ? (std::ios_base::out | std::ios_base::binary) : std::ios_base::out;
+    std::ofstream file(s.c_str(), mode);
     if (file.good())
     {
         sad::String output;
-        this->save(output);
+        if (binary)
+        {
+            this->saveBinary(output);
+        }
+        else
+        {
+            this->save(output);
+        }
         file << output;
         file.close();
     }
@@ -106,6 +146,21 @@ bool sad::db::Database::load(const sad::String& text)
     return result;
 }
 
+bool sad::db::Database::loadBinary(const sad::String& input)
+{
+    sad::db::BinaryReader r(input);
+    bool result = r.readHeader();
+    if (result)
+    {
+        result = this->loadPropertiesAndTables(r);
+        if (result)
+        {
+            this->saveSnapshot();
+        }
+    }
+    return result;
+}
+
 bool sad::db::Database::tryLoadFrom(const sad::String& name)
 {
     return this->loadFromFile(name, sad::Renderer::ref());
@@ -114,8 +169,10 @@ bool sad::db::Database::tryLoadFrom(const sad::String& name)
 bool sad::db::Database::loadFromFile(const sad::String& name, sad::Renderer * r)
 {
     bool loadingresult = false;
+    bool binary = sad::db::Database::isBinaryFileName(name);
+    std::ios_base::openmode mode = (binary) ? (std::ios_base::in | std::ios_base::binary) : std::ios_base::in;
     sad::Maybe<sad::String> result;
-    std::ifstream stream(name.c_str());
+    std::ifstream stream(name.c_str(), mode);
     if (stream.good())
     {
         std::string alldata(
@@ -134,7 +191,7 @@ bool sad::db::Database::loadFromFile(const sad::String& name, sad::Renderer * r)
             }
             sad::String path = util::concatPaths(r->executablePath(), name);
             stream.clear();
-            stream.open(path.c_str());
+            stream.open(path.c_str(), mode);
             if (stream.good())
             {
                 std::string alldata(
@@ -148,7 +205,14 @@ bool sad::db::Database::loadFromFile(const sad::String& name, sad::Renderer * r)
 
     if (result.exists())
     {
-        loadingresult = this->load(result.value());
+        if (binary)
+        {
+            loadingresult = this->loadBinary(result.value());
+        }
+        else
+        {
+            loadingresult = this->load(result.value());
+        }
     }
 
     return loadingresult;
@@ -203,6 +267,10 @@ bool sad::db::Database::setDBProperty(const sad::String& name, sad::db::Variant&
     bool result = false;
     if (prop)
     {
+        if (m_journal)
+        {
+            m_journal->recordPropertyChange(NULL, name, prop);
+        }
         result = prop->set(NULL, v);
     }
     return result;
@@ -249,6 +317,10 @@ bool sad::db::Database::addTable(const sad::String& name, db::Table* table)
         table->addRef();
         table->setDatabase(this);
         m_names_to_tables.insert(name, table);
+        if (m_journal)
+        {
+            m_journal->recordTableAdded(name, table);
+        }
     }
     return result;		
 }
@@ -265,6 +337,10 @@ void sad::db::Database::removeTable(const sad::String& name)
             this->removeMajorId(objects[i]->MajorId);
         }
 
+        if (m_journal)
+        {
+            m_journal->recordTableRemoved(name, m_names_to_tables[name]);
+        }
         m_names_to_tables[name]->delRef();
         m_names_to_tables.remove(name);
     }
@@ -435,8 +511,39 @@ const sad::String& sad::db::Database::defaultTreeName() const
     return m_default_tree_name;
 }
 
+void sad::db::Database::setJournaledSnapshots(bool journaled)
+{
+    if (journaled == (m_journal != NULL))
+    {
+        return;
+    }
+    m_snapshots.clear();
+    delete m_journal;
+    m_journal = NULL;
+    if (journaled)
+    {
+        m_journal = new sad::db::Journal(this);
+    }
+}
+
+bool sad::db::Database::journaledSnapshots() const
+{
+    return m_journal != NULL;
+}
+
+sad::db::Journal* sad::db::Database::journal() const
+{
+    return m_journal;
+}
+
 void sad::db::Database::saveSnapshot()
 {
+    if (m_journal)
+    {
+        m_journal->saveSnapshot(m_max_major_id);
+        return;
+    }
+
     sad::db::Database::Snapshot snapshotstub;
     snapshotstub.MaxId = m_max_major_id;
     m_snapshots << snapshotstub;
@@ -463,11 +570,26 @@ void sad::db::Database::saveSnapshot()
 
 unsigned long sad::db::Database::snapshotsCount() const
 {
+    if (m_journal)
+    {
+        return m_journal->snapshotsCount();
+    }
     return m_snapshots.size();
 }
 
 bool sad::db::Database::restoreSnapshot(unsigned long index)
 {
+    if (m_journal)
+    {
+        unsigned long long maxid = m_max_major_id;
+        bool result = m_journal->restoreSnapshot(index, maxid);
+        if (result)
+        {
+            m_max_major_id = maxid;
+        }
+        return result;
+    }
+
     if (index >= m_snapshots.size())
     {
         return false;
@@ -666,6 +788,9 @@ bool sad::db::Database::loadPropertiesAndTables(
     sad::Hash<sad::String, sad::db::Property*> newproperties;
     bool result = loadProperties(properties, newproperties);
 
+    // Loaded tables are not part of database yet, so changes in them must not be journaled
+    sad::db::Journal* journal = m_journal;
+    m_journal = NULL;
     sad::Hash<sad::String, sad::db::Table*> newtables;
     for(picojson::object::const_iterator it = tables.begin();
         it != tables.end();
@@ -678,14 +803,110 @@ bool sad::db::Database::loadPropertiesAndTables(
         {
             newtables.insert(it->first, t);
         }
+        else
+        {
+            delete t;
+        }
         result = result && deserialized;
     }
+    m_journal = journal;
+
+    return finishLoadingPropertiesAndTables(result, oldmajoridtotable, oldmaxmajorid, newproperties, newtables);
+}
 
+bool sad::db::Database::loadProperties(
+    sad::db::BinaryReader& r,
+    sad::Hash<sad::String, sad::db::Property*>& newproperties
+)
+{
+    unsigned int count = 0;
+    bool result = r.readUInt32(count);
+    for(unsigned int i = 0; i < count && result; i++)
+    {
+        const sad::String* name = NULL;
+        const sad::String* type = NULL;
+        result = r.readString(name) && r.readString(type);
+        if (result)
+        {
+            sad::db::Property * p = m_prop_factory->create(*type);
+            result = (p != NULL);
+            if (result)
+            {
+                sad::db::Variant value;
+                p->get(NULL, value);
+                result = r.readValue(value) && p->set(NULL, value) && !newproperties.contains(*name);
+                if (result)
+                {
+                    newproperties.insert(*name, p);
+                }
+                else
+                {
+                    delete p;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+bool sad::db::Database::loadPropertiesAndTables(sad::db::BinaryReader& r)
+{
+    sad::Hash<unsigned long long, sad::db::Table*> oldmajoridtotable = m_majorid_to_table;
+    unsigned long long oldmaxmajorid = m_max_major_id;
+    sad::Hash<sad::String, sad::db::Property*> newproperties;
+    bool result = loadProperties(r, newproperties);
+
+    // Loaded tables are not part of database yet, so changes in them must not be journaled
+    sad::db::Journal* journal = m_journal;
+    m_journal = NULL;
+    sad::Hash<sad::String, sad::db::Table*> newtables;
+    unsigned int count = 0;
+    result = result && r.readUInt32(count);
+    for(unsigned int i = 0; i < count && result; i++)
+    {
+        const sad::String* name = NULL;
+        result = r.readString(name) && !newtables.contains(*name);
+        if (result)
+        {
+            sad::db::Table* t = new sad::db::Table();
+            t->setDatabase(this);
+            result = t->loadBinary(r, m_factory, this->renderer(), this->defaultTreeName());
+            if (result)
+            {
+                newtables.insert(*name, t);
+            }
+            else
+            {
+                delete t;
+            }
+        }
+    }
+    m_journal = journal;
+    // Trailing data means, that data is malformed
+    result = result && r.atEnd();
+
+    return finishLoadingPropertiesAndTables(result, oldmajoridtotable, oldmaxmajorid, newproperties, newtables);
+}
+
+bool sad::db::Database::finishLoadingPropertiesAndTables(
+    bool result,
+    const sad::Hash<unsigned long long, sad::db::Table*>& oldmajoridtotable,
+    unsigned long long oldmaxmajorid,
+    sad::Hash<sad::String, sad::db::Property*>& newproperties,
+    sad::Hash<sad::String, sad::db::Table*>& newtables
+)
+{
     if (result)
     {
+        // Journal references old tables and objects, which are going to be replaced
+        if (m_journal)
+        {
+            m_journal->clear();
+        }
+
         // Remove old keys
-        for(sad::Hash<unsigned long long, sad::db::Table*>::iterator it = oldmajoridtotable.begin();
-            it != oldmajoridtotable.end();
+        for(sad::Hash<unsigned long long, sad::db::Table*>::const_iterator it = oldmajoridtotable.const_begin();
+            it != oldmajoridtotable.const_end();
             ++it)
         {
             m_majorid_to_table.remove(it.key());
@@ -694,15 +915,21 @@ bool sad::db::Database::loadPropertiesAndTables(
         // Reset old properties
         setPropertiesFrom(newproperties);
 
-        // Reset old tables
+        // Reset old tables. Database holds a reference to each table, like in addTable
         for(sad::Hash<sad::String, sad::db::Table*>::iterator it = m_names_to_tables.begin();
             it != m_names_to_tables.end();
             ++it)
         {
-            delete it.value();
+            it.value()->delRef();
         }
         m_names_to_tables.clear();
         m_names_to_tables = newtables;
+        for(sad::Hash<sad::String, sad::db::Table*>::iterator it = m_names_to_tables.begin();
+            it != m_names_to_tables.end();
+            ++it)
+        {
+            it.value()->addRef();
+        }
     }
     else
     {
@@ -729,6 +956,13 @@ bool sad::db::Database::loadPropertiesAndTables(
     return result;
 }
 
+bool sad::db::Database::isBinaryFileName(const sad::String& name)
+{
+    sad::String extension = name.getExtension();
+    extension.toLower();
+    return extension == SAD_DB_BINARY_EXTENSION;
+}
+
 void sad::db::Database::saveProperties(picojson::object& o)
 {
     for(sad::PtrHash<sad::String, sad::db::Property>::iterator it = m_properties.begin();
@@ -0,0 +1,343 @@
+#include "db/dbjournal.h"
+#include "db/dbdatabase.h"
+#include "db/dbtable.h"
+#include "db/dbobject.h"
+#include "db/dbproperty.h"
+
+// ===================================  PUBLIC METHODS ===================================
+
+sad::db::Journal::Journal(sad::db::Database* db)
+: m_database(db), m_position(0), m_replaying(false)
+{
+
+}
+
+sad::db::Journal::~Journal()
+{
+    clear();
+}
+
+bool sad::db::Journal::isRecording() const
+{
+    return m_max_ids.size() != 0 && !m_replaying;
+}
+
+void sad::db::Journal::recordPropertyChange(sad::db::Object* o, const sad::String& name, sad::db::Property* prop)
+{
+    if (!isRecording() || !prop)
+    {
+        return;
+    }
+    if (m_pending_properties.contains(o) == false)
+    {
+        m_pending_properties.insert(o, sad::Hash<sad::String, size_t>());
+    }
+    sad::Hash<sad::String, size_t>& properties = m_pending_properties[o];
+    if (properties.contains(name))
+    {
+        // Only first value since last snapshot is needed to undo changes
+        return;
+    }
+    sad::db::Journal::Entry e;
+    e.Type = sad::db::Journal::JET_PROPERTY_CHANGED;
+    e.Item = o;
+    e.Container = NULL;
+    e.Name = name;
+    prop->get(o, e.OldValue);
+    properties.insert(name, m_pending.size());
+    addPending(e);
+}
+
+void sad::db::Journal::recordObjectAdded(sad::db::Table* t, sad::db::Object* o)
+{
+    if (isRecording())
+    {
+        sad::db::Journal::Entry e;
+        e.Type = sad::db::Journal::JET_OBJECT_ADDED;
+        e.Item = o;
+        e.Container = t;
+        addPending(e);
+    }
+}
+
+void sad::db::Journal::recordObjectRemoved(sad::db::Table* t, sad::db::Object* o)
+{
+    if (isRecording())
+    {
+        sad::db::Journal::Entry e;
+        e.Type = sad::db::Journal::JET_OBJECT_REMOVED;
+        e.Item = o;
+        e.Container = t;
+        addPending(e);
+    }
+}
+
+void sad::db::Journal::recordTableAdded(const sad::String& name, sad::db::Table* t)
+{
+    if (isRecording())
+    {
+        sad::db::Journal::Entry e;
+        e.Type = sad::db::Journal::JET_TABLE_ADDED;
+        e.Item = NULL;
+        e.Container = t;
+        e.Name = name;
+        addPending(e);
+    }
+}
+
+void sad::db::Journal::recordTableRemoved(const sad::String& name, sad::db::Table* t)
+{
+    if (isRecording())
+    {
+        sad::db::Journal::Entry e;
+        e.Type = sad::db::Journal::JET_TABLE_REMOVED;
+        e.Item = NULL;
+        e.Container = t;
+        e.Name = name;
+        addPending(e);
+    }
+}
+
+void sad::db::Journal::saveSnapshot(unsigned long long maxid)
+{
+    if (m_max_ids.size() == 0)
+    {
+        // First snapshot is a state of database itself, so nothing should be stored
+        releaseSegment(m_pending);
+        m_pending_properties.clear();
+        m_max_ids << maxid;
+        m_position = 0;
+        return;
+    }
+
+    m_segments << sad::db::Journal::Segment();
+    sad::db::Journal::Segment& segment = m_segments[m_segments.size() - 1];
+    // If we restored older snapshot, new snapshot leads from last one, so
+    // we must undo changes, which lead from current snapshot to last
+    for(size_t i = m_max_ids.size() - 1; i > m_position; i--)
+    {
+        sad::db::Journal::Segment& skipped = m_segments[i - 1];
+        for(size_t j = skipped.size(); j > 0; j--)
+        {
+            sad::db::Journal::Entry e = skipped[j - 1];
+            switch(e.Type)
+            {
+                case sad::db::Journal::JET_PROPERTY_CHANGED:
+                    std::swap(e.OldValue, e.NewValue);
+                    break;
+                case sad::db::Journal::JET_OBJECT_ADDED:
+                    e.Type = sad::db::Journal::JET_OBJECT_REMOVED;
+                    break;
+                case sad::db::Journal::JET_OBJECT_REMOVED:
+                    e.Type = sad::db::Journal::JET_OBJECT_ADDED;
+                    break;
+                case sad::db::Journal::JET_TABLE_ADDED:
+                    e.Type = sad::db::Journal::JET_TABLE_REMOVED;
+                    break;
+                case sad::db::Journal::JET_TABLE_REMOVED:
+                    e.Type = sad::db::Journal::JET_TABLE_ADDED;
+                    break;
+            }
+            retain(e);
+            segment << e;
+        }
+    }
+
+    // Pending entries are moved to segment with their references
+    for(size_t i = 0; i < m_pending.size(); i++)
+    {
+        sad::db::Journal::Entry& e = m_pending[i];
+        if (e.Type == sad::db::Journal::JET_PROPERTY_CHANGED)
+        {
+            sad::db::Property* prop = (e.Item) ? e.Item->getObjectProperty(e.Name) : m_database->propertyByName(e.Name);
+            if (prop)
+            {
+                prop->get(e.Item, e.NewValue);
+            }
+            else
+            {
+                e.NewValue = e.OldValue;
+            }
+        }
+        segment << e;
+    }
+    m_pending.clear();
+    m_pending_properties.clear();
+
+    m_max_ids << maxid;
+    m_position = m_max_ids.size() - 1;
+}
+
+unsigned long sad::db::Journal::snapshotsCount() const
+{
+    return m_max_ids.size();
+}
+
+bool sad::db::Journal::restoreSnapshot(unsigned long index, unsigned long long& maxid)
+{
+    if (index >= m_max_ids.size())
+    {
+        return false;
+    }
+
+    m_replaying = true;
+    undoPending();
+    while(m_position > index)
+    {
+        --m_position;
+        sad::db::Journal::Segment& segment = m_segments[m_position];
+        for(size_t i = segment.size(); i > 0; i--)
+        {
+            apply(segment[i - 1], false);
+        }
+    }
+    while(m_position < index)
+    {
+        sad::db::Journal::Segment& segment = m_segments[m_position];
+        for(size_t i = 0; i < segment.size(); i++)
+        {
+            apply(segment[i], true);
+        }
+        ++m_position;
+    }
+    m_replaying = false;
+
+    maxid = m_max_ids[index];
+    return true;
+}
+
+size_t sad::db::Journal::entriesCount() const
+{
+    size_t result = m_pending.size();
+    for(size_t i = 0; i < m_segments.size(); i++)
+    {
+        result += m_segments[i].size();
+    }
+    return result;
+}
+
+void sad::db::Journal::clear()
+{
+    for(size_t i = 0; i < m_segments.size(); i++)
+    {
+        releaseSegment(m_segments[i]);
+    }
+    m_segments.clear();
+    releaseSegment(m_pending);
+    m_pending_properties.clear();
+    m_max_ids.clear();
+    m_position = 0;
+}
+
+// ===================================  PRIVATE METHODS ===================================
+
+void sad::db::Journal::retain(const sad::db::Journal::Entry& e)
+{
+    if (e.Item)
+    {
+        e.Item->addRef();
+    }
+    if (e.Container)
+    {
+        e.Container->addRef();
+    }
+}
+
+void sad::db::Journal::release(const sad::db::Journal::Entry& e)
+{
+    if (e.Item)
+    {
+        e.Item->delRef();
+    }
+    if (e.Container)
+    {
+        e.Container->delRef();
+    }
+}
+
+void sad::db::Journal::releaseSegment(sad::db::Journal::Segment& s)
+{
+    for(size_t i = 0; i < s.size(); i++)
+    {
+        release(s[i]);
+    }
+    s.clear();
+}
+
+void sad::db::Journal::addPending(const sad::db::Journal::Entry& e)
+{
+    retain(e);
+    m_pending << e;
+}
+
+void sad::db::Journal::apply(const sad::db::Journal::Entry& e, bool forward)
+{
+    switch(e.Type)
+    {
+        case sad::db::Journal::JET_PROPERTY_CHANGED:
+        {
+            sad::db::Property* prop = (e.Item) ? e.Item->getObjectProperty(e.Name) : m_database->propertyByName(e.Name);
+            if (prop)
+            {
+                prop->set(e.Item, (forward) ? e.NewValue : e.OldValue);
+            }
+            break;
+        }
+        case sad::db::Journal::JET_OBJECT_ADDED:
+        case sad::db::Journal::JET_OBJECT_REMOVED:
+        {
+            bool add = (e.Type == sad::db::Journal::JET_OBJECT_ADDED) == forward;
+            if (add)
+            {
+                if (e.Item->table() != e.Container)
+                {
+                    e.Container->add(e.Item);
+                }
+            }
+            else
+            {
+                if (e.Item->table() == e.Container)
+                {
+                    e.Container->remove(e.Item);
+                }
+            }
+            break;
+        }
+        case sad::db::Journal::JET_TABLE_ADDED:
+        case sad::db::Journal::JET_TABLE_REMOVED:
+        {
+            bool add = (e.Type == sad::db::Journal::JET_TABLE_ADDED) == forward;
+            if (add)
+            {
+                if (m_database->addTable(e.Name, e.Container))
+                {
+                    // Database drops major ids of objects, when removing table, so restore them
+                    sad::Vector<sad::db::Object*> objects;
+                    e.Container->objects(objects);
+                    for(size_t i = 0; i < objects.size(); i++)
+                    {
+                        m_database->trySetMaxMajorId(objects[i]->MajorId, e.Container);
+                    }
+                }
+            }
+            else
+            {
+                if (m_database->table(e.Name) == e.Container)
+                {
+                    m_database->removeTable(e.Name);
+                }
+            }
+            break;
+        }
+    }
+}
+
+void sad::db::Journal::undoPending()
+{
+    for(size_t i = m_pending.size(); i > 0; i--)
+    {
+        apply(m_pending[i - 1], false);
+    }
+    releaseSegment(m_pending);
+    m_pending_properties.clear();
+}
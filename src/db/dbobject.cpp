@@ -1,5 +1,6 @@
 #include "db/dbobject.h"
 #include "db/dbtable.h"
+#include "db/dbdatabase.h"
 #include "db/schema/schema.h"
 
 #include "db/dbproperty.h"
@@ -35,11 +36,46 @@ bool sad::db::Object::load(const picojson::value& v)
     sad::db::schema::Schema * schema = this->schema();
     if (schema)
     {
-        return schema->load(this, v);
+        this->beginLoading();
+        return this->finishLoading(schema->load(this, v));
     }
     return false;
 }
 
+void sad::db::Object::saveBinary(sad::db::BinaryWriter& w)
+{
+    w.writeString(this->serializableName());
+    size_t countposition = w.reserveUInt32();
+    unsigned int count = 0;
+    sad::db::schema::Schema * schema = this->schema();
+    if (schema)
+    {
+        count = schema->save(this, w);
+    }
+    w.writeUInt32At(countposition, count);
+}
+
+bool sad::db::Object::loadBinary(sad::db::BinaryReader& r, const sad::db::BinaryReader::Fields& fields)
+{
+    sad::db::schema::Schema * schema = this->schema();
+    if (schema)
+    {
+        this->beginLoading();
+        return this->finishLoading(schema->load(this, r, fields));
+    }
+    return false;
+}
+
+void sad::db::Object::beginLoading()
+{
+
+}
+
+bool sad::db::Object::finishLoading(bool loaded)
+{
+    return loaded;
+}
+
 sad::db::Table* sad::db::Object::table() const
 {
     return m_table;
@@ -125,6 +161,15 @@ sad::db::Property* sad::db::Object::getObjectProperty(const sad::String& s) cons
     return result;
 }
 
+void sad::db::Object::journalPropertyChange(const sad::String& s, sad::db::Property* prop)
+{
+    sad::db::Table* table = this->table();
+    if (table && table->database() && table->database()->journal())
+    {
+        table->database()->journal()->recordPropertyChange(this, s, prop);
+    }
+}
+
 bool sad::db::Object::isInstanceOf(const sad::String& name)
 {
     return this->serializableName() == name || name == "sad::db::Object";
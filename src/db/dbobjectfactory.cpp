@@ -97,7 +97,6 @@ sad::db::Object* sad::db::ObjectFactory::create(const sad::String& name)
 
 sad::db::Object* sad::db::ObjectFactory::createFromEntry(const picojson::value & v)
 {
-    sad::ScopedLock lock(&m_lock);
     const picojson::value * type = picojson::get_property(v, "type");
     const picojson::value * name = picojson::get_property(v, "name");
     sad::db::Object*  result = NULL;
@@ -111,24 +110,32 @@ sad::db::Object* sad::db::ObjectFactory::createFromEntry(const picojson::value &
         }
         if (maybetype.exists())
         {
-            if (maybename.exists() 
-                && maybetype.value() == "sad::db::custom::Object" 
-               )
-            {
-                if (m_special_custom_handlers.contains(maybename.value()))
-                {
-                    result =  m_special_custom_handlers[maybename.value()]->create();
-                }
-            }
-            if (result == NULL)
-            {
-                result = this->create(maybetype.value());
-            }
+            result = this->createByTypeAndName(maybetype.value(), maybename);
         }
     }
     return result;
 }
 
+sad::db::Object* sad::db::ObjectFactory::createByTypeAndName(const sad::String& type, const sad::Maybe<sad::String>& name)
+{
+    sad::ScopedLock lock(&m_lock);
+    sad::db::Object*  result = NULL;
+    if (name.exists() 
+        && type == "sad::db::custom::Object" 
+       )
+    {
+        if (m_special_custom_handlers.contains(name.value()))
+        {
+            result =  m_special_custom_handlers[name.value()]->create();
+        }
+    }
+    if (result == NULL)
+    {
+        result = this->create(type);
+    }
+    return result;
+}
+
 sad::db::ObjectFactory::~ObjectFactory()
 {
     
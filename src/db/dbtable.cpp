@@ -144,12 +144,21 @@ void sad::db::Table::add(sad::db::Object* a)
     LOG_TABLE_ADD_PRINTF("sad::db::Table::add::2C\n");
     a->setTable(this);
     LOG_TABLE_ADD_PRINTF("sad::db::Table::add::2D\n");
+    if (database() && database()->journal())
+    {
+        database()->journal()->recordObjectAdded(this, a);
+    }
 }
 
 void sad::db::Table::remove(sad::db::Object* a)
 {
     if (a)
     {
+        if (a->table() == this && database() && database()->journal())
+        {
+            database()->journal()->recordObjectRemoved(this, a);
+        }
+
         if (a->objectName().size() != 0)
         {
             if (m_object_by_name.contains(a->objectName()))
@@ -312,6 +321,97 @@ void sad::db::Table::save(picojson::value & v)
     }
 }
 
+bool sad::db::Table::loadBinary(
+    sad::db::BinaryReader& r,
+    sad::db::ObjectFactory* factory,
+    sad::Renderer* renderer,
+    const sad::String& treename
+)
+{
+    if (renderer == NULL)
+    {
+        renderer = sad::Renderer::ref();
+    }
+    unsigned int count = 0;
+    if (!r.readUInt32(count))
+    {
+        return false;
+    }
+    sad::Vector<sad::db::Object*> buffer;
+    sad::db::BinaryReader::Fields fields;
+    bool ok = true;
+    // Load items to buffer
+    for(unsigned int i = 0; i < count && ok; i++)
+    {
+        const sad::String* type = NULL;
+        ok = r.readString(type) && r.readFields(fields);
+        if (ok)
+        {
+            size_t end = r.position();
+            // A name is needed to create custom objects
+            sad::Maybe<sad::String> name;
+            const sad::db::BinaryReader::Field* namefield = r.findField(fields, "name");
+            if (namefield)
+            {
+                sad::db::Variant tmp(sad::String(""));
+                r.setPosition(namefield->Offset);
+                if (r.readValue(tmp))
+                {
+                    name.setValue(*static_cast<sad::String*>(tmp.data()));
+                }
+            }
+            sad::db::Object * o = factory->createByTypeAndName(*type, name);
+            if (!o)
+            {
+                ok = false;
+            }
+            else
+            {
+                o->setTreeName(renderer, treename);
+                ok = o->loadBinary(r, fields);
+                if (ok)
+                {
+                    buffer << o;
+                }
+                else
+                {
+                    delete o;
+                }
+            }
+            r.setPosition(end);
+        }
+    }
+    // Insert buffer to table, otherwise delete buffer
+    for(size_t i = 0; i < buffer.size(); i++)
+    {
+        if (ok)
+        {
+            add(buffer[i]);
+        }
+        else
+        {
+            delete buffer[i];
+        }
+    }
+    return ok;
+}
+
+void sad::db::Table::saveBinary(sad::db::BinaryWriter& w)
+{
+    sad::Vector<sad::db::Object*> result;
+    this->objects(result);
+    size_t countposition = w.reserveUInt32();
+    unsigned int count = 0;
+    for(size_t i = 0; i < result.size(); i++)
+    {
+        if (result[i]->Active)
+        {
+            result[i]->saveBinary(w);
+            ++count;
+        }
+    }
+    w.writeUInt32At(countposition, count);
+}
 
 sad::db::Database* sad::db::Table::database() const
 {
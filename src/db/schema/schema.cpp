@@ -175,6 +175,78 @@ void sad::db::schema::Schema::save(sad::db::Object * linked, picojson::value & v
     
 }
 
+bool sad::db::schema::Schema::load(
+    sad::db::Object * o,
+    sad::db::BinaryReader& r,
+    const sad::db::BinaryReader::Fields& fields
+)
+{
+    sad::ScopedLock locallock(&m_lock);
+
+    if (!o)
+    {
+        return false;
+    }
+    bool result = true;
+    for(size_t i = 0; i < m_parent.size() && result; i++)
+    {
+        result = result && m_parent[i]->load(o, r, fields);
+    }
+    for(sad::PtrHash<sad::String, sad::db::Property>::iterator it = m_properties.begin();
+        (it != m_properties.end()) && result;
+        ++it)
+    {
+        const sad::db::BinaryReader::Field* field = r.findField(fields, it.key());
+        if (field)
+        {
+            sad::db::Variant tmp;
+            it.value()->get(o, tmp);
+            r.setPosition(field->Offset);
+            result = r.readValue(tmp) && it.value()->set(o, tmp);
+        }
+        else
+        {
+            sad::db::Property* myprop = it.value();
+            if (myprop->hasDefaultValue())
+            {
+                myprop->set(o, *(myprop->defaultValue()));
+            } 
+            else
+            {
+                result = false;
+            }
+        }
+    }
+
+    return result;
+}
+
+unsigned int sad::db::schema::Schema::save(sad::db::Object * linked, sad::db::BinaryWriter& w)
+{
+    sad::ScopedLock locallock(&m_lock);
+
+    unsigned int result = 0;
+    if (!linked)
+    {
+        return result;
+    }
+    for(size_t i = 0; i < m_parent.size(); i++)
+    {
+        result += m_parent[i]->save(linked, w);
+    }
+    for(sad::PtrHash<sad::String, sad::db::Property>::iterator it = m_properties.begin();
+        it != m_properties.end();
+        ++it)
+    {
+        sad::db::Variant tmp;
+        it.value()->get(linked, tmp);
+        w.writeString(it.key());
+        w.writeValue(tmp);
+        ++result;
+    }
+    return result;
+}
+
 const sad::Vector<sad::db::schema::Schema*>& sad::db::schema::Schema::parent() const
 {
     return m_parent;
@@ -1,4 +1,6 @@
 #include "font.h"
+#include "renderer.h"
+#include "opengl.h"
 
 #ifdef WIN32
 #include <windows.h>
@@ -42,12 +44,5 @@ float sad::Font::builtinLineSpacing() const
 
 void sad::Font::setCurrentColor()
 {
-    glGetIntegerv(GL_CURRENT_COLOR,this->m_current_color_buffer);
-    glColor4ub(m_color.r(),m_color.g(),m_color.b(),255-m_color.a());
-}
-
-void sad::Font::restoreColor()
-{
-    //glPopAttrib();
-    glColor4iv(m_current_color_buffer);
+    sad::Renderer::ref()->opengl()->stateCache()->setColor(sad::AColor(m_color.r(),m_color.g(),m_color.b(),255-m_color.a()));
 }
\ No newline at end of file
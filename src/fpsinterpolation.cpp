@@ -1,11 +1,14 @@
 #include "fpsinterpolation.h"
 #include <iostream>
+#include <algorithm>
+#include <cmath>
 
 const double sad::FPSInterpolation::WarmupTime = 500;
 
 const double sad::FPSInterpolation::RegistrationTime = 500;
 
 sad::FPSInterpolation::FPSInterpolation()
+: m_frame_timer_started(false), m_frame_times_position(0), m_frame_times_capacity(300)
 {
     reset();
 }
@@ -21,6 +24,7 @@ void sad::FPSInterpolation::reset()
     m_setimmediately = true;
     m_reset =  false;
     m_frames = 0;
+    clearFrameTimes();
 }
 
 
@@ -74,3 +78,72 @@ double sad::FPSInterpolation::fps()
     return m_fps;
 }
 
+void sad::FPSInterpolation::frameFinished()
+{
+    m_frame_timer.stop();
+    if (m_frame_timer_started)
+    {
+        this->frameFinished(m_frame_timer.elapsed());
+    }
+    m_frame_timer.start();
+    m_frame_timer_started = true;
+}
+
+void sad::FPSInterpolation::frameFinished(double elapsed)
+{
+    if (m_frame_times.size() < m_frame_times_capacity)
+    {
+        m_frame_times << elapsed;
+    }
+    else
+    {
+        m_frame_times[m_frame_times_position] = elapsed;
+        m_frame_times_position = (m_frame_times_position + 1) % m_frame_times_capacity;
+    }
+}
+
+void sad::FPSInterpolation::resetFrameTimer()
+{
+    m_frame_timer.start();
+    m_frame_timer_started = true;
+}
+
+double sad::FPSInterpolation::frameTimePercentile(double percentile) const
+{
+    if (m_frame_times.size() == 0)
+    {
+        return 0;
+    }
+    percentile = std::min(std::max(percentile, 0.0), 100.0);
+    size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * m_frame_times.size()));
+    if (rank > 0)
+    {
+        --rank;
+    }
+    sad::Vector<double> times = m_frame_times;
+    std::nth_element(times.begin(), times.begin() + rank, times.end());
+    return times[rank];
+}
+
+size_t sad::FPSInterpolation::frameTimesCount() const
+{
+    return m_frame_times.size();
+}
+
+void sad::FPSInterpolation::setFrameTimesCapacity(size_t capacity)
+{
+    m_frame_times_capacity = std::max(capacity, static_cast<size_t>(1));
+    clearFrameTimes();
+}
+
+size_t sad::FPSInterpolation::frameTimesCapacity() const
+{
+    return m_frame_times_capacity;
+}
+
+void sad::FPSInterpolation::clearFrameTimes()
+{
+    m_frame_times.clear();
+    m_frame_times_position = 0;
+    m_frame_timer_started = false;
+}
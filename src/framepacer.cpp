@@ -0,0 +1,136 @@
+#include "framepacer.h"
+#include "sadsleep.h"
+
+#include <algorithm>
+
+sad::FramePacer::FramePacer()
+: m_target_fps(60),
+m_strategy(sad::FramePacer::FPS_UNLIMITED),
+m_spin_time(2),
+m_idle_waiting(false),
+m_max_idle_wait_time(100),
+m_vsync_enabled(false),
+m_lag(0)
+{
+
+}
+
+sad::FramePacer::~FramePacer()
+{
+
+}
+
+void sad::FramePacer::setTargetFPS(double fps)
+{
+    m_target_fps = fps;
+}
+
+double sad::FramePacer::targetFPS() const
+{
+    return m_target_fps;
+}
+
+void sad::FramePacer::setStrategy(sad::FramePacer::Strategy strategy)
+{
+    m_strategy = strategy;
+}
+
+sad::FramePacer::Strategy sad::FramePacer::strategy() const
+{
+    return m_strategy;
+}
+
+void sad::FramePacer::setSpinTime(double ms)
+{
+    m_spin_time = std::max(ms, 0.0);
+}
+
+double sad::FramePacer::spinTime() const
+{
+    return m_spin_time;
+}
+
+void sad::FramePacer::setIdleWaiting(bool enabled)
+{
+    m_idle_waiting = enabled;
+}
+
+bool sad::FramePacer::idleWaiting() const
+{
+    return m_idle_waiting;
+}
+
+void sad::FramePacer::setMaxIdleWaitTime(unsigned int ms)
+{
+    m_max_idle_wait_time = ms;
+}
+
+unsigned int sad::FramePacer::maxIdleWaitTime() const
+{
+    return m_max_idle_wait_time;
+}
+
+void sad::FramePacer::setVSyncEnabled(bool enabled)
+{
+    m_vsync_enabled = enabled;
+}
+
+bool sad::FramePacer::vsyncEnabled() const
+{
+    return m_vsync_enabled;
+}
+
+bool sad::FramePacer::waitsWithTimer() const
+{
+    if (m_target_fps <= 0)
+    {
+        return false;
+    }
+    return m_strategy == sad::FramePacer::FPS_TIMER
+        || (m_strategy == sad::FramePacer::FPS_VSYNC && !m_vsync_enabled);
+}
+
+double sad::FramePacer::frameTime() const
+{
+    if (m_target_fps <= 0)
+    {
+        return 0;
+    }
+    return 1000.0 / m_target_fps;
+}
+
+void sad::FramePacer::reset()
+{
+    m_lag = 0;
+    m_timer.start();
+}
+
+void sad::FramePacer::waitForNextFrame()
+{
+    if (!waitsWithTimer())
+    {
+        m_timer.start();
+        return;
+    }
+
+    double frametime = this->frameTime();
+    double budget = frametime - m_lag;
+    m_timer.stop();
+    double elapsed = m_timer.elapsed();
+    // Sleep is coarse and could oversleep, so stop sleeping before end of frame
+    while (budget - elapsed - m_spin_time >= 1.0)
+    {
+        sad::sleep(static_cast<unsigned int>(budget - elapsed - m_spin_time));
+        m_timer.stop();
+        elapsed = m_timer.elapsed();
+    }
+    // Spin rest of frame
+    while (elapsed < budget)
+    {
+        m_timer.stop();
+        elapsed = m_timer.elapsed();
+    }
+    m_timer.start();
+    // Long frames are not compensated by shortening next ones more, than a frame
+    m_lag = std::min(elapsed - budget, frametime);
+}
@@ -8,6 +8,7 @@
 #include "p2d/axle.h"
 
 #include <limits>
+#include <algorithm>
 
 bool sad::projectionIsWithin(const sad::Point2D & test, const sad::Point2D & pivot1, const sad::Point2D & pivot2)
 {
@@ -302,3 +303,30 @@ bool sad::isAABB(const sad::Rect2D& rect)
               && sad::is_fuzzy_equal(rect[2].y() , rect[3].y());
     return valid;
 }
+
+sad::Rect2D sad::boundingBox(const sad::Rect2D& rect)
+{
+    sad::Rect2D result(rect[0], rect[0]);
+    sad::extendBoundingBox(result, rect);
+    return result;
+}
+
+void sad::extendBoundingBox(sad::Rect2D& box, const sad::Rect2D& rect)
+{
+    double minx = box[0].x(), miny = box[0].y();
+    double maxx = box[2].x(), maxy = box[2].y();
+    for(int i = 0; i < 4; i++)
+    {
+        minx = std::min(minx, rect[i].x());
+        miny = std::min(miny, rect[i].y());
+        maxx = std::max(maxx, rect[i].x());
+        maxy = std::max(maxy, rect[i].y());
+    }
+    box = sad::Rect2D(minx, miny, maxx, maxy);
+}
+
+bool sad::collidesAABB(const sad::Rect2D& a, const sad::Rect2D& b)
+{
+    return a[0].x() <= b[2].x() && b[0].x() <= a[2].x()
+        && a[0].y() <= b[2].y() && b[0].y() <= a[2].y();
+}
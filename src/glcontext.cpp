@@ -23,6 +23,11 @@ void sad::GLContext::swapBuffers()
     m_dptr->swapBuffers();
 }
 
+bool sad::GLContext::setSwapInterval(int interval)
+{
+    return m_dptr->setSwapInterval(interval);
+}
+
 sad::Point3D sad::GLContext::mapToViewport(const sad::Point2D & p, bool ztest)
 {
     return m_dptr->mapToViewport(p, ztest);
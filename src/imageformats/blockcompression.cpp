@@ -0,0 +1,463 @@
+#include "imageformats/blockcompression.h"
+
+#include <cstring>
+
+// ============================================================ COLOR HELPERS ============================================================
+
+/*! Packs 8-bit color to R5G6B5 value
+    \param[in] c a color
+    \return packed value
+ */
+inline static unsigned short bc_pack565(const int* c)
+{
+    int r = (c[0] * 31 + 127) / 255;
+    int g = (c[1] * 63 + 127) / 255;
+    int b = (c[2] * 31 + 127) / 255;
+    return static_cast<unsigned short>((r << 11) | (g << 5) | b);
+}
+
+/*! Unpacks R5G6B5 value to 8-bit color
+    \param[in] v a packed value
+    \param[out] c a color
+ */
+inline static void bc_unpack565(unsigned short v, int* c)
+{
+    int r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+    c[0] = (r << 3) | (r >> 2);
+    c[1] = (g << 2) | (g >> 4);
+    c[2] = (b << 3) | (b >> 2);
+    c[3] = 255;
+}
+
+/*! Builds palette of color block from its endpoints
+    \param[in] c0 first endpoint
+    \param[in] c1 second endpoint
+    \param[in] four_colors whether block uses four colors even if c0 <= c1, as in BC3
+    \param[out] palette a palette of four colors
+ */
+static void bc_color_palette(unsigned short c0, unsigned short c1, bool four_colors, int palette[4][4])
+{
+    bc_unpack565(c0, palette[0]);
+    bc_unpack565(c1, palette[1]);
+    if (c0 > c1 || four_colors)
+    {
+        for(int k = 0; k < 3; k++)
+        {
+            palette[2][k] = (2 * palette[0][k] + palette[1][k]) / 3;
+            palette[3][k] = (palette[0][k] + 2 * palette[1][k]) / 3;
+        }
+        palette[2][3] = 255;
+        palette[3][3] = 255;
+    }
+    else
+    {
+        for(int k = 0; k < 3; k++)
+        {
+            palette[2][k] = (palette[0][k] + palette[1][k]) / 2;
+            palette[3][k] = 0;
+        }
+        palette[2][3] = 255;
+        palette[3][3] = 0;
+    }
+}
+
+/*! Builds palette of alpha block from its endpoints
+    \param[in] a0 first endpoint
+    \param[in] a1 second endpoint
+    \param[out] palette a palette of eight values
+ */
+static void bc_alpha_palette(int a0, int a1, int palette[8])
+{
+    palette[0] = a0;
+    palette[1] = a1;
+    if (a0 > a1)
+    {
+        for(int i = 1; i < 7; i++)
+        {
+            palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+        }
+    }
+    else
+    {
+        for(int i = 1; i < 5; i++)
+        {
+            palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+/*! Returns squared distance between colors
+    \param[in] a first color
+    \param[in] b second color
+    \return distance
+ */
+inline static int bc_distance(const int* a, const sad::uchar* b)
+{
+    int dr = a[0] - b[0], dg = a[1] - b[1], db = a[2] - b[2];
+    return dr * dr + dg * dg + db * db;
+}
+
+// ============================================================ BLOCK ENCODING ============================================================
+
+/*! Encodes color of block of 16 pixels. Endpoints are chosen along principal axis of colors
+    \param[in] block a pixels of block in 32-bit RGBA
+    \param[in] bc3 whether block is part of BC3 block, so alpha is stored separately
+    \param[out] out 8 bytes of encoded block
+ */
+static void bc_encode_color(const sad::uchar* block, bool bc3, sad::uchar* out)
+{
+    bool transparent[16];
+    bool has_transparent = false;
+    int opaque = 0;
+    double mean[3] = { 0, 0, 0 };
+    int lower[3] = { 255, 255, 255 };
+    int upper[3] = { 0, 0, 0 };
+    for(int i = 0; i < 16; i++)
+    {
+        transparent[i] = !bc3 && block[i * 4 + 3] < 128;
+        has_transparent = has_transparent || transparent[i];
+        if (!transparent[i])
+        {
+            for(int k = 0; k < 3; k++)
+            {
+                int c = block[i * 4 + k];
+                mean[k] += c;
+                lower[k] = (c < lower[k]) ? c : lower[k];
+                upper[k] = (c > upper[k]) ? c : upper[k];
+            }
+            ++opaque;
+        }
+    }
+    if (opaque == 0)
+    {
+        memset(out, 0, 4);
+        memset(out + 4, 0xFF, 4);
+        return;
+    }
+    for(int k = 0; k < 3; k++)
+    {
+        mean[k] /= opaque;
+    }
+    // Find principal axis with power iteration over covariance matrix
+    double cov[3][3] = { { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 } };
+    for(int i = 0; i < 16; i++)
+    {
+        if (transparent[i])
+        {
+            continue;
+        }
+        double d[3];
+        for(int k = 0; k < 3; k++)
+        {
+            d[k] = block[i * 4 + k] - mean[k];
+        }
+        for(int a = 0; a < 3; a++)
+        {
+            for(int b = 0; b < 3; b++)
+            {
+                cov[a][b] += d[a] * d[b];
+            }
+        }
+    }
+    // Iteration starts from row of covariance matrix with largest norm, since a fixed vector
+    // like grey axis could be orthogonal to colors of block (e.g. red and green) and vanish.
+    // If all rows vanish, colors are the same and diagonal of bounding box is used
+    double axis[3];
+    for(int k = 0; k < 3; k++)
+    {
+        axis[k] = static_cast<double>(upper[k] - lower[k]);
+    }
+    double best_norm = 1.0e-9;
+    for(int a = 0; a < 3; a++)
+    {
+        double norm = cov[a][0] * cov[a][0] + cov[a][1] * cov[a][1] + cov[a][2] * cov[a][2];
+        if (norm > best_norm)
+        {
+            best_norm = norm;
+            for(int b = 0; b < 3; b++)
+            {
+                axis[b] = cov[a][b];
+            }
+        }
+    }
+    for(int iteration = 0; iteration < 8; iteration++)
+    {
+        double next[3];
+        double max = 0;
+        for(int a = 0; a < 3; a++)
+        {
+            next[a] = cov[a][0] * axis[0] + cov[a][1] * axis[1] + cov[a][2] * axis[2];
+            max = (next[a] > max) ? next[a] : ((-next[a] > max) ? -next[a] : max);
+        }
+        if (max < 1.0e-9)
+        {
+            break;
+        }
+        for(int a = 0; a < 3; a++)
+        {
+            axis[a] = next[a] / max;
+        }
+    }
+    // Use pixels with extreme projections as endpoints
+    int imin = -1, imax = -1;
+    double pmin = 0, pmax = 0;
+    for(int i = 0; i < 16; i++)
+    {
+        if (transparent[i])
+        {
+            continue;
+        }
+        double p = block[i * 4] * axis[0] + block[i * 4 + 1] * axis[1] + block[i * 4 + 2] * axis[2];
+        if (imin < 0 || p < pmin)
+        {
+            imin = i;
+            pmin = p;
+        }
+        if (imax < 0 || p > pmax)
+        {
+            imax = i;
+            pmax = p;
+        }
+    }
+    int cmin[3] = { block[imin * 4], block[imin * 4 + 1], block[imin * 4 + 2] };
+    int cmax[3] = { block[imax * 4], block[imax * 4 + 1], block[imax * 4 + 2] };
+    unsigned short c0 = bc_pack565(cmax);
+    unsigned short c1 = bc_pack565(cmin);
+    // Three-color mode is needed for transparent pixels, it's selected by c0 <= c1
+    bool three_colors = has_transparent;
+    if ((three_colors && c0 > c1) || (!three_colors && c0 < c1))
+    {
+        unsigned short tmp = c0;
+        c0 = c1;
+        c1 = tmp;
+    }
+
+    int palette[4][4];
+    bc_color_palette(c0, c1, bc3, palette);
+    unsigned int indexes = 0;
+    if (c0 != c1 || three_colors)
+    {
+        int candidates = (three_colors) ? 3 : 4;
+        for(int i = 0; i < 16; i++)
+        {
+            unsigned int index = 3;
+            if (!transparent[i])
+            {
+                int best = bc_distance(palette[0], block + i * 4);
+                index = 0;
+                for(int j = 1; j < candidates; j++)
+                {
+                    int d = bc_distance(palette[j], block + i * 4);
+                    if (d < best)
+                    {
+                        best = d;
+                        index = j;
+                    }
+                }
+            }
+            indexes |= index << (2 * i);
+        }
+    }
+    out[0] = static_cast<sad::uchar>(c0 & 0xFF);
+    out[1] = static_cast<sad::uchar>(c0 >> 8);
+    out[2] = static_cast<sad::uchar>(c1 & 0xFF);
+    out[3] = static_cast<sad::uchar>(c1 >> 8);
+    for(int i = 0; i < 4; i++)
+    {
+        out[4 + i] = static_cast<sad::uchar>((indexes >> (8 * i)) & 0xFF);
+    }
+}
+
+/*! Encodes alpha of block of 16 pixels, using eight interpolated values between minimum and maximum
+    \param[in] block a pixels of block in 32-bit RGBA
+    \param[out] out 8 bytes of encoded block
+ */
+static void bc_encode_alpha(const sad::uchar* block, sad::uchar* out)
+{
+    int a0 = 0, a1 = 255;
+    for(int i = 0; i < 16; i++)
+    {
+        int a = block[i * 4 + 3];
+        a0 = (a > a0) ? a : a0;
+        a1 = (a < a1) ? a : a1;
+    }
+    int palette[8];
+    bc_alpha_palette(a0, a1, palette);
+    unsigned long long indexes = 0;
+    if (a0 != a1)
+    {
+        for(int i = 0; i < 16; i++)
+        {
+            int a = block[i * 4 + 3];
+            unsigned long long index = 0;
+            int best = 256;
+            for(int j = 0; j < 8; j++)
+            {
+                int d = (a > palette[j]) ? (a - palette[j]) : (palette[j] - a);
+                if (d < best)
+                {
+                    best = d;
+                    index = j;
+                }
+            }
+            indexes |= index << (3 * i);
+        }
+    }
+    out[0] = static_cast<sad::uchar>(a0);
+    out[1] = static_cast<sad::uchar>(a1);
+    for(int i = 0; i < 6; i++)
+    {
+        out[2 + i] = static_cast<sad::uchar>((indexes >> (8 * i)) & 0xFF);
+    }
+}
+
+// ============================================================ BLOCK DECODING ============================================================
+
+/*! Decodes color of block of 16 pixels
+    \param[in] in 8 bytes of encoded block
+    \param[in] bc3 whether block is part of BC3 block, so alpha is stored separately
+    \param[out] block a pixels of block in 32-bit RGBA
+ */
+static void bc_decode_color(const sad::uchar* in, bool bc3, sad::uchar* block)
+{
+    unsigned short c0 = static_cast<unsigned short>(in[0] | (in[1] << 8));
+    unsigned short c1 = static_cast<unsigned short>(in[2] | (in[3] << 8));
+    int palette[4][4];
+    bc_color_palette(c0, c1, bc3, palette);
+    unsigned int indexes = in[4] | (in[5] << 8) | (in[6] << 16) | (static_cast<unsigned int>(in[7]) << 24);
+    for(int i = 0; i < 16; i++)
+    {
+        const int* c = palette[(indexes >> (2 * i)) & 3];
+        for(int k = 0; k < 4; k++)
+        {
+            block[i * 4 + k] = static_cast<sad::uchar>(c[k]);
+        }
+    }
+}
+
+/*! Decodes alpha of block of 16 pixels
+    \param[in] in 8 bytes of encoded block
+    \param[out] block a pixels of block in 32-bit RGBA, where alpha is stored
+ */
+static void bc_decode_alpha(const sad::uchar* in, sad::uchar* block)
+{
+    int palette[8];
+    bc_alpha_palette(in[0], in[1], palette);
+    unsigned long long indexes = 0;
+    for(int i = 0; i < 6; i++)
+    {
+        indexes |= static_cast<unsigned long long>(in[2 + i]) << (8 * i);
+    }
+    for(int i = 0; i < 16; i++)
+    {
+        block[i * 4 + 3] = static_cast<sad::uchar>(palette[(indexes >> (3 * i)) & 7]);
+    }
+}
+
+// ============================================================ PUBLIC METHODS ============================================================
+
+bool sad::imageformats::BlockCompression::isCompressed(sad::Texture::InternalFormat format)
+{
+    return format == sad::Texture::SFT_BC1 || format == sad::Texture::SFT_BC3;
+}
+
+size_t sad::imageformats::BlockCompression::blockSize(sad::Texture::InternalFormat format)
+{
+    switch(format)
+    {
+    case sad::Texture::SFT_BC1: return 8;
+    case sad::Texture::SFT_BC3: return 16;
+    default: break;
+    };
+    return 0;
+}
+
+size_t sad::imageformats::BlockCompression::compressedSize(unsigned int width, unsigned int height, sad::Texture::InternalFormat format)
+{
+    size_t blocks = static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4);
+    return blocks * sad::imageformats::BlockCompression::blockSize(format);
+}
+
+bool sad::imageformats::BlockCompression::compress(
+    const sad::uchar* pixels,
+    unsigned int width,
+    unsigned int height,
+    sad::Texture::InternalFormat format,
+    sad::uchar* blocks
+)
+{
+    if (!sad::imageformats::BlockCompression::isCompressed(format) || width == 0 || height == 0)
+    {
+        return false;
+    }
+    bool bc3 = (format == sad::Texture::SFT_BC3);
+    sad::uchar block[16 * 4];
+    for(unsigned int by = 0; by < height; by += 4)
+    {
+        for(unsigned int bx = 0; bx < width; bx += 4)
+        {
+            for(unsigned int y = 0; y < 4; y++)
+            {
+                unsigned int sy = (by + y < height) ? (by + y) : (height - 1);
+                for(unsigned int x = 0; x < 4; x++)
+                {
+                    unsigned int sx = (bx + x < width) ? (bx + x) : (width - 1);
+                    memcpy(block + (y * 4 + x) * 4, pixels + (static_cast<size_t>(sy) * width + sx) * 4, 4);
+                }
+            }
+            if (bc3)
+            {
+                bc_encode_alpha(block, blocks);
+                bc_encode_color(block, true, blocks + 8);
+                blocks += 16;
+            }
+            else
+            {
+                bc_encode_color(block, false, blocks);
+                blocks += 8;
+            }
+        }
+    }
+    return true;
+}
+
+bool sad::imageformats::BlockCompression::decompress(
+    const sad::uchar* blocks,
+    unsigned int width,
+    unsigned int height,
+    sad::Texture::InternalFormat format,
+    sad::uchar* pixels
+)
+{
+    if (!sad::imageformats::BlockCompression::isCompressed(format))
+    {
+        return false;
+    }
+    bool bc3 = (format == sad::Texture::SFT_BC3);
+    sad::uchar block[16 * 4];
+    for(unsigned int by = 0; by < height; by += 4)
+    {
+        for(unsigned int bx = 0; bx < width; bx += 4)
+        {
+            if (bc3)
+            {
+                bc_decode_color(blocks + 8, true, block);
+                bc_decode_alpha(blocks, block);
+                blocks += 16;
+            }
+            else
+            {
+                bc_decode_color(blocks, false, block);
+                blocks += 8;
+            }
+            for(unsigned int y = 0; y < 4 && by + y < height; y++)
+            {
+                unsigned int count = (bx + 4 <= width) ? 4 : (width - bx);
+                memcpy(pixels + (static_cast<size_t>(by + y) * width + bx) * 4, block + y * 16, count * 4);
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,176 @@
+#include "imageformats/compressedstorageloader.h"
+#include "imageformats/blockcompression.h"
+
+#include "os/mappedfileimpl.h"
+
+#include "texture.h"
+
+#define TAR7Z_SADDY
+
+#include "3rdparty/tar7z/include/tar.h"
+
+#include <cstring>
+
+const unsigned int maxcompressedtexturesize = 16384;
+
+/*! A size of width and height in header
+ */
+const int compressedsizeheadersize = 8;
+
+sad::imageformats::CompressedStorageLoader::CompressedStorageLoader(const sad::imageformats::CompressedStorageLoader::Settings& settings) : m_settings(settings)
+{
+
+}
+
+bool sad::imageformats::CompressedStorageLoader::load(FILE * file, sad::Texture * texture)
+{
+    // Exit on invalid input data
+    if (!file || !texture)
+    {
+        return false;
+    }
+
+    const int headersize = m_settings.SignatureSize + compressedsizeheadersize;
+    sad::Vector<sad::uchar> header;
+    header.resize(headersize);
+
+    // Exit if unable to read header or signature is invalid
+    if (fread(&(header[0]), headersize, 1, file) != 1
+        || memcmp(&(header[0]), m_settings.Signature, m_settings.SignatureSize) != 0)
+    {
+        return false;
+    }
+
+    unsigned int width = 0, height = 0;
+    if (!readSize(&(header[m_settings.SignatureSize]), width, height))
+    {
+        return false;
+    }
+
+    sad::Texture::InternalFormat format = static_cast<sad::Texture::InternalFormat>(m_settings.Format);
+    size_t buffersize = sad::imageformats::BlockCompression::compressedSize(width, height, format);
+
+    // Map file into memory, if requested, so blocks are read from page cache without copying them
+    long offset = ftell(file);
+    sad::os::MappedFileImpl* mapped = new sad::os::MappedFileImpl();
+    if (texture->MapFile && offset >= 0 && mapped->map(file) && mapped->size() >= static_cast<size_t>(offset) + buffersize)
+    {
+        texture->width() = width;
+        texture->height() = height;
+        texture->bpp() = static_cast<sad::uchar>(m_settings.Bpp);
+        texture->Format = format;
+        delete texture->Buffer;
+        sad::Texture::MappedFileBuffer* buf = new sad::Texture::MappedFileBuffer();
+        buf->File = mapped;
+        buf->Offset = static_cast<size_t>(offset);
+        texture->Buffer = buf;
+        return true;
+    }
+    delete mapped;
+
+    sad::Texture::DefaultBuffer* newbuffer = new sad::Texture::DefaultBuffer();
+    newbuffer->Data.resize(buffersize);
+    if (fread(&(newbuffer->Data[0]), buffersize, 1, file) != 1)
+    {
+        delete newbuffer;
+        return false;
+    }
+    texture->width() = width;
+    texture->height() = height;
+    texture->bpp() = static_cast<sad::uchar>(m_settings.Bpp);
+    texture->Format = format;
+    delete texture->Buffer;
+    texture->Buffer = newbuffer;
+
+    return true;
+}
+
+bool sad::imageformats::CompressedStorageLoader::load(tar7z::Entry* entry, sad::Texture* texture)
+{
+    if (entry == NULL || texture == NULL)
+        return false;
+
+    const char* buffer = entry->contents();
+
+    const int headersize = m_settings.SignatureSize + compressedsizeheadersize;
+
+    // Exit if signature is invalid
+    if (entry->Size < headersize || memcmp(buffer, m_settings.Signature, m_settings.SignatureSize) != 0)
+    {
+        return false;
+    }
+
+    unsigned int width = 0, height = 0;
+    if (!readSize(reinterpret_cast<const sad::uchar*>(buffer) + m_settings.SignatureSize, width, height))
+    {
+        return false;
+    }
+
+    // Exit on insufficient space
+    sad::Texture::InternalFormat format = static_cast<sad::Texture::InternalFormat>(m_settings.Format);
+    size_t buffersize = sad::imageformats::BlockCompression::compressedSize(width, height, format);
+    if (buffersize + headersize > entry->Size)
+    {
+        return false;
+    }
+
+    texture->width() = width;
+    texture->height() = height;
+    texture->bpp() = static_cast<sad::uchar>(m_settings.Bpp);
+    texture->Format = format;
+    delete texture->Buffer;
+    sad::Texture::Tar7zArchiveBuffer* buf = new sad::Texture::Tar7zArchiveBuffer();
+    buf->Archive = entry->Parent;
+    buf->Offset = entry->Offset + headersize;
+    texture->Buffer = buf;
+
+    return true;
+}
+
+bool sad::imageformats::CompressedStorageLoader::save(FILE* file, const sad::Texture* texture)
+{
+    if (!file || !texture || !(texture->Buffer))
+    {
+        return false;
+    }
+    if (static_cast<unsigned int>(texture->Format) != m_settings.Format
+        || texture->width() == 0 || texture->height() == 0
+        || texture->width() > maxcompressedtexturesize || texture->height() > maxcompressedtexturesize)
+    {
+        return false;
+    }
+    sad::uchar size[compressedsizeheadersize];
+    for(int i = 0; i < 4; i++)
+    {
+        size[i] = static_cast<sad::uchar>((texture->width() >> (8 * i)) & 0xFF);
+        size[4 + i] = static_cast<sad::uchar>((texture->height() >> (8 * i)) & 0xFF);
+    }
+    size_t buffersize = sad::imageformats::BlockCompression::compressedSize(texture->width(), texture->height(), texture->Format);
+    return fwrite(m_settings.Signature, m_settings.SignatureSize, 1, file) == 1
+        && fwrite(size, compressedsizeheadersize, 1, file) == 1
+        && fwrite(texture->data(), buffersize, 1, file) == 1;
+}
+
+sad::imageformats::CompressedStorageLoader::~CompressedStorageLoader()
+{
+
+}
+
+bool sad::imageformats::CompressedStorageLoader::readSize(const sad::uchar* header, unsigned int& width, unsigned int& height)
+{
+    width = 0;
+    height = 0;
+    for(int i = 0; i < 4; i++)
+    {
+        width |= static_cast<unsigned int>(header[i]) << (8 * i);
+        height |= static_cast<unsigned int>(header[4 + i]) << (8 * i);
+    }
+    return width != 0 && height != 0 && width <= maxcompressedtexturesize && height <= maxcompressedtexturesize;
+}
+
+const sad::uchar SBC1signature[]     =  {'S', 'B', 'C', '1'};
+
+const sad::uchar SBC3signature[]     =  {'S', 'B', 'C', '3'};
+
+sad::imageformats::CompressedStorageLoader::Settings sad::imageformats::CompressedStorageLoader::SBC1Settings(SBC1signature, 4, 4, sad::Texture::SFT_BC1);
+sad::imageformats::CompressedStorageLoader::Settings sad::imageformats::CompressedStorageLoader::SBC3Settings(SBC3signature, 4, 8, sad::Texture::SFT_BC3);
@@ -0,0 +1,667 @@
+#include "imageformats/mipchain.h"
+
+#include <cstring>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define SAD_MIPCHAIN_SSE2
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define SAD_MIPCHAIN_NEON
+    #include <arm_neon.h>
+#endif
+
+#ifndef M_PI
+    #define M_PI (3.14159265358979323846)
+#endif
+
+// ============================================================ PIXEL OPERATIONS ============================================================
+
+/*! A radius of Kaiser filter in pixels of source level
+ */
+#define MIPCHAIN_KAISER_RADIUS (3.0)
+/*! An alpha parameter of Kaiser window
+ */
+#define MIPCHAIN_KAISER_ALPHA (4.0)
+
+#if defined(SAD_MIPCHAIN_SSE2)
+
+/*! A pixel with four float components, used when filtering
+ */
+typedef __m128 mipchain_pixel;
+
+inline static mipchain_pixel mipchain_zero()
+{
+    return _mm_setzero_ps();
+}
+
+inline static mipchain_pixel mipchain_load(const sad::uchar* p)
+{
+    int v;
+    memcpy(&v, p, 4);
+    __m128i zero = _mm_setzero_si128();
+    __m128i i = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(v), zero), zero);
+    return _mm_cvtepi32_ps(i);
+}
+
+inline static mipchain_pixel mipchain_load(const float* p)
+{
+    return _mm_loadu_ps(p);
+}
+
+inline static mipchain_pixel mipchain_madd(mipchain_pixel acc, mipchain_pixel v, float w)
+{
+    return _mm_add_ps(acc, _mm_mul_ps(v, _mm_set1_ps(w)));
+}
+
+inline static void mipchain_store(float* p, mipchain_pixel v)
+{
+    _mm_storeu_ps(p, v);
+}
+
+inline static void mipchain_store(sad::uchar* p, mipchain_pixel v)
+{
+    // Conversion rounds to nearest, packing saturates to [0, 255]
+    __m128i i = _mm_cvtps_epi32(v);
+    i = _mm_packs_epi32(i, i);
+    i = _mm_packus_epi16(i, i);
+    int r = _mm_cvtsi128_si32(i);
+    memcpy(p, &r, 4);
+}
+
+#elif defined(SAD_MIPCHAIN_NEON)
+
+/*! A pixel with four float components, used when filtering
+ */
+typedef float32x4_t mipchain_pixel;
+
+inline static mipchain_pixel mipchain_zero()
+{
+    return vdupq_n_f32(0.0f);
+}
+
+inline static mipchain_pixel mipchain_load(const sad::uchar* p)
+{
+    uint32_t v;
+    memcpy(&v, p, 4);
+    uint8x8_t b = vreinterpret_u8_u32(vdup_n_u32(v));
+    uint32x4_t i = vmovl_u16(vget_low_u16(vmovl_u8(b)));
+    return vcvtq_f32_u32(i);
+}
+
+inline static mipchain_pixel mipchain_load(const float* p)
+{
+    return vld1q_f32(p);
+}
+
+inline static mipchain_pixel mipchain_madd(mipchain_pixel acc, mipchain_pixel v, float w)
+{
+    return vmlaq_n_f32(acc, v, w);
+}
+
+inline static void mipchain_store(float* p, mipchain_pixel v)
+{
+    vst1q_f32(p, v);
+}
+
+inline static void mipchain_store(sad::uchar* p, mipchain_pixel v)
+{
+    v = vmaxq_f32(vminq_f32(v, vdupq_n_f32(255.0f)), vdupq_n_f32(0.0f));
+    v = vaddq_f32(v, vdupq_n_f32(0.5f));
+    uint16x4_t h = vmovn_u32(vcvtq_u32_f32(v));
+    uint8x8_t b = vmovn_u16(vcombine_u16(h, h));
+    uint32_t r = vget_lane_u32(vreinterpret_u32_u8(b), 0);
+    memcpy(p, &r, 4);
+}
+
+#else
+
+/*! A pixel with four float components, used when filtering
+ */
+struct mipchain_pixel
+{
+    float V[4]; //!< Components of pixel
+};
+
+inline static mipchain_pixel mipchain_zero()
+{
+    mipchain_pixel result = { { 0.0f, 0.0f, 0.0f, 0.0f } };
+    return result;
+}
+
+inline static mipchain_pixel mipchain_load(const sad::uchar* p)
+{
+    mipchain_pixel result = { { p[0], p[1], p[2], p[3] } };
+    return result;
+}
+
+inline static mipchain_pixel mipchain_load(const float* p)
+{
+    mipchain_pixel result = { { p[0], p[1], p[2], p[3] } };
+    return result;
+}
+
+inline static mipchain_pixel mipchain_madd(mipchain_pixel acc, mipchain_pixel v, float w)
+{
+    for(int i = 0; i < 4; i++)
+    {
+        acc.V[i] += v.V[i] * w;
+    }
+    return acc;
+}
+
+inline static void mipchain_store(float* p, mipchain_pixel v)
+{
+    memcpy(p, v.V, 4 * sizeof(float));
+}
+
+inline static void mipchain_store(sad::uchar* p, mipchain_pixel v)
+{
+    for(int i = 0; i < 4; i++)
+    {
+        float c = floor(v.V[i] + 0.5f);
+        p[i] = static_cast<sad::uchar>((c < 0.0f) ? 0.0f : ((c > 255.0f) ? 255.0f : c));
+    }
+}
+
+#endif
+
+// ============================================================ CONVERSIONS ============================================================
+
+/*! Returns amount of bytes per pixel for texture
+    \param[in] bpp bits per pixel
+    \return bytes per pixel
+ */
+inline static unsigned int mipchain_pixel_size(unsigned int bpp)
+{
+    return bpp / 8;
+}
+
+/*! Tests, whether format is supported by chain
+    \param[in] bpp bits per pixel
+    \param[in] format a format
+    \return whether it's supported
+ */
+static bool mipchain_is_supported(unsigned int bpp, sad::Texture::InternalFormat format)
+{
+    switch(format)
+    {
+    case sad::Texture::SFT_R8_G8_B8_A8: return bpp == 24 || bpp == 32;
+    case sad::Texture::SFT_R5_G6_B5:
+    case sad::Texture::SFT_R4_G4_B4_A4: return bpp == 16;
+    case sad::Texture::SFT_R3_G3_B2: return bpp == 8;
+    default: break;
+    };
+    return false;
+}
+
+/*! Expands a component with specified amount of bits to 8 bits
+    \param[in] v value
+    \param[in] bits amount of bits
+    \return value
+ */
+inline static sad::uchar mipchain_expand(unsigned int v, unsigned int bits)
+{
+    unsigned int max = (1 << bits) - 1;
+    return static_cast<sad::uchar>((v * 255 + max / 2) / max);
+}
+
+/*! Reduces 8-bit component to specified amount of bits
+    \param[in] v value
+    \param[in] bits amount of bits
+    \return value
+ */
+inline static unsigned int mipchain_reduce(sad::uchar v, unsigned int bits)
+{
+    unsigned int max = (1 << bits) - 1;
+    return (v * max + 127) / 255;
+}
+
+/*! Converts pixels of texture to 32-bit RGBA pixels
+    \param[in] pixels a source pixels
+    \param[in] count amount of pixels
+    \param[in] bpp bits per pixel
+    \param[in] format a format of pixels
+    \param[out] out a result
+ */
+static void mipchain_decode(
+    const sad::uchar* pixels,
+    size_t count,
+    unsigned int bpp,
+    sad::Texture::InternalFormat format,
+    sad::uchar* out
+)
+{
+    for(size_t i = 0; i < count; i++, out += 4)
+    {
+        unsigned short v = 0;
+        switch(format)
+        {
+        case sad::Texture::SFT_R8_G8_B8_A8:
+            if (bpp == 32)
+            {
+                memcpy(out, pixels + i * 4, 4);
+            }
+            else
+            {
+                memcpy(out, pixels + i * 3, 3);
+                out[3] = 255;
+            }
+            break;
+        case sad::Texture::SFT_R5_G6_B5:
+            memcpy(&v, pixels + i * 2, 2);
+            out[0] = mipchain_expand((v >> 11) & 31, 5);
+            out[1] = mipchain_expand((v >> 5) & 63, 6);
+            out[2] = mipchain_expand(v & 31, 5);
+            out[3] = 255;
+            break;
+        case sad::Texture::SFT_R4_G4_B4_A4:
+            memcpy(&v, pixels + i * 2, 2);
+            out[0] = mipchain_expand((v >> 12) & 15, 4);
+            out[1] = mipchain_expand((v >> 8) & 15, 4);
+            out[2] = mipchain_expand((v >> 4) & 15, 4);
+            out[3] = mipchain_expand(v & 15, 4);
+            break;
+        case sad::Texture::SFT_R3_G3_B2:
+            v = pixels[i];
+            out[0] = mipchain_expand((v >> 5) & 7, 3);
+            out[1] = mipchain_expand((v >> 2) & 7, 3);
+            out[2] = mipchain_expand(v & 3, 2);
+            out[3] = 255;
+            break;
+        };
+    }
+}
+
+/*! Converts 32-bit RGBA pixels to pixels of texture
+    \param[in] pixels a source pixels
+    \param[in] count amount of pixels
+    \param[in] bpp bits per pixel
+    \param[in] format a format of pixels
+    \param[out] out a result
+ */
+static void mipchain_encode(
+    const sad::uchar* pixels,
+    size_t count,
+    unsigned int bpp,
+    sad::Texture::InternalFormat format,
+    sad::uchar* out
+)
+{
+    for(size_t i = 0; i < count; i++, pixels += 4)
+    {
+        unsigned short v = 0;
+        switch(format)
+        {
+        case sad::Texture::SFT_R8_G8_B8_A8:
+            memcpy(out + i * (bpp / 8), pixels, bpp / 8);
+            break;
+        case sad::Texture::SFT_R5_G6_B5:
+            v = static_cast<unsigned short>(
+                (mipchain_reduce(pixels[0], 5) << 11) 
+              | (mipchain_reduce(pixels[1], 6) << 5) 
+              | mipchain_reduce(pixels[2], 5)
+            );
+            memcpy(out + i * 2, &v, 2);
+            break;
+        case sad::Texture::SFT_R4_G4_B4_A4:
+            v = static_cast<unsigned short>(
+                (mipchain_reduce(pixels[0], 4) << 12) 
+              | (mipchain_reduce(pixels[1], 4) << 8) 
+              | (mipchain_reduce(pixels[2], 4) << 4) 
+              | mipchain_reduce(pixels[3], 4)
+            );
+            memcpy(out + i * 2, &v, 2);
+            break;
+        case sad::Texture::SFT_R3_G3_B2:
+            out[i] = static_cast<sad::uchar>(
+                (mipchain_reduce(pixels[0], 3) << 5) 
+              | (mipchain_reduce(pixels[1], 3) << 2) 
+              | mipchain_reduce(pixels[2], 2)
+            );
+            break;
+        };
+    }
+}
+
+// ============================================================ FILTERS ============================================================
+
+/*! Downsamples 32-bit RGBA pixels, averaging 2x2 blocks. Last row and column of odd-sized
+    levels are dropped, like in most drivers
+    \param[in] src a source pixels
+    \param[in] sw a width of source
+    \param[in] sh a height of source
+    \param[out] dst a destination pixels
+    \param[in] dw a width of destination
+    \param[in] dh a height of destination
+ */
+static void mipchain_box(const sad::uchar* src, unsigned int sw, unsigned int sh, sad::uchar* dst, unsigned int dw, unsigned int dh)
+{
+    for(unsigned int y = 0; y < dh; y++)
+    {
+        const sad::uchar* r0 = src + static_cast<size_t>((sh > 1) ? (2 * y) : 0) * sw * 4;
+        const sad::uchar* r1 = src + static_cast<size_t>((sh > 1) ? (2 * y + 1) : 0) * sw * 4;
+        sad::uchar* out = dst + static_cast<size_t>(y) * dw * 4;
+        unsigned int x = 0;
+        if (sw > 1)
+        {
+#if defined(SAD_MIPCHAIN_SSE2)
+            // Two destination pixels from four pixels of two rows
+            __m128i zero = _mm_setzero_si128();
+            __m128i two = _mm_set1_epi16(2);
+            for(; x + 2 <= dw; x += 2)
+            {
+                __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r0 + 8 * x));
+                __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r1 + 8 * x));
+                __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+                __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+                lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+                hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+                __m128i s = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), two), 2);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 4 * x), _mm_packus_epi16(s, s));
+            }
+#elif defined(SAD_MIPCHAIN_NEON)
+            // Four destination pixels from eight pixels of two rows, deinterleaved by channel
+            for(; x + 4 <= dw; x += 4)
+            {
+                uint8x8x4_t a = vld4_u8(r0 + 8 * x);
+                uint8x8x4_t b = vld4_u8(r1 + 8 * x);
+                uint8x8x4_t o;
+                for(int k = 0; k < 4; k++)
+                {
+                    uint16x4_t s = vadd_u16(vpaddl_u8(a.val[k]), vpaddl_u8(b.val[k]));
+                    o.val[k] = vrshrn_n_u16(vcombine_u16(s, s), 2);
+                }
+                sad::uchar buffer[32];
+                vst4_u8(buffer, o);
+                memcpy(out + 4 * x, buffer, 16);
+            }
+#endif
+        }
+        for(; x < dw; x++)
+        {
+            unsigned int x0 = (sw > 1) ? (2 * x) : 0;
+            unsigned int x1 = (sw > 1) ? (2 * x + 1) : 0;
+            for(int k = 0; k < 4; k++)
+            {
+                unsigned int s = r0[x0 * 4 + k] + r0[x1 * 4 + k] + r1[x0 * 4 + k] + r1[x1 * 4 + k];
+                out[x * 4 + k] = static_cast<sad::uchar>((s + 2) >> 2);
+            }
+        }
+    }
+}
+
+/*! Computes modified Bessel function of first kind of zero order
+    \param[in] x argument
+    \return value
+ */
+static double mipchain_bessel_i0(double x)
+{
+    double sum = 1.0, term = 1.0, half = x / 2.0;
+    for(int k = 1; k < 32; k++)
+    {
+        term *= (half / k) * (half / k);
+        sum += term;
+        if (term < sum * 1.0e-12)
+        {
+            break;
+        }
+    }
+    return sum;
+}
+
+/*! Computes Kaiser-windowed sinc kernel for halving a level
+    \param[in] d distance from center of destination pixel in pixels of source
+    \return weight
+ */
+static double mipchain_kaiser(double d)
+{
+    double t = d / MIPCHAIN_KAISER_RADIUS;
+    if (t <= -1.0 || t >= 1.0)
+    {
+        return 0.0;
+    }
+    double x = d / 2.0 * M_PI;
+    double sinc = (fabs(x) < 1.0e-9) ? 1.0 : sin(x) / x;
+    double window = mipchain_bessel_i0(MIPCHAIN_KAISER_ALPHA * sqrt(1.0 - t * t)) / mipchain_bessel_i0(MIPCHAIN_KAISER_ALPHA);
+    return sinc * window;
+}
+
+/*! A weights of source pixels for one destination pixel
+ */
+struct mipchain_taps
+{
+    int First;                  //!< A first source pixel
+    sad::Vector<float> Weights; //!< A normalized weights of pixels, starting from first
+};
+
+/*! Computes taps of Kaiser filter for all of destination pixels
+    \param[in] src a size of source
+    \param[in] dst a size of destination
+    \param[out] taps a taps
+ */
+static void mipchain_kaiser_taps(unsigned int src, unsigned int dst, sad::Vector<mipchain_taps>& taps)
+{
+    double scale = static_cast<double>(src) / dst;
+    taps.resize(dst);
+    for(unsigned int i = 0; i < dst; i++)
+    {
+        double center = (i + 0.5) * scale;
+        int first = static_cast<int>(floor(center - MIPCHAIN_KAISER_RADIUS));
+        int last = static_cast<int>(ceil(center + MIPCHAIN_KAISER_RADIUS));
+        taps[i].First = first;
+        taps[i].Weights.clear();
+        double sum = 0;
+        for(int j = first; j <= last; j++)
+        {
+            double w = mipchain_kaiser(j + 0.5 - center);
+            taps[i].Weights << static_cast<float>(w);
+            sum += w;
+        }
+        for(size_t j = 0; j < taps[i].Weights.size(); j++)
+        {
+            taps[i].Weights[j] = static_cast<float>(taps[i].Weights[j] / sum);
+        }
+    }
+}
+
+/*! Clamps index of pixel to size of level
+    \param[in] i index
+    \param[in] size size of level
+    \return clamped index
+ */
+inline static unsigned int mipchain_clamp(int i, unsigned int size)
+{
+    if (i < 0)
+    {
+        return 0;
+    }
+    return (static_cast<unsigned int>(i) >= size) ? (size - 1) : static_cast<unsigned int>(i);
+}
+
+/*! Downsamples 32-bit RGBA pixels with separable Kaiser filter
+    \param[in] src a source pixels
+    \param[in] sw a width of source
+    \param[in] sh a height of source
+    \param[out] dst a destination pixels
+    \param[in] dw a width of destination
+    \param[in] dh a height of destination
+ */
+static void mipchain_kaiser_filter(const sad::uchar* src, unsigned int sw, unsigned int sh, sad::uchar* dst, unsigned int dw, unsigned int dh)
+{
+    sad::Vector<mipchain_taps> htaps, vtaps;
+    mipchain_kaiser_taps(sw, dw, htaps);
+    mipchain_kaiser_taps(sh, dh, vtaps);
+
+    // Horizontal pass into floating point buffer
+    sad::Vector<float> tmp;
+    tmp.resize(static_cast<size_t>(dw) * sh * 4);
+    for(unsigned int y = 0; y < sh; y++)
+    {
+        const sad::uchar* row = src + static_cast<size_t>(y) * sw * 4;
+        float* out = &(tmp[static_cast<size_t>(y) * dw * 4]);
+        for(unsigned int x = 0; x < dw; x++)
+        {
+            const mipchain_taps& t = htaps[x];
+            mipchain_pixel acc = mipchain_zero();
+            for(size_t j = 0; j < t.Weights.size(); j++)
+            {
+                unsigned int sx = mipchain_clamp(t.First + static_cast<int>(j), sw);
+                acc = mipchain_madd(acc, mipchain_load(row + sx * 4), t.Weights[j]);
+            }
+            mipchain_store(out + x * 4, acc);
+        }
+    }
+    // Vertical pass into destination
+    for(unsigned int y = 0; y < dh; y++)
+    {
+        const mipchain_taps& t = vtaps[y];
+        sad::uchar* out = dst + static_cast<size_t>(y) * dw * 4;
+        for(unsigned int x = 0; x < dw; x++)
+        {
+            mipchain_pixel acc = mipchain_zero();
+            for(size_t j = 0; j < t.Weights.size(); j++)
+            {
+                unsigned int sy = mipchain_clamp(t.First + static_cast<int>(j), sh);
+                acc = mipchain_madd(acc, mipchain_load(&(tmp[(static_cast<size_t>(sy) * dw + x) * 4])), t.Weights[j]);
+            }
+            mipchain_store(out + x * 4, acc);
+        }
+    }
+}
+
+// ============================================================ PUBLIC METHODS ============================================================
+
+sad::imageformats::MipChain::MipChain()
+{
+
+}
+
+sad::imageformats::MipChain::~MipChain()
+{
+
+}
+
+bool sad::imageformats::MipChain::build(
+    const sad::uchar* pixels,
+    unsigned int width,
+    unsigned int height,
+    unsigned int bpp,
+    sad::Texture::InternalFormat format,
+    sad::imageformats::MipChain::Filter filter
+)
+{
+    m_levels.clear();
+    if (!pixels || width == 0 || height == 0 || !mipchain_is_supported(bpp, format))
+    {
+        return false;
+    }
+    // Every level is built from previous one in 32-bit RGBA, so precision is not lost in packed formats
+    sad::Vector<sad::uchar> current;
+    current.resize(static_cast<size_t>(width) * height * 4);
+    mipchain_decode(pixels, static_cast<size_t>(width) * height, bpp, format, &(current[0]));
+    unsigned int cw = width, ch = height;
+    while(cw > 1 || ch > 1)
+    {
+        unsigned int nw = sad::imageformats::MipChain::nextLevelSize(cw);
+        unsigned int nh = sad::imageformats::MipChain::nextLevelSize(ch);
+        sad::Vector<sad::uchar> next;
+        next.resize(static_cast<size_t>(nw) * nh * 4);
+        if (filter == sad::imageformats::MipChain::MCF_KAISER)
+        {
+            mipchain_kaiser_filter(&(current[0]), cw, ch, &(next[0]), nw, nh);
+        }
+        else
+        {
+            mipchain_box(&(current[0]), cw, ch, &(next[0]), nw, nh);
+        }
+
+        m_levels << sad::imageformats::MipChain::Level();
+        sad::imageformats::MipChain::Level& level = m_levels[m_levels.size() - 1];
+        level.Width = nw;
+        level.Height = nh;
+        level.Data.resize(static_cast<size_t>(nw) * nh * mipchain_pixel_size(bpp));
+        mipchain_encode(&(next[0]), static_cast<size_t>(nw) * nh, bpp, format, &(level.Data[0]));
+
+        current.swap(next);
+        cw = nw;
+        ch = nh;
+    }
+    return true;
+}
+
+bool sad::imageformats::MipChain::build(
+    const sad::Texture* texture,
+    sad::imageformats::MipChain::Filter filter
+)
+{
+    if (!texture)
+    {
+        return false;
+    }
+    return this->build(texture->data(), texture->width(), texture->height(), texture->Bpp, texture->Format, filter);
+}
+
+unsigned int sad::imageformats::MipChain::levels() const
+{
+    return static_cast<unsigned int>(m_levels.size());
+}
+
+const sad::imageformats::MipChain::Level& sad::imageformats::MipChain::level(unsigned int i) const
+{
+    return m_levels[i];
+}
+
+void sad::imageformats::MipChain::addLevel(unsigned int width, unsigned int height, const sad::Vector<sad::uchar>& data)
+{
+    sad::imageformats::MipChain::Level level;
+    level.Width = width;
+    level.Height = height;
+    level.Data = data;
+    m_levels << level;
+}
+
+void sad::imageformats::MipChain::clear()
+{
+    m_levels.clear();
+}
+
+bool sad::imageformats::MipChain::isCompleteFor(unsigned int width, unsigned int height, unsigned int bpp) const
+{
+    unsigned int cw = width, ch = height;
+    size_t i = 0;
+    while(cw > 1 || ch > 1)
+    {
+        cw = sad::imageformats::MipChain::nextLevelSize(cw);
+        ch = sad::imageformats::MipChain::nextLevelSize(ch);
+        if (i >= m_levels.size())
+        {
+            return false;
+        }
+        const sad::imageformats::MipChain::Level& level = m_levels[i];
+        if (level.Width != cw || level.Height != ch || level.Data.size() != static_cast<size_t>(cw) * ch * mipchain_pixel_size(bpp))
+        {
+            return false;
+        }
+        ++i;
+    }
+    return i == m_levels.size() && i != 0;
+}
+
+unsigned int sad::imageformats::MipChain::nextLevelSize(unsigned int size)
+{
+    return (size > 1) ? (size / 2) : 1;
+}
+
+size_t sad::imageformats::MipChain::chainSize(unsigned int width, unsigned int height, unsigned int bpp)
+{
+    size_t result = 0;
+    unsigned int cw = width, ch = height;
+    while(cw > 1 || ch > 1)
+    {
+        cw = sad::imageformats::MipChain::nextLevelSize(cw);
+        ch = sad::imageformats::MipChain::nextLevelSize(ch);
+        result += static_cast<size_t>(cw) * ch * mipchain_pixel_size(bpp);
+    }
+    return result;
+}
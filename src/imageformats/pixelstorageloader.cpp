@@ -1,5 +1,9 @@
 #include "imageformats/pixelstorageloader.h"
 
+#include "imageformats/mipchain.h"
+
+#include "os/mappedfileimpl.h"
+
 #include "texture.h"
 
 #define TAR7Z_SADDY
@@ -8,6 +12,29 @@
 
 const int maxlogtexturesize = 14;
 
+/*! Splits contiguous levels of chain of mip-maps, stored after pixels of base level
+    \param[in] data a data of levels
+    \param[in] texsize a size of base level
+    \param[in] bpp bits per pixel
+    \return chain
+ */
+static sad::imageformats::MipChain* pixel_storage_make_chain(const sad::uchar* data, unsigned int texsize, unsigned int bpp)
+{
+    sad::imageformats::MipChain* chain = new sad::imageformats::MipChain();
+    unsigned int size = texsize;
+    while(size > 1)
+    {
+        size = sad::imageformats::MipChain::nextLevelSize(size);
+        size_t levelsize = static_cast<size_t>(size) * size * (bpp / 8);
+        sad::Vector<sad::uchar> level;
+        level.resize(levelsize);
+        memcpy(&(level[0]), data, levelsize);
+        chain->addLevel(size, size, level);
+        data += levelsize;
+    }
+    return chain;
+}
+
 sad::imageformats::PixelStorageLoader::PixelStorageLoader(const sad::imageformats::PixelStorageLoader::Settings& settings) : m_settings(settings)
 {
 
@@ -50,6 +77,30 @@ bool sad::imageformats::PixelStorageLoader::load(FILE * file, sad::Texture * tex
 
     unsigned int texsize = 1 << static_cast<unsigned int>(logtexsize);
     unsigned int buffersize = texsize * texsize * (m_settings.Bpp / 8);
+    size_t chainsize = sad::imageformats::MipChain::chainSize(texsize, texsize, m_settings.Bpp);
+
+    // Map file into memory, if requested, so pixels are read from page cache without copying them
+    long offset = ftell(file);
+    sad::os::MappedFileImpl* mapped = new sad::os::MappedFileImpl();
+    if (texture->MapFile && offset >= 0 && mapped->map(file) && mapped->size() >= static_cast<size_t>(offset) + buffersize)
+    {
+        texture->width() = texsize;
+        texture->height() = texsize;
+        texture->bpp() = m_settings.Bpp;
+        texture->Format = static_cast<sad::Texture::InternalFormat>(m_settings.Format);
+        delete texture->Buffer;
+        sad::Texture::MappedFileBuffer* buf = new sad::Texture::MappedFileBuffer();
+        buf->File = mapped;
+        buf->Offset = static_cast<size_t>(offset);
+        texture->Buffer = buf;
+
+        if (chainsize != 0 && mapped->size() >= static_cast<size_t>(offset) + buffersize + chainsize)
+        {
+            texture->setMipChain(pixel_storage_make_chain(mapped->data() + offset + buffersize, texsize, m_settings.Bpp));
+        }
+        return true;
+    }
+    delete mapped;
 
     sad::Texture::DefaultBuffer* newbuffer = new sad::Texture::DefaultBuffer();
     newbuffer->Data.resize(buffersize);
@@ -57,6 +108,7 @@ bool sad::imageformats::PixelStorageLoader::load(FILE * file, sad::Texture * tex
     sad::uchar* buffer = &(newbuffer->Data[0]);
     if (fread(buffer, buffersize, 1, file) != 1)
     {
+        delete newbuffer;
         return false;
     }
     texture->width() = texsize;
@@ -66,6 +118,17 @@ bool sad::imageformats::PixelStorageLoader::load(FILE * file, sad::Texture * tex
     delete texture->Buffer;
     texture->Buffer = newbuffer;
 
+    // Read prebuilt chain of mip-maps, if it's stored after pixels
+    if (chainsize != 0)
+    {
+        sad::Vector<sad::uchar> chain;
+        chain.resize(chainsize);
+        if (fread(&(chain[0]), chainsize, 1, file) == 1)
+        {
+            texture->setMipChain(pixel_storage_make_chain(&(chain[0]), texsize, m_settings.Bpp));
+        }
+    }
+
     return true;
 }
 
@@ -116,6 +179,60 @@ bool sad::imageformats::PixelStorageLoader::load(tar7z::Entry* entry, sad::Textu
     buf->Offset = entry->Offset + headersize;
     texture->Buffer = buf;
 
+    // Read prebuilt chain of mip-maps, if it's stored after pixels
+    size_t chainsize = sad::imageformats::MipChain::chainSize(texsize, texsize, m_settings.Bpp);
+    if (chainsize != 0 && headersize + buffersize + chainsize <= entry->Size)
+    {
+        const sad::uchar* chain = reinterpret_cast<const sad::uchar*>(buffer) + headersize + buffersize;
+        texture->setMipChain(pixel_storage_make_chain(chain, texsize, m_settings.Bpp));
+    }
+
+    return true;
+}
+
+bool sad::imageformats::PixelStorageLoader::save(FILE* file, const sad::Texture* texture)
+{
+    if (!file || !texture || !(texture->Buffer))
+    {
+        return false;
+    }
+    unsigned int texsize = texture->width();
+    if (texsize == 0 || texsize != texture->height() || (texsize & (texsize - 1)) != 0
+        || texture->Bpp != m_settings.Bpp || static_cast<unsigned int>(texture->Format) != m_settings.Format)
+    {
+        return false;
+    }
+    sad::uchar logtexsize = 0;
+    while((1u << logtexsize) < texsize)
+    {
+        ++logtexsize;
+    }
+    if (logtexsize > maxlogtexturesize)
+    {
+        return false;
+    }
+
+    if (fwrite(m_settings.Signature, m_settings.SignatureSize, 1, file) != 1 || fwrite(&logtexsize, 1, 1, file) != 1)
+    {
+        return false;
+    }
+    size_t buffersize = static_cast<size_t>(texsize) * texsize * (m_settings.Bpp / 8);
+    if (fwrite(texture->data(), buffersize, 1, file) != 1)
+    {
+        return false;
+    }
+    sad::imageformats::MipChain* chain = texture->mipChain();
+    if (chain && chain->isCompleteFor(texsize, texsize, m_settings.Bpp))
+    {
+        for(unsigned int i = 0; i < chain->levels(); i++)
+        {
+            const sad::Vector<sad::uchar>& data = chain->level(i).Data;
+            if (fwrite(&(data[0]), data.size(), 1, file) != 1)
+            {
+                return false;
+            }
+        }
+    }
     return true;
 }
 
@@ -3,6 +3,8 @@
 #include "util/chararrayibuf.h"
 #include "util/fileistreambuf.h"
 
+#include "sadscopedlock.h"
+
 #define TAR7Z_SADDY
 
 #include "3rdparty/tar7z/include/tar.h"
@@ -62,6 +64,7 @@ bool sad::imageformats::TGALoader::load(FILE * file, sad::Texture * texture)
     {
         return false;
     }
+    sad::ScopedLock lock(&m_lock);
     sad::util::FileIStreamBuf buf(file);
     std::istream stream(&buf);
     m_file = &stream;
@@ -76,6 +79,7 @@ bool sad::imageformats::TGALoader::load(tar7z::Entry* entry, sad::Texture* textu
     {
         return false;
     }
+    sad::ScopedLock lock(&m_lock);
     sad::util::CharArrayIBuf buf(entry->contents(), entry->contents() + entry->Size);
     std::istream stream(&buf);
     m_file = &stream;
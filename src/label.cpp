@@ -10,6 +10,8 @@
 #include "db/load.h"
 #include "db/dbmethodpair.h"
 
+#include "rendering/backend.h"
+
 #ifdef WIN32
 #include <windows.h>
 #endif
@@ -100,6 +102,30 @@ void sad::Label::regions(sad::Vector<sad::Rect2D> & r)
     r << m_cached_region;
 }
 
+bool sad::Label::boundingRect(sad::Rect2D & r)
+{
+    sad::ScopedLock recompute_string_lock(&m_recompute_string_lock);
+    sad::ScopedLock recompute_point_lock(&m_recompute_point_lock);
+
+    // Cached region is recomputed lazily, so it's stale, if font was not loaded, when label was changed.
+    // Since culled label is not rendered, it must be recomputed here, or label will never be shown
+    if (!m_computed_rendering_string)
+    {
+        recomputeRenderedString(false);
+    }
+    if (!m_computed_rendering_point)
+    {
+        recomputeRenderingPoint(false);
+    }
+
+    if (!m_computed_rendering_string || !m_computed_rendering_point)
+    {
+        return false;
+    }
+    r = sad::boundingBox(m_cached_region);
+    return true;
+}
+
 static sad::db::schema::Schema* LabelBasicSchema = NULL;
 
 static sad::Mutex LabelBasicSchemaInit;
@@ -261,26 +287,28 @@ void sad::Label::render()
         return;
     }
 
-    glMatrixMode(GL_MODELVIEW);
-    glPushMatrix();
-    glTranslatef(static_cast<GLfloat>(m_center.x()), static_cast<GLfloat>(m_center.y()), 0.0f);
-    glRotatef(static_cast<GLfloat>(m_angle / M_PI * 180.0f), 0.0f, 0.0f, 1.0f);
+    sad::rendering::Backend* backend = sad::rendering::backend(this->renderer());
+    backend->pushMatrix();
+    backend->translate(m_center.x(), m_center.y(), 0.0);
+    backend->rotate(m_angle / M_PI * 180.0, 0.0, 0.0, 1.0);
 
     if (m_size > 0)
     {
         if (font)
         {
-            if (m_formatted)
-            {
-                renderWithFormatting(font);
-            }
-            else
-            {
-                renderWithoutFormatting(font);
-            }
+            backend->drawText(static_cast<unsigned int>(m_rendered_string.size()), [this, font]() {
+                if (m_formatted)
+                {
+                    renderWithFormatting(font);
+                }
+                else
+                {
+                    renderWithoutFormatting(font);
+                }
+            });
         }
     }
-    glPopMatrix();
+    backend->popMatrix();
 }
 
 
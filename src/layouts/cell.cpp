@@ -23,7 +23,8 @@ m_padding_bottom(0),
 m_padding_left(0),
 m_padding_right(0),
 m_grid(NULL),
-m_db(NULL)
+m_db(NULL),
+m_dirty(false)
 {
     m_width.Unit = sad::layouts::LU_Auto;
     m_height.Unit = sad::layouts::LU_Auto;
@@ -740,16 +741,31 @@ void sad::layouts::Cell::normalize(sad::layouts::Cell::NormalizedRectangle& resu
     }
 }
 
-void sad::layouts::Cell::tryNotify(bool update_grid)
+sad::Size2D sad::layouts::Cell::layoutSize() const
 {
-    if (update_grid)
+    sad::Size2D result = this->preferredSize();
+    if (m_width.Unit != sad::layouts::LU_Auto || m_height.Unit != sad::layouts::LU_Auto)
     {
-        if (m_grid)
+        sad::Size2D computed = this->computedSize();
+        if (m_width.Unit != sad::layouts::LU_Auto)
+        {
+            result.Width = computed.Width;
+        }
+        if (m_height.Unit != sad::layouts::LU_Auto)
         {
-            m_grid->update();
+            result.Height = computed.Height;
         }
     }
-    else
+    return result;
+}
+
+void sad::layouts::Cell::tryNotify(bool update_grid)
+{
+    if (m_grid)
+    {
+        m_grid->markDirty(this, update_grid);
+    }
+    if (!update_grid)
     {
         update();
     }
@@ -910,7 +926,8 @@ sad::layouts::Cell::Cell(const sad::layouts::Cell& o)
     m_padding_left(o.m_padding_left),
     m_padding_right(o.m_padding_right),
     m_grid(o.m_grid),
-    m_db(o.m_db)
+    m_db(o.m_db),
+    m_dirty(false)
 {
     throw std::runtime_error("Not implemented");
 }
@@ -7,6 +7,7 @@
 #include "util/free.h"
 
 #include "renderer.h"
+#include "pipeline/pipeline.h"
 #include "primitiverenderer.h"
 #include "sadmutex.h"
 #include "geometry2d.h"
@@ -30,7 +31,12 @@ m_fixed_width(false),
 m_fixed_height(false),
 m_render_color(255,0 ,0),
 m_renderer(NULL),
-m_loading(false)
+m_loading(false),
+m_full_relayout(true),
+m_relayout_pending(false),
+m_batch_depth(0),
+m_deferred_updates(false),
+m_relayout_scheduled(false)
 {
     
 }
@@ -112,11 +118,17 @@ sad::Vector<sad::Rect2D> sad::layouts::Grid::getRegions()
     return r;
 }
 
-bool sad::layouts::Grid::load(const picojson::value& v)
+void sad::layouts::Grid::beginLoading()
 {
     m_loading = true;
-    bool result = this->sad::SceneNode::load(v);
+}
+
+bool sad::layouts::Grid::finishLoading(bool loaded)
+{
     m_loading = false;
+    m_full_relayout = true;
+    m_dirty_cells.clear();
+    bool result = loaded;
     if (result)
     {        
         result = this->validate();
@@ -235,7 +247,7 @@ void sad::layouts::Grid::setArea(const sad::Rect2D & r)
     m_area = r;
     if (!m_loading)
     {
-        this->update();
+        this->invalidate();
     }
 }
 
@@ -263,7 +275,7 @@ void sad::layouts::Grid::setRows(unsigned int rows)
     {
         if (!m_loading)
         {
-            this->update();
+            this->invalidate();
         }
     }
 }
@@ -292,7 +304,7 @@ void sad::layouts::Grid::setColumns(unsigned int cols)
     {
         if (!m_loading)
         {
-            this->update();
+            this->invalidate();
         }
     }
 }
@@ -313,7 +325,7 @@ void sad::layouts::Grid::setPaddingTop(double value, bool propagate)
         }
         if (!m_loading)
         {
-            this->update();
+            this->invalidate();
         }
     }
 }
@@ -339,7 +351,7 @@ void sad::layouts::Grid::setPaddingBottom(double value, bool propagate)
         }
         if (!m_loading)
         {
-            this->update();
+            this->invalidate();
         }
     }
 }
@@ -365,7 +377,7 @@ void sad::layouts::Grid::setPaddingLeft(double value, bool propagate)
         }
         if (!m_loading)
         {
-            this->update();
+            this->invalidate();
         }
     }
 }
@@ -391,7 +403,7 @@ void sad::layouts::Grid::setPaddingRight(double value, bool propagate)
         }
         if (!m_loading)
         {
-            this->update();
+            this->invalidate();
         }
     }
 }
@@ -411,7 +423,7 @@ void sad::layouts::Grid::setFixedWidth(bool flag)
     m_fixed_width = flag;
     if (!m_loading)
     {
-        this->update();
+        this->invalidate();
     }
 }
 
@@ -425,7 +437,7 @@ void sad::layouts::Grid::setFixedHeight(bool flag)
     m_fixed_height = flag;
     if (!m_loading)
     {
-        this->update();
+        this->invalidate();
     }
 }
 
@@ -480,7 +492,7 @@ void sad::layouts::Grid::setCells(const sad::Vector<sad::layouts::SerializableCe
             // Remove old cells
             sad::util::free(oldcells);
             this->makeCellViews();
-            this->update();
+            this->invalidate();
         }
         else
         {
@@ -584,7 +596,7 @@ bool sad::layouts::Grid::merge(size_t row, size_t col, size_t row_span, size_t c
     cell->setColSpan(col_span);  
     std::sort(m_cells.begin(), m_cells.end(), less);
     makeCellViews();
-    this->update();
+    this->invalidate();
     return true;
 }
 
@@ -613,65 +625,123 @@ bool sad::layouts::Grid::split(size_t row, size_t col, size_t row_span, size_t c
     CellComparator less;
     std::sort(m_cells.begin(), m_cells.end(), less);
     makeCellViews();
-    this->update();
+    this->invalidate();
     return true;
 }
 
 void sad::layouts::Grid::update()
 {
-    // 1. Create empty arrays of widths and heights, filled with zeros
-    sad::Vector<sad::Vector<double> > widths;
-    sad::Vector<sad::Vector<double> > heights;
-    for(size_t i = 0; i < m_rows; i++)
+    m_full_relayout = true;
+    m_dirty_cells.clear();
+    this->relayout();
+}
+
+/*! Tests, whether areas are exactly the same
+    \param[in] a first area
+    \param[in] b second area
+    \return whether they are same
+ */
+static bool isSameArea(const sad::Rect2D& a, const sad::Rect2D& b)
+{
+    for(size_t i = 0; i < 4; i++)
     {
-        widths << sad::Vector<double>();
-        heights << sad::Vector<double>();
-        for(size_t j = 0; j < m_cols; j++)
+        if (a[i].x() != b[i].x() || a[i].y() != b[i].y())
         {
-            widths[i] << 0.0;
-            heights[i] << 0.0;
+            return false;
         }
     }
-    
-    // 2. Fill this array with actual widths and heights, distributed from cells
-    for(size_t i = 0; i < m_cells.size(); i++)
+    return true;
+}
+
+void sad::layouts::Grid::relayout()
+{
+    m_relayout_pending = false;
+    bool full = m_full_relayout
+             || m_cell_views.size() != m_rows * m_cols
+             || m_row_heights.size() != m_rows
+             || m_col_widths.size() != m_cols;
+    // 1. Compute sizes of cells, which should be recomputed
+    // 2. Compute natural heights of rows and widths of columns as maximal sizes of cells, that take them.
+    //    Spanning cells are distributed evenly
+    if (full)
     {
-        sad::layouts::Cell* cell = m_cells[i];
-        sad::Size2D computedSize = cell->computedSize();
-        sad::Size2D size = cell->preferredSize();
-        if (cell->width().Unit != sad::layouts::LU_Auto)
+        m_row_heights.clear();
+        m_col_widths.clear();
+        m_row_heights.resize(m_rows, 0.0);
+        m_col_widths.resize(m_cols, 0.0);
+        for(size_t i = 0; i < m_cells.size(); i++)
         {
-            size.Width = computedSize.Width;            
+            sad::layouts::Cell* cell = m_cells[i];
+            cell->m_layout_size = cell->layoutSize();
+            for(size_t row = 0; row < cell->rowSpan(); row++)
+            {
+                m_row_heights[cell->Row + row] = std::max(m_row_heights[cell->Row + row], cell->m_layout_size.Height / cell->rowSpan());
+            }
+            for(size_t col = 0; col < cell->colSpan(); col++)
+            {
+                m_col_widths[cell->Col + col] = std::max(m_col_widths[cell->Col + col], cell->m_layout_size.Width / cell->colSpan());
+            }
         }
-        if (cell->height().Unit != sad::layouts::LU_Auto)
+    }
+    else
+    {
+        sad::Vector<bool> dirty_rows;
+        sad::Vector<bool> dirty_cols;
+        dirty_rows.resize(m_rows, false);
+        dirty_cols.resize(m_cols, false);
+        for(size_t i = 0; i < m_dirty_cells.size(); i++)
         {
-            size.Height = computedSize.Height;
+            sad::layouts::Cell* cell = m_dirty_cells[i];
+            sad::Size2D size = cell->layoutSize();
+            if (size.Height != cell->m_layout_size.Height)
+            {
+                for(size_t row = 0; row < cell->rowSpan(); row++)
+                {
+                    dirty_rows[cell->Row + row] = true;
+                }
+            }
+            if (size.Width != cell->m_layout_size.Width)
+            {
+                for(size_t col = 0; col < cell->colSpan(); col++)
+                {
+                    dirty_cols[cell->Col + col] = true;
+                }
+            }
+            cell->m_layout_size = size;
         }
-                
-        for(size_t row = 0; row < cell->rowSpan(); row++)
+        for(size_t row = 0; row < m_rows; row++)
         {
-            for(size_t col = 0; col < cell->colSpan(); col++)
+            if (dirty_rows[row])
             {
-                widths[cell->Row + row][cell->Col + col] = size.Width / cell->colSpan();
-                heights[cell->Row + row][cell->Col + col] = size.Height / cell->rowSpan();              
+                double height = 0;
+                for(size_t col = 0; col < m_cols; col++)
+                {
+                    sad::layouts::Cell* cell = m_cell_views[row * m_cols + col];
+                    height = std::max(height, cell->m_layout_size.Height / cell->rowSpan());
+                }
+                m_row_heights[row] = height;
             }
         }
-    }
-
-    
-    // 3. Linearize widths and heights by picking maximal width and height on row or column
-    sad::Vector<double> rowtoheight;    
-    sad::Vector<double> coltowidth;
-    rowtoheight.resize(m_rows, 0.0);
-    coltowidth.resize(m_cols, 0.0);
-    for(size_t i = 0; i < m_rows; i++)
-    {
-        for(size_t j = 0; j < m_cols; j++)
+        for(size_t col = 0; col < m_cols; col++)
         {
-            rowtoheight[i] = std::max(rowtoheight[i], heights[i][j]);
-            coltowidth[j] = std::max(coltowidth[j], widths[i][j]);
+            if (dirty_cols[col])
+            {
+                double width = 0;
+                for(size_t row = 0; row < m_rows; row++)
+                {
+                    sad::layouts::Cell* cell = m_cell_views[row * m_cols + col];
+                    width = std::max(width, cell->m_layout_size.Width / cell->colSpan());
+                }
+                m_col_widths[col] = width;
+            }
         }
     }
+    m_full_relayout = false;
+    m_dirty_cells.clear();
+
+    // 3. Take natural sizes as base for layouting
+    sad::Vector<double> rowtoheight = m_row_heights;
+    sad::Vector<double> coltowidth = m_col_widths;
 
     // 3.1. Fill zero-size rows with redistributed left-space from other cells
     if (this->fixedWidth())
@@ -789,22 +859,90 @@ void sad::layouts::Grid::update()
         }
     }
     
-    // 5. Update assigned areas for all of cells
+    // 5. Update assigned areas for all of cells, updating only changed ones
+    sad::Vector<double> rowstart;
+    sad::Vector<double> colstart;
+    rowstart.resize(m_rows + 1, 0.0);
+    colstart.resize(m_cols + 1, 0.0);
+    for(size_t i = 0; i < m_rows; i++)
+    {
+        rowstart[i + 1] = rowstart[i] + rowtoheight[i];
+    }
+    for(size_t i = 0; i < m_cols; i++)
+    {
+        colstart[i + 1] = colstart[i] + coltowidth[i];
+    }
     sad::Point2D startingpoint = m_area.p3();
     for(size_t i = 0; i < m_cells.size(); i++)
     {
         sad::layouts::Cell* cell = m_cells[i];
-        double xstart = startingpoint.x() + std::accumulate(coltowidth.begin(), coltowidth.begin() + cell->Col, 0.0);
-        double ystart = startingpoint.y() - std::accumulate(rowtoheight.begin(), rowtoheight.begin() + cell->Row, 0.0);
+        double xstart = startingpoint.x() + colstart[cell->Col];
+        double ystart = startingpoint.y() - rowstart[cell->Row];
         double width = std::accumulate(coltowidth.begin() + cell->Col, coltowidth.begin() + cell->Col + cell->colSpan(), 0.0);
         double height = std::accumulate(rowtoheight.begin() + cell->Row, rowtoheight.begin() + cell->Row + cell->rowSpan(), 0.0);
-        cell->AssignedArea = sad::Rect2D(xstart, ystart - height, xstart + width, ystart);
+        sad::Rect2D area(xstart, ystart - height, xstart + width, ystart);
+        // 6. Update cells, which were changed or moved
+        if (full || cell->m_dirty || !isSameArea(area, cell->AssignedArea))
+        {
+            cell->m_dirty = false;
+            cell->AssignedArea = area;
+            cell->update();
+        }
     }
-    
-    // 6. Update all cells.
-    for(size_t i = 0; i < m_cells.size(); i++)
+}
+
+void sad::layouts::Grid::beginBatch()
+{
+    ++m_batch_depth;
+}
+
+void sad::layouts::Grid::endBatch()
+{
+    if (m_batch_depth == 0)
     {
-        m_cells[i]->update();
+        return;
+    }
+    --m_batch_depth;
+    if (m_batch_depth == 0 && m_relayout_pending)
+    {
+        this->requestRelayout();
+    }
+}
+
+bool sad::layouts::Grid::isBatching() const
+{
+    return m_batch_depth != 0;
+}
+
+void sad::layouts::Grid::setDeferredUpdates(bool deferred)
+{
+    m_deferred_updates = deferred;
+    if (!deferred && m_relayout_pending)
+    {
+        this->requestRelayout();
+    }
+}
+
+bool sad::layouts::Grid::deferredUpdates() const
+{
+    return m_deferred_updates;
+}
+
+bool sad::layouts::Grid::needsRelayout() const
+{
+    return m_relayout_pending;
+}
+
+void sad::layouts::Grid::markDirty(sad::layouts::Cell* cell, bool relayout)
+{
+    if (!cell->m_dirty)
+    {
+        cell->m_dirty = true;
+        m_dirty_cells << cell;
+    }
+    if (relayout)
+    {
+        this->requestRelayout();
     }
 }
 
@@ -872,7 +1010,12 @@ m_fixed_width(o.m_fixed_width),
 m_fixed_height(o.m_fixed_height),
 m_render_color(o.m_render_color),
 m_renderer(o.m_renderer),
-m_loading(false)
+m_loading(false),
+m_full_relayout(true),
+m_relayout_pending(false),
+m_batch_depth(0),
+m_deferred_updates(false),
+m_relayout_scheduled(false)
 {
     throw std::runtime_error("Not implemented");
 }
@@ -884,6 +1027,48 @@ sad::layouts::Grid& sad::layouts::Grid::operator=(const sad::layouts::Grid& o)
     return *this;
 }
 
+void sad::layouts::Grid::invalidate()
+{
+    m_full_relayout = true;
+    m_dirty_cells.clear();
+    this->requestRelayout();
+}
+
+void sad::layouts::Grid::requestRelayout()
+{
+    m_relayout_pending = true;
+    if (m_loading || m_batch_depth != 0)
+    {
+        return;
+    }
+    if (m_deferred_updates)
+    {
+        sad::Renderer* r = this->renderer();
+        if (r)
+        {
+            if (!m_relayout_scheduled)
+            {
+                m_relayout_scheduled = true;
+                // Keep grid alive until task is performed
+                this->addRef();
+                r->pipeline()->prependTask(this, &sad::layouts::Grid::performDeferredRelayout);
+            }
+            return;
+        }
+    }
+    this->relayout();
+}
+
+void sad::layouts::Grid::performDeferredRelayout()
+{
+    m_relayout_scheduled = false;
+    if (m_relayout_pending && !m_loading && m_batch_depth == 0)
+    {
+        this->relayout();
+    }
+    this->delRef();
+}
+
 void sad::layouts::Grid::expandRows(size_t oldrows, size_t newrows)
 {
     sad::db::Database* db = NULL;
@@ -31,6 +31,14 @@ void sad::log::FileTarget::receive(const sad::log::Message & message)
     fputs("\n", m_file);
 }
 
+void sad::log::FileTarget::flush()
+{
+    if (m_file)
+    {
+        fflush(m_file);
+    }
+}
+
 sad::log::FileTarget::~FileTarget()
 {
     close();
@@ -3,8 +3,15 @@
 
 #include "../../include/db/dbtypename.h"
 
+#include "../../include/sadthread.h"
+
+/*! An amount of messages, which are broadcasted to targets at once in asynchronous mode
+ */
+#define SAD_LOG_BATCH_SIZE 64
+
 sad::log::Log::~Log()
 {
+    setAsynchronous(false);
     for(unsigned int i = 0; i < m_targets.count(); i++)
     {
         m_targets[i]->delRef();
@@ -12,6 +19,89 @@ sad::log::Log::~Log()
 }
 
 void sad::log::Log::broadcast(const sad::log::Message & m)
+{
+    if (m_queue)
+    {
+        enqueue(new sad::log::Message(m));
+    }
+    else
+    {
+        broadcastNow(m);
+    }
+}
+
+void sad::log::Log::setAsynchronous(bool async, size_t capacity, sad::log::OverflowPolicy policy)
+{
+    if (m_queue)
+    {
+        // Stop background thread. It will broadcast all messages before exiting
+        m_stopping.store(true);
+        m_queue_semaphore.release(1);
+        m_worker->wait();
+        delete m_worker;
+        m_worker = NULL;
+
+        drainQueue();
+        delete m_queue;
+        m_queue = NULL;
+    }
+    m_overflow_policy = policy;
+    if (async)
+    {
+        m_stopping.store(false);
+        m_queued_messages.store(0);
+        m_queue = new sad::log::MessageQueue(capacity);
+        m_worker = new sad::Thread(this, &sad::log::Log::processQueue);
+        m_worker->run();
+    }
+}
+
+bool sad::log::Log::isAsynchronous() const
+{
+    return m_queue != NULL;
+}
+
+void sad::log::Log::setOverflowPolicy(sad::log::OverflowPolicy policy)
+{
+    m_overflow_policy = policy;
+}
+
+sad::log::OverflowPolicy sad::log::Log::overflowPolicy() const
+{
+    return m_overflow_policy;
+}
+
+size_t sad::log::Log::droppedMessages() const
+{
+    return m_dropped_messages.load();
+}
+
+size_t sad::log::Log::blockedMessages() const
+{
+    return m_blocked_messages.load();
+}
+
+void sad::log::Log::resetCounters()
+{
+    m_dropped_messages.store(0);
+    m_blocked_messages.store(0);
+}
+
+void sad::log::Log::flush()
+{
+    if (m_queue)
+    {
+        drainQueue();
+    }
+    m_lock.lock();
+    for(unsigned int i = 0; i < m_targets.count(); i++)
+    {
+        m_targets[i]->flush();
+    }
+    m_lock.unlock();
+}
+
+void sad::log::Log::broadcastNow(const sad::log::Message & m)
 {
     m_lock.lock();
     for(unsigned int i = 0; i < m_targets.count(); i++)
@@ -21,6 +111,131 @@ void sad::log::Log::broadcast(const sad::log::Message & m)
     m_lock.unlock();
 }
 
+void sad::log::Log::enqueue(sad::log::Message * m)
+{
+    bool blocked = false;
+    while(m_queue->tryPush(m) == false)
+    {
+        switch(m_overflow_policy)
+        {
+            case sad::log::LOP_DROP_NEWEST:
+            {
+                delete m;
+                ++m_dropped_messages;
+                return;
+            }
+            case sad::log::LOP_DROP_OLDEST:
+            {
+                sad::log::Message * oldest = m_queue->tryPop();
+                if (oldest)
+                {
+                    --m_queued_messages;
+                    delete oldest;
+                    ++m_dropped_messages;
+                }
+                break;
+            }
+            default:
+            {
+                if (!blocked)
+                {
+                    blocked = true;
+                    ++m_blocked_messages;
+                }
+                // Background thread is already woken by full queue, so wait until it takes
+                // some messages. Queue is checked again after registering, so wakeup is not lost
+                ++m_blocked_writers;
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (m_queue->tryPush(m))
+                {
+                    // Unregister or, if background thread already released semaphore
+                    // for this thread, take it back, so semaphore stays balanced
+                    size_t writers = m_blocked_writers.load();
+                    while(writers != 0 && !m_blocked_writers.compare_exchange_weak(writers, writers - 1))
+                    {
+                    }
+                    if (writers == 0)
+                    {
+                        m_space_semaphore.consume(1);
+                    }
+                    notifyQueued();
+                    return;
+                }
+                m_space_semaphore.consume(1);
+                break;
+            }
+        }
+    }
+    notifyQueued();
+}
+
+void sad::log::Log::notifyQueued()
+{
+    // Background thread drains queue until it's empty, so it's woken only for first message
+    if (m_queued_messages.fetch_add(1) == 0)
+    {
+        m_queue_semaphore.release(1);
+    }
+}
+
+void sad::log::Log::drainQueue()
+{
+    sad::log::Message * batch[SAD_LOG_BATCH_SIZE];
+    m_drain_lock.lock();
+    size_t remaining = 0;
+    do
+    {
+        size_t count = 0;
+        sad::log::Message * m = NULL;
+        while(count < SAD_LOG_BATCH_SIZE && (m = m_queue->tryPop()) != NULL)
+        {
+            batch[count] = m;
+            ++count;
+        }
+        if (count != 0)
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            size_t writers = m_blocked_writers.exchange(0);
+            if (writers != 0)
+            {
+                m_space_semaphore.release(static_cast<unsigned int>(writers));
+            }
+
+            m_lock.lock();
+            for(size_t i = 0; i < count; i++)
+            {
+                for(unsigned int j = 0; j < m_targets.count(); j++)
+                {
+                    m_targets[j]->receive(*(batch[i]));
+                }
+            }
+            m_lock.unlock();
+            for(size_t i = 0; i < count; i++)
+            {
+                delete batch[i];
+            }
+        }
+        // A message could be pushed after last pop, but before it's counted here,
+        // so queue is drained, until all counted messages are taken
+        remaining = m_queued_messages.fetch_sub(count) - count;
+    } while(remaining != 0);
+    m_drain_lock.unlock();
+}
+
+int sad::log::Log::processQueue()
+{
+    while(true)
+    {
+        m_queue_semaphore.consume(1);
+        drainQueue();
+        if (m_stopping.load())
+        {
+            return 0;
+        }
+    }
+    return 0;
+}
+
 sad::String sad::log::Log::subsystem() 
 {
     if (m_subsystems.count() != 0)
@@ -47,6 +262,12 @@ void sad::log::Log::createAndBroadcast(
         this->subsystem(),
         upriority
     );
+    if (m_queue)
+    {
+        // Message is already formatted, so it's passed to background thread as is
+        enqueue(m);
+        return;
+    }
     broadcast(*m);
     delete m;
 }
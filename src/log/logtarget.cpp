@@ -1,6 +1,11 @@
 #include <log/logtarget.h>
 #include <db/dbtypename.h>
 
+void sad::log::Target::flush()
+{
+
+}
+
 sad::log::Target::~Target()
 {
 
@@ -0,0 +1,97 @@
+#include <log/messagequeue.h>
+#include <log/logmessage.h>
+
+
+sad::log::MessageQueue::MessageQueue(size_t capacity)
+: m_push_position(0), m_pop_position(0)
+{
+    size_t size = 2;
+    while(size < capacity)
+    {
+        size *= 2;
+    }
+    m_mask = size - 1;
+    m_cells = new sad::log::MessageQueue::Cell[size];
+    for(size_t i = 0; i < size; i++)
+    {
+        m_cells[i].Sequence.store(i, std::memory_order_relaxed);
+        m_cells[i].Data = NULL;
+    }
+}
+
+sad::log::MessageQueue::~MessageQueue()
+{
+    sad::log::Message* m = tryPop();
+    while(m)
+    {
+        delete m;
+        m = tryPop();
+    }
+    delete[] m_cells;
+}
+
+size_t sad::log::MessageQueue::capacity() const
+{
+    return m_mask + 1;
+}
+
+bool sad::log::MessageQueue::tryPush(sad::log::Message* m)
+{
+    size_t position = m_push_position.load(std::memory_order_relaxed);
+    while(true)
+    {
+        sad::log::MessageQueue::Cell& cell = m_cells[position & m_mask];
+        size_t sequence = cell.Sequence.load(std::memory_order_acquire);
+        ptrdiff_t difference = static_cast<ptrdiff_t>(sequence) - static_cast<ptrdiff_t>(position);
+        if (difference == 0)
+        {
+            if (m_push_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                cell.Data = m;
+                cell.Sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else
+        {
+            if (difference < 0)
+            {
+                // Cell wasn't read after previous cycle, so queue is full
+                return false;
+            }
+            position = m_push_position.load(std::memory_order_relaxed);
+        }
+    }
+    return false;
+}
+
+sad::log::Message* sad::log::MessageQueue::tryPop()
+{
+    size_t position = m_pop_position.load(std::memory_order_relaxed);
+    while(true)
+    {
+        sad::log::MessageQueue::Cell& cell = m_cells[position & m_mask];
+        size_t sequence = cell.Sequence.load(std::memory_order_acquire);
+        ptrdiff_t difference = static_cast<ptrdiff_t>(sequence) - static_cast<ptrdiff_t>(position + 1);
+        if (difference == 0)
+        {
+            if (m_pop_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                sad::log::Message* result = cell.Data;
+                cell.Data = NULL;
+                cell.Sequence.store(position + m_mask + 1, std::memory_order_release);
+                return result;
+            }
+        }
+        else
+        {
+            if (difference < 0)
+            {
+                // Cell wasn't written yet, so queue is empty
+                return NULL;
+            }
+            position = m_pop_position.load(std::memory_order_relaxed);
+        }
+    }
+    return NULL;
+}
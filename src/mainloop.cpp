@@ -5,7 +5,9 @@
 #include "glcontext.h"
 #include "sadsleep.h"
 #include "fpsinterpolation.h"
+#include "framepacer.h"
 #include "pipeline/pipeline.h"
+#include "animations/animationsanimations.h"
 
 #include "os/windowhandles.h"
 #include "os/systemwindowevent.h"
@@ -20,6 +22,10 @@
 #include <sched.h>
 #endif
 
+#ifdef X11
+#include <sys/select.h>
+#endif
+
 #ifdef X11
 /*! Predicate for capturing all of X11 events
  *  \return true
@@ -30,7 +36,10 @@ static int predicate(Display *, XEvent * e, char *);
 sad::MainLoop::MainLoop() : 
 m_renderer(NULL),
 m_running(false),
-m_dispatcher(new sad::os::SystemEventDispatcher())
+m_dispatcher(new sad::os::SystemEventDispatcher()),
+m_frame_pacer(new sad::FramePacer()),
+m_frame_limit(0),
+m_frame_count(0)
 {
 
 }
@@ -38,6 +47,7 @@ m_dispatcher(new sad::os::SystemEventDispatcher())
 sad::MainLoop::~MainLoop()
 {
     delete m_dispatcher;
+    delete m_frame_pacer;
 }
 
 void sad::MainLoop::setRenderer(sad::Renderer * r)
@@ -55,10 +65,18 @@ sad::Renderer * sad::MainLoop::renderer() const
 void sad::MainLoop::run(bool once)
 {
     m_running = true;
-    this->m_renderer->window()->setActive(true);
+    // Headless renderer has no window, so no system events are dispatched
+    bool headless = this->m_renderer->headless();
+    if (!headless)
+    {
+        this->m_renderer->window()->setActive(true);
+    }
+    m_frame_count = 0;
     if (!once)
     {
         this->m_renderer->fpsInterpolation()->reset();
+        this->applyFramePacing();
+        m_frame_pacer->reset();
     }
     m_dispatcher->reset();
 
@@ -73,67 +91,95 @@ void sad::MainLoop::run(bool once)
 #endif
     while (m_running)
     {
-#ifdef WIN32
-        // There was some kind of bug, when mouse leave was not generated
-        // If this occurs one more time try uncommenting this code
-        /*
-        GetWindowRect(m_renderer->window()->handles()->WND, &windowrect);
-        GetCursorPos(&cursorpos);
-        if (!PtInRect(&windowrect, cursorpos) && m_dispatcher->m_is_in_window)
+        bool hadevents = false;
+        if (!headless)
         {
-            #ifdef EVENT_LOGGING
-                SL_COND_LOCAL_INTERNAL("Cursor pos is outside of window, posting MouseLeave", m_renderer);
-            #endif
-                sad::os::SystemWindowEvent ev(
-                m_renderer->window()->handles()->WND,
-                WM_MOUSELEAVE,
-                0,
+#ifdef WIN32
+            // There was some kind of bug, when mouse leave was not generated
+            // If this occurs one more time try uncommenting this code
+            /*
+            GetWindowRect(m_renderer->window()->handles()->WND, &windowrect);
+            GetCursorPos(&cursorpos);
+            if (!PtInRect(&windowrect, cursorpos) && m_dispatcher->m_is_in_window)
+            {
+                #ifdef EVENT_LOGGING
+                    SL_COND_LOCAL_INTERNAL("Cursor pos is outside of window, posting MouseLeave", m_renderer);
+                #endif
+                    sad::os::SystemWindowEvent ev(
+                    m_renderer->window()->handles()->WND,
+                    WM_MOUSELEAVE,
+                    0,
+                    0
+                );
+                m_dispatcher->dispatch(ev);
+            }
+            */
+            while (PeekMessage(
+                &msg,
+                // A PeekMessage docs state, that multithreading
+                // should work with zero, since sad::Renderer-s must
+                // be running at separate threads. Also, moving here
+                // a handle to window  causes problems with switching
+                // keyboard layout on Windows XP
                 0
-            );
-            m_dispatcher->dispatch(ev);
-        }
-        */
-        while (PeekMessage(
-            &msg,
-            // A PeekMessage docs state, that multithreading
-            // should work with zero, since sad::Renderer-s must
-            // be running at separate threads. Also, moving here
-            // a handle to window  causes problems with switching
-            // keyboard layout on Windows XP
-            0
-            /*m_renderer->window()->handles()->WND*/,
-            0,
-            0,
-            PM_REMOVE
-        ) != 0
-            )
-        {
-            TranslateMessage(&msg);
-            DispatchMessage(&msg);
-        }
+                /*m_renderer->window()->handles()->WND*/,
+                0,
+                0,
+                PM_REMOVE
+            ) != 0
+                )
+            {
+                hadevents = true;
+                TranslateMessage(&msg);
+                DispatchMessage(&msg);
+            }
 #endif
 
 #ifdef X11
-        // In fact in linux we get big slowdown if 
-        // all events is not dispatched
-        while (XCheckIfEvent(m_renderer->window()->handles()->Dpy, &(msg.Event), predicate, NULL) != False)
-        {
-            m_dispatcher->dispatch(msg);
-        }
+            // In fact in linux we get big slowdown if 
+            // all events is not dispatched
+            while (XCheckIfEvent(m_renderer->window()->handles()->Dpy, &(msg.Event), predicate, NULL) != False)
+            {
+                hadevents = true;
+                m_dispatcher->dispatch(msg);
+            }
 #endif
+        }
         // Try render scene if can
-        if (this->m_renderer->window()->hidden() == false
-            && this->m_renderer->window()->minimized() == false
+        if ((headless
+             || (this->m_renderer->window()->hidden() == false
+                 && this->m_renderer->window()->minimized() == false))
             && m_running)
         {
             this->m_renderer->pipeline()->run();
 #ifdef X11
-            XFlush(m_renderer->window()->handles()->Dpy);
+            if (!headless)
+            {
+                XFlush(m_renderer->window()->handles()->Dpy);
+            }
 #endif
+            ++m_frame_count;
+            if (m_frame_limit != 0 && m_frame_count >= m_frame_limit)
+            {
+                m_running = false;
+            }
+            if (!once && m_running)
+            {
+                m_frame_pacer->waitForNextFrame();
+                this->m_renderer->fpsInterpolation()->frameFinished();
+                // A scene is already rendered, so nothing changes until next event
+                if (this->isIdle(hadevents))
+                {
+                    this->waitForSystemEvents(m_frame_pacer->maxIdleWaitTime());
+                    this->m_renderer->fpsInterpolation()->resetFrameTimer();
+                    m_frame_pacer->reset();
+                }
+            }
         }
         else
         {
             this->m_renderer->fpsInterpolation()->resetTimer();
+            this->m_renderer->fpsInterpolation()->resetFrameTimer();
             this->forceSchedulerSwitchToOtherProcesses();
         }
         if (once)
@@ -141,7 +187,10 @@ void sad::MainLoop::run(bool once)
             m_running = false;
         }
     }
-    this->m_renderer->window()->setActive(false);
+    if (!headless)
+    {
+        this->m_renderer->window()->setActive(false);
+    }
     m_running = false;
 }
 
@@ -157,6 +206,26 @@ sad::os::SystemEventDispatcher *  sad::MainLoop::dispatcher()
     return m_dispatcher;
 }
 
+sad::FramePacer* sad::MainLoop::framePacer() const
+{
+    return m_frame_pacer;
+}
+
+void sad::MainLoop::setFrameLimit(unsigned int frames)
+{
+    m_frame_limit = frames;
+}
+
+unsigned int sad::MainLoop::frameLimit() const
+{
+    return m_frame_limit;
+}
+
+unsigned int sad::MainLoop::frameCount() const
+{
+    return m_frame_count;
+}
+
 bool sad::MainLoop::running() const
 {
     return m_running;
@@ -166,15 +235,23 @@ bool sad::MainLoop::running() const
 
 void sad::MainLoop::initMainLoop()
 {
-    tryElevatePriority();
     trySetEmergencyShudownHandler();
-    registerRenderer();
-    initKeyboardInput();
+    // Headless renderer runs on servers, where it should not take over a processor
+    // and has no window to register or keyboard to handle
+    if (m_renderer == NULL || m_renderer->headless() == false)
+    {
+        tryElevatePriority();
+        registerRenderer();
+        initKeyboardInput();
+    }
 }
 
 void sad::MainLoop::deinitMainLoop()
 {
-    unregisterRenderer();
+    if (m_renderer == NULL || m_renderer->headless() == false)
+    {
+        unregisterRenderer();
+    }
 }
 
 void sad::MainLoop::tryElevatePriority()
@@ -328,6 +405,66 @@ void sad::MainLoop::initKeyboardInput()
 }
 
 
+void sad::MainLoop::applyFramePacing()
+{
+    bool vsync = false;
+    if (m_renderer->context()->valid())
+    {
+        switch(m_frame_pacer->strategy())
+        {
+            case sad::FramePacer::FPS_VSYNC:
+                vsync = m_renderer->context()->setSwapInterval(1);
+                if (!vsync)
+                {
+                    SL_COND_LOCAL_INTERNAL("Vertical synchronization is not supported, falling back to timer", m_renderer);
+                }
+                break;
+            case sad::FramePacer::FPS_TIMER:
+                m_renderer->context()->setSwapInterval(0);
+                break;
+            case sad::FramePacer::FPS_UNLIMITED:
+                break;
+        }
+    }
+    m_frame_pacer->setVSyncEnabled(vsync);
+}
+
+bool sad::MainLoop::isIdle(bool hadevents) const
+{
+    // Headless loop has no system events, which could wake it up
+    if (!m_frame_pacer->idleWaiting() || hadevents || !m_running || m_renderer->headless())
+    {
+        return false;
+    }
+    // Scenes are rendered by renderer step, which is added as user step, but it does not change them
+    sad::Vector<sad::String> ignored;
+    ignored << "sad::Renderer::renderScenes";
+    ignored << "sad::animations::Animations::process";
+    return !m_renderer->pipeline()->hasUserSteps(ignored) && m_renderer->animations()->count() == 0;
+}
+
+void sad::MainLoop::waitForSystemEvents(unsigned int ms)
+{
+#ifdef WIN32
+    MsgWaitForMultipleObjects(0, NULL, FALSE, ms, QS_ALLINPUT);
+#endif
+
+#ifdef X11
+    Display* dpy = m_renderer->window()->handles()->Dpy;
+    if (XPending(dpy) == 0)
+    {
+        int fd = ConnectionNumber(dpy);
+        fd_set set;
+        FD_ZERO(&set);
+        FD_SET(fd, &set);
+        timeval timeout;
+        timeout.tv_sec = ms / 1000;
+        timeout.tv_usec = (ms % 1000) * 1000;
+        select(fd + 1, &set, NULL, NULL, &timeout);
+    }
+#endif
+}
+
 void sad::MainLoop::forceSchedulerSwitchToOtherProcesses()
 {
 #ifdef WIN32
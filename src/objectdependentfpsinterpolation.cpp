@@ -24,6 +24,7 @@ void sad::ObjectDependentFPSInterpolation::reset()
     
     m_total_renderer_items = 0;
     m_interval_per_item.setValue(0);
+    clearFrameTimes();
 }
 
 
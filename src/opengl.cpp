@@ -87,6 +87,11 @@ bool sad::OpenGL::supportsExtension(const sad::String & extension)
     return m_extensions.getOccurence(extension) != -1;
 }
 
+sad::rendering::GLStateCache* sad::OpenGL::stateCache()
+{
+    return &m_state_cache;
+}
+
 
 void sad::OpenGL::tryFetchStrings()
 {
@@ -2,6 +2,8 @@
 #include "renderer.h"
 #include "log/log.h"
 
+#include "rendering/backend.h"
+
 #ifdef WIN32
 #include <windows.h>
 #endif
@@ -19,7 +21,7 @@ sad::OrthographicCamera::OrthographicCamera()
 sad::OrthographicCamera::OrthographicCamera(int width, int height)
 : m_width(width), m_height(height), m_fetched(true)
 {
-
+    m_projection = sad::Matrix4x4<double>::ortho2D(m_width, m_height);
 }
 
 void sad::OrthographicCamera::apply()
@@ -29,17 +31,27 @@ void sad::OrthographicCamera::apply()
         m_fetched = true;
         m_width = Scene->renderer()->settings().width();
         m_height = Scene->renderer()->settings().height();
+        m_projection = sad::Matrix4x4<double>::ortho2D(m_width, m_height);
     }
 
-    glPushAttrib(GL_TRANSFORM_BIT);
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    gluOrtho2D(0,m_width,0,m_height);
-    glPopAttrib();
+    sad::rendering::backend(Scene->renderer())->setOrthographicProjection(m_width, m_height);
+    if (Scene->renderer())
+    {
+        Scene->renderer()->setProjectionMatrix(m_projection);
+    }
     
     this->sad::Camera::apply();
 }
 
+bool sad::OrthographicCamera::viewRect(sad::Rect2D & r) const
+{
+    if (!m_fetched)
+    {
+        return false;
+    }
+    return this->viewRectForViewport(m_width, m_height, r);
+}
+
 sad::OrthographicCamera::~OrthographicCamera()
 {
 }
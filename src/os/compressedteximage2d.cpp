@@ -0,0 +1,48 @@
+#include "os/compressedteximage2d.h"
+#include "log/log.h"
+#include "renderer.h"
+
+static PFNGLCOMPRESSEDTEXIMAGE2DPROC _compressedTexImage2D  = NULL;
+
+bool sad::os::compressedTexImage2D(
+    sad::Renderer * r,
+    GLenum target,
+    GLint level,
+    GLenum internalformat,
+    GLsizei width,
+    GLsizei height,
+    GLsizei size,
+    const GLvoid* data
+)
+{
+    PFNGLCOMPRESSEDTEXIMAGE2DPROC __compressedTexImage2D = _compressedTexImage2D;
+    if (_compressedTexImage2D == NULL)
+    {
+#ifdef WIN32
+        __compressedTexImage2D = (PFNGLCOMPRESSEDTEXIMAGE2DPROC)getProcAdress("glCompressedTexImage2D");
+        if (__compressedTexImage2D == NULL)
+        {
+            __compressedTexImage2D = (PFNGLCOMPRESSEDTEXIMAGE2DPROC)getProcAdress("glCompressedTexImage2DARB");
+        }
+#endif
+#ifdef LINUX
+        __compressedTexImage2D = (PFNGLCOMPRESSEDTEXIMAGE2DPROC)getProcAdress((const GLubyte*)("glCompressedTexImage2D"));
+        if (__compressedTexImage2D == NULL)
+        {
+            __compressedTexImage2D = (PFNGLCOMPRESSEDTEXIMAGE2DPROC)getProcAdress((const GLubyte*)("glCompressedTexImage2DARB"));
+        }
+#endif
+        _compressedTexImage2D = __compressedTexImage2D;
+    }
+    bool result = false;
+    if (__compressedTexImage2D)
+    {
+        __compressedTexImage2D(target, level, internalformat, width, height, 0, size, data);
+        result = true;
+    }
+    else
+    {
+        SL_COND_LOCAL_INTERNAL("Failed to obtain glCompressedTexImage2D", r);
+    }
+    return result;
+}
@@ -391,6 +391,70 @@ void sad::os::GLContextImpl::swapBuffers()
 #endif
 }
 
+#ifdef X11
+typedef void (*glXSwapIntervalEXTProc)(Display*, GLXDrawable, int);
+typedef int (*glXSwapIntervalSGIProc)(int);
+#endif
+
+#ifdef WIN32
+typedef BOOL (WINAPI * wglSwapIntervalEXTProc)(int);
+#endif
+
+bool sad::os::GLContextImpl::setSwapInterval(int interval)
+{
+    if (this->valid() == false || m_win == NULL || m_win->valid() == false)
+    {
+        return false;
+    }
+    bool result = false;
+#ifdef WIN32
+    wglSwapIntervalEXTProc swapinterval = (wglSwapIntervalEXTProc)wglGetProcAddress("wglSwapIntervalEXT");
+    if (swapinterval)
+    {
+        result = swapinterval(interval) != FALSE;
+    }
+#endif
+
+#ifdef X11
+    Display* dpy = m_win->handles()->Dpy;
+    const char* extensions = glXQueryExtensionsString(dpy, DefaultScreen(dpy));
+    if (extensions == NULL)
+    {
+        return false;
+    }
+    if (isExtensionSupported(extensions, "GLX_EXT_swap_control"))
+    {
+        glXSwapIntervalEXTProc swapinterval = (glXSwapIntervalEXTProc)
+            glXGetProcAddressARB((const GLubyte *) "glXSwapIntervalEXT");
+        if (swapinterval)
+        {
+            swapinterval(dpy, m_win->handles()->Win, interval);
+            result = true;
+        }
+    }
+    if (!result && isExtensionSupported(extensions, "GLX_MESA_swap_control"))
+    {
+        glXSwapIntervalSGIProc swapinterval = (glXSwapIntervalSGIProc)
+            glXGetProcAddressARB((const GLubyte *) "glXSwapIntervalMESA");
+        if (swapinterval)
+        {
+            result = swapinterval(interval) == 0;
+        }
+    }
+    // SGI extension does not allow disabling synchronization
+    if (!result && interval > 0 && isExtensionSupported(extensions, "GLX_SGI_swap_control"))
+    {
+        glXSwapIntervalSGIProc swapinterval = (glXSwapIntervalSGIProc)
+            glXGetProcAddressARB((const GLubyte *) "glXSwapIntervalSGI");
+        if (swapinterval)
+        {
+            result = swapinterval(interval) == 0;
+        }
+    }
+#endif
+    return result;
+}
+
 
 #ifndef DEFAULT_DEPTH_VALUE
 #define DEFAULT_DEPTH_VALUE 0.8f //!< Value, which gives us a z=0.5 in mapping coordinates
@@ -401,35 +465,23 @@ sad::Point3D sad::os::GLContextImpl::mapToViewport(const sad::Point2D & p, bool
     if (m_win->valid() == false || !valid())
         return p;
 
-    GLint     viewport[4];
-    GLdouble  modelview[16];
-    GLdouble  projection[16];
-
+    // Matrices and viewport are kept by renderer on CPU, so nothing is read back from OpenGL,
+    // unless depth is tested
+    sad::Renderer * r = this->renderer();
     GLfloat winx=0,winy=0,winz=0;
-    GLdouble result[3];
-    
-    glGetDoublev(GL_MODELVIEW_MATRIX,modelview);
-    glGetDoublev(GL_PROJECTION_MATRIX,projection);
-    glGetIntegerv(GL_VIEWPORT,viewport);
 
     winx=(float)p.x();
 #ifdef WIN32  // On win32 we explicitly handle coordinates
     winy=(float)(p.y());
 #else
-    winy=(float)(viewport[3] - p.y());
+    winy=(float)(r->viewportSize().Height - p.y());
 #endif
     if (ztest)
         glReadPixels((int)winx,(int)winy,1,1,GL_DEPTH_COMPONENT,GL_FLOAT,&winz);
     else
         winz = DEFAULT_DEPTH_VALUE;
 
-
-    gluUnProject(winx,winy,winz,modelview,projection,viewport,result,result+1,result+2);
-    
-    result[0] -= this->renderer()->globalTranslationOffset().x();
-    result[1] -= this->renderer()->globalTranslationOffset().y();
-        
-    return sad::Point3D(result[0], result[1], result[2]);
+    return r->unproject(sad::Point3D(winx, winy, winz));
 }
 
 sad::os::GLContextHandle * sad::os::GLContextImpl::handle() const
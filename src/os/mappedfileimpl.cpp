@@ -0,0 +1,99 @@
+#include <os/mappedfileimpl.h>
+
+#ifdef WIN32
+    #include <io.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+sad::os::MappedFileImpl::MappedFileImpl() : m_data(NULL), m_size(0)
+#ifdef WIN32
+, m_mapping(NULL)
+#endif
+{
+
+}
+
+sad::os::MappedFileImpl::~MappedFileImpl()
+{
+    unmap();
+}
+
+bool sad::os::MappedFileImpl::map(FILE* file)
+{
+    unmap();
+    if (!file)
+    {
+        return false;
+    }
+#ifdef WIN32
+    HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(file)));
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0)
+    {
+        return false;
+    }
+    m_mapping = CreateFileMappingA(handle, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    if (m_mapping == NULL)
+    {
+        return false;
+    }
+    void* data = MapViewOfFile(m_mapping, FILE_MAP_COPY, 0, 0, 0);
+    if (data == NULL)
+    {
+        CloseHandle(m_mapping);
+        m_mapping = NULL;
+        return false;
+    }
+    m_data = static_cast<unsigned char*>(data);
+    m_size = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = fileno(file);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        return false;
+    }
+    void* data = mmap(NULL, static_cast<size_t>(st.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+    m_data = static_cast<unsigned char*>(data);
+    m_size = static_cast<size_t>(st.st_size);
+#endif
+    return true;
+}
+
+void sad::os::MappedFileImpl::unmap()
+{
+    if (!m_data)
+    {
+        return;
+    }
+#ifdef WIN32
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mapping);
+    m_mapping = NULL;
+#else
+    munmap(m_data, m_size);
+#endif
+    m_data = NULL;
+    m_size = 0;
+}
+
+unsigned char* sad::os::MappedFileImpl::data() const
+{
+    return m_data;
+}
+
+size_t sad::os::MappedFileImpl::size() const
+{
+    return m_size;
+}
@@ -1,4 +1,7 @@
 #include <p2d/app/object.h>
+#include <fuzzyequal.h>
+#include <geometry2d.h>
+#include <rendering/backend.h>
 
 
 DECLARE_SOBJ_INHERITANCE(sad::p2d::app::Object, sad::SceneNode);
@@ -70,7 +73,26 @@ void sad::p2d::app::Object::notifyRotate(const double & angle)
 
 void sad::p2d::app::Object::render()
 {
+    // If world is stepped with fixed step, sprite is rendered between previous
+    // and current state of body. Offset is applied by model-view matrix, since moving
+    // sprite and back would rebuild it twice per frame and accumulate rounding errors
+    sad::p2d::Vector offset = m_body->interpolatedPosition() - m_body->position();
+    double angle_offset = m_body->interpolatedAngle() - m_body->angle();
+    bool interpolated = !sad::is_fuzzy_zero(offset.x()) || !sad::is_fuzzy_zero(offset.y()) || !sad::is_fuzzy_zero(angle_offset);
+    if (!interpolated)
+    {
+        m_sprite->render();
+        return;
+    }
+    const sad::Point2D & middle = m_sprite->middle();
+    sad::rendering::Backend* backend = sad::rendering::backend(this->renderer());
+    backend->pushMatrix();
+    // Rotate around middle of sprite, then move it
+    backend->translate(middle.x() + offset.x(), middle.y() + offset.y(), 0.0);
+    backend->rotate(angle_offset / M_PI * 180.0, 0.0, 0.0, 1.0);
+    backend->translate(-middle.x(), -middle.y(), 0.0);
     m_sprite->render();
+    backend->popMatrix();
 }
 
 void sad::p2d::app::Object::setAngularVelocity(double v)
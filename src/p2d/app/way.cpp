@@ -234,9 +234,9 @@ sad::db::schema::Schema* sad::p2d::app::Way::schema() const
     return sad::p2d::app::Way::basicSchema();
 }
 
-bool sad::p2d::app::Way::load(const picojson::value& v)
+bool sad::p2d::app::Way::finishLoading(bool loaded)
 {
-    bool result = this->sad::db::Object::load(v);
+    bool result = loaded;
     if (result)
     {
         construct();
@@ -2,7 +2,9 @@
 #include "p2d/world.h"
 #include "p2d/circle.h"
 #include "p2d/line.h"
+#include "p2d/bounds.h"
 #include <cstdio>
+#include <thread>
 
 DECLARE_SOBJ(sad::p2d::Body);
 
@@ -12,6 +14,41 @@ double sad::p2d::Body::timeStep() const
     return TimeStep;
 }
 
+const sad::p2d::BoundingBox& sad::p2d::Body::sweptBoundingBox() const
+{
+    return m_swept_bounding_box;
+}
+
+const sad::p2d::ConvexHull& sad::p2d::Body::sweptHull()
+{
+    for(;;)
+    {
+        int state = m_swept_hull_state.load(std::memory_order_acquire);
+        if (state == sad::p2d::Body::SHS_BUILT)
+        {
+            return m_swept_hull;
+        }
+        int expected = sad::p2d::Body::SHS_INVALID;
+        if (state == expected 
+            && m_swept_hull_state.compare_exchange_strong(expected, sad::p2d::Body::SHS_BUILDING, std::memory_order_acq_rel))
+        {
+            m_swept_hull.clear();
+            m_swept_hull.insertPointsFromShape(m_current);
+            int k = m_lastsampleindex + 1;
+            for(int i = 0; i < k; i++)
+            {
+                m_swept_hull.insertPointsFromShape(this->sample(i));
+            }
+            m_swept_hull.buildHull();
+            m_swept_hull.buildAxisCache();
+            m_swept_hull_state.store(sad::p2d::Body::SHS_BUILT, std::memory_order_release);
+            return m_swept_hull;
+        }
+        // Other thread builds a hull right now, so just wait for it
+        std::this_thread::yield();
+    }
+}
+
 void sad::p2d::Body::notifyRotate(const double & delta)
 {
     m_current->rotate(delta);
@@ -58,11 +95,17 @@ sad::p2d::CollisionShape & sad::p2d::Body::at(double time, int index) const
     // Light optimization, because most of our collision shapes are POD-like structures
     // We can reduce amount of allocations, using untyped copying instead all of high-level
     // operations
-    memcpy(me->Temporary + index, me->m_current, me->m_shapesize);
+    sad::p2d::CollisionShape * s = me->sample(index);
+    memcpy(s, me->m_current, me->m_shapesize);
 
-    (me->Temporary + index)->move(m_tangential->positionDelta(time, me->TimeStep));
-    (me->Temporary + index)->rotate(m_angular->positionDelta(time, me->TimeStep));
-    return *(me->Temporary + index);
+    s->move(m_tangential->positionDelta(time, me->TimeStep));
+    s->rotate(m_angular->positionDelta(time, me->TimeStep));
+    return *s;
+}
+
+sad::p2d::CollisionShape * sad::p2d::Body::sample(int index) const
+{
+    return reinterpret_cast<sad::p2d::CollisionShape *>(reinterpret_cast<char *>(Temporary) + index * m_shapesize);
 }
 
 void sad::p2d::Body::stepDiscreteChangingValues(double time)
@@ -89,7 +132,7 @@ void sad::p2d::Body::trySetTransformer()
     }
 }
 
-sad::p2d::Body::Body() : m_is_ghost(false), m_world(NULL), m_user_object(NULL)
+sad::p2d::Body::Body() : m_is_ghost(false), m_world(NULL), m_kinematic_state(NULL), m_user_object(NULL)
 {    
     m_tangential = new p2d::TangentialMovement();
     m_tangential->addListener( new move_t(this, &p2d::Body::notifyMove) );
@@ -111,6 +154,15 @@ sad::p2d::Body::Body() : m_is_ghost(false), m_world(NULL), m_user_object(NULL)
 
     m_fixed = false;
     this->TimeStep = 0.0;
+
+    m_previous_position = m_tangential->position();
+    m_previous_angle = m_angular->position();
+
+    m_is_sleeping = false;
+    m_can_sleep = true;
+    m_resting_steps = 0;
+
+    m_swept_hull_state.store(sad::p2d::Body::SHS_INVALID);
 }
 
 sad::p2d::Body::~Body()
@@ -118,8 +170,8 @@ sad::p2d::Body::~Body()
     //printf("Destroying body %p with %p\n", this, m_user_object);
     delete m_tangential;
     delete m_angular;
+    m_current->freeClones(Temporary);
     delete m_current;
-    delete[] Temporary;
     if (m_user_object)
     {
         m_user_object->delRef();
@@ -158,8 +210,33 @@ sad::p2d::World * sad::p2d::Body::world()
     return m_world;
 }
 
+void sad::p2d::Body::setKinematicState(sad::p2d::KinematicState* state, size_t slot)
+{
+    if (state)
+    {
+        m_tangential->bind(&(state->tangential()), slot);
+        m_angular->bind(&(state->angular()), slot);
+        m_tangential->setSleeping(m_is_sleeping);
+        m_angular->setSleeping(m_is_sleeping);
+    }
+    else
+    {
+        m_tangential->unbind();
+        m_angular->unbind();
+    }
+    m_kinematic_state = state;
+}
+
+sad::p2d::KinematicState* sad::p2d::Body::kinematicState() const
+{
+    return m_kinematic_state;
+}
+
 void sad::p2d::Body::setShape(sad::p2d::CollisionShape * shape)
 {
+    // Samples are cloned from old shape, so they are freed by it
+    m_current->freeClones(Temporary);
+    Temporary = NULL;
     delete m_current;
     m_current = shape;
     this->trySetTransformer();
@@ -167,8 +244,6 @@ void sad::p2d::Body::setShape(sad::p2d::CollisionShape * shape)
     m_current->rotate(this->m_angular->position());
     m_shapesize = m_current->sizeOfType();
 
-    delete Temporary;
-    Temporary = NULL;
     if (m_lastsampleindex > -1)
         Temporary = m_current->clone(m_lastsampleindex + 1);    
 }
@@ -176,18 +251,23 @@ void sad::p2d::Body::setShape(sad::p2d::CollisionShape * shape)
 
 void sad::p2d::Body::setCurrentPosition(const sad::p2d::Point & p)
 {
+    this->disturb();
     m_tangential->setCurrentPosition(p);
+    // Teleported body should not be interpolated from old position
+    m_previous_position = m_tangential->position();
     buildCaches();
 }
 
 void sad::p2d::Body::shedulePosition(const sad::p2d::Point & p)
 {
+    this->disturb();
     m_tangential->setNextPosition(p);
     buildCaches();
 }
 
 void sad::p2d::Body::shedulePositionAt(const sad::p2d::Point & p, double time)
 {
+    this->disturb();
     m_tangential->setNextPositionAt(p, time);
     buildCaches();
 }
@@ -210,17 +290,20 @@ sad::p2d::Vector sad::p2d::Body::nextPosition() const
 
 void sad::p2d::Body::setCurrentTangentialVelocity(const p2d::Vector & v)
 {
+    this->disturb();
     m_tangential->setCurrentVelocity(v);
     buildCaches();
 }
 
 void sad::p2d::Body::sheduleTangentialVelocity(const p2d::Vector & v)
 {
+    this->disturb();
     m_tangential->setNextVelocity(v);
 }
 
 void sad::p2d::Body::sheduleTangentialVelocityAt(const p2d::Vector & v, double time)
 {
+    this->disturb();
     m_tangential->setNextVelocityAt(v, time);
 }
 
@@ -241,18 +324,22 @@ sad::p2d::Vector sad::p2d::Body::nextTangentialVelocity() const
 
 void sad::p2d::Body::setCurrentAngle(double angle)
 {
+    this->disturb();
     m_angular->setCurrentPosition(angle);
+    m_previous_angle = m_angular->position();
     buildCaches();
 }
 
 void sad::p2d::Body::sheduleAngle(double angle)
 {
+    this->disturb();
     m_angular->setNextPosition(angle);  
     buildCaches();
 }
 
 void sad::p2d::Body::sheduleAngleAt(double angle, double time)
 {
+    this->disturb();
     m_angular->setNextPositionAt(angle, time);
     buildCaches();
 }
@@ -274,17 +361,20 @@ double sad::p2d::Body::nextAngle() const
 
 void sad::p2d::Body::setCurrentAngularVelocity(double v)
 {
+    this->disturb();
     m_angular->setCurrentVelocity(v);
     buildCaches();
 }
 
 void sad::p2d::Body::sheduleAngularVelocity(double v)
 {
+    this->disturb();
     m_angular->setNextVelocity(v);
 }
 
 void sad::p2d::Body::sheduleAngularVelocityAt(double v, double time)
 {
+    this->disturb();
     m_angular->setNextVelocityAt(v, time);
 }
 
@@ -308,14 +398,50 @@ double sad::p2d::Body::nextAngularVelocity() const
     return m_angular->nextVelocity();
 }
 
+const sad::p2d::Vector & sad::p2d::Body::previousPosition() const
+{
+    return m_previous_position;
+}
+
+double sad::p2d::Body::previousAngle() const
+{
+    return m_previous_angle;
+}
+
+double sad::p2d::Body::interpolationAlpha() const
+{
+    if (m_world)
+    {
+        return m_world->interpolationAlpha();
+    }
+    return 1.0;
+}
+
+sad::p2d::Vector sad::p2d::Body::interpolatedPosition() const
+{
+    double alpha = this->interpolationAlpha();
+    const sad::p2d::Vector& current = m_tangential->position();
+    return m_previous_position + (current - m_previous_position) * alpha;
+}
+
+double sad::p2d::Body::interpolatedAngle() const
+{
+    double alpha = this->interpolationAlpha();
+    return m_previous_angle + (m_angular->position() - m_previous_angle) * alpha;
+}
+
 void sad::p2d::Body::move(const p2d::Vector & v)
 {
+    this->disturb();
+    m_previous_position += v;
     return m_tangential->setCurrentPosition(m_tangential->position() + v);
 }
 
 
 void sad::p2d::Body::rotate(double delta)
 {
+    this->disturb();
+    m_previous_angle += delta;
     return m_angular->setCurrentPosition(m_angular->position() + delta);
 }
 
@@ -343,31 +469,37 @@ void sad::p2d::Body::clearListeners()
 
 void sad::p2d::Body::addForce(sad::p2d::Force<sad::p2d::Vector>* force)
 {
+    this->disturb();
     m_tangential->forces().add(force);
 }
 
 void sad::p2d::Body::addForce(sad::p2d::Force<double>* force)
 {
+    this->disturb();
     m_angular->forces().add(force);
 }
 
 void sad::p2d::Body::sheduleAddForce(sad::p2d::Force<sad::p2d::Vector>* force, double time)
 {
+    this->disturb();
     m_tangential->forces().scheduleAdd(force, time);
 }
 
 void sad::p2d::Body::sheduleAddForce(sad::p2d::Force<double>* force, double time)
 {
+    this->disturb();
     m_angular->forces().scheduleAdd(force, time);
 }
 
 void sad::p2d::Body::sheduleAddForce(sad::p2d::Force<sad::p2d::Vector>* force)
 {
+    this->disturb();
     m_tangential->forces().scheduleAdd(force);
 }
 
 void sad::p2d::Body::sheduleAddForce(sad::p2d::Force<double>* force)
 {
+    this->disturb();
     m_angular->forces().scheduleAdd(force);
 }
 
@@ -427,6 +559,16 @@ sad::p2d::Vector sad::p2d::Body::tangentialVelocityAt(double time)
     return m_tangential->velocityAt(time, this->timeStep());
 }
 
+sad::p2d::Vector sad::p2d::Body::positionDeltaAt(double time) const
+{
+    return m_tangential->positionDeltaWithoutCaching(time, this->timeStep());
+}
+
+double sad::p2d::Body::angleDeltaAt(double time) const
+{
+    return m_angular->positionDeltaWithoutCaching(time, this->timeStep());
+}
+
 void sad::p2d::Body::buildCaches()
 {
     m_tangential->cacheAcceleration();
@@ -438,7 +580,33 @@ void sad::p2d::Body::buildCaches()
     {
         // Saves inner data, using at. After that, caches results can be used by 
         // any kind of detector to build data
-        this->at(t * (i+1), i );
+        this->at(slice * (i+1), i );
+    }
+
+    this->buildSweptBoundingBox();
+}
+
+void sad::p2d::Body::buildSweptBoundingBox()
+{
+    int k = m_lastsampleindex + 1;
+    m_swept_hull_state.store(sad::p2d::Body::SHS_INVALID, std::memory_order_release);
+    // Build a swept bounding box for broad phase. Bounds are infinite, so they are treated as unbounded
+    m_swept_bounding_box = sad::p2d::BoundingBox();
+    if (m_current->metaIndex() == sad::p2d::Bound::globalMetaIndex())
+    {
+        m_swept_bounding_box.Unbounded = true;
+    }
+    else
+    {
+        sad::p2d::Axle horizontal(1, 0);
+        sad::p2d::Axle vertical(0, 1);
+        m_swept_bounding_box.add(m_current->project(horizontal), m_current->project(vertical));
+        for(int i = 0; i < k; i++)
+        {
+            sad::p2d::CollisionShape* shape = this->sample(i);
+            m_swept_bounding_box.add(shape->project(horizontal), shape->project(vertical));
+        }
+        m_swept_bounding_box.inflate(COLLISION_PRECISION);
     }
 }
 
@@ -494,13 +662,120 @@ void sad::p2d::Body::correctTangentialVelocity(const p2d::Vector & v)
 
 void sad::p2d::Body::setSamplingCount(int samples)
 {   
-    delete Temporary;
+    m_current->freeClones(Temporary);
     Temporary = m_current->clone(samples);
     m_lastsampleindex = samples - 1;
+    m_swept_hull_state.store(sad::p2d::Body::SHS_INVALID, std::memory_order_release);
+}
+
+bool sad::p2d::Body::isSleeping() const
+{
+    return m_is_sleeping;
+}
+
+void sad::p2d::Body::sleep()
+{
+    if (m_is_sleeping)
+    {
+        return;
+    }
+    m_is_sleeping = true;
+    m_resting_steps = 0;
+    m_tangential->setCurrentVelocity(sad::p2d::Vector(0, 0));
+    m_angular->setCurrentVelocity(0);
+    m_tangential->setSleeping(true);
+    m_angular->setSleeping(true);
+    m_previous_position = m_tangential->position();
+    m_previous_angle = m_angular->position();
+    // Sleeping body does not move, so all samples are the same as current shape
+    // and stay valid, while caches are not rebuilt
+    int k = m_lastsampleindex + 1;
+    for(int i = 0; i < k; i++)
+    {
+        memcpy(this->sample(i), m_current, m_shapesize);
+    }
+    this->buildSweptBoundingBox();
+}
+
+void sad::p2d::Body::wakeUp()
+{
+    if (!m_is_sleeping)
+    {
+        return;
+    }
+    m_is_sleeping = false;
+    m_resting_steps = 0;
+    m_tangential->setSleeping(false);
+    m_angular->setSleeping(false);
+    // Body can be woken in the middle of step, so it should be ready to be stepped by world
+    if (m_world)
+    {
+        this->TimeStep = m_world->timeStep();
+        m_world->wakeUpNeighbours(this);
+    }
+    this->buildCaches();
+}
+
+void sad::p2d::Body::disturb()
+{
+    if (m_is_sleeping)
+    {
+        this->wakeUp();
+        return;
+    }
+    if (m_world)
+    {
+        m_world->wakeUpNeighbours(this);
+    }
+}
+
+void sad::p2d::Body::setCanSleep(bool can_sleep)
+{
+    m_can_sleep = can_sleep;
+    m_resting_steps = 0;
+    if (!can_sleep)
+    {
+        this->wakeUp();
+    }
+}
+
+bool sad::p2d::Body::canSleep() const
+{
+    return m_can_sleep;
+}
+
+bool sad::p2d::Body::updateSleepState(double linear_threshold, double angular_threshold, unsigned int steps)
+{
+    if (!m_can_sleep || m_is_sleeping)
+    {
+        return false;
+    }
+    bool resting = p2d::modulo(m_tangential->velocity()) < linear_threshold
+                && fabs(m_angular->velocity()) < angular_threshold
+                && !(m_tangential->willPositionChange())
+                && !(m_tangential->willVelocityChange())
+                && !(m_angular->willPositionChange())
+                && !(m_angular->willVelocityChange())
+                && !(m_tangential->forces().hasScheduledForces())
+                && !(m_angular->forces().hasScheduledForces());
+    if (!resting)
+    {
+        m_resting_steps = 0;
+        return false;
+    }
+    ++m_resting_steps;
+    if (m_resting_steps >= steps)
+    {
+        this->sleep();
+        return true;
+    }
+    return false;
 }
 
 void sad::p2d::Body::buildCaches(double time_step)
 {
+    m_previous_position = m_tangential->position();
+    m_previous_angle = m_angular->position();
     this->TimeStep = time_step;
     this->buildCaches();
 }
@@ -15,6 +15,11 @@ sad::p2d::CollisionShape * sad::p2d::Bound::clone(int count) const
     return b;
 }
 
+void sad::p2d::Bound::freeClones(sad::p2d::CollisionShape * clones) const
+{
+    delete[] static_cast<sad::p2d::Bound *>(clones);
+}
+
 sad::p2d::Point sad::p2d::Bound::center() const
 {
     return sad::p2d::Point();
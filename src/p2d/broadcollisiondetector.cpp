@@ -19,6 +19,13 @@ sad::p2d::BroadCollisionDetector::~BroadCollisionDetector()
 }
 
 
+void sad::p2d::BroadCollisionDetector::prepare()
+{
+    m_tester->ensureInitialized();
+    m_detector->prepare();
+}
+
+
 sad::p2d::MaybeTime sad::p2d::BroadCollisionDetector::collides(
     sad::p2d::Body * b1, 
     sad::p2d::Body * b2, 
@@ -63,18 +70,12 @@ sad::p2d::MaybeTime sad::p2d::BroadCollisionDetector::collides(
     }
 
 
-    // Build two hulls for determining a collision
-    sad::p2d::ConvexHull s1;
-    s1.insertPointsFromShape(b1->currentShape());
-    s1.insertPointsFromShape( b1->Temporary );
-    s1.buildHull();
-
-    sad::p2d::ConvexHull s2;
-    s2.insertPointsFromShape(b2->currentShape());
-    s2.insertPointsFromShape( b2->Temporary );
-    s2.buildHull();
+    // Hulls of swept shapes are built once per step for every body and reused
+    // for all of it's pairs, so only overlap of them is tested here
+    const sad::p2d::ConvexHull& s1 = b1->sweptHull();
+    const sad::p2d::ConvexHull& s2 = b2->sweptHull();
 
-    if(s1.collides(s2))
+    if(s1.collidesUsingCachedAxis(s2))
     {
         result.setValue(limit / 2.0);
     }
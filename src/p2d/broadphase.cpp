@@ -0,0 +1,55 @@
+#include "p2d/broadphase.h"
+
+#include <algorithm>
+
+DECLARE_SOBJ(sad::p2d::BroadPhase);
+
+sad::p2d::BroadPhase::~BroadPhase()
+{
+
+}
+
+void sad::p2d::BroadPhase::findSortedPairs(
+    const sad::Vector<sad::p2d::BroadPhase::Entry>& first,
+    const sad::Vector<sad::p2d::BroadPhase::Entry>& second,
+    bool same_group,
+    sad::Vector<sad::p2d::BroadPhase::CandidatePair>& pairs
+)
+{
+    pairs.clear();
+    this->findPairs(first, second, same_group, pairs);
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+}
+
+void sad::p2d::BroadPhase::tryAddPair(
+    const sad::p2d::BroadPhase::Entry& e1,
+    const sad::p2d::BroadPhase::Entry& e2,
+    bool same_group,
+    sad::Vector<sad::p2d::BroadPhase::CandidatePair>& pairs
+)
+{
+    if (e1.Body == e2.Body)
+    {
+        return;
+    }
+    if (e1.Body->sweptBoundingBox().intersects(e2.Body->sweptBoundingBox()) == false)
+    {
+        return;
+    }
+    if (same_group)
+    {
+        if (e1.Index < e2.Index)
+        {
+            pairs << sad::p2d::BroadPhase::CandidatePair(e1.Index, e2.Index);
+        }
+        else
+        {
+            pairs << sad::p2d::BroadPhase::CandidatePair(e2.Index, e1.Index);
+        }
+    }
+    else
+    {
+        pairs << sad::p2d::BroadPhase::CandidatePair(e1.Index, e2.Index);
+    }
+}
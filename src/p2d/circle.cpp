@@ -13,6 +13,11 @@ sad::p2d::CollisionShape * sad::p2d::Circle::clone(int count) const
     return b;
 }
 
+void sad::p2d::Circle::freeClones(sad::p2d::CollisionShape * clones) const
+{
+    delete[] static_cast<sad::p2d::Circle *>(clones);
+}
+
 const sad::p2d::Point & sad::p2d::Circle::centerRef() const
 {
     return m_center;
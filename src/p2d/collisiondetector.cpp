@@ -6,6 +6,11 @@ sad::p2d::CollisionDetector::~CollisionDetector()
 {
 }
 
+void sad::p2d::CollisionDetector::prepare()
+{
+
+}
+
 int sad::p2d::CollisionDetector::sampleCount() const
 {
     return 1;
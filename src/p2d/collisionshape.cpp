@@ -5,6 +5,11 @@ sad::p2d::CollisionShape::~CollisionShape()
 
 }
 
+void sad::p2d::CollisionShape::freeClones(sad::p2d::CollisionShape * clones) const
+{
+    delete[] clones;
+}
+
 void sad::p2d::CollisionShape::resizeBy(const sad::p2d::Vector& v)
 {
 
@@ -0,0 +1,380 @@
+#include "p2d/conservativeadvancementcollisiondetector.h"
+#include "p2d/circle.h"
+#include "p2d/rectangle.h"
+#include "p2d/line.h"
+#include "p2d/bounds.h"
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstring>
+
+DECLARE_SOBJ_INHERITANCE(sad::p2d::ConservativeAdvancementCollisionDetector, sad::p2d::CollisionDetector);
+
+namespace sad
+{
+
+namespace p2d
+{
+
+/*! A shape of body at arbitrary time of step. Unlike samples of body, it's stored
+    in detector, so it could be computed from several threads at once. Known shapes are
+    stored without allocations
+ */
+class ShapeAtTime
+{
+public:
+    /*! Creates new shape for a body
+        \param[in] b body
+     */
+    ShapeAtTime(sad::p2d::Body * b) : m_body(b), m_clone(NULL)
+    {
+        sad::p2d::CollisionShape * s = b->currentShape();
+        unsigned int index = s->metaIndex();
+        if (index == sad::p2d::Circle::globalMetaIndex())
+        {
+            m_shape = &m_circle;
+        }
+        else if (index == sad::p2d::Rectangle::globalMetaIndex())
+        {
+            m_shape = &m_rectangle;
+        }
+        else if (index == sad::p2d::Line::globalMetaIndex())
+        {
+            m_shape = &m_line;
+        }
+        else if (index == sad::p2d::Bound::globalMetaIndex())
+        {
+            // Bounds don't move, so current shape is used
+            m_shape = s;
+        }
+        else
+        {
+            m_clone = s->clone(1);
+            m_shape = m_clone;
+        }
+    }
+    /*! Returns shape of body at specified time
+        \param[in] time a time
+        \return shape
+     */
+    sad::p2d::CollisionShape * at(double time)
+    {
+        sad::p2d::CollisionShape * s = m_body->currentShape();
+        if (m_shape == s)
+        {
+            return s;
+        }
+        if (m_shape == &m_circle)
+        {
+            m_circle = *static_cast<sad::p2d::Circle*>(s);
+        }
+        else if (m_shape == &m_rectangle)
+        {
+            m_rectangle = *static_cast<sad::p2d::Rectangle*>(s);
+        }
+        else if (m_shape == &m_line)
+        {
+            m_line = *static_cast<sad::p2d::Line*>(s);
+        }
+        else
+        {
+            // Same trick as in sad::p2d::Body::at
+            memcpy(m_clone, s, s->sizeOfType());
+        }
+        m_shape->move(m_body->positionDeltaAt(time));
+        m_shape->rotate(m_body->angleDeltaAt(time));
+        return m_shape;
+    }
+    /*! Frees cloned shape
+     */
+    ~ShapeAtTime()
+    {
+        m_body->currentShape()->freeClones(m_clone);
+    }
+private:
+    sad::p2d::Body * m_body; //!< A body
+    sad::p2d::CollisionShape * m_shape; //!< A returned shape
+    sad::p2d::CollisionShape * m_clone; //!< A clone for unknown shapes
+    sad::p2d::Circle m_circle; //!< A storage for circle
+    sad::p2d::Rectangle m_rectangle; //!< A storage for rectangle
+    sad::p2d::Line m_line; //!< A storage for line
+};
+
+/*! Returns points, which define axis for separation of shape
+    \param[in] s shape
+    \param[out] points points of shape (up to 4)
+    \param[out] circle whether shape is a circle, so axis to it's center should be tested
+    \return amount of points
+ */
+static int featurePoints(sad::p2d::CollisionShape * s, sad::p2d::Point * points, bool & circle)
+{
+    circle = false;
+    unsigned int index = s->metaIndex();
+    if (index == sad::p2d::Circle::globalMetaIndex())
+    {
+        circle = true;
+        points[0] = s->center();
+        return 1;
+    }
+    if (index == sad::p2d::Rectangle::globalMetaIndex())
+    {
+        const sad::Rect2D & r = static_cast<sad::p2d::Rectangle*>(s)->rect();
+        for(int i = 0; i < 4; i++)
+        {
+            points[i] = r[i];
+        }
+        return 4;
+    }
+    if (index == sad::p2d::Line::globalMetaIndex())
+    {
+        const sad::p2d::Cutter2D & c = static_cast<sad::p2d::Line*>(s)->cutter();
+        points[0] = c.p1();
+        points[1] = c.p2();
+        return 2;
+    }
+    return 0;
+}
+
+/*! Updates distance between shapes along specified axis, if it's greater than current
+    \param[in] s1 first shape
+    \param[in] s2 second shape
+    \param[in] v  a vector, defining axle
+    \param[in, out] best current distance
+ */
+static void separateAlong(
+    sad::p2d::CollisionShape * s1,
+    sad::p2d::CollisionShape * s2,
+    const sad::p2d::Vector & v,
+    double & best
+)
+{
+    double length = sad::p2d::modulo(v);
+    if (sad::is_fuzzy_zero(length))
+    {
+        return;
+    }
+    sad::p2d::Axle a = v / length;
+    sad::p2d::Cutter1D c1 = s1->project(a);
+    sad::p2d::Cutter1D c2 = s2->project(a);
+    double gap = std::max(c2.p1() - c1.p2(), c1.p1() - c2.p2());
+    best = std::max(best, gap);
+}
+
+/*! Computes distance between bound and shape
+    \param[in] b bound
+    \param[in] s shape
+    \return distance
+ */
+static double separateFromBound(sad::p2d::Bound * b, sad::p2d::CollisionShape * s)
+{
+    bool horizontal = (b->type() == sad::p2d::BT_LEFT || b->type() == sad::p2d::BT_RIGHT);
+    sad::p2d::Cutter1D c = s->project(horizontal ? sad::p2d::Vector(1, 0) : sad::p2d::Vector(0, 1));
+    if (b->type() == sad::p2d::BT_LEFT || b->type() == sad::p2d::BT_DOWN)
+    {
+        return c.p1() - b->position();
+    }
+    return b->position() - c.p2();
+}
+
+}
+
+}
+
+sad::p2d::ConservativeAdvancementCollisionDetector::ConservativeAdvancementCollisionDetector(
+    unsigned int iterations,
+    double tolerance,
+    sad::p2d::CollisionTest * t
+)
+: m_tester(t), m_max_iterations(iterations), m_tolerance(tolerance)
+{
+}
+
+sad::p2d::ConservativeAdvancementCollisionDetector::~ConservativeAdvancementCollisionDetector()
+{
+    delete m_tester;
+}
+
+void sad::p2d::ConservativeAdvancementCollisionDetector::prepare()
+{
+    m_tester->ensureInitialized();
+}
+
+void sad::p2d::ConservativeAdvancementCollisionDetector::setMaxIterations(unsigned int iterations)
+{
+    m_max_iterations = iterations;
+}
+
+unsigned int sad::p2d::ConservativeAdvancementCollisionDetector::maxIterations() const
+{
+    return m_max_iterations;
+}
+
+void sad::p2d::ConservativeAdvancementCollisionDetector::setTolerance(double tolerance)
+{
+    m_tolerance = tolerance;
+}
+
+double sad::p2d::ConservativeAdvancementCollisionDetector::tolerance() const
+{
+    return m_tolerance;
+}
+
+double sad::p2d::ConservativeAdvancementCollisionDetector::separation(
+    sad::p2d::CollisionShape * s1,
+    sad::p2d::CollisionShape * s2
+)
+{
+    unsigned int bound = sad::p2d::Bound::globalMetaIndex();
+    if (s1->metaIndex() == bound)
+    {
+        return sad::p2d::separateFromBound(static_cast<sad::p2d::Bound*>(s1), s2);
+    }
+    if (s2->metaIndex() == bound)
+    {
+        return sad::p2d::separateFromBound(static_cast<sad::p2d::Bound*>(s2), s1);
+    }
+
+    sad::p2d::Point points1[4];
+    sad::p2d::Point points2[4];
+    bool circle1 = false, circle2 = false;
+    int count1 = sad::p2d::featurePoints(s1, points1, circle1);
+    int count2 = sad::p2d::featurePoints(s2, points2, circle2);
+
+    double best = -std::numeric_limits<double>::max();
+    sad::p2d::separateAlong(s1, s2, s2->center() - s1->center(), best);
+    // Normals to sides of polygons. Rectangle has two pairs of parallel sides, and for
+    // line direction is also tested to separate it from collinear lines
+    sad::p2d::Point* points[2] = { points1, points2 };
+    int counts[2] = { count1, count2 };
+    for(int k = 0; k < 2; k++)
+    {
+        if (counts[k] > 1)
+        {
+            int sides = (counts[k] == 4) ? 2 : 1;
+            for(int i = 0; i < sides; i++)
+            {
+                sad::p2d::Vector side = points[k][i + 1] - points[k][i];
+                sad::p2d::separateAlong(s1, s2, sad::p2d::ortho(side, sad::p2d::OVI_DEG_90), best);
+                if (counts[k] == 2)
+                {
+                    sad::p2d::separateAlong(s1, s2, side, best);
+                }
+            }
+        }
+    }
+    // Axis from center of circle to vertices of other shape
+    if (circle1)
+    {
+        for(int i = 0; i < count2; i++)
+        {
+            sad::p2d::separateAlong(s1, s2, points2[i] - points1[0], best);
+        }
+    }
+    if (circle2)
+    {
+        for(int i = 0; i < count1; i++)
+        {
+            sad::p2d::separateAlong(s1, s2, points2[0] - points1[i], best);
+        }
+    }
+    return best;
+}
+
+double sad::p2d::ConservativeAdvancementCollisionDetector::rotationRadius(sad::p2d::CollisionShape * s)
+{
+    unsigned int index = s->metaIndex();
+    if (index == sad::p2d::Circle::globalMetaIndex() || index == sad::p2d::Bound::globalMetaIndex())
+    {
+        return 0;
+    }
+    sad::p2d::Point center = s->center();
+    sad::p2d::Point points[4];
+    bool circle = false;
+    int count = sad::p2d::featurePoints(s, points, circle);
+    double result = 0;
+    if (count == 0)
+    {
+        sad::Vector<sad::p2d::Point> v;
+        s->populatePoints(v);
+        for(size_t i = 0; i < v.size(); i++)
+        {
+            result = std::max(result, sad::p2d::modulo(v[i] - center));
+        }
+        return result;
+    }
+    for(int i = 0; i < count; i++)
+    {
+        result = std::max(result, sad::p2d::modulo(points[i] - center));
+    }
+    return result;
+}
+
+sad::p2d::MaybeTime sad::p2d::ConservativeAdvancementCollisionDetector::collides(
+    sad::p2d::Body * b1,
+    sad::p2d::Body * b2,
+    double limit
+)
+{
+    sad::p2d::MaybeTime result;
+    sad::p2d::CollisionShape * c1 = b1->currentShape();
+    sad::p2d::CollisionShape * c2 = b2->currentShape();
+    if (m_tester->invoke(c1, c2))
+    {
+        return static_cast<double>(0);
+    }
+    unsigned int bound = sad::p2d::Bound::globalMetaIndex();
+    if ((c1->metaIndex() == bound && c2->metaIndex() == bound) || limit <= 0)
+    {
+        return result;
+    }
+
+    // Velocities change linearly within step, since accelerations are constant. Velocities
+    // at end are restored from displacements, so they are consistent with positions
+    sad::p2d::Vector v0 = b1->tangentialVelocity() - b2->tangentialVelocity();
+    sad::p2d::Vector v1 = (b1->positionDeltaAt(limit) - b2->positionDeltaAt(limit)) * (2.0 / limit) - v0;
+    double w10 = b1->angularVelocity();
+    double w20 = b2->angularVelocity();
+    double w11 = b1->angleDeltaAt(limit) * (2.0 / limit) - w10;
+    double w21 = b2->angleDeltaAt(limit) * (2.0 / limit) - w20;
+    double r1 = rotationRadius(c1);
+    double r2 = rotationRadius(c2);
+    // Speed of any point of shape relative to other one grows no faster than this
+    double acceleration = (sad::p2d::modulo(v1 - v0) + fabs(w11 - w10) * r1 + fabs(w21 - w20) * r2) / limit;
+
+    sad::p2d::ShapeAtTime s1(b1);
+    sad::p2d::ShapeAtTime s2(b2);
+    double t = 0;
+    for(unsigned int i = 0; i < m_max_iterations && t < limit; i++)
+    {
+        sad::p2d::CollisionShape * p1 = s1.at(t);
+        sad::p2d::CollisionShape * p2 = s2.at(t);
+        double distance = separation(p1, p2);
+        if (distance <= m_tolerance && m_tester->invoke(p1, p2))
+        {
+            result.setValue(t);
+            return result;
+        }
+        double k = t / limit;
+        double speed = sad::p2d::modulo(v0 + (v1 - v0) * k)
+                     + fabs(w10 + (w11 - w10) * k) * r1
+                     + fabs(w20 + (w21 - w20) * k) * r2;
+        if (sad::is_fuzzy_zero(speed) && sad::is_fuzzy_zero(acceleration))
+        {
+            break;
+        }
+        // Bodies can't cover distance between them faster, than it's solution of
+        // speed * dt + acceleration * dt * dt / 2 = distance. Advance at least by tolerance,
+        // so touching bodies, which are not moving into each other, won't stall here
+        distance = std::max(distance, m_tolerance);
+        t += 2 * distance / (speed + sqrt(speed * speed + 2 * acceleration * distance));
+    }
+
+    // Position could leap at end of step, if it's scheduled, and iterations could
+    // be exceeded, so end of step is tested too
+    if (m_tester->invoke(s1.at(limit), s2.at(limit)))
+    {
+        result.setValue(limit);
+    }
+    return result;
+}
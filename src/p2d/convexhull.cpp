@@ -151,6 +151,33 @@ bool sad::p2d::ConvexHull::collides(const sad::p2d::ConvexHull & c) const
     return collides;
 }
 
+bool sad::p2d::ConvexHull::collidesUsingCachedAxis(const sad::p2d::ConvexHull & c) const
+{
+    if (this->points() == 0 || c.points() == 0)
+    {
+        return false;
+    }
+    if (this->points() == 1 && c.points() == 1)
+    {
+        return sad::equal(this->m_set[0], c.m_set[0]);
+    }
+    for(size_t i = 0 ; i < m_axles.size(); i++)
+    {
+        if (!sad::p2d::collides(m_projections[i], c.project(m_axles[i])))
+        {
+            return false;
+        }
+    }
+    for(size_t i = 0 ; i < c.m_axles.size(); i++)
+    {
+        if (!sad::p2d::collides(this->project(c.m_axles[i]), c.m_projections[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 
 sad::p2d::Vector sad::p2d::ConvexHull::getSumOfNormalsFor(const sad::p2d::Point & p) const
 {
@@ -203,6 +230,24 @@ void sad::p2d::ConvexHull::buildHull()
     m_set = sad::p2d::graham_scan(m_set);
 }
 
+void sad::p2d::ConvexHull::clear()
+{
+    m_set.clear();
+    m_axles.clear();
+    m_projections.clear();
+}
+
+void sad::p2d::ConvexHull::buildAxisCache()
+{
+    m_axles.clear();
+    m_projections.clear();
+    this->appendAxisForCollision(m_axles);
+    for(size_t i = 0; i < m_axles.size(); i++)
+    {
+        m_projections << this->project(m_axles[i]);
+    }
+}
+
 void sad::p2d::ConvexHull::insertPointsFromShape(sad::p2d::CollisionShape * s)
 {
     s->populatePoints(m_set);
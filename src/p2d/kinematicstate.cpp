@@ -0,0 +1,215 @@
+#include "p2d/kinematicstate.h"
+#include "p2d/body.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define SAD_KINEMATICS_SSE2
+    #include <emmintrin.h>
+#endif
+
+static_assert(sizeof(sad::p2d::Vector) == 2 * sizeof(double), "Vector must be packed as two doubles to be integrated");
+
+/*! A flags of slots, which must not be integrated by state
+ */
+#define KINEMATICS_SKIPPED_SLOT (sad::p2d::KSF_FREE | sad::p2d::KSF_SCHEDULED | sad::p2d::KSF_SLEEPING)
+
+sad::p2d::KinematicState::KinematicState()
+{
+
+}
+
+sad::p2d::KinematicState::~KinematicState()
+{
+    this->clear();
+}
+
+void sad::p2d::KinematicState::bind(size_t slot, sad::p2d::Body* body)
+{
+    if (slot >= m_bodies.size())
+    {
+        size_t old_size = m_bodies.size();
+        m_bodies.resize(slot + 1);
+        for(size_t i = old_size; i < m_bodies.size(); i++)
+        {
+            m_bodies[i] = NULL;
+        }
+        m_tangential.resize(slot + 1);
+        m_angular.resize(slot + 1);
+    }
+    this->unbind(slot);
+    // A body, bound to other world, is stepped as standalone object
+    if (body->kinematicState() == NULL)
+    {
+        m_bodies[slot] = body;
+        body->setKinematicState(this, slot);
+    }
+}
+
+void sad::p2d::KinematicState::unbind(size_t slot)
+{
+    if (slot < m_bodies.size())
+    {
+        if (m_bodies[slot])
+        {
+            m_bodies[slot]->setKinematicState(NULL);
+            m_bodies[slot] = NULL;
+        }
+    }
+}
+
+void sad::p2d::KinematicState::clear()
+{
+    for(size_t i = 0; i < m_bodies.size(); i++)
+    {
+        this->unbind(i);
+    }
+    m_bodies.clear();
+    m_tangential.clear();
+    m_angular.clear();
+}
+
+void sad::p2d::KinematicState::integrate(double time_step)
+{
+    sad::p2d::KinematicState::integrate(m_tangential, time_step);
+    sad::p2d::KinematicState::integrate(m_angular, time_step);
+}
+
+size_t sad::p2d::KinematicState::size() const
+{
+    return m_bodies.size();
+}
+
+sad::p2d::Body* sad::p2d::KinematicState::body(size_t slot) const
+{
+    if (slot < m_bodies.size())
+    {
+        return m_bodies[slot];
+    }
+    return NULL;
+}
+
+sad::p2d::KinematicArrays<sad::p2d::Vector>& sad::p2d::KinematicState::tangential()
+{
+    return m_tangential;
+}
+
+sad::p2d::KinematicArrays<double>& sad::p2d::KinematicState::angular()
+{
+    return m_angular;
+}
+
+// Both integrators repeat order of operations from sad::p2d::Movement::positionDelta and
+// sad::p2d::Movement::velocityDelta, so results are the same as when bodies are stepped one by one
+
+void sad::p2d::KinematicState::integrate(sad::p2d::KinematicArrays<sad::p2d::Vector>& arrays, double time_step)
+{
+    size_t size = arrays.Flags.size();
+    if (size == 0)
+    {
+        return;
+    }
+    double half_step = time_step / 2;
+    unsigned char* flags = &(arrays.Flags[0]);
+    double* positions = reinterpret_cast<double*>(&(arrays.Positions[0]));
+    double* velocities = reinterpret_cast<double*>(&(arrays.Velocities[0]));
+    const double* accelerations = reinterpret_cast<const double*>(&(arrays.Accelerations[0]));
+    double* deltas = reinterpret_cast<double*>(&(arrays.Deltas[0]));
+#if defined(SAD_KINEMATICS_SSE2)
+    // A vector is two doubles, so every body is integrated by one register
+    __m128d t = _mm_set1_pd(time_step);
+    __m128d h = _mm_set1_pd(half_step);
+    for(size_t i = 0; i < size; i++)
+    {
+        if ((flags[i] & KINEMATICS_SKIPPED_SLOT) == 0)
+        {
+            size_t offset = i * 2;
+            __m128d a = _mm_loadu_pd(accelerations + offset);
+            __m128d v = _mm_loadu_pd(velocities + offset);
+            __m128d delta = _mm_mul_pd(_mm_add_pd(_mm_mul_pd(a, h), v), t);
+            _mm_storeu_pd(deltas + offset, delta);
+            _mm_storeu_pd(positions + offset, _mm_add_pd(_mm_loadu_pd(positions + offset), delta));
+            _mm_storeu_pd(velocities + offset, _mm_add_pd(v, _mm_mul_pd(a, t)));
+            flags[i] |= sad::p2d::KSF_INTEGRATED;
+        }
+    }
+#else
+    for(size_t i = 0; i < size; i++)
+    {
+        if ((flags[i] & KINEMATICS_SKIPPED_SLOT) == 0)
+        {
+            for(size_t j = i * 2; j < i * 2 + 2; j++)
+            {
+                double delta = (accelerations[j] * half_step + velocities[j]) * time_step;
+                deltas[j] = delta;
+                positions[j] += delta;
+                velocities[j] += accelerations[j] * time_step;
+            }
+            flags[i] |= sad::p2d::KSF_INTEGRATED;
+        }
+    }
+#endif
+}
+
+void sad::p2d::KinematicState::integrate(sad::p2d::KinematicArrays<double>& arrays, double time_step)
+{
+    size_t size = arrays.Flags.size();
+    if (size == 0)
+    {
+        return;
+    }
+    double half_step = time_step / 2;
+    unsigned char* flags = &(arrays.Flags[0]);
+    double* positions = &(arrays.Positions[0]);
+    double* velocities = &(arrays.Velocities[0]);
+    const double* accelerations = &(arrays.Accelerations[0]);
+    double* deltas = &(arrays.Deltas[0]);
+    size_t i = 0;
+#if defined(SAD_KINEMATICS_SSE2)
+    // Two bodies are integrated at once, skipped slots are preserved by masking results
+    __m128d t = _mm_set1_pd(time_step);
+    __m128d h = _mm_set1_pd(half_step);
+    for(; i + 1 < size; i += 2)
+    {
+        bool integrate_first = (flags[i] & KINEMATICS_SKIPPED_SLOT) == 0;
+        bool integrate_second = (flags[i + 1] & KINEMATICS_SKIPPED_SLOT) == 0;
+        if (!integrate_first && !integrate_second)
+        {
+            continue;
+        }
+        __m128d mask = _mm_castsi128_pd(_mm_set_epi32(
+            integrate_second ? -1 : 0,
+            integrate_second ? -1 : 0,
+            integrate_first ? -1 : 0,
+            integrate_first ? -1 : 0
+        ));
+        __m128d a = _mm_loadu_pd(accelerations + i);
+        __m128d v = _mm_loadu_pd(velocities + i);
+        __m128d p = _mm_loadu_pd(positions + i);
+        __m128d d = _mm_loadu_pd(deltas + i);
+        __m128d delta = _mm_mul_pd(_mm_add_pd(_mm_mul_pd(a, h), v), t);
+        __m128d new_position = _mm_add_pd(p, delta);
+        __m128d new_velocity = _mm_add_pd(v, _mm_mul_pd(a, t));
+        _mm_storeu_pd(deltas + i, _mm_or_pd(_mm_and_pd(mask, delta), _mm_andnot_pd(mask, d)));
+        _mm_storeu_pd(positions + i, _mm_or_pd(_mm_and_pd(mask, new_position), _mm_andnot_pd(mask, p)));
+        _mm_storeu_pd(velocities + i, _mm_or_pd(_mm_and_pd(mask, new_velocity), _mm_andnot_pd(mask, v)));
+        if (integrate_first)
+        {
+            flags[i] |= sad::p2d::KSF_INTEGRATED;
+        }
+        if (integrate_second)
+        {
+            flags[i + 1] |= sad::p2d::KSF_INTEGRATED;
+        }
+    }
+#endif
+    for(; i < size; i++)
+    {
+        if ((flags[i] & KINEMATICS_SKIPPED_SLOT) == 0)
+        {
+            double delta = (accelerations[i] * half_step + velocities[i]) * time_step;
+            deltas[i] = delta;
+            positions[i] += delta;
+            velocities[i] += accelerations[i] * time_step;
+            flags[i] |= sad::p2d::KSF_INTEGRATED;
+        }
+    }
+}
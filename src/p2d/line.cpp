@@ -11,6 +11,11 @@ sad::p2d::CollisionShape * sad::p2d::Line::clone(int count) const
     return b;
 }
 
+void sad::p2d::Line::freeClones(sad::p2d::CollisionShape * clones) const
+{
+    delete[] static_cast<sad::p2d::Line *>(clones);
+}
+
 
 sad::p2d::Point sad::p2d::Line::center() const
 {
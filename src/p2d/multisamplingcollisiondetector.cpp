@@ -14,8 +14,8 @@ sad::p2d::MaybeTime sad::p2d::MultisamplingCollisionDetector::collides(sad::p2d:
     }
     for(unsigned int  i = 0; i  < m_tests && !(result.exists()); i++)
     {
-        sad::p2d::CollisionShape * s1 = b1->Temporary + i;
-        sad::p2d::CollisionShape * s2 = b2->Temporary + i;
+        sad::p2d::CollisionShape * s1 = b1->sample(i);
+        sad::p2d::CollisionShape * s2 = b2->sample(i);
         if (m_tester->invoke(s1, s2))
         {
             result.setValue(limit / m_tests * (i+1));
@@ -24,6 +24,11 @@ sad::p2d::MaybeTime sad::p2d::MultisamplingCollisionDetector::collides(sad::p2d:
     return result;
 }
 
+void sad::p2d::MultisamplingCollisionDetector::prepare()
+{
+    m_tester->ensureInitialized();
+}
+
 sad::p2d::MultisamplingCollisionDetector::~MultisamplingCollisionDetector()
 {
     delete m_tester;
@@ -18,6 +18,11 @@ sad::p2d::CollisionShape * sad::p2d::Rectangle::clone(int count) const
     return b;
 }
 
+void sad::p2d::Rectangle::freeClones(sad::p2d::CollisionShape * clones) const
+{
+    delete[] static_cast<sad::p2d::Rectangle *>(clones);
+}
+
 
 sad::p2d::Point sad::p2d::Rectangle::center() const
 {
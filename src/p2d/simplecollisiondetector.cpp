@@ -19,6 +19,11 @@ sad::p2d::MaybeTime sad::p2d::SimpleCollisionDetector::collides(sad::p2d::Body *
     return result;
 }
 
+void sad::p2d::SimpleCollisionDetector::prepare()
+{
+    m_tester->ensureInitialized();
+}
+
 sad::p2d::SimpleCollisionDetector::~SimpleCollisionDetector()
 {
     delete m_tester;
@@ -0,0 +1,111 @@
+#include "p2d/sweepandprunebroadphase.h"
+
+#include <algorithm>
+
+DECLARE_SOBJ_INHERITANCE(sad::p2d::SweepAndPruneBroadPhase, sad::p2d::BroadPhase);
+
+sad::p2d::SweepAndPruneBroadPhase::SweepAndPruneBroadPhase()
+{
+
+}
+
+void sad::p2d::SweepAndPruneBroadPhase::findPairs(
+    const sad::Vector<sad::p2d::BroadPhase::Entry>& first,
+    const sad::Vector<sad::p2d::BroadPhase::Entry>& second,
+    bool same_group,
+    sad::Vector<sad::p2d::BroadPhase::CandidatePair>& pairs
+)
+{
+    m_intervals.clear();
+    m_active_first.clear();
+    m_active_second.clear();
+
+    // Unbounded bodies are tested against everything, other are sweeped
+    for(size_t i = 0; i < first.size(); i++)
+    {
+        const sad::p2d::BoundingBox& box = first[i].Body->sweptBoundingBox();
+        if (box.Unbounded)
+        {
+            for(size_t j = 0; j < second.size(); j++)
+            {
+                sad::p2d::BroadPhase::tryAddPair(first[i], second[j], same_group, pairs);
+            }
+        }
+        else
+        {
+            m_intervals << sad::p2d::SweepAndPruneBroadPhase::Interval(box.MinX, box.MaxX, false, i);
+        }
+    }
+    if (!same_group)
+    {
+        for(size_t i = 0; i < second.size(); i++)
+        {
+            const sad::p2d::BoundingBox& box = second[i].Body->sweptBoundingBox();
+            if (box.Unbounded)
+            {
+                for(size_t j = 0; j < first.size(); j++)
+                {
+                    sad::p2d::BroadPhase::tryAddPair(first[j], second[i], same_group, pairs);
+                }
+            }
+            else
+            {
+                m_intervals << sad::p2d::SweepAndPruneBroadPhase::Interval(box.MinX, box.MaxX, true, i);
+            }
+        }
+    }
+    std::sort(m_intervals.begin(), m_intervals.end());
+
+    for(size_t i = 0; i < m_intervals.size(); i++)
+    {
+        const sad::p2d::SweepAndPruneBroadPhase::Interval& interval = m_intervals[i];
+        sad::p2d::SweepAndPruneBroadPhase::prune(m_active_first, interval.MinX);
+        sad::p2d::SweepAndPruneBroadPhase::prune(m_active_second, interval.MinX);
+        if (same_group)
+        {
+            for(size_t j = 0; j < m_active_first.size(); j++)
+            {
+                sad::p2d::BroadPhase::tryAddPair(first[m_active_first[j].Position], first[interval.Position], true, pairs);
+            }
+            m_active_first << interval;
+        }
+        else
+        {
+            if (interval.Second)
+            {
+                for(size_t j = 0; j < m_active_first.size(); j++)
+                {
+                    sad::p2d::BroadPhase::tryAddPair(first[m_active_first[j].Position], second[interval.Position], false, pairs);
+                }
+                m_active_second << interval;
+            }
+            else
+            {
+                for(size_t j = 0; j < m_active_second.size(); j++)
+                {
+                    sad::p2d::BroadPhase::tryAddPair(first[interval.Position], second[m_active_second[j].Position], false, pairs);
+                }
+                m_active_first << interval;
+            }
+        }
+    }
+}
+
+sad::p2d::SweepAndPruneBroadPhase::~SweepAndPruneBroadPhase()
+{
+
+}
+
+void sad::p2d::SweepAndPruneBroadPhase::prune(sad::Vector<sad::p2d::SweepAndPruneBroadPhase::Interval>& active, double x)
+{
+    size_t kept = 0;
+    for(size_t i = 0; i < active.size(); i++)
+    {
+        if (active[i].MaxX >= x)
+        {
+            active[kept] = active[i];
+            ++kept;
+        }
+    }
+    active.resize(kept);
+}
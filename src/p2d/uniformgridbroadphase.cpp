@@ -0,0 +1,135 @@
+#include "p2d/uniformgridbroadphase.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+DECLARE_SOBJ_INHERITANCE(sad::p2d::UniformGridBroadPhase, sad::p2d::BroadPhase);
+
+sad::p2d::UniformGridBroadPhase::UniformGridBroadPhase(double cell_size, size_t max_cells_per_body)
+: m_cell_size(cell_size), m_max_cells_per_body(max_cells_per_body)
+{
+    assert( cell_size > 0 );
+}
+
+void sad::p2d::UniformGridBroadPhase::setCellSize(double cell_size)
+{
+    assert( cell_size > 0 );
+    m_cell_size = cell_size;
+}
+
+double sad::p2d::UniformGridBroadPhase::cellSize() const
+{
+    return m_cell_size;
+}
+
+void sad::p2d::UniformGridBroadPhase::setMaxCellsPerBody(size_t max_cells_per_body)
+{
+    m_max_cells_per_body = max_cells_per_body;
+}
+
+size_t sad::p2d::UniformGridBroadPhase::maxCellsPerBody() const
+{
+    return m_max_cells_per_body;
+}
+
+void sad::p2d::UniformGridBroadPhase::findPairs(
+    const sad::Vector<sad::p2d::BroadPhase::Entry>& first,
+    const sad::Vector<sad::p2d::BroadPhase::Entry>& second,
+    bool same_group,
+    sad::Vector<sad::p2d::BroadPhase::CandidatePair>& pairs
+)
+{
+    m_cells.clear();
+    m_large.clear();
+
+    long long minx = 0, miny = 0, maxx = 0, maxy = 0;
+    // Place bodies of second group into grid
+    for(size_t i = 0; i < second.size(); i++)
+    {
+        if (cellRange(second[i].Body->sweptBoundingBox(), minx, miny, maxx, maxy))
+        {
+            for(long long x = minx; x <= maxx; x++)
+            {
+                for(long long y = miny; y <= maxy; y++)
+                {
+                    m_cells << sad::p2d::UniformGridBroadPhase::CellEntry(x, y, i);
+                }
+            }
+        }
+        else
+        {
+            m_large << i;
+        }
+    }
+    std::sort(m_cells.begin(), m_cells.end());
+
+    // Query cells for bodies of first group
+    for(size_t i = 0; i < first.size(); i++)
+    {
+        const sad::p2d::BroadPhase::Entry& e1 = first[i];
+        if (cellRange(e1.Body->sweptBoundingBox(), minx, miny, maxx, maxy))
+        {
+            for(long long x = minx; x <= maxx; x++)
+            {
+                for(long long y = miny; y <= maxy; y++)
+                {
+                    typedef sad::Vector<sad::p2d::UniformGridBroadPhase::CellEntry>::iterator iterator_t;
+                    std::pair<iterator_t, iterator_t> range = std::equal_range(
+                        m_cells.begin(),
+                        m_cells.end(),
+                        sad::p2d::UniformGridBroadPhase::CellEntry(x, y)
+                    );
+                    for(iterator_t it = range.first; it != range.second; ++it)
+                    {
+                        sad::p2d::BroadPhase::tryAddPair(e1, second[it->Position], same_group, pairs);
+                    }
+                }
+            }
+            for(size_t j = 0; j < m_large.size(); j++)
+            {
+                sad::p2d::BroadPhase::tryAddPair(e1, second[m_large[j]], same_group, pairs);
+            }
+        }
+        else
+        {
+            for(size_t j = 0; j < second.size(); j++)
+            {
+                sad::p2d::BroadPhase::tryAddPair(e1, second[j], same_group, pairs);
+            }
+        }
+    }
+}
+
+sad::p2d::UniformGridBroadPhase::~UniformGridBroadPhase()
+{
+
+}
+
+bool sad::p2d::UniformGridBroadPhase::cellRange(
+    const sad::p2d::BoundingBox& box,
+    long long& minx,
+    long long& miny,
+    long long& maxx,
+    long long& maxy
+) const
+{
+    if (box.Unbounded)
+    {
+        return false;
+    }
+    double dminx = floor(box.MinX / m_cell_size);
+    double dminy = floor(box.MinY / m_cell_size);
+    double dmaxx = floor(box.MaxX / m_cell_size);
+    double dmaxy = floor(box.MaxY / m_cell_size);
+    double cells = (dmaxx - dminx + 1) * (dmaxy - dminy + 1);
+    if (cells > static_cast<double>(m_max_cells_per_body))
+    {
+        return false;
+    }
+    minx = static_cast<long long>(dminx);
+    miny = static_cast<long long>(dminy);
+    maxx = static_cast<long long>(dmaxx);
+    maxy = static_cast<long long>(dmaxy);
+    return true;
+}
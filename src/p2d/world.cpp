@@ -1,6 +1,8 @@
 #include "p2d/world.h"
 #include "collection.h"
 
+#include <algorithm>
+
 DECLARE_SOBJ(sad::p2d::World);
 
 // =============================== sad::p2d::World::GlobalBodyContainer METHODS ===============================
@@ -49,24 +51,64 @@ void sad::p2d::World::GlobalBodyContainer::trySetTransformer()
 
 void sad::p2d::World::GlobalBodyContainer::buildBodyCaches(double time_step)
 {
-   void (sad::p2d::Body::*action)(double) = &sad::p2d::Body::buildCaches;
-   this->performActionWithTimeStep(action, time_step);
+    size_t size = this->AllBodies.size();
+    if (size)
+    {
+        sad::p2d::World::BodyWithActivityFlag* p = &(this->AllBodies[0]);
+        for(size_t i = 0; i < size; i++)
+        {
+            if (p->Active)
+            {
+                // Sleeping bodies keep caches, but time step is refreshed, because it's read
+                // by narrow phase, which must not change bodies
+                if (p->Body->isSleeping())
+                {
+                    p->Body->TimeStep = time_step;
+                }
+                else
+                {
+                    p->Body->buildCaches(time_step);
+                }
+            }
+            p++;
+        }
+    }
 }
 
 void sad::p2d::World::GlobalBodyContainer::stepDiscreteChangingValues(double time_step)
 {
-    this->performActionWithTimeStep(
-        &sad::p2d::Body::stepDiscreteChangingValues,
-        time_step
-    );
+    size_t size = this->AllBodies.size();
+    if (size)
+    {
+        sad::p2d::World::BodyWithActivityFlag* p = &(this->AllBodies[0]);
+        for(size_t i = 0; i < size; i++)
+        {
+            if (p->Active && !(p->Body->isSleeping()))
+            {
+                p->Body->stepDiscreteChangingValues(time_step);
+            }
+            p++;
+        }
+    }
 }
 
 void sad::p2d::World::GlobalBodyContainer::stepPositionsAndVelocities(double time_step)
 {
-    this->performActionWithTimeStep(
-        &sad::p2d::Body::stepPositionsAndVelocities,
-        time_step
-    );
+    this->Kinematics.integrate(time_step);
+    // Integrated bodies only notify listeners here, other ones are stepped as before
+    size_t size = this->AllBodies.size();
+    if (size)
+    {
+        sad::p2d::World::BodyWithActivityFlag* p = &(this->AllBodies[0]);
+        for(size_t i = 0; i < size; i++)
+        {
+            if (p->Active && !(p->Body->isSleeping()))
+            {
+                p->Body->stepPositionsAndVelocities(time_step);
+            }
+            p++;
+        }
+    }
 }
 
 sad::p2d::World::BodyLocation& sad::p2d::World::GlobalBodyContainer::add(sad::p2d::Body* b)
@@ -95,6 +137,10 @@ sad::p2d::World::BodyLocation& sad::p2d::World::GlobalBodyContainer::add(sad::p2
         AllBodies.push_back(sad::p2d::World::BodyWithActivityFlag(b));
     }
 
+    // Body could be put to sleep by other world, so it's woken to be simulated here
+    b->wakeUp();
+    Kinematics.bind(position, b);
+
     BodyLocation bl;
     bl.OffsetInAllBodies = position;
     BodyToLocation.insert(b, bl);
@@ -107,6 +153,7 @@ void sad::p2d::World::GlobalBodyContainer::remove(sad::p2d::Body* b)
     {
         BodyLocation& bl = BodyToLocation[b];
         FreePositions.push_back(bl.OffsetInAllBodies);
+        Kinematics.unbind(bl.OffsetInAllBodies);
         if (AllBodies[bl.OffsetInAllBodies].Active)
         {
             b->delRef();
@@ -131,6 +178,7 @@ const sad::Vector<size_t>& sad::p2d::World::GlobalBodyContainer::getGroupLocatio
 
 void sad::p2d::World::GlobalBodyContainer::clear()
 {
+    this->Kinematics.clear();
     size_t size = this->AllBodies.size();
     if (size)
     {
@@ -201,6 +249,62 @@ sad::Vector<sad::p2d::Body*> sad::p2d::World::GlobalBodyContainer::activeBodies(
     return result;
 }
 
+void sad::p2d::World::GlobalBodyContainer::updateSleepStates(double linear_threshold, double angular_threshold, unsigned int steps)
+{
+    size_t size = this->AllBodies.size();
+    if (size)
+    {
+        sad::p2d::World::BodyWithActivityFlag* p = &(this->AllBodies[0]);
+        for (size_t i = 0; i < size; i++)
+        {
+            if (p->Active)
+            {
+                p->Body->updateSleepState(linear_threshold, angular_threshold, steps);
+            }
+            p++;
+        }
+    }
+}
+
+void sad::p2d::World::GlobalBodyContainer::wakeUpAll()
+{
+    this->performAction([](sad::p2d::Body* body) {
+        body->wakeUp();
+    });
+}
+
+void sad::p2d::World::GlobalBodyContainer::wakeUpInArea(const sad::p2d::BoundingBox& area)
+{
+    size_t size = this->AllBodies.size();
+    for (size_t i = 0; i < size; i++)
+    {
+        sad::p2d::World::BodyWithActivityFlag& p = this->AllBodies[i];
+        if (p.Active && p.Body->isSleeping() && p.Body->sweptBoundingBox().intersects(area))
+        {
+            p.Body->wakeUp();
+        }
+    }
+}
+
+size_t sad::p2d::World::GlobalBodyContainer::sleepingBodyCount()
+{
+    size_t size = this->AllBodies.size();
+    size_t result = 0;
+    if (size)
+    {
+        sad::p2d::World::BodyWithActivityFlag* p = &(this->AllBodies[0]);
+        for(size_t i = 0; i < size; i++)
+        {
+            if (p->Active && p->Body->isSleeping())
+            {
+                result += 1;
+            }
+            p++;
+        }
+    }
+    return result;
+}
+
 // =============================== sad::p2d::World::Group METHODS ===============================
 
 size_t sad::p2d::World::Group::add(sad::p2d::Body* b)
@@ -670,7 +774,7 @@ sad::Vector<sad::p2d::BasicCollisionHandler*> sad::p2d::World::GlobalHandlerList
 
 // =============================== sad::p2d::World PUBLIC METHODS ===============================
 
-sad::p2d::World::World() : m_time_step(1), m_is_locked(false)
+sad::p2d::World::World() : m_time_step(1), m_interpolation_alpha(1.0), m_sleeping_enabled(false), m_sleep_linear_threshold(1.0), m_sleep_angular_threshold(0.01), m_steps_before_sleep(30), m_broad_phase(NULL), m_narrow_phase_thread_count(1), m_worker_pool(NULL), m_is_locked(false)
 {
     m_transformer = new p2d::CircleToHullTransformer(*(p2d::CircleToHullTransformer::ref()));
     m_detector = new p2d::SimpleCollisionDetector();
@@ -684,6 +788,11 @@ sad::p2d::World::~World()
 {
     delete m_transformer;
     m_detector->delRef();
+    if (m_broad_phase)
+    {
+        m_broad_phase->delRef();
+    }
+    delete m_worker_pool;
     m_group_container.clear();
     m_global_handler_list.clear();
     m_global_body_container.clear();
@@ -729,12 +838,118 @@ void sad::p2d::World::setDetector(sad::p2d::CollisionDetector * d)
     m_global_body_container.setSamplingCount(m_detector->sampleCount());
 }
 
+void sad::p2d::World::setBroadPhase(sad::p2d::BroadPhase * p)
+{
+    if (p)
+    {
+        p->addRef();
+    }
+    if (m_broad_phase)
+    {
+        m_broad_phase->delRef();
+    }
+    m_broad_phase = p;
+}
+
+sad::p2d::BroadPhase * sad::p2d::World::broadPhase() const
+{
+    return m_broad_phase;
+}
+
+void sad::p2d::World::setNarrowPhaseThreadCount(size_t threads)
+{
+    // Pool is recreated on next step, so it's safe to call this from callbacks
+    m_narrow_phase_thread_count = std::max(threads, static_cast<size_t>(1));
+}
+
+size_t sad::p2d::World::narrowPhaseThreadCount() const
+{
+    return m_narrow_phase_thread_count;
+}
+
 double sad::p2d::World::timeStep() const
 {
     return m_time_step;
 }
 
 
+void sad::p2d::World::setInterpolationAlpha(double alpha)
+{
+    m_interpolation_alpha = alpha;
+}
+
+double sad::p2d::World::interpolationAlpha() const
+{
+    return m_interpolation_alpha;
+}
+
+void sad::p2d::World::setSleepingEnabled(bool enabled)
+{
+    m_sleeping_enabled = enabled;
+    if (!enabled)
+    {
+        m_global_body_container.wakeUpAll();
+    }
+}
+
+bool sad::p2d::World::isSleepingEnabled() const
+{
+    return m_sleeping_enabled;
+}
+
+void sad::p2d::World::setSleepThresholds(double linear, double angular)
+{
+    m_sleep_linear_threshold = linear;
+    m_sleep_angular_threshold = angular;
+}
+
+double sad::p2d::World::sleepLinearThreshold() const
+{
+    return m_sleep_linear_threshold;
+}
+
+double sad::p2d::World::sleepAngularThreshold() const
+{
+    return m_sleep_angular_threshold;
+}
+
+void sad::p2d::World::setStepsBeforeSleep(unsigned int steps)
+{
+    m_steps_before_sleep = steps;
+}
+
+unsigned int sad::p2d::World::stepsBeforeSleep() const
+{
+    return m_steps_before_sleep;
+}
+
+size_t sad::p2d::World::sleepingBodyCount()
+{
+    m_world_lock.lock();
+    size_t result = m_global_body_container.sleepingBodyCount();
+    m_world_lock.unlock();
+    return result;
+}
+
+size_t sad::p2d::World::awakeBodyCount()
+{
+    m_world_lock.lock();
+    size_t result = m_global_body_container.bodyCount() - m_global_body_container.sleepingBodyCount();
+    m_world_lock.unlock();
+    return result;
+}
+
+void sad::p2d::World::wakeUpNeighbours(sad::p2d::Body* b)
+{
+    if (!m_sleeping_enabled || !b)
+    {
+        return;
+    }
+    m_disturbed_areas_lock.lock();
+    m_disturbed_areas << b->sweptBoundingBox();
+    m_disturbed_areas_lock.unlock();
+}
+
 void sad::p2d::World::setTransformer(sad::p2d::CircleToHullTransformer * t)
 {
     delete m_transformer;
@@ -1383,6 +1598,8 @@ void sad::p2d::World::removeBodyNow(sad::p2d::Body* b)
 
     if (m_global_body_container.BodyToLocation.contains(b))
     {
+        // Bodies, resting on removed one, should fall
+        wakeUpNeighbours(b);
         sad::p2d::World::BodyLocation& loc = m_global_body_container.BodyToLocation[b];
         for(size_t i = 0; i < loc.PositionInGroups.size(); i++)
         {
@@ -1447,6 +1664,10 @@ void sad::p2d::World::removeBodyFromGroupNow(const sad::String& group_name, sad:
         {
             m_group_container.Groups[location.value()].Group.remove(o);
             m_global_body_container.removeFromGroup(o, location.value());            
+            if (!m_global_body_container.BodyToLocation.contains(o))
+            {
+                wakeUpNeighbours(o);
+            }
         }
     }
 
@@ -1627,15 +1848,34 @@ void sad::p2d::World::stepNow(double time)
 
     m_time_step = time;
     m_global_body_container.buildBodyCaches(time);
+    wakeUpBodiesInDisturbedAreas();
     {
         sad::p2d::World::EventsWithCallbacks events_with_callbacks;
-        findEvents(events_with_callbacks);
+        if (m_narrow_phase_thread_count > 1)
+        {
+            findEventsInParallel(events_with_callbacks);
+        }
+        else
+        {
+            findEvents(events_with_callbacks);
+        }
         std::sort(events_with_callbacks.begin(), events_with_callbacks.end());
+        // Sleeping body, hit by awake one, is woken, so handlers could change it
+        for (size_t i = 0; i < events_with_callbacks.size(); i++)
+        {
+            const sad::p2d::BasicCollisionEvent& ev = events_with_callbacks[i].Event;
+            ev.m_object_1->wakeUp();
+            ev.m_object_2->wakeUp();
+        }
         sad::invoke_functors(events_with_callbacks);
     }
 
     m_global_body_container.stepPositionsAndVelocities(time);
     m_global_body_container.stepDiscreteChangingValues(time);
+    if (m_sleeping_enabled)
+    {
+        m_global_body_container.updateSleepStates(m_sleep_linear_threshold, m_sleep_angular_threshold, m_steps_before_sleep);
+    }
 
     setIsLockedFlag(false);
     m_world_lock.unlock();
@@ -1644,6 +1884,30 @@ void sad::p2d::World::stepNow(double time)
 }
 
 
+void sad::p2d::World::wakeUpBodiesInDisturbedAreas()
+{
+    // Woken bodies add their areas to list, so it's traversed until no more bodies are woken
+    for(size_t i = 0; true; i++)
+    {
+        m_disturbed_areas_lock.lock();
+        if (i >= m_disturbed_areas.size())
+        {
+            m_disturbed_areas.clear();
+            m_disturbed_areas_lock.unlock();
+            return;
+        }
+        sad::p2d::BoundingBox area = m_disturbed_areas[i];
+        m_disturbed_areas_lock.unlock();
+
+        if (m_sleeping_enabled && !area.Empty)
+        {
+            // Resting bodies are usually separated by small gap, so area is extended a bit
+            area.inflate(SAD_P2D_WAKE_UP_DISTANCE);
+            m_global_body_container.wakeUpInArea(area);
+        }
+    }
+}
+
 void sad::p2d::World::findEvents(sad::p2d::World::EventsWithCallbacks& ewc)
 {
     for (size_t i = 0; i < m_global_handler_list.List.size(); i++)
@@ -1657,7 +1921,6 @@ void sad::p2d::World::findEvents(sad::p2d::World::EventsWithCallbacks& ewc)
 }
 void sad::p2d::World::findEvent(sad::p2d::World::EventsWithCallbacks& ewc, sad::p2d::World::HandlerList& lst)
 {
-    double step = this->timeStep();
     size_t group_index_1 = lst.TypeIndex1;
     size_t group_index_2 = lst.TypeIndex2;
     sad::Vector<sad::p2d::BasicCollisionHandler*>* callbacks = lst.List;
@@ -1672,35 +1935,208 @@ void sad::p2d::World::findEvent(sad::p2d::World::EventsWithCallbacks& ewc, sad::
         sad::Vector<sad::p2d::World::BodyWithActivityFlag>& bodies2 = group2.Bodies;
 
         bool not_same_group = group_index_1 != group_index_2;
-        for (size_t i = 0; i < bodies1.count(); i++)
+        if (m_broad_phase)
         {
-            size_t jmin = i + 1;
-            if (not_same_group)
+            findEventWithBroadPhase(ewc, bodies1, bodies2, !not_same_group, callbacks);
+            return;
+        }
+        findEventInRows(ewc, bodies1, bodies2, !not_same_group, callbacks, 0, bodies1.count());
+    }
+}
+
+void sad::p2d::World::findEventsInParallel(sad::p2d::World::EventsWithCallbacks& ewc)
+{
+    if (m_worker_pool == NULL || m_worker_pool->threadCount() != m_narrow_phase_thread_count)
+    {
+        delete m_worker_pool;
+        m_worker_pool = new sad::WorkerPool(m_narrow_phase_thread_count);
+    }
+    m_detector->prepare();
+
+    // Split every pair of groups into several tasks, so threads could take them dynamically
+    // and load will be balanced, even if there is only one pair of groups
+    size_t max_tasks_per_list = m_worker_pool->threadCount() * 4;
+    size_t task_count = 0;
+    m_narrow_phase_pairs.resize(m_global_handler_list.List.size());
+    for (size_t i = 0; i < m_global_handler_list.List.size(); i++)
+    {
+        sad::p2d::World::HandlerList& lst = m_global_handler_list.List[i];
+        if (lst.List == NULL
+            || !(m_group_container.Groups[lst.TypeIndex1].Active)
+            || !(m_group_container.Groups[lst.TypeIndex2].Active))
+        {
+            continue;
+        }
+        sad::Vector<sad::p2d::World::BodyWithActivityFlag>& bodies1 = m_group_container.Groups[lst.TypeIndex1].Group.Bodies;
+        sad::Vector<sad::p2d::World::BodyWithActivityFlag>& bodies2 = m_group_container.Groups[lst.TypeIndex2].Group.Bodies;
+        bool same_group = lst.TypeIndex1 == lst.TypeIndex2;
+
+        const sad::Vector<sad::p2d::BroadPhase::CandidatePair>* pairs = NULL;
+        size_t total = bodies1.count();
+        if (m_broad_phase)
+        {
+            findCandidatePairs(bodies1, bodies2, same_group, m_narrow_phase_pairs[i]);
+            pairs = &(m_narrow_phase_pairs[i]);
+            total = pairs->size();
+        }
+
+        size_t chunk = std::max(total / max_tasks_per_list, static_cast<size_t>(1));
+        for (size_t begin = 0; begin < total; begin += chunk)
+        {
+            if (task_count == m_narrow_phase_tasks.size())
             {
-                jmin = 0;
+                m_narrow_phase_tasks << sad::p2d::World::NarrowPhaseTask();
             }
-            for (size_t j = jmin; j < bodies2.count(); j++)
+            sad::p2d::World::NarrowPhaseTask& task = m_narrow_phase_tasks[task_count];
+            task.Bodies1 = &bodies1;
+            task.Bodies2 = &bodies2;
+            task.SameGroup = same_group;
+            task.Callbacks = lst.List;
+            task.Pairs = pairs;
+            task.Begin = begin;
+            task.End = std::min(begin + chunk, total);
+            task.Events.clear();
+            ++task_count;
+        }
+    }
+
+    m_worker_pool->run(task_count, [this](size_t i) {
+        sad::p2d::World::NarrowPhaseTask& task = m_narrow_phase_tasks[i];
+        if (task.Pairs)
+        {
+            findEventForPairs(task.Events, *(task.Bodies1), *(task.Bodies2), *(task.Pairs), task.Callbacks, task.Begin, task.End);
+        }
+        else
+        {
+            findEventInRows(task.Events, *(task.Bodies1), *(task.Bodies2), task.SameGroup, task.Callbacks, task.Begin, task.End);
+        }
+    });
+
+    // Tasks are merged in same order, as pairs are tested in single thread, so sorting will produce same order
+    for (size_t i = 0; i < task_count; i++)
+    {
+        ewc << m_narrow_phase_tasks[i].Events;
+    }
+}
+
+void sad::p2d::World::findEventInRows(
+    sad::p2d::World::EventsWithCallbacks& ewc,
+    sad::Vector<sad::p2d::World::BodyWithActivityFlag>& bodies1,
+    sad::Vector<sad::p2d::World::BodyWithActivityFlag>& bodies2,
+    bool same_group,
+    sad::Vector<sad::p2d::BasicCollisionHandler*>* callbacks,
+    size_t begin,
+    size_t end
+)
+{
+    for (size_t i = begin; i < end; i++)
+    {
+        size_t jmin = i + 1;
+        if (!same_group)
+        {
+            jmin = 0;
+        }
+        for (size_t j = jmin; j < bodies2.count(); j++)
+        {
+            sad::p2d::Body* b1 = bodies1[i].Body;
+            sad::p2d::Body* b2 = bodies2[j].Body;
+
+            bool b1active = bodies1[i].Active;
+            bool b2active = bodies2[j].Active;
+            if (b1active && b2active && (b1 != b2))
             {
-                sad::p2d::Body* b1 = bodies1[i].Body;
-                sad::p2d::Body* b2 = bodies2[j].Body;
+                findEventForPair(ewc, b1, b2, callbacks);
+            }
+        }
+    }
+}
 
-                bool b1active = bodies1[i].Active;
-                bool b2active = bodies2[j].Active;
-                if (b1active && b2active && (b1 != b2))
-                {
-                    if (!(b1->isGhost()) && !(b2->isGhost()))
-                    {
-                        b1->TimeStep = step;
-                        b2->TimeStep = step;
-                        sad::Maybe<double> time = m_detector->collides(b1, b2, m_time_step);
-                        if (time.exists())
-                        {
-                            sad::p2d::BasicCollisionEvent ev(b1, b2, time.value());
-                            ewc << sad::p2d::World::EventWithCallback(ev, callbacks);
-                        }
-                    }
-                }
+void sad::p2d::World::findEventWithBroadPhase(
+    sad::p2d::World::EventsWithCallbacks& ewc,
+    sad::Vector<sad::p2d::World::BodyWithActivityFlag>& bodies1,
+    sad::Vector<sad::p2d::World::BodyWithActivityFlag>& bodies2,
+    bool same_group,
+    sad::Vector<sad::p2d::BasicCollisionHandler*>* callbacks
+)
+{
+    findCandidatePairs(bodies1, bodies2, same_group, m_broad_phase_pairs);
+    findEventForPairs(ewc, bodies1, bodies2, m_broad_phase_pairs, callbacks, 0, m_broad_phase_pairs.size());
+}
+
+void sad::p2d::World::findCandidatePairs(
+    sad::Vector<sad::p2d::World::BodyWithActivityFlag>& bodies1,
+    sad::Vector<sad::p2d::World::BodyWithActivityFlag>& bodies2,
+    bool same_group,
+    sad::Vector<sad::p2d::BroadPhase::CandidatePair>& pairs
+)
+{
+    // Ghosts and inactive bodies are never tested, so we don't pass them to broad phase
+    m_broad_phase_first.clear();
+    for (size_t i = 0; i < bodies1.count(); i++)
+    {
+        if (bodies1[i].Active && !(bodies1[i].Body->isGhost()))
+        {
+            m_broad_phase_first << sad::p2d::BroadPhase::Entry(bodies1[i].Body, i);
+        }
+    }
+    m_broad_phase_second.clear();
+    if (!same_group)
+    {
+        for (size_t i = 0; i < bodies2.count(); i++)
+        {
+            if (bodies2[i].Active && !(bodies2[i].Body->isGhost()))
+            {
+                m_broad_phase_second << sad::p2d::BroadPhase::Entry(bodies2[i].Body, i);
             }
         }
     }
+
+    // Pairs are sorted, so events are found in same order, as without broad phase
+    m_broad_phase->findSortedPairs(
+        m_broad_phase_first,
+        (same_group) ? m_broad_phase_first : m_broad_phase_second,
+        same_group,
+        pairs
+    );
+}
+
+void sad::p2d::World::findEventForPairs(
+    sad::p2d::World::EventsWithCallbacks& ewc,
+    sad::Vector<sad::p2d::World::BodyWithActivityFlag>& bodies1,
+    sad::Vector<sad::p2d::World::BodyWithActivityFlag>& bodies2,
+    const sad::Vector<sad::p2d::BroadPhase::CandidatePair>& pairs,
+    sad::Vector<sad::p2d::BasicCollisionHandler*>* callbacks,
+    size_t begin,
+    size_t end
+)
+{
+    for (size_t i = begin; i < end; i++)
+    {
+        const sad::p2d::BroadPhase::CandidatePair& pair = pairs[i];
+        findEventForPair(ewc, bodies1[pair.First].Body, bodies2[pair.Second].Body, callbacks);
+    }
+}
+
+void sad::p2d::World::findEventForPair(
+    sad::p2d::World::EventsWithCallbacks& ewc,
+    sad::p2d::Body* b1,
+    sad::p2d::Body* b2,
+    sad::Vector<sad::p2d::BasicCollisionHandler*>* callbacks
+)
+{
+    // Sleeping bodies don't move, so they can't collide with each other
+    if (b1->isSleeping() && b2->isSleeping())
+    {
+        return;
+    }
+    if (!(b1->isGhost()) && !(b2->isGhost()))
+    {
+        // Time step of bodies is already set, when caches are built
+        sad::Maybe<double> time = m_detector->collides(b1, b2, m_time_step);
+        if (time.exists())
+        {
+            sad::p2d::BasicCollisionEvent ev(b1, b2, time.value());
+            ewc << sad::p2d::World::EventWithCallback(ev, callbacks);
+        }
+    }
 }
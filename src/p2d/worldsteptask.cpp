@@ -1,8 +1,15 @@
 #include "p2d/worldsteptask.h"
 
+#include <cmath>
+
 
 sad::p2d::WorldStepTask::WorldStepTask(sad::p2d::World * w, sad::Renderer * r)
-: m_world(w), m_renderer(r)
+: m_world(w), m_renderer(r),
+m_fixed_time_step(0),
+m_max_substeps(5),
+m_accumulator(0),
+m_interpolation_alpha(1.0),
+m_frame_timer_started(false)
 {
     if (w)
     {
@@ -12,19 +19,120 @@ sad::p2d::WorldStepTask::WorldStepTask(sad::p2d::World * w, sad::Renderer * r)
 
 void sad::p2d::WorldStepTask::_process()
 {
+    if (!m_enabled)
+    {
+        // Time, spent while disabled, should not be simulated after enabling
+        m_frame_timer_started = false;
+        return;
+    }
+    if (this->isFixedTimeStep())
+    {
+        double frame_time = m_fixed_time_step;
+        if (m_frame_timer_started)
+        {
+            m_frame_timer.stop();
+            frame_time = m_frame_timer.elapsed() / 1000.0;
+        }
+        m_frame_timer.start();
+        m_frame_timer_started = true;
+        this->advance(frame_time);
+        return;
+    }
     // 1.0 is a second, so if 1 frame at 1s, we will step second
     double fps = m_renderer->fps();
     double rendertime = 1.0 / fps;
     // If rendering goes extremely slow, like 5 FPS per sec
     // everything can broke, So we avoid this, by setting rendertime to
-    // normal. Also we can't obviously use multiple steps, because
-    // it could lead us to spiral of death problem
-    if (rendertime >= 200.0)
+    // normal. Multiple steps are taken only in fixed step mode, where
+    // their amount is limited to avoid spiral of death problem
+    if (rendertime >= 0.2)
     {
         rendertime = 1.0 / 60.0; 
     }
-    if (m_enabled)
-        m_world->step(rendertime);
+    this->advance(rendertime);
+}
+
+void sad::p2d::WorldStepTask::setFixedTimeStep(double step)
+{
+    m_fixed_time_step = step;
+    this->resetAccumulator();
+}
+
+double sad::p2d::WorldStepTask::fixedTimeStep() const
+{
+    return m_fixed_time_step;
+}
+
+bool sad::p2d::WorldStepTask::isFixedTimeStep() const
+{
+    return m_fixed_time_step > 0;
+}
+
+void sad::p2d::WorldStepTask::setMaxSubsteps(unsigned int substeps)
+{
+    m_max_substeps = (substeps == 0) ? 1 : substeps;
+}
+
+unsigned int sad::p2d::WorldStepTask::maxSubsteps() const
+{
+    return m_max_substeps;
+}
+
+double sad::p2d::WorldStepTask::accumulator() const
+{
+    return m_accumulator;
+}
+
+double sad::p2d::WorldStepTask::interpolationAlpha() const
+{
+    return m_interpolation_alpha;
+}
+
+void sad::p2d::WorldStepTask::resetAccumulator()
+{
+    m_accumulator = 0;
+    m_interpolation_alpha = (this->isFixedTimeStep()) ? 0.0 : 1.0;
+    m_frame_timer_started = false;
+    if (m_world)
+    {
+        m_world->setInterpolationAlpha(m_interpolation_alpha);
+    }
+}
+
+unsigned int sad::p2d::WorldStepTask::advance(double frame_time)
+{
+    if (!m_world)
+    {
+        return 0;
+    }
+    if (!(this->isFixedTimeStep()))
+    {
+        m_interpolation_alpha = 1.0;
+        m_world->setInterpolationAlpha(m_interpolation_alpha);
+        m_world->step(frame_time);
+        return 1;
+    }
+
+    if (frame_time > 0)
+    {
+        m_accumulator += frame_time;
+    }
+    unsigned int steps = 0;
+    while (m_accumulator >= m_fixed_time_step && steps < m_max_substeps)
+    {
+        m_world->step(m_fixed_time_step);
+        m_accumulator -= m_fixed_time_step;
+        ++steps;
+    }
+    // If we could not catch up, remaining time is dropped, otherwise
+    // every next frame will be slower, than previous one
+    if (m_accumulator >= m_fixed_time_step)
+    {
+        m_accumulator = fmod(m_accumulator, m_fixed_time_step);
+    }
+    m_interpolation_alpha = m_accumulator / m_fixed_time_step;
+    m_world->setInterpolationAlpha(m_interpolation_alpha);
+    return steps;
 }
 
 void sad::p2d::WorldStepTask::setWorld(sad::p2d::World * world)
@@ -1,6 +1,7 @@
 #include "pipeline/pipeline.h"
 #include "db/dbtypename.h"
 #include <cassert>
+#include <algorithm>
 
 sad::pipeline::Pipeline::Pipeline()
 {
@@ -107,6 +108,23 @@ void sad::pipeline::Pipeline::run()
     this->performQueuedActions();
 }
 
+bool sad::pipeline::Pipeline::hasUserSteps(const sad::Vector<sad::String>& ignored_marks) const
+{
+    for(size_t i = 0; i < m_user_steps.size(); i++)
+    {
+        sad::pipeline::Step* step = m_user_steps[i];
+        if (step->enabled())
+        {
+            sad::Maybe<sad::String> mark = step->mark();
+            if (mark.exists() == false || std::find(ignored_marks.begin(), ignored_marks.end(), mark.value()) == ignored_marks.end())
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 sad::pipeline::Step * sad::pipeline::Pipeline::append(sad::pipeline::Step * step)
 {
     step->setSource(sad::pipeline::ST_USER);
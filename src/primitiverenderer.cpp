@@ -1,10 +1,10 @@
 #include "primitiverenderer.h"
 
-#include "os/glheaders.h"
+#include "rendering/backend.h"
 
 #include "db/dbtypename.h"
 
-sad::PrimitiveRenderer::PrimitiveRenderer()
+sad::PrimitiveRenderer::PrimitiveRenderer() : m_renderer(NULL)
 {
     
 }
@@ -14,26 +14,24 @@ sad::PrimitiveRenderer::~PrimitiveRenderer()
     
 }
 
+void sad::PrimitiveRenderer::setRenderer(sad::Renderer* renderer)
+{
+    m_renderer = renderer;
+}
+
+sad::Renderer* sad::PrimitiveRenderer::renderer() const
+{
+    return m_renderer;
+}
+
 void sad::PrimitiveRenderer::line(
         const sad::Point2D & p1,
         const sad::Point2D & p2,
         const sad::AColor & c
 )
 {
-    glDisable(GL_TEXTURE_2D);
-    GLint   clr[4]={};
-    glGetIntegerv(GL_CURRENT_COLOR,clr);
-    glColor4ub(c.r(),c.g(),c.b(),c.a());
-    
-    glBegin(GL_LINES);
-    
-    glVertex2f((GLfloat)p1.x(), (GLfloat)p1.y());
-    glVertex2f((GLfloat)p2.x(), (GLfloat)p2.y());
-
-    glEnd();
-    
-    glColor4iv(clr);
-    glEnable(GL_TEXTURE_2D);
+    sad::Point2D points[2] = { p1, p2 };
+    sad::rendering::backend(m_renderer)->drawLines(points, 2, c);
 }
 
 void sad::PrimitiveRenderer::rectangle(
@@ -41,27 +39,13 @@ void sad::PrimitiveRenderer::rectangle(
         const sad::AColor & c
 )
 {
-    glDisable(GL_TEXTURE_2D);
-    GLint   clr[4]={};
-    glGetIntegerv(GL_CURRENT_COLOR,clr);
-    glColor4ub(c.r(),c.g(),c.b(),c.a());
-    
-    glBegin(GL_LINES);
-    glVertex2f((GLfloat)r[0].x(), (GLfloat)r[0].y());
-    glVertex2f((GLfloat)r[1].x(), (GLfloat)r[1].y());
-
-    glVertex2f((GLfloat)r[1].x(), (GLfloat)r[1].y());
-    glVertex2f((GLfloat)r[2].x(), (GLfloat)r[2].y());
-
-    glVertex2f((GLfloat)r[2].x(), (GLfloat)r[2].y());
-    glVertex2f((GLfloat)r[3].x(), (GLfloat)r[3].y());	
-
-    glVertex2f((GLfloat)r[3].x(), (GLfloat)r[3].y());	
-    glVertex2f((GLfloat)r[0].x(), (GLfloat)r[0].y());
-
-    glEnd();
-    glColor4iv(clr);
-    glEnable(GL_TEXTURE_2D);
+    sad::Point2D points[8] = {
+        r[0], r[1],
+        r[1], r[2],
+        r[2], r[3],
+        r[3], r[0]
+    };
+    sad::rendering::backend(m_renderer)->drawLines(points, 8, c);
 }
 
 DECLARE_COMMON_TYPE(sad::PrimitiveRenderer)
\ No newline at end of file
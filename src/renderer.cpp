@@ -12,6 +12,11 @@
 
 #include "pipeline/pipeline.h"
 
+#include "rendering/glbackend.h"
+#include "rendering/nullbackend.h"
+#include "rendering/recorder.h"
+#include "rendering/textureresidency.h"
+
 #include "os/windowhandles.h"
 #include "os/glheaders.h"
 #include "os/threadimpl.h"
@@ -25,6 +30,7 @@
 #include "imageformats/pngloader.h"
 #include "imageformats/tgaloader.h"
 #include "imageformats/srgbaloader.h"
+#include "imageformats/compressedstorageloader.h"
 
 #ifdef LINUX
     #include <stdio.h>
@@ -50,10 +56,15 @@ m_opengl(new sad::OpenGL()),
 m_main_loop(new sad::MainLoop()),
 m_fps_interpolation(new sad::FPSInterpolation()),
 m_primitiverenderer(new sad::PrimitiveRenderer()),
+m_sprite_batch(new sad::SpriteBatch()),
 m_controls(new sad::input::Controls()),
 m_animations(new sad::animations::Animations()),
 m_pipeline(new sad::pipeline::Pipeline()),
-m_added_system_pipeline_tasks(false)
+m_added_system_pipeline_tasks(false),
+m_headless(false),
+m_backend(new sad::rendering::GLBackend(this)),
+m_recorder(NULL),
+m_texture_residency(new sad::rendering::TextureResidency())
 {
 #ifdef X11
     SafeXInitThreads();
@@ -63,6 +74,8 @@ m_added_system_pipeline_tasks(false)
     m_cursor->addRef();
     m_opengl->setRenderer(this);
     m_main_loop->setRenderer(this);
+    m_primitiverenderer->setRenderer(this);
+    m_sprite_batch->setRenderer(this);
 
     setTextureLoader("BMP", new sad::imageformats::BMPLoader());
     setTextureLoader("TGA", new sad::imageformats::TGALoader());
@@ -71,6 +84,8 @@ m_added_system_pipeline_tasks(false)
     setTextureLoader("SR5G6B5", new sad::imageformats::PixelStorageLoader(sad::imageformats::PixelStorageLoader::SR5G6B5Settings));
     setTextureLoader("SR4G4B4A4", new sad::imageformats::PixelStorageLoader(sad::imageformats::PixelStorageLoader::SR4G4B4A4Settings));
     setTextureLoader("SR3G3B2", new sad::imageformats::PixelStorageLoader(sad::imageformats::PixelStorageLoader::SR3G3B2Settings));
+    setTextureLoader("SBC1", new sad::imageformats::CompressedStorageLoader(sad::imageformats::CompressedStorageLoader::SBC1Settings));
+    setTextureLoader("SBC3", new sad::imageformats::CompressedStorageLoader(sad::imageformats::CompressedStorageLoader::SBC3Settings));
 
 
 
@@ -99,6 +114,9 @@ sad::Renderer::~Renderer(void)
 
     delete m_animations;
     delete m_primitiverenderer;
+    delete m_sprite_batch;
+    delete m_recorder;
+    delete m_backend;
     m_cursor->delRef();
 
     // Force freeing resources, to make sure, that pointer to context will be valid, when resource
@@ -126,6 +144,7 @@ sad::Renderer::~Renderer(void)
     {
         it.value()->delRef();
     }   
+    delete m_texture_residency;
 }
 
 void sad::Renderer::setScene(Scene * scene)
@@ -164,6 +183,11 @@ bool sad::Renderer::run()
 
 void sad::Renderer::quit()
 {
+    if (m_headless)
+    {
+        m_main_loop->stop();
+        return;
+    }
     if (m_window->valid())
     {
         m_window->close();
@@ -286,6 +310,11 @@ sad::OpenGL * sad::Renderer::opengl() const
     return m_opengl;
 }
 
+sad::rendering::TextureResidency* sad::Renderer::textureResidency() const
+{
+    return m_texture_residency;
+}
+
 sad::MainLoop * sad::Renderer::mainLoop() const
 {
     return m_main_loop;
@@ -362,7 +391,9 @@ void sad::Renderer::emergencyShutdown()
     {
         m_emergency_shutdown_callbacks[i]->call(this);
     }
-    
+
+    // Write all queued messages, because application could be terminated right after shutdown
+    m_log->flush();
 
     // Destroy context and window, so nothing could go wrong
     this->context()->destroy();
@@ -391,22 +422,24 @@ void sad::Renderer::reshape(int width, int height)
     }
     // Reset viewport for window
     glViewport (0, 0, width, height);
+    m_viewport_size = sad::Size2I(width, height);
     
-    // Clear projection matrix
-    glMatrixMode (GL_PROJECTION);
-    glLoadIdentity ();
-  
-    //  Set perspective projection
-    GLfloat aspectratio = static_cast<GLfloat>(width)/static_cast<GLfloat>(height);
-    gluPerspective(
+    //  Set perspective projection, computed on CPU, so it's never read back from OpenGL
+    double aspectratio = static_cast<double>(width)/static_cast<double>(height);
+    m_projection_matrix = sad::Matrix4x4<double>::perspective(
         m_glsettings.fov(), 
         aspectratio,
         m_glsettings.znear(), 
         m_glsettings.zfar()
-    );      
+    );
+    GLdouble projection[16];
+    m_projection_matrix.toColumnMajor(projection);
+    sad::rendering::GLStateCache* cache = this->opengl()->stateCache();
+    cache->setMatrixMode(GL_PROJECTION);
+    glLoadMatrixd(projection);
     
     // Clear modelview matrix
-    glMatrixMode (GL_MODELVIEW);                                        
+    cache->setMatrixMode(GL_MODELVIEW);
     glLoadIdentity ();  
 }
 
@@ -489,6 +522,10 @@ void sad::Renderer::setPrimitiveRenderer(sad::PrimitiveRenderer * r)
 {
     delete m_primitiverenderer; 
     m_primitiverenderer = r;
+    if (m_primitiverenderer)
+    {
+        m_primitiverenderer->setRenderer(this);
+    }
 }
 
 
@@ -497,6 +534,11 @@ sad::PrimitiveRenderer * sad::Renderer::render() const
     return m_primitiverenderer;
 }
 
+sad::SpriteBatch * sad::Renderer::spriteBatch() const
+{
+    return m_sprite_batch;
+}
+
 #ifdef LINUX
 // http://www.gnu.org/software/hurd/user/tlecarrour/porting_guide_for_dummies.html
 static char *readlink_malloc(const char *filename)
@@ -793,11 +835,110 @@ const sad::Vector3D& sad::Renderer::globalTranslationOffset() const
     return m_global_translation_offset;
 }
 
+void sad::Renderer::setProjectionMatrix(const sad::Matrix4x4<double>& m)
+{
+    m_projection_matrix = m;
+}
+
+const sad::Matrix4x4<double>& sad::Renderer::projectionMatrix() const
+{
+    return m_projection_matrix;
+}
+
+const sad::Size2I& sad::Renderer::viewportSize() const
+{
+    return m_viewport_size;
+}
+
+sad::Point3D sad::Renderer::unproject(const sad::Point3D& p) const
+{
+    if (m_viewport_size.Width == 0 || m_viewport_size.Height == 0)
+    {
+        return p;
+    }
+    int viewport[4] = {
+        0,
+        0,
+        static_cast<int>(m_viewport_size.Width),
+        static_cast<int>(m_viewport_size.Height)
+    };
+    sad::Point3D result;
+    if (sad::unProject(p, sad::Matrix4x4<double>::identity(), m_projection_matrix, viewport, result) == false)
+    {
+        return p;
+    }
+    result.setX(result.x() - m_global_translation_offset.x());
+    result.setY(result.y() - m_global_translation_offset.y());
+    return result;
+}
+
+void sad::Renderer::setHeadless(bool headless)
+{
+    m_headless = headless;
+    if (headless)
+    {
+        this->setBackend(new sad::rendering::NullBackend());
+    }
+    else
+    {
+        this->setBackend(new sad::rendering::GLBackend(this));
+    }
+}
+
+bool sad::Renderer::headless() const
+{
+    return m_headless;
+}
+
+sad::rendering::Backend* sad::Renderer::backend() const
+{
+    if (m_recorder)
+    {
+        return m_recorder;
+    }
+    return m_backend;
+}
+
+void sad::Renderer::setBackend(sad::rendering::Backend* backend)
+{
+    assert( backend );
+    this->stopRecording();
+    delete m_backend;
+    m_backend = backend;
+}
+
+void sad::Renderer::startRecording(sad::rendering::CommandBuffer* buffer)
+{
+    assert( buffer );
+    delete m_recorder;
+    m_recorder = new sad::rendering::Recorder(buffer, m_backend);
+}
+
+void sad::Renderer::stopRecording()
+{
+    delete m_recorder;
+    m_recorder = NULL;
+}
+
+bool sad::Renderer::recording() const
+{
+    return m_recorder != NULL;
+}
+
 // ============================================================ PROTECTED METHODS ============================================================
 
 bool sad::Renderer::initRendererBeforeLoop()
 {
     SL_INTERNAL_SCOPE("sad::Renderer::initRendererBeforeLoop()", *this);
+    if (m_headless)
+    {
+        // No window and context, so pipeline is run on calling thread
+        m_context_thread = reinterpret_cast<void*>(sad::os::current_thread_id());
+        this->initPipeline();
+        this->cursor()->insertHandlersIfNeeded();
+        this->mainLoop()->initMainLoop();
+        return true;
+    }
     bool success = true;
     if (m_window->valid() == false)
     {
@@ -839,8 +980,8 @@ bool sad::Renderer::initRendererBeforeLoop()
 
 void sad::Renderer::runOnce()
 {
-    assert(m_window->valid());
-    assert(m_context->valid());
+    assert(m_headless || m_window->valid());
+    assert(m_headless || m_context->valid());
 
 
     mainLoop()->run(SAD_MAIN_LOOP_RUN_ONLY_ONCE);
@@ -853,6 +994,10 @@ void sad::Renderer::deinitRendererAfterLoop()
     this->mainLoop()->deinitMainLoop();
     cursor()->removeHandlersIfNeeded();
     cleanPipeline();
+    if (m_headless)
+    {
+        return;
+    }
 
     m_context->destroy();
     m_window->destroy();
@@ -885,9 +1030,12 @@ bool sad::Renderer::initGLRendering()
             glHint(GL_GENERATE_MIPMAP_HINT,GL_NICEST);
     }
 
-    glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
-    glEnable(GL_BLEND);
-    glEnable(GL_TEXTURE_2D);
+    // A state of new context is unknown
+    sad::rendering::GLStateCache* cache = this->opengl()->stateCache();
+    cache->invalidate();
+    cache->setBlendFunction(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
+    cache->setBlendEnabled(true);
+    cache->setTextureEnabled(true);
     glEnable(GL_COLOR_MATERIAL);
     
     reshape(m_glsettings.width(),m_glsettings.height());
@@ -938,9 +1086,9 @@ void sad::Renderer::cleanPipeline()
 
 void sad::Renderer::startRendering()
 {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
+    this->backend()->startFrame();
+    m_sprite_batch->startFrame();
+    m_texture_residency->startFrame();
 }
 
 void sad::Renderer::renderScenes()
@@ -971,6 +1119,11 @@ void sad::Renderer::renderScenes()
 
 void sad::Renderer::finishRendering()
 {
+    this->backend()->finishFrame();
+    if (m_headless)
+    {
+        return;
+    }
 #ifndef NO_GL_FINISH 
     glFinish();
 #endif
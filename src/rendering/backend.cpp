@@ -0,0 +1,20 @@
+#include "rendering/backend.h"
+#include "rendering/glbackend.h"
+
+#include "renderer.h"
+
+sad::rendering::Backend::~Backend()
+{
+
+}
+
+static sad::rendering::GLBackend sad_rendering_default_backend;
+
+sad::rendering::Backend* sad::rendering::backend(sad::Renderer* renderer)
+{
+    if (renderer)
+    {
+        return renderer->backend();
+    }
+    return &sad_rendering_default_backend;
+}
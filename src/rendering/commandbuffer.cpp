@@ -0,0 +1,518 @@
+#include "rendering/commandbuffer.h"
+#include "rendering/backend.h"
+
+#include "texture.h"
+#include "sadhash.h"
+
+#include <fstream>
+#include <cstring>
+
+/*! A signature of saved command buffer
+ */
+static const char sad_rendering_command_buffer_signature[8] = {'S', 'A', 'D', 'R', 'C', 'M', 'D', '1'};
+
+/*! A reader of recorded data, which checks bounds
+ */
+class SadRenderingCommandReader
+{
+public:
+    /*! Creates new reader
+        \param[in] data a data
+     */
+    SadRenderingCommandReader(const sad::Vector<unsigned char>& data) : m_data(data), m_position(0), m_failed(false)
+    {
+    }
+    /*! Whether all data is read
+        \return whether all data is read
+     */
+    bool atEnd() const
+    {
+        return m_position >= m_data.size();
+    }
+    /*! Whether reading failed due to lack of data
+        \return whether reading failed
+     */
+    bool failed() const
+    {
+        return m_failed;
+    }
+    /*! Returns pointer to next bytes of data and skips them
+        \param[in] size amount of bytes
+        \return pointer or NULL if not enough data
+     */
+    const unsigned char* read(size_t size)
+    {
+        if (m_failed || m_data.size() - m_position < size)
+        {
+            m_failed = true;
+            return NULL;
+        }
+        const unsigned char* result = &(m_data[0]) + m_position;
+        m_position += size;
+        return result;
+    }
+    /*! Reads a byte
+        \return byte
+     */
+    unsigned char readByte()
+    {
+        const unsigned char* p = read(1);
+        return (p) ? *p : 0;
+    }
+    /*! Reads unsigned integer
+        \return value
+     */
+    unsigned int readUInt()
+    {
+        unsigned int result = 0;
+        const unsigned char* p = read(sizeof(unsigned int));
+        if (p)
+        {
+            memcpy(&result, p, sizeof(unsigned int));
+        }
+        return result;
+    }
+    /*! Reads float
+        \return value
+     */
+    double readFloat()
+    {
+        float result = 0;
+        const unsigned char* p = read(sizeof(float));
+        if (p)
+        {
+            memcpy(&result, p, sizeof(float));
+        }
+        return result;
+    }
+    /*! Reads a color
+        \return color
+     */
+    sad::AColor readColor()
+    {
+        const unsigned char* p = read(4);
+        if (p)
+        {
+            return sad::AColor(p[0], p[1], p[2], p[3]);
+        }
+        return sad::AColor();
+    }
+    /*! Reads a rectangle
+        \return rectangle
+     */
+    sad::Rect2D readRect()
+    {
+        sad::Rect2D result;
+        for(int i = 0; i < 4; i++)
+        {
+            double x = readFloat();
+            double y = readFloat();
+            result[i] = sad::Point2D(x, y);
+        }
+        return result;
+    }
+    /*! Reads an array of values, copying it to aligned storage
+        \param[in] v a storage
+        \param[in] count amount of values
+     */
+    template<typename T>
+    void readArray(sad::Vector<T>& v, size_t count)
+    {
+        v.clear();
+        // Amount of values could not exceed amount of bytes, so size is not overflown
+        if (count > m_data.size())
+        {
+            m_failed = true;
+            return;
+        }
+        const unsigned char* p = read(count * sizeof(T));
+        if (p && count)
+        {
+            v.resize(count);
+            memcpy(&(v[0]), p, count * sizeof(T));
+        }
+    }
+private:
+    /*! A data
+     */
+    const sad::Vector<unsigned char>& m_data;
+    /*! A position in data
+     */
+    size_t m_position;
+    /*! Whether reading failed
+     */
+    bool m_failed;
+};
+
+sad::rendering::CommandBuffer::CommandBuffer() : m_frames(0), m_commands(0)
+{
+
+}
+
+sad::rendering::CommandBuffer::~CommandBuffer()
+{
+
+}
+
+void sad::rendering::CommandBuffer::startFrame()
+{
+    writeCommand(sad::rendering::CommandBuffer::CT_StartFrame);
+    ++m_frames;
+}
+
+void sad::rendering::CommandBuffer::finishFrame()
+{
+    writeCommand(sad::rendering::CommandBuffer::CT_FinishFrame);
+}
+
+void sad::rendering::CommandBuffer::setOrthographicProjection(double width, double height)
+{
+    writeCommand(sad::rendering::CommandBuffer::CT_SetOrthographicProjection);
+    writeFloat(width);
+    writeFloat(height);
+}
+
+void sad::rendering::CommandBuffer::pushMatrix()
+{
+    writeCommand(sad::rendering::CommandBuffer::CT_PushMatrix);
+}
+
+void sad::rendering::CommandBuffer::popMatrix()
+{
+    writeCommand(sad::rendering::CommandBuffer::CT_PopMatrix);
+}
+
+void sad::rendering::CommandBuffer::translate(double x, double y, double z)
+{
+    writeCommand(sad::rendering::CommandBuffer::CT_Translate);
+    writeFloat(x);
+    writeFloat(y);
+    writeFloat(z);
+}
+
+void sad::rendering::CommandBuffer::rotate(double angle, double x, double y, double z)
+{
+    writeCommand(sad::rendering::CommandBuffer::CT_Rotate);
+    writeFloat(angle);
+    writeFloat(x);
+    writeFloat(y);
+    writeFloat(z);
+}
+
+void sad::rendering::CommandBuffer::defineTexture(unsigned int key, unsigned int width, unsigned int height)
+{
+    writeCommand(sad::rendering::CommandBuffer::CT_DefineTexture);
+    writeUInt(key);
+    writeUInt(width);
+    writeUInt(height);
+}
+
+void sad::rendering::CommandBuffer::drawSprite(
+    unsigned int texture,
+    const sad::Rect2D& area,
+    const sad::Rect2D& texture_coordinates,
+    const sad::AColor& color
+)
+{
+    writeCommand(sad::rendering::CommandBuffer::CT_DrawSprite);
+    writeUInt(texture);
+    for(int i = 0; i < 4; i++)
+    {
+        writeFloat(area[i].x());
+        writeFloat(area[i].y());
+    }
+    for(int i = 0; i < 4; i++)
+    {
+        writeFloat(texture_coordinates[i].x());
+        writeFloat(texture_coordinates[i].y());
+    }
+    writeColor(color);
+}
+
+void sad::rendering::CommandBuffer::drawQuads(
+    unsigned int texture,
+    const float* vertexes,
+    const float* texture_coordinates,
+    const unsigned char* colors,
+    unsigned int quads
+)
+{
+    writeCommand(sad::rendering::CommandBuffer::CT_DrawQuads);
+    writeUInt(texture);
+    writeUInt(quads);
+    write(vertexes, quads * 8 * sizeof(float));
+    write(texture_coordinates, quads * 8 * sizeof(float));
+    write(colors, quads * 16);
+}
+
+void sad::rendering::CommandBuffer::drawLines(const sad::Point2D* points, unsigned int count, const sad::AColor& color)
+{
+    writeCommand(sad::rendering::CommandBuffer::CT_DrawLines);
+    writeUInt(count);
+    writeColor(color);
+    for(unsigned int i = 0; i < count; i++)
+    {
+        writeFloat(points[i].x());
+        writeFloat(points[i].y());
+    }
+}
+
+void sad::rendering::CommandBuffer::drawText(unsigned int characters)
+{
+    writeCommand(sad::rendering::CommandBuffer::CT_DrawText);
+    writeUInt(characters);
+}
+
+unsigned int sad::rendering::CommandBuffer::frameCount() const
+{
+    return m_frames;
+}
+
+unsigned int sad::rendering::CommandBuffer::commandCount() const
+{
+    return m_commands;
+}
+
+const sad::Vector<unsigned char>& sad::rendering::CommandBuffer::data() const
+{
+    return m_data;
+}
+
+void sad::rendering::CommandBuffer::clear()
+{
+    m_data.clear();
+    m_frames = 0;
+    m_commands = 0;
+}
+
+bool sad::rendering::CommandBuffer::replay(sad::rendering::Backend* backend) const
+{
+    SadRenderingCommandReader reader(m_data);
+    sad::Hash<unsigned int, sad::Texture*> textures;
+    sad::Vector<float> vertexes;
+    sad::Vector<float> texture_coordinates;
+    sad::Vector<unsigned char> colors;
+    sad::Vector<sad::Point2D> points;
+    bool ok = true;
+    while(!reader.atEnd() && ok)
+    {
+        unsigned char type = reader.readByte();
+        switch(type)
+        {
+            case sad::rendering::CommandBuffer::CT_StartFrame:
+                backend->startFrame();
+                break;
+            case sad::rendering::CommandBuffer::CT_FinishFrame:
+                backend->finishFrame();
+                break;
+            case sad::rendering::CommandBuffer::CT_SetOrthographicProjection:
+            {
+                double width = reader.readFloat();
+                double height = reader.readFloat();
+                ok = !reader.failed();
+                if (ok)
+                {
+                    backend->setOrthographicProjection(width, height);
+                }
+                break;
+            }
+            case sad::rendering::CommandBuffer::CT_PushMatrix:
+                backend->pushMatrix();
+                break;
+            case sad::rendering::CommandBuffer::CT_PopMatrix:
+                backend->popMatrix();
+                break;
+            case sad::rendering::CommandBuffer::CT_Translate:
+            {
+                double x = reader.readFloat();
+                double y = reader.readFloat();
+                double z = reader.readFloat();
+                ok = !reader.failed();
+                if (ok)
+                {
+                    backend->translate(x, y, z);
+                }
+                break;
+            }
+            case sad::rendering::CommandBuffer::CT_Rotate:
+            {
+                double angle = reader.readFloat();
+                double x = reader.readFloat();
+                double y = reader.readFloat();
+                double z = reader.readFloat();
+                ok = !reader.failed();
+                if (ok)
+                {
+                    backend->rotate(angle, x, y, z);
+                }
+                break;
+            }
+            case sad::rendering::CommandBuffer::CT_DefineTexture:
+            {
+                unsigned int key = reader.readUInt();
+                unsigned int width = reader.readUInt();
+                unsigned int height = reader.readUInt();
+                ok = !reader.failed() && !textures.contains(key);
+                if (ok)
+                {
+                    sad::Texture* texture = new sad::Texture();
+                    texture->Width = width;
+                    texture->Height = height;
+                    textures.insert(key, texture);
+                }
+                break;
+            }
+            case sad::rendering::CommandBuffer::CT_DrawSprite:
+            {
+                unsigned int key = reader.readUInt();
+                sad::Rect2D area = reader.readRect();
+                sad::Rect2D tc = reader.readRect();
+                sad::AColor color = reader.readColor();
+                ok = !reader.failed() && textures.contains(key);
+                if (ok)
+                {
+                    backend->drawSprite(textures[key], area, tc, color);
+                }
+                break;
+            }
+            case sad::rendering::CommandBuffer::CT_DrawQuads:
+            {
+                unsigned int key = reader.readUInt();
+                unsigned int quads = reader.readUInt();
+                reader.readArray(vertexes, static_cast<size_t>(quads) * 8);
+                reader.readArray(texture_coordinates, static_cast<size_t>(quads) * 8);
+                reader.readArray(colors, static_cast<size_t>(quads) * 16);
+                ok = !reader.failed() && textures.contains(key) && quads != 0;
+                if (ok)
+                {
+                    backend->drawQuads(textures[key], &(vertexes[0]), &(texture_coordinates[0]), &(colors[0]), quads);
+                }
+                break;
+            }
+            case sad::rendering::CommandBuffer::CT_DrawLines:
+            {
+                unsigned int count = reader.readUInt();
+                sad::AColor color = reader.readColor();
+                points.clear();
+                for(unsigned int i = 0; i < count && !reader.failed(); i++)
+                {
+                    double x = reader.readFloat();
+                    double y = reader.readFloat();
+                    points << sad::Point2D(x, y);
+                }
+                ok = !reader.failed();
+                if (ok)
+                {
+                    backend->drawLines((count) ? &(points[0]) : NULL, count, color);
+                }
+                break;
+            }
+            case sad::rendering::CommandBuffer::CT_DrawText:
+            {
+                unsigned int characters = reader.readUInt();
+                ok = !reader.failed();
+                if (ok)
+                {
+                    backend->drawText(characters, std::function<void()>());
+                }
+                break;
+            }
+            default:
+                ok = false;
+        };
+    }
+    for(sad::Hash<unsigned int, sad::Texture*>::iterator it = textures.begin(); it != textures.end(); ++it)
+    {
+        delete it.value();
+    }
+    return ok;
+}
+
+bool sad::rendering::CommandBuffer::save(const sad::String& filename) const
+{
+    std::ofstream stream(filename.c_str(), std::ios_base::out | std::ios_base::binary);
+    if (!stream.good())
+    {
+        return false;
+    }
+    unsigned int size = static_cast<unsigned int>(m_data.size());
+    stream.write(sad_rendering_command_buffer_signature, sizeof(sad_rendering_command_buffer_signature));
+    stream.write(reinterpret_cast<const char*>(&m_frames), sizeof(unsigned int));
+    stream.write(reinterpret_cast<const char*>(&m_commands), sizeof(unsigned int));
+    stream.write(reinterpret_cast<const char*>(&size), sizeof(unsigned int));
+    if (size)
+    {
+        stream.write(reinterpret_cast<const char*>(&(m_data[0])), size);
+    }
+    return stream.good();
+}
+
+bool sad::rendering::CommandBuffer::load(const sad::String& filename)
+{
+    std::ifstream stream(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+    if (!stream.good())
+    {
+        return false;
+    }
+    char signature[sizeof(sad_rendering_command_buffer_signature)];
+    unsigned int frames = 0, commands = 0, size = 0;
+    stream.read(signature, sizeof(signature));
+    stream.read(reinterpret_cast<char*>(&frames), sizeof(unsigned int));
+    stream.read(reinterpret_cast<char*>(&commands), sizeof(unsigned int));
+    stream.read(reinterpret_cast<char*>(&size), sizeof(unsigned int));
+    if (!stream.good() || memcmp(signature, sad_rendering_command_buffer_signature, sizeof(signature)) != 0)
+    {
+        return false;
+    }
+    std::string data(
+        (std::istreambuf_iterator<char>(stream)),
+        std::istreambuf_iterator<char>()
+    );
+    if (data.size() != size)
+    {
+        return false;
+    }
+    m_data.resize(size);
+    if (size)
+    {
+        memcpy(&(m_data[0]), data.c_str(), size);
+    }
+    m_frames = frames;
+    m_commands = commands;
+    return true;
+}
+
+// ============================================================ PROTECTED METHODS ============================================================
+
+void sad::rendering::CommandBuffer::writeCommand(sad::rendering::CommandBuffer::CommandType type)
+{
+    m_data << static_cast<unsigned char>(type);
+    ++m_commands;
+}
+
+void sad::rendering::CommandBuffer::write(const void* data, size_t size)
+{
+    if (size == 0)
+    {
+        return;
+    }
+    size_t offset = m_data.size();
+    m_data.resize(offset + size);
+    memcpy(&(m_data[0]) + offset, data, size);
+}
+
+void sad::rendering::CommandBuffer::writeUInt(unsigned int value)
+{
+    write(&value, sizeof(unsigned int));
+}
+
+void sad::rendering::CommandBuffer::writeFloat(double value)
+{
+    float v = static_cast<float>(value);
+    write(&v, sizeof(float));
+}
+
+void sad::rendering::CommandBuffer::writeColor(const sad::AColor& color)
+{
+    m_data << color.r() << color.g() << color.b() << color.a();
+}
@@ -0,0 +1,153 @@
+#include "rendering/glbackend.h"
+
+#include "texture.h"
+#include "renderer.h"
+#include "opengl.h"
+
+#include "os/glheaders.h"
+
+sad::rendering::GLBackend::GLBackend(sad::Renderer* renderer) : m_renderer(renderer)
+{
+
+}
+
+sad::rendering::GLBackend::~GLBackend()
+{
+
+}
+
+sad::rendering::GLStateCache* sad::rendering::GLBackend::stateCache() const
+{
+    sad::Renderer* r = (m_renderer) ? m_renderer : sad::Renderer::ref();
+    return r->opengl()->stateCache();
+}
+
+void sad::rendering::GLBackend::startFrame()
+{
+    sad::rendering::GLStateCache* cache = this->stateCache();
+    // State could be changed by user code between frames
+    cache->invalidate();
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    cache->setMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+}
+
+void sad::rendering::GLBackend::finishFrame()
+{
+
+}
+
+void sad::rendering::GLBackend::setOrthographicProjection(double width, double height)
+{
+    sad::rendering::GLStateCache* cache = this->stateCache();
+    sad::Maybe<unsigned int> mode = cache->matrixMode();
+    cache->setMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    gluOrtho2D(0, width, 0, height);
+    cache->setMatrixMode(mode.exists() ? mode.value() : GL_MODELVIEW);
+}
+
+void sad::rendering::GLBackend::pushMatrix()
+{
+    this->stateCache()->setMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+}
+
+void sad::rendering::GLBackend::popMatrix()
+{
+    glPopMatrix();
+}
+
+void sad::rendering::GLBackend::translate(double x, double y, double z)
+{
+    glTranslatef(
+        static_cast<GLfloat>(x),
+        static_cast<GLfloat>(y),
+        static_cast<GLfloat>(z)
+    );
+}
+
+void sad::rendering::GLBackend::rotate(double angle, double x, double y, double z)
+{
+    glRotatef(
+        static_cast<GLfloat>(angle),
+        static_cast<GLfloat>(x),
+        static_cast<GLfloat>(y),
+        static_cast<GLfloat>(z)
+    );
+}
+
+void sad::rendering::GLBackend::drawSprite(
+    sad::Texture* texture,
+    const sad::Rect2D& area,
+    const sad::Rect2D& texture_coordinates,
+    const sad::AColor& color
+)
+{
+    this->stateCache()->setColor(color);
+    texture->bind();
+    glBegin(GL_QUADS);
+    for (int i = 0;i < 4; i++)
+    {
+        glTexCoord2f(
+            static_cast<GLfloat>(texture_coordinates[i].x()),
+            static_cast<GLfloat>(texture_coordinates[i].y())
+        );
+        glVertex2f(
+            static_cast<GLfloat>(area[i].x()),
+            static_cast<GLfloat>(area[i].y())
+        );
+    }
+    glEnd();
+}
+
+void sad::rendering::GLBackend::drawQuads(
+    sad::Texture* texture,
+    const float* vertexes,
+    const float* texture_coordinates,
+    const unsigned char* colors,
+    unsigned int quads
+)
+{
+    texture->bind();
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+
+    glVertexPointer(2, GL_FLOAT, 0, vertexes);
+    glTexCoordPointer(2, GL_FLOAT, 0, texture_coordinates);
+    glColorPointer(4, GL_UNSIGNED_BYTE, 0, colors);
+    glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(quads * 4));
+
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    // Current color is undefined after drawing with color array
+    this->stateCache()->forgetColor();
+}
+
+void sad::rendering::GLBackend::drawLines(const sad::Point2D* points, unsigned int count, const sad::AColor& color)
+{
+    sad::rendering::GLStateCache* cache = this->stateCache();
+    cache->setTextureEnabled(false);
+    cache->setColor(color);
+
+    glBegin(GL_LINES);
+    for(unsigned int i = 0; i < count; i++)
+    {
+        glVertex2f(static_cast<GLfloat>(points[i].x()), static_cast<GLfloat>(points[i].y()));
+    }
+    glEnd();
+
+    cache->setTextureEnabled(true);
+}
+
+void sad::rendering::GLBackend::drawText(unsigned int, const std::function<void()>& render)
+{
+    if (render)
+    {
+        render();
+        this->stateCache()->invalidate();
+    }
+}
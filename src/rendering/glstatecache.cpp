@@ -0,0 +1,161 @@
+#include "rendering/glstatecache.h"
+
+#include "os/glheaders.h"
+
+sad::rendering::GLStateCache::GLStateCache()
+: m_issued_calls(0),
+m_avoided_calls(0),
+m_avoided_texture_binds(0),
+m_avoided_color_changes(0)
+{
+
+}
+
+sad::rendering::GLStateCache::~GLStateCache()
+{
+
+}
+
+void sad::rendering::GLStateCache::bindTexture(unsigned int id)
+{
+    if (m_texture.exists() && m_texture.value() == id)
+    {
+        ++m_avoided_calls;
+        ++m_avoided_texture_binds;
+        return;
+    }
+    glBindTexture(GL_TEXTURE_2D, id);
+    m_texture.setValue(id);
+    ++m_issued_calls;
+}
+
+void sad::rendering::GLStateCache::textureDeleted(unsigned int id)
+{
+    if (m_texture.exists() && m_texture.value() == id)
+    {
+        m_texture.setValue(0);
+    }
+}
+
+void sad::rendering::GLStateCache::setColor(const sad::AColor& color)
+{
+    if (m_color.exists())
+    {
+        const sad::AColor& c = m_color.value();
+        if (c.r() == color.r() && c.g() == color.g() && c.b() == color.b() && c.a() == color.a())
+        {
+            ++m_avoided_calls;
+            ++m_avoided_color_changes;
+            return;
+        }
+    }
+    glColor4ub(color.r(), color.g(), color.b(), color.a());
+    m_color.setValue(color);
+    ++m_issued_calls;
+}
+
+void sad::rendering::GLStateCache::forgetColor()
+{
+    m_color.clear();
+}
+
+void sad::rendering::GLStateCache::setBlendEnabled(bool enabled)
+{
+    this->setCapability(m_blend, GL_BLEND, enabled);
+}
+
+void sad::rendering::GLStateCache::setBlendFunction(unsigned int source, unsigned int destination)
+{
+    if (m_blend_source.exists() && m_blend_source.value() == source
+        && m_blend_destination.exists() && m_blend_destination.value() == destination)
+    {
+        ++m_avoided_calls;
+        return;
+    }
+    glBlendFunc(source, destination);
+    m_blend_source.setValue(source);
+    m_blend_destination.setValue(destination);
+    ++m_issued_calls;
+}
+
+void sad::rendering::GLStateCache::setTextureEnabled(bool enabled)
+{
+    this->setCapability(m_texture_2d, GL_TEXTURE_2D, enabled);
+}
+
+void sad::rendering::GLStateCache::setMatrixMode(unsigned int mode)
+{
+    if (m_matrix_mode.exists() && m_matrix_mode.value() == mode)
+    {
+        ++m_avoided_calls;
+        return;
+    }
+    glMatrixMode(mode);
+    m_matrix_mode.setValue(mode);
+    ++m_issued_calls;
+}
+
+const sad::Maybe<unsigned int>& sad::rendering::GLStateCache::matrixMode() const
+{
+    return m_matrix_mode;
+}
+
+void sad::rendering::GLStateCache::invalidate()
+{
+    m_texture.clear();
+    m_color.clear();
+    m_blend.clear();
+    m_blend_source.clear();
+    m_blend_destination.clear();
+    m_texture_2d.clear();
+    m_matrix_mode.clear();
+}
+
+unsigned int sad::rendering::GLStateCache::issuedCalls() const
+{
+    return m_issued_calls;
+}
+
+unsigned int sad::rendering::GLStateCache::avoidedCalls() const
+{
+    return m_avoided_calls;
+}
+
+unsigned int sad::rendering::GLStateCache::avoidedTextureBinds() const
+{
+    return m_avoided_texture_binds;
+}
+
+unsigned int sad::rendering::GLStateCache::avoidedColorChanges() const
+{
+    return m_avoided_color_changes;
+}
+
+void sad::rendering::GLStateCache::resetCounters()
+{
+    m_issued_calls = 0;
+    m_avoided_calls = 0;
+    m_avoided_texture_binds = 0;
+    m_avoided_color_changes = 0;
+}
+
+// ============================================================ PROTECTED METHODS ============================================================
+
+void sad::rendering::GLStateCache::setCapability(sad::Maybe<bool>& state, unsigned int capability, bool enabled)
+{
+    if (state.exists() && state.value() == enabled)
+    {
+        ++m_avoided_calls;
+        return;
+    }
+    if (enabled)
+    {
+        glEnable(capability);
+    }
+    else
+    {
+        glDisable(capability);
+    }
+    state.setValue(enabled);
+    ++m_issued_calls;
+}
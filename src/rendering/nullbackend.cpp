@@ -0,0 +1,172 @@
+#include "rendering/nullbackend.h"
+
+sad::rendering::NullBackend::NullBackend()
+: m_frame_count(0), m_keeps_history(false), m_texture(NULL), m_color_set(false)
+{
+
+}
+
+sad::rendering::NullBackend::~NullBackend()
+{
+
+}
+
+void sad::rendering::NullBackend::startFrame()
+{
+
+}
+
+void sad::rendering::NullBackend::finishFrame()
+{
+    m_total += m_frame;
+    m_last_frame = m_frame;
+    if (m_keeps_history)
+    {
+        m_frames << m_frame;
+    }
+    m_frame = sad::rendering::FrameStatistics();
+    ++m_frame_count;
+}
+
+void sad::rendering::NullBackend::setOrthographicProjection(double, double)
+{
+    ++(m_frame.Commands);
+    ++(m_frame.StateChanges);
+}
+
+void sad::rendering::NullBackend::pushMatrix()
+{
+    ++(m_frame.Commands);
+    ++(m_frame.StateChanges);
+}
+
+void sad::rendering::NullBackend::popMatrix()
+{
+    ++(m_frame.Commands);
+    ++(m_frame.StateChanges);
+}
+
+void sad::rendering::NullBackend::translate(double, double, double)
+{
+    ++(m_frame.Commands);
+    ++(m_frame.StateChanges);
+}
+
+void sad::rendering::NullBackend::rotate(double, double, double, double)
+{
+    ++(m_frame.Commands);
+    ++(m_frame.StateChanges);
+}
+
+void sad::rendering::NullBackend::drawSprite(
+    sad::Texture* texture,
+    const sad::Rect2D&,
+    const sad::Rect2D&,
+    const sad::AColor& color
+)
+{
+    ++(m_frame.Commands);
+    ++(m_frame.DrawCalls);
+    ++(m_frame.Quads);
+    this->setColor(color);
+    this->bindTexture(texture);
+}
+
+void sad::rendering::NullBackend::drawQuads(
+    sad::Texture* texture,
+    const float*,
+    const float*,
+    const unsigned char*,
+    unsigned int quads
+)
+{
+    ++(m_frame.Commands);
+    ++(m_frame.DrawCalls);
+    m_frame.Quads += quads;
+    this->bindTexture(texture);
+}
+
+void sad::rendering::NullBackend::drawLines(const sad::Point2D*, unsigned int count, const sad::AColor& color)
+{
+    ++(m_frame.Commands);
+    ++(m_frame.DrawCalls);
+    m_frame.Lines += count / 2;
+    this->setColor(color);
+}
+
+void sad::rendering::NullBackend::drawText(unsigned int characters, const std::function<void()>&)
+{
+    ++(m_frame.Commands);
+    ++(m_frame.DrawCalls);
+    m_frame.Characters += characters;
+    m_texture = NULL;
+}
+
+void sad::rendering::NullBackend::setKeepsHistory(bool keep)
+{
+    m_keeps_history = keep;
+}
+
+bool sad::rendering::NullBackend::keepsHistory() const
+{
+    return m_keeps_history;
+}
+
+const sad::Vector<sad::rendering::FrameStatistics>& sad::rendering::NullBackend::frames() const
+{
+    return m_frames;
+}
+
+unsigned int sad::rendering::NullBackend::frameCount() const
+{
+    return m_frame_count;
+}
+
+const sad::rendering::FrameStatistics& sad::rendering::NullBackend::lastFrame() const
+{
+    return m_last_frame;
+}
+
+sad::rendering::FrameStatistics sad::rendering::NullBackend::total() const
+{
+    sad::rendering::FrameStatistics result = m_total;
+    result += m_frame;
+    return result;
+}
+
+void sad::rendering::NullBackend::clear()
+{
+    m_frame = sad::rendering::FrameStatistics();
+    m_last_frame = sad::rendering::FrameStatistics();
+    m_total = sad::rendering::FrameStatistics();
+    m_frames.clear();
+    m_frame_count = 0;
+    m_texture = NULL;
+    m_color_set = false;
+}
+
+// ============================================================ PROTECTED METHODS ============================================================
+
+void sad::rendering::NullBackend::bindTexture(sad::Texture* texture)
+{
+    if (texture != m_texture)
+    {
+        ++(m_frame.TextureSwitches);
+        ++(m_frame.StateChanges);
+        m_texture = texture;
+    }
+}
+
+void sad::rendering::NullBackend::setColor(const sad::AColor& color)
+{
+    if (!m_color_set
+        || color.r() != m_color.r()
+        || color.g() != m_color.g()
+        || color.b() != m_color.b()
+        || color.a() != m_color.a())
+    {
+        ++(m_frame.StateChanges);
+        m_color = color;
+        m_color_set = true;
+    }
+}
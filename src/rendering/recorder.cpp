@@ -0,0 +1,148 @@
+#include "rendering/recorder.h"
+
+#include "texture.h"
+
+sad::rendering::Recorder::Recorder(sad::rendering::CommandBuffer* buffer, sad::rendering::Backend* target)
+: m_buffer(buffer), m_target(target)
+{
+
+}
+
+sad::rendering::Recorder::~Recorder()
+{
+
+}
+
+sad::rendering::CommandBuffer* sad::rendering::Recorder::buffer() const
+{
+    return m_buffer;
+}
+
+sad::rendering::Backend* sad::rendering::Recorder::target() const
+{
+    return m_target;
+}
+
+void sad::rendering::Recorder::startFrame()
+{
+    m_buffer->startFrame();
+    if (m_target)
+    {
+        m_target->startFrame();
+    }
+}
+
+void sad::rendering::Recorder::finishFrame()
+{
+    m_buffer->finishFrame();
+    if (m_target)
+    {
+        m_target->finishFrame();
+    }
+}
+
+void sad::rendering::Recorder::setOrthographicProjection(double width, double height)
+{
+    m_buffer->setOrthographicProjection(width, height);
+    if (m_target)
+    {
+        m_target->setOrthographicProjection(width, height);
+    }
+}
+
+void sad::rendering::Recorder::pushMatrix()
+{
+    m_buffer->pushMatrix();
+    if (m_target)
+    {
+        m_target->pushMatrix();
+    }
+}
+
+void sad::rendering::Recorder::popMatrix()
+{
+    m_buffer->popMatrix();
+    if (m_target)
+    {
+        m_target->popMatrix();
+    }
+}
+
+void sad::rendering::Recorder::translate(double x, double y, double z)
+{
+    m_buffer->translate(x, y, z);
+    if (m_target)
+    {
+        m_target->translate(x, y, z);
+    }
+}
+
+void sad::rendering::Recorder::rotate(double angle, double x, double y, double z)
+{
+    m_buffer->rotate(angle, x, y, z);
+    if (m_target)
+    {
+        m_target->rotate(angle, x, y, z);
+    }
+}
+
+void sad::rendering::Recorder::drawSprite(
+    sad::Texture* texture,
+    const sad::Rect2D& area,
+    const sad::Rect2D& texture_coordinates,
+    const sad::AColor& color
+)
+{
+    m_buffer->drawSprite(textureKey(texture), area, texture_coordinates, color);
+    if (m_target)
+    {
+        m_target->drawSprite(texture, area, texture_coordinates, color);
+    }
+}
+
+void sad::rendering::Recorder::drawQuads(
+    sad::Texture* texture,
+    const float* vertexes,
+    const float* texture_coordinates,
+    const unsigned char* colors,
+    unsigned int quads
+)
+{
+    m_buffer->drawQuads(textureKey(texture), vertexes, texture_coordinates, colors, quads);
+    if (m_target)
+    {
+        m_target->drawQuads(texture, vertexes, texture_coordinates, colors, quads);
+    }
+}
+
+void sad::rendering::Recorder::drawLines(const sad::Point2D* points, unsigned int count, const sad::AColor& color)
+{
+    m_buffer->drawLines(points, count, color);
+    if (m_target)
+    {
+        m_target->drawLines(points, count, color);
+    }
+}
+
+void sad::rendering::Recorder::drawText(unsigned int characters, const std::function<void()>& render)
+{
+    m_buffer->drawText(characters);
+    if (m_target)
+    {
+        m_target->drawText(characters, render);
+    }
+}
+
+// ============================================================ PROTECTED METHODS ============================================================
+
+unsigned int sad::rendering::Recorder::textureKey(sad::Texture* texture)
+{
+    if (m_textures.contains(texture))
+    {
+        return m_textures[texture];
+    }
+    unsigned int key = static_cast<unsigned int>(m_textures.size());
+    m_textures.insert(texture, key);
+    m_buffer->defineTexture(key, texture->width(), texture->height());
+    return key;
+}
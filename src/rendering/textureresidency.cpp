@@ -0,0 +1,205 @@
+#include "rendering/textureresidency.h"
+
+#include "texture.h"
+#include "sadscopedlock.h"
+#include "sadvector.h"
+#include "sadpair.h"
+
+#include <algorithm>
+
+sad::rendering::TextureResidency::TextureResidency()
+: m_budget(0),
+m_resident_bytes(0),
+m_frame(1),
+m_evictions(0),
+m_reuploads(0),
+m_evicting(false)
+{
+
+}
+
+sad::rendering::TextureResidency::~TextureResidency()
+{
+
+}
+
+void sad::rendering::TextureResidency::setBudget(size_t bytes)
+{
+    m_lock.lock();
+    m_budget = bytes;
+    m_lock.unlock();
+    this->enforceBudget();
+}
+
+size_t sad::rendering::TextureResidency::budget() const
+{
+    return m_budget;
+}
+
+void sad::rendering::TextureResidency::startFrame()
+{
+    sad::ScopedLock lock(&m_lock);
+    ++m_frame;
+}
+
+unsigned int sad::rendering::TextureResidency::frame() const
+{
+    return m_frame;
+}
+
+void sad::rendering::TextureResidency::textureUploaded(sad::Texture* texture)
+{
+    m_lock.lock();
+    if (m_evicted.contains(texture))
+    {
+        m_evicted.remove(texture);
+        ++m_reuploads;
+    }
+    if (m_resident.contains(texture))
+    {
+        m_resident_bytes -= m_resident[texture].Bytes;
+    }
+    sad::rendering::TextureResidency::Record record;
+    record.Bytes = texture->gpuMemorySize();
+    record.LastFrame = m_frame;
+    m_resident.insert(texture, record);
+    m_resident_bytes += record.Bytes;
+    m_lock.unlock();
+    this->enforceBudget();
+}
+
+void sad::rendering::TextureResidency::textureBound(sad::Texture* texture)
+{
+    sad::ScopedLock lock(&m_lock);
+    std::unordered_map<sad::Texture*, sad::rendering::TextureResidency::Record>::iterator it = m_resident.find(texture);
+    if (it != m_resident.end())
+    {
+        it->second.LastFrame = m_frame;
+    }
+}
+
+void sad::rendering::TextureResidency::textureUnloaded(sad::Texture* texture)
+{
+    sad::ScopedLock lock(&m_lock);
+    if (m_resident.contains(texture))
+    {
+        m_resident_bytes -= m_resident[texture].Bytes;
+        m_resident.remove(texture);
+        if (m_evicting)
+        {
+            m_evicted.insert(texture, true);
+        }
+    }
+}
+
+void sad::rendering::TextureResidency::textureDestroyed(sad::Texture* texture)
+{
+    sad::ScopedLock lock(&m_lock);
+    if (m_resident.contains(texture))
+    {
+        m_resident_bytes -= m_resident[texture].Bytes;
+        m_resident.remove(texture);
+    }
+    m_evicted.remove(texture);
+}
+
+bool sad::rendering::TextureResidency::isResident(sad::Texture* texture) const
+{
+    sad::ScopedLock lock(&m_lock);
+    return m_resident.contains(texture);
+}
+
+unsigned int sad::rendering::TextureResidency::lastBoundFrame(sad::Texture* texture) const
+{
+    sad::ScopedLock lock(&m_lock);
+    if (m_resident.contains(texture))
+    {
+        return m_resident[texture].LastFrame;
+    }
+    return 0;
+}
+
+size_t sad::rendering::TextureResidency::residentBytes() const
+{
+    return m_resident_bytes;
+}
+
+size_t sad::rendering::TextureResidency::residentTextures() const
+{
+    sad::ScopedLock lock(&m_lock);
+    return m_resident.count();
+}
+
+unsigned int sad::rendering::TextureResidency::evictions() const
+{
+    return m_evictions;
+}
+
+unsigned int sad::rendering::TextureResidency::reuploads() const
+{
+    return m_reuploads;
+}
+
+void sad::rendering::TextureResidency::resetStatistics()
+{
+    sad::ScopedLock lock(&m_lock);
+    m_evictions = 0;
+    m_reuploads = 0;
+}
+
+// ============================================================ PROTECTED METHODS ============================================================
+
+/*! Compares textures by frame, when they were bound last time
+    \param[in] a first texture
+    \param[in] b second texture
+    \return whether first texture was bound earlier
+ */
+static bool is_texture_bound_earlier(
+    const sad::Pair<unsigned int, sad::Texture*>& a,
+    const sad::Pair<unsigned int, sad::Texture*>& b
+)
+{
+    return a.p1() < b.p1();
+}
+
+void sad::rendering::TextureResidency::enforceBudget()
+{
+    sad::Vector<sad::Pair<unsigned int, sad::Texture*> > candidates;
+    m_lock.lock();
+    if (m_budget == 0 || m_resident_bytes <= m_budget || m_evicting)
+    {
+        m_lock.unlock();
+        return;
+    }
+    for(sad::Hash<sad::Texture*, sad::rendering::TextureResidency::Record>::const_iterator it = m_resident.const_begin();
+        it != m_resident.const_end();
+        ++it)
+    {
+        // Textures, used in current frame, are likely to be used again
+        if (it.value().LastFrame != m_frame)
+        {
+            candidates << sad::Pair<unsigned int, sad::Texture*>(it.value().LastFrame, it.key());
+        }
+    }
+    m_evicting = true;
+    m_lock.unlock();
+
+    std::sort(candidates.begin(), candidates.end(), is_texture_bound_earlier);
+    // Textures are unloaded without lock, since they notify manager about it
+    for(size_t i = 0; i < candidates.size(); i++)
+    {
+        m_lock.lock();
+        bool exceeded = m_resident_bytes > m_budget;
+        m_lock.unlock();
+        if (!exceeded)
+        {
+            break;
+        }
+        candidates[i].p2()->unloadFromGPU();
+        ++m_evictions;
+    }
+
+    m_lock.lock();
+    m_evicting = false;
+    m_lock.unlock();
+}
@@ -0,0 +1,422 @@
+#include "resource/asyncloading.h"
+#include "resource/tree.h"
+#include "resource/resourcefile.h"
+
+#include "sadworkerpool.h"
+#include "pipeline/pipeline.h"
+
+#include "3rdparty/picojson/valuetotype.h"
+
+#include "util/free.h"
+
+#include "renderer.h"
+#include "texture.h"
+#include "sadscopedlock.h"
+
+#include <algorithm>
+#include <thread>
+
+// ============================ sad::resource::AsyncLoading::PipelineStep ============================
+
+sad::resource::AsyncLoading::PipelineStep::PipelineStep(sad::resource::AsyncLoading* loading)
+: m_loading(loading), m_finished(false)
+{
+    m_loading->addRef();
+}
+
+sad::resource::AsyncLoading::PipelineStep::~PipelineStep()
+{
+    m_loading->delRef();
+}
+
+bool sad::resource::AsyncLoading::PipelineStep::shouldBeDestroyedAfterProcessing()
+{
+    return m_finished;
+}
+
+void sad::resource::AsyncLoading::PipelineStep::_process()
+{
+    m_finished = m_loading->update();
+}
+
+// ============================ sad::resource::AsyncLoading ============================
+
+sad::resource::AsyncLoading::AsyncLoading(sad::resource::Tree* tree)
+: m_tree(tree),
+m_new_root(NULL),
+m_uploaded(0),
+m_uploads_per_frame(0),
+m_thread_count(1),
+m_thread(NULL),
+m_decoded(0),
+m_decoding_finished(false),
+m_cancelled(false),
+m_failed(false),
+m_committed(false)
+{
+
+}
+
+sad::resource::AsyncLoading::~AsyncLoading()
+{
+    m_cancelled = true;
+    if (m_thread)
+    {
+        m_thread->wait();
+        delete m_thread;
+    }
+    delete m_new_root;
+    sad::util::free(m_new_files);
+    for(size_t i = 0; i < m_entries.size(); i++)
+    {
+        delete m_entries[i]->Folder;
+        sad::util::free(m_entries[i]->Files);
+        sad::util::free(m_entries[i]->Errors);
+        delete m_entries[i];
+    }
+    sad::util::free(m_errors);
+}
+
+void sad::resource::AsyncLoading::start(const sad::String& string, size_t threads)
+{
+    m_temporary_root = m_tree->m_temporary_root;
+    if (threads == 0)
+    {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    m_thread_count = threads;
+
+    // Resource list is parsed on calling thread, like in sad::resource::Tree::loadFromString
+    if (string.consistsOfWhitespaceCharacters() == false)
+    {
+        picojson::value v = picojson::parse_string(string);
+        if (picojson::get_last_error().size() == 0 && v.is<picojson::array>())
+        {
+            picojson::array & resourcelist = v.get<picojson::array>();
+            for(size_t i = 0 ; i < resourcelist.size() && m_errors.size() == 0; i++)
+            {
+                sad::Maybe<sad::String>  maybetype = picojson::to_type<sad::String>(
+                    picojson::get_property(resourcelist[i], "type")
+                );
+                sad::Maybe<sad::String>  maybename = picojson::to_type<sad::String>(
+                    picojson::get_property(resourcelist[i], "filename")
+                );
+                if (maybetype.exists() && maybename.exists())
+                {
+                    sad::resource::AsyncLoading::Entry* entry = new sad::resource::AsyncLoading::Entry();
+                    entry->Type = maybetype.value();
+                    entry->FileName = maybename.value();
+                    entry->ResourceName = picojson::to_type<sad::String>(
+                        picojson::get_property(resourcelist[i], "name")
+                    );
+                    entry->Description = resourcelist[i];
+                    sad::resource::ResourceFile* file = m_tree->factory()->fileByType(entry->Type);
+                    entry->Parallel = (file == NULL) || file->supportsParallelLoading();
+                    delete file;
+                    entry->Decoded = false;
+                    entry->Folder = new sad::resource::Folder();
+                    m_entries << entry;
+                }
+                else
+                {
+                    m_errors << new sad::resource::MalformedResourceEntry(resourcelist[i]);
+                }
+            }
+        }
+        else
+        {
+            if (picojson::get_last_error().size() == 0)
+            {
+                m_errors << new  sad::resource::MalformedResourceEntry(v);
+            }
+            else
+            {
+                m_errors << new sad::resource::JSONParseError();
+            }
+        }
+    }
+
+    if (m_errors.size() == 0 && m_entries.size() != 0)
+    {
+        m_new_root = new sad::resource::Folder();
+        m_thread = new sad::Thread(this, &sad::resource::AsyncLoading::decode);
+        m_thread->run();
+    }
+    else
+    {
+        m_decoding_finished = true;
+    }
+    this->appendToPipeline();
+}
+
+void sad::resource::AsyncLoading::fail(sad::resource::Error* error)
+{
+    m_errors << error;
+    m_decoding_finished = true;
+    this->appendToPipeline();
+}
+
+sad::resource::Tree* sad::resource::AsyncLoading::tree() const
+{
+    return m_tree;
+}
+
+size_t sad::resource::AsyncLoading::total() const
+{
+    return m_entries.size();
+}
+
+size_t sad::resource::AsyncLoading::decoded() const
+{
+    return m_decoded.load();
+}
+
+double sad::resource::AsyncLoading::progress() const
+{
+    if (this->finished())
+    {
+        return 1.0;
+    }
+    size_t units = m_entries.size() + m_uploads.size();
+    if (units == 0)
+    {
+        return 0.0;
+    }
+    size_t done = std::min(m_decoded.load(), m_entries.size()) + m_uploaded;
+    return static_cast<double>(done) / units;
+}
+
+bool sad::resource::AsyncLoading::decodingFinished() const
+{
+    return m_decoding_finished.load();
+}
+
+bool sad::resource::AsyncLoading::committed() const
+{
+    return m_committed;
+}
+
+bool sad::resource::AsyncLoading::finished() const
+{
+    return m_committed && m_uploaded == m_uploads.size();
+}
+
+size_t sad::resource::AsyncLoading::pendingUploads() const
+{
+    return m_uploads.size() - m_uploaded;
+}
+
+void sad::resource::AsyncLoading::setUploadsPerFrame(size_t count)
+{
+    m_uploads_per_frame = count;
+}
+
+size_t sad::resource::AsyncLoading::uploadsPerFrame() const
+{
+    return m_uploads_per_frame;
+}
+
+void sad::resource::AsyncLoading::cancel()
+{
+    m_cancelled = true;
+}
+
+bool sad::resource::AsyncLoading::cancelled() const
+{
+    return m_cancelled.load();
+}
+
+const sad::Vector<sad::resource::Error*>& sad::resource::AsyncLoading::wait()
+{
+    if (m_thread)
+    {
+        m_thread->wait();
+    }
+    this->commit();
+    return m_errors;
+}
+
+const sad::Vector<sad::resource::Error*>& sad::resource::AsyncLoading::errors() const
+{
+    return m_errors;
+}
+
+bool sad::resource::AsyncLoading::update()
+{
+    if (m_decoding_finished.load() == false)
+    {
+        return false;
+    }
+    this->commit();
+    this->upload();
+    return this->finished();
+}
+
+void sad::resource::AsyncLoading::appendToPipeline()
+{
+    sad::Renderer* renderer = m_tree->renderer();
+    if (renderer)
+    {
+        renderer->pipeline()->append(new sad::resource::AsyncLoading::PipelineStep(this));
+    }
+}
+
+void sad::resource::AsyncLoading::decode()
+{
+    sad::Vector<size_t> parallel;
+    for(size_t i = 0; i < m_entries.size(); i++)
+    {
+        if (m_entries[i]->Parallel)
+        {
+            parallel << i;
+        }
+    }
+    {
+        sad::WorkerPool pool(std::min(m_thread_count, std::max(parallel.size(), static_cast<size_t>(1))));
+        pool.run(parallel.size(), [this, &parallel](size_t i) { this->decodeEntry(parallel[i]); });
+    }
+
+    // Merge decoded entries in order of resource list, so errors are the same as in synchronous loading
+    for(size_t i = 0; i < m_entries.size() && m_errors.size() == 0; i++)
+    {
+        sad::resource::AsyncLoading::Entry* entry = m_entries[i];
+        if (entry->Parallel == false && m_cancelled.load() == false)
+        {
+            // A file depends on resources of previous ones, so it's loaded into merged folder
+            m_tree->m_temporary_root_folder = m_new_root;
+            m_errors << m_tree->load(
+                entry->Type,
+                entry->FileName,
+                entry->ResourceName,
+                m_new_root,
+                entry->Description,
+                m_new_files
+            );
+            m_tree->m_temporary_root_folder = NULL;
+            entry->Decoded = true;
+            ++m_decoded;
+            continue;
+        }
+
+        if (entry->Decoded == false)
+        {
+            if (m_cancelled.load())
+            {
+                m_errors << new sad::resource::LoadingCancelled();
+            }
+            else
+            {
+                // Entry was skipped, because some of next entries failed
+                for(size_t j = i; j < m_entries.size(); j++)
+                {
+                    m_errors << m_entries[j]->Errors;
+                    m_entries[j]->Errors.clear();
+                }
+            }
+            break;
+        }
+
+        m_errors << entry->Errors;
+        entry->Errors.clear();
+        if (m_errors.size() == 0)
+        {
+            sad::resource::ResourceEntryList list = entry->Folder->copyAndClear();
+            m_errors << m_tree->duplicatesToErrors(m_new_root->duplicatesBetween(list));
+            if (m_errors.size() == 0)
+            {
+                m_new_root->addResources(list, false);
+                m_new_files << entry->Files;
+                entry->Files.clear();
+            }
+            else
+            {
+                sad::resource::free(list);
+            }
+        }
+    }
+    m_decoding_finished = true;
+}
+
+void sad::resource::AsyncLoading::decodeEntry(size_t index)
+{
+    sad::resource::AsyncLoading::Entry* entry = m_entries[index];
+    if (m_failed.load() == false && m_cancelled.load() == false)
+    {
+        entry->Errors << m_tree->load(
+            entry->Type,
+            entry->FileName,
+            entry->ResourceName,
+            entry->Folder,
+            entry->Description,
+            entry->Files
+        );
+        entry->Decoded = true;
+        if (entry->Errors.size())
+        {
+            m_failed = true;
+        }
+    }
+    ++m_decoded;
+}
+
+void sad::resource::AsyncLoading::commit()
+{
+    sad::ScopedLock lock(&m_commit_lock);
+    if (m_committed)
+    {
+        return;
+    }
+    if (m_errors.size() == 0 && m_new_root != NULL)
+    {
+        sad::resource::ResourceEntryList list = m_new_root->copyAndClear();
+        m_errors << m_tree->duplicatesToErrors(m_tree->root()->duplicatesBetween(list));
+        if (m_errors.size() == 0)
+        {
+            m_tree->packTextures(m_new_files);
+            m_tree->root()->addResources(list, false);
+            m_tree->m_files << m_new_files;
+            // Textures are uploaded later, so loading won't stall a frame
+            for(size_t i = 0; i < m_new_files.size(); i++)
+            {
+                sad::Vector<sad::resource::Resource*> resources = m_new_files[i]->resources();
+                for(size_t j = 0; j < resources.size(); j++)
+                {
+                    if (resources[j]->metaData()->canBeCastedTo("sad::Texture"))
+                    {
+                        m_uploads << static_cast<sad::Texture*>(resources[j]);
+                    }
+                }
+            }
+            m_new_files.clear();
+        }
+        else
+        {
+            sad::resource::free(list);
+        }
+    }
+    if (m_errors.size() == 0)
+    {
+        m_tree->m_current_root = m_temporary_root;
+    }
+    delete m_new_root;
+    m_new_root = NULL;
+    sad::util::free(m_new_files);
+    m_new_files.clear();
+    m_committed = true;
+}
+
+void sad::resource::AsyncLoading::upload()
+{
+    size_t count = 0;
+    while(m_uploaded < m_uploads.size() && (m_uploads_per_frame == 0 || count < m_uploads_per_frame))
+    {
+        // Textures, placed in atlas, are uploaded with their page
+        sad::Texture* texture = m_uploads[m_uploaded]->boundTexture();
+        ++m_uploaded;
+        if (texture->OnGPU == false)
+        {
+            texture->upload();
+            ++count;
+        }
+    }
+}
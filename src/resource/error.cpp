@@ -17,6 +17,7 @@ DECLARE_SOBJ_INHERITANCE(sad::resource::MalformedResourceEntry, sad::resource::E
 DECLARE_SOBJ_INHERITANCE(sad::resource::EmptyTextureAtlas, sad::resource::Error);
 DECLARE_SOBJ_INHERITANCE(sad::resource::TreeNotFound, sad::resource::Error);
 DECLARE_SOBJ_INHERITANCE(sad::resource::ResourceCannotBeLoadedFromArchive, sad::resource::Error);
+DECLARE_SOBJ_INHERITANCE(sad::resource::LoadingCancelled, sad::resource::Error);
 
 sad::resource::Error::~Error() throw()
 {
@@ -93,6 +94,11 @@ sad::resource::ResourceCannotBeLoadedFromArchive::~ResourceCannotBeLoadedFromArc
 
 }
 
+sad::resource::LoadingCancelled::~LoadingCancelled() throw()
+{
+
+}
+
 
 sad::String sad::resource::format(
     const sad::Vector<sad::resource::Error *> & errors,
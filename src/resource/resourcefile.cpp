@@ -227,6 +227,11 @@ bool sad::resource::ResourceFile::supportsLoadingFromTar7z() const
     return false;
 }
 
+bool sad::resource::ResourceFile::supportsParallelLoading() const
+{
+    return true;
+}
+
 
 sad::Maybe<sad::String> sad::resource::ResourceFile::tryReadToString(bool force_reload) const
 {
@@ -0,0 +1,244 @@
+#include "resource/textureatlaspacker.h"
+
+#include "texture.h"
+
+#include "3rdparty/framepacker/framepacker.hpp"
+
+#include <cstring>
+#include <sstream>
+
+/*! An image for framepacker, which stores only size of packed texture
+ */
+class SadResourceTextureAtlasImage
+{
+public:
+    /*! Creates new image
+        \param[in] texture a texture
+     */
+    SadResourceTextureAtlasImage(sad::Texture* texture = NULL) : Texture(texture), Width(0), Height(0)
+    {
+        if (texture)
+        {
+            Width = static_cast<int>(texture->width());
+            Height = static_cast<int>(texture->height());
+        }
+    }
+    /*! Returns width of image
+        \return width
+     */
+    int width() const
+    {
+        return Width;
+    }
+    /*! Returns height of image
+        \return height
+     */
+    int height() const
+    {
+        return Height;
+    }
+    /*! Sets size of resulting image
+        \param[in] w width
+        \param[in] h height
+     */
+    void resize(int w, int h)
+    {
+        Width = w;
+        Height = h;
+    }
+    /*! Pixels are copied after packing, so does nothing
+        \return 0
+     */
+    int pixel(int, int)
+    {
+        return 0;
+    }
+    /*! Pixels are copied after packing, so does nothing
+     */
+    void pixel(int, int, int)
+    {
+    }
+    /*! Textures are not trimmed
+        \return false
+     */
+    bool is_transparent(int, int)
+    {
+        return false;
+    }
+    /*! Pixels are copied after packing, so does nothing
+     */
+    void copy_from(const SadResourceTextureAtlasImage&, int, int, int, int, int, int)
+    {
+    }
+
+    /*! A packed texture
+     */
+    sad::Texture* Texture;
+    /*! A width of image
+     */
+    int Width;
+    /*! A height of image
+     */
+    int Height;
+};
+
+typedef framepacker::packer<SadResourceTextureAtlasImage, false, false> SadResourceTextureAtlasPackerType;
+
+sad::resource::TextureAtlasPacker::TextureAtlasPacker(unsigned int page_size, unsigned int padding)
+: m_page_size(page_size), m_padding(padding)
+{
+
+}
+
+sad::resource::TextureAtlasPacker::~TextureAtlasPacker()
+{
+
+}
+
+unsigned int sad::resource::TextureAtlasPacker::pageSize() const
+{
+    return m_page_size;
+}
+
+unsigned int sad::resource::TextureAtlasPacker::padding() const
+{
+    return m_padding;
+}
+
+bool sad::resource::TextureAtlasPacker::canBePacked(sad::Texture* texture) const
+{
+    if (!texture)
+    {
+        return false;
+    }
+    return texture->atlasPage() == NULL
+        && texture->Format == sad::Texture::SFT_R8_G8_B8_A8
+        && (texture->Bpp == 32 || texture->Bpp == 24)
+        && texture->Width != 0
+        && texture->Height != 0
+        && texture->Width + 2 * m_padding <= m_page_size
+        && texture->Height + 2 * m_padding <= m_page_size;
+}
+
+sad::Vector<sad::Texture*> sad::resource::TextureAtlasPacker::pack(const sad::Vector<sad::Texture*>& textures) const
+{
+    sad::Vector<sad::Texture*> packable;
+    for(size_t i = 0; i < textures.size(); i++)
+    {
+        if (this->canBePacked(textures[i]) && std::find(packable.begin(), packable.end(), textures[i]) == packable.end())
+        {
+            packable << textures[i];
+        }
+    }
+    sad::Vector<sad::Texture*> pages;
+    // A single texture gains nothing from atlas
+    if (packable.size() > 1)
+    {
+        this->packGroup(packable, pages);
+    }
+    return pages;
+}
+
+// ============================================================ PROTECTED METHODS ============================================================
+
+void sad::resource::TextureAtlasPacker::packGroup(const sad::Vector<sad::Texture*>& textures, sad::Vector<sad::Texture*>& pages) const
+{
+    if (textures.size() < 2)
+    {
+        return;
+    }
+    SadResourceTextureAtlasPackerType packer;
+    packer.padding = static_cast<int>(m_padding);
+    packer.alpha_trim = false;
+    packer.allow_rotate = false;
+    packer.power_of_2 = true;
+    packer.comparer = SadResourceTextureAtlasPackerType::compare_area;
+    for(size_t i = 0; i < textures.size(); i++)
+    {
+        std::ostringstream name;
+        name << i;
+        packer.add(name.str(), SadResourceTextureAtlasPackerType::texture_type(new SadResourceTextureAtlasImage(textures[i])));
+    }
+
+    SadResourceTextureAtlasPackerType::texture_type result(new SadResourceTextureAtlasImage());
+    SadResourceTextureAtlasPackerType::texture_coll_type packed, failed;
+    packer.pack(result, packed, failed);
+
+    unsigned int size = static_cast<unsigned int>(std::max(result->width(), result->height()));
+    if (failed.size() != 0 || size > m_page_size)
+    {
+        // Split group in halves, sorted by area, so both of them would contain large and small textures
+        sad::Vector<sad::Texture*> sorted = textures;
+        std::sort(sorted.begin(), sorted.end(), [](sad::Texture* a, sad::Texture* b) {
+            return a->Width * a->Height > b->Width * b->Height;
+        });
+        sad::Vector<sad::Texture*> first, second;
+        for(size_t i = 0; i < sorted.size(); i++)
+        {
+            ((i % 2 == 0) ? first : second) << sorted[i];
+        }
+        this->packGroup(first, pages);
+        this->packGroup(second, pages);
+        return;
+    }
+
+    sad::Texture* page = new sad::Texture();
+    page->Width = size;
+    page->Height = size;
+    page->Bpp = 32;
+    page->Format = sad::Texture::SFT_R8_G8_B8_A8;
+    // Mip-maps would mix neighbouring textures
+    page->BuildMipMaps = false;
+    page->setRenderer(textures[0]->renderer());
+    static_cast<sad::Texture::DefaultBuffer*>(page->Buffer)->Data.resize(size * size * 4, 0);
+
+    for(SadResourceTextureAtlasPackerType::texture_coll_type::iterator it = packed.begin(); it != packed.end(); ++it)
+    {
+        const SadResourceTextureAtlasPackerType::block_type& block = it->second;
+        unsigned int x = static_cast<unsigned int>(block.fit->min_x()) + m_padding;
+        unsigned int y = static_cast<unsigned int>(block.fit->min_y()) + m_padding;
+        sad::Texture* texture = block.texture->Texture;
+        this->copy(texture, page, x, y);
+        texture->placeInAtlas(page, x, y);
+    }
+    pages << page;
+}
+
+void sad::resource::TextureAtlasPacker::copy(sad::Texture* texture, sad::Texture* page, unsigned int x, unsigned int y) const
+{
+    unsigned int bytes = texture->Bpp / 8;
+    for(unsigned int row = 0; row < texture->Height; row++)
+    {
+        const sad::uchar* source = texture->pixel(row, 0);
+        sad::uchar* destination = page->pixel(row + y, x);
+        if (bytes == 4)
+        {
+            memcpy(destination, source, texture->Width * 4);
+        }
+        else
+        {
+            for(unsigned int column = 0; column < texture->Width; column++)
+            {
+                destination[column * 4] = source[column * bytes];
+                destination[column * 4 + 1] = source[column * bytes + 1];
+                destination[column * 4 + 2] = source[column * bytes + 2];
+                destination[column * 4 + 3] = 255;
+            }
+        }
+    }
+    // Extrude edges into padding, so filtering won't mix texture with neighbours
+    for(unsigned int p = 1; p <= m_padding; p++)
+    {
+        for(unsigned int row = 0; row < texture->Height; row++)
+        {
+            memcpy(page->pixel(row + y, x - p), page->pixel(row + y, x), 4);
+            memcpy(page->pixel(row + y, x + texture->Width - 1 + p), page->pixel(row + y, x + texture->Width - 1), 4);
+        }
+    }
+    size_t row_size = (texture->Width + 2 * m_padding) * 4;
+    for(unsigned int p = 1; p <= m_padding; p++)
+    {
+        memcpy(page->pixel(y - p, x - m_padding), page->pixel(y, x - m_padding), row_size);
+        memcpy(page->pixel(y + texture->Height - 1 + p, x - m_padding), page->pixel(y + texture->Height - 1, x - m_padding), row_size);
+    }
+}
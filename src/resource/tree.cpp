@@ -1,5 +1,7 @@
 #include "resource/tree.h"
 #include "resource/resourcefile.h"
+#include "resource/asyncloading.h"
+#include "resource/textureatlaspacker.h"
 
 #include "renderer.h"
 
@@ -9,6 +11,8 @@
 #include "util/free.h"
 #include "util/fs.h"
 
+#include "sadscopedlock.h"
+
 #define TAR7Z_SADDY
 
 #include "3rdparty/tar7z/include/tar.h"
@@ -22,7 +26,10 @@ m_renderer(r),
 m_root(new sad::resource::Folder()), 
 m_factory(new sad::resource::Factory()),
 m_storelinks(false),
-m_temporary_root_folder(NULL)
+m_temporary_root_folder(NULL),
+m_texture_atlas_enabled(false),
+m_texture_atlas_threshold(128),
+m_texture_atlas_page_size(1024)
 {
     if (r == NULL)
     {
@@ -34,6 +41,11 @@ sad::resource::Tree::~Tree()
 {
     delete m_root;
     delete m_factory;
+    // Pages are freed after textures, placed in them
+    for(size_t i = 0; i < m_texture_atlas_pages.size(); i++)
+    {
+        delete m_texture_atlas_pages[i];
+    }
     for(size_t i = 0; i < m_archive_list.size(); i++)
     {
         delete m_archive_list[i];
@@ -99,6 +111,7 @@ sad::Vector<sad::resource::Error*> sad::resource::Tree::loadFromString(const sad
             errors << this->duplicatesToErrors(m_root->duplicatesBetween(list));
             if (errors.size() == 0)
             {
+                this->packTextures(newfiles);
                 m_root->addResources(list, false);
                 m_files << newfiles;
                 delete newroot;
@@ -142,39 +155,10 @@ sad::Maybe<sad::String> sad::resource::Tree::tryLoadFromString(const sad::String
 
 sad::Vector<sad::resource::Error*> sad::resource::Tree::loadFromFile(const sad::String& string)
 {
-    std::ifstream stream(string.c_str());
-    if (sad::util::isAbsolutePath(string))
-    {
-        m_temporary_root = sad::util::folder(string);
-    } 
-    else
+    sad::Maybe<sad::String> data = this->readFile(string);
+    if (data.exists())
     {
-        m_temporary_root = "";
-    }
-    if (stream.good())
-    {
-        std::string alldata(
-            (std::istreambuf_iterator<char>(stream)), 
-            std::istreambuf_iterator<char>()
-        );
-        return loadFromString(alldata);
-    }
-    else
-    {
-        if (util::isAbsolutePath(string) == false)
-        {
-            sad::String path = util::concatPaths(m_renderer->executablePath(), string);
-            stream.clear();
-            stream.open(path.c_str());
-            if (stream.good())
-            {
-                std::string alldata(
-                    (std::istreambuf_iterator<char>(stream)), 
-                     std::istreambuf_iterator<char>()
-                    );
-                return loadFromString(alldata);
-            }
-        }
+        return loadFromString(data.value());
     }
     sad::Vector<sad::resource::Error*> result;
     result << new sad::resource::FileLoadError(string);
@@ -186,6 +170,25 @@ sad::Maybe<sad::String> sad::resource::Tree::tryLoadFromFile(const sad::String &
     return sad::resource::errorsToString(this->loadFromFile(string));
 }
 
+sad::resource::AsyncLoading* sad::resource::Tree::loadFromStringAsync(const sad::String & string, size_t threads)
+{
+    sad::resource::AsyncLoading* loading = new sad::resource::AsyncLoading(this);
+    loading->start(string, threads);
+    return loading;
+}
+
+sad::resource::AsyncLoading* sad::resource::Tree::loadFromFileAsync(const sad::String & string, size_t threads)
+{
+    sad::Maybe<sad::String> data = this->readFile(string);
+    if (data.exists())
+    {
+        return loadFromStringAsync(data.value(), threads);
+    }
+    sad::resource::AsyncLoading* loading = new sad::resource::AsyncLoading(this);
+    loading->fail(new sad::resource::FileLoadError(string));
+    return loading;
+}
+
 
 sad::Vector<sad::resource::Error*> sad::resource::Tree::load(
         const sad::String& typehint, 
@@ -193,14 +196,18 @@ sad::Vector<sad::resource::Error*> sad::resource::Tree::load(
         const sad::Maybe<sad::String>& resourcename
 )
 {
-    return load(
+    sad::Vector<sad::resource::ResourceFile *> newfiles;
+    sad::Vector<sad::resource::Error*> errors = load(
         typehint, 
         filename, 
         resourcename, 
         m_root, 
         picojson::value(picojson::null_type, false), 
-        m_files
+        newfiles
     );
+    this->packTextures(newfiles);
+    m_files << newfiles;
+    return errors;
 }
 
 sad::Vector<sad::resource::Error*> sad::resource::Tree::load(
@@ -486,10 +493,50 @@ sad::resource::Folder * sad::resource::Tree::temporaryRoot() const
 void sad::resource::Tree::unloadResourcesFromGPU()
 {
     this->root()->unloadResourcesFromGPU();
+    for(size_t i = 0; i < m_texture_atlas_pages.size(); i++)
+    {
+        m_texture_atlas_pages[i]->unloadFromGPU();
+    }
+}
+
+void sad::resource::Tree::setTextureAtlasEnabled(bool enabled)
+{
+    m_texture_atlas_enabled = enabled;
+}
+
+bool sad::resource::Tree::textureAtlasEnabled() const
+{
+    return m_texture_atlas_enabled;
+}
+
+void sad::resource::Tree::setTextureAtlasThreshold(unsigned int threshold)
+{
+    m_texture_atlas_threshold = threshold;
+}
+
+unsigned int sad::resource::Tree::textureAtlasThreshold() const
+{
+    return m_texture_atlas_threshold;
+}
+
+void sad::resource::Tree::setTextureAtlasPageSize(unsigned int size)
+{
+    m_texture_atlas_page_size = size;
+}
+
+unsigned int sad::resource::Tree::textureAtlasPageSize() const
+{
+    return m_texture_atlas_page_size;
+}
+
+const sad::Vector<sad::Texture*>& sad::resource::Tree::textureAtlasPages() const
+{
+    return m_texture_atlas_pages;
 }
 
 tar7z::Entry* sad::resource::Tree::archiveEntry(const sad::String& archive, const sad::String filename, bool loadnew)
 {
+    sad::ScopedLock lock(&m_archives_lock);
     if (m_archives.contains(archive) && !loadnew)
     {
         return m_archive_list[m_archives[archive]]->file(filename);
@@ -532,5 +579,59 @@ tar7z::Entry* sad::resource::Tree::archiveEntry(const sad::String& archive, cons
     return NULL;    
 }
 
+sad::Maybe<sad::String> sad::resource::Tree::readFile(const sad::String& string)
+{
+    std::ifstream stream(string.c_str());
+    if (sad::util::isAbsolutePath(string))
+    {
+        m_temporary_root = sad::util::folder(string);
+    } 
+    else
+    {
+        m_temporary_root = "";
+    }
+    if (stream.good() == false && util::isAbsolutePath(string) == false)
+    {
+        sad::String path = util::concatPaths(m_renderer->executablePath(), string);
+        stream.clear();
+        stream.open(path.c_str());
+    }
+    if (stream.good())
+    {
+        std::string alldata(
+            (std::istreambuf_iterator<char>(stream)), 
+            std::istreambuf_iterator<char>()
+        );
+        return sad::Maybe<sad::String>(alldata);
+    }
+    return sad::Maybe<sad::String>();
+}
 
 DECLARE_COMMON_TYPE(sad::resource::Tree)
+
+void sad::resource::Tree::packTextures(const sad::Vector<sad::resource::ResourceFile*>& files)
+{
+    if (!m_texture_atlas_enabled)
+    {
+        return;
+    }
+    sad::Vector<sad::Texture*> textures;
+    for(size_t i = 0; i < files.size(); i++)
+    {
+        sad::Vector<sad::resource::Resource*> resources = files[i]->resources();
+        for(size_t j = 0; j < resources.size(); j++)
+        {
+            // Inherited textures could generate own pixels, so only plain textures are packed
+            if (resources[j]->metaData()->name() == "sad::Texture")
+            {
+                sad::Texture* texture = static_cast<sad::Texture*>(resources[j]);
+                if (texture->width() <= m_texture_atlas_threshold && texture->height() <= m_texture_atlas_threshold)
+                {
+                    textures << texture;
+                }
+            }
+        }
+    }
+    sad::resource::TextureAtlasPacker packer(m_texture_atlas_page_size);
+    m_texture_atlas_pages << packer.pack(textures);
+}
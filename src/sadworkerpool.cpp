@@ -0,0 +1,87 @@
+#include "sadworkerpool.h"
+
+#include <algorithm>
+
+
+sad::WorkerPool::WorkerPool(size_t threads)
+: m_function(NULL), m_tasks(0), m_next_task(0), m_stopping(false)
+{
+    for(size_t i = 1; i < threads; i++)
+    {
+        m_start << new sad::Semaphore(0, 1);
+    }
+    for(size_t i = 1; i < threads; i++)
+    {
+        sad::Thread* thread = new sad::Thread(this, &sad::WorkerPool::workerLoop, i - 1);
+        thread->run();
+        m_threads << thread;
+    }
+}
+
+sad::WorkerPool::~WorkerPool()
+{
+    m_stopping = true;
+    for(size_t i = 0; i < m_start.size(); i++)
+    {
+        m_start[i]->release(1);
+    }
+    for(size_t i = 0; i < m_threads.size(); i++)
+    {
+        m_threads[i]->wait();
+        delete m_threads[i];
+    }
+    for(size_t i = 0; i < m_start.size(); i++)
+    {
+        delete m_start[i];
+    }
+}
+
+size_t sad::WorkerPool::threadCount() const
+{
+    return m_threads.size() + 1;
+}
+
+void sad::WorkerPool::run(size_t tasks, const std::function<void(size_t)>& f)
+{
+    if (tasks == 0)
+    {
+        return;
+    }
+    m_function = &f;
+    m_tasks = tasks;
+    m_next_task.store(0);
+    // Don't wake workers, when there is only one task
+    size_t workers = std::min(m_threads.size(), tasks - 1);
+    for(size_t i = 0; i < workers; i++)
+    {
+        m_start[i]->release(1);
+    }
+    performTasks();
+    m_finished.consume(static_cast<unsigned int>(workers));
+    m_function = NULL;
+}
+
+int sad::WorkerPool::workerLoop(size_t index)
+{
+    while(true)
+    {
+        m_start[index]->consume(1);
+        if (m_stopping)
+        {
+            return 0;
+        }
+        performTasks();
+        m_finished.release(1);
+    }
+    return 0;
+}
+
+void sad::WorkerPool::performTasks()
+{
+    size_t task = m_next_task.fetch_add(1);
+    while(task < m_tasks)
+    {
+        (*m_function)(task);
+        task = m_next_task.fetch_add(1);
+    }
+}
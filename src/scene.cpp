@@ -2,6 +2,8 @@
 #include "camera.h"
 #include "renderer.h"
 #include "orthographiccamera.h"
+#include "spritebatch.h"
+#include "geometry2d.h"
 #include "sadmutex.h"
 
 // ReSharper disable once CppUnusedIncludeDirective
@@ -22,7 +24,8 @@
 #include <time.h>
 
 sad::Scene::Scene()
-: m_active(true), m_cached_layer(0), m_camera(new sad::OrthographicCamera()), m_renderer(NULL)
+: m_active(true), m_cached_layer(0), m_camera(new sad::OrthographicCamera()), m_renderer(NULL),
+m_culling_enabled(false), m_culling_margin(0), m_culled_node_count(0), m_rendered_node_count(0)
 {
     m_camera->addRef();
     m_camera->Scene = this;
@@ -147,10 +150,33 @@ void sad::Scene::swapLayers(sad::SceneNode * node1, sad::SceneNode * node2)
 
 void sad::Scene::render()
 {  
+  if (m_renderer && m_renderer->headless() && !m_renderer->recording())
+  {
+      this->countNodesWithoutRendering();
+      return;
+  }
   m_camera->apply();
 
   performQueuedActions();
   lockChanges();
+  sad::SpriteBatch* batch = (m_renderer) ? m_renderer->spriteBatch() : NULL;
+  if (batch && !batch->enabled())
+  {
+      batch = NULL;
+  }
+  sad::Rect2D view;
+  bool culling = m_culling_enabled && m_camera->viewRect(view);
+  if (culling)
+  {
+      view = sad::Rect2D(
+          view[0].x() - m_culling_margin,
+          view[0].y() - m_culling_margin,
+          view[2].x() + m_culling_margin,
+          view[2].y() + m_culling_margin
+      );
+  }
+  m_culled_node_count = 0;
+  m_rendered_node_count = 0;
   for (unsigned long i = 0;i < m_layers.count(); ++i)
   {
 #ifdef LOG_RENDERING
@@ -164,7 +190,24 @@ void sad::Scene::render()
       sad::SceneNode * node = m_layers[i];
       if (node->active() && node->visible())
       {
-            node->render();
+            sad::Rect2D bounds;
+            if (culling && node->boundingRect(bounds) && !sad::collidesAABB(bounds, view))
+            {
+                ++m_culled_node_count;
+            }
+            else
+            {
+                bool batched = (batch) ? node->batch(batch) : false;
+                if (!batched)
+                {
+                    if (batch)
+                    {
+                        batch->flush();
+                    }
+                    node->render();
+                }
+                ++m_rendered_node_count;
+            }
       }
 #ifdef LOG_RENDERING
       SL_LOCAL_INTERNAL(
@@ -175,12 +218,63 @@ void sad::Scene::render()
     );
 #endif
   }
+  if (batch)
+  {
+      batch->flush();
+  }
   unlockChanges();
   performQueuedActions();
 
   m_camera->restore();  
 }
 
+void sad::Scene::countNodesWithoutRendering()
+{
+  performQueuedActions();
+  lockChanges();
+  m_culled_node_count = 0;
+  m_rendered_node_count = 0;
+  for (unsigned long i = 0;i < m_layers.count(); ++i)
+  {
+      if (m_layers[i]->active() && m_layers[i]->visible())
+      {
+          ++m_rendered_node_count;
+      }
+  }
+  unlockChanges();
+  performQueuedActions();
+}
+
+void sad::Scene::setCullingEnabled(bool enabled)
+{
+    m_culling_enabled = enabled;
+}
+
+bool sad::Scene::cullingEnabled() const
+{
+    return m_culling_enabled;
+}
+
+void sad::Scene::setCullingMargin(double margin)
+{
+    m_culling_margin = margin;
+}
+
+double sad::Scene::cullingMargin() const
+{
+    return m_culling_margin;
+}
+
+size_t sad::Scene::culledNodeCount() const
+{
+    return m_culled_node_count;
+}
+
+size_t sad::Scene::renderedNodeCount() const
+{
+    return m_rendered_node_count;
+}
+
 unsigned int sad::Scene::cachedSceneLayer() const
 {   
     return m_cached_layer;
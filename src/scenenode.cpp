@@ -1,6 +1,7 @@
 #include "scenenode.h"
 #include "scene.h"
 #include "sadmutex.h"
+#include "geometry2d.h"
 
 #include "db/schema/schema.h"
 #include "db/dbproperty.h"
@@ -21,6 +22,27 @@ void sad::SceneNode::regions(sad::Vector<sad::Rect2D> & r)
     
 }
 
+bool sad::SceneNode::boundingRect(sad::Rect2D & r)
+{
+    sad::Vector<sad::Rect2D> list;
+    this->regions(list);
+    if (list.size() == 0)
+    {
+        return false;
+    }
+    r = sad::boundingBox(list[0]);
+    for(size_t i = 1; i < list.size(); i++)
+    {
+        sad::extendBoundingBox(r, list[i]);
+    }
+    return true;
+}
+
+bool sad::SceneNode::batch(sad::SpriteBatch* batch)
+{
+    return false;
+}
+
 sad::SceneNode::~SceneNode()
 {
 
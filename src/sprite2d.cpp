@@ -1,10 +1,13 @@
 #include <sprite2d.h>
+#include <spritebatch.h>
 #include <geometry2d.h>
 #include <renderer.h>
 #include <sadmutex.h>
 
 #include <os/glheaders.h>
 
+#include <rendering/backend.h>
+
 #include <util/fs.h>
 
 #include <resource/resourcefile.h>
@@ -164,6 +167,12 @@ void sad::Sprite2D::regions(sad::Vector<sad::Rect2D> & r)
     r << this->renderableArea();
 }
 
+bool sad::Sprite2D::boundingRect(sad::Rect2D & r)
+{
+    r = sad::boundingBox(m_renderable_area);
+    return true;
+}
+
 static sad::db::schema::Schema* Sprite2DBasicSchema = NULL;
 
 static sad::Mutex Sprite2DBasicSchemaInit;
@@ -246,23 +255,23 @@ void sad::Sprite2D::render()
     sad::Texture * tex = m_texture.get();
     if (!tex)
       return;
-    glGetIntegerv(GL_CURRENT_COLOR, m_current_color_buffer);   
-    glColor4ub(m_color.r(),m_color.g(),m_color.b(),255-m_color.a());	   
-    tex->bind();	
-    glBegin(GL_QUADS);
-    for (int i = 0;i < 4; i++)
+    sad::rendering::backend(this->renderer())->drawSprite(
+        tex->boundTexture(),
+        m_renderable_area,
+        m_normalized_texture_coordinates,
+        sad::AColor(m_color.r(), m_color.g(), m_color.b(), 255 - m_color.a())
+    );
+}
+
+bool sad::Sprite2D::batch(sad::SpriteBatch* batch)
+{
+    sad::Texture * tex = m_texture.get();
+    if (!tex || this->metaData() != sad::Sprite2D::globalMetaData())
     {
-        glTexCoord2f(
-            (GLfloat)(m_normalized_texture_coordinates[i].x()),
-            (GLfloat)(m_normalized_texture_coordinates[i].y())
-        );
-        glVertex2f(
-            (GLfloat)(m_renderable_area[i].x()),
-            (GLfloat)(m_renderable_area[i].y())
-        );
-    }  
-    glEnd();
-    glColor4iv(m_current_color_buffer);
+        return false;
+    }
+    batch->add(tex->boundTexture(), m_renderable_area, m_normalized_texture_coordinates, m_color);
+    return true;
 }
 
 void sad::Sprite2D::rendererChanged()
@@ -291,7 +300,7 @@ void sad::Sprite2D::setTextureCoordinate(int index, const sad::Point2D & point)
     // Try  to immediately convert point to normalized if needed
     if (tex)
     {
-        sad::Point2D relativepoint(point.x() / tex->Width, point.y() / tex->Height );
+        sad::Point2D relativepoint = tex->normalizedPoint(point);
         int newindex = 3 - index;
 
         // Take care of horizontal flip
@@ -600,12 +609,15 @@ void sad::Sprite2D::toggleLoadingMode(bool on)
     m_loading = on;
 }
 
-bool sad::Sprite2D::load(const picojson::value& v)
+void sad::Sprite2D::beginLoading()
 {
     toggleLoadingMode(true);
-    bool result =  this->sad::SceneNode::load(v);
+}
+
+bool sad::Sprite2D::finishLoading(bool loaded)
+{
     toggleLoadingMode(false);
-    return result;
+    return loaded;
 }
 
 void sad::Sprite2D::setTreeName(sad::Renderer* r, const sad::String & tree_name)
@@ -672,7 +684,7 @@ void sad::Sprite2D::normalizeTextureCoordinates(sad::Texture * tex)
         for(int i = 0; i < 4; i++)
         {
             const sad::Point2D & point = m_texture_coordinates[i];
-            sad::Point2D relativepoint(point.x() / tex->Width, point.y() / tex->Height );
+            sad::Point2D relativepoint = tex->normalizedPoint(point);
             m_normalized_texture_coordinates[3 - i] = relativepoint;
         }
         if (m_flipx)
@@ -1,6 +1,7 @@
 #include <sprite3d.h>
 #include <geometry3d.h>
 #include <renderer.h>
+#include <opengl.h>
 #include <sadmutex.h>
 
 #include <os/glheaders.h>
@@ -181,8 +182,8 @@ void sad::Sprite3D::render()
   sad::Texture * texture = m_texture.get();
   if (!texture)
       return;
-   glGetIntegerv(GL_CURRENT_COLOR, m_current_color_buffer);   
-   glColor4ub(m_color.r(),m_color.g(),m_color.b(),255-m_color.a());	   
+   sad::Renderer * r = (this->renderer()) ? this->renderer() : sad::Renderer::ref();
+   r->opengl()->stateCache()->setColor(sad::AColor(m_color.r(),m_color.g(),m_color.b(),255-m_color.a()));
    texture->bind();	
    glBegin(GL_QUADS);
    for (int i = 0;i < 4; i++)
@@ -198,7 +199,6 @@ void sad::Sprite3D::render()
         );
    }  
    glEnd();
-   glColor4iv(m_current_color_buffer);
 }
 
 void sad::Sprite3D::rendererChanged()
@@ -222,7 +222,7 @@ void sad::Sprite3D::setTextureCoordinate(int index, const sad::Point2D & point)
     sad::Texture * tex = m_texture.get();
     if (tex)
     {
-        sad::Point2D relativepoint(point.x() / tex->Width, point.y() / tex->Height );
+        sad::Point2D relativepoint = tex->normalizedPoint(point);
         int newindex = 3 - index;
 
         // Take care of horizontal flip
@@ -497,7 +497,7 @@ void sad::Sprite3D::normalizeTextureCoordinates()
         for(int i = 0; i < 4; i++)
         {
             const sad::Point2D & point = m_texture_coordinates[i];
-            sad::Point2D relativepoint(point.x() / texture->Width, point.y() / texture->Height );
+            sad::Point2D relativepoint = texture->normalizedPoint(point);
             m_normalized_texture_coordinates[3 - i] = relativepoint;
         }
         if (m_flipx)
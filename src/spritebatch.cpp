@@ -0,0 +1,124 @@
+#include "spritebatch.h"
+#include "texture.h"
+
+#include "rendering/backend.h"
+
+sad::SpriteBatch::SpriteBatch()
+: m_renderer(NULL),
+m_enabled(true),
+m_texture(NULL),
+m_batched_quads(0),
+m_draw_calls(0),
+m_last_frame_saved_draw_calls(0)
+{
+
+}
+
+sad::SpriteBatch::~SpriteBatch()
+{
+
+}
+
+void sad::SpriteBatch::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+}
+
+bool sad::SpriteBatch::enabled() const
+{
+    return m_enabled;
+}
+
+void sad::SpriteBatch::setRenderer(sad::Renderer* renderer)
+{
+    m_renderer = renderer;
+}
+
+sad::Renderer* sad::SpriteBatch::renderer() const
+{
+    return m_renderer;
+}
+
+void sad::SpriteBatch::add(
+    sad::Texture* tex,
+    const sad::Rect2D& area,
+    const sad::Rect2D& texture_coordinates,
+    const sad::AColor& clr
+)
+{
+    if (tex != m_texture)
+    {
+        flush();
+        m_texture = tex;
+    }
+    for(unsigned int i = 0; i < 4; i++)
+    {
+        m_vertexes << static_cast<float>(area[i].x());
+        m_vertexes << static_cast<float>(area[i].y());
+        m_texture_coordinates << static_cast<float>(texture_coordinates[i].x());
+        m_texture_coordinates << static_cast<float>(texture_coordinates[i].y());
+        m_colors << clr.r() << clr.g() << clr.b() << static_cast<unsigned char>(255 - clr.a());
+    }
+}
+
+void sad::SpriteBatch::flush()
+{
+    unsigned int quads = pendingQuads();
+    if (quads == 0 || m_texture == NULL)
+    {
+        clear();
+        return;
+    }
+
+    sad::rendering::backend(m_renderer)->drawQuads(
+        m_texture,
+        &(m_vertexes[0]),
+        &(m_texture_coordinates[0]),
+        &(m_colors[0]),
+        quads
+    );
+
+    m_batched_quads += quads;
+    ++m_draw_calls;
+    clear();
+}
+
+void sad::SpriteBatch::startFrame()
+{
+    m_last_frame_saved_draw_calls = savedDrawCalls();
+    m_batched_quads = 0;
+    m_draw_calls = 0;
+}
+
+unsigned int sad::SpriteBatch::pendingQuads() const
+{
+    return static_cast<unsigned int>(m_vertexes.size() / 8);
+}
+
+unsigned int sad::SpriteBatch::batchedQuads() const
+{
+    return m_batched_quads;
+}
+
+unsigned int sad::SpriteBatch::drawCalls() const
+{
+    return m_draw_calls;
+}
+
+unsigned int sad::SpriteBatch::savedDrawCalls() const
+{
+    return m_batched_quads - m_draw_calls;
+}
+
+unsigned int sad::SpriteBatch::lastFrameSavedDrawCalls() const
+{
+    return m_last_frame_saved_draw_calls;
+}
+
+void sad::SpriteBatch::clear()
+{
+    m_texture = NULL;
+    m_vertexes.clear();
+    m_texture_coordinates.clear();
+    m_colors.clear();
+}
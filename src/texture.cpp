@@ -5,10 +5,15 @@
 
 #include <renderer.h>
 #include <opengl.h>
+#include <rendering/textureresidency.h>
+#include <imageformats/mipchain.h>
+#include <imageformats/blockcompression.h>
 #include <glcontext.h>
 
 #include <os/glheaders.h>
 #include <os/generatemipmaps30.h>
+#include <os/compressedteximage2d.h>
+#include <os/mappedfileimpl.h>
 
 #include <pipeline/pipeline.h>
 
@@ -87,6 +92,27 @@ sad::Texture::Tar7zArchiveBuffer::~Tar7zArchiveBuffer()
     
 }
 
+// ================================ sad::Texture::MappedFileBuffer implementation ================================
+
+sad::Texture::MappedFileBuffer::MappedFileBuffer() : File(NULL), Offset(0)
+{
+    
+}
+
+sad::uchar* sad::Texture::MappedFileBuffer::buffer() const
+{
+    if (!File || !(File->data()))
+    {
+        return NULL;
+    }
+    return File->data() + Offset;
+}
+
+sad::Texture::MappedFileBuffer::~MappedFileBuffer()
+{
+    delete File;
+}
+
 // ================================ sad::Texture::DefaultImageBuffer implementation ================================
 
 sad::Texture::DefaultImageBuffer::DefaultImageBuffer()
@@ -110,7 +136,7 @@ DECLARE_SOBJ_INHERITANCE(sad::Texture, sad::resource::Resource);
 #endif
 
 sad::Texture::Texture() 
-: BuildMipMaps(true), Buffer(new sad::Texture::DefaultBuffer()), Bpp(32), Format(sad::Texture::SFT_R8_G8_B8_A8), Width(0), Height(0), Id(0), OnGPU(false), m_renderer(NULL)
+: BuildMipMaps(true), MapFile(false), Buffer(new sad::Texture::DefaultBuffer()), Bpp(32), Format(sad::Texture::SFT_R8_G8_B8_A8), Width(0), Height(0), Id(0), OnGPU(false), m_renderer(NULL), m_atlas_page(NULL), m_atlas_x(0), m_atlas_y(0), m_mip_chain(NULL)
 {
 
 }
@@ -118,6 +144,10 @@ sad::Texture::Texture()
 sad::Texture::~Texture()
 {
 #ifndef TEXTURE_LOADER_TEST 
+    if (this->renderer())
+    {
+        this->renderer()->textureResidency()->textureDestroyed(this);
+    }
     if (this->renderer() && OnGPU)
     {
         if (this->renderer()->context()->valid())
@@ -144,18 +174,41 @@ sad::Texture::~Texture()
         }
     }
 #endif
+    delete m_mip_chain;
     delete Buffer;
 }
 
 void sad::Texture::upload()
 {
 #ifndef TEXTURE_LOADER_TEST 
+    // Texture, placed in atlas, is stored in page
+    if (m_atlas_page)
+    {
+        if (!m_atlas_page->OnGPU)
+        {
+            m_atlas_page->upload();
+        }
+        return;
+    }
     // We must not upload on our own to not cause
     // undefined behaviour
+    // Headless renderer has no context, where texture could be uploaded
     sad::Renderer * r = renderer();
-    if (!r || Width == 0 || Height == 0)
+    if (!r || r->headless() || Width == 0 || Height == 0)
         return;
 
+    // Compressed pixels are decompressed on CPU, if driver can't handle them
+    if (this->isCompressed())
+    {
+        bool npot = (Width & (Width - 1)) != 0 || (Height & (Height - 1)) != 0 || Width != Height;
+        if (r->opengl()->supportsExtension("GL_EXT_texture_compression_s3tc") == false
+            || (npot && (r->opengl()->supportsExtension("GL_ARB_texture_rectangle") == false
+                        || r->opengl()->supportsExtension("GL_ARB_texture_non_power_of_two") == false)))
+        {
+            this->decompress();
+        }
+    }
+
     OnGPU = true;
     
     // Get texture type and components
@@ -215,7 +268,7 @@ void sad::Texture::upload()
     GL_INVALID_VALUE is generated if texture is not a name returned from a previous call to glGenTextures.
     GL_INVALID_OPERATION is generated if texture was previously created with a target that doesn't match that of target.
     */
-    glBindTexture(GL_TEXTURE_2D, Id);
+    r->opengl()->stateCache()->bindTexture(Id);
     // Call function to know if there was any error and send message to log if error occurred
     gl_error = getGLError();
     if (gl_error != NULL)
@@ -245,6 +298,28 @@ void sad::Texture::upload()
     gl_error = getGLError();
     if (gl_error != NULL)
         SL_COND_LOCAL_INTERNAL(gl_error, r);
+
+    // Upload compressed blocks as is. Mip-maps are not built, since driver can't generate them
+    // for compressed textures
+    if (this->isCompressed())
+    {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        GLenum compressed_format = (Format == sad::Texture::SFT_BC1) ? GL_COMPRESSED_RGBA_S3TC_DXT1_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        GLsizei compressed_size = static_cast<GLsizei>(sad::imageformats::BlockCompression::compressedSize(Width, Height, Format));
+        if (sad::os::compressedTexImage2D(r, GL_TEXTURE_2D, 0, compressed_format, Width, Height, compressed_size, Buffer->buffer()))
+        {
+            gl_error = getGLError();
+            if (gl_error != NULL)
+                SL_COND_LOCAL_INTERNAL(gl_error, r);
+            r->textureResidency()->textureUploaded(this);
+            return;
+        }
+        // Function is not available, so fall back to decompressed pixels
+        this->decompress();
+    }
     
     if (!BuildMipMaps)
     {
@@ -284,6 +359,24 @@ void sad::Texture::upload()
             SL_COND_LOCAL_INTERNAL(gl_error, r);
     }
 
+    // Upload prebuilt chain of mip-maps instead of generating it on GPU
+    if (BuildMipMaps && m_mip_chain && m_mip_chain->isCompleteFor(Width, Height, Bpp))
+    {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(m_mip_chain->levels()));
+        glTexImage2D(GL_TEXTURE_2D, 0, opengl_internalformat, Width, Height, 0, opengl_format, opengl_type, Buffer->buffer());
+        for(unsigned int i = 0; i < m_mip_chain->levels(); i++)
+        {
+            const sad::imageformats::MipChain::Level& level = m_mip_chain->level(i);
+            glTexImage2D(GL_TEXTURE_2D, i + 1, opengl_internalformat, level.Width, level.Height, 0, opengl_format, opengl_type, &(level.Data[0]));
+        }
+        gl_error = getGLError();
+        if (gl_error != NULL)
+            SL_COND_LOCAL_INTERNAL(gl_error, r);
+        r->textureResidency()->textureUploaded(this);
+        return;
+    }
+
     // Actually upload image to GPU   
     GLint res;
     // ReSharper disable once CppEntityAssignedButNoRead
@@ -346,6 +439,7 @@ void sad::Texture::upload()
     {
         SL_COND_LOCAL_INTERNAL(gluErrorString(res), r);
     }
+    r->textureResidency()->textureUploaded(this);
 #endif
 }
 
@@ -383,6 +477,7 @@ bool sad::Texture::load(
     {   
         if (ri.Type == sad::resource::RFT_FILE)
         {
+            this->MapFile = picojson::get_property_or_default(options, "mapped", false);
             result = load(ri.FileName, r);
             if (!result && !util::isAbsolutePath(ri.FileName))
             {
@@ -417,6 +512,22 @@ bool sad::Texture::load(
             {
                 this->BuildMipMaps = !(maybenomips.value());
             }
+            // Chain is built here, so it's done on loader thread, when loading asynchronously
+            sad::Maybe<sad::String> maybemipmaps = picojson::to_type<sad::String>(
+                picojson::get_property(options, "mipmaps")
+            );
+            if (maybemipmaps.exists())
+            {
+                const sad::String& filter = maybemipmaps.value();
+                if (filter != "box" && filter != "kaiser")
+                {
+                    SL_LOCAL_WARNING(sad::String("Unknown mip-map filter \"") + filter + "\" for texture, expected \"box\" or \"kaiser\"", *r);
+                }
+                else if (this->BuildMipMaps && !m_mip_chain)
+                {
+                    this->buildMipChain(filter == "kaiser");
+                }
+            }
         }
     }
     return result;
@@ -433,6 +544,9 @@ bool sad::Texture::load(tar7z::Entry* e, sad::Renderer* r)
     char * f=const_cast<char *>(ff.data());
     while(*f) { *f=toupper(*f); ++f; }
 
+    // A chain and atlas placement of previous image must not be used with new one
+    this->setMipChain(NULL);
+    this->placeInAtlas(NULL, 0, 0);
     sad::imageformats::Loader * l = r->textureLoader(ff);
     return l->load(e, this);
 }
@@ -448,6 +562,9 @@ bool sad::Texture::load(const sad::String & filename, sad::Renderer * r)
     char * f=const_cast<char *>(ff.data());
     while(*f) { *f=toupper(*f); ++f; }
 
+    // A chain and atlas placement of previous image must not be used with new one
+    this->setMipChain(NULL);
+    this->placeInAtlas(NULL, 0, 0);
     sad::imageformats::Loader * l = r->textureLoader(ff);
     if (l)
     {
@@ -481,9 +598,27 @@ bool sad::Texture::load(const sad::WString & filename, sad::Renderer * r)
 void sad::Texture::bind()
 {
 #ifndef TEXTURE_LOADER_TEST
+    if (m_atlas_page)
+    {
+        m_atlas_page->bind();
+        return;
+    }
+    sad::Renderer * r = renderer();
+    if (r && r->headless())
+        return;
     if (!OnGPU)
         upload();
-    glBindTexture(GL_TEXTURE_2D, Id);
+    if (r)
+    {
+        r->opengl()->stateCache()->bindTexture(Id);
+        r->textureResidency()->textureBound(this);
+    }
+    else
+    {
+        // Texture without renderer is bound in context of global renderer, so binding must
+        // go through it's cache, otherwise cache could skip next binding of other texture
+        sad::Renderer::ref()->opengl()->stateCache()->bindTexture(Id);
+    }
     // Call function to know if there was any error and send message to log if error occurred
     unsigned char const * gl_error = getGLError();
     if (gl_error != NULL)
@@ -498,6 +633,15 @@ void sad::Texture::unload()
     {
         // glDeleteTextures causes an GL_INVALID_VALUE if n (1st arg) is negative.
         glDeleteTextures(1, &Id);
+        if (m_renderer)
+        {
+            m_renderer->opengl()->stateCache()->textureDeleted(Id);
+            m_renderer->textureResidency()->textureUnloaded(this);
+        }
+        else
+        {
+            sad::Renderer::ref()->opengl()->stateCache()->textureDeleted(Id);
+        }
         // Call function to know if there was any error and send message to log if error occurred
         unsigned char const * gl_error = getGLError();
         if (gl_error != NULL)
@@ -507,6 +651,101 @@ void sad::Texture::unload()
 #endif
 }
 
+size_t sad::Texture::gpuMemorySize() const
+{
+    size_t pixelsize = Bpp / 8;
+    switch(Format)
+    {
+    case sad::Texture::SFT_R5_G6_B5:
+    case sad::Texture::SFT_R4_G4_B4_A4:
+        pixelsize = 2;
+        break;
+    case sad::Texture::SFT_R3_G3_B2:
+        pixelsize = 1;
+        break;
+    case sad::Texture::SFT_BC1:
+    case sad::Texture::SFT_BC3:
+        // Compressed textures are uploaded without mip-maps
+        return sad::imageformats::BlockCompression::compressedSize(Width, Height, Format);
+    default: break;
+    };
+    size_t result = static_cast<size_t>(Width) * Height * pixelsize;
+    // A full chain of mip-maps takes one third of base level
+    if (BuildMipMaps)
+    {
+        result += result / 3;
+    }
+    return result;
+}
+
+void sad::Texture::setMipChain(sad::imageformats::MipChain* chain)
+{
+    if (m_mip_chain != chain)
+    {
+        delete m_mip_chain;
+    }
+    m_mip_chain = chain;
+}
+
+bool sad::Texture::buildMipChain(bool kaiser)
+{
+    if (Width == 0 || Height == 0)
+    {
+        return false;
+    }
+    sad::imageformats::MipChain* chain = new sad::imageformats::MipChain();
+    sad::imageformats::MipChain::Filter filter = (kaiser) ? sad::imageformats::MipChain::MCF_KAISER : sad::imageformats::MipChain::MCF_BOX;
+    if (!chain->build(this, filter))
+    {
+        delete chain;
+        return false;
+    }
+    this->setMipChain(chain);
+    return true;
+}
+
+bool sad::Texture::isCompressed() const
+{
+    return sad::imageformats::BlockCompression::isCompressed(Format);
+}
+
+bool sad::Texture::compress(sad::Texture::InternalFormat format)
+{
+    if (Bpp != 32 || Format != sad::Texture::SFT_R8_G8_B8_A8 || Width == 0 || Height == 0
+        || !sad::imageformats::BlockCompression::isCompressed(format))
+    {
+        return false;
+    }
+    sad::Texture::DefaultBuffer* newbuffer = new sad::Texture::DefaultBuffer();
+    newbuffer->Data.resize(sad::imageformats::BlockCompression::compressedSize(Width, Height, format));
+    sad::imageformats::BlockCompression::compress(Buffer->buffer(), Width, Height, format, &(newbuffer->Data[0]));
+    delete Buffer;
+    Buffer = newbuffer;
+    Format = format;
+    Bpp = (format == sad::Texture::SFT_BC1) ? 4 : 8;
+    // Prebuilt chain is stored in old format and can't be uploaded with compressed texture
+    this->setMipChain(NULL);
+    return true;
+}
+
+bool sad::Texture::decompress()
+{
+    if (!this->isCompressed())
+    {
+        return false;
+    }
+    sad::Texture::DefaultBuffer* newbuffer = new sad::Texture::DefaultBuffer();
+    newbuffer->Data.resize(static_cast<size_t>(Width) * Height * 4);
+    if (Width != 0 && Height != 0)
+    {
+        sad::imageformats::BlockCompression::decompress(Buffer->buffer(), Width, Height, Format, &(newbuffer->Data[0]));
+    }
+    delete Buffer;
+    Buffer = newbuffer;
+    Format = sad::Texture::SFT_R8_G8_B8_A8;
+    Bpp = 32;
+    return true;
+}
 
 void sad::Texture::setAlpha(sad::uchar a) const
 {
@@ -610,6 +849,25 @@ void sad::Texture::convertToPOTTexture()
     this->Buffer = buffer;
 }
 
+void sad::Texture::placeInAtlas(sad::Texture* page, unsigned int x, unsigned int y)
+{
+    m_atlas_page = page;
+    m_atlas_x = x;
+    m_atlas_y = y;
+}
+
+sad::Point2D sad::Texture::normalizedPoint(const sad::Point2D& p) const
+{
+    if (m_atlas_page)
+    {
+        return sad::Point2D(
+            (p.x() + m_atlas_x) / m_atlas_page->Width,
+            (p.y() + m_atlas_y) / m_atlas_page->Height
+        );
+    }
+    return sad::Point2D(p.x() / Width, p.y() / Height);
+}
+
 unsigned char const * sad::Texture::getGLError() {
     // Get an info about errors during operation
     GLint errorcode = glGetError();
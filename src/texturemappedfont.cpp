@@ -238,21 +238,6 @@ void  sad::TextureMappedFont::render(const sad::String & str,const sad::Point2D
         << glGetError(), 
         *sad::Renderer::ref()
     );
-    SL_LOCAL_INTERNAL(
-        fmt::Format("Restoring color {0}")
-        << glGetError(), 
-        *sad::Renderer::ref()
-    );
-#endif
-    this->restoreColor();
-#ifdef LOG_RENDERING
-    glGetIntegerv(GL_ATTRIB_STACK_DEPTH, &attribstackdepth);
-    SL_LOCAL_INTERNAL(
-        fmt::Format("Restored color {0} stack depth {1}")
-        << glGetError()
-        << attribstackdepth, 
-        *sad::Renderer::ref()
-    );
 #endif
     glPopAttrib();
 #ifdef LOG_RENDERING
@@ -0,0 +1,80 @@
+/*! \file benchmark.h
+
+
+    Defines a registry of benchmarks for tests. Benchmarks only measure and print time,
+    so they are not run with tests and are run instead of them, only when test executable
+    is started with --benchmark flag
+ */
+#pragma once
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+
+namespace benchmark
+{
+
+/*! A registered benchmark
+ */
+struct Entry
+{
+    const char* Name;    //!< A name of benchmark
+    void (*Function)();  //!< A function, which runs benchmark and prints results
+};
+
+/*! Returns all registered benchmarks
+    \return benchmarks
+ */
+inline std::vector<benchmark::Entry>& entries()
+{
+    static std::vector<benchmark::Entry> result;
+    return result;
+}
+
+/*! Registers benchmark, when instance is created. Used as global variable in file with benchmark
+ */
+struct Registrar
+{
+    /*! Registers benchmark
+        \param[in] name a name of benchmark
+        \param[in] function a function, which runs benchmark
+     */
+    Registrar(const char* name, void (*function)())
+    {
+        benchmark::Entry entry = { name, function };
+        benchmark::entries().push_back(entry);
+    }
+};
+
+/*! Returns, whether benchmarks are requested by --benchmark flag in command line
+    \param[in] argc amount of arguments
+    \param[in] argv arguments
+    \return whether benchmarks should be run
+ */
+inline bool requested(int argc, char** argv)
+{
+    for(int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--benchmark") == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*! Runs all registered benchmarks
+    \return exit code for executable
+ */
+inline int run()
+{
+    std::vector<benchmark::Entry>& list = benchmark::entries();
+    for(size_t i = 0; i < list.size(); i++)
+    {
+        printf("[ BENCHMARK    ] %s\n", list[i].Name);
+        list[i].Function();
+    }
+    return 0;
+}
+
+}
@@ -0,0 +1,306 @@
+#pragma warning(push)
+#pragma warning(disable: 4273)
+#pragma warning(disable: 4351)
+#include <cstdio>
+#include <chrono>
+#include "db/dbvariant.h"
+#include "db/dbobject.h"
+#include "db/dbtable.h"
+#include "db/dbdatabase.h"
+#include "db/dbbinarywriter.h"
+#include "db/dbbinaryreader.h"
+#include "db/schema/schema.h"
+// ReSharper disable once CppUnusedIncludeDirective
+#include "db/save.h"
+// ReSharper disable once CppUnusedIncludeDirective
+#include "db/load.h"
+#include "db/dbobjectfactory.h"
+#include "fuzzyequal.h"
+
+#include "mock3.h"
+#define _INC_STDIO
+#include "3rdparty/tpunit++/tpunit++.hpp"
+#include "../benchmark.h"
+#pragma warning(pop)
+
+
+/*!
+ * Tests binary format of sad::db::Database
+ */
+struct SadDbBinaryFormatTest : tpunit::TestFixture
+{
+public:
+    SadDbBinaryFormatTest() : tpunit::TestFixture(
+        TEST(SadDbBinaryFormatTest::test_values),
+        TEST(SadDbBinaryFormatTest::test_composite_values),
+        TEST(SadDbBinaryFormatTest::test_round_trip),
+        TEST(SadDbBinaryFormatTest::test_malformed),
+        TEST(SadDbBinaryFormatTest::test_deep_nesting)
+    ) {}
+
+    /*! Makes new empty database, which can create mock objects
+        \return database
+     */
+    static sad::db::Database* makeEmptyDatabase()
+    {
+        sad::db::ObjectFactory* f = new sad::db::ObjectFactory();
+        f->add<Mock3>("Mock3",  new sad::db::schema::Schema());
+
+        sad::db::Database* db = new sad::db::Database();
+        db->setFactory(f);
+        return db;
+    }
+
+    /*! Makes new database with table, filled with objects and some properties
+        \param[in] count amount of objects
+        \return database
+     */
+    static sad::db::Database* makeDatabase(int count)
+    {
+        sad::db::Database* db = makeEmptyDatabase();
+        db->addPropertyOfType("int", "int");
+        db->setProperty("int", -5);
+        db->addPropertyOfType("string", "sad::String");
+        db->setProperty("string", sad::String("test"));
+        db->addPropertyOfType("point", "sad::Point2D");
+        db->setProperty("point", sad::Point2D(1.5, -2));
+
+        sad::db::Table* tbl = new sad::db::Table();
+        db->addTable("table", tbl);
+        for(int i = 0; i < count; i++)
+        {
+            Mock3* mock = new Mock3();
+            mock->setIdC(i);
+            mock->setObjectName(sad::String("m") + sad::String::number(i));
+            tbl->add(mock);
+        }
+        db->addTable("empty", new sad::db::Table());
+        return db;
+    }
+
+    // ReSharper disable once CppMemberFunctionMayBeStatic
+    // ReSharper disable once CppMemberFunctionMayBeConst
+    void test_values()
+    {
+        sad::db::BinaryWriter w;
+        w.writeValue(sad::db::Variant(-7));
+        w.writeValue(sad::db::Variant(sad::String("name")));
+        w.writeValue(sad::db::Variant(sad::Point2D(3, 4)));
+        w.writeValue(sad::db::Variant(0.25));
+        sad::String data;
+        w.finish(data);
+
+        sad::db::BinaryReader r(data);
+        ASSERT_TRUE( r.readHeader() );
+        sad::db::Variant i(0);
+        ASSERT_TRUE( r.readValue(i) );
+        ASSERT_TRUE( i.get<int>().value() == -7 );
+        sad::db::Variant s(sad::String(""));
+        ASSERT_TRUE( r.readValue(s) );
+        ASSERT_TRUE( s.get<sad::String>().value() == "name" );
+        sad::db::Variant p(sad::Point2D(0, 0));
+        ASSERT_TRUE( r.readValue(p) );
+        ASSERT_TRUE( sad::equal(p.get<sad::Point2D>().value(), sad::Point2D(3, 4)) );
+        // Type mismatch must be rejected
+        sad::db::Variant wrong(sad::String(""));
+        ASSERT_FALSE( r.readValue(wrong) );
+        ASSERT_FALSE( r.atEnd() );
+    }
+
+    // ReSharper disable once CppMemberFunctionMayBeStatic
+    // ReSharper disable once CppMemberFunctionMayBeConst
+    void test_composite_values()
+    {
+        sad::Vector<sad::Point2D> points;
+        points << sad::Point2D(1, 2) << sad::Point2D(-3, 4.5);
+        sad::Vector<sad::Vector<sad::AColor> > colors;
+        colors << sad::Vector<sad::AColor>();
+        colors[0] << sad::AColor(1, 2, 3, 4) << sad::AColor(255, 0, 128, 7);
+        colors << sad::Vector<sad::AColor>();
+
+        sad::db::BinaryWriter w;
+        w.writeValue(sad::db::Variant(sad::Rect2D(1, 2, 3, 4)));
+        w.writeValue(sad::db::Variant(sad::Color(10, 20, 30)));
+        w.writeValue(sad::db::Variant(sad::AColor(40, 50, 60, 70)));
+        w.writeValue(sad::db::Variant(sad::Size2D(5.5, 6)));
+        w.writeValue(sad::db::Variant(sad::Point3I(-1, 2, -3)));
+        w.writeValue(sad::db::Variant(points));
+        w.writeValue(sad::db::Variant(colors));
+        sad::String data;
+        w.finish(data);
+
+        sad::db::BinaryReader r(data);
+        ASSERT_TRUE( r.readHeader() );
+        sad::db::Variant rect(sad::Rect2D(0, 0, 0, 0));
+        ASSERT_TRUE( r.readValue(rect) );
+        ASSERT_TRUE( sad::equal(rect.get<sad::Rect2D>().value(), sad::Rect2D(1, 2, 3, 4)) );
+        sad::db::Variant color(sad::Color(0, 0, 0));
+        ASSERT_TRUE( r.readValue(color) );
+        ASSERT_TRUE( color.get<sad::Color>().value() == sad::Color(10, 20, 30) );
+        sad::db::Variant acolor(sad::AColor(0, 0, 0, 0));
+        ASSERT_TRUE( r.readValue(acolor) );
+        ASSERT_TRUE( acolor.get<sad::AColor>().value() == sad::AColor(40, 50, 60, 70) );
+        sad::db::Variant size(sad::Size2D(0, 0));
+        ASSERT_TRUE( r.readValue(size) );
+        ASSERT_TRUE( sad::is_fuzzy_equal(size.get<sad::Size2D>().value().Width, 5.5) );
+        ASSERT_TRUE( sad::is_fuzzy_equal(size.get<sad::Size2D>().value().Height, 6) );
+        sad::db::Variant point(sad::Point3I(0, 0, 0));
+        ASSERT_TRUE( r.readValue(point) );
+        ASSERT_TRUE( point.get<sad::Point3I>().value().z() == -3 );
+        sad::Vector<sad::Point2D> readpoints;
+        sad::db::Variant pointlist(readpoints);
+        ASSERT_TRUE( r.readValue(pointlist) );
+        readpoints = pointlist.get<sad::Vector<sad::Point2D> >().value();
+        ASSERT_TRUE( readpoints.size() == 2 );
+        ASSERT_TRUE( sad::equal(readpoints[1], sad::Point2D(-3, 4.5)) );
+        // Packed color must not be read as other packed type
+        sad::db::Variant wrong(sad::Point2D(0, 0));
+        size_t position = r.position();
+        ASSERT_FALSE( r.readValue(wrong) );
+        r.setPosition(position);
+        sad::Vector<sad::Vector<sad::AColor> > readcolors;
+        sad::db::Variant colorlist(readcolors);
+        ASSERT_TRUE( r.readValue(colorlist) );
+        readcolors = colorlist.get<sad::Vector<sad::Vector<sad::AColor> > >().value();
+        ASSERT_TRUE( readcolors.size() == 2 );
+        ASSERT_TRUE( readcolors[0].size() == 2 );
+        ASSERT_TRUE( readcolors[0][1] == sad::AColor(255, 0, 128, 7) );
+        ASSERT_TRUE( readcolors[1].size() == 0 );
+        ASSERT_TRUE( r.atEnd() );
+    }
+
+    // ReSharper disable once CppMemberFunctionMayBeStatic
+    // ReSharper disable once CppMemberFunctionMayBeConst
+    void test_round_trip()
+    {
+        sad::db::Database* db = makeDatabase(3);
+        sad::String data;
+        db->saveBinary(data);
+
+        sad::db::Database* loaded = makeEmptyDatabase();
+        ASSERT_TRUE( loaded->loadBinary(data) );
+        ASSERT_TRUE( loaded->getProperty<int>("int").value() == -5 );
+        ASSERT_TRUE( loaded->getProperty<sad::String>("string").value() == "test" );
+        ASSERT_TRUE( sad::equal(loaded->getProperty<sad::Point2D>("point").value(), sad::Point2D(1.5, -2)) );
+        ASSERT_TRUE( loaded->table("empty") != NULL );
+        ASSERT_TRUE( loaded->table("empty")->empty() );
+        for(int i = 0; i < 3; i++)
+        {
+            sad::String name = sad::String("m") + sad::String::number(i);
+            Mock3* original = db->objectByName<Mock3>(name);
+            Mock3* mock = loaded->objectByName<Mock3>(name);
+            ASSERT_TRUE( mock != NULL );
+            ASSERT_TRUE( mock->id_c() == i );
+            ASSERT_TRUE( mock->MajorId == original->MajorId );
+            ASSERT_TRUE( mock->MinorId == original->MinorId );
+        }
+
+        // Order of tables and objects may differ, so compare sizes of binary data and JSON
+        sad::String resaved;
+        loaded->saveBinary(resaved);
+        ASSERT_TRUE( resaved.size() == data.size() );
+        ASSERT_TRUE( loaded->save().size() == db->save().size() );
+        delete loaded;
+        delete db;
+    }
+
+    // ReSharper disable once CppMemberFunctionMayBeStatic
+    // ReSharper disable once CppMemberFunctionMayBeConst
+    void test_malformed()
+    {
+        sad::db::Database* db = makeDatabase(3);
+        sad::String data;
+        db->saveBinary(data);
+
+        sad::db::Database* loaded = makeEmptyDatabase();
+        ASSERT_FALSE( loaded->loadBinary(sad::String()) );
+        ASSERT_FALSE( loaded->loadBinary(db->save()) );
+        // Every truncated variant of data must be rejected
+        for(size_t i = 0; i < data.size(); i++)
+        {
+            ASSERT_FALSE( loaded->loadBinary(data.substr(0, i)) );
+        }
+        ASSERT_FALSE( loaded->loadBinary(data + sad::String("x")) );
+        ASSERT_TRUE( loaded->table("table") == NULL );
+        ASSERT_TRUE( loaded->loadBinary(data) );
+        ASSERT_TRUE( loaded->objectByName<Mock3>("m2") != NULL );
+        delete loaded;
+        delete db;
+    }
+
+    // ReSharper disable once CppMemberFunctionMayBeStatic
+    // ReSharper disable once CppMemberFunctionMayBeConst
+    void test_deep_nesting()
+    {
+        // Arrays, nested deeper than limit, must be rejected instead of overflowing stack
+        sad::db::BinaryWriter w;
+        for(int i = 0; i < 100000; i++)
+        {
+            w.writeByte(sad::db::BVT_ARRAY);
+            w.writeUInt32(1);
+        }
+        w.writeByte(sad::db::BVT_NULL);
+        sad::String data;
+        w.finish(data);
+
+        sad::db::BinaryReader r(data);
+        ASSERT_TRUE( r.readHeader() );
+        size_t start = r.position();
+        ASSERT_FALSE( r.skipValue() );
+        r.setPosition(start);
+        picojson::value json;
+        ASSERT_FALSE( r.readJSON(json) );
+
+        // Nesting within limit is still allowed
+        sad::db::BinaryWriter shallow;
+        for(int i = 0; i < SAD_DB_BINARY_MAX_DEPTH; i++)
+        {
+            shallow.writeByte(sad::db::BVT_ARRAY);
+            shallow.writeUInt32(1);
+        }
+        shallow.writeByte(sad::db::BVT_NULL);
+        shallow.finish(data);
+
+        sad::db::BinaryReader sr(data);
+        ASSERT_TRUE( sr.readHeader() );
+        start = sr.position();
+        ASSERT_TRUE( sr.skipValue() );
+        ASSERT_TRUE( sr.atEnd() );
+        sr.setPosition(start);
+        ASSERT_TRUE( sr.readJSON(json) );
+    }
+
+} _sad_db_binary_format_test;
+
+/*! Prints time of loading database with many objects from JSON and from binary format
+ */
+static void benchmarkBinaryFormat()
+{
+    const int count = 20000;
+    sad::db::Database* db = SadDbBinaryFormatTest::makeDatabase(count);
+    sad::String json = db->save();
+    sad::String binary;
+    db->saveBinary(binary);
+
+    // Full snapshot, made after loading, costs same for both formats, so journaled snapshots are used
+    sad::db::Database* fromjson = SadDbBinaryFormatTest::makeEmptyDatabase();
+    fromjson->setJournaledSnapshots(true);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    fromjson->load(json);
+    double jsonloading = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    sad::db::Database* frombinary = SadDbBinaryFormatTest::makeEmptyDatabase();
+    frombinary->setJournaledSnapshots(true);
+    start = std::chrono::steady_clock::now();
+    frombinary->loadBinary(binary);
+    double binaryloading = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    printf("Loading database of %d objects:\n", count);
+    printf("JSON: %.3f ms, %u bytes\n", jsonloading, static_cast<unsigned int>(json.size()));
+    printf("Binary: %.3f ms, %u bytes\n", binaryloading, static_cast<unsigned int>(binary.size()));
+    delete fromjson;
+    delete frombinary;
+    delete db;
+}
+
+static benchmark::Registrar _sad_db_binary_format_benchmark("Loading database from JSON and binary format", benchmarkBinaryFormat);
@@ -0,0 +1,279 @@
+#pragma warning(push)
+#pragma warning(disable: 4273)
+#pragma warning(disable: 4351)
+#include <cstdio>
+#include <chrono>
+#include "db/dbvariant.h"
+#include "db/dbobject.h"
+#include "db/dbtable.h"
+#include "db/dbdatabase.h"
+#include "db/dbjournal.h"
+#include "db/schema/schema.h"
+// ReSharper disable once CppUnusedIncludeDirective
+#include "db/save.h"
+// ReSharper disable once CppUnusedIncludeDirective
+#include "db/load.h"
+#include "db/dbobjectfactory.h"
+
+#include "mock3.h"
+#define _INC_STDIO
+#include "3rdparty/tpunit++/tpunit++.hpp"
+#include "../benchmark.h"
+#pragma warning(pop)
+
+
+/*! A database, which could estimate memory, used by full snapshots
+ */
+class SnapshotMeasuringDatabase: public sad::db::Database
+{
+public:
+    /*! Returns summary size of serialized full snapshots. Memory, used by picojson values,
+        is larger, so it's a lower bound of used memory
+        \return size in bytes
+     */
+    size_t fullSnapshotsSize() const
+    {
+        size_t result = 0;
+        for(size_t i = 0; i < m_snapshots.size(); i++)
+        {
+            const sad::db::Database::TablesSnapshot& tables = m_snapshots[i].Tables;
+            for(size_t j = 0; j < tables.size(); j++)
+            {
+                const sad::db::Database::TableSnapshot& table = tables[j].p2();
+                for(sad::db::Database::TableSnapshot::const_iterator it = table.const_begin(); it != table.const_end(); ++it)
+                {
+                    result += it.value().serialize().size();
+                }
+            }
+        }
+        return result;
+    }
+};
+
+/*!
+ * Tests journaled snapshots of sad::db::Database
+ */
+struct SadDbJournalTest : tpunit::TestFixture
+{
+public:
+    SadDbJournalTest() : tpunit::TestFixture(
+        TEST(SadDbJournalTest::test_properties),
+        TEST(SadDbJournalTest::test_database_properties),
+        TEST(SadDbJournalTest::test_objects_and_tables),
+        TEST(SadDbJournalTest::test_save_after_restore),
+        TEST(SadDbJournalTest::test_undo_step)
+    ) {}
+
+    /*! Makes new database with table, filled with objects
+        \param[in] count amount of objects
+        \param[in] journaled whether snapshots are journaled
+        \return database
+     */
+    static SnapshotMeasuringDatabase* makeDatabase(int count, bool journaled)
+    {
+        sad::db::ObjectFactory* f = new sad::db::ObjectFactory();
+        f->add<Mock3>("Mock3",  new sad::db::schema::Schema());
+
+        SnapshotMeasuringDatabase* db = new SnapshotMeasuringDatabase();
+        db->setFactory(f);
+        db->setJournaledSnapshots(journaled);
+
+        sad::db::Table* tbl = new sad::db::Table();
+        db->addTable("table", tbl);
+        for(int i = 0; i < count; i++)
+        {
+            Mock3* mock = new Mock3();
+            mock->setIdC(i);
+            mock->setObjectName(sad::String("m") + sad::String::number(i));
+            tbl->add(mock);
+        }
+        return db;
+    }
+
+    // ReSharper disable once CppMemberFunctionMayBeStatic
+    // ReSharper disable once CppMemberFunctionMayBeConst
+    void test_properties()
+    {
+        sad::db::Database* db = makeDatabase(2, true);
+        ASSERT_TRUE( db->journaledSnapshots() );
+        Mock3* mock = db->objectByName<Mock3>("m1");
+        db->saveSnapshot();
+
+        mock->setProperty("prop", 5);
+        mock->setProperty("prop", 6);
+        db->saveSnapshot();
+
+        mock->setProperty("prop2", 7);
+        db->saveSnapshot();
+        // Only first change of property is stored
+        ASSERT_TRUE( db->journal()->entriesCount() == 2 );
+
+        mock->setProperty("prop", 8);
+        ASSERT_TRUE( db->snapshotsCount() == 3 );
+
+        ASSERT_TRUE( db->restoreSnapshot(0) );
+        ASSERT_TRUE( mock->id_c() == 1 );
+        ASSERT_TRUE( db->restoreSnapshot(2) );
+        ASSERT_TRUE( mock->id_c() == 7 );
+        ASSERT_TRUE( db->restoreSnapshot(1) );
+        ASSERT_TRUE( mock->id_c() == 6 );
+        ASSERT_FALSE( db->restoreSnapshot(3) );
+        delete db;
+    }
+
+    // ReSharper disable once CppMemberFunctionMayBeStatic
+    // ReSharper disable once CppMemberFunctionMayBeConst
+    void test_database_properties()
+    {
+        sad::db::Database* db = makeDatabase(0, true);
+        db->addPropertyOfType("value", "int");
+        db->setProperty("value", 1);
+        db->saveSnapshot();
+
+        db->setProperty("value", 2);
+        db->saveSnapshot();
+
+        sad::db::Variant v(3);
+        db->setDBProperty("value", v);
+
+        ASSERT_TRUE( db->restoreSnapshot(0) );
+        ASSERT_TRUE( db->getProperty<int>("value").value() == 1 );
+        ASSERT_TRUE( db->restoreSnapshot(1) );
+        ASSERT_TRUE( db->getProperty<int>("value").value() == 2 );
+        delete db;
+    }
+
+    // ReSharper disable once CppMemberFunctionMayBeStatic
+    // ReSharper disable once CppMemberFunctionMayBeConst
+    void test_objects_and_tables()
+    {
+        sad::db::Database* db = makeDatabase(2, true);
+        sad::db::Table* tbl = db->table("table");
+        Mock3* mock0 = db->objectByName<Mock3>("m0");
+        Mock3* mock1 = db->objectByName<Mock3>("m1");
+        db->saveSnapshot();
+
+        tbl->remove(mock0);
+        Mock3* mock2 = new Mock3();
+        mock2->setIdC(2);
+        mock2->setObjectName("m2");
+        tbl->add(mock2);
+        db->saveSnapshot();
+
+        db->removeTable("table");
+        db->addTable("table1", new sad::db::Table());
+        ASSERT_TRUE( db->objectByName<Mock3>("m1") == NULL );
+
+        ASSERT_TRUE( db->restoreSnapshot(0) );
+        ASSERT_TRUE( db->table("table") == tbl );
+        ASSERT_TRUE( db->table("table1") == NULL );
+        ASSERT_TRUE( db->objectByName<Mock3>("m0") == mock0 );
+        ASSERT_TRUE( db->objectByName<Mock3>("m1") == mock1 );
+        ASSERT_TRUE( db->objectByName<Mock3>("m2") == NULL );
+        ASSERT_TRUE( db->queryByMajorId(mock1->MajorId) == mock1 );
+
+        ASSERT_TRUE( db->restoreSnapshot(1) );
+        ASSERT_TRUE( db->objectByName<Mock3>("m0") == NULL );
+        ASSERT_TRUE( db->objectByName<Mock3>("m2") == mock2 );
+        ASSERT_TRUE( db->queryByMajorId(mock2->MajorId) == mock2 );
+        delete db;
+    }
+
+    // ReSharper disable once CppMemberFunctionMayBeStatic
+    // ReSharper disable once CppMemberFunctionMayBeConst
+    void test_save_after_restore()
+    {
+        sad::db::Database* db = makeDatabase(1, true);
+        Mock3* mock = db->objectByName<Mock3>("m0");
+        db->saveSnapshot();
+
+        mock->setProperty("prop", 5);
+        db->saveSnapshot();
+
+        ASSERT_TRUE( db->restoreSnapshot(0) );
+        mock->setProperty("prop", 9);
+        db->saveSnapshot();
+        ASSERT_TRUE( db->snapshotsCount() == 3 );
+
+        ASSERT_TRUE( db->restoreSnapshot(1) );
+        ASSERT_TRUE( mock->id_c() == 5 );
+        ASSERT_TRUE( db->restoreSnapshot(2) );
+        ASSERT_TRUE( mock->id_c() == 9 );
+        ASSERT_TRUE( db->restoreSnapshot(0) );
+        ASSERT_TRUE( mock->id_c() == 0 );
+        delete db;
+    }
+
+    /*! Makes a small change in database, saves snapshot and restores previous one
+        \param[in] db database
+        \param[out] saving time of saving snapshot in milliseconds
+        \param[out] restoring time of restoring snapshot in milliseconds
+     */
+    static void measureUndoStep(sad::db::Database* db, double& saving, double& restoring)
+    {
+        for(int i = 0; i < 10; i++)
+        {
+            db->objectByMajorId<Mock3>(i + 2)->setProperty("prop", -1);
+        }
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        db->saveSnapshot();
+        saving = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        db->restoreSnapshot(0);
+        restoring = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // ReSharper disable once CppMemberFunctionMayBeStatic
+    // ReSharper disable once CppMemberFunctionMayBeConst
+    void test_undo_step()
+    {
+        for(int journaled = 0; journaled < 2; journaled++)
+        {
+            SnapshotMeasuringDatabase* db = makeDatabase(20, journaled == 1);
+            db->saveSnapshot();
+            double saving = 0, restoring = 0;
+            measureUndoStep(db, saving, restoring);
+            ASSERT_TRUE( db->objectByMajorId<Mock3>(2)->id_c() == 1 );
+            if (journaled == 1)
+            {
+                ASSERT_TRUE( db->journal()->entriesCount() == 10 );
+            }
+            delete db;
+        }
+    }
+
+} _sad_db_journal_test;
+
+/*! Prints time of saving and restoring snapshots of database with many objects and memory, used by
+    them, for full and journaled snapshots
+ */
+static void benchmarkJournal()
+{
+    const int count = 20000;
+    SnapshotMeasuringDatabase* full = SadDbJournalTest::makeDatabase(count, false);
+    full->saveSnapshot();
+    double fullsaving = 0, fullrestoring = 0;
+    SadDbJournalTest::measureUndoStep(full, fullsaving, fullrestoring);
+
+    SnapshotMeasuringDatabase* journaled = SadDbJournalTest::makeDatabase(count, true);
+    journaled->saveSnapshot();
+    double journaledsaving = 0, journaledrestoring = 0;
+    SadDbJournalTest::measureUndoStep(journaled, journaledsaving, journaledrestoring);
+
+    printf("Snapshots of %d objects with 10 changed objects:\n", count);
+    printf("Full: saving %.3f ms, restoring %.3f ms, at least %u bytes\n",
+        fullsaving,
+        fullrestoring,
+        static_cast<unsigned int>(full->fullSnapshotsSize())
+    );
+    printf("Journaled: saving %.3f ms, restoring %.3f ms, about %u bytes\n",
+        journaledsaving,
+        journaledrestoring,
+        static_cast<unsigned int>(journaled->journal()->entriesCount() * sizeof(sad::db::Journal::Entry))
+    );
+    delete full;
+    delete journaled;
+}
+
+static benchmark::Registrar _sad_db_journal_benchmark("Full and journaled snapshots", benchmarkJournal);
@@ -0,0 +1,134 @@
+#include "helper.h"
+#include <glyphatlas.h>
+#include <fixedsizefont.h>
+#include <towidechar.h>
+
+/*!
+ * Tests packing glyphs into atlas and lazy loading of glyphs by code points
+ */
+struct GlyphAtlasTest : tpunit::TestFixture
+{
+public:
+
+   GlyphAtlasTest() : tpunit::TestFixture(
+       TEST(GlyphAtlasTest::testCodePoints),
+       TEST(GlyphAtlasTest::testPacking),
+       TEST(GlyphAtlasTest::testEviction),
+       TEST(GlyphAtlasTest::testFont)
+   ) {}
+
+   /*! Makes a bitmap of specified size
+       \param[in] buffer a buffer for pixels
+       \param[in] width a width
+       \param[in] height a height
+       \return bitmap
+    */
+   static FT_Bitmap makeBitmap(std::vector<unsigned char> & buffer, unsigned int width, unsigned int height)
+   {
+       buffer.resize(width * height, 255);
+       FT_Bitmap bitmap;
+       memset(&bitmap, 0, sizeof(FT_Bitmap));
+       bitmap.width = width;
+       bitmap.rows = height;
+       bitmap.pitch = width;
+       bitmap.buffer = &(buffer[0]);
+       return bitmap;
+   }
+
+   void testCodePoints()
+   {
+       // "Aя€" in UTF-8 and a single byte, which is not valid UTF-8
+       sad::String s("A\xD1\x8F\xE2\x82\xAC\xFF");
+       size_t pos = 0;
+       ASSERT_TRUE( sad::freetype::next_code_point(s, pos) == 'A' );
+       ASSERT_TRUE( sad::freetype::next_code_point(s, pos) == 0x44F );
+       ASSERT_TRUE( sad::freetype::next_code_point(s, pos) == 0x20AC );
+       ASSERT_TRUE( sad::freetype::next_code_point(s, pos) == static_cast<unsigned int>(sad::freetype::to_wide_char(0xFF)) );
+       ASSERT_TRUE( pos == s.size() );
+   }
+
+   void testPacking()
+   {
+       sad::freetype::GlyphAtlas atlas(64, 2);
+       std::vector<unsigned char> buffer;
+       FT_Bitmap bitmap = makeBitmap(buffer, 10, 12);
+       sad::Vector<sad::freetype::GlyphAtlas::Region> regions;
+       atlas.beginUse();
+       // 5 glyphs of 11 pixels with padding fit in a row, 4 rows of 13 pixels fit into page
+       for(int i = 0; i < 20; i++)
+       {
+           sad::freetype::GlyphAtlas::Region r;
+           atlas.add(bitmap, r);
+           regions << r;
+       }
+       ASSERT_TRUE( atlas.pageCount() == 1 );
+       for(size_t i = 0; i < regions.size(); i++)
+       {
+           ASSERT_TRUE( regions[i].Page == 0 );
+           ASSERT_TRUE( atlas.use(regions[i]) );
+           for(size_t j = 0; j < i; j++)
+           {
+               bool overlaps = regions[i].U0 < regions[j].U1 && regions[j].U0 < regions[i].U1
+                            && regions[i].V0 < regions[j].V1 && regions[j].V0 < regions[i].V1;
+               ASSERT_FALSE( overlaps );
+           }
+       }
+       sad::freetype::GlyphAtlas::Region r;
+       atlas.add(bitmap, r);
+       ASSERT_TRUE( r.Page == 1 );
+       ASSERT_TRUE( atlas.evictionCount() == 0 );
+   }
+
+   void testEviction()
+   {
+       sad::freetype::GlyphAtlas atlas(16, 2);
+       std::vector<unsigned char> buffer;
+       FT_Bitmap bitmap = makeBitmap(buffer, 15, 15);
+       sad::freetype::GlyphAtlas::Region first, second, third;
+       atlas.beginUse();
+       atlas.add(bitmap, first);
+       atlas.beginUse();
+       atlas.add(bitmap, second);
+       atlas.beginUse();
+       ASSERT_TRUE( atlas.use(second) );
+       // First page is least recently used, so it's evicted
+       atlas.add(bitmap, third);
+       ASSERT_TRUE( atlas.pageCount() == 2 );
+       ASSERT_TRUE( atlas.evictionCount() == 1 );
+       ASSERT_FALSE( atlas.use(first) );
+       ASSERT_TRUE( atlas.use(second) );
+       ASSERT_TRUE( atlas.use(third) );
+       // Both pages are used now, so atlas grows over limit
+       sad::freetype::GlyphAtlas::Region fourth;
+       atlas.add(bitmap, fourth);
+       ASSERT_TRUE( atlas.pageCount() == 3 );
+       // Oversized glyph gets it's own page
+       FT_Bitmap big = makeBitmap(buffer, 40, 20);
+       sad::freetype::GlyphAtlas::Region fifth;
+       atlas.add(big, fifth);
+       ASSERT_TRUE( atlas.use(fifth) );
+       ASSERT_TRUE( fifth.U1 - fifth.U0 > 0.5f );
+   }
+
+   void testFont()
+   {
+       FT_Library library;
+       FT_Face    face;
+       FT_Init_FreeType(&library);
+       ASSERT_TRUE( FT_New_Face(library, SOURCE_FONT, 0, &face) == 0 );
+       {
+           sad::freetype::FixedSizeFont font(library, face, 20);
+           ASSERT_TRUE( font.cachedGlyphCount() == 0 );
+           sad::Size2D size = font.size("Hello, world", 1.0f, sad::Font::FRF_None);
+           ASSERT_TRUE( size.Width > 0 );
+           // Glyphs are cached once per code point and share one page
+           ASSERT_TRUE( font.cachedGlyphCount() == 9 );
+           ASSERT_TRUE( font.atlas().pageCount() == 1 );
+           font.size("\xE2\x82\xAC\xE2\x82\xAC", 1.0f, sad::Font::FRF_None);
+           ASSERT_TRUE( font.cachedGlyphCount() == 10 );
+       }
+       FT_Done_Face(face);
+       FT_Done_FreeType(library);
+   }
+
+} _glyph_atlas_test;
@@ -0,0 +1,317 @@
+#pragma warning(push)
+#pragma warning(disable: 4273)
+#pragma warning(disable: 4351)
+#include <cstdio>
+#include <chrono>
+#define _INC_STDIO
+#include "3rdparty/tpunit++/tpunit++.hpp"
+#include "layouts/grid.h"
+#include "fuzzyequal.h"
+#include "../benchmark.h"
+#pragma warning(pop)
+
+
+/*! A node with fixed size, which could be placed in grid without loading any resources
+ */
+class GridBatchNode: public sad::SceneNode
+{
+public:
+    /*! Creates new node with specified size
+        \param[in] width a width
+        \param[in] height a height
+     */
+    GridBatchNode(double width, double height) : m_area(0, 0, width, height)
+    {
+    }
+    /*! Does nothing
+     */
+    virtual void render() override
+    {
+    }
+    /*! Returns area of node
+        \param[out] r regions
+     */
+    virtual void regions(sad::Vector<sad::Rect2D> & r) override
+    {
+        r << m_area;
+    }
+    /*! Moves node
+        \param[in] p vector
+     */
+    virtual void moveBy(const sad::Point2D& p) override
+    {
+        for(size_t i = 0; i < 4; i++)
+        {
+            m_area[i] += p;
+        }
+    }
+    /*! Sets size of node, keeping it's position
+        \param[in] width a width
+        \param[in] height a height
+     */
+    void setSize(double width, double height)
+    {
+        m_area = sad::Rect2D(m_area[0].x(), m_area[0].y(), m_area[0].x() + width, m_area[0].y() + height);
+    }
+private:
+    /*! An area of node
+     */
+    sad::Rect2D m_area;
+};
+
+/*!
+ * Tests dirty tracking and batching of changes in grid
+ */
+struct SadGridBatchTests : tpunit::TestFixture
+{
+ public:
+   SadGridBatchTests() : tpunit::TestFixture(
+       TEST(SadGridBatchTests::testBatch),
+       TEST(SadGridBatchTests::testIncrementalEqualsFull),
+       TEST(SadGridBatchTests::testDeferredWithoutRenderer),
+       TEST(SadGridBatchTests::testBatchEqualsImmediate)
+   ) {}
+
+   /*! Makes new grid with specified size
+       \param[in] rows amount of rows
+       \param[in] cols amount of columns
+       \return grid
+    */
+   static sad::layouts::Grid* makeGrid(unsigned int rows, unsigned int cols)
+   {
+       sad::layouts::Grid* grid = new sad::layouts::Grid();
+       grid->setFixedWidth(false);
+       grid->setFixedHeight(false);
+       grid->setRows(rows);
+       grid->setColumns(cols);
+       grid->setArea(sad::Rect2D(0, 0, 100, 100));
+       return grid;
+   }
+
+   /*! Fills every cell of grid with node, with padding
+       \param[in] grid a grid
+       \param[out] nodes created nodes
+    */
+   static void fill(sad::layouts::Grid* grid, sad::Vector<GridBatchNode*>& nodes)
+   {
+       for(unsigned int row = 0; row < grid->rows(); row++)
+       {
+           for(unsigned int col = 0; col < grid->columns(); col++)
+           {
+               GridBatchNode* node = new GridBatchNode(10 + col, 10 + row);
+               nodes << node;
+               sad::layouts::Cell* cell = grid->cell(row, col);
+               cell->addChild(node);
+               cell->setPaddingTop(1);
+               cell->setPaddingLeft(2);
+           }
+       }
+   }
+
+   /*! Collects assigned areas of cells of grid
+       \param[in] grid a grid
+       \param[out] areas areas of cells
+    */
+   static void collectAreas(sad::layouts::Grid* grid, sad::Vector<sad::Rect2D>& areas)
+   {
+       areas.clear();
+       for(size_t i = 0; i < grid->allocatedCellCount(); i++)
+       {
+           areas << grid->cell(i)->AssignedArea;
+       }
+   }
+
+   /*! Tests, whether lists of areas are equal
+       \param[in] a first list
+       \param[in] b second list
+       \return whether they are equal
+    */
+   static bool equalAreas(const sad::Vector<sad::Rect2D>& a, const sad::Vector<sad::Rect2D>& b)
+   {
+       if (a.size() != b.size())
+       {
+           return false;
+       }
+       for(size_t i = 0; i < a.size(); i++)
+       {
+           if (!sad::equal(a[i], b[i]))
+           {
+               return false;
+           }
+       }
+       return true;
+   }
+
+   /*! Frees nodes
+       \param[in] nodes list of nodes
+    */
+   static void freeNodes(sad::Vector<GridBatchNode*>& nodes)
+   {
+       for(size_t i = 0; i < nodes.size(); i++)
+       {
+           delete nodes[i];
+       }
+       nodes.clear();
+   }
+
+   // ReSharper disable once CppMemberFunctionMayBeStatic
+   // ReSharper disable once CppMemberFunctionMayBeConst
+   void testBatch()
+   {
+       sad::Vector<GridBatchNode*> nodes;
+       sad::layouts::Grid* grid = makeGrid(2, 2);
+       grid->beginBatch();
+       grid->beginBatch();
+       fill(grid, nodes);
+       ASSERT_TRUE( grid->isBatching() );
+       ASSERT_TRUE( grid->needsRelayout() );
+       ASSERT_TRUE( sad::equal(grid->cell(1, 1)->AssignedArea, sad::Rect2D(0, 100, 0, 100)) );
+       grid->endBatch();
+       ASSERT_TRUE( grid->needsRelayout() );
+       grid->endBatch();
+       ASSERT_FALSE( grid->isBatching() );
+       ASSERT_FALSE( grid->needsRelayout() );
+       // Column 1 has width of 11 + 2 of padding, row 1 has height of 11 + 1 of padding
+       ASSERT_TRUE( sad::equal(grid->cell(1, 1)->AssignedArea, sad::Rect2D(12, 100 - 11 - 12, 25, 100 - 11)) );
+       ASSERT_TRUE( sad::equal(grid->area(), sad::Rect2D(0, 100 - 23, 25, 100)) );
+       delete grid;
+       freeNodes(nodes);
+   }
+
+   // ReSharper disable once CppMemberFunctionMayBeStatic
+   // ReSharper disable once CppMemberFunctionMayBeConst
+   void testIncrementalEqualsFull()
+   {
+       sad::Vector<GridBatchNode*> nodes;
+       sad::layouts::Grid* grid = makeGrid(4, 5);
+       fill(grid, nodes);
+       grid->merge(1, 1, 2, 2);
+
+       sad::Vector<sad::Rect2D> incremental;
+       sad::Vector<sad::Rect2D> full;
+       // Grow a cell, so row and column are resized
+       nodes[0]->setSize(40, 30);
+       grid->cell(0, 0)->setPaddingBottom(3);
+       collectAreas(grid, incremental);
+       grid->update();
+       collectAreas(grid, full);
+       ASSERT_TRUE( equalAreas(incremental, full) );
+
+       // Shrink it back
+       nodes[0]->setSize(1, 1);
+       grid->cell(0, 0)->setPaddingBottom(0);
+       collectAreas(grid, incremental);
+       grid->update();
+       collectAreas(grid, full);
+       ASSERT_TRUE( equalAreas(incremental, full) );
+
+       // Change merged cell and a cell, which does not change it's size
+       grid->cell(1, 1)->setWidth(sad::layouts::LengthValue(sad::layouts::LU_Pixels, 70));
+       grid->cell(3, 4)->setHorizontalAlignment(sad::layouts::LHA_Left);
+       collectAreas(grid, incremental);
+       grid->update();
+       collectAreas(grid, full);
+       ASSERT_TRUE( equalAreas(incremental, full) );
+
+       // Changes without updating grid are taken into account on next relayout
+       grid->cell(2, 4)->setPaddingRight(15, false);
+       grid->cell(0, 1)->setPaddingTop(2);
+       collectAreas(grid, incremental);
+       grid->update();
+       collectAreas(grid, full);
+       ASSERT_TRUE( equalAreas(incremental, full) );
+
+       delete grid;
+       freeNodes(nodes);
+   }
+
+   // ReSharper disable once CppMemberFunctionMayBeStatic
+   // ReSharper disable once CppMemberFunctionMayBeConst
+   void testDeferredWithoutRenderer()
+   {
+       sad::Vector<GridBatchNode*> nodes;
+       sad::layouts::Grid* grid = makeGrid(1, 1);
+       grid->setDeferredUpdates(true);
+       ASSERT_TRUE( grid->deferredUpdates() );
+       fill(grid, nodes);
+       // No renderer to defer updates to, so grid is relayouted immediately
+       ASSERT_FALSE( grid->needsRelayout() );
+       ASSERT_TRUE( sad::equal(grid->area(), sad::Rect2D(0, 89, 12, 100)) );
+       delete grid;
+       freeNodes(nodes);
+   }
+
+   // ReSharper disable once CppMemberFunctionMayBeStatic
+   // ReSharper disable once CppMemberFunctionMayBeConst
+   void testBatchEqualsImmediate()
+   {
+       sad::Vector<GridBatchNode*> nodes;
+       sad::layouts::Grid* grid = makeGrid(5, 5);
+       fill(grid, nodes);
+       sad::Vector<sad::Rect2D> expected;
+       collectAreas(grid, expected);
+       delete grid;
+       freeNodes(nodes);
+
+       grid = makeGrid(5, 5);
+       grid->beginBatch();
+       fill(grid, nodes);
+       grid->endBatch();
+       sad::Vector<sad::Rect2D> areas;
+       collectAreas(grid, areas);
+       ASSERT_TRUE( equalAreas(areas, expected) );
+       delete grid;
+       freeNodes(nodes);
+   }
+
+} _sad_grid_batch_tests;
+
+/*! Prints time of building grid with relayout on every change and in batch, and time of editing
+    single cell with full update and with dirty tracking
+ */
+static void benchmarkGridBatch()
+{
+    const unsigned int size = 20;
+    const int edits = 200;
+    sad::Vector<GridBatchNode*> nodes;
+
+    // Building grid with relayout on every change
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    sad::layouts::Grid* grid = SadGridBatchTests::makeGrid(size, size);
+    SadGridBatchTests::fill(grid, nodes);
+    double immediate = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    delete grid;
+    SadGridBatchTests::freeNodes(nodes);
+
+    // Building grid in batch
+    start = std::chrono::steady_clock::now();
+    grid = SadGridBatchTests::makeGrid(size, size);
+    grid->beginBatch();
+    SadGridBatchTests::fill(grid, nodes);
+    grid->endBatch();
+    double batched = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // Editing single cell with full recomputation, as before dirty tracking
+    start = std::chrono::steady_clock::now();
+    for(int i = 0; i < edits; i++)
+    {
+        grid->cell(size / 2, size / 2)->setPaddingRight(i % 2, false);
+        grid->update();
+    }
+    double fulledits = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // Editing single cell with dirty tracking
+    start = std::chrono::steady_clock::now();
+    for(int i = 0; i < edits; i++)
+    {
+        grid->cell(size / 2, size / 2)->setPaddingRight(i % 2);
+    }
+    double incrementaledits = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    printf("Building %ux%u grid: %.3f ms with relayout on every change, %.3f ms in batch\n", size, size, immediate, batched);
+    printf("%d edits of single cell: %.3f ms with full update, %.3f ms with dirty tracking\n", edits, fulledits, incrementaledits);
+    delete grid;
+    SadGridBatchTests::freeNodes(nodes);
+}
+
+static benchmark::Registrar _sad_grid_batch_benchmark("Batching and dirty tracking of grid", benchmarkGridBatch);
@@ -3,10 +3,15 @@
 #pragma warning(disable: 4351)
 #include <stdio.h>
 #include "3rdparty/tpunit++/tpunit++.hpp"
+#include "../benchmark.h"
 #pragma warning(pop)
 
 int main(int argc, char ** argv)
 {
+   if (benchmark::requested(argc, argv))
+   {
+       return benchmark::run();
+   }
    /**
     * Run all of the registered tpunit++ tests. Returns 0 if
     * all tests are successful, otherwise returns the number
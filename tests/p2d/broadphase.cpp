@@ -0,0 +1,53 @@
+#pragma warning(push)
+#pragma warning(disable: 4273)
+#pragma warning(disable: 4351)
+#include <stdio.h>
+#include <vector>
+#include "3rdparty/tpunit++/tpunit++.hpp"
+#include "worldsimulation.h"
+#pragma warning(pop)
+
+
+/*!
+ * Tests broad phases for equivalence with brute-force search
+ */
+struct BroadPhaseTest : tpunit::TestFixture
+{
+ public:
+    BroadPhaseTest() : tpunit::TestFixture(
+        TEST(BroadPhaseTest::testUniformGrid),
+        TEST(BroadPhaseTest::testSweepAndPrune),
+        TEST(BroadPhaseTest::testSwitchingBroadPhase)
+    ) {}
+
+    void testUniformGrid()
+    {
+        std::vector<p2dsimulation::BodyDescription> d = p2dsimulation::generateBodies(300);
+        std::vector<p2dsimulation::RecordedEvent> expected = p2dsimulation::simulate(d, NULL, 5);
+        std::vector<p2dsimulation::RecordedEvent> actual = p2dsimulation::simulate(d, new sad::p2d::UniformGridBroadPhase(16.0), 5);
+        ASSERT_TRUE( expected.size() > 0 );
+        ASSERT_TRUE( expected == actual );
+    }
+
+    void testSweepAndPrune()
+    {
+        std::vector<p2dsimulation::BodyDescription> d = p2dsimulation::generateBodies(300);
+        std::vector<p2dsimulation::RecordedEvent> expected = p2dsimulation::simulate(d, NULL, 5);
+        std::vector<p2dsimulation::RecordedEvent> actual = p2dsimulation::simulate(d, new sad::p2d::SweepAndPruneBroadPhase(), 5);
+        ASSERT_TRUE( expected.size() > 0 );
+        ASSERT_TRUE( expected == actual );
+    }
+
+    void testSwitchingBroadPhase()
+    {
+        sad::p2d::World* w = new sad::p2d::World();
+        ASSERT_TRUE( w->broadPhase() == NULL );
+        sad::p2d::BroadPhase* p = new sad::p2d::SweepAndPruneBroadPhase();
+        w->setBroadPhase(p);
+        ASSERT_TRUE( w->broadPhase() == p );
+        w->setBroadPhase(NULL);
+        ASSERT_TRUE( w->broadPhase() == NULL );
+        delete w;
+    }
+
+} _broad_phase_test;
@@ -0,0 +1,338 @@
+#pragma warning(push)
+#pragma warning(disable: 4273)
+#pragma warning(disable: 4351)
+#include <stdio.h>
+#include <chrono>
+#include "3rdparty/tpunit++/tpunit++.hpp"
+#include <p2d/world.h>
+#include <p2d/circle.h>
+#include <p2d/rectangle.h>
+#include <p2d/line.h>
+#include <p2d/bounds.h>
+#include "../benchmark.h"
+#pragma warning(pop)
+
+/*! Makes a circle body
+    \param[in] x an x position
+    \param[in] y an y position
+    \param[in] r a radius
+    \param[in] vx a horizontal velocity
+    \return body
+ */
+static sad::p2d::Body* makeBullet(double x, double y, double r, double vx)
+{
+    sad::p2d::Body* b = new sad::p2d::Body();
+    sad::p2d::Circle* c = new sad::p2d::Circle();
+    c->setRadius(r);
+    b->setShape(c);
+    b->setCurrentPosition(sad::p2d::Point(x, y));
+    b->setCurrentTangentialVelocity(sad::p2d::Vector(vx, 0));
+    return b;
+}
+
+/*! Makes a vertical line body
+    \param[in] x an x position
+    \param[in] y1 a lower point
+    \param[in] y2 an upper point
+    \return body
+ */
+static sad::p2d::Body* makeWall(double x, double y1, double y2)
+{
+    sad::p2d::Body* b = new sad::p2d::Body();
+    sad::p2d::Line* l = new sad::p2d::Line();
+    l->setCutter(x, y1, x, y2);
+    b->setShape(l);
+    return b;
+}
+
+/*! Adds bodies to world and builds their caches, like world does before testing them
+    \param[in] w world
+    \param[in] b1 first body
+    \param[in] b2 second body
+    \param[in] step time step
+ */
+static void prepareBodies(sad::p2d::World* w, sad::p2d::Body* b1, sad::p2d::Body* b2, double step)
+{
+    w->addBody(b1);
+    w->addBody(b2);
+    b1->buildCaches(step);
+    b2->buildCaches(step);
+}
+
+/*!
+ * Tests detector, computing time of impact by conservative advancement, and tunnelling
+ * of fast bodies through thin ones
+ */
+struct ConservativeAdvancementTest : tpunit::TestFixture
+{
+ public:
+    ConservativeAdvancementTest() : tpunit::TestFixture(
+        TEST(ConservativeAdvancementTest::testSeparation),
+        TEST(ConservativeAdvancementTest::testCircles),
+        TEST(ConservativeAdvancementTest::testBulletThroughLine),
+        TEST(ConservativeAdvancementTest::testBulletThroughThinRectangle),
+        TEST(ConservativeAdvancementTest::testBulletMissesLine),
+        TEST(ConservativeAdvancementTest::testBulletThroughBound),
+        TEST(ConservativeAdvancementTest::testAcceleratedBody),
+        TEST(ConservativeAdvancementTest::testRotatingStick),
+        TEST(ConservativeAdvancementTest::testOverlappingAtStart),
+        TEST(ConservativeAdvancementTest::testWorld),
+        TEST(ConservativeAdvancementTest::testManyBullets)
+    ) {}
+
+    int events;
+
+    void countEvent(const sad::p2d::BasicCollisionEvent&)
+    {
+        ++events;
+    }
+
+    /*! Separation of shapes is a distance between them
+     */
+    void testSeparation()
+    {
+        sad::p2d::Circle c1;
+        c1.setRadius(1);
+        sad::p2d::Circle c2;
+        c2.setRadius(1);
+        c2.setCenter(sad::p2d::Point(3, 4));
+        ASSERT_TRUE( sad::is_fuzzy_equal(sad::p2d::ConservativeAdvancementCollisionDetector::separation(&c1, &c2), 3.0) );
+
+        sad::p2d::Rectangle r;
+        r.setRect(sad::Rect2D(2, -1, 4, 1));
+        ASSERT_TRUE( sad::is_fuzzy_equal(sad::p2d::ConservativeAdvancementCollisionDetector::separation(&c1, &r), 1.0) );
+        // Nearest point of rectangle is a vertex
+        r.setRect(sad::Rect2D(3, 4, 5, 6));
+        ASSERT_TRUE( sad::is_fuzzy_equal(sad::p2d::ConservativeAdvancementCollisionDetector::separation(&c1, &r), 4.0) );
+
+        sad::p2d::Line l;
+        l.setCutter(0, 0, 0, 10);
+        ASSERT_TRUE( sad::p2d::ConservativeAdvancementCollisionDetector::separation(&c1, &l) <= 0 );
+
+        sad::p2d::Bound b;
+        b.setType(sad::p2d::BT_DOWN);
+        b.setPosition(-3);
+        ASSERT_TRUE( sad::is_fuzzy_equal(sad::p2d::ConservativeAdvancementCollisionDetector::separation(&b, &c1), 2.0) );
+        ASSERT_TRUE( sad::is_fuzzy_equal(sad::p2d::ConservativeAdvancementCollisionDetector::separation(&c1, &b), 2.0) );
+    }
+
+    /*! Time of impact of two circles is exact
+     */
+    void testCircles()
+    {
+        sad::p2d::World* w = new sad::p2d::World();
+        sad::p2d::Body* b1 = makeBullet(0, 0, 1, 10);
+        sad::p2d::Body* b2 = makeBullet(10, 0, 1, -10);
+        prepareBodies(w, b1, b2, 1.0);
+        sad::p2d::ConservativeAdvancementCollisionDetector d;
+        sad::p2d::MaybeTime t = d.collides(b1, b2, 1.0);
+        ASSERT_TRUE( t.exists() );
+        ASSERT_TRUE( sad::is_fuzzy_equal(t.value(), 0.4, 1.0E-4) );
+        delete w;
+    }
+
+    /*! Fast bullet does not pass through thin line
+     */
+    void testBulletThroughLine()
+    {
+        sad::p2d::World* w = new sad::p2d::World();
+        sad::p2d::Body* bullet = makeBullet(0, 0, 0.5, 1000);
+        sad::p2d::Body* wall = makeWall(50, -10, 10);
+        prepareBodies(w, bullet, wall, 0.1);
+        sad::p2d::ConservativeAdvancementCollisionDetector d;
+        sad::p2d::MaybeTime t = d.collides(bullet, wall, 0.1);
+        ASSERT_TRUE( t.exists() );
+        ASSERT_TRUE( sad::is_fuzzy_equal(t.value(), 0.0495, 1.0E-6) );
+        t = d.collides(wall, bullet, 0.1);
+        ASSERT_TRUE( t.exists() );
+        ASSERT_TRUE( sad::is_fuzzy_equal(t.value(), 0.0495, 1.0E-6) );
+        delete w;
+    }
+
+    /*! Fast bullet does not pass through thin rectangle
+     */
+    void testBulletThroughThinRectangle()
+    {
+        sad::p2d::World* w = new sad::p2d::World();
+        sad::p2d::Body* bullet = makeBullet(0, 0, 0.5, 1000);
+        sad::p2d::Body* wall = new sad::p2d::Body();
+        sad::p2d::Rectangle* r = new sad::p2d::Rectangle();
+        r->setRect(sad::Rect2D(70, -10, 70.1, 10));
+        wall->setShape(r);
+        prepareBodies(w, bullet, wall, 0.1);
+        sad::p2d::ConservativeAdvancementCollisionDetector d;
+        sad::p2d::MaybeTime t = d.collides(bullet, wall, 0.1);
+        ASSERT_TRUE( t.exists() );
+        ASSERT_TRUE( sad::is_fuzzy_equal(t.value(), 0.0695, 1.0E-6) );
+
+        // Multisampling with same amount of samples misses it
+        sad::p2d::MultisamplingCollisionDetector m(1);
+        ASSERT_FALSE( m.collides(bullet, wall, 0.1).exists() );
+        delete w;
+    }
+
+    /*! Fast bullet, passing near line, does not collide with it
+     */
+    void testBulletMissesLine()
+    {
+        sad::p2d::World* w = new sad::p2d::World();
+        sad::p2d::Body* bullet = makeBullet(0, 0, 0.5, 1000);
+        sad::p2d::Body* wall = makeWall(50, 0.6, 10);
+        prepareBodies(w, bullet, wall, 0.1);
+        sad::p2d::ConservativeAdvancementCollisionDetector d;
+        ASSERT_FALSE( d.collides(bullet, wall, 0.1).exists() );
+        delete w;
+    }
+
+    /*! Fast bullet is stopped at bound
+     */
+    void testBulletThroughBound()
+    {
+        sad::p2d::World* w = new sad::p2d::World();
+        sad::p2d::Body* bullet = makeBullet(0, 0, 0.5, 1000);
+        sad::p2d::Body* bound = new sad::p2d::Body();
+        sad::p2d::Bound* b = new sad::p2d::Bound();
+        b->setType(sad::p2d::BT_RIGHT);
+        b->setPosition(30);
+        bound->setShape(b);
+        prepareBodies(w, bullet, bound, 0.1);
+        sad::p2d::ConservativeAdvancementCollisionDetector d;
+        sad::p2d::MaybeTime t = d.collides(bound, bullet, 0.1);
+        ASSERT_TRUE( t.exists() );
+        ASSERT_TRUE( sad::is_fuzzy_equal(t.value(), 0.0295, 1.0E-6) );
+        delete w;
+    }
+
+    /*! Time of impact of accelerated body matches time of uniformly accelerated movement
+     */
+    void testAcceleratedBody()
+    {
+        sad::p2d::World* w = new sad::p2d::World();
+        sad::p2d::Body* bullet = makeBullet(0, 0, 0.5, 0);
+        bullet->addForce(new sad::p2d::TangentialForce(sad::p2d::Vector(200, 0)));
+        sad::p2d::Body* wall = makeWall(25.5, -10, 10);
+        prepareBodies(w, bullet, wall, 1.0);
+        sad::p2d::ConservativeAdvancementCollisionDetector d;
+        sad::p2d::MaybeTime t = d.collides(bullet, wall, 1.0);
+        // Displacement of body grows as square of time, so 25 = x(1) * t * t
+        ASSERT_TRUE( t.exists() );
+        double expected = sqrt(25.0 / bullet->positionDeltaAt(1.0).x());
+        ASSERT_TRUE( sad::is_fuzzy_equal(t.value(), expected, 1.0E-4) );
+        delete w;
+    }
+
+    /*! Fast rotating stick hits a ball, which lays in it's way
+     */
+    void testRotatingStick()
+    {
+        sad::p2d::World* w = new sad::p2d::World();
+        sad::p2d::Body* stick = makeWall(0, -10, 10);
+        stick->setCurrentAngularVelocity(100);
+        sad::p2d::Body* ball = makeBullet(7, 0, 0.5, 0);
+        prepareBodies(w, stick, ball, 0.1);
+        sad::p2d::ConservativeAdvancementCollisionDetector d;
+        sad::p2d::MaybeTime t = d.collides(stick, ball, 0.1);
+        ASSERT_TRUE( t.exists() );
+        // Stick should be rotated by quarter of turn minus angle, covered by ball
+        double angle = M_PI / 2 - asin(0.5 / 7);
+        ASSERT_TRUE( fabs(t.value() - angle / 100) < 1.0E-4 );
+        delete w;
+    }
+
+    /*! Overlapping bodies collide immediately
+     */
+    void testOverlappingAtStart()
+    {
+        sad::p2d::World* w = new sad::p2d::World();
+        sad::p2d::Body* b1 = makeBullet(0, 0, 1, 10);
+        sad::p2d::Body* b2 = makeBullet(1, 0, 1, -10);
+        prepareBodies(w, b1, b2, 1.0);
+        sad::p2d::ConservativeAdvancementCollisionDetector d;
+        sad::p2d::MaybeTime t = d.collides(b1, b2, 1.0);
+        ASSERT_TRUE( t.exists() );
+        ASSERT_TRUE( sad::is_fuzzy_zero(t.value()) );
+        delete w;
+    }
+
+    /*! World with detector reports event for bullet, which passes through a wall within a step
+     */
+    void testWorld()
+    {
+        events = 0;
+        sad::p2d::World* w = new sad::p2d::World();
+        w->setDetector(new sad::p2d::ConservativeAdvancementCollisionDetector());
+        w->addHandler(this, &ConservativeAdvancementTest::countEvent);
+        w->addBody(makeBullet(0, 0, 0.5, 1000));
+        w->addBody(makeWall(50, -10, 10));
+        w->step(0.1);
+        ASSERT_TRUE( events == 1 );
+        delete w;
+    }
+
+    /*! World with detector reports events for all bullets of different speed, every of which
+        passes through it's own wall
+     */
+    void testManyBullets()
+    {
+        const int count = 50;
+        events = 0;
+        sad::p2d::World* w = new sad::p2d::World();
+        w->setDetector(new sad::p2d::ConservativeAdvancementCollisionDetector());
+        w->addGroup("bullets");
+        w->addGroup("walls");
+        w->addHandler("bullets", "walls", this, &ConservativeAdvancementTest::countEvent);
+        for(int i = 0; i < count; i++)
+        {
+            double y = i * 3.0;
+            w->addBodyToGroup("bullets", makeBullet(0, y, 0.5, 200.0 + 10.0 * i));
+            w->addBodyToGroup("walls", makeWall(15.0 + (i % 7), y - 1, y + 1));
+        }
+        w->step(0.1);
+        ASSERT_TRUE( events == count );
+        delete w;
+    }
+
+} _conservative_advancement_test;
+
+/*! Prints time of stepping a world with bullets and thin walls and amount of tunnelled bullets
+    for multisampling with 1, 4 and 16 samples and conservative advancement
+ */
+static void benchmarkConservativeAdvancement()
+{
+    const int count = 200;
+    const char* names[] = { "multisampling x1", "multisampling x4", "multisampling x16", "conservative advancement" };
+    for(int mode = 0; mode < 4; mode++)
+    {
+        sad::p2d::CollisionDetector* d = NULL;
+        switch(mode)
+        {
+            case 0: d = new sad::p2d::MultisamplingCollisionDetector(1); break;
+            case 1: d = new sad::p2d::MultisamplingCollisionDetector(4); break;
+            case 2: d = new sad::p2d::MultisamplingCollisionDetector(16); break;
+            default: d = new sad::p2d::ConservativeAdvancementCollisionDetector(); break;
+        }
+        int events = 0;
+        sad::p2d::World* w = new sad::p2d::World();
+        w->setDetector(d);
+        w->addGroup("bullets");
+        w->addGroup("walls");
+        std::function<void(const sad::p2d::BasicCollisionEvent&)> f = [&events](const sad::p2d::BasicCollisionEvent&) {
+            ++events;
+        };
+        w->addHandler("bullets", "walls", f);
+        for(int i = 0; i < count; i++)
+        {
+            // Bullets of different speed, every of them should hit only it's own wall
+            double y = i * 3.0;
+            w->addBodyToGroup("bullets", makeBullet(0, y, 0.5, 200.0 + 10.0 * i));
+            w->addBodyToGroup("walls", makeWall(15.0 + (i % 7), y - 1, y + 1));
+        }
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        w->step(0.1);
+        double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        printf("%-26s: %8.2f ms, %3d of %d bullets tunnelled\n", names[mode], time, count - events, count);
+        delete w;
+    }
+}
+
+static benchmark::Registrar _conservative_advancement_benchmark("Conservative advancement", benchmarkConservativeAdvancement);
@@ -25,7 +25,8 @@ struct ConvexHullTest : tpunit::TestFixture
        TEST(ConvexHullTest::testPointOnRectangleSide),
        TEST(ConvexHullTest::testNearestNormals),
        TEST(ConvexHullTest::testQuadrangle1),
-       TEST(ConvexHullTest::testSixSides1)
+       TEST(ConvexHullTest::testSixSides1),
+       TEST(ConvexHullTest::testCollidesUsingCachedAxis)
    ) {}
    
    void testNormalsOfTriangle()
@@ -236,4 +237,38 @@ struct ConvexHullTest : tpunit::TestFixture
        ASSERT_TRUE( sad::equal(center, sad::p2d::Point(3,2)) );
    }
 
+   void testCollidesUsingCachedAxis()
+   {
+       sad::Vector<sad::p2d::Point> set1;
+       set1 << sad::p2d::Point(0, 0);
+       set1 << sad::p2d::Point(1, 3);
+       set1 << sad::p2d::Point(4, 3);
+       set1 << sad::p2d::Point(3, 0);
+       sad::p2d::ConvexHull hull1(set1);
+       hull1.buildAxisCache();
+
+       sad::Vector<sad::p2d::Point> set2;
+       set2 << sad::p2d::Point(3.5, 0);
+       set2 << sad::p2d::Point(5, 2);
+       set2 << sad::p2d::Point(7, 0);
+       set2 << sad::p2d::Point(5, -2);
+       sad::p2d::ConvexHull hull2(set2);
+       hull2.buildAxisCache();
+
+       sad::Vector<sad::p2d::Point> set3;
+       set3 << sad::p2d::Point(2, 2);
+       sad::p2d::ConvexHull hull3(set3);
+       hull3.buildAxisCache();
+
+       ASSERT_FALSE( hull1.collidesUsingCachedAxis(hull2) );
+       ASSERT_FALSE( hull2.collidesUsingCachedAxis(hull1) );
+       ASSERT_TRUE( hull1.collidesUsingCachedAxis(hull3) );
+       ASSERT_TRUE( hull3.collidesUsingCachedAxis(hull1) );
+       ASSERT_FALSE( hull2.collidesUsingCachedAxis(hull3) );
+
+       hull2.clear();
+       ASSERT_TRUE( hull2.points() == 0 );
+       ASSERT_FALSE( hull2.collidesUsingCachedAxis(hull1) );
+   }
+
 } _convex_hull_test;
\ No newline at end of file
@@ -0,0 +1,171 @@
+#pragma warning(push)
+#pragma warning(disable: 4273)
+#pragma warning(disable: 4351)
+#include <stdio.h>
+#include <algorithm>
+#include "3rdparty/tpunit++/tpunit++.hpp"
+#include <p2d/world.h>
+#include <p2d/worldsteptask.h>
+#include <p2d/circle.h>
+#pragma warning(pop)
+
+/*! Makes world with one body, moving with specified velocity
+    \param[in] vx a horizontal velocity
+    \param[out] body a created body
+    \return a world
+ */
+static sad::p2d::World* makeWorldWithMovingBody(double vx, sad::p2d::Body** body)
+{
+    sad::p2d::World* w = new sad::p2d::World();
+    sad::p2d::Body* b = new sad::p2d::Body();
+    sad::p2d::Circle* c = new sad::p2d::Circle();
+    c->setRadius(1);
+    b->setShape(c);
+    b->setCurrentTangentialVelocity(sad::p2d::Vector(vx, 0));
+    w->addBody(b);
+    *body = b;
+    return w;
+}
+
+/*!
+ * Tests stepping world with fixed step and interpolation between steps
+ */
+struct FixedStepTest : tpunit::TestFixture
+{
+ public:
+    FixedStepTest() : tpunit::TestFixture(
+        TEST(FixedStepTest::testVariableStep),
+        TEST(FixedStepTest::testAccumulator),
+        TEST(FixedStepTest::testMaxSubsteps),
+        TEST(FixedStepTest::testInterpolation),
+        TEST(FixedStepTest::testTeleportIsNotInterpolated),
+        TEST(FixedStepTest::testReproducibleWithDifferentFrameRates)
+    ) {}
+
+    /*! By default world is stepped once by time of frame
+     */
+    void testVariableStep()
+    {
+        sad::p2d::Body* b = NULL;
+        sad::p2d::World* w = makeWorldWithMovingBody(1.0, &b);
+        sad::p2d::WorldStepTask* task = new sad::p2d::WorldStepTask(w, NULL);
+        ASSERT_FALSE( task->isFixedTimeStep() );
+        ASSERT_TRUE( task->advance(0.5) == 1 );
+        ASSERT_TRUE( sad::is_fuzzy_equal(b->position().x(), 0.5) );
+        ASSERT_TRUE( sad::is_fuzzy_equal(task->interpolationAlpha(), 1.0) );
+        ASSERT_TRUE( sad::is_fuzzy_equal(b->interpolatedPosition().x(), 0.5) );
+        delete task;
+    }
+
+    /*! Time of frames is accumulated and simulated by fixed steps
+     */
+    void testAccumulator()
+    {
+        sad::p2d::Body* b = NULL;
+        sad::p2d::World* w = makeWorldWithMovingBody(1.0, &b);
+        sad::p2d::WorldStepTask* task = new sad::p2d::WorldStepTask(w, NULL);
+        task->setFixedTimeStep(0.01);
+        ASSERT_TRUE( task->advance(0.025) == 2 );
+        ASSERT_TRUE( sad::is_fuzzy_equal(task->accumulator(), 0.005) );
+        ASSERT_TRUE( sad::is_fuzzy_equal(b->position().x(), 0.02) );
+        ASSERT_TRUE( task->advance(0.004) == 0 );
+        ASSERT_TRUE( sad::is_fuzzy_equal(b->position().x(), 0.02) );
+        ASSERT_TRUE( task->advance(0.002) == 1 );
+        ASSERT_TRUE( sad::is_fuzzy_equal(task->accumulator(), 0.001) );
+        ASSERT_TRUE( sad::is_fuzzy_equal(b->position().x(), 0.03) );
+        delete task;
+    }
+
+    /*! Amount of steps per frame is limited and time, which could not be simulated, is dropped
+     */
+    void testMaxSubsteps()
+    {
+        sad::p2d::Body* b = NULL;
+        sad::p2d::World* w = makeWorldWithMovingBody(1.0, &b);
+        sad::p2d::WorldStepTask* task = new sad::p2d::WorldStepTask(w, NULL);
+        task->setFixedTimeStep(0.01);
+        task->setMaxSubsteps(5);
+        ASSERT_TRUE( task->advance(1.0) == 5 );
+        ASSERT_TRUE( sad::is_fuzzy_equal(b->position().x(), 0.05) );
+        ASSERT_TRUE( task->accumulator() < 0.01 );
+        ASSERT_TRUE( task->interpolationAlpha() >= 0 && task->interpolationAlpha() < 1 );
+        // Next usual frame should not try to catch up
+        ASSERT_TRUE( task->advance(0.01) <= 2 );
+        delete task;
+    }
+
+    /*! Bodies are interpolated between previous and current step by alpha
+     */
+    void testInterpolation()
+    {
+        sad::p2d::Body* b = NULL;
+        sad::p2d::World* w = makeWorldWithMovingBody(1.0, &b);
+        b->setCurrentAngularVelocity(1.0);
+        sad::p2d::WorldStepTask* task = new sad::p2d::WorldStepTask(w, NULL);
+        task->setFixedTimeStep(0.01);
+        task->advance(0.015);
+        ASSERT_TRUE( sad::is_fuzzy_equal(task->interpolationAlpha(), 0.5) );
+        ASSERT_TRUE( sad::is_fuzzy_equal(w->interpolationAlpha(), 0.5) );
+        ASSERT_TRUE( sad::is_fuzzy_equal(b->interpolationAlpha(), 0.5) );
+        ASSERT_TRUE( sad::is_fuzzy_equal(b->previousPosition().x(), 0.0) );
+        ASSERT_TRUE( sad::is_fuzzy_equal(b->position().x(), 0.01) );
+        ASSERT_TRUE( sad::is_fuzzy_equal(b->interpolatedPosition().x(), 0.005) );
+        ASSERT_TRUE( sad::is_fuzzy_equal(b->interpolatedAngle(), 0.005) );
+        delete task;
+    }
+
+    /*! Setting position of body should not make it move smoothly to new position
+     */
+    void testTeleportIsNotInterpolated()
+    {
+        sad::p2d::Body* b = NULL;
+        sad::p2d::World* w = makeWorldWithMovingBody(1.0, &b);
+        sad::p2d::WorldStepTask* task = new sad::p2d::WorldStepTask(w, NULL);
+        task->setFixedTimeStep(0.01);
+        task->advance(0.015);
+        b->setCurrentPosition(sad::p2d::Point(100, 0));
+        ASSERT_TRUE( sad::is_fuzzy_equal(b->interpolatedPosition().x(), 100) );
+        delete task;
+    }
+
+    /*! Same total time gives same simulation, no matter how it's split into frames
+     */
+    void testReproducibleWithDifferentFrameRates()
+    {
+        sad::p2d::Body* b1 = NULL;
+        sad::p2d::Body* b2 = NULL;
+        sad::p2d::World* w1 = makeWorldWithMovingBody(3.0, &b1);
+        sad::p2d::World* w2 = makeWorldWithMovingBody(3.0, &b2);
+        b1->addForce(new sad::p2d::TangentialForce(sad::p2d::Vector(0, -9.8)));
+        b2->addForce(new sad::p2d::TangentialForce(sad::p2d::Vector(0, -9.8)));
+        sad::p2d::WorldStepTask* t1 = new sad::p2d::WorldStepTask(w1, NULL);
+        sad::p2d::WorldStepTask* t2 = new sad::p2d::WorldStepTask(w2, NULL);
+        t1->setFixedTimeStep(1.0 / 60.0);
+        t2->setFixedTimeStep(1.0 / 60.0);
+
+        unsigned int steps1 = 0, steps2 = 0;
+        // 144 FPS against uneven 20-40 FPS
+        for(int i = 0; i < 144; i++)
+        {
+            steps1 += t1->advance(1.0 / 144.0);
+        }
+        double frames[] = { 0.05, 0.025, 0.03, 0.04, 0.03, 0.025 };
+        double total = 0;
+        for(int i = 0; total < 1.0 - 1.0E-9; i = (i + 1) % 6)
+        {
+            double frame = std::min(frames[i], 1.0 - total);
+            total += frame;
+            steps2 += t2->advance(frame);
+        }
+        // Half of step more, so both tasks surely perform same amount of steps, despite rounding errors
+        steps1 += t1->advance(1.0 / 120.0);
+        steps2 += t2->advance(1.0 / 120.0);
+        ASSERT_TRUE( steps1 == 60 );
+        ASSERT_TRUE( steps1 == steps2 );
+        ASSERT_TRUE( b1->position().x() == b2->position().x() );
+        ASSERT_TRUE( b1->position().y() == b2->position().y() );
+        delete t1;
+        delete t2;
+    }
+
+} _fixed_step_test;
@@ -0,0 +1,257 @@
+#pragma warning(push)
+#pragma warning(disable: 4273)
+#pragma warning(disable: 4351)
+#include <stdio.h>
+#include <vector>
+#include <chrono>
+#include "3rdparty/tpunit++/tpunit++.hpp"
+#include <p2d/world.h>
+#include <p2d/circle.h>
+#include "../benchmark.h"
+#pragma warning(pop)
+
+/*! Makes bodies with different velocities and forces, using simple deterministic linear congruental generator.
+    Every seventh body has scheduled position, so it must be stepped as standalone object
+    \param[in] count amount of bodies
+    \return bodies
+ */
+static std::vector<sad::p2d::Body*> makeKinematicBodies(int count)
+{
+    std::vector<sad::p2d::Body*> result;
+    unsigned int seed = 54321;
+    for(int i = 0; i < count; i++)
+    {
+        double v[6];
+        for(int j = 0; j < 6; j++)
+        {
+            seed = seed * 1103515245 + 12345;
+            v[j] = ((seed >> 16) & 0x7FFF) / 32767.0;
+        }
+        sad::p2d::Body* b = new sad::p2d::Body();
+        sad::p2d::Circle* c = new sad::p2d::Circle();
+        c->setRadius(1.0 + v[0]);
+        b->setShape(c);
+        // Same as in world with default detector, so bodies are sampled when caches are built
+        b->setSamplingCount(1);
+        b->setCurrentPosition(sad::p2d::Point(v[1] * 1000.0, v[2] * 1000.0));
+        b->setCurrentTangentialVelocity(sad::p2d::Vector((v[3] - 0.5) * 60.0, (v[4] - 0.5) * 60.0));
+        b->setCurrentAngularVelocity(v[5] - 0.5);
+        if (i % 2 == 0)
+        {
+            b->addForce(new sad::p2d::TangentialForce(sad::p2d::Vector(0, -9.8)));
+        }
+        if (i % 3 == 0)
+        {
+            b->addForce(new sad::p2d::AngularForce(0.25));
+        }
+        if (i % 5 == 0)
+        {
+            b->addForce(new sad::p2d::TangentialImpulseForce(sad::p2d::Vector(3.0, 1.0)));
+        }
+        if (i % 7 == 0)
+        {
+            b->shedulePosition(sad::p2d::Point(v[2] * 1000.0, v[1] * 1000.0));
+        }
+        b->addRef();
+        result.push_back(b);
+    }
+    return result;
+}
+
+/*! Steps bodies one by one, as it was done before kinematic state was introduced
+    \param[in] bodies a bodies
+    \param[in] time_step a time step
+ */
+static void stepStandaloneBodies(std::vector<sad::p2d::Body*>& bodies, double time_step)
+{
+    for(size_t i = 0; i < bodies.size(); i++)
+    {
+        bodies[i]->buildCaches(time_step);
+    }
+    for(size_t i = 0; i < bodies.size(); i++)
+    {
+        bodies[i]->stepPositionsAndVelocities(time_step);
+    }
+    for(size_t i = 0; i < bodies.size(); i++)
+    {
+        bodies[i]->stepDiscreteChangingValues(time_step);
+    }
+}
+
+/*! Releases bodies
+    \param[in] bodies a bodies
+ */
+static void releaseBodies(std::vector<sad::p2d::Body*>& bodies)
+{
+    for(size_t i = 0; i < bodies.size(); i++)
+    {
+        bodies[i]->delRef();
+    }
+    bodies.clear();
+}
+
+/*! Tests, whether bodies have same positions, velocities and shapes
+    \param[in] a first list
+    \param[in] b second list
+    \return whether they are same
+ */
+static bool sameKinematics(const std::vector<sad::p2d::Body*>& a, const std::vector<sad::p2d::Body*>& b)
+{
+    bool result = a.size() == b.size();
+    for(size_t i = 0; i < a.size() && result; i++)
+    {
+        result = result
+            && a[i]->position().x() == b[i]->position().x()
+            && a[i]->position().y() == b[i]->position().y()
+            && a[i]->tangentialVelocity().x() == b[i]->tangentialVelocity().x()
+            && a[i]->tangentialVelocity().y() == b[i]->tangentialVelocity().y()
+            && a[i]->angle() == b[i]->angle()
+            && a[i]->angularVelocity() == b[i]->angularVelocity()
+            && a[i]->currentShape()->center().x() == b[i]->currentShape()->center().x()
+            && a[i]->currentShape()->center().y() == b[i]->currentShape()->center().y();
+    }
+    return result;
+}
+
+/*!
+ * Tests packed kinematic state of world
+ */
+struct KinematicStateTest : tpunit::TestFixture
+{
+ public:
+    KinematicStateTest() : tpunit::TestFixture(
+        TEST(KinematicStateTest::testEquivalence),
+        TEST(KinematicStateTest::testBindingAndUnbinding),
+        TEST(KinematicStateTest::testBodyInTwoWorlds)
+    ) {}
+
+    void testEquivalence()
+    {
+        std::vector<sad::p2d::Body*> expected = makeKinematicBodies(500);
+        std::vector<sad::p2d::Body*> actual = makeKinematicBodies(500);
+        sad::p2d::World* w = new sad::p2d::World();
+        for(size_t i = 0; i < actual.size(); i++)
+        {
+            w->addBody(actual[i]);
+        }
+        for(int step = 0; step < 20; step++)
+        {
+            if (step == 10)
+            {
+                expected[3]->sheduleTangentialVelocity(sad::p2d::Vector(1.0, 2.0));
+                actual[3]->sheduleTangentialVelocity(sad::p2d::Vector(1.0, 2.0));
+            }
+            stepStandaloneBodies(expected, 0.1);
+            w->step(0.1);
+        }
+        ASSERT_TRUE( actual[3]->tangentialVelocity().x() != 0 );
+        ASSERT_TRUE( sameKinematics(expected, actual) );
+        delete w;
+        releaseBodies(expected);
+        releaseBodies(actual);
+    }
+
+    void testBindingAndUnbinding()
+    {
+        sad::p2d::World* w = new sad::p2d::World();
+        sad::p2d::Body* b = new sad::p2d::Body();
+        b->addRef();
+        b->setCurrentPosition(sad::p2d::Point(10, 20));
+        b->setCurrentTangentialVelocity(sad::p2d::Vector(1, 0));
+        w->addBody(b);
+        ASSERT_TRUE( b->kinematicState() != NULL );
+        ASSERT_TRUE( sad::is_fuzzy_equal(b->position().x(), 10) );
+        w->step(1.0);
+        ASSERT_TRUE( sad::is_fuzzy_equal(b->position().x(), 11) );
+        w->removeBody(b);
+        ASSERT_TRUE( b->kinematicState() == NULL );
+        ASSERT_TRUE( sad::is_fuzzy_equal(b->position().x(), 11) );
+        ASSERT_TRUE( sad::is_fuzzy_equal(b->position().y(), 20) );
+        ASSERT_TRUE( sad::is_fuzzy_equal(b->tangentialVelocity().x(), 1) );
+        w->addBody(b);
+        w->step(1.0);
+        delete w;
+        ASSERT_TRUE( b->kinematicState() == NULL );
+        ASSERT_TRUE( sad::is_fuzzy_equal(b->position().x(), 12) );
+        b->delRef();
+    }
+
+    void testBodyInTwoWorlds()
+    {
+        sad::p2d::World* w1 = new sad::p2d::World();
+        sad::p2d::World* w2 = new sad::p2d::World();
+        sad::p2d::Body* b = new sad::p2d::Body();
+        b->addRef();
+        b->setCurrentTangentialVelocity(sad::p2d::Vector(1, 0));
+        w1->addBody(b);
+        w2->addBody(b);
+        w2->step(1.0);
+        w1->step(1.0);
+        ASSERT_TRUE( sad::is_fuzzy_equal(b->position().x(), 2) );
+        delete w1;
+        w2->step(1.0);
+        ASSERT_TRUE( sad::is_fuzzy_equal(b->position().x(), 3) );
+        delete w2;
+        b->delRef();
+    }
+
+} _kinematic_state_test;
+
+/*! Prints time of integrating 10000 bodies with packed kinematic state and one by one.
+    Caches are built outside of measured time, since they are same for both
+ */
+static void benchmarkKinematicState()
+{
+    const int steps = 20;
+    std::vector<sad::p2d::Body*> standalone = makeKinematicBodies(10000);
+    std::vector<sad::p2d::Body*> packed = makeKinematicBodies(10000);
+    sad::p2d::KinematicState state;
+    for(size_t i = 0; i < packed.size(); i++)
+    {
+        state.bind(i, packed[i]);
+    }
+
+    double per_object = 0;
+    double packed_time = 0;
+    double integration_time = 0;
+    for(int step = 0; step < steps; step++)
+    {
+        for(size_t i = 0; i < standalone.size(); i++)
+        {
+            standalone[i]->buildCaches(0.1);
+            packed[i]->buildCaches(0.1);
+        }
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for(size_t i = 0; i < standalone.size(); i++)
+        {
+            standalone[i]->stepPositionsAndVelocities(0.1);
+        }
+        per_object += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        state.integrate(0.1);
+        integration_time += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        for(size_t i = 0; i < packed.size(); i++)
+        {
+            packed[i]->stepPositionsAndVelocities(0.1);
+        }
+        packed_time += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        for(size_t i = 0; i < standalone.size(); i++)
+        {
+            standalone[i]->stepDiscreteChangingValues(0.1);
+            packed[i]->stepDiscreteChangingValues(0.1);
+        }
+    }
+
+    printf("Integration of 10000 bodies, %d steps:\n", steps);
+    printf("per-object: %8.2f ms (%.3f ms/step)\n", per_object, per_object / steps);
+    printf("packed:     %8.2f ms (%.3f ms/step), speedup %.2fx\n", packed_time, packed_time / steps, per_object / packed_time);
+    printf("  of them vectorized loop: %8.2f ms, rest is notifying shapes of bodies\n", integration_time);
+    state.clear();
+    releaseBodies(standalone);
+    releaseBodies(packed);
+}
+
+static benchmark::Registrar _kinematic_state_benchmark("Packed kinematic state", benchmarkKinematicState);
@@ -0,0 +1,84 @@
+#pragma warning(push)
+#pragma warning(disable: 4273)
+#pragma warning(disable: 4351)
+#include <stdio.h>
+#include <vector>
+#include <thread>
+#include "3rdparty/tpunit++/tpunit++.hpp"
+#include "worldsimulation.h"
+#include "../benchmark.h"
+#pragma warning(pop)
+
+
+/*!
+ * Tests parallel narrow phase for equivalence with single-threaded one
+ */
+struct ParallelNarrowPhaseTest : tpunit::TestFixture
+{
+ public:
+    ParallelNarrowPhaseTest() : tpunit::TestFixture(
+        TEST(ParallelNarrowPhaseTest::testBruteForce),
+        TEST(ParallelNarrowPhaseTest::testBroadPhase),
+        TEST(ParallelNarrowPhaseTest::testSwitchingThreadCount)
+    ) {}
+
+    void testBruteForce()
+    {
+        std::vector<p2dsimulation::BodyDescription> d = p2dsimulation::generateBodies(300);
+        std::vector<p2dsimulation::RecordedEvent> expected = p2dsimulation::simulate(d, NULL, 5);
+        ASSERT_TRUE( expected.size() > 0 );
+        for(size_t threads = 2; threads <= 8; threads *= 2)
+        {
+            std::vector<p2dsimulation::RecordedEvent> actual = p2dsimulation::simulate(d, NULL, 5, threads);
+            ASSERT_TRUE( expected == actual );
+        }
+    }
+
+    void testBroadPhase()
+    {
+        std::vector<p2dsimulation::BodyDescription> d = p2dsimulation::generateBodies(300);
+        std::vector<p2dsimulation::RecordedEvent> expected = p2dsimulation::simulate(d, NULL, 5);
+        ASSERT_TRUE( expected.size() > 0 );
+        for(size_t threads = 2; threads <= 8; threads *= 2)
+        {
+            std::vector<p2dsimulation::RecordedEvent> actual = p2dsimulation::simulate(d, new sad::p2d::SweepAndPruneBroadPhase(), 5, threads);
+            ASSERT_TRUE( expected == actual );
+        }
+    }
+
+    void testSwitchingThreadCount()
+    {
+        sad::p2d::World* w = new sad::p2d::World();
+        ASSERT_TRUE( w->narrowPhaseThreadCount() == 1 );
+        w->setNarrowPhaseThreadCount(4);
+        ASSERT_TRUE( w->narrowPhaseThreadCount() == 4 );
+        w->step(0.1);
+        w->setNarrowPhaseThreadCount(0);
+        ASSERT_TRUE( w->narrowPhaseThreadCount() == 1 );
+        w->step(0.1);
+        delete w;
+    }
+
+} _parallel_narrow_phase_test;
+
+/*! Prints time of stepping a world with 1..N threads, where N is amount of hardware threads
+ */
+static void benchmarkParallelNarrowPhase()
+{
+    std::vector<p2dsimulation::BodyDescription> d = p2dsimulation::generateBodies(400, 800.0);
+    size_t max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    double single_threaded = 0;
+    printf("Parallel narrow phase, 400 bodies, 3 steps, no broad phase:\n");
+    for(size_t threads = 1; threads <= max_threads; threads++)
+    {
+        double elapsed = 0;
+        p2dsimulation::simulate(d, NULL, 3, threads, &elapsed);
+        if (threads == 1)
+        {
+            single_threaded = elapsed;
+        }
+        printf("%2d thread(s): %8.2f ms, speedup %.2fx\n", static_cast<int>(threads), elapsed, single_threaded / elapsed);
+    }
+}
+
+static benchmark::Registrar _parallel_narrow_phase_benchmark("Parallel narrow phase", benchmarkParallelNarrowPhase);
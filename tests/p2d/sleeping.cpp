@@ -0,0 +1,323 @@
+#pragma warning(push)
+#pragma warning(disable: 4273)
+#pragma warning(disable: 4351)
+#include <stdio.h>
+#include <chrono>
+#include "3rdparty/tpunit++/tpunit++.hpp"
+#include <p2d/world.h>
+#include <p2d/circle.h>
+#include "../benchmark.h"
+#pragma warning(pop)
+
+/*! Makes circle body at specified position with specified velocity
+    \param[in] x an x position
+    \param[in] y an y position
+    \param[in] vx a horizontal velocity
+    \return body
+ */
+static sad::p2d::Body* makeSleepingTestBody(double x, double y, double vx)
+{
+    sad::p2d::Body* b = new sad::p2d::Body();
+    sad::p2d::Circle* c = new sad::p2d::Circle();
+    c->setRadius(1.0);
+    b->setShape(c);
+    b->setCurrentPosition(sad::p2d::Point(x, y));
+    b->setCurrentTangentialVelocity(sad::p2d::Vector(vx, 0.0));
+    return b;
+}
+
+/*!
+ * Tests putting resting bodies to sleep and waking them up
+ */
+struct SleepingTest : tpunit::TestFixture
+{
+ public:
+    SleepingTest() : tpunit::TestFixture(
+        TEST(SleepingTest::testDisabledByDefault),
+        TEST(SleepingTest::testFallsAsleep),
+        TEST(SleepingTest::testMovingBodyDoesNotSleep),
+        TEST(SleepingTest::testWakeUpByForce),
+        TEST(SleepingTest::testWakeUpByMoving),
+        TEST(SleepingTest::testWakeUpByCollision),
+        TEST(SleepingTest::testSleepingPairIsNotTested),
+        TEST(SleepingTest::testDisablingWakesUp),
+        TEST(SleepingTest::testWakeUpWhenSupportIsRemoved),
+        TEST(SleepingTest::testWakeUpWhenSupportIsMoved)
+    ) {}
+
+    int events;
+    bool awake_in_handler;
+
+    void countEvent(const sad::p2d::BasicCollisionEvent& ev)
+    {
+        ++events;
+        awake_in_handler = !(ev.m_object_1->isSleeping()) && !(ev.m_object_2->isSleeping());
+    }
+
+    /*! Without enabling sleeping, bodies never fall asleep
+     */
+    void testDisabledByDefault()
+    {
+        sad::p2d::World* w = new sad::p2d::World();
+        w->addBody(makeSleepingTestBody(0, 0, 0));
+        ASSERT_FALSE( w->isSleepingEnabled() );
+        for(int i = 0; i < 100; i++)
+        {
+            w->step(0.1);
+        }
+        ASSERT_TRUE( w->sleepingBodyCount() == 0 );
+        ASSERT_TRUE( w->awakeBodyCount() == 1 );
+        delete w;
+    }
+
+    /*! Resting body falls asleep after specified amount of steps
+     */
+    void testFallsAsleep()
+    {
+        sad::p2d::World* w = new sad::p2d::World();
+        w->setSleepingEnabled(true);
+        w->setSleepThresholds(0.5, 0.1);
+        w->setStepsBeforeSleep(5);
+        sad::p2d::Body* b = makeSleepingTestBody(0, 0, 0.2);
+        w->addBody(b);
+        w->addBody(makeSleepingTestBody(10, 0, 3.0));
+        for(int i = 0; i < 4; i++)
+        {
+            w->step(0.1);
+        }
+        ASSERT_FALSE( b->isSleeping() );
+        w->step(0.1);
+        ASSERT_TRUE( b->isSleeping() );
+        ASSERT_TRUE( w->sleepingBodyCount() == 1 );
+        ASSERT_TRUE( w->awakeBodyCount() == 1 );
+        // Sleeping body is stopped and not moved anymore
+        ASSERT_TRUE( sad::is_fuzzy_zero(b->tangentialVelocity().x()) );
+        double x = b->position().x();
+        w->step(0.1);
+        ASSERT_TRUE( sad::is_fuzzy_equal(b->position().x(), x) );
+        delete w;
+    }
+
+    /*! Body, which moves faster than threshold or can't sleep, stays awake
+     */
+    void testMovingBodyDoesNotSleep()
+    {
+        sad::p2d::World* w = new sad::p2d::World();
+        w->setSleepingEnabled(true);
+        w->setStepsBeforeSleep(5);
+        sad::p2d::Body* moving = makeSleepingTestBody(0, 0, 3.0);
+        sad::p2d::Body* insomniac = makeSleepingTestBody(0, 10, 0.0);
+        insomniac->setCanSleep(false);
+        w->addBody(moving);
+        w->addBody(insomniac);
+        for(int i = 0; i < 20; i++)
+        {
+            w->step(0.1);
+        }
+        ASSERT_FALSE( moving->isSleeping() );
+        ASSERT_FALSE( insomniac->isSleeping() );
+        delete w;
+    }
+
+    /*! Adding a force wakes body up
+     */
+    void testWakeUpByForce()
+    {
+        sad::p2d::World* w = new sad::p2d::World();
+        w->setSleepingEnabled(true);
+        w->setStepsBeforeSleep(1);
+        sad::p2d::Body* b = makeSleepingTestBody(0, 0, 0);
+        w->addBody(b);
+        w->step(0.1);
+        ASSERT_TRUE( b->isSleeping() );
+        b->addForce(new sad::p2d::TangentialForce(sad::p2d::Vector(100, 0)));
+        ASSERT_FALSE( b->isSleeping() );
+        w->step(0.1);
+        ASSERT_FALSE( b->isSleeping() );
+        ASSERT_TRUE( b->position().x() > 0.1 );
+        delete w;
+    }
+
+    /*! Moving body by script wakes it up
+     */
+    void testWakeUpByMoving()
+    {
+        sad::p2d::World* w = new sad::p2d::World();
+        w->setSleepingEnabled(true);
+        w->setStepsBeforeSleep(1);
+        sad::p2d::Body* b = makeSleepingTestBody(0, 0, 0);
+        w->addBody(b);
+        w->step(0.1);
+        ASSERT_TRUE( b->isSleeping() );
+        b->setCurrentTangentialVelocity(sad::p2d::Vector(5, 0));
+        ASSERT_FALSE( b->isSleeping() );
+        w->step(0.1);
+        ASSERT_TRUE( sad::is_fuzzy_equal(b->position().x(), 0.5) );
+
+        w->step(0.1);
+        b->setCurrentTangentialVelocity(sad::p2d::Vector(0, 0));
+        w->step(0.1);
+        ASSERT_TRUE( b->isSleeping() );
+        b->move(sad::p2d::Vector(1, 0));
+        ASSERT_FALSE( b->isSleeping() );
+        delete w;
+    }
+
+    /*! Sleeping body, hit by awake body, is woken up and handler is invoked
+     */
+    void testWakeUpByCollision()
+    {
+        events = 0;
+        awake_in_handler = false;
+        sad::p2d::World* w = new sad::p2d::World();
+        w->setSleepingEnabled(true);
+        w->setStepsBeforeSleep(1);
+        w->addHandler(this, &SleepingTest::countEvent);
+        sad::p2d::Body* sleeping = makeSleepingTestBody(6, 0, 0);
+        sad::p2d::Body* moving = makeSleepingTestBody(0, 0, 3.0);
+        w->addBody(sleeping);
+        w->addBody(moving);
+        w->step(1.0);
+        ASSERT_TRUE( sleeping->isSleeping() );
+        ASSERT_TRUE( events == 0 );
+        w->step(1.0);
+        ASSERT_TRUE( events == 1 );
+        ASSERT_TRUE( awake_in_handler );
+        delete w;
+    }
+
+    /*! Overlapping sleeping bodies are not reported as colliding
+     */
+    void testSleepingPairIsNotTested()
+    {
+        events = 0;
+        sad::p2d::World* w = new sad::p2d::World();
+        w->setSleepingEnabled(true);
+        w->addHandler(this, &SleepingTest::countEvent);
+        sad::p2d::Body* b1 = makeSleepingTestBody(0, 0, 0);
+        sad::p2d::Body* b2 = makeSleepingTestBody(1, 0, 0);
+        w->addBody(b1);
+        w->addBody(b2);
+        w->step(0.1);
+        ASSERT_TRUE( events == 1 );
+        b1->sleep();
+        b2->sleep();
+        w->step(0.1);
+        ASSERT_TRUE( events == 1 );
+        ASSERT_TRUE( w->sleepingBodyCount() == 2 );
+        delete w;
+    }
+
+    /*! Disabling sleeping wakes all bodies up
+     */
+    void testDisablingWakesUp()
+    {
+        sad::p2d::World* w = new sad::p2d::World();
+        w->setSleepingEnabled(true);
+        w->setStepsBeforeSleep(1);
+        w->addBody(makeSleepingTestBody(0, 0, 0));
+        w->addBody(makeSleepingTestBody(0, 10, 0));
+        w->step(0.1);
+        ASSERT_TRUE( w->sleepingBodyCount() == 2 );
+        w->setSleepingEnabled(false);
+        ASSERT_TRUE( w->sleepingBodyCount() == 0 );
+        ASSERT_TRUE( w->awakeBodyCount() == 2 );
+        delete w;
+    }
+
+    /*! Removing a body wakes up stack of bodies, resting on it, but not bodies far from it
+     */
+    void testWakeUpWhenSupportIsRemoved()
+    {
+        sad::p2d::World* w = new sad::p2d::World();
+        w->setSleepingEnabled(true);
+        w->setStepsBeforeSleep(1);
+        sad::p2d::Body* support = makeSleepingTestBody(0, 0, 0);
+        sad::p2d::Body* lower = makeSleepingTestBody(0, 2.5, 0);
+        sad::p2d::Body* upper = makeSleepingTestBody(0, 5.0, 0);
+        sad::p2d::Body* far = makeSleepingTestBody(20, 0, 0);
+        w->addBody(support);
+        w->addBody(lower);
+        w->addBody(upper);
+        w->addBody(far);
+        w->step(0.1);
+        ASSERT_TRUE( w->sleepingBodyCount() == 4 );
+
+        // Woken bodies don't move, so they shouldn't fall asleep in same step
+        w->setStepsBeforeSleep(5);
+        w->removeBody(support);
+        w->step(0.1);
+        ASSERT_FALSE( lower->isSleeping() );
+        ASSERT_FALSE( upper->isSleeping() );
+        ASSERT_TRUE( far->isSleeping() );
+        delete w;
+    }
+
+    /*! Moving an awake body by script wakes up bodies, resting on it
+     */
+    void testWakeUpWhenSupportIsMoved()
+    {
+        sad::p2d::World* w = new sad::p2d::World();
+        w->setSleepingEnabled(true);
+        w->setStepsBeforeSleep(1);
+        sad::p2d::Body* support = makeSleepingTestBody(0, 0, 0);
+        support->setCanSleep(false);
+        sad::p2d::Body* resting = makeSleepingTestBody(0, 2.5, 0);
+        sad::p2d::Body* far = makeSleepingTestBody(20, 0, 0);
+        w->addBody(support);
+        w->addBody(resting);
+        w->addBody(far);
+        w->step(0.1);
+        ASSERT_FALSE( support->isSleeping() );
+        ASSERT_TRUE( resting->isSleeping() );
+
+        // Moving support without waking neighbours would leave resting body hanging in the air
+        w->setStepsBeforeSleep(5);
+        support->move(sad::p2d::Vector(0, -10));
+        w->step(0.1);
+        ASSERT_FALSE( resting->isSleeping() );
+        ASSERT_TRUE( far->isSleeping() );
+        delete w;
+    }
+
+} _sleeping_test;
+
+/*! Prints time of stepping a world with resting bodies, when they are awake and when they are sleeping
+ */
+static void benchmarkSleeping()
+{
+    const int side = 20;
+    const int steps = 20;
+    double times[2];
+    int events = 0;
+    std::function<void(const sad::p2d::BasicCollisionEvent&)> f = [&events](const sad::p2d::BasicCollisionEvent&) {
+        ++events;
+    };
+    for(int mode = 0; mode < 2; mode++)
+    {
+        sad::p2d::World* w = new sad::p2d::World();
+        w->addHandler(f);
+        w->setSleepingEnabled(mode == 1);
+        w->setStepsBeforeSleep(1);
+        for(int i = 0; i < side; i++)
+        {
+            for(int j = 0; j < side; j++)
+            {
+                w->addBody(makeSleepingTestBody(i * 5.0, j * 5.0, 0));
+            }
+        }
+        w->step(0.1);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for(int i = 0; i < steps; i++)
+        {
+            w->step(0.1);
+        }
+        times[mode] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        delete w;
+    }
+    printf("Stepping %d resting bodies, %d steps:\n", side * side, steps);
+    printf("awake:    %8.2f ms (%.3f ms/step)\n", times[0], times[0] / steps);
+    printf("sleeping: %8.2f ms (%.3f ms/step), speedup %.2fx\n", times[1], times[1] / steps, times[0] / times[1]);
+}
+
+static benchmark::Registrar _sleeping_benchmark("Sleeping bodies", benchmarkSleeping);
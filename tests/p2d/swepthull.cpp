@@ -0,0 +1,176 @@
+#pragma warning(push)
+#pragma warning(disable: 4273)
+#pragma warning(disable: 4351)
+#include <stdio.h>
+#include <vector>
+#include <chrono>
+#include "3rdparty/tpunit++/tpunit++.hpp"
+#include "worldsimulation.h"
+#include <p2d/broadcollisiondetector.h>
+#include <p2d/convexhull.h>
+#include "../benchmark.h"
+#pragma warning(pop)
+
+/*! Makes world with broad collision detector and moving bodies, generated from descriptions.
+    Caches of bodies are built with specified step
+    \param[in] d descriptions of bodies
+    \param[in] step a time step for caches
+    \param[out] bodies created bodies
+    \return a world
+ */
+static sad::p2d::World* makeSweptHullWorld(
+    const std::vector<p2dsimulation::BodyDescription>& d,
+    double step,
+    std::vector<sad::p2d::Body*>& bodies
+)
+{
+    sad::p2d::World* w = new sad::p2d::World();
+    w->setDetector(new sad::p2d::BroadCollisionDetector());
+    for(size_t i = 0; i < d.size(); i++)
+    {
+        if (d[i].Kind == 2)
+        {
+            continue;
+        }
+        sad::p2d::Body* b = new sad::p2d::Body();
+        if (d[i].Kind == 0)
+        {
+            sad::p2d::Circle* c = new sad::p2d::Circle();
+            c->setRadius(d[i].Size);
+            b->setShape(c);
+        }
+        else
+        {
+            sad::p2d::Rectangle* r = new sad::p2d::Rectangle();
+            r->setRect(sad::Rect2D(-d[i].Size, -d[i].Size, d[i].Size, d[i].Size));
+            b->setShape(r);
+        }
+        b->setCurrentPosition(sad::p2d::Point(d[i].X, d[i].Y));
+        b->setCurrentTangentialVelocity(sad::p2d::Vector(d[i].VX, d[i].VY));
+        w->addBody(b);
+        b->buildCaches(step);
+        bodies.push_back(b);
+    }
+    return w;
+}
+
+/*! Builds convex hull of swept shape of body from scratch, like detector did without caching
+    \param[in] b body
+    \return hull
+ */
+static sad::p2d::ConvexHull buildFreshSweptHull(sad::p2d::Body* b)
+{
+    sad::p2d::ConvexHull s;
+    s.insertPointsFromShape(b->currentShape());
+    s.insertPointsFromShape(b->Temporary);
+    s.buildHull();
+    return s;
+}
+
+/*!
+ * Tests caching of swept hulls of bodies, used by broad collision detector
+ */
+struct SweptHullTest : tpunit::TestFixture
+{
+ public:
+    SweptHullTest() : tpunit::TestFixture(
+        TEST(SweptHullTest::testHullIsCachedUntilBuildCaches),
+        TEST(SweptHullTest::testDetectorMatchesFreshHulls)
+    ) {}
+
+    /*! Hull contains start and end of movement and is rebuilt, when caches are rebuilt
+     */
+    void testHullIsCachedUntilBuildCaches()
+    {
+        sad::p2d::World* w = new sad::p2d::World();
+        sad::p2d::Body* b = new sad::p2d::Body();
+        sad::p2d::Circle* c = new sad::p2d::Circle();
+        c->setRadius(1.0);
+        b->setShape(c);
+        b->setCurrentTangentialVelocity(sad::p2d::Vector(10, 0));
+        w->addBody(b);
+        b->buildCaches(1.0);
+
+        const sad::p2d::ConvexHull& hull = b->sweptHull();
+        sad::p2d::Cutter1D projection = hull.project(sad::p2d::Axle(1, 0));
+        ASSERT_TRUE( sad::is_fuzzy_equal(projection.p1(), -1.0, 0.1) );
+        ASSERT_TRUE( sad::is_fuzzy_equal(projection.p2(), 11.0, 0.1) );
+        ASSERT_TRUE( &hull == &(b->sweptHull()) );
+
+        // Changing velocity rebuilds caches, so hull should be rebuilt too
+        b->setCurrentTangentialVelocity(sad::p2d::Vector(0, 0));
+        projection = b->sweptHull().project(sad::p2d::Axle(1, 0));
+        ASSERT_TRUE( sad::is_fuzzy_equal(projection.p2(), 1.0, 0.1) );
+        delete w;
+    }
+
+    /*! Detector with cached hulls gives same results as one, which builds hulls for every pair
+     */
+    void testDetectorMatchesFreshHulls()
+    {
+        std::vector<p2dsimulation::BodyDescription> d = p2dsimulation::generateBodies(150, 200.0);
+        std::vector<sad::p2d::Body*> bodies;
+        // Step is large enough for detector to always test hulls, not falling back to simple detector
+        sad::p2d::World* w = makeSweptHullWorld(d, 1.0, bodies);
+        sad::p2d::BroadCollisionDetector detector;
+        detector.prepare();
+        int collisions = 0;
+        bool all_matched = true;
+        for(size_t i = 0; i < bodies.size(); i++)
+        {
+            for(size_t j = i + 1; j < bodies.size(); j++)
+            {
+                bool expected = buildFreshSweptHull(bodies[i]).collides(buildFreshSweptHull(bodies[j]));
+                bool actual = detector.collides(bodies[i], bodies[j], 1.0).exists();
+                all_matched = all_matched && (expected == actual);
+                collisions += actual ? 1 : 0;
+            }
+        }
+        ASSERT_TRUE( all_matched );
+        ASSERT_TRUE( collisions > 0 );
+        delete w;
+    }
+
+} _swept_hull_test;
+
+/*! Prints time of testing all pairs of bodies, when hulls are built for every pair and when they
+    are cached per body
+ */
+static void benchmarkSweptHull()
+{
+    std::vector<p2dsimulation::BodyDescription> d = p2dsimulation::generateBodies(300);
+    std::vector<sad::p2d::Body*> bodies;
+    sad::p2d::World* w = makeSweptHullWorld(d, 1.0, bodies);
+    sad::p2d::BroadCollisionDetector detector;
+    detector.prepare();
+
+    int fresh_collisions = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < bodies.size(); i++)
+    {
+        for(size_t j = i + 1; j < bodies.size(); j++)
+        {
+            fresh_collisions += buildFreshSweptHull(bodies[i]).collides(buildFreshSweptHull(bodies[j])) ? 1 : 0;
+        }
+    }
+    double fresh = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    int cached_collisions = 0;
+    start = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < bodies.size(); i++)
+    {
+        for(size_t j = i + 1; j < bodies.size(); j++)
+        {
+            cached_collisions += detector.collides(bodies[i], bodies[j], 1.0).exists() ? 1 : 0;
+        }
+    }
+    double cached = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    size_t pairs = bodies.size() * (bodies.size() - 1) / 2;
+    printf("Testing %d pairs of swept hulls:\n", static_cast<int>(pairs));
+    printf("hull per pair: %8.2f ms\n", fresh);
+    printf("hull per body: %8.2f ms, speedup %.2fx\n", cached, fresh / cached);
+    delete w;
+}
+
+static benchmark::Registrar _swept_hull_benchmark("Swept hulls", benchmarkSweptHull);
@@ -0,0 +1,166 @@
+#pragma once
+#include <map>
+#include <vector>
+#include <chrono>
+#include <p2d/world.h>
+#include <p2d/circle.h>
+#include <p2d/rectangle.h>
+#include <p2d/bounds.h>
+
+
+namespace p2dsimulation
+{
+
+/*! A description of body, used to build same bodies in different worlds
+ */
+struct BodyDescription
+{
+    int Kind;           //!< 0 - circle, 1 - rectangle, 2 - bound
+    double X;           //!< X position
+    double Y;           //!< Y position
+    double VX;          //!< Horizontal velocity
+    double VY;          //!< Vertical velocity
+    double Size;        //!< Radius or half-side
+    int Group;          //!< 0 - first group, 1 - second group, 2 - both groups
+};
+
+/*! A recorded event as indexes of bodies and time
+ */
+struct RecordedEvent
+{
+    int First;     //!< Index of first body
+    int Second;    //!< Index of second body
+    double Time;   //!< Time of event
+
+    bool operator==(const RecordedEvent& o) const
+    {
+        return First == o.First && Second == o.Second && sad::is_fuzzy_equal(Time, o.Time);
+    }
+};
+
+/*! Generates bodies, using simple deterministic linear congruental generator
+    \param[in] count amount of bodies
+    \param[in] area a size of area, where bodies are placed
+    \return descriptions
+ */
+inline std::vector<BodyDescription> generateBodies(int count, double area = 400.0)
+{
+    std::vector<BodyDescription> result;
+    unsigned int seed = 12345;
+    for(int i = 0; i < count; i++)
+    {
+        double v[6];
+        for(int j = 0; j < 6; j++)
+        {
+            seed = seed * 1103515245 + 12345;
+            v[j] = ((seed >> 16) & 0x7FFF) / 32767.0;
+        }
+        BodyDescription d;
+        d.Kind = (v[0] < 0.5) ? 0 : 1;
+        d.X = v[1] * area;
+        d.Y = v[2] * area;
+        d.VX = (v[3] - 0.5) * 60.0;
+        d.VY = (v[4] - 0.5) * 60.0;
+        d.Size = 2.0 + v[5] * 8.0;
+        d.Group = i % 3;
+        result.push_back(d);
+    }
+    // Add bound to make sure, that unbounded bodies are handled
+    BodyDescription bound;
+    bound.Kind = 2;
+    bound.X = 0;
+    bound.Y = 0;
+    bound.VX = 0;
+    bound.VY = 0;
+    bound.Size = 20.0;
+    bound.Group = 1;
+    result.push_back(bound);
+    return result;
+}
+
+/*! Runs simulation with specified broad phase and records events
+    \param[in] d descriptions of bodies
+    \param[in] p broad phase (NULL for brute-force)
+    \param[in] steps amount of steps
+    \param[in] threads amount of threads for narrow phase
+    \param[out] elapsed if not NULL, time of stepping world in milliseconds is stored here
+    \return recorded events
+ */
+inline std::vector<RecordedEvent> simulate(
+    const std::vector<BodyDescription>& d,
+    sad::p2d::BroadPhase* p,
+    int steps,
+    size_t threads = 1,
+    double* elapsed = NULL
+)
+{
+    sad::p2d::World* w = new sad::p2d::World();
+    w->setDetector(new sad::p2d::BroadCollisionDetector());
+    w->setBroadPhase(p);
+    w->setNarrowPhaseThreadCount(threads);
+    w->addGroup("first");
+    w->addGroup("second");
+
+    std::map<sad::p2d::Body*, int> indexes;
+    for(size_t i = 0; i < d.size(); i++)
+    {
+        sad::p2d::Body* b = new sad::p2d::Body();
+        if (d[i].Kind == 0)
+        {
+            sad::p2d::Circle* c = new sad::p2d::Circle();
+            c->setRadius(d[i].Size);
+            b->setShape(c);
+        }
+        if (d[i].Kind == 1)
+        {
+            sad::p2d::Rectangle* r = new sad::p2d::Rectangle();
+            r->setRect(sad::Rect2D(-d[i].Size, -d[i].Size, d[i].Size, d[i].Size));
+            b->setShape(r);
+        }
+        if (d[i].Kind == 2)
+        {
+            sad::p2d::Bound* bound = new sad::p2d::Bound();
+            bound->setType(sad::p2d::BT_DOWN);
+            bound->setPosition(d[i].Size);
+            b->setShape(bound);
+        }
+        if (d[i].Kind != 2)
+        {
+            b->setCurrentPosition(sad::p2d::Point(d[i].X, d[i].Y));
+            b->setCurrentTangentialVelocity(sad::p2d::Vector(d[i].VX, d[i].VY));
+        }
+        indexes[b] = static_cast<int>(i);
+        if (d[i].Group == 0 || d[i].Group == 2)
+        {
+            w->addBodyToGroup("first", b);
+        }
+        if (d[i].Group == 1 || d[i].Group == 2)
+        {
+            w->addBodyToGroup("second", b);
+        }
+    }
+
+    std::vector<RecordedEvent> result;
+    std::function<void(const sad::p2d::BasicCollisionEvent&)> f = [&result, &indexes](const sad::p2d::BasicCollisionEvent& ev) {
+        RecordedEvent e;
+        e.First = indexes[ev.m_object_1];
+        e.Second = indexes[ev.m_object_2];
+        e.Time = ev.m_time;
+        result.push_back(e);
+    };
+    w->addHandler("first", "second", f);
+    w->addHandler("first", "first", f);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(int i = 0; i < steps; i++)
+    {
+        w->step(0.1);
+    }
+    if (elapsed)
+    {
+        *elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    delete w;
+    return result;
+}
+
+}
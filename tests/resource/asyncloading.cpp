@@ -0,0 +1,176 @@
+#pragma warning(push)
+#pragma warning(disable: 4273)
+#pragma warning(disable: 4351)
+#include <cstdio>
+
+#include "resource/tree.h"
+#include "resource/asyncloading.h"
+
+#include "util/free.h"
+#include "texture.h"
+
+#include "renderer.h"
+
+#define _INC_STDIO
+#include "3rdparty/tpunit++/tpunit++.hpp"
+#pragma warning(pop)
+
+#include "counterrorsoftype.h"
+
+/*!
+ * Tests sad::resource::AsyncLoading
+ */
+struct SadAsyncLoadingTest : tpunit::TestFixture
+{
+ public:
+   SadAsyncLoadingTest() : tpunit::TestFixture(
+       TEST(SadAsyncLoadingTest::testLoadFileNotExists),
+       TEST(SadAsyncLoadingTest::testEmpty),
+       TEST(SadAsyncLoadingTest::testValid),
+       TEST(SadAsyncLoadingTest::testLoadingFailure),
+       TEST(SadAsyncLoadingTest::testDuplicates),
+       TEST(SadAsyncLoadingTest::testSameAsSynchronous)
+   ) {}
+
+    // ReSharper disable once CppMemberFunctionMayBeStatic
+    // ReSharper disable once CppMemberFunctionMayBeConst
+   void testLoadFileNotExists()
+   {
+       sad::Renderer r;
+       sad::resource::Tree tree;
+       tree.setRenderer(&r);
+
+       sad::resource::AsyncLoading* loading = tree.loadFromFileAsync("doesnotexists.json");
+       loading->addRef();
+       ASSERT_TRUE( loading->decodingFinished() );
+       int count = count_errors_of_type(loading->wait(), "sad::resource::FileLoadError");
+       ASSERT_TRUE( loading->committed() );
+       loading->delRef();
+       ASSERT_TRUE(count == 1);
+   }
+
+    // ReSharper disable once CppMemberFunctionMayBeStatic
+    // ReSharper disable once CppMemberFunctionMayBeConst
+   void testEmpty()
+   {
+       sad::Renderer r;
+       sad::resource::Tree tree;
+       tree.setRenderer(&r);
+
+       sad::resource::AsyncLoading* loading = tree.loadFromFileAsync("tests/empty.json");
+       loading->addRef();
+       int count = loading->wait().size();
+       ASSERT_TRUE( loading->finished() );
+       ASSERT_TRUE( loading->progress() > 0.999 );
+       loading->delRef();
+       ASSERT_TRUE(count == 0);
+   }
+
+    // ReSharper disable once CppMemberFunctionMayBeStatic
+    // ReSharper disable once CppMemberFunctionMayBeConst
+   void testValid()
+   {
+       sad::Renderer r;
+       sad::resource::Tree tree;
+       tree.setStoreLinks(true);
+       tree.setRenderer(&r);
+
+       sad::resource::AsyncLoading* loading = tree.loadFromStringAsync(
+           "["
+                "{ \"type\": \"sad::Texture\", \"filename\": \"examples/game/objects.bmp\", \"name\": \"objects\" },"
+                "{ \"type\": \"sad::Texture\", \"filename\": \"tests/images/png.png\", \"name\": \"png\" },"
+                "{ \"type\": \"sad::Texture\", \"filename\": \"tests/images/tga32_compressed.tga\", \"name\": \"tga1\" },"
+                "{ \"type\": \"sad::Texture\", \"filename\": \"tests/images/tga24_compressed.tga\", \"name\": \"tga2\" },"
+                "{ \"type\": \"sad::Texture\", \"filename\": \"tests/images/bmp.bmp\", \"name\": \"images/bmp\" },"
+                "{ \"type\": \"sad::TextureMappedFont\", \"filename\": \"examples/game/font\", \"name\": \"myfont\" }"
+           "]",
+           4
+       );
+       loading->addRef();
+       ASSERT_TRUE( loading->total() == 6 );
+       // Resources are not added to tree, until loading is committed
+       ASSERT_TRUE( tree.root()->resource("objects") == NULL );
+       int count = loading->wait().size();
+       ASSERT_TRUE( loading->decoded() == 6 );
+       ASSERT_TRUE( loading->committed() );
+       // Textures are waiting to be uploaded on renderer's thread
+       ASSERT_TRUE( loading->pendingUploads() == 5 );
+       ASSERT_FALSE( loading->finished() );
+       loading->delRef();
+
+       ASSERT_TRUE(count == 0);
+       ASSERT_TRUE(tree.root()->resource("objects") != NULL);
+       ASSERT_TRUE(tree.root()->resource("png") != NULL);
+       ASSERT_TRUE(tree.root()->resource("tga1") != NULL);
+       ASSERT_TRUE(tree.root()->resource("tga2") != NULL);
+       ASSERT_TRUE(tree.root()->resource("images/bmp") != NULL);
+       ASSERT_TRUE(tree.root()->resource("myfont") != NULL);
+       ASSERT_TRUE(tree.files().size() == 6);
+   }
+
+    // ReSharper disable once CppMemberFunctionMayBeStatic
+    // ReSharper disable once CppMemberFunctionMayBeConst
+   void testLoadingFailure()
+   {
+       sad::Renderer r;
+       sad::resource::Tree tree;
+       tree.setStoreLinks(true);
+       tree.setRenderer(&r);
+
+       sad::resource::AsyncLoading* loading = tree.loadFromFileAsync("tests/loadingfailure.json", 2);
+       loading->addRef();
+       int count = count_errors_of_type(loading->wait(), "sad::resource::ResourceLoadError");
+       loading->delRef();
+       ASSERT_TRUE(count >= 1);
+       ASSERT_TRUE(tree.files().size() == 0);
+   }
+
+    // ReSharper disable once CppMemberFunctionMayBeStatic
+    // ReSharper disable once CppMemberFunctionMayBeConst
+   void testDuplicates()
+   {
+       sad::Renderer r;
+       sad::resource::Tree tree;
+       tree.setStoreLinks(true);
+       tree.setRenderer(&r);
+
+       sad::resource::AsyncLoading* loading = tree.loadFromFileAsync("tests/duplicates.json");
+       loading->addRef();
+       int count = count_errors_of_type(loading->wait(), "sad::resource::ResourceAlreadyExists");
+       loading->delRef();
+       ASSERT_TRUE(count == 1);
+       ASSERT_TRUE(tree.root()->resource("test1/test2") == NULL);
+       ASSERT_TRUE(tree.files().size() == 0);
+   }
+
+    // ReSharper disable once CppMemberFunctionMayBeStatic
+    // ReSharper disable once CppMemberFunctionMayBeConst
+   void testSameAsSynchronous()
+   {
+       sad::Renderer r;
+       sad::resource::Tree tree;
+       tree.setStoreLinks(true);
+       tree.setRenderer(&r);
+       sad::Vector<sad::resource::Error *> errors = tree.loadFromFile("tests/validmultiple.json");
+       ASSERT_TRUE(errors.size() == 0);
+
+       sad::resource::Tree asynctree;
+       asynctree.setStoreLinks(true);
+       asynctree.setRenderer(&r);
+       sad::resource::AsyncLoading* loading = asynctree.loadFromFileAsync("tests/validmultiple.json");
+       loading->addRef();
+       int count = loading->wait().size();
+       loading->delRef();
+       ASSERT_TRUE(count == 0);
+
+       sad::Texture* expected = tree.get<sad::Texture>("objects2");
+       sad::Texture* result = asynctree.get<sad::Texture>("objects2");
+       ASSERT_TRUE(expected != NULL);
+       ASSERT_TRUE(result != NULL);
+       ASSERT_TRUE(expected->width() == result->width());
+       ASSERT_TRUE(expected->height() == result->height());
+       size_t size = expected->width() * expected->height() * (expected->bpp() / 8);
+       ASSERT_TRUE(memcmp(expected->data(), result->data(), size) == 0);
+   }
+
+} _sad_async_loading_test;
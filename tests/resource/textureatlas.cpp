@@ -0,0 +1,256 @@
+#pragma warning(push)
+#pragma warning(disable: 4273)
+#pragma warning(disable: 4351)
+#include <cstdio>
+#include "resource/tree.h"
+#include "resource/textureatlaspacker.h"
+#include "util/free.h"
+#include "texture.h"
+#include "sprite2d.h"
+#include "fuzzyequal.h"
+#include "renderer.h"
+#include "rendering/nullbackend.h"
+#define _INC_STDIO
+#include "3rdparty/tpunit++/tpunit++.hpp"
+#pragma warning(pop)
+
+
+/*! Creates texture, filled with color, depending on index
+    \param[in] width a width of texture
+    \param[in] height a height of texture
+    \param[in] index an index of texture
+    \param[in] bpp bits per pixel
+    \return texture
+ */
+static sad::Texture* makeTextureAtlasTestTexture(unsigned int width, unsigned int height, unsigned char index, unsigned char bpp = 32)
+{
+    sad::Texture* t = new sad::Texture();
+    t->Width = width;
+    t->Height = height;
+    t->Bpp = bpp;
+    sad::Vector<sad::uchar>& data = static_cast<sad::Texture::DefaultBuffer*>(t->Buffer)->Data;
+    data.resize(width * height * (bpp / 8));
+    for(size_t i = 0; i < data.size(); i++)
+    {
+        data[i] = static_cast<sad::uchar>(index * 16 + i % 7);
+    }
+    return t;
+}
+
+/*! Returns a rectangle, taken by texture in page
+    \param[in] t texture
+    \return rectangle
+ */
+static sad::Rect2D textureAtlasTestRect(sad::Texture* t)
+{
+    sad::Point2D p1 = t->normalizedPoint(sad::Point2D(0, 0));
+    sad::Point2D p2 = t->normalizedPoint(sad::Point2D(t->Width, t->Height));
+    double w = t->atlasPage()->Width, h = t->atlasPage()->Height;
+    return sad::Rect2D(p1.x() * w, p1.y() * h, p2.x() * w, p2.y() * h);
+}
+
+/*! A backend, which stores last drawn sprite
+ */
+class TextureAtlasTestBackend: public sad::rendering::NullBackend
+{
+public:
+    /*! Creates new backend
+     */
+    TextureAtlasTestBackend() : Texture(NULL)
+    {
+    }
+    /*! Stores drawn sprite
+        \param[in] texture a texture
+        \param[in] area a rendered area
+        \param[in] texture_coordinates a normalized texture coordinates
+        \param[in] color a color
+     */
+    virtual void drawSprite(
+        sad::Texture* texture,
+        const sad::Rect2D& area,
+        const sad::Rect2D& texture_coordinates,
+        const sad::AColor& color
+    ) override
+    {
+        Texture = texture;
+        TextureCoordinates = texture_coordinates;
+        this->sad::rendering::NullBackend::drawSprite(texture, area, texture_coordinates, color);
+    }
+    /*! A last drawn texture
+     */
+    sad::Texture* Texture;
+    /*! A last drawn texture coordinates
+     */
+    sad::Rect2D TextureCoordinates;
+};
+
+/*!
+ * Tests runtime texture atlas
+ */
+struct SadResourceTextureAtlasTest : tpunit::TestFixture
+{
+ public:
+   SadResourceTextureAtlasTest() : tpunit::TestFixture(
+       TEST(SadResourceTextureAtlasTest::testPack),
+       TEST(SadResourceTextureAtlasTest::testSeveralPages),
+       TEST(SadResourceTextureAtlasTest::testTree)
+   ) {}
+
+   // ReSharper disable once CppMemberFunctionMayBeStatic
+   // ReSharper disable once CppMemberFunctionMayBeConst
+   void testPack()
+   {
+       sad::Vector<sad::Texture*> textures;
+       textures << makeTextureAtlasTestTexture(16, 16, 0);
+       textures << makeTextureAtlasTestTexture(8, 8, 1);
+       textures << makeTextureAtlasTestTexture(30, 10, 2);
+       textures << makeTextureAtlasTestTexture(10, 30, 3);
+       textures << makeTextureAtlasTestTexture(5, 3, 4, 24);
+       sad::Texture* big = makeTextureAtlasTestTexture(300, 2, 5);
+       textures << big;
+
+       sad::resource::TextureAtlasPacker packer(256);
+       sad::Vector<sad::Texture*> pages = packer.pack(textures);
+       ASSERT_TRUE( pages.size() == 1 );
+       sad::Texture* page = pages[0];
+       ASSERT_TRUE( page->Width == page->Height );
+       ASSERT_TRUE( (page->Width & (page->Width - 1)) == 0 );
+       ASSERT_FALSE( page->BuildMipMaps );
+       // Too large texture is left as is
+       ASSERT_TRUE( big->atlasPage() == NULL );
+       ASSERT_TRUE( big->boundTexture() == big );
+
+       for(size_t i = 0; i < 5; i++)
+       {
+           sad::Texture* t = textures[i];
+           ASSERT_TRUE( t->atlasPage() == page );
+           ASSERT_TRUE( t->boundTexture() == page );
+           sad::Rect2D r = textureAtlasTestRect(t);
+           // Pixels are copied into page
+           unsigned int x = static_cast<unsigned int>(r[0].x()), y = static_cast<unsigned int>(r[0].y());
+           for(unsigned int row = 0; row < t->Height; row++)
+           {
+               for(unsigned int column = 0; column < t->Width; column++)
+               {
+                   for(unsigned int component = 0; component < 3; component++)
+                   {
+                       ASSERT_TRUE( page->pixel(row + y, column + x)[component] == t->pixel(row, column)[component] );
+                   }
+               }
+           }
+           // Edges are extruded
+           ASSERT_TRUE( page->pixel(y - 1, x - 1)[0] == t->pixel(0, 0)[0] );
+           // Textures are not overlapping
+           for(size_t j = 0; j < i; j++)
+           {
+               sad::Rect2D o = textureAtlasTestRect(textures[j]);
+               bool separated = r[2].x() <= o[0].x() || o[2].x() <= r[0].x()
+                             || r[2].y() <= o[0].y() || o[2].y() <= r[0].y();
+               ASSERT_TRUE( separated );
+           }
+       }
+       // 24-bit texture is opaque in page
+       sad::Rect2D r = textureAtlasTestRect(textures[4]);
+       ASSERT_TRUE( page->pixel(static_cast<unsigned int>(r[0].y()), static_cast<unsigned int>(r[0].x()))[3] == 255 );
+
+       for(size_t i = 0; i < textures.size(); i++)
+       {
+           delete textures[i];
+       }
+       delete page;
+   }
+
+   // ReSharper disable once CppMemberFunctionMayBeStatic
+   // ReSharper disable once CppMemberFunctionMayBeConst
+   void testSeveralPages()
+   {
+       sad::Vector<sad::Texture*> textures;
+       for(unsigned char i = 0; i < 10; i++)
+       {
+           textures << makeTextureAtlasTestTexture(60, 60, i);
+       }
+       sad::resource::TextureAtlasPacker packer(128);
+       sad::Vector<sad::Texture*> pages = packer.pack(textures);
+       ASSERT_TRUE( pages.size() > 1 );
+       for(size_t i = 0; i < pages.size(); i++)
+       {
+           ASSERT_TRUE( pages[i]->Width <= 128 );
+       }
+       for(size_t i = 0; i < textures.size(); i++)
+       {
+           ASSERT_TRUE( textures[i]->atlasPage() != NULL );
+           delete textures[i];
+       }
+       sad::util::free(pages);
+   }
+
+   // ReSharper disable once CppMemberFunctionMayBeStatic
+   // ReSharper disable once CppMemberFunctionMayBeConst
+   void testTree()
+   {
+       sad::Renderer r;
+       r.setHeadless(true);
+       sad::resource::Tree tree;
+       tree.setRenderer(&r);
+       tree.setTextureAtlasEnabled(true);
+       tree.setTextureAtlasThreshold(64);
+
+       sad::Vector<sad::resource::Error *> errors = tree.loadFromString(
+           "["
+                "{"
+                    "\"type\"   : \"sad::Texture\","
+                    "\"filename\": \"tests/images/tga32_compressed.tga\","
+                    "\"name\"    : \"tga32\""
+                "},"
+                "{"
+                    "\"type\"   : \"sad::Texture\","
+                    "\"filename\": \"tests/images/tga32_compressed_small.tga\","
+                    "\"name\"    : \"tga32small\""
+                "},"
+                "{"
+                    "\"type\"   : \"sad::Texture\","
+                    "\"filename\": \"tests/images/png.png\","
+                    "\"name\"    : \"png\""
+                "}"
+            "]"
+        );
+       int count = errors.size();
+       sad::util::free(errors);
+       ASSERT_TRUE( count == 0 );
+
+       ASSERT_TRUE( tree.textureAtlasPages().size() == 1 );
+       sad::Texture* page = tree.textureAtlasPages()[0];
+       sad::Texture* tga32 = tree.get<sad::Texture>("tga32");
+       sad::Texture* tga32small = tree.get<sad::Texture>("tga32small");
+       sad::Texture* png = tree.get<sad::Texture>("png");
+       ASSERT_TRUE( tga32->atlasPage() == page );
+       ASSERT_TRUE( tga32small->atlasPage() == page );
+       ASSERT_TRUE( png->atlasPage() == NULL );
+       // Texture keeps own size
+       ASSERT_TRUE( tga32small->Width == 9 );
+
+       // Sprite is drawn with page and remapped coordinates
+       TextureAtlasTestBackend* backend = new TextureAtlasTestBackend();
+       r.setBackend(backend);
+       sad::Scene* scene = new sad::Scene();
+       scene->addRef();
+       scene->setRenderer(&r);
+       sad::Sprite2D* sprite = new sad::Sprite2D(tga32small, sad::Rect2D(0, 0, 9, 9), sad::Rect2D(0, 0, 9, 9));
+       sprite->addRef();
+       sprite->setScene(scene);
+       sprite->render();
+       ASSERT_TRUE( backend->Texture == page );
+       sad::Rect2D expected = textureAtlasTestRect(tga32small);
+       double minx = 1, maxx = 0;
+       for(int i = 0; i < 4; i++)
+       {
+           minx = std::min(minx, backend->TextureCoordinates[i].x());
+           maxx = std::max(maxx, backend->TextureCoordinates[i].x());
+       }
+       ASSERT_TRUE( sad::is_fuzzy_equal(minx * page->Width, expected[0].x()) );
+       ASSERT_TRUE( sad::is_fuzzy_equal((maxx - minx) * page->Width, 9) );
+       sprite->delRef();
+       scene->delRef();
+   }
+
+} _sad_resource_texture_atlas_test;
@@ -0,0 +1,252 @@
+#pragma warning(push)
+#pragma warning(disable: 4273)
+#pragma warning(disable: 4351)
+#include <stdio.h>
+#include <vector>
+#include <log/log.h>
+#include <sadthread.h>
+#include <sadsemaphore.h>
+#include "3rdparty/tpunit++/tpunit++.hpp"
+#pragma warning(pop)
+
+
+/*! A target, which records all received messages and could be blocked
+ */
+class RecordingLogTarget: public sad::log::Target
+{
+public:
+    /*! Makes new target
+        \param[in] gate if not NULL, every message waits on gate before being recorded
+     */
+    RecordingLogTarget(sad::Semaphore* gate = NULL) : m_gate(gate), Flushes(0)
+    {
+
+    }
+
+    virtual void receive(const sad::log::Message & message)
+    {
+        if (m_gate)
+        {
+            Received.release(1);
+            m_gate->consume(1);
+            m_gate->release(1);
+        }
+        Messages.push_back(message.message());
+    }
+
+    virtual void flush()
+    {
+        ++Flushes;
+    }
+
+    std::vector<sad::String> Messages;
+    /*! Released for every received message, before target is blocked on gate
+     */
+    sad::Semaphore Received;
+    sad::Semaphore* m_gate;
+    int Flushes;
+};
+
+/*!
+ * Tests asynchronous mode of log
+ */
+struct sadAsyncLogTest : tpunit::TestFixture
+{
+public:
+
+    sadAsyncLogTest() : tpunit::TestFixture(
+        TEST(sadAsyncLogTest::testMessageQueue),
+        TEST(sadAsyncLogTest::testOrder),
+        TEST(sadAsyncLogTest::testFlush),
+        TEST(sadAsyncLogTest::testDropNewest),
+        TEST(sadAsyncLogTest::testDropOldest),
+        TEST(sadAsyncLogTest::testBlock),
+        TEST(sadAsyncLogTest::testBlockManyThreads)
+    ) {}
+
+    sad::log::Log* log;
+
+    void produceFirst()
+    {
+        for(int i = 0; i < 1000; i++)
+        {
+            log->message(sad::String("a") + sad::String::number(i));
+        }
+    }
+
+    void produceSecond()
+    {
+        for(int i = 0; i < 1000; i++)
+        {
+            log->message(sad::String("b") + sad::String::number(i));
+        }
+    }
+
+    /*! Logs one message, which blocks background thread on gate, waits for thread to take it
+        and logs ten messages more
+        \param[in] log a log
+        \param[in] target a target, blocked on gate
+     */
+    void logWithBlockedTarget(sad::log::Log& log, RecordingLogTarget* target)
+    {
+        log.message("first");
+        target->Received.consume(1);
+        for(int i = 1; i <= 10; i++)
+        {
+            log.message(sad::String::number(i));
+        }
+    }
+
+    void testMessageQueue()
+    {
+        sad::log::MessageQueue queue(3);
+        ASSERT_TRUE( queue.capacity() == 4 );
+        ASSERT_TRUE( queue.tryPop() == NULL );
+        for(int i = 0; i < 4; i++)
+        {
+            ASSERT_TRUE( queue.tryPush(new sad::log::Message(sad::String::number(i), sad::log::MESSAGE)) );
+        }
+        sad::log::Message* extra = new sad::log::Message("extra", sad::log::MESSAGE);
+        ASSERT_FALSE( queue.tryPush(extra) );
+        delete extra;
+        for(int i = 0; i < 4; i++)
+        {
+            sad::log::Message* m = queue.tryPop();
+            ASSERT_TRUE( m != NULL );
+            ASSERT_TRUE( m->message() == sad::String::number(i) );
+            delete m;
+        }
+        ASSERT_TRUE( queue.tryPop() == NULL );
+    }
+
+    void testOrder()
+    {
+        log = new sad::log::Log();
+        RecordingLogTarget* target = new RecordingLogTarget();
+        log->addTarget(target);
+        log->setAsynchronous(true, 64);
+        ASSERT_TRUE( log->isAsynchronous() );
+
+        sad::Thread thread1(this, &sadAsyncLogTest::produceFirst);
+        sad::Thread thread2(this, &sadAsyncLogTest::produceSecond);
+        thread1.run();
+        thread2.run();
+        thread1.wait();
+        thread2.wait();
+        log->setAsynchronous(false);
+        ASSERT_FALSE( log->isAsynchronous() );
+
+        ASSERT_TRUE( target->Messages.size() == 2000 );
+        // Messages from every thread must be kept in same order
+        int next_a = 0, next_b = 0;
+        bool ordered = true;
+        for(size_t i = 0; i < target->Messages.size(); i++)
+        {
+            const sad::String& m = target->Messages[i];
+            if (m[0] == 'a')
+            {
+                ordered = ordered && (m == sad::String("a") + sad::String::number(next_a));
+                ++next_a;
+            }
+            else
+            {
+                ordered = ordered && (m == sad::String("b") + sad::String::number(next_b));
+                ++next_b;
+            }
+        }
+        ASSERT_TRUE( ordered );
+        ASSERT_TRUE( log->droppedMessages() == 0 );
+        delete log;
+    }
+
+    void testFlush()
+    {
+        sad::log::Log log;
+        RecordingLogTarget* target = new RecordingLogTarget();
+        log.addTarget(target);
+        log.setAsynchronous(true, 256);
+        for(int i = 0; i < 100; i++)
+        {
+            log.debug(sad::String::number(i));
+        }
+        log.flush();
+        ASSERT_TRUE( target->Messages.size() == 100 );
+        ASSERT_TRUE( target->Flushes == 1 );
+    }
+
+    void testDropNewest()
+    {
+        sad::Semaphore gate(0);
+        sad::log::Log log;
+        RecordingLogTarget* target = new RecordingLogTarget(&gate);
+        log.addTarget(target);
+        log.setAsynchronous(true, 4, sad::log::LOP_DROP_NEWEST);
+        logWithBlockedTarget(log, target);
+        gate.release(1);
+        log.setAsynchronous(false);
+
+        ASSERT_TRUE( log.droppedMessages() == 6 );
+        ASSERT_TRUE( target->Messages.size() == 5 );
+        ASSERT_TRUE( target->Messages[0] == "first" );
+        ASSERT_TRUE( target->Messages[1] == "1" );
+        ASSERT_TRUE( target->Messages[4] == "4" );
+        log.resetCounters();
+        ASSERT_TRUE( log.droppedMessages() == 0 );
+    }
+
+    void testDropOldest()
+    {
+        sad::Semaphore gate(0);
+        sad::log::Log log;
+        RecordingLogTarget* target = new RecordingLogTarget(&gate);
+        log.addTarget(target);
+        log.setAsynchronous(true, 4, sad::log::LOP_DROP_OLDEST);
+        logWithBlockedTarget(log, target);
+        gate.release(1);
+        log.setAsynchronous(false);
+
+        ASSERT_TRUE( log.droppedMessages() == 6 );
+        ASSERT_TRUE( target->Messages.size() == 5 );
+        ASSERT_TRUE( target->Messages[0] == "first" );
+        ASSERT_TRUE( target->Messages[1] == "7" );
+        ASSERT_TRUE( target->Messages[4] == "10" );
+    }
+
+    void testBlock()
+    {
+        sad::log::Log log;
+        RecordingLogTarget* target = new RecordingLogTarget();
+        log.addTarget(target);
+        log.setAsynchronous(true, 2, sad::log::LOP_BLOCK);
+        for(int i = 0; i < 500; i++)
+        {
+            log.debug(sad::String::number(i));
+        }
+        log.setAsynchronous(false);
+
+        ASSERT_TRUE( log.droppedMessages() == 0 );
+        ASSERT_TRUE( target->Messages.size() == 500 );
+        ASSERT_TRUE( target->Messages[499] == "499" );
+    }
+
+    void testBlockManyThreads()
+    {
+        log = new sad::log::Log();
+        RecordingLogTarget* target = new RecordingLogTarget();
+        log->addTarget(target);
+        log->setAsynchronous(true, 2, sad::log::LOP_BLOCK);
+
+        sad::Thread thread1(this, &sadAsyncLogTest::produceFirst);
+        sad::Thread thread2(this, &sadAsyncLogTest::produceSecond);
+        thread1.run();
+        thread2.run();
+        thread1.wait();
+        thread2.wait();
+        log->setAsynchronous(false);
+
+        ASSERT_TRUE( log->droppedMessages() == 0 );
+        ASSERT_TRUE( target->Messages.size() == 2000 );
+        delete log;
+    }
+
+} sad_async_log_test;
@@ -0,0 +1,204 @@
+#pragma warning(push)
+#pragma warning(disable: 4273)
+#pragma warning(disable: 4351)
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include "texture.h"
+#include "imageformats/blockcompression.h"
+#include "imageformats/compressedstorageloader.h"
+#define _INC_STDIO
+#include "3rdparty/tpunit++/tpunit++.hpp"
+#pragma warning(pop)
+
+/*! Compresses and decompresses pixels, returning maximal error of component
+    \param[in] pixels a pixels
+    \param[in] width a width of image
+    \param[in] height a height of image
+    \param[in] format a compressed format
+    \param[out] result a decompressed pixels
+    \return maximal error
+ */
+static int roundtripBlockCompression(
+    const sad::Vector<sad::uchar>& pixels,
+    unsigned int width,
+    unsigned int height,
+    sad::Texture::InternalFormat format,
+    sad::Vector<sad::uchar>& result
+)
+{
+    sad::Vector<sad::uchar> blocks;
+    blocks.resize(sad::imageformats::BlockCompression::compressedSize(width, height, format));
+    sad::imageformats::BlockCompression::compress(&(pixels[0]), width, height, format, &(blocks[0]));
+    result.resize(pixels.size());
+    sad::imageformats::BlockCompression::decompress(&(blocks[0]), width, height, format, &(result[0]));
+    int error = 0;
+    for(size_t i = 0; i < pixels.size(); i++)
+    {
+        int d = abs(static_cast<int>(pixels[i]) - static_cast<int>(result[i]));
+        error = (d > error) ? d : error;
+    }
+    return error;
+}
+
+/*!
+ * Tests sad::imageformats::BlockCompression and sad::imageformats::CompressedStorageLoader
+ */
+struct SadBlockCompressionTest : tpunit::TestFixture
+{
+ public:
+   SadBlockCompressionTest() : tpunit::TestFixture(
+       TEST(SadBlockCompressionTest::testSizes),
+       TEST(SadBlockCompressionTest::testSolidColor),
+       TEST(SadBlockCompressionTest::testGradient),
+       TEST(SadBlockCompressionTest::testColorsOrthogonalToGrey),
+       TEST(SadBlockCompressionTest::testAlpha),
+       TEST(SadBlockCompressionTest::testTextureSaveAndLoad)
+   ) {}
+
+   void testSizes()
+   {
+       ASSERT_TRUE( sad::imageformats::BlockCompression::compressedSize(5, 3, sad::Texture::SFT_BC1) == 2 * 8 );
+       ASSERT_TRUE( sad::imageformats::BlockCompression::compressedSize(8, 8, sad::Texture::SFT_BC3) == 4 * 16 );
+       ASSERT_TRUE( sad::imageformats::BlockCompression::compressedSize(8, 8, sad::Texture::SFT_R8_G8_B8_A8) == 0 );
+       ASSERT_FALSE( sad::imageformats::BlockCompression::isCompressed(sad::Texture::SFT_R5_G6_B5) );
+
+       sad::Texture t;
+       t.Width = 256;
+       t.Height = 128;
+       t.Format = sad::Texture::SFT_BC1;
+       t.Bpp = 4;
+       ASSERT_TRUE( t.gpuMemorySize() == 256 * 128 / 2 );
+       t.Format = sad::Texture::SFT_BC3;
+       t.Bpp = 8;
+       ASSERT_TRUE( t.gpuMemorySize() == 256 * 128 );
+   }
+
+   void testSolidColor()
+   {
+       // Odd size to test padding of blocks
+       sad::Vector<sad::uchar> pixels, result;
+       for(int i = 0; i < 5 * 7; i++)
+       {
+           pixels << 255 << 0 << 255 << 255;
+       }
+       ASSERT_TRUE( roundtripBlockCompression(pixels, 5, 7, sad::Texture::SFT_BC1, result) == 0 );
+       ASSERT_TRUE( roundtripBlockCompression(pixels, 5, 7, sad::Texture::SFT_BC3, result) == 0 );
+   }
+
+   void testGradient()
+   {
+       sad::Vector<sad::uchar> pixels, result;
+       for(int y = 0; y < 8; y++)
+       {
+           for(int x = 0; x < 8; x++)
+           {
+               pixels << static_cast<sad::uchar>(x * 8) << static_cast<sad::uchar>(x * 8 + y) << 64 << 255;
+           }
+       }
+       ASSERT_TRUE( roundtripBlockCompression(pixels, 8, 8, sad::Texture::SFT_BC1, result) <= 8 );
+       ASSERT_TRUE( roundtripBlockCompression(pixels, 8, 8, sad::Texture::SFT_BC3, result) <= 8 );
+
+       // Colors along one line are restored almost exactly
+       pixels.clear();
+       for(int i = 0; i < 16; i++)
+       {
+           sad::uchar v = (i % 4) * 85;
+           pixels << v << v << v << 255;
+       }
+       ASSERT_TRUE( roundtripBlockCompression(pixels, 4, 4, sad::Texture::SFT_BC1, result) <= 4 );
+   }
+
+   void testColorsOrthogonalToGrey()
+   {
+       // Red and green differ only across grey axis, so they must not collapse into one color
+       sad::Vector<sad::uchar> pixels, result;
+       for(int y = 0; y < 4; y++)
+       {
+           for(int x = 0; x < 4; x++)
+           {
+               if ((x + y) % 2)
+               {
+                   pixels << 255 << 0 << 0 << 255;
+               }
+               else
+               {
+                   pixels << 0 << 255 << 0 << 255;
+               }
+           }
+       }
+       ASSERT_TRUE( roundtripBlockCompression(pixels, 4, 4, sad::Texture::SFT_BC1, result) <= 4 );
+       ASSERT_TRUE( roundtripBlockCompression(pixels, 4, 4, sad::Texture::SFT_BC3, result) <= 4 );
+   }
+
+   void testAlpha()
+   {
+       sad::Vector<sad::uchar> pixels, result;
+       for(int i = 0; i < 16; i++)
+       {
+           pixels << 200 << 100 << 50 << ((i % 2) ? 255 : 0);
+       }
+       roundtripBlockCompression(pixels, 4, 4, sad::Texture::SFT_BC1, result);
+       for(int i = 0; i < 16; i++)
+       {
+           ASSERT_TRUE( result[i * 4 + 3] == pixels[i * 4 + 3] );
+           if (pixels[i * 4 + 3])
+           {
+               ASSERT_TRUE( abs(result[i * 4] - 200) <= 4 && abs(result[i * 4 + 1] - 100) <= 4 && abs(result[i * 4 + 2] - 50) <= 4 );
+           }
+       }
+
+       pixels.clear();
+       for(int i = 0; i < 16; i++)
+       {
+           pixels << 10 << 20 << 30 << static_cast<sad::uchar>(i * 17);
+       }
+       ASSERT_TRUE( roundtripBlockCompression(pixels, 4, 4, sad::Texture::SFT_BC3, result) <= 20 );
+       ASSERT_TRUE( result[3] == 0 && result[15 * 4 + 3] == 255 );
+   }
+
+   void testTextureSaveAndLoad()
+   {
+       sad::Texture t;
+       sad::Texture::DefaultBuffer* buffer = new sad::Texture::DefaultBuffer();
+       for(int i = 0; i < 6 * 6; i++)
+       {
+           buffer->Data << 0 << 255 << 0 << 255;
+       }
+       delete t.Buffer;
+       t.Buffer = buffer;
+       t.Width = 6;
+       t.Height = 6;
+       ASSERT_TRUE( t.compress(sad::Texture::SFT_BC3) );
+       ASSERT_TRUE( t.isCompressed() );
+       ASSERT_TRUE( t.Bpp == 8 );
+       ASSERT_FALSE( t.compress(sad::Texture::SFT_BC1) );
+
+       sad::imageformats::CompressedStorageLoader bc1(sad::imageformats::CompressedStorageLoader::SBC1Settings);
+       sad::imageformats::CompressedStorageLoader bc3(sad::imageformats::CompressedStorageLoader::SBC3Settings);
+       FILE* file = fopen("tests/blockcompression.sbc3", "wb");
+       ASSERT_TRUE( file != NULL );
+       ASSERT_FALSE( bc1.save(file, &t) );
+       bool saved = bc3.save(file, &t);
+       fclose(file);
+       ASSERT_TRUE( saved );
+
+       sad::Texture loaded;
+       file = fopen("tests/blockcompression.sbc3", "rb");
+       ASSERT_TRUE( file != NULL );
+       ASSERT_FALSE( bc1.load(file, &loaded) );
+       rewind(file);
+       bool result = bc3.load(file, &loaded);
+       fclose(file);
+       remove("tests/blockcompression.sbc3");
+       ASSERT_TRUE( result );
+       ASSERT_TRUE( loaded.width() == 6 && loaded.height() == 6 );
+       ASSERT_TRUE( loaded.Format == sad::Texture::SFT_BC3 );
+       ASSERT_TRUE( memcmp(loaded.data(), t.data(), 4 * 16) == 0 );
+
+       ASSERT_TRUE( loaded.decompress() );
+       ASSERT_TRUE( loaded.Bpp == 32 && loaded.Format == sad::Texture::SFT_R8_G8_B8_A8 );
+       ASSERT_TRUE( loaded.data()[35 * 4] == 0 && loaded.data()[35 * 4 + 1] == 255 && loaded.data()[35 * 4 + 3] == 255 );
+   }
+
+} _sad_block_compression_test;
@@ -0,0 +1,126 @@
+#pragma warning(push)
+#pragma warning(disable: 4273)
+#pragma warning(disable: 4351)
+#include <stdio.h>
+#include <framepacer.h>
+#include <fpsinterpolation.h>
+#include "3rdparty/tpunit++/tpunit++.hpp"
+#include "../benchmark.h"
+#pragma warning(pop)
+
+
+
+/*!
+ * Tests frame pacing and frame time percentiles
+ */
+struct SadFramePacer : tpunit::TestFixture
+{
+public:
+
+    SadFramePacer() : tpunit::TestFixture(
+        TEST(SadFramePacer::testPercentiles),
+        TEST(SadFramePacer::testFrameTimesCapacity),
+        TEST(SadFramePacer::testMeasuredFrames),
+        TEST(SadFramePacer::testUnlimited)
+    ) {}
+
+   void testPercentiles()
+   {
+       sad::FPSInterpolation i;
+       ASSERT_TRUE( i.frameTimesCount() == 0 );
+       ASSERT_TRUE( i.frameTimePercentile(50) == 0 );
+       double times[10] = { 7, 3, 10, 1, 5, 9, 2, 8, 4, 6 };
+       for(int j = 0; j < 10; j++)
+       {
+           i.frameFinished(times[j]);
+       }
+       ASSERT_TRUE( i.frameTimesCount() == 10 );
+       // Nearest-rank method: percentile is a time at rank ceil(p / 100 * count)
+       ASSERT_TRUE( i.frameTimePercentile(0) == 1 );
+       ASSERT_TRUE( i.frameTimePercentile(50) == 5 );
+       ASSERT_TRUE( i.frameTimePercentile(51) == 6 );
+       ASSERT_TRUE( i.frameTimePercentile(90) == 9 );
+       ASSERT_TRUE( i.frameTimePercentile(99) == 10 );
+       ASSERT_TRUE( i.frameTimePercentile(100) == 10 );
+       // Out of range percentiles are clamped
+       ASSERT_TRUE( i.frameTimePercentile(-5) == 1 );
+       ASSERT_TRUE( i.frameTimePercentile(150) == 10 );
+   }
+
+   void testFrameTimesCapacity()
+   {
+       sad::FPSInterpolation i;
+       i.frameFinished(100);
+       i.setFrameTimesCapacity(3);
+       ASSERT_TRUE( i.frameTimesCapacity() == 3 );
+       ASSERT_TRUE( i.frameTimesCount() == 0 );
+       double times[5] = { 1, 2, 3, 40, 50 };
+       for(int j = 0; j < 5; j++)
+       {
+           i.frameFinished(times[j]);
+       }
+       // Oldest times are replaced, so 3, 40 and 50 are kept
+       ASSERT_TRUE( i.frameTimesCount() == 3 );
+       ASSERT_TRUE( i.frameTimePercentile(0) == 3 );
+       ASSERT_TRUE( i.frameTimePercentile(50) == 40 );
+       ASSERT_TRUE( i.frameTimePercentile(100) == 50 );
+
+       i.setFrameTimesCapacity(0);
+       ASSERT_TRUE( i.frameTimesCapacity() == 1 );
+       i.clearFrameTimes();
+       ASSERT_TRUE( i.frameTimesCount() == 0 );
+   }
+
+   void testMeasuredFrames()
+   {
+       sad::FPSInterpolation i;
+       // First call only starts measuring
+       i.frameFinished();
+       ASSERT_TRUE( i.frameTimesCount() == 0 );
+       i.frameFinished();
+       i.frameFinished();
+       ASSERT_TRUE( i.frameTimesCount() == 2 );
+       ASSERT_TRUE( i.frameTimePercentile(0) >= 0 );
+       // Clearing times restarts measuring
+       i.clearFrameTimes();
+       i.frameFinished();
+       ASSERT_TRUE( i.frameTimesCount() == 0 );
+   }
+
+   void testUnlimited()
+   {
+       sad::FramePacer p;
+       ASSERT_TRUE( p.strategy() == sad::FramePacer::FPS_UNLIMITED );
+       ASSERT_FALSE( p.waitsWithTimer() );
+       p.setStrategy(sad::FramePacer::FPS_VSYNC);
+       p.setVSyncEnabled(true);
+       ASSERT_FALSE( p.waitsWithTimer() );
+       // Falls back to timer, if synchronization is not supported
+       p.setVSyncEnabled(false);
+       ASSERT_TRUE( p.waitsWithTimer() );
+       p.setTargetFPS(0);
+       ASSERT_FALSE( p.waitsWithTimer() );
+       ASSERT_TRUE( p.frameTime() == 0 );
+   }
+
+} _sad_frame_pacer_test;
+
+/*! Prints frame times, achieved by timer strategy. Times depend on load of machine, so they are only printed
+ */
+static void benchmarkFramePacerTimer()
+{
+    sad::FramePacer p;
+    p.setStrategy(sad::FramePacer::FPS_TIMER);
+    p.setTargetFPS(100);
+    sad::FPSInterpolation i;
+    p.reset();
+    i.frameFinished();
+    for(int j = 0; j < 50; j++)
+    {
+        p.waitForNextFrame();
+        i.frameFinished();
+    }
+    printf("Frame time at 100 FPS: median %.3f ms, 99th percentile %.3f ms\n", i.frameTimePercentile(50), i.frameTimePercentile(99));
+}
+
+static benchmark::Registrar _sad_frame_pacer_benchmark("Frame pacing with timer", benchmarkFramePacerTimer);
@@ -0,0 +1,138 @@
+#pragma warning(push)
+#pragma warning(disable: 4273)
+#pragma warning(disable: 4351)
+#include <cstdio>
+#include "renderer.h"
+#include "opengl.h"
+#include "rendering/glstatecache.h"
+#include "rendering/glbackend.h"
+#include "os/glheaders.h"
+#define _INC_STDIO
+#include "3rdparty/tpunit++/tpunit++.hpp"
+#pragma warning(pop)
+
+/*!
+ * Tests sad::rendering::GLStateCache
+ */
+struct SadGLStateCacheTest : tpunit::TestFixture
+{
+ public:
+   SadGLStateCacheTest() : tpunit::TestFixture(
+       TEST(SadGLStateCacheTest::testBindTexture),
+       TEST(SadGLStateCacheTest::testColor),
+       TEST(SadGLStateCacheTest::testCapabilitiesAndMatrixMode),
+       TEST(SadGLStateCacheTest::testInvalidate),
+       TEST(SadGLStateCacheTest::testBackendUsesCacheOfRenderer)
+   ) {}
+
+   void testBindTexture()
+   {
+       sad::rendering::GLStateCache cache;
+       cache.bindTexture(1);
+       cache.bindTexture(1);
+       cache.bindTexture(2);
+       cache.bindTexture(2);
+       cache.bindTexture(2);
+       ASSERT_TRUE( cache.issuedCalls() == 2 );
+       ASSERT_TRUE( cache.avoidedCalls() == 3 );
+       ASSERT_TRUE( cache.avoidedTextureBinds() == 3 );
+
+       // Deleting bound texture resets binding, so new texture with same id must be bound
+       cache.textureDeleted(2);
+       cache.bindTexture(2);
+       ASSERT_TRUE( cache.issuedCalls() == 3 );
+       // Deleting other texture does not affect binding
+       cache.textureDeleted(1);
+       cache.bindTexture(2);
+       ASSERT_TRUE( cache.issuedCalls() == 3 );
+       ASSERT_TRUE( cache.avoidedTextureBinds() == 4 );
+   }
+
+   void testColor()
+   {
+       sad::rendering::GLStateCache cache;
+       cache.setColor(sad::AColor(255, 0, 0, 255));
+       cache.setColor(sad::AColor(255, 0, 0, 255));
+       cache.setColor(sad::AColor(255, 0, 0, 128));
+       ASSERT_TRUE( cache.issuedCalls() == 2 );
+       ASSERT_TRUE( cache.avoidedColorChanges() == 1 );
+
+       cache.forgetColor();
+       cache.setColor(sad::AColor(255, 0, 0, 128));
+       ASSERT_TRUE( cache.issuedCalls() == 3 );
+       ASSERT_TRUE( cache.avoidedColorChanges() == 1 );
+
+       cache.resetCounters();
+       ASSERT_TRUE( cache.issuedCalls() == 0 );
+       ASSERT_TRUE( cache.avoidedCalls() == 0 );
+       ASSERT_TRUE( cache.avoidedColorChanges() == 0 );
+   }
+
+   void testCapabilitiesAndMatrixMode()
+   {
+       sad::rendering::GLStateCache cache;
+       ASSERT_FALSE( cache.matrixMode().exists() );
+       cache.setMatrixMode(GL_MODELVIEW);
+       cache.setMatrixMode(GL_MODELVIEW);
+       ASSERT_TRUE( cache.matrixMode().exists() );
+       ASSERT_TRUE( cache.matrixMode().value() == GL_MODELVIEW );
+
+       cache.setBlendEnabled(true);
+       cache.setBlendEnabled(true);
+       cache.setBlendFunction(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+       cache.setBlendFunction(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+       cache.setBlendFunction(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+       cache.setTextureEnabled(false);
+       cache.setTextureEnabled(true);
+       ASSERT_TRUE( cache.issuedCalls() == 6 );
+       ASSERT_TRUE( cache.avoidedCalls() == 3 );
+       ASSERT_TRUE( cache.avoidedTextureBinds() == 0 );
+       ASSERT_TRUE( cache.avoidedColorChanges() == 0 );
+   }
+
+   void testInvalidate()
+   {
+       sad::rendering::GLStateCache cache;
+       cache.bindTexture(3);
+       cache.setColor(sad::AColor(1, 2, 3, 4));
+       cache.setBlendEnabled(true);
+       cache.setMatrixMode(GL_PROJECTION);
+       cache.invalidate();
+       ASSERT_FALSE( cache.matrixMode().exists() );
+
+       cache.bindTexture(3);
+       cache.setColor(sad::AColor(1, 2, 3, 4));
+       cache.setBlendEnabled(true);
+       cache.setMatrixMode(GL_PROJECTION);
+       ASSERT_TRUE( cache.issuedCalls() == 8 );
+       ASSERT_TRUE( cache.avoidedCalls() == 0 );
+   }
+
+   void testBackendUsesCacheOfRenderer()
+   {
+       sad::Renderer r;
+       sad::rendering::GLStateCache* cache = r.opengl()->stateCache();
+       sad::rendering::GLBackend backend(&r);
+       ASSERT_TRUE( backend.stateCache() == cache );
+
+       sad::Point2D points[2] = { sad::Point2D(0, 0), sad::Point2D(1, 1) };
+       backend.startFrame();
+       cache->resetCounters();
+       backend.drawLines(points, 2, sad::AColor(255, 0, 0, 255));
+       backend.drawLines(points, 2, sad::AColor(255, 0, 0, 255));
+       backend.drawLines(points, 2, sad::AColor(0, 255, 0, 255));
+       // Only first and last lines change color, texturing is toggled for every call
+       ASSERT_TRUE( cache->avoidedColorChanges() == 1 );
+       ASSERT_TRUE( cache->issuedCalls() == 8 );
+
+       backend.pushMatrix();
+       backend.pushMatrix();
+       ASSERT_TRUE( cache->avoidedCalls() == 3 );
+       backend.popMatrix();
+       backend.popMatrix();
+
+       backend.setOrthographicProjection(800, 600);
+       ASSERT_TRUE( cache->matrixMode().value() == GL_MODELVIEW );
+   }
+
+} _sad_gl_state_cache_test;
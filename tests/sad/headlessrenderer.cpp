@@ -0,0 +1,135 @@
+#pragma warning(push)
+#pragma warning(disable: 4273)
+#pragma warning(disable: 4351)
+#include <cstdio>
+#include "renderer.h"
+#include "mainloop.h"
+#include "framepacer.h"
+#include "pipeline/pipeline.h"
+#define _INC_STDIO
+#include "3rdparty/tpunit++/tpunit++.hpp"
+#pragma warning(pop)
+
+
+/*! A node, which counts, how many times it was rendered
+ */
+class HeadlessTestNode: public sad::SceneNode
+{
+public:
+    /*! Creates new node
+     */
+    HeadlessTestNode() : Rendered(0)
+    {
+    }
+    /*! Counts rendering
+     */
+    virtual void render() override
+    {
+        ++Rendered;
+    }
+    /*! Amount of renderings
+     */
+    int Rendered;
+};
+
+/*! A counter of frames, which could quit renderer
+ */
+struct HeadlessFrameCounter
+{
+    /*! Creates new counter
+        \param[in] r renderer
+        \param[in] quit_after amount of frames, after which renderer quits (0 to never quit)
+     */
+    HeadlessFrameCounter(sad::Renderer* r, int quit_after) : Renderer(r), QuitAfter(quit_after), Frames(0)
+    {
+    }
+    /*! Counts a frame
+     */
+    void tick()
+    {
+        ++Frames;
+        if (Frames == QuitAfter)
+        {
+            Renderer->quit();
+        }
+    }
+    /*! A renderer
+     */
+    sad::Renderer* Renderer;
+    /*! Amount of frames, after which renderer quits
+     */
+    int QuitAfter;
+    /*! Amount of frames
+     */
+    int Frames;
+};
+
+/*!
+ * Tests running sad::Renderer without window and context
+ */
+struct SadHeadlessRendererTest : tpunit::TestFixture
+{
+ public:
+   SadHeadlessRendererTest() : tpunit::TestFixture(
+       TEST(SadHeadlessRendererTest::testFrameLimit),
+       TEST(SadHeadlessRendererTest::testQuit),
+       TEST(SadHeadlessRendererTest::testFixedTick)
+   ) {}
+
+   // ReSharper disable once CppMemberFunctionMayBeStatic
+   // ReSharper disable once CppMemberFunctionMayBeConst
+   void testFrameLimit()
+   {
+       sad::Renderer r;
+       r.setHeadless(true);
+       HeadlessFrameCounter counter(&r, 0);
+       r.pipeline()->appendProcess(&counter, &HeadlessFrameCounter::tick);
+       sad::Scene* scene = new sad::Scene();
+       HeadlessTestNode* visible = new HeadlessTestNode();
+       HeadlessTestNode* hidden = new HeadlessTestNode();
+       hidden->setVisible(false);
+       scene->addNode(visible);
+       scene->addNode(hidden);
+       r.addScene(scene);
+
+       r.mainLoop()->setFrameLimit(10);
+       ASSERT_TRUE( r.run() );
+       ASSERT_TRUE( r.mainLoop()->frameCount() == 10 );
+       ASSERT_TRUE( counter.Frames == 10 );
+       // Nodes are only counted, not rendered
+       ASSERT_TRUE( visible->Rendered == 0 );
+       ASSERT_TRUE( scene->renderedNodeCount() == 1 );
+       ASSERT_FALSE( r.hasValidContext() );
+       ASSERT_FALSE( r.running() );
+   }
+
+   // ReSharper disable once CppMemberFunctionMayBeStatic
+   // ReSharper disable once CppMemberFunctionMayBeConst
+   void testQuit()
+   {
+       sad::Renderer r;
+       r.setHeadless(true);
+       HeadlessFrameCounter counter(&r, 5);
+       r.pipeline()->appendProcess(&counter, &HeadlessFrameCounter::tick);
+       ASSERT_TRUE( r.run() );
+       ASSERT_TRUE( counter.Frames == 5 );
+   }
+
+   // ReSharper disable once CppMemberFunctionMayBeStatic
+   // ReSharper disable once CppMemberFunctionMayBeConst
+   void testFixedTick()
+   {
+       sad::Renderer r;
+       r.setHeadless(true);
+       r.mainLoop()->framePacer()->setStrategy(sad::FramePacer::FPS_TIMER);
+       r.mainLoop()->framePacer()->setTargetFPS(100);
+       r.mainLoop()->setFrameLimit(11);
+       sad::Timer timer;
+       timer.start();
+       ASSERT_TRUE( r.run() );
+       timer.stop();
+       // 10 frames are paced, last one stops the loop
+       ASSERT_TRUE( timer.elapsed() > 90 );
+   }
+
+} _sad_headless_renderer_test;
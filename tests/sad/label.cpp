@@ -24,7 +24,8 @@ struct LabelTest : tpunit::TestFixture
        TEST(LabelTest::testFormatTextLineEllipsisEnd),
        TEST(LabelTest::testFormatTextLineEllipsisMiddle),
        TEST(LabelTest::testMakeRenderingString),
-       TEST(LabelTest::testMakeRenderingStringMultiline)
+       TEST(LabelTest::testMakeRenderingStringMultiline),
+       TEST(LabelTest::testBoundingRectWithoutFont)
    ) {}
    
    
@@ -504,6 +505,16 @@ struct LabelTest : tpunit::TestFixture
       ASSERT_TRUE( result ==  "testing1\ntesting2\n...\ntesting5");
    }
 
+   void testBoundingRectWithoutFont()
+   {
+      // Label with font, which is not loaded, could not compute it's region and must not be culled
+      sad::Label label;
+      label.setString("text");
+      label.setPoint(10, 20);
+      sad::Rect2D r;
+      ASSERT_FALSE( label.boundingRect(r) );
+   }
+
 
 } _label_test;
 
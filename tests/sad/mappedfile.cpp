@@ -0,0 +1,99 @@
+#pragma warning(push)
+#pragma warning(disable: 4273)
+#pragma warning(disable: 4351)
+#include <cstdio>
+#include <cstring>
+#include "texture.h"
+#include "os/mappedfileimpl.h"
+#include "imageformats/pixelstorageloader.h"
+#define _INC_STDIO
+#include "3rdparty/tpunit++/tpunit++.hpp"
+#pragma warning(pop)
+
+/*!
+ * Tests sad::os::MappedFileImpl and loading of textures via mapped files
+ */
+struct SadMappedFileTest : tpunit::TestFixture
+{
+ public:
+   SadMappedFileTest() : tpunit::TestFixture(
+       TEST(SadMappedFileTest::testMap),
+       TEST(SadMappedFileTest::testPixelStorage)
+   ) {}
+
+   void testMap()
+   {
+       sad::os::MappedFileImpl mapped;
+       ASSERT_FALSE( mapped.map(NULL) );
+       ASSERT_TRUE( mapped.data() == NULL );
+
+       FILE* file = fopen("tests/mappedfile.bin", "wb");
+       ASSERT_TRUE( file != NULL );
+       fwrite("mapped", 6, 1, file);
+       fclose(file);
+
+       file = fopen("tests/mappedfile.bin", "rb");
+       ASSERT_TRUE( file != NULL );
+       bool result = mapped.map(file);
+       fclose(file);
+       ASSERT_TRUE( result );
+       ASSERT_TRUE( mapped.size() == 6 );
+       ASSERT_TRUE( memcmp(mapped.data(), "mapped", 6) == 0 );
+       // Pages are copy-on-write, so file stays unchanged
+       mapped.data()[0] = 'M';
+       mapped.unmap();
+       ASSERT_TRUE( mapped.data() == NULL && mapped.size() == 0 );
+
+       file = fopen("tests/mappedfile.bin", "rb");
+       ASSERT_TRUE( file != NULL );
+       char contents[6];
+       fread(contents, 6, 1, file);
+       fclose(file);
+       remove("tests/mappedfile.bin");
+       ASSERT_TRUE( memcmp(contents, "mapped", 6) == 0 );
+   }
+
+   void testPixelStorage()
+   {
+       sad::Texture t;
+       sad::Texture::DefaultBuffer* buffer = new sad::Texture::DefaultBuffer();
+       for(int i = 0; i < 4 * 4; i++)
+       {
+           buffer->Data << static_cast<sad::uchar>(i) << 2 << 3 << 4;
+       }
+       delete t.Buffer;
+       t.Buffer = buffer;
+       t.Width = 4;
+       t.Height = 4;
+
+       sad::imageformats::PixelStorageLoader loader(sad::imageformats::PixelStorageLoader::SRGBASettings);
+       FILE* file = fopen("tests/mappedfile.srgba", "wb");
+       ASSERT_TRUE( file != NULL );
+       bool saved = loader.save(file, &t);
+       fclose(file);
+       ASSERT_TRUE( saved );
+
+       // File is read, unless mapping is requested
+       sad::Texture read;
+       file = fopen("tests/mappedfile.srgba", "rb");
+       ASSERT_TRUE( file != NULL );
+       bool result = loader.load(file, &read);
+       fclose(file);
+       ASSERT_TRUE( result );
+       ASSERT_TRUE( dynamic_cast<sad::Texture::DefaultBuffer*>(read.Buffer) != NULL );
+       ASSERT_TRUE( memcmp(read.data(), t.data(), 4 * 4 * 4) == 0 );
+
+       sad::Texture loaded;
+       loaded.MapFile = true;
+       file = fopen("tests/mappedfile.srgba", "rb");
+       ASSERT_TRUE( file != NULL );
+       result = loader.load(file, &loaded);
+       fclose(file);
+       remove("tests/mappedfile.srgba");
+       ASSERT_TRUE( result );
+       ASSERT_TRUE( dynamic_cast<sad::Texture::MappedFileBuffer*>(loaded.Buffer) != NULL );
+       ASSERT_TRUE( loaded.width() == 4 && loaded.height() == 4 );
+       ASSERT_TRUE( memcmp(loaded.data(), t.data(), 4 * 4 * 4) == 0 );
+   }
+
+} _sad_mapped_file_test;
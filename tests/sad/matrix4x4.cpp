@@ -0,0 +1,155 @@
+#pragma warning(push)
+#pragma warning(disable: 4273)
+#pragma warning(disable: 4351)
+#include <cstdio>
+#include "matrix4x4.h"
+#include "renderer.h"
+#include "camera.h"
+#include "orthographiccamera.h"
+#include "fuzzyequal.h"
+#include "os/glheaders.h"
+#define _INC_STDIO
+#include "3rdparty/tpunit++/tpunit++.hpp"
+#pragma warning(pop)
+
+/*! Tests, whether points are equal with precision
+    \param[in] a first point
+    \param[in] b second point
+    \return whether they are equal
+ */
+static bool equalMatrix4x4Points(const sad::Point3D& a, const sad::Point3D& b)
+{
+    return sad::is_fuzzy_equal(a.x(), b.x(), 0.0001)
+        && sad::is_fuzzy_equal(a.y(), b.y(), 0.0001)
+        && sad::is_fuzzy_equal(a.z(), b.z(), 0.0001);
+}
+
+/*!
+ * Tests sad::Matrix4x4 and unprojection of points without OpenGL
+ */
+struct SadMatrix4x4Test : tpunit::TestFixture
+{
+ public:
+   SadMatrix4x4Test() : tpunit::TestFixture(
+       TEST(SadMatrix4x4Test::testTransformations),
+       TEST(SadMatrix4x4Test::testInverse),
+       TEST(SadMatrix4x4Test::testUnProjectOrtho),
+       TEST(SadMatrix4x4Test::testUnProjectMatchesGLU),
+       TEST(SadMatrix4x4Test::testRendererUnproject),
+       TEST(SadMatrix4x4Test::testCameraMatrixCache)
+   ) {}
+
+   void testTransformations()
+   {
+       sad::Matrix4x4<double> r = sad::Matrix4x4<double>::rotation(90, 0, 0, 1);
+       ASSERT_TRUE( equalMatrix4x4Points(r.transform(sad::Point3D(1, 0, 0)), sad::Point3D(0, 1, 0)) );
+       // Zero axis is ignored
+       sad::Matrix4x4<double> z = sad::Matrix4x4<double>::rotation(90, 0, 0, 0);
+       ASSERT_TRUE( equalMatrix4x4Points(z.transform(sad::Point3D(1, 2, 3)), sad::Point3D(1, 2, 3)) );
+
+       // Translation is applied after rotation, like in glTranslatef and glRotatef sequence
+       sad::Matrix4x4<double> m = sad::Matrix4x4<double>::translation(10, 20, 0) * r;
+       ASSERT_TRUE( equalMatrix4x4Points(m.transform(sad::Point3D(1, 0, 0)), sad::Point3D(10, 21, 0)) );
+
+       double data[16];
+       m.toColumnMajor(data);
+       ASSERT_TRUE( sad::is_fuzzy_equal(data[12], 10) );
+       ASSERT_TRUE( sad::is_fuzzy_equal(data[13], 20) );
+   }
+
+   void testInverse()
+   {
+       sad::Matrix4x4<double> m = sad::Matrix4x4<double>::translation(10, 20, 30)
+                                * sad::Matrix4x4<double>::rotation(33, 1, 2, 3)
+                                * sad::Matrix4x4<double>::perspective(45, 4.0 / 3.0, 0.1, 100);
+       sad::Matrix4x4<double> inverse;
+       ASSERT_TRUE( m.inverse(inverse) );
+       sad::Matrix4x4<double> identity = m * inverse;
+       for(unsigned int i = 0; i < 4; i++)
+       {
+           for(unsigned int j = 0; j < 4; j++)
+           {
+               ASSERT_TRUE( sad::is_fuzzy_equal(identity.get(i, j), (i == j) ? 1.0 : 0.0, 0.0001) );
+           }
+       }
+
+       sad::Matrix4x4<double> singular;
+       singular.set(2, 2, 0);
+       ASSERT_FALSE( singular.inverse(inverse) );
+   }
+
+   void testUnProjectOrtho()
+   {
+       int viewport[4] = { 0, 0, 800, 600 };
+       sad::Point3D result;
+       ASSERT_TRUE( sad::unProject(
+           sad::Point3D(100, 200, 0.5),
+           sad::Matrix4x4<double>::identity(),
+           sad::Matrix4x4<double>::ortho2D(800, 600),
+           viewport,
+           result
+       ) );
+       ASSERT_TRUE( equalMatrix4x4Points(result, sad::Point3D(100, 200, 0)) );
+   }
+
+   void testUnProjectMatchesGLU()
+   {
+       int viewport[4] = { 0, 0, 800, 600 };
+       sad::Matrix4x4<double> modelview = sad::Matrix4x4<double>::translation(5, -3, -10)
+                                        * sad::Matrix4x4<double>::rotation(30, 0, 1, 0);
+       sad::Matrix4x4<double> projection = sad::Matrix4x4<double>::perspective(45, 800.0 / 600.0, 0.1, 100);
+       sad::Point3D result;
+       ASSERT_TRUE( sad::unProject(sad::Point3D(320, 240, 0.8), modelview, projection, viewport, result) );
+
+       GLdouble glmodelview[16], glprojection[16];
+       GLint glviewport[4] = { 0, 0, 800, 600 };
+       modelview.toColumnMajor(glmodelview);
+       projection.toColumnMajor(glprojection);
+       GLdouble x = 0, y = 0, z = 0;
+       gluUnProject(320, 240, 0.8, glmodelview, glprojection, glviewport, &x, &y, &z);
+       ASSERT_TRUE( equalMatrix4x4Points(result, sad::Point3D(x, y, z)) );
+   }
+
+   void testRendererUnproject()
+   {
+       sad::Renderer r;
+       // Nothing could be mapped, until viewport is known
+       ASSERT_TRUE( equalMatrix4x4Points(r.unproject(sad::Point3D(1, 2, 0.5)), sad::Point3D(1, 2, 0.5)) );
+
+       r.reshape(800, 600);
+       ASSERT_TRUE( r.viewportSize().Width == 800 );
+       ASSERT_TRUE( r.viewportSize().Height == 600 );
+
+       r.setProjectionMatrix(sad::Matrix4x4<double>::ortho2D(800, 600));
+       r.setGlobalTranslationOffset(sad::Vector3D(10, 20, 0));
+       sad::Point3D p = r.unproject(sad::Point3D(100, 200, 0.5));
+       ASSERT_TRUE( sad::is_fuzzy_equal(p.x(), 90) );
+       ASSERT_TRUE( sad::is_fuzzy_equal(p.y(), 180) );
+   }
+
+   void testCameraMatrixCache()
+   {
+       sad::Renderer r;
+       sad::Scene* scene = new sad::Scene();
+       sad::OrthographicCamera* camera = new sad::OrthographicCamera(800, 600);
+       scene->setCamera(camera);
+       r.addScene(scene);
+
+       camera->TranslationOffset = sad::Vector3D(100, 0, 0);
+       ASSERT_TRUE( equalMatrix4x4Points(camera->matrix().transform(sad::Point3D(0, 0, 0)), sad::Point3D(100, 0, 0)) );
+       ASSERT_TRUE( equalMatrix4x4Points(camera->inverseMatrix().transform(sad::Point3D(100, 0, 0)), sad::Point3D(0, 0, 0)) );
+
+       // Matrix is recomputed, when fields or global offset are changed
+       camera->Angle = 90;
+       camera->RotationVectorDirection = sad::Vector3D(0, 0, 1);
+       ASSERT_TRUE( equalMatrix4x4Points(camera->matrix().transform(sad::Point3D(1, 0, 0)), sad::Point3D(100, 1, 0)) );
+       r.setGlobalTranslationOffset(sad::Vector3D(0, 50, 0));
+       ASSERT_TRUE( equalMatrix4x4Points(camera->matrix().transform(sad::Point3D(1, 0, 0)), sad::Point3D(100, 51, 0)) );
+
+       sad::Rect2D rect;
+       ASSERT_TRUE( camera->viewRect(rect) );
+       ASSERT_TRUE( sad::is_fuzzy_equal(rect[0].x(), -50) );
+       ASSERT_TRUE( sad::is_fuzzy_equal(rect[0].y(), -700) );
+   }
+
+} _sad_matrix4x4_test;
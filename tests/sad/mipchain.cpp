@@ -0,0 +1,197 @@
+#pragma warning(push)
+#pragma warning(disable: 4273)
+#pragma warning(disable: 4351)
+#include <cstdio>
+#include <cstring>
+#include "texture.h"
+#include "imageformats/mipchain.h"
+#include "imageformats/pixelstorageloader.h"
+#define _INC_STDIO
+#include "3rdparty/tpunit++/tpunit++.hpp"
+#pragma warning(pop)
+
+/*! Fills texture with pixels of same 32-bit color
+    \param[in] t texture
+    \param[in] width a width of texture
+    \param[in] height a height of texture
+    \param[in] color a color
+ */
+static void fillMipChainTestTexture(sad::Texture& t, unsigned int width, unsigned int height, const sad::uchar* color)
+{
+    sad::Texture::DefaultBuffer* buffer = new sad::Texture::DefaultBuffer();
+    buffer->Data.resize(width * height * 4);
+    for(unsigned int i = 0; i < width * height; i++)
+    {
+        memcpy(&(buffer->Data[i * 4]), color, 4);
+    }
+    delete t.Buffer;
+    t.Buffer = buffer;
+    t.Width = width;
+    t.Height = height;
+    t.Bpp = 32;
+    t.Format = sad::Texture::SFT_R8_G8_B8_A8;
+}
+
+/*!
+ * Tests sad::imageformats::MipChain
+ */
+struct SadMipChainTest : tpunit::TestFixture
+{
+ public:
+   SadMipChainTest() : tpunit::TestFixture(
+       TEST(SadMipChainTest::testLevelSizes),
+       TEST(SadMipChainTest::testBoxFilter),
+       TEST(SadMipChainTest::testKaiserFilter),
+       TEST(SadMipChainTest::testPackedFormats),
+       TEST(SadMipChainTest::testSaveAndLoad)
+   ) {}
+
+   void testLevelSizes()
+   {
+       sad::uchar color[4] = { 10, 20, 30, 40 };
+       sad::Texture t;
+       fillMipChainTestTexture(t, 8, 4, color);
+       sad::imageformats::MipChain chain;
+       ASSERT_TRUE( chain.build(&t) );
+       ASSERT_TRUE( chain.levels() == 3 );
+       ASSERT_TRUE( chain.level(0).Width == 4 && chain.level(0).Height == 2 );
+       ASSERT_TRUE( chain.level(1).Width == 2 && chain.level(1).Height == 1 );
+       ASSERT_TRUE( chain.level(2).Width == 1 && chain.level(2).Height == 1 );
+       ASSERT_TRUE( chain.isCompleteFor(8, 4, 32) );
+       ASSERT_FALSE( chain.isCompleteFor(8, 8, 32) );
+       ASSERT_TRUE( sad::imageformats::MipChain::chainSize(8, 4, 32) == (8 + 2 + 1) * 4 );
+
+       t.Format = sad::Texture::SFT_R3_G3_B2;
+       ASSERT_FALSE( chain.build(&t) );
+       ASSERT_TRUE( chain.levels() == 0 );
+   }
+
+   void testBoxFilter()
+   {
+       // Two 2x2 blocks, so vectorized path is used for first level
+       sad::uchar pixels[4 * 2 * 4] = {
+           0, 10, 200, 255,   4, 10, 100, 255,   50, 0, 0, 0,     50, 0, 0, 0,
+           0, 11, 201, 255,   4, 10, 100, 255,   50, 0, 0, 255,   51, 1, 1, 255
+       };
+       sad::imageformats::MipChain chain;
+       ASSERT_TRUE( chain.build(pixels, 4, 2, 32, sad::Texture::SFT_R8_G8_B8_A8) );
+       ASSERT_TRUE( chain.levels() == 2 );
+       const sad::uchar* l0 = &(chain.level(0).Data[0]);
+       // (0 + 4 + 0 + 4 + 2) / 4 = 2, (10 + 10 + 11 + 10 + 2) / 4 = 10, (200 + 100 + 201 + 100 + 2) / 4 = 150
+       ASSERT_TRUE( l0[0] == 2 && l0[1] == 10 && l0[2] == 150 && l0[3] == 255 );
+       ASSERT_TRUE( l0[4] == 50 && l0[5] == 0 && l0[6] == 0 && l0[7] == 128 );
+       const sad::uchar* l1 = &(chain.level(1).Data[0]);
+       ASSERT_TRUE( l1[0] == 26 && l1[1] == 5 && l1[2] == 75 && l1[3] == 192 );
+
+       // A 24-bit odd-sized texture
+       sad::uchar rgb[3 * 3 * 3];
+       for(int i = 0; i < 9; i++)
+       {
+           rgb[i * 3] = 90;
+           rgb[i * 3 + 1] = 60;
+           rgb[i * 3 + 2] = 30;
+       }
+       ASSERT_TRUE( chain.build(rgb, 3, 3, 24, sad::Texture::SFT_R8_G8_B8_A8) );
+       ASSERT_TRUE( chain.levels() == 1 );
+       ASSERT_TRUE( chain.level(0).Data.size() == 3 );
+       ASSERT_TRUE( chain.level(0).Data[0] == 90 && chain.level(0).Data[1] == 60 && chain.level(0).Data[2] == 30 );
+   }
+
+   void testKaiserFilter()
+   {
+       sad::uchar color[4] = { 255, 128, 3, 77 };
+       sad::Texture t;
+       fillMipChainTestTexture(t, 16, 8, color);
+       sad::imageformats::MipChain chain;
+       ASSERT_TRUE( chain.build(&t, sad::imageformats::MipChain::MCF_KAISER) );
+       ASSERT_TRUE( chain.levels() == 4 );
+       for(unsigned int i = 0; i < chain.levels(); i++)
+       {
+           const sad::Vector<sad::uchar>& data = chain.level(i).Data;
+           for(size_t j = 0; j < data.size(); j++)
+           {
+               ASSERT_TRUE( data[j] == color[j % 4] );
+           }
+       }
+
+       // A step between black and white halves must stay in range and keep ordering
+       sad::uchar step[8 * 1 * 4];
+       for(int i = 0; i < 8; i++)
+       {
+           sad::uchar v = (i < 4) ? 0 : 255;
+           step[i * 4] = v;
+           step[i * 4 + 1] = v;
+           step[i * 4 + 2] = v;
+           step[i * 4 + 3] = 255;
+       }
+       ASSERT_TRUE( chain.build(step, 8, 1, 32, sad::Texture::SFT_R8_G8_B8_A8, sad::imageformats::MipChain::MCF_KAISER) );
+       const sad::Vector<sad::uchar>& l0 = chain.level(0).Data;
+       ASSERT_TRUE( chain.level(0).Width == 4 && chain.level(0).Height == 1 );
+       ASSERT_TRUE( l0[0] < 10 && l0[12] > 245 );
+       ASSERT_TRUE( l0[0] <= l0[4] && l0[4] <= l0[8] && l0[8] <= l0[12] );
+       ASSERT_TRUE( l0[3] == 255 && l0[15] == 255 );
+   }
+
+   void testPackedFormats()
+   {
+       unsigned short rgb565[4 * 4];
+       unsigned short rgba4444[4 * 4];
+       sad::uchar rgb332[4 * 4];
+       for(int i = 0; i < 16; i++)
+       {
+           rgb565[i] = (10 << 11) | (40 << 5) | 3;
+           rgba4444[i] = (1 << 12) | (2 << 8) | (3 << 4) | 15;
+           rgb332[i] = (5 << 5) | (2 << 2) | 1;
+       }
+       sad::imageformats::MipChain chain;
+       ASSERT_TRUE( chain.build(reinterpret_cast<sad::uchar*>(rgb565), 4, 4, 16, sad::Texture::SFT_R5_G6_B5) );
+       ASSERT_TRUE( chain.levels() == 2 );
+       ASSERT_TRUE( chain.level(1).Data.size() == 2 );
+       unsigned short v;
+       memcpy(&v, &(chain.level(1).Data[0]), 2);
+       ASSERT_TRUE( v == rgb565[0] );
+
+       ASSERT_TRUE( chain.build(reinterpret_cast<sad::uchar*>(rgba4444), 4, 4, 16, sad::Texture::SFT_R4_G4_B4_A4, sad::imageformats::MipChain::MCF_KAISER) );
+       memcpy(&v, &(chain.level(0).Data[6]), 2);
+       ASSERT_TRUE( v == rgba4444[0] );
+
+       ASSERT_TRUE( chain.build(rgb332, 4, 4, 8, sad::Texture::SFT_R3_G3_B2) );
+       ASSERT_TRUE( chain.level(0).Data.size() == 4 );
+       ASSERT_TRUE( chain.level(0).Data[3] == rgb332[0] );
+   }
+
+   void testSaveAndLoad()
+   {
+       sad::uchar color[4] = { 1, 2, 3, 4 };
+       sad::Texture t;
+       fillMipChainTestTexture(t, 4, 4, color);
+       t.pixel(0, 0)[0] = 200;
+       ASSERT_TRUE( t.buildMipChain() );
+
+       sad::imageformats::PixelStorageLoader loader(sad::imageformats::PixelStorageLoader::SRGBASettings);
+       FILE* file = fopen("tests/mipchain.srgba", "wb");
+       ASSERT_TRUE( file != NULL );
+       bool saved = loader.save(file, &t);
+       fclose(file);
+       ASSERT_TRUE( saved );
+
+       sad::Texture loaded;
+       file = fopen("tests/mipchain.srgba", "rb");
+       ASSERT_TRUE( file != NULL );
+       bool result = loader.load(file, &loaded);
+       fclose(file);
+       remove("tests/mipchain.srgba");
+       ASSERT_TRUE( result );
+       ASSERT_TRUE( loaded.width() == 4 && loaded.height() == 4 );
+       ASSERT_TRUE( loaded.data()[0] == 200 );
+       ASSERT_TRUE( loaded.mipChain() != NULL );
+       ASSERT_TRUE( loaded.mipChain()->isCompleteFor(4, 4, 32) );
+       for(unsigned int i = 0; i < t.mipChain()->levels(); i++)
+       {
+           ASSERT_TRUE( loaded.mipChain()->level(i).Data == t.mipChain()->level(i).Data );
+       }
+       // (200 + 1 + 1 + 1 + 2) / 4 = 51
+       ASSERT_TRUE( loaded.mipChain()->level(0).Data[0] == 51 );
+   }
+
+} _sad_mip_chain_test;
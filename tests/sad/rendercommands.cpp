@@ -0,0 +1,235 @@
+#pragma warning(push)
+#pragma warning(disable: 4273)
+#pragma warning(disable: 4351)
+#include <cstdio>
+#include "renderer.h"
+#include "mainloop.h"
+#include "rendering/commandbuffer.h"
+#include "rendering/nullbackend.h"
+#include "rendering/recorder.h"
+#define _INC_STDIO
+#include "3rdparty/tpunit++/tpunit++.hpp"
+#pragma warning(pop)
+
+
+/*! A node, which renders two lines via primitive renderer
+ */
+class RenderCommandsTestNode: public sad::SceneNode
+{
+public:
+    /*! Creates new node
+     */
+    RenderCommandsTestNode() : Rendered(0)
+    {
+    }
+    /*! Renders lines
+     */
+    virtual void render() override
+    {
+        ++Rendered;
+        this->renderer()->render()->line(sad::Point2D(0, 0), sad::Point2D(10, 10), sad::AColor(255, 0, 0, 255));
+        this->renderer()->render()->rectangle(sad::Rect2D(0, 0, 10, 10), sad::AColor(0, 255, 0, 255));
+    }
+    /*! Amount of renderings
+     */
+    int Rendered;
+};
+
+/*! Records two frames into backend
+    \param[in] backend a backend
+    \param[in] t1 first texture
+    \param[in] t2 second texture
+ */
+static void recordRenderCommandsFrames(sad::rendering::Backend* backend, sad::Texture* t1, sad::Texture* t2)
+{
+    sad::Rect2D area(0, 0, 32, 32);
+    sad::Rect2D tc(0, 0, 1, 1);
+    float vertexes[16] = { 0 };
+    float tcs[16] = { 0 };
+    unsigned char colors[32] = { 0 };
+    sad::Point2D points[4] = { sad::Point2D(0, 0), sad::Point2D(1, 1), sad::Point2D(2, 2), sad::Point2D(3, 3) };
+
+    backend->startFrame();
+    backend->setOrthographicProjection(800, 600);
+    backend->pushMatrix();
+    backend->translate(10, 20, 0);
+    backend->rotate(45, 0, 0, 1);
+    backend->drawSprite(t1, area, tc, sad::AColor(255, 255, 255, 255));
+    backend->drawSprite(t1, area, tc, sad::AColor(255, 255, 255, 255));
+    backend->drawSprite(t2, area, tc, sad::AColor(255, 0, 255, 255));
+    backend->drawQuads(t1, vertexes, tcs, colors, 2);
+    backend->drawLines(points, 4, sad::AColor(0, 0, 0, 255));
+    backend->drawText(12, std::function<void()>());
+    backend->popMatrix();
+    backend->finishFrame();
+
+    backend->startFrame();
+    backend->drawSprite(t2, area, tc, sad::AColor(255, 255, 255, 255));
+    backend->finishFrame();
+}
+
+/*! Checks, whether statistics are equal
+    \param[in] a first statistics
+    \param[in] b second statistics
+    \return whether they are equal
+ */
+static bool equalRenderCommandsStatistics(const sad::rendering::FrameStatistics& a, const sad::rendering::FrameStatistics& b)
+{
+    return a.Commands == b.Commands
+        && a.DrawCalls == b.DrawCalls
+        && a.Quads == b.Quads
+        && a.Lines == b.Lines
+        && a.Characters == b.Characters
+        && a.StateChanges == b.StateChanges
+        && a.TextureSwitches == b.TextureSwitches;
+}
+
+/*!
+ * Tests recording and replaying rendering commands
+ */
+struct SadRenderCommandsTest : tpunit::TestFixture
+{
+ public:
+   SadRenderCommandsTest() : tpunit::TestFixture(
+       TEST(SadRenderCommandsTest::testNullBackend),
+       TEST(SadRenderCommandsTest::testRecordAndReplay),
+       TEST(SadRenderCommandsTest::testSaveLoad),
+       TEST(SadRenderCommandsTest::testMalformed),
+       TEST(SadRenderCommandsTest::testRendererRecording)
+   ) {}
+
+   // ReSharper disable once CppMemberFunctionMayBeStatic
+   // ReSharper disable once CppMemberFunctionMayBeConst
+   void testNullBackend()
+   {
+       sad::Texture t1, t2;
+       sad::rendering::NullBackend backend;
+       backend.setKeepsHistory(true);
+       recordRenderCommandsFrames(&backend, &t1, &t2);
+
+       ASSERT_TRUE( backend.frameCount() == 2 );
+       ASSERT_TRUE( backend.frames().size() == 2 );
+       const sad::rendering::FrameStatistics& first = backend.frames()[0];
+       ASSERT_TRUE( first.Commands == 11 );
+       ASSERT_TRUE( first.DrawCalls == 6 );
+       ASSERT_TRUE( first.Quads == 5 );
+       ASSERT_TRUE( first.Lines == 2 );
+       ASSERT_TRUE( first.Characters == 12 );
+       // t1, t2, t1
+       ASSERT_TRUE( first.TextureSwitches == 3 );
+       const sad::rendering::FrameStatistics& second = backend.lastFrame();
+       ASSERT_TRUE( second.Commands == 1 );
+       // Text resets bound texture
+       ASSERT_TRUE( second.TextureSwitches == 1 );
+       ASSERT_TRUE( backend.total().DrawCalls == 7 );
+   }
+
+   // ReSharper disable once CppMemberFunctionMayBeStatic
+   // ReSharper disable once CppMemberFunctionMayBeConst
+   void testRecordAndReplay()
+   {
+       sad::Texture t1, t2;
+       t1.Width = 64;
+       t1.Height = 32;
+       sad::rendering::CommandBuffer buffer;
+       sad::rendering::NullBackend direct;
+       direct.setKeepsHistory(true);
+       sad::rendering::Recorder recorder(&buffer, &direct);
+       recordRenderCommandsFrames(&recorder, &t1, &t2);
+
+       ASSERT_TRUE( buffer.frameCount() == 2 );
+       // 12 commands, 2 frames and 2 texture definitions
+       ASSERT_TRUE( buffer.commandCount() == 18 );
+
+       sad::rendering::NullBackend replayed;
+       replayed.setKeepsHistory(true);
+       ASSERT_TRUE( buffer.replay(&replayed) );
+       ASSERT_TRUE( replayed.frames().size() == 2 );
+       for(size_t i = 0; i < 2; i++)
+       {
+           ASSERT_TRUE( equalRenderCommandsStatistics(direct.frames()[i], replayed.frames()[i]) );
+       }
+   }
+
+   // ReSharper disable once CppMemberFunctionMayBeStatic
+   // ReSharper disable once CppMemberFunctionMayBeConst
+   void testSaveLoad()
+   {
+       sad::Texture t1, t2;
+       sad::rendering::CommandBuffer buffer;
+       sad::rendering::Recorder recorder(&buffer);
+       recordRenderCommandsFrames(&recorder, &t1, &t2);
+
+       ASSERT_TRUE( buffer.save("tests/rendercommands.bin") );
+       sad::rendering::CommandBuffer loaded;
+       ASSERT_TRUE( loaded.load("tests/rendercommands.bin") );
+       ASSERT_TRUE( loaded.frameCount() == buffer.frameCount() );
+       ASSERT_TRUE( loaded.commandCount() == buffer.commandCount() );
+       ASSERT_TRUE( loaded.data().size() == buffer.data().size() );
+
+       sad::rendering::NullBackend original, replayed;
+       ASSERT_TRUE( buffer.replay(&original) );
+       ASSERT_TRUE( loaded.replay(&replayed) );
+       ASSERT_TRUE( equalRenderCommandsStatistics(original.total(), replayed.total()) );
+       remove("tests/rendercommands.bin");
+   }
+
+   // ReSharper disable once CppMemberFunctionMayBeStatic
+   // ReSharper disable once CppMemberFunctionMayBeConst
+   void testMalformed()
+   {
+       sad::Texture t1, t2;
+       sad::rendering::CommandBuffer buffer;
+       // Texture is used without definition
+       buffer.startFrame();
+       buffer.drawSprite(3, sad::Rect2D(0, 0, 1, 1), sad::Rect2D(0, 0, 1, 1), sad::AColor(0, 0, 0, 0));
+       buffer.finishFrame();
+       sad::rendering::NullBackend backend;
+       ASSERT_FALSE( buffer.replay(&backend) );
+
+       ASSERT_FALSE( buffer.load("tests/rendercommands_not_existing.bin") );
+
+       FILE* file = fopen("tests/rendercommands_truncated.bin", "wb");
+       fputs("SADRCMD1 truncated", file);
+       fclose(file);
+       ASSERT_FALSE( buffer.load("tests/rendercommands_truncated.bin") );
+       remove("tests/rendercommands_truncated.bin");
+   }
+
+   // ReSharper disable once CppMemberFunctionMayBeStatic
+   // ReSharper disable once CppMemberFunctionMayBeConst
+   void testRendererRecording()
+   {
+       sad::Renderer r;
+       r.setHeadless(true);
+       sad::Scene* scene = new sad::Scene();
+       RenderCommandsTestNode* node = new RenderCommandsTestNode();
+       scene->addNode(node);
+       r.addScene(scene);
+
+       sad::rendering::CommandBuffer buffer;
+       r.startRecording(&buffer);
+       ASSERT_TRUE( r.recording() );
+       r.mainLoop()->setFrameLimit(3);
+       ASSERT_TRUE( r.run() );
+       r.stopRecording();
+       ASSERT_FALSE( r.recording() );
+
+       ASSERT_TRUE( node->Rendered == 3 );
+       ASSERT_TRUE( buffer.frameCount() == 3 );
+
+       sad::rendering::NullBackend replayed;
+       replayed.setKeepsHistory(true);
+       ASSERT_TRUE( buffer.replay(&replayed) );
+       ASSERT_TRUE( replayed.frames().size() == 3 );
+       // A line and rectangle in every frame
+       ASSERT_TRUE( replayed.frames()[2].Lines == 5 );
+       ASSERT_TRUE( replayed.frames()[2].DrawCalls == 2 );
+
+       // Renderer backend received same commands
+       sad::rendering::NullBackend* backend = static_cast<sad::rendering::NullBackend*>(r.backend());
+       ASSERT_TRUE( backend->frameCount() == 3 );
+       ASSERT_TRUE( equalRenderCommandsStatistics(backend->lastFrame(), replayed.frames()[2]) );
+   }
+
+} _sad_render_commands_test;
@@ -0,0 +1,51 @@
+#pragma warning(push)
+#pragma warning(disable: 4273)
+#pragma warning(disable: 4351)
+#include <stdio.h>
+#include <vector>
+#include <sadworkerpool.h>
+#include "3rdparty/tpunit++/tpunit++.hpp"
+#pragma warning(pop)
+
+
+
+/*!
+ * Tests pool of worker threads
+ */
+struct sadWorkerPoolTest : tpunit::TestFixture
+{
+public:
+
+    sadWorkerPoolTest() : tpunit::TestFixture(
+        TEST(sadWorkerPoolTest::testAllTasksPerformedOnce),
+        TEST(sadWorkerPoolTest::testSingleThread)
+    ) {}
+
+    void testAllTasksPerformedOnce()
+    {
+        sad::WorkerPool pool(4);
+        ASSERT_TRUE( pool.threadCount() == 4 );
+        for(int run = 0; run < 10; run++)
+        {
+            std::vector<int> counters(1000, 0);
+            pool.run(counters.size(), [&counters](size_t i) { counters[i] += 1; });
+            bool all_performed_once = true;
+            for(size_t i = 0; i < counters.size(); i++)
+            {
+                all_performed_once = all_performed_once && (counters[i] == 1);
+            }
+            ASSERT_TRUE( all_performed_once );
+        }
+        pool.run(0, [](size_t) {});
+    }
+
+    void testSingleThread()
+    {
+        sad::WorkerPool pool(0);
+        ASSERT_TRUE( pool.threadCount() == 1 );
+        int sum = 0;
+        pool.run(10, [&sum](size_t i) { sum += static_cast<int>(i); });
+        ASSERT_TRUE( sum == 45 );
+    }
+
+} _sad_worker_pool_test;
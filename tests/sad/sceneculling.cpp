@@ -0,0 +1,168 @@
+#pragma warning(push)
+#pragma warning(disable: 4273)
+#pragma warning(disable: 4351)
+#include <cstdio>
+#include "scene.h"
+#include "orthographiccamera.h"
+#include "geometry2d.h"
+#include "fuzzyequal.h"
+#define _INC_STDIO
+#include "3rdparty/tpunit++/tpunit++.hpp"
+#pragma warning(pop)
+
+
+/*! A node with fixed area, which counts, how many times it was rendered
+ */
+class CullingTestNode: public sad::SceneNode
+{
+public:
+    /*! Creates new node with specified area
+        \param[in] area an area
+     */
+    CullingTestNode(const sad::Rect2D& area) : Rendered(0), m_area(area)
+    {
+    }
+    /*! Counts rendering
+     */
+    virtual void render() override
+    {
+        ++Rendered;
+    }
+    /*! Returns area of node
+        \param[out] r regions
+     */
+    virtual void regions(sad::Vector<sad::Rect2D> & r) override
+    {
+        r << m_area;
+    }
+    /*! Amount of renderings
+     */
+    int Rendered;
+private:
+    /*! An area of node
+     */
+    sad::Rect2D m_area;
+};
+
+/*! A node without bounds
+ */
+class UnboundedTestNode: public sad::SceneNode
+{
+public:
+    /*! Creates new node
+     */
+    UnboundedTestNode() : Rendered(0)
+    {
+    }
+    /*! Counts rendering
+     */
+    virtual void render() override
+    {
+        ++Rendered;
+    }
+    /*! Amount of renderings
+     */
+    int Rendered;
+};
+
+/*!
+ * Tests culling of nodes outside of camera's view in sad::Scene
+ */
+struct SadSceneCullingTest : tpunit::TestFixture
+{
+ public:
+   SadSceneCullingTest() : tpunit::TestFixture(
+       TEST(SadSceneCullingTest::testBoundingBox),
+       TEST(SadSceneCullingTest::testViewRect),
+       TEST(SadSceneCullingTest::testCulling)
+   ) {}
+
+   // ReSharper disable once CppMemberFunctionMayBeStatic
+   // ReSharper disable once CppMemberFunctionMayBeConst
+   void testBoundingBox()
+   {
+       sad::Rect2D r(sad::Point2D(5, 0), sad::Point2D(10, 5), sad::Point2D(5, 10), sad::Point2D(0, 5));
+       sad::Rect2D box = sad::boundingBox(r);
+       ASSERT_TRUE( sad::equal(box, sad::Rect2D(0, 0, 10, 10)) );
+       sad::extendBoundingBox(box, sad::Rect2D(-5, 2, 3, 20));
+       ASSERT_TRUE( sad::equal(box, sad::Rect2D(-5, 0, 10, 20)) );
+       ASSERT_TRUE( sad::collidesAABB(box, sad::Rect2D(10, 20, 30, 30)) );
+       ASSERT_FALSE( sad::collidesAABB(box, sad::Rect2D(11, 0, 30, 30)) );
+   }
+
+   // ReSharper disable once CppMemberFunctionMayBeStatic
+   // ReSharper disable once CppMemberFunctionMayBeConst
+   void testViewRect()
+   {
+       sad::Camera defaultcamera;
+       sad::Rect2D view;
+       ASSERT_FALSE( defaultcamera.viewRect(view) );
+
+       sad::OrthographicCamera camera(800, 600);
+       ASSERT_TRUE( camera.viewRect(view) );
+       ASSERT_TRUE( sad::equal(view, sad::Rect2D(0, 0, 800, 600)) );
+
+       // Moving camera to the left shows part of scene to the right
+       camera.move(sad::Point2D(-100, 50));
+       ASSERT_TRUE( camera.viewRect(view) );
+       ASSERT_TRUE( sad::equal(view, sad::Rect2D(100, -50, 900, 550)) );
+
+       // Rotation by 90 degrees around center of screen swaps sides of view
+       camera.TranslationOffset = sad::Vector3D(0, 0, 0);
+       camera.TemporaryRotationOffset = sad::Vector3D(400, 300, 0);
+       camera.RotationVectorDirection = sad::Vector3D(0, 0, 1);
+       camera.Angle = 90;
+       ASSERT_TRUE( camera.viewRect(view) );
+       ASSERT_TRUE( sad::equal(view, sad::Rect2D(100, -100, 700, 700)) );
+
+       // Rotation around other axes does not produce rectangular view
+       camera.RotationVectorDirection = sad::Vector3D(1, 0, 0);
+       ASSERT_FALSE( camera.viewRect(view) );
+   }
+
+   // ReSharper disable once CppMemberFunctionMayBeStatic
+   // ReSharper disable once CppMemberFunctionMayBeConst
+   void testCulling()
+   {
+       sad::Scene scene;
+       scene.setCamera(new sad::OrthographicCamera(800, 600));
+       CullingTestNode* inside = new CullingTestNode(sad::Rect2D(10, 10, 20, 20));
+       CullingTestNode* partially = new CullingTestNode(sad::Rect2D(790, 590, 820, 620));
+       CullingTestNode* outside = new CullingTestNode(sad::Rect2D(900, 10, 920, 20));
+       UnboundedTestNode* unbounded = new UnboundedTestNode();
+       scene.addNode(inside);
+       scene.addNode(partially);
+       scene.addNode(outside);
+       scene.addNode(unbounded);
+
+       // Culling is disabled by default
+       scene.render();
+       ASSERT_TRUE( outside->Rendered == 1 );
+       ASSERT_TRUE( scene.renderedNodeCount() == 4 );
+       ASSERT_TRUE( scene.culledNodeCount() == 0 );
+
+       scene.setCullingEnabled(true);
+       scene.render();
+       ASSERT_TRUE( inside->Rendered == 2 );
+       ASSERT_TRUE( partially->Rendered == 2 );
+       ASSERT_TRUE( outside->Rendered == 1 );
+       ASSERT_TRUE( unbounded->Rendered == 2 );
+       ASSERT_TRUE( scene.renderedNodeCount() == 3 );
+       ASSERT_TRUE( scene.culledNodeCount() == 1 );
+
+       // Margin extends view
+       scene.setCullingMargin(100);
+       scene.render();
+       ASSERT_TRUE( outside->Rendered == 2 );
+       ASSERT_TRUE( scene.culledNodeCount() == 0 );
+
+       // Moving camera shows node
+       scene.setCullingMargin(0);
+       scene.camera().move(sad::Point2D(-200, 0));
+       scene.render();
+       ASSERT_TRUE( outside->Rendered == 3 );
+       ASSERT_TRUE( inside->Rendered == 3 );
+       ASSERT_TRUE( scene.culledNodeCount() == 1 );
+   }
+
+} _sad_scene_culling_test;
@@ -0,0 +1,289 @@
+#pragma warning(push)
+#pragma warning(disable: 4273)
+#pragma warning(disable: 4351)
+#include <cstdio>
+#include "renderer.h"
+#include "scene.h"
+#include "sprite2d.h"
+#include "spritebatch.h"
+#include "texture.h"
+#include "rendering/commandbuffer.h"
+#include "rendering/nullbackend.h"
+#define _INC_STDIO
+#include "3rdparty/tpunit++/tpunit++.hpp"
+#pragma warning(pop)
+
+
+/*! A draw call, received by SpriteBatchTestBackend
+ */
+struct SpriteBatchTestDrawCall
+{
+    /*! A kind of draw call: 's' for sprite, 'q' for quads, 'l' for lines
+     */
+    char Kind;
+    /*! A texture of call (NULL for lines)
+     */
+    sad::Texture* Texture;
+    /*! Amount of quads for quads, 1 for sprite, amount of points for lines
+     */
+    unsigned int Count;
+};
+
+/*! A backend, which records draw calls in order of issuing
+ */
+class SpriteBatchTestBackend: public sad::rendering::NullBackend
+{
+public:
+    /*! Records a sprite
+        \param[in] texture a texture
+        \param[in] area a rendered area
+        \param[in] texture_coordinates a texture coordinates
+        \param[in] color a color
+     */
+    virtual void drawSprite(
+        sad::Texture* texture,
+        const sad::Rect2D& area,
+        const sad::Rect2D& texture_coordinates,
+        const sad::AColor& color
+    ) override
+    {
+        SpriteBatchTestDrawCall call = { 's', texture, 1 };
+        Calls << call;
+        this->sad::rendering::NullBackend::drawSprite(texture, area, texture_coordinates, color);
+    }
+    /*! Records quads
+        \param[in] texture a texture
+        \param[in] vertexes a coordinates of vertexes
+        \param[in] texture_coordinates a texture coordinates
+        \param[in] colors a colors
+        \param[in] quads amount of quads
+     */
+    virtual void drawQuads(
+        sad::Texture* texture,
+        const float* vertexes,
+        const float* texture_coordinates,
+        const unsigned char* colors,
+        unsigned int quads
+    ) override
+    {
+        SpriteBatchTestDrawCall call = { 'q', texture, quads };
+        Calls << call;
+        this->sad::rendering::NullBackend::drawQuads(texture, vertexes, texture_coordinates, colors, quads);
+    }
+    /*! Records lines
+        \param[in] points a pairs of points of lines
+        \param[in] count amount of points
+        \param[in] color a color of lines
+     */
+    virtual void drawLines(const sad::Point2D* points, unsigned int count, const sad::AColor& color) override
+    {
+        SpriteBatchTestDrawCall call = { 'l', NULL, count };
+        Calls << call;
+        this->sad::rendering::NullBackend::drawLines(points, count, color);
+    }
+    /*! Checks, whether call with specified index matches
+        \param[in] i index of call
+        \param[in] kind a kind of call
+        \param[in] texture a texture
+        \param[in] count amount of quads or points
+        \return whether it matches
+     */
+    bool isCall(size_t i, char kind, sad::Texture* texture, unsigned int count) const
+    {
+        if (i >= Calls.size())
+        {
+            return false;
+        }
+        return Calls[i].Kind == kind && Calls[i].Texture == texture && Calls[i].Count == count;
+    }
+
+    /*! A calls in order of issuing
+     */
+    sad::Vector<SpriteBatchTestDrawCall> Calls;
+};
+
+/*! A non-batchable node, which renders a line
+ */
+class SpriteBatchTestLineNode: public sad::SceneNode
+{
+public:
+    /*! Renders line
+     */
+    virtual void render() override
+    {
+        this->renderer()->render()->line(sad::Point2D(0, 0), sad::Point2D(10, 10), sad::AColor(255, 0, 0, 255));
+    }
+};
+
+/*! Makes new sprite with texture
+    \param[in] tex a texture
+    \return sprite
+ */
+static sad::Sprite2D* makeSpriteBatchTestSprite(sad::Texture* tex)
+{
+    return new sad::Sprite2D(tex, sad::Rect2D(0, 0, 16, 16), sad::Rect2D(0, 0, 16, 16));
+}
+
+/*!
+ * Tests batching of sprites
+ */
+struct SadSpriteBatchTest : tpunit::TestFixture
+{
+ public:
+   SadSpriteBatchTest() : tpunit::TestFixture(
+       TEST(SadSpriteBatchTest::testTextureRuns),
+       TEST(SadSpriteBatchTest::testSavedDrawCalls),
+       TEST(SadSpriteBatchTest::testSceneOrder),
+       TEST(SadSpriteBatchTest::testSceneDisabled)
+   ) {}
+
+   // ReSharper disable once CppMemberFunctionMayBeStatic
+   // ReSharper disable once CppMemberFunctionMayBeConst
+   void testTextureRuns()
+   {
+       sad::Texture t1, t2;
+       sad::Renderer r;
+       r.setHeadless(true);
+       SpriteBatchTestBackend* backend = new SpriteBatchTestBackend();
+       r.setBackend(backend);
+
+       sad::SpriteBatch batch;
+       batch.setRenderer(&r);
+       batch.startFrame();
+       sad::Rect2D area(0, 0, 16, 16);
+       sad::Rect2D tc(0, 0, 1, 1);
+       sad::AColor clr(255, 255, 255, 0);
+       batch.add(&t1, area, tc, clr);
+       batch.add(&t1, area, tc, clr);
+       ASSERT_TRUE( batch.pendingQuads() == 2 );
+       ASSERT_TRUE( backend->Calls.size() == 0 );
+       // Changing texture flushes previous run
+       batch.add(&t2, area, tc, clr);
+       ASSERT_TRUE( batch.pendingQuads() == 1 );
+       batch.add(&t1, area, tc, clr);
+       batch.flush();
+       ASSERT_TRUE( batch.pendingQuads() == 0 );
+       // Flush of empty batch does nothing
+       batch.flush();
+
+       ASSERT_TRUE( backend->Calls.size() == 3 );
+       ASSERT_TRUE( backend->isCall(0, 'q', &t1, 2) );
+       ASSERT_TRUE( backend->isCall(1, 'q', &t2, 1) );
+       ASSERT_TRUE( backend->isCall(2, 'q', &t1, 1) );
+       ASSERT_TRUE( batch.drawCalls() == 3 );
+       ASSERT_TRUE( batch.batchedQuads() == 4 );
+   }
+
+   // ReSharper disable once CppMemberFunctionMayBeStatic
+   // ReSharper disable once CppMemberFunctionMayBeConst
+   void testSavedDrawCalls()
+   {
+       sad::Texture t1, t2;
+       sad::Renderer r;
+       r.setHeadless(true);
+       SpriteBatchTestBackend* backend = new SpriteBatchTestBackend();
+       r.setBackend(backend);
+
+       sad::SpriteBatch batch;
+       batch.setRenderer(&r);
+       batch.startFrame();
+       sad::Rect2D area(0, 0, 16, 16);
+       sad::Rect2D tc(0, 0, 1, 1);
+       sad::AColor clr(255, 255, 255, 0);
+       for(int i = 0; i < 3; i++)
+       {
+           batch.add(&t1, area, tc, clr);
+       }
+       batch.add(&t2, area, tc, clr);
+       batch.add(&t2, area, tc, clr);
+       batch.flush();
+       // 5 quads in 2 calls
+       ASSERT_TRUE( batch.savedDrawCalls() == 3 );
+       ASSERT_TRUE( batch.lastFrameSavedDrawCalls() == 0 );
+
+       batch.startFrame();
+       ASSERT_TRUE( batch.savedDrawCalls() == 0 );
+       ASSERT_TRUE( batch.lastFrameSavedDrawCalls() == 3 );
+       ASSERT_TRUE( batch.drawCalls() == 0 );
+       ASSERT_TRUE( batch.batchedQuads() == 0 );
+
+       batch.add(&t1, area, tc, clr);
+       batch.flush();
+       ASSERT_TRUE( batch.savedDrawCalls() == 0 );
+
+       batch.startFrame();
+       ASSERT_TRUE( batch.lastFrameSavedDrawCalls() == 0 );
+       ASSERT_TRUE( backend->Calls.size() == 3 );
+   }
+
+   // ReSharper disable once CppMemberFunctionMayBeStatic
+   // ReSharper disable once CppMemberFunctionMayBeConst
+   void testSceneOrder()
+   {
+       sad::Texture t1, t2;
+       t1.Width = 16;
+       t1.Height = 16;
+       t2.Width = 16;
+       t2.Height = 16;
+       sad::Renderer r;
+       r.setHeadless(true);
+       SpriteBatchTestBackend* backend = new SpriteBatchTestBackend();
+       r.setBackend(backend);
+
+       sad::Scene* scene = new sad::Scene();
+       scene->addNode(makeSpriteBatchTestSprite(&t1));
+       scene->addNode(makeSpriteBatchTestSprite(&t1));
+       scene->addNode(new SpriteBatchTestLineNode());
+       scene->addNode(makeSpriteBatchTestSprite(&t1));
+       scene->addNode(makeSpriteBatchTestSprite(&t2));
+       scene->addNode(makeSpriteBatchTestSprite(&t2));
+       r.addScene(scene);
+
+       // Headless scene is rendered via backend only, while recording
+       sad::rendering::CommandBuffer buffer;
+       r.startRecording(&buffer);
+       r.spriteBatch()->startFrame();
+       scene->render();
+       r.stopRecording();
+
+       ASSERT_TRUE( backend->Calls.size() == 4 );
+       ASSERT_TRUE( backend->isCall(0, 'q', &t1, 2) );
+       ASSERT_TRUE( backend->Calls[1].Kind == 'l' );
+       ASSERT_TRUE( backend->isCall(2, 'q', &t1, 1) );
+       ASSERT_TRUE( backend->isCall(3, 'q', &t2, 2) );
+       ASSERT_TRUE( r.spriteBatch()->drawCalls() == 3 );
+       ASSERT_TRUE( r.spriteBatch()->savedDrawCalls() == 2 );
+       ASSERT_TRUE( r.spriteBatch()->pendingQuads() == 0 );
+   }
+
+   // ReSharper disable once CppMemberFunctionMayBeStatic
+   // ReSharper disable once CppMemberFunctionMayBeConst
+   void testSceneDisabled()
+   {
+       sad::Texture t1;
+       t1.Width = 16;
+       t1.Height = 16;
+       sad::Renderer r;
+       r.setHeadless(true);
+       SpriteBatchTestBackend* backend = new SpriteBatchTestBackend();
+       r.setBackend(backend);
+       r.spriteBatch()->setEnabled(false);
+
+       sad::Scene* scene = new sad::Scene();
+       scene->addNode(makeSpriteBatchTestSprite(&t1));
+       scene->addNode(makeSpriteBatchTestSprite(&t1));
+       r.addScene(scene);
+
+       sad::rendering::CommandBuffer buffer;
+       r.startRecording(&buffer);
+       r.spriteBatch()->startFrame();
+       scene->render();
+       r.stopRecording();
+
+       ASSERT_TRUE( backend->Calls.size() == 2 );
+       ASSERT_TRUE( backend->isCall(0, 's', &t1, 1) );
+       ASSERT_TRUE( backend->isCall(1, 's', &t1, 1) );
+       ASSERT_TRUE( r.spriteBatch()->drawCalls() == 0 );
+   }
+
+} _sad_sprite_batch_test;
@@ -0,0 +1,158 @@
+#pragma warning(push)
+#pragma warning(disable: 4273)
+#pragma warning(disable: 4351)
+#include <cstdio>
+#include "renderer.h"
+#include "texture.h"
+#include "rendering/textureresidency.h"
+#define _INC_STDIO
+#include "3rdparty/tpunit++/tpunit++.hpp"
+#pragma warning(pop)
+
+/*! Makes texture, which is treated like uploaded to GPU
+    \param[in] r renderer
+    \param[in] size a size of side of texture
+    \return texture
+ */
+static sad::Texture* makeResidentTestTexture(sad::Renderer* r, unsigned int size)
+{
+    sad::Texture* t = new sad::Texture();
+    t->BuildMipMaps = false;
+    t->Bpp = 32;
+    t->Width = size;
+    t->Height = size;
+    t->setRenderer(r);
+    t->OnGPU = true;
+    r->textureResidency()->textureUploaded(t);
+    return t;
+}
+
+/*!
+ * Tests sad::rendering::TextureResidency
+ */
+struct SadTextureResidencyTest : tpunit::TestFixture
+{
+ public:
+   SadTextureResidencyTest() : tpunit::TestFixture(
+       TEST(SadTextureResidencyTest::testGPUMemorySize),
+       TEST(SadTextureResidencyTest::testTracking),
+       TEST(SadTextureResidencyTest::testEvictsLeastRecentlyUsed),
+       TEST(SadTextureResidencyTest::testKeepsTexturesOfCurrentFrame)
+   ) {}
+
+   void testGPUMemorySize()
+   {
+       sad::Texture t;
+       t.Width = 64;
+       t.Height = 32;
+       t.Bpp = 32;
+       t.BuildMipMaps = false;
+       ASSERT_TRUE( t.gpuMemorySize() == 64 * 32 * 4 );
+       t.Bpp = 24;
+       ASSERT_TRUE( t.gpuMemorySize() == 64 * 32 * 3 );
+       t.Format = sad::Texture::SFT_R5_G6_B5;
+       ASSERT_TRUE( t.gpuMemorySize() == 64 * 32 * 2 );
+       t.Format = sad::Texture::SFT_R3_G3_B2;
+       ASSERT_TRUE( t.gpuMemorySize() == 64 * 32 );
+       t.BuildMipMaps = true;
+       ASSERT_TRUE( t.gpuMemorySize() == 64 * 32 + 64 * 32 / 3 );
+   }
+
+   void testTracking()
+   {
+       sad::Renderer r;
+       sad::rendering::TextureResidency* residency = r.textureResidency();
+       sad::Texture* t1 = makeResidentTestTexture(&r, 64);
+       sad::Texture* t2 = makeResidentTestTexture(&r, 32);
+       ASSERT_TRUE( residency->residentTextures() == 2 );
+       ASSERT_TRUE( residency->residentBytes() == 64 * 64 * 4 + 32 * 32 * 4 );
+
+       residency->startFrame();
+       residency->textureBound(t2);
+       ASSERT_TRUE( residency->lastBoundFrame(t2) == residency->frame() );
+       ASSERT_TRUE( residency->lastBoundFrame(t1) == residency->frame() - 1 );
+
+       t1->unload();
+       ASSERT_FALSE( t1->OnGPU );
+       ASSERT_FALSE( residency->isResident(t1) );
+       ASSERT_TRUE( residency->residentBytes() == 32 * 32 * 4 );
+       // Explicit unloading is not an eviction
+       ASSERT_TRUE( residency->evictions() == 0 );
+
+       delete t2;
+       ASSERT_TRUE( residency->residentTextures() == 0 );
+       ASSERT_TRUE( residency->residentBytes() == 0 );
+       delete t1;
+   }
+
+   void testEvictsLeastRecentlyUsed()
+   {
+       sad::Renderer r;
+       sad::rendering::TextureResidency* residency = r.textureResidency();
+       const size_t size = 64 * 64 * 4;
+       residency->setBudget(size * 2);
+
+       sad::Texture* t1 = makeResidentTestTexture(&r, 64);
+       residency->startFrame();
+       sad::Texture* t2 = makeResidentTestTexture(&r, 64);
+       residency->startFrame();
+       residency->textureBound(t1);
+       residency->startFrame();
+       sad::Texture* t3 = makeResidentTestTexture(&r, 64);
+
+       // t2 was not bound for longest time
+       ASSERT_TRUE( residency->evictions() == 1 );
+       ASSERT_FALSE( t2->OnGPU );
+       ASSERT_TRUE( t1->OnGPU );
+       ASSERT_TRUE( t3->OnGPU );
+       ASSERT_TRUE( residency->residentBytes() == size * 2 );
+
+       // Evicted texture is uploaded again, evicting other one
+       residency->startFrame();
+       t2->OnGPU = true;
+       residency->textureUploaded(t2);
+       ASSERT_TRUE( residency->reuploads() == 1 );
+       ASSERT_TRUE( residency->evictions() == 2 );
+       ASSERT_FALSE( t1->OnGPU );
+       ASSERT_TRUE( residency->residentBytes() == size * 2 );
+
+       // Lowering budget evicts immediately
+       residency->startFrame();
+       residency->setBudget(size);
+       ASSERT_TRUE( residency->evictions() == 3 );
+       ASSERT_TRUE( residency->residentTextures() == 1 );
+
+       residency->resetStatistics();
+       ASSERT_TRUE( residency->evictions() == 0 );
+       ASSERT_TRUE( residency->reuploads() == 0 );
+
+       delete t1;
+       delete t2;
+       delete t3;
+   }
+
+   void testKeepsTexturesOfCurrentFrame()
+   {
+       sad::Renderer r;
+       sad::rendering::TextureResidency* residency = r.textureResidency();
+       residency->setBudget(1);
+       sad::Texture* t1 = makeResidentTestTexture(&r, 16);
+       sad::Texture* t2 = makeResidentTestTexture(&r, 16);
+       ASSERT_TRUE( residency->evictions() == 0 );
+       ASSERT_TRUE( residency->residentTextures() == 2 );
+
+       residency->startFrame();
+       residency->textureBound(t2);
+       sad::Texture* t3 = makeResidentTestTexture(&r, 16);
+       // Only t1 is not used in current frame
+       ASSERT_TRUE( residency->evictions() == 1 );
+       ASSERT_FALSE( t1->OnGPU );
+       ASSERT_TRUE( t2->OnGPU );
+       ASSERT_TRUE( t3->OnGPU );
+
+       delete t1;
+       delete t2;
+       delete t3;
+   }
+
+} _sad_texture_residency_test;
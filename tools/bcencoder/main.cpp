@@ -0,0 +1,196 @@
+/*! \file main.cpp
+    
+
+    A tool, which converts images into block-compressed textures
+ */
+#include <texture.h>
+#include <imageformats/pngloader.h>
+#include <imageformats/tgaloader.h>
+#include <imageformats/bmploader.h>
+#include <imageformats/blockcompression.h>
+#include <imageformats/compressedstorageloader.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+/*! Loads source image, selecting loader by extension
+    \param[in] name a name of file
+    \param[out] texture a texture
+    \return whether image was loaded
+ */
+static bool loadImage(const sad::String& name, sad::Texture& texture)
+{
+    sad::String ext = name.getExtension();
+    char * f = const_cast<char *>(ext.data());
+    while(*f) { *f = toupper(*f); ++f; }
+
+    sad::imageformats::Loader* loader = NULL;
+    if (ext == "PNG")
+    {
+        loader = new sad::imageformats::PNGLoader();
+    }
+    if (ext == "TGA")
+    {
+        loader = new sad::imageformats::TGALoader();
+    }
+    if (ext == "BMP")
+    {
+        loader = new sad::imageformats::BMPLoader();
+    }
+    if (!loader)
+    {
+        return false;
+    }
+    bool result = false;
+    FILE* file = fopen(name.data(), "rb");
+    if (file)
+    {
+        result = loader->load(file, &texture);
+        fclose(file);
+    }
+    delete loader;
+    return result;
+}
+
+/*! Converts pixels of texture to 32-bit RGBA, if needed
+    \param[in] texture a texture
+    \param[out] pixels a pixels
+ */
+static void toRGBA(const sad::Texture& texture, sad::Vector<sad::uchar>& pixels)
+{
+    size_t count = static_cast<size_t>(texture.width()) * texture.height();
+    pixels.resize(count * 4);
+    const sad::uchar* data = texture.data();
+    for(size_t i = 0; i < count; i++)
+    {
+        if (texture.Bpp == 24)
+        {
+            memcpy(&(pixels[i * 4]), data + i * 3, 3);
+            pixels[i * 4 + 3] = 255;
+        }
+        else
+        {
+            memcpy(&(pixels[i * 4]), data + i * 4, 4);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        printf("Usage: bcencoder <source image> [<output file>] [--bc1|--bc3] [--check]\n");
+        return 1;
+    }
+    sad::String source = argv[1];
+    sad::String output;
+    int format = -1;
+    bool check = false;
+    for(int i = 2; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--bc1") == 0)
+        {
+            format = sad::Texture::SFT_BC1;
+        }
+        else if (strcmp(argv[i], "--bc3") == 0)
+        {
+            format = sad::Texture::SFT_BC3;
+        }
+        else if (strcmp(argv[i], "--check") == 0)
+        {
+            check = true;
+        }
+        else
+        {
+            output = argv[i];
+        }
+    }
+
+    sad::Texture texture;
+    if (!loadImage(source, texture) || (texture.Bpp != 24 && texture.Bpp != 32))
+    {
+        printf("Unable to load image from %s\n", source.data());
+        return 2;
+    }
+    sad::Vector<sad::uchar> pixels;
+    toRGBA(texture, pixels);
+    if (format < 0)
+    {
+        format = sad::Texture::SFT_BC1;
+        for(size_t i = 3; i < pixels.size(); i += 4)
+        {
+            if (pixels[i] != 255)
+            {
+                format = sad::Texture::SFT_BC3;
+                break;
+            }
+        }
+    }
+    if (output.length() == 0)
+    {
+        output = source;
+        output.removeExtension();
+        output.addExtension((format == sad::Texture::SFT_BC1) ? "sbc1" : "sbc3");
+    }
+
+    sad::Texture::DefaultBuffer* buffer = new sad::Texture::DefaultBuffer();
+    buffer->Data = pixels;
+    delete texture.Buffer;
+    texture.Buffer = buffer;
+    texture.Bpp = 32;
+    texture.Format = sad::Texture::SFT_R8_G8_B8_A8;
+    texture.compress(static_cast<sad::Texture::InternalFormat>(format));
+
+    sad::imageformats::CompressedStorageLoader saver(
+        (format == sad::Texture::SFT_BC1)
+        ? sad::imageformats::CompressedStorageLoader::SBC1Settings
+        : sad::imageformats::CompressedStorageLoader::SBC3Settings
+    );
+    FILE* file = fopen(output.data(), "wb");
+    bool saved = false;
+    if (file)
+    {
+        saved = saver.save(file, &texture);
+        fclose(file);
+    }
+    if (!saved)
+    {
+        printf("Unable to save compressed texture to %s\n", output.data());
+        return 3;
+    }
+    size_t compressed = sad::imageformats::BlockCompression::compressedSize(texture.width(), texture.height(), texture.Format);
+    printf(
+        "%s: %ux%u, %s, %u bytes instead of %u\n",
+        output.data(),
+        texture.width(),
+        texture.height(),
+        (format == sad::Texture::SFT_BC1) ? "BC1" : "BC3",
+        static_cast<unsigned int>(compressed),
+        static_cast<unsigned int>(pixels.size())
+    );
+
+    if (check)
+    {
+        sad::Vector<sad::uchar> decompressed;
+        decompressed.resize(pixels.size());
+        sad::imageformats::BlockCompression::decompress(texture.data(), texture.width(), texture.height(), texture.Format, &(decompressed[0]));
+        // Colors of fully transparent pixels are not visible, so they are not counted
+        double error = 0;
+        size_t count = 0;
+        for(size_t i = 0; i < pixels.size(); i++)
+        {
+            bool invisible = (i % 4 != 3) && pixels[i - i % 4 + 3] == 0 && decompressed[i - i % 4 + 3] == 0;
+            if (!invisible)
+            {
+                double d = static_cast<double>(pixels[i]) - decompressed[i];
+                error += d * d;
+                ++count;
+            }
+        }
+        double rmse = (count) ? sqrt(error / count) : 0.0;
+        printf("RMSE: %.3lf, PSNR: %.2lf dB\n", rmse, (rmse > 0) ? 20.0 * log10(255.0 / rmse) : 99.0);
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+/*! \file main.cpp
+    
+
+    A tool, which replays recorded rendering commands into null backend
+    and reports statistics for every frame
+ */
+#include <rendering/commandbuffer.h>
+#include <rendering/nullbackend.h>
+#include <timer.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/*! Prints statistics for a frame
+    \param[in] name a name of frame
+    \param[in] s statistics
+ */
+static void printStatistics(const char* name, const sad::rendering::FrameStatistics& s)
+{
+    printf(
+        "%10s %10u %10u %10u %10u %10u %10u %10u\n",
+        name,
+        s.Commands,
+        s.DrawCalls,
+        s.Quads,
+        s.Lines,
+        s.Characters,
+        s.StateChanges,
+        s.TextureSwitches
+    );
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        printf("Usage: renderreplay <recorded file> [--repeat <amount>] [--totals]\n");
+        return 1;
+    }
+    int repeat = 1;
+    bool only_totals = false;
+    for(int i = 2; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+        {
+            repeat = atoi(argv[i + 1]);
+            ++i;
+        }
+        if (strcmp(argv[i], "--totals") == 0)
+        {
+            only_totals = true;
+        }
+    }
+    if (repeat < 1)
+    {
+        repeat = 1;
+    }
+
+    sad::rendering::CommandBuffer buffer;
+    if (!buffer.load(argv[1]))
+    {
+        printf("Unable to load recorded commands from %s\n", argv[1]);
+        return 2;
+    }
+
+    sad::rendering::NullBackend backend;
+    backend.setKeepsHistory(true);
+    if (!buffer.replay(&backend))
+    {
+        printf("Recorded commands in %s are malformed\n", argv[1]);
+        return 3;
+    }
+
+    printf(
+        "%10s %10s %10s %10s %10s %10s %10s %10s\n",
+        "frame",
+        "commands",
+        "draws",
+        "quads",
+        "lines",
+        "chars",
+        "states",
+        "textures"
+    );
+    if (!only_totals)
+    {
+        char name[32];
+        for(size_t i = 0; i < backend.frames().size(); i++)
+        {
+            sprintf(name, "%u", static_cast<unsigned int>(i));
+            printStatistics(name, backend.frames()[i]);
+        }
+    }
+    printStatistics("total", backend.total());
+
+    // Measure time of decoding commands, excluding first replay
+    sad::rendering::NullBackend timed_backend;
+    sad::Timer timer;
+    timer.start();
+    for(int i = 0; i < repeat; i++)
+    {
+        buffer.replay(&timed_backend);
+    }
+    timer.stop();
+    printf(
+        "Replayed %u frames (%u commands, %u bytes) %d times in %.3lf ms\n",
+        buffer.frameCount(),
+        buffer.commandCount(),
+        static_cast<unsigned int>(buffer.data().size()),
+        repeat,
+        timer.elapsed()
+    );
+    return 0;
+}